@@ -164,6 +164,14 @@ DX12_UTIL_DLL UINT GetDXGIFormatPixelSize(DXGI_FORMAT format)
     case DXGI_FORMAT_R16_SINT:
         return 2;
 
+    case DXGI_FORMAT_R8_TYPELESS:
+    case DXGI_FORMAT_R8_UNORM:
+    case DXGI_FORMAT_R8_UINT:
+    case DXGI_FORMAT_R8_SNORM:
+    case DXGI_FORMAT_R8_SINT:
+    case DXGI_FORMAT_A8_UNORM:
+        return 1;
+
     default:
         assert(false && "Unsupported DXGI format for pixel size retrieval.");
     }
@@ -0,0 +1,153 @@
+﻿#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "class_template/non_copy.h"
+
+#include "ecs/include/dll_config.h"
+#include "ecs/include/entity.h"
+#include "ecs/include/component.h"
+
+namespace ecs
+{
+
+// The sorted list of component IDs that identifies an archetype
+using ArchetypeSignature = std::vector<ComponentID>;
+
+// An archetype stores all entities that have exactly the same set of components
+// Rows are stored in fixed size chunks: one entity column and one column per component type
+// Components are polymorphic and not movable, so the columns hold pointers to the component instances
+// which are owned by the component allocators of the world
+// Walking a column avoids per entity lookups, but the component data itself is not stored contiguously
+class ECS_DLL Archetype :
+    public class_template::NonCopyable
+{
+public:
+    // The number of rows stored in one chunk
+    static constexpr size_t CHUNK_ROW_COUNT = 512;
+
+    // The column index returned when the archetype does not contain the component
+    static constexpr size_t INVALID_COLUMN = static_cast<size_t>(-1);
+
+    Archetype(ArchetypeSignature signature);
+    ~Archetype() = default;
+
+    // Get the sorted component IDs of this archetype
+    const ArchetypeSignature& GetSignature() const { return signature_; }
+
+    // Get the component IDs of this archetype as a set
+    const std::set<ComponentID>& GetComponentIDSet() const { return component_id_set_; }
+
+    // Get the column index of the component, INVALID_COLUMN if the archetype does not contain it
+    size_t FindColumn(ComponentID component_id) const
+    {
+        if (component_id >= column_lookup_.size())
+            return INVALID_COLUMN;
+        return column_lookup_[component_id];
+    }
+
+    // Check if the archetype contains the component
+    bool Contains(ComponentID component_id) const { return FindColumn(component_id) != INVALID_COLUMN; }
+
+    // Get the number of component columns
+    size_t GetColumnCount() const { return signature_.size(); }
+
+    // Get the number of rows (entities) stored in this archetype
+    size_t GetRowCount() const { return row_count_; }
+
+    // Get the number of chunks that currently hold rows
+    size_t GetChunkCount() const { return (row_count_ + CHUNK_ROW_COUNT - 1) / CHUNK_ROW_COUNT; }
+
+    // Get the number of rows stored in the chunk
+    size_t GetChunkRowCount(size_t chunk_index) const
+    {
+        assert(chunk_index < GetChunkCount()); // Ensure the chunk holds rows
+        size_t first_row = chunk_index * CHUNK_ROW_COUNT;
+        return (row_count_ - first_row < CHUNK_ROW_COUNT) ? row_count_ - first_row : CHUNK_ROW_COUNT;
+    }
+
+    // Get the entity column of the chunk
+    const Entity* GetChunkEntities(size_t chunk_index) const
+    {
+        assert(chunk_index < chunks_.size()); // Ensure the chunk index is within bounds
+        return chunks_[chunk_index]->entities.get();
+    }
+
+    // Get the component column of the chunk
+    Component* const* GetChunkColumn(size_t chunk_index, size_t column) const
+    {
+        assert(chunk_index < chunks_.size()); // Ensure the chunk index is within bounds
+        assert(column < GetColumnCount()); // Ensure the column index is within bounds
+        return chunks_[chunk_index]->components.get() + column * CHUNK_ROW_COUNT;
+    }
+
+    // Get the entity stored in the row
+    const Entity& GetEntity(size_t row) const
+    {
+        assert(row < row_count_); // Ensure the row is within bounds
+        return chunks_[row / CHUNK_ROW_COUNT]->entities[row % CHUNK_ROW_COUNT];
+    }
+
+    // Get the component stored in the row and column
+    Component*& At(size_t row, size_t column)
+    {
+        assert(row < row_count_); // Ensure the row is within bounds
+        assert(column < GetColumnCount()); // Ensure the column index is within bounds
+        return chunks_[row / CHUNK_ROW_COUNT]->components[column * CHUNK_ROW_COUNT + row % CHUNK_ROW_COUNT];
+    }
+
+    // Get the component stored in the row and column
+    Component* At(size_t row, size_t column) const
+    {
+        assert(row < row_count_); // Ensure the row is within bounds
+        assert(column < GetColumnCount()); // Ensure the column index is within bounds
+        return chunks_[row / CHUNK_ROW_COUNT]->components[column * CHUNK_ROW_COUNT + row % CHUNK_ROW_COUNT];
+    }
+
+    // Append a row for the entity and return its row index
+    // The component columns of the new row are set to nullptr
+    size_t AddRow(const Entity& entity);
+
+    // Remove the row by moving the last row into its place
+    // Return true and set moved_entity if another entity was moved into the removed row
+    bool RemoveRow(size_t row, Entity& moved_entity);
+
+    // Get the cached archetype reached by adding the component, nullptr if not cached yet
+    Archetype* GetAddEdge(ComponentID component_id) const;
+
+    // Cache the archetype reached by adding the component
+    void SetAddEdge(ComponentID component_id, Archetype* archetype);
+
+    // Get the cached archetype reached by removing the component, nullptr if not cached yet
+    Archetype* GetRemoveEdge(ComponentID component_id) const;
+
+    // Cache the archetype reached by removing the component
+    void SetRemoveEdge(ComponentID component_id, Archetype* archetype);
+
+private:
+    // The storage of CHUNK_ROW_COUNT rows
+    // Chunks are kept once allocated so that the row memory stays stable and is reused
+    struct Chunk
+    {
+        std::unique_ptr<Entity[]> entities; // The entity column
+        std::unique_ptr<Component*[]> components; // The component columns, column major
+    };
+
+    const ArchetypeSignature signature_; // The sorted component IDs
+    const std::set<ComponentID> component_id_set_; // The component IDs as a set
+    std::vector<size_t> column_lookup_; // Map from component ID to column index
+
+    std::vector<std::unique_ptr<Chunk>> chunks_; // The chunks of this archetype
+    size_t row_count_ = 0; // The number of rows in use
+
+    // The archetype graph edges used to find the destination archetype of add/remove component
+    std::unordered_map<ComponentID, Archetype*> add_edges_;
+    std::unordered_map<ComponentID, Archetype*> remove_edges_;
+};
+
+} // namespace ecs
\ No newline at end of file
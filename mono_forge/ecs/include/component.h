@@ -86,6 +86,7 @@ using IComponentAllocatorFactory
 
 // The descriptor for a component type
 // It contains the component ID, maximum count, and the factory for creating and destroying component instances
+// The maximum count sizes the initial pool, allocators that grow on demand treat it as a soft limit
 // It is used to register component types in the ECS world
 class ECS_DLL ComponentDescriptor
 {
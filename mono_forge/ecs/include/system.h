@@ -1,9 +1,12 @@
 ﻿#pragma once
 
+#include <set>
+
 #include "class_template/singleton.h"
 #include "utility_header/id.h"
 
 #include "ecs/include/dll_config.h" // DLL export/import macros
+#include "ecs/include/component.h"
 
 namespace ecs
 {
@@ -24,6 +27,46 @@ public:
     virtual ~SystemIDGenerator() override = default;
 };
 
+// The phases of a system update
+enum class SystemPhase
+{
+    PreUpdate,
+    Update,
+    PostUpdate,
+};
+
+// The number of system phases
+constexpr size_t SYSTEM_PHASE_COUNT = 3;
+
+// The components that a system reads and writes during a phase
+// It is used by the SystemScheduler to find systems that can run at the same time
+class ECS_DLL SystemAccess
+{
+public:
+    SystemAccess() = default;
+    ~SystemAccess() = default;
+
+    // Declare that the system reads the component
+    SystemAccess& Read(ComponentID component_id);
+
+    // Declare that the system writes the component
+    SystemAccess& Write(ComponentID component_id);
+
+    // Get the components the system reads
+    const std::set<ComponentID>& GetReads() const { return reads_; }
+
+    // Get the components the system writes
+    const std::set<ComponentID>& GetWrites() const { return writes_; }
+
+    // Check if the two accesses can not run at the same time
+    // They conflict when one writes a component that the other reads or writes
+    bool ConflictsWith(const SystemAccess& other) const;
+
+private:
+    std::set<ComponentID> reads_; // The components that are read
+    std::set<ComponentID> writes_; // The components that are written
+};
+
 // The interface for all systems
 // It can be inherited to create specific system types.
 class ECS_DLL System :
@@ -45,6 +88,11 @@ public:
 
     // Get the system ID
     virtual SystemID GetID() const = 0;
+
+    // Declare the components this system reads and writes in the phase
+    // Return false to run exclusively, which is the default for systems that do not declare their access
+    // Systems that create/destroy entities or add/remove components must run exclusively
+    virtual bool DeclareAccess(SystemPhase phase, SystemAccess& access) const;
 };
 
 // The template class for system handles of specific types
@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "class_template/non_copy.h"
+
+#include "ecs/include/dll_config.h"
+#include "ecs/include/system.h"
+
+namespace ecs
+{
+
+// The scheduler that runs the systems of a phase on a persistent worker pool
+// It builds a dependency graph per phase from the SystemAccess each system declares for that phase:
+// a system depends on every earlier system in the order that it conflicts with,
+// so conflicting systems keep the given order and independent systems run at the same time
+// Systems that do not declare their access conflict with every other system,
+// and run on the thread calling Run, as they may depend on it like window and dialog systems do
+// The worker pool is started by the first Build with a system declaring its access
+class ECS_DLL SystemScheduler :
+    public class_template::NonCopyable
+{
+public:
+    // worker_count is the number of threads created in addition to the calling thread
+    // 0 runs every system on the calling thread in the given order
+    // The threads are not created until a system declares its access
+    SystemScheduler(size_t worker_count);
+    ~SystemScheduler();
+
+    // Build the dependency graphs of all phases for the systems in the given order
+    // The systems must stay alive while the scheduler uses them
+    void Build(const std::vector<System*>& ordered_systems);
+
+    // Run the phase of all systems and wait for them to finish
+    // When a system fails, no more systems are started and false is returned
+    // after the running systems finished
+    bool Run(SystemPhase phase, World& world);
+
+    // Get the number of systems that the system depends on in the phase
+    size_t GetDependencyCount(SystemPhase phase, size_t system_index) const;
+
+    // Get the number of started worker threads
+    size_t GetWorkerCount() const { return workers_.size(); }
+
+private:
+    // The node of the dependency graph
+    struct Node
+    {
+        System* system = nullptr; // The system to run
+        std::vector<size_t> dependents; // The nodes that must wait for this node
+        size_t dependency_count = 0; // The number of nodes this node waits for
+        bool exclusive = false; // True if the system did not declare its access
+    };
+
+    // Call the phase function of the system
+    bool Execute(size_t node_index);
+
+    // Pop a ready node from the queue and run it, the lock is released while the system runs
+    void RunReadyNode(std::deque<size_t>& queue, std::unique_lock<std::mutex>& lock);
+
+    // Check if the current run has nothing left to do
+    bool IsRunFinished() const;
+
+    // The loop of the worker threads
+    void WorkerLoop();
+
+    // The dependency graphs of the phases, in the given order
+    std::array<std::vector<Node>, SYSTEM_PHASE_COUNT> graphs_;
+
+    const size_t worker_count_; // The number of worker threads to start
+    std::vector<std::thread> workers_; // The persistent worker threads
+    std::mutex mutex_; // The mutex guarding the run state
+    std::condition_variable condition_; // Notified when nodes become ready or the run finishes
+
+    // The run state, guarded by mutex_
+    bool stop_ = false; // True when the workers must exit
+    bool running_ = false; // True while a phase is running
+    SystemPhase phase_ = SystemPhase::Update; // The phase being run
+    const std::vector<Node>* nodes_ = nullptr; // The dependency graph of the phase being run
+    World* world_ = nullptr; // The world passed to the systems
+    std::deque<size_t> ready_nodes_; // The nodes whose dependencies are finished, run by any thread
+    std::deque<size_t> ready_exclusive_nodes_; // The ready exclusive nodes, run only by the thread calling Run
+    std::vector<size_t> remaining_dependencies_; // The unfinished dependency count of each node
+    size_t completed_count_ = 0; // The number of finished nodes
+    size_t executing_count_ = 0; // The number of nodes being executed
+    bool failed_ = false; // True if a system returned false
+};
+
+} // namespace ecs
\ No newline at end of file
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
+#include <atomic>
 #include <cassert>
+#include <iterator>
+#include <map>
 #include <unordered_map>
 #include <set>
 #include <vector>
@@ -19,12 +22,16 @@
 #include "ecs/include/dll_config.h"
 #include "ecs/include/entity.h"
 #include "ecs/include/component.h"
+#include "ecs/include/archetype.h"
 
 namespace ecs
 {
 
+class EntityView;
+
 // The main world class that manages entities and components
 // It provides methods to create/destroy entities, add/remove components, and query entities
+// Entities are grouped by their component set into archetypes, see archetype.h
 // It is designed to be thread-safe
 class ECS_DLL World :
     public class_template::ThreadSafer
@@ -56,19 +63,11 @@ public:
 
         std::unique_lock<std::shared_mutex> lock = LockUnique(); // Lock for exclusive access
 
-        assert(component_pools_.find(component_id) != component_pools_.end()); // Ensure the component pool exists
         assert(component_allocators_.find(component_id) != component_allocators_.end()); // Ensure the component allocator exists
-
-        // Get the component size
-        size_t component_size = 0;
-        component_descriptor_registry_->WithUniqueLock([&](const ComponentDescriptorRegistry& registry)
-        {
-            assert(registry.Contains(component_id)); // Ensure the component ID is registered
-            component_size = registry.Get(component_id).GetSize();
-        });
+        assert(component_sizes_.find(component_id) != component_sizes_.end()); // Ensure the component size is cached
 
         // Allocate memory for the component using the allocator
-        std::byte* component_data = component_allocators_[component_id]->Allocate(component_size);
+        std::byte* component_data = component_allocators_[component_id]->Allocate(component_sizes_[component_id]);
 
         // Create the component instance using placement new
         Component* component = new (component_data) T(std::forward<ConstructArgs>(construct_args)...);
@@ -76,19 +75,13 @@ public:
         // Setup the component if setup parameters are provided
         if (setup_param != nullptr && !component->Setup(*setup_param)) // If setup failed, clean up and return false
         {
-            // Destroy the component instance using the destructor
-            component->~Component();
-
-            // Free the memory allocated for the component using the allocator
-            component_allocators_[component_id]->Deallocate(reinterpret_cast<std::byte**>(&component));
-            
+            // Destroy the component instance and free its memory
+            DestroyComponent(component_id, component);
             return false; // Setup failed
         }
 
-        // Store the component data in the maps
-        entity_to_component_ids_[entity].emplace(component_id);
-        component_id_to_entities_[component_id].emplace(entity);
-        entity_component_to_data_[{entity, component_id}] = component;
+        // Move the entity to the archetype that has the component
+        AttachComponent(entity, component_id, component);
 
         return true; // Component added successfully
     }
@@ -115,23 +108,73 @@ public:
             assert(registry.Contains(component_id)); // Ensure the component ID is registered
         });
 
-        if (!HasComponent(entity, component_id)) // If the entity does not have the component, return nullptr
-            return nullptr;
-
         std::shared_lock<std::shared_mutex> lock = LockShared(); // Lock for shared access
 
-        // Find the component data associated with the entity and component ID
-        auto it = entity_component_to_data_.find({entity, component_id});
-        if (it != entity_component_to_data_.end())
-            return dynamic_cast<T*>(it->second); // Return the component data casted to type T
-        else
-            return nullptr; // Component data not found, return nullptr
+        // Find the row of the entity and the column of the component in its archetype
+        const EntityLocation& location = entity_locations_[entity.GetIndex()];
+        size_t column = location.archetype->FindColumn(component_id);
+        if (column == Archetype::INVALID_COLUMN)
+            return nullptr; // The entity does not have the component
+
+        // The column only holds components of this ID, so a static cast is enough
+        Component* component = location.archetype->At(location.row, column);
+        assert(dynamic_cast<T*>(component) == static_cast<T*>(component)); // Ensure the component type matches
+        return static_cast<T*>(component);
     }
 
     // Get a read-only view of all entities that have the specified component
-    utility_header::ConstSharedLockedValue<std::set<Entity>> View(ComponentID component_id) const;
+    // Components and entities can be added or removed while iterating it, see EntityView
+    EntityView View(ComponentID component_id) const;
+
+    // Get the number of entity and component removals so far
+    // Views check their entities again once it changes
+    uint64_t GetRemovalCount() const { return removal_count_.load(std::memory_order_acquire); }
+
+    // Call func(const Entity&, T&) for every entity that has the specified component
+    // It walks the archetype chunks linearly without per entity lookups
+    // The world is shared locked while iterating, so func must not add/remove components or entities
+    template <typename T, typename Func>
+    void ForEach(ComponentID component_id, Func&& func)
+    {
+        std::shared_lock<std::shared_mutex> lock = LockShared(); // Lock for shared access
+
+        auto it = component_archetypes_.find(component_id);
+        if (it == component_archetypes_.end())
+            return; // No archetype contains the component
+
+        for (Archetype* archetype : it->second)
+        {
+            size_t column = archetype->FindColumn(component_id);
+            for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+            {
+                const Entity* entities = archetype->GetChunkEntities(chunk);
+                Component* const* components = archetype->GetChunkColumn(chunk, column);
+
+                size_t row_count = archetype->GetChunkRowCount(chunk);
+                for (size_t row = 0; row < row_count; ++row)
+                    func(entities[row], *static_cast<T*>(components[row]));
+            }
+        }
+    }
 
 private:
+    // Move the entity to the archetype with the component added and store the component in it
+    // It must be called with the unique lock held
+    void AttachComponent(const Entity& entity, ComponentID component_id, Component* component);
+
+    // Destroy the component instance and free its memory with the component allocator
+    // It must be called with the unique lock held
+    void DestroyComponent(ComponentID component_id, Component* component);
+
+    // Find or create the archetype that has the given signature
+    // It must be called with the unique lock held
+    Archetype* GetOrCreateArchetype(const ArchetypeSignature& signature);
+
+    // Move the entity from its current archetype row to the destination archetype
+    // Components shared by both archetypes are carried over, returns the new row
+    // It must be called with the unique lock held
+    size_t MoveEntity(const Entity& entity, Archetype* destination);
+
     const std::unique_ptr<ComponentDescriptorRegistry> component_descriptor_registry_; // The registry of component descriptors
 
     std::vector<Entity> entities_; // The list of all entities
@@ -144,37 +187,120 @@ private:
     // The allocators for each component type
     std::unordered_map<ComponentID, std::unique_ptr<memory_allocator::Allocator>> component_allocators_;
 
-    // Map from entity to its component IDs
-    std::unordered_map<Entity, std::set<ComponentID>> entity_to_component_ids_;
-    std::set<ComponentID> empty_component_ids_; // An empty set of component IDs for entities with no components
+    // The size of each component type, cached from the descriptors
+    std::unordered_map<ComponentID, size_t> component_sizes_;
+
+    // All archetypes by their signature
+    std::map<ArchetypeSignature, std::unique_ptr<Archetype>> archetypes_;
 
-    // Map from component ID to entities
-    std::unordered_map<ComponentID, std::set<Entity>> component_id_to_entities_;
-    std::set<Entity> empty_entities_; // An empty set of entities for components with no entities
+    // The archetype of entities that have no components
+    Archetype* empty_archetype_ = nullptr;
 
-    // Struct to represent a key for entity-component pair
-    struct EntityComponentKey
+    // Map from component ID to the archetypes containing it
+    std::unordered_map<ComponentID, std::vector<Archetype*>> component_archetypes_;
+
+    // The number of entity and component removals
+    std::atomic<uint64_t> removal_count_ = 0;
+
+    // The location of an entity in the archetype storage
+    struct EntityLocation
     {
-        Entity entity;
-        ComponentID component_id;
+        Archetype* archetype = nullptr; // The archetype the entity belongs to
+        size_t row = 0; // The row of the entity in the archetype
+    };
 
-        bool operator==(const EntityComponentKey &other) const
+    // The location of each entity, indexed by entity index
+    std::vector<EntityLocation> entity_locations_;
+};
+
+// A read-only range of all entities that have a specific component
+// The entities are copied when the view is created, so the loop body may add or remove components and entities
+// Entities which get the component during the loop are not visited,
+// and entities which are destroyed or lose the component before they are reached are skipped
+class ECS_DLL EntityView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entity*;
+        using reference = const Entity&;
+
+        Iterator(const EntityView* view, size_t index) :
+            view_(view), index_(index)
         {
-            return entity == other.entity && component_id == other.component_id;
+            SkipRemovedEntities();
         }
-    };
 
-    // Hash function for EntityComponentKey to be used in unordered_map
-    struct EntityComponentKeyHash
-    {
-        std::size_t operator()(const EntityComponentKey &key) const
+        reference operator*() const { return view_->entities_[index_]; }
+        pointer operator->() const { return &(**this); }
+
+        Iterator& operator++()
         {
-            return std::hash<Entity>()(key.entity) ^ (std::hash<ComponentID>()(key.component_id) << 1);
+            ++index_;
+            SkipRemovedEntities();
+            return *this;
         }
+
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        void SkipRemovedEntities()
+        {
+            while (index_ < view_->entities_.size() && view_->IsRemoved(view_->entities_[index_]))
+                ++index_;
+        }
+
+        const EntityView* view_;
+        size_t index_;
     };
 
-    // Map from entity-component pair to component data
-    std::unordered_map<EntityComponentKey, Component*, EntityComponentKeyHash> entity_component_to_data_;
+    EntityView(const World& world, ComponentID component_id, std::vector<Entity> entities, uint64_t removal_count) :
+        world_(&world), component_id_(component_id), entities_(std::move(entities)), removal_count_(removal_count)
+    {
+    }
+
+    ~EntityView() = default;
+
+    // Access the range
+    // It is kept so that call sites can keep the world.View(id)() form
+    EntityView operator()() const & { return *this; }
+    EntityView operator()() && { return std::move(*this); }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, entities_.size()); }
+
+    // Get the number of entities when the view was created
+    size_t size() const { return entities_.size(); }
+
+    // Check if the view had no entities when it was created
+    bool empty() const { return entities_.empty(); }
+
+private:
+    // Check if the entity was destroyed or lost the component after the view was created
+    // Nothing was removed while the removal count is unchanged, so the world is only asked after a removal
+    bool IsRemoved(const Entity& entity) const
+    {
+        if (world_->GetRemovalCount() == removal_count_)
+            return false;
+        return !world_->CheckEntityExist(entity) || !world_->HasComponent(entity, component_id_);
+    }
+
+    const World* world_; // The world the entities belong to
+    ComponentID component_id_; // The component of the view
+    std::vector<Entity> entities_; // The entities which had the component when the view was created
+    uint64_t removal_count_; // The removal count of the world when the view was created
 };
 
 } // namespace ecs
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿#include "ecs/src/pch.h"
+#include "ecs/include/archetype.h"
+
+namespace ecs
+{
+
+Archetype::Archetype(ArchetypeSignature signature) :
+    signature_(std::move(signature)),
+    component_id_set_(signature_.begin(), signature_.end())
+{
+    assert(component_id_set_.size() == signature_.size()); // Ensure the signature has no duplicates
+
+    // Build the lookup from component ID to column index
+    for (size_t column = 0; column < signature_.size(); ++column)
+    {
+        ComponentID component_id = signature_[column];
+        if (component_id >= column_lookup_.size())
+            column_lookup_.resize(component_id + 1, INVALID_COLUMN);
+
+        column_lookup_[component_id] = column;
+    }
+}
+
+size_t Archetype::AddRow(const Entity& entity)
+{
+    size_t row = row_count_;
+    size_t chunk_index = row / CHUNK_ROW_COUNT;
+
+    // Allocate a new chunk if all chunks are full
+    if (chunk_index == chunks_.size())
+    {
+        std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+        chunk->entities = std::make_unique<Entity[]>(CHUNK_ROW_COUNT);
+        chunk->components = std::make_unique<Component*[]>(CHUNK_ROW_COUNT * (std::max)(GetColumnCount(), size_t(1)));
+        chunks_.emplace_back(std::move(chunk));
+    }
+
+    // Store the entity and clear its component columns
+    Chunk& chunk = *chunks_[chunk_index];
+    size_t chunk_row = row % CHUNK_ROW_COUNT;
+    chunk.entities[chunk_row] = entity;
+    for (size_t column = 0; column < GetColumnCount(); ++column)
+        chunk.components[column * CHUNK_ROW_COUNT + chunk_row] = nullptr;
+
+    row_count_++;
+    return row;
+}
+
+bool Archetype::RemoveRow(size_t row, Entity& moved_entity)
+{
+    assert(row < row_count_); // Ensure the row is within bounds
+
+    size_t last_row = row_count_ - 1;
+    bool moved = false;
+
+    // Move the last row into the removed row to keep the rows contiguous
+    if (row != last_row)
+    {
+        Chunk& dst_chunk = *chunks_[row / CHUNK_ROW_COUNT];
+        Chunk& src_chunk = *chunks_[last_row / CHUNK_ROW_COUNT];
+        size_t dst_row = row % CHUNK_ROW_COUNT;
+        size_t src_row = last_row % CHUNK_ROW_COUNT;
+
+        dst_chunk.entities[dst_row] = src_chunk.entities[src_row];
+        for (size_t column = 0; column < GetColumnCount(); ++column)
+        {
+            dst_chunk.components[column * CHUNK_ROW_COUNT + dst_row]
+                = src_chunk.components[column * CHUNK_ROW_COUNT + src_row];
+        }
+
+        moved_entity = dst_chunk.entities[dst_row];
+        moved = true;
+    }
+
+    row_count_--;
+    return moved;
+}
+
+Archetype* Archetype::GetAddEdge(ComponentID component_id) const
+{
+    auto it = add_edges_.find(component_id);
+    return (it != add_edges_.end()) ? it->second : nullptr;
+}
+
+void Archetype::SetAddEdge(ComponentID component_id, Archetype* archetype)
+{
+    assert(archetype != nullptr); // Ensure the archetype is not null
+    add_edges_[component_id] = archetype;
+}
+
+Archetype* Archetype::GetRemoveEdge(ComponentID component_id) const
+{
+    auto it = remove_edges_.find(component_id);
+    return (it != remove_edges_.end()) ? it->second : nullptr;
+}
+
+void Archetype::SetRemoveEdge(ComponentID component_id, Archetype* archetype)
+{
+    assert(archetype != nullptr); // Ensure the archetype is not null
+    remove_edges_[component_id] = archetype;
+}
+
+} // namespace ecs
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <shared_mutex>
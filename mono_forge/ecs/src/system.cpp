@@ -4,6 +4,38 @@
 namespace ecs
 {
 
+SystemAccess& SystemAccess::Read(ComponentID component_id)
+{
+    reads_.emplace(component_id);
+    return *this;
+}
+
+SystemAccess& SystemAccess::Write(ComponentID component_id)
+{
+    writes_.emplace(component_id);
+    return *this;
+}
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+{
+    // Check if this writes a component the other reads or writes
+    for (ComponentID component_id : writes_)
+    {
+        if (other.reads_.find(component_id) != other.reads_.end() ||
+            other.writes_.find(component_id) != other.writes_.end())
+            return true;
+    }
+
+    // Check if the other writes a component this reads
+    for (ComponentID component_id : other.writes_)
+    {
+        if (reads_.find(component_id) != reads_.end())
+            return true;
+    }
+
+    return false; // No conflict
+}
+
 bool ecs::System::PreUpdate(World& world)
 {
     return true;
@@ -19,4 +51,9 @@ bool ecs::System::PostUpdate(World& world)
     return true;
 }
 
+bool ecs::System::DeclareAccess(SystemPhase phase, SystemAccess& access) const
+{
+    return false; // Run exclusively by default
+}
+
 } // namespace ecs
\ No newline at end of file
@@ -0,0 +1,216 @@
+﻿#include "ecs/src/pch.h"
+#include "ecs/include/system_scheduler.h"
+
+namespace ecs
+{
+
+SystemScheduler::SystemScheduler(size_t worker_count) :
+    worker_count_(worker_count)
+{
+}
+
+SystemScheduler::~SystemScheduler()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+
+    // Wait for all workers to exit
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void SystemScheduler::Build(const std::vector<System*>& ordered_systems)
+{
+    bool has_declared = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        assert(!running_ && "Cannot build the scheduler while running!");
+
+        for (size_t phase_index = 0; phase_index < SYSTEM_PHASE_COUNT; ++phase_index)
+        {
+            SystemPhase phase = static_cast<SystemPhase>(phase_index);
+
+            // Collect the accesses declared for the phase
+            std::vector<SystemAccess> accesses(ordered_systems.size());
+            std::vector<bool> exclusive(ordered_systems.size());
+            for (size_t i = 0; i < ordered_systems.size(); ++i)
+            {
+                assert(ordered_systems[i] != nullptr && "System is null!");
+                exclusive[i] = !ordered_systems[i]->DeclareAccess(phase, accesses[i]);
+                has_declared = has_declared || !exclusive[i];
+            }
+
+            // Make each node depend on the earlier nodes it conflicts with
+            std::vector<Node>& nodes = graphs_[phase_index];
+            nodes.clear();
+            nodes.resize(ordered_systems.size());
+            for (size_t i = 0; i < ordered_systems.size(); ++i)
+            {
+                nodes[i].system = ordered_systems[i];
+                nodes[i].exclusive = exclusive[i];
+                for (size_t j = 0; j < i; ++j)
+                {
+                    if (exclusive[i] || exclusive[j] || accesses[i].ConflictsWith(accesses[j]))
+                    {
+                        nodes[j].dependents.push_back(i);
+                        nodes[i].dependency_count++;
+                    }
+                }
+            }
+        }
+
+        remaining_dependencies_.resize(ordered_systems.size());
+    }
+
+    // Start the workers once some system can run on them
+    if (has_declared && workers_.empty())
+    {
+        workers_.reserve(worker_count_);
+        for (size_t i = 0; i < worker_count_; ++i)
+            workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+bool SystemScheduler::Run(SystemPhase phase, World& world)
+{
+    const std::vector<Node>& nodes = graphs_[static_cast<size_t>(phase)];
+    if (nodes.empty())
+        return true; // Nothing to run
+
+    // Without workers, run in the given order on this thread
+    if (workers_.empty())
+    {
+        phase_ = phase;
+        nodes_ = &nodes;
+        world_ = &world;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (!Execute(i))
+                return false;
+        }
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(!running_ && "The scheduler is already running!");
+
+    // Reset the run state and queue the nodes without dependencies
+    phase_ = phase;
+    nodes_ = &nodes;
+    world_ = &world;
+    completed_count_ = 0;
+    executing_count_ = 0;
+    failed_ = false;
+    ready_nodes_.clear();
+    ready_exclusive_nodes_.clear();
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        remaining_dependencies_[i] = nodes[i].dependency_count;
+        if (remaining_dependencies_[i] == 0)
+            (nodes[i].exclusive ? ready_exclusive_nodes_ : ready_nodes_).push_back(i);
+    }
+
+    running_ = true;
+    condition_.notify_all();
+
+    // The calling thread runs the exclusive nodes, and works as well until the run is finished
+    while (!IsRunFinished())
+    {
+        if (!ready_exclusive_nodes_.empty())
+            RunReadyNode(ready_exclusive_nodes_, lock);
+        else if (!ready_nodes_.empty())
+            RunReadyNode(ready_nodes_, lock);
+        else
+            condition_.wait(lock);
+    }
+
+    running_ = false;
+    return !failed_;
+}
+
+size_t SystemScheduler::GetDependencyCount(SystemPhase phase, size_t system_index) const
+{
+    const std::vector<Node>& nodes = graphs_[static_cast<size_t>(phase)];
+    assert(system_index < nodes.size()); // Ensure the index is within bounds
+    return nodes[system_index].dependency_count;
+}
+
+bool SystemScheduler::Execute(size_t node_index)
+{
+    System& system = *(*nodes_)[node_index].system;
+    switch (phase_)
+    {
+    case SystemPhase::PreUpdate:
+        return system.PreUpdate(*world_);
+
+    case SystemPhase::Update:
+        return system.Update(*world_);
+
+    case SystemPhase::PostUpdate:
+        return system.PostUpdate(*world_);
+    }
+
+    assert(false && "Unknown system phase!");
+    return false;
+}
+
+void SystemScheduler::RunReadyNode(std::deque<size_t>& queue, std::unique_lock<std::mutex>& lock)
+{
+    size_t node_index = queue.front();
+    queue.pop_front();
+    executing_count_++;
+
+    // Run the system without holding the lock
+    lock.unlock();
+    bool result = Execute(node_index);
+    lock.lock();
+
+    executing_count_--;
+    completed_count_++;
+
+    if (!result)
+    {
+        // Stop starting new systems
+        failed_ = true;
+        ready_nodes_.clear();
+        ready_exclusive_nodes_.clear();
+    }
+    else if (!failed_)
+    {
+        // Release the dependents of the finished node
+        for (size_t dependent : (*nodes_)[node_index].dependents)
+        {
+            if (--remaining_dependencies_[dependent] == 0)
+                ((*nodes_)[dependent].exclusive ? ready_exclusive_nodes_ : ready_nodes_).push_back(dependent);
+        }
+    }
+
+    condition_.notify_all();
+}
+
+bool SystemScheduler::IsRunFinished() const
+{
+    if (failed_)
+        return executing_count_ == 0;
+
+    return completed_count_ == nodes_->size();
+}
+
+void SystemScheduler::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        condition_.wait(lock, [this]() { return stop_ || (running_ && !ready_nodes_.empty()); });
+        if (stop_)
+            return;
+
+        // Workers never take the exclusive nodes
+        RunReadyNode(ready_nodes_, lock);
+    }
+}
+
+} // namespace ecs
\ No newline at end of file
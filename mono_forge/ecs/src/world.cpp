@@ -38,11 +38,15 @@ World::World(std::unique_ptr<ComponentDescriptorRegistry> component_descriptor_r
             std::unique_ptr<memory_allocator::Allocator> allocator 
                 = desc.GetAllocatorFactory().Create(*pool, desc.GetSize());
 
-            // Store the pool and allocator
+            // Store the pool, allocator and component size
             component_pools_[component_id] = std::move(pool);
             component_allocators_[component_id] = std::move(allocator);
+            component_sizes_[component_id] = desc.GetSize();
         });
     }
+
+    // Create the archetype of entities without components
+    empty_archetype_ = GetOrCreateArchetype(ArchetypeSignature());
 }
 
 World::~World()
@@ -84,6 +88,10 @@ Entity World::CreateEntity()
         // Update the generation of the entity
         entities_[entity.GetIndex()] = Entity(entity.GetIndex(), entity.GetGeneration() + 1);
 
+        // Place the entity in the archetype without components
+        entity_locations_[entity.GetIndex()] 
+            = EntityLocation{ empty_archetype_, empty_archetype_->AddRow(entities_[entity.GetIndex()]) };
+
         return entities_[entity.GetIndex()]; // Return the reused entity
     }
     else // Create a new entity
@@ -96,6 +104,9 @@ Entity World::CreateEntity()
 
         // Mark the new entity as existing
         entity_exist_flags_.emplace_back(true);
+
+        // Place the entity in the archetype without components
+        entity_locations_.emplace_back(EntityLocation{ empty_archetype_, empty_archetype_->AddRow(entities_.back()) });
         
         return entities_.back(); // Return the newly created entity
     }
@@ -109,20 +120,18 @@ bool World::DestroyEntity(const Entity& entity)
     assert(entity_exist_flags_[entity.GetIndex()]); // Ensure the entity exists
     assert(entities_[entity.GetIndex()] == entity); // Ensure the entity matches the stored
 
-    // Remove all components associated with the entity
-    if (entity_to_component_ids_.find(entity) != entity_to_component_ids_.end())
-    {
-        // Copy the component IDs to avoid modifying the set while iterating
-        std::vector<ComponentID> component_ids(
-            entity_to_component_ids_[entity].begin(), entity_to_component_ids_[entity].end());
+    // Destroy all components associated with the entity
+    EntityLocation& location = entity_locations_[entity.GetIndex()];
+    const ArchetypeSignature& signature = location.archetype->GetSignature();
+    for (size_t column = 0; column < signature.size(); ++column)
+        DestroyComponent(signature[column], location.archetype->At(location.row, column));
 
-        for (ComponentID component_id : component_ids)
-        {
-            lock.unlock(); // Unlock before calling RemoveComponentWithoutLock to avoid deadlock
-            RemoveComponent(entity, component_id); // Remove the component
-            lock.lock(); // Re-lock after removing the component
-        }
-    }
+    // Remove the row of the entity, another entity may be moved into it
+    Entity moved_entity;
+    if (location.archetype->RemoveRow(location.row, moved_entity))
+        entity_locations_[moved_entity.GetIndex()].row = location.row;
+
+    location = EntityLocation();
 
     // Mark the entity as not existing
     entity_exist_flags_[entity.GetIndex()] = false;
@@ -130,6 +139,9 @@ bool World::DestroyEntity(const Entity& entity)
     // Add the entity to the free list for reuse
     free_entities_.push_back(entity);
 
+    // Let views skip the destroyed entity
+    removal_count_.fetch_add(1, std::memory_order_release);
+
     return true; // Entity destroyed successfully
 }
 
@@ -156,23 +168,35 @@ bool World::RemoveComponent(const Entity& entity, ComponentID component_id)
 
     std::unique_lock<std::shared_mutex> lock = LockUnique(); // Lock for exclusive access
 
-    assert(component_pools_.find(component_id) != component_pools_.end()); // Ensure the component pool exists
     assert(component_allocators_.find(component_id) != component_allocators_.end()); // Ensure the component allocator exists
-    assert(entity_component_to_data_.find({entity, component_id}) != entity_component_to_data_.end()); // Ensure the component data exists
 
     // Get the component data
-    Component* component = entity_component_to_data_[{entity, component_id}];
+    EntityLocation& location = entity_locations_[entity.GetIndex()];
+    Archetype* source = location.archetype;
+    size_t column = source->FindColumn(component_id);
+    assert(column != Archetype::INVALID_COLUMN); // Ensure the component data exists
+    Component* component = source->At(location.row, column);
+
+    // Find the archetype without the component, using the cached edge if possible
+    Archetype* destination = source->GetRemoveEdge(component_id);
+    if (destination == nullptr)
+    {
+        ArchetypeSignature signature = source->GetSignature();
+        signature.erase(std::find(signature.begin(), signature.end(), component_id));
 
-    // Destroy the component instance using the destructor
-    component->~Component();
+        destination = GetOrCreateArchetype(signature);
+        source->SetRemoveEdge(component_id, destination);
+        destination->SetAddEdge(component_id, source);
+    }
 
-    // Free the memory allocated for the component using the allocator
-    component_allocators_[component_id]->Deallocate(reinterpret_cast<std::byte**>(&component));
+    // Move the entity to the destination archetype
+    MoveEntity(entity, destination);
+
+    // Destroy the component instance and free its memory
+    DestroyComponent(component_id, component);
 
-    // Remove the component data from the maps
-    entity_to_component_ids_[entity].erase(component_id);
-    component_id_to_entities_[component_id].erase(entity);
-    entity_component_to_data_.erase({entity, component_id});
+    // Let views skip the entity which lost the component
+    removal_count_.fetch_add(1, std::memory_order_release);
 
     return true; // Component removed successfully
 }
@@ -188,12 +212,8 @@ bool World::HasComponent(const Entity& entity, ComponentID component_id) const
 
     std::shared_lock<std::shared_mutex> lock = LockShared(); // Lock for shared access
 
-    // Check if the entity has the component by looking it up in the map
-    auto it = entity_to_component_ids_.find(entity);
-    if (it != entity_to_component_ids_.end())
-        return it->second.find(component_id) != it->second.end();
-    else
-        return false; // The entity has no components
+    // Check if the archetype of the entity contains the component
+    return entity_locations_[entity.GetIndex()].archetype->Contains(component_id);
 }
 
 utility_header::ConstSharedLockedValue<std::set<ComponentID>> World::GetComponentIDs(const Entity& entity) const
@@ -202,16 +222,13 @@ utility_header::ConstSharedLockedValue<std::set<ComponentID>> World::GetComponen
 
     std::shared_lock<std::shared_mutex> lock = LockShared(); // Lock for shared access
 
-    // Find the component IDs associated with the entity
-    auto it = entity_to_component_ids_.find(entity);
-
-    if (it != entity_to_component_ids_.end()) // If found, return the set of component IDs
-        return utility_header::ConstSharedLockedValue<std::set<ComponentID>>(it->second, std::move(lock));
-    else // Not found, return an empty set
-        return utility_header::ConstSharedLockedValue<std::set<ComponentID>>(empty_component_ids_, std::move(lock));
+    // The archetype of the entity holds its component IDs
+    const Archetype* archetype = entity_locations_[entity.GetIndex()].archetype;
+    return utility_header::ConstSharedLockedValue<std::set<ComponentID>>(
+        archetype->GetComponentIDSet(), std::move(lock));
 }
 
-utility_header::ConstSharedLockedValue<std::set<Entity>> World::View(ComponentID component_id) const
+EntityView World::View(ComponentID component_id) const
 {
     component_descriptor_registry_->WithSharedLock([&](const ComponentDescriptorRegistry& registry)
     {
@@ -220,13 +237,103 @@ utility_header::ConstSharedLockedValue<std::set<Entity>> World::View(ComponentID
 
     std::shared_lock<std::shared_mutex> lock = LockShared(); // Lock for shared access
 
-    // Find the entities that have the specified component
-    auto it = component_id_to_entities_.find(component_id);
+    // Copy the entities of the archetypes that contain the specified component
+    // The rows move while components are added or removed, so the view must not walk them directly
+    std::vector<Entity> entities;
+    auto it = component_archetypes_.find(component_id);
+    if (it != component_archetypes_.end())
+    {
+        size_t entity_count = 0;
+        for (const Archetype* archetype : it->second)
+            entity_count += archetype->GetRowCount();
+        entities.reserve(entity_count);
+
+        for (const Archetype* archetype : it->second)
+        {
+            for (size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+            {
+                const Entity* chunk_entities = archetype->GetChunkEntities(chunk);
+                entities.insert(entities.end(), chunk_entities, chunk_entities + archetype->GetChunkRowCount(chunk));
+            }
+        }
+    }
+
+    return EntityView(*this, component_id, std::move(entities), removal_count_.load(std::memory_order_acquire));
+}
+
+void World::AttachComponent(const Entity& entity, ComponentID component_id, Component* component)
+{
+    Archetype* source = entity_locations_[entity.GetIndex()].archetype;
+    assert(!source->Contains(component_id)); // Ensure the entity does not already have the component
+
+    // Find the archetype with the component, using the cached edge if possible
+    Archetype* destination = source->GetAddEdge(component_id);
+    if (destination == nullptr)
+    {
+        ArchetypeSignature signature = source->GetSignature();
+        signature.insert(std::upper_bound(signature.begin(), signature.end(), component_id), component_id);
+
+        destination = GetOrCreateArchetype(signature);
+        source->SetAddEdge(component_id, destination);
+        destination->SetRemoveEdge(component_id, source);
+    }
+
+    // Move the entity and store the new component in its column
+    size_t row = MoveEntity(entity, destination);
+    destination->At(row, destination->FindColumn(component_id)) = component;
+}
+
+void World::DestroyComponent(ComponentID component_id, Component* component)
+{
+    assert(component != nullptr); // Ensure the component is not null
+
+    // Destroy the component instance using the destructor
+    component->~Component();
+
+    // Free the memory allocated for the component using the allocator
+    component_allocators_[component_id]->Deallocate(reinterpret_cast<std::byte**>(&component));
+}
+
+Archetype* World::GetOrCreateArchetype(const ArchetypeSignature& signature)
+{
+    auto it = archetypes_.find(signature);
+    if (it != archetypes_.end())
+        return it->second.get(); // Already exists
+
+    // Create the archetype
+    std::unique_ptr<Archetype> archetype = std::make_unique<Archetype>(signature);
+    Archetype* archetype_ptr = archetype.get();
+    archetypes_.emplace(signature, std::move(archetype));
+
+    // Register the archetype to each of its components for views
+    for (ComponentID component_id : signature)
+        component_archetypes_[component_id].push_back(archetype_ptr);
+
+    return archetype_ptr;
+}
+
+size_t World::MoveEntity(const Entity& entity, Archetype* destination)
+{
+    EntityLocation& location = entity_locations_[entity.GetIndex()];
+    Archetype* source = location.archetype;
+
+    // Add a row to the destination and carry over the shared components
+    size_t row = destination->AddRow(entity);
+    const ArchetypeSignature& signature = source->GetSignature();
+    for (size_t column = 0; column < signature.size(); ++column)
+    {
+        size_t destination_column = destination->FindColumn(signature[column]);
+        if (destination_column != Archetype::INVALID_COLUMN)
+            destination->At(row, destination_column) = source->At(location.row, column);
+    }
+
+    // Remove the source row, another entity may be moved into it
+    Entity moved_entity;
+    if (source->RemoveRow(location.row, moved_entity))
+        entity_locations_[moved_entity.GetIndex()].row = location.row;
 
-    if (it != component_id_to_entities_.end()) // If found, return the set of entities
-        return utility_header::ConstSharedLockedValue<std::set<Entity>>(it->second, std::move(lock));
-    else // Not found, return an empty set
-        return utility_header::ConstSharedLockedValue<std::set<Entity>>(empty_entities_, std::move(lock));
+    location = EntityLocation{ destination, row };
+    return row;
 }
 
 } // namespace ecs
\ No newline at end of file
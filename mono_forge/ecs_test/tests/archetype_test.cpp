@@ -0,0 +1,376 @@
+﻿#include "ecs_test/pch.h"
+
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <set>
+
+#include "ecs/include/world.h"
+#include "ecs/include/archetype.h"
+#include "memory_allocator/include/fixed_block_allocator.h"
+
+namespace
+{
+
+// Lightweight components for archetype tests and the iteration benchmark
+class PositionComponentHandle : public ecs::ComponentHandle<PositionComponentHandle> {};
+class PositionComponent : public ecs::Component
+{
+public:
+    bool Setup(ecs::Component::SetupParam& param) override { return true; }
+    ecs::ComponentID GetID() const override { return PositionComponentHandle::ID(); }
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+class VelocityComponentHandle : public ecs::ComponentHandle<VelocityComponentHandle> {};
+class VelocityComponent : public ecs::Component
+{
+public:
+    VelocityComponent(float vx, float vy, float vz) : x(vx), y(vy), z(vz) {}
+    bool Setup(ecs::Component::SetupParam& param) override { return true; }
+    ecs::ComponentID GetID() const override { return VelocityComponentHandle::ID(); }
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+class BenchAllocatorFactory : public ecs::IComponentAllocatorFactory
+{
+public:
+    std::unique_ptr<memory_allocator::Allocator> Create(memory_allocator::Pool& pool, size_t block_size) const override
+    {
+        return std::make_unique<memory_allocator::FixedBlockAllocator>(pool, block_size);
+    }
+
+    void Destroy(std::unique_ptr<memory_allocator::Allocator>& allocator) const override
+    {
+        allocator.reset();
+    }
+
+    size_t GetProductSize() const override
+    {
+        return sizeof(memory_allocator::FixedBlockAllocator);
+    }
+};
+
+// Create a component descriptor registry with PositionComponent and VelocityComponent
+std::unique_ptr<ecs::ComponentDescriptorRegistry> CreateRegistry(size_t max_count)
+{
+    std::unique_ptr<ecs::ComponentDescriptorRegistry> registry = std::make_unique<ecs::ComponentDescriptorRegistry>();
+    ecs::RegisterComponentDescriptor<PositionComponent, BenchAllocatorFactory, PositionComponentHandle>(
+        *registry, max_count);
+    ecs::RegisterComponentDescriptor<VelocityComponent, BenchAllocatorFactory, VelocityComponentHandle>(
+        *registry, max_count);
+    return registry;
+}
+
+// A copy of the map based component layout that ecs::World used before archetypes
+// It is only used as the baseline of the iteration benchmark
+class MapBasedStorage
+{
+public:
+    MapBasedStorage(size_t max_count) :
+        position_pool_(sizeof(PositionComponent) * max_count),
+        velocity_pool_(sizeof(VelocityComponent) * max_count),
+        position_allocator_(position_pool_, sizeof(PositionComponent)),
+        velocity_allocator_(velocity_pool_, sizeof(VelocityComponent))
+    {
+    }
+
+    ~MapBasedStorage()
+    {
+        for (auto& [key, component] : entity_component_to_data_)
+        {
+            component->~Component();
+            memory_allocator::Allocator& allocator = (key.component_id == PositionComponentHandle::ID())
+                ? static_cast<memory_allocator::Allocator&>(position_allocator_)
+                : static_cast<memory_allocator::Allocator&>(velocity_allocator_);
+            allocator.Deallocate(reinterpret_cast<std::byte**>(&component));
+        }
+    }
+
+    template <typename T, typename... Args>
+    void AddComponent(const ecs::Entity& entity, ecs::ComponentID component_id, Args... args)
+    {
+        memory_allocator::Allocator& allocator = (component_id == PositionComponentHandle::ID())
+            ? static_cast<memory_allocator::Allocator&>(position_allocator_)
+            : static_cast<memory_allocator::Allocator&>(velocity_allocator_);
+
+        ecs::Component* component = new (allocator.Allocate(sizeof(T))) T(args...);
+        entity_to_component_ids_[entity].emplace(component_id);
+        component_id_to_entities_[component_id].emplace(entity);
+        entity_component_to_data_[{entity, component_id}] = component;
+    }
+
+    template <typename T>
+    T* GetComponent(const ecs::Entity& entity, ecs::ComponentID component_id)
+    {
+        auto it = entity_component_to_data_.find({entity, component_id});
+        return (it != entity_component_to_data_.end()) ? dynamic_cast<T*>(it->second) : nullptr;
+    }
+
+    const std::set<ecs::Entity>& View(ecs::ComponentID component_id)
+    {
+        return component_id_to_entities_[component_id];
+    }
+
+private:
+    struct EntityComponentKey
+    {
+        ecs::Entity entity;
+        ecs::ComponentID component_id;
+
+        bool operator==(const EntityComponentKey &other) const
+        {
+            return entity == other.entity && component_id == other.component_id;
+        }
+    };
+
+    struct EntityComponentKeyHash
+    {
+        std::size_t operator()(const EntityComponentKey &key) const
+        {
+            return std::hash<ecs::Entity>()(key.entity) ^ (std::hash<ecs::ComponentID>()(key.component_id) << 1);
+        }
+    };
+
+    memory_allocator::Pool position_pool_;
+    memory_allocator::Pool velocity_pool_;
+    memory_allocator::FixedBlockAllocator position_allocator_;
+    memory_allocator::FixedBlockAllocator velocity_allocator_;
+
+    std::unordered_map<ecs::Entity, std::set<ecs::ComponentID>> entity_to_component_ids_;
+    std::unordered_map<ecs::ComponentID, std::set<ecs::Entity>> component_id_to_entities_;
+    std::unordered_map<EntityComponentKey, ecs::Component*, EntityComponentKeyHash> entity_component_to_data_;
+};
+
+} // namespace
+
+TEST(Archetype, AddRemoveRow)
+{
+    ecs::Archetype archetype({ 1, 3 });
+    ASSERT_EQ(archetype.GetColumnCount(), 2);
+    ASSERT_TRUE(archetype.Contains(1));
+    ASSERT_TRUE(archetype.Contains(3));
+    ASSERT_FALSE(archetype.Contains(2));
+    ASSERT_EQ(archetype.FindColumn(3), 1);
+
+    // Fill more than one chunk
+    const size_t row_count = ecs::Archetype::CHUNK_ROW_COUNT + 10;
+    for (size_t i = 0; i < row_count; ++i)
+    {
+        size_t row = archetype.AddRow(ecs::Entity(i, 0));
+        ASSERT_EQ(row, i);
+    }
+    ASSERT_EQ(archetype.GetRowCount(), row_count);
+    ASSERT_EQ(archetype.GetChunkCount(), 2);
+    ASSERT_EQ(archetype.GetChunkRowCount(1), 10);
+
+    // Removing a middle row moves the last row into it
+    ecs::Entity moved_entity;
+    ASSERT_TRUE(archetype.RemoveRow(5, moved_entity));
+    ASSERT_EQ(moved_entity, ecs::Entity(row_count - 1, 0));
+    ASSERT_EQ(archetype.GetEntity(5), moved_entity);
+    ASSERT_EQ(archetype.GetRowCount(), row_count - 1);
+
+    // Removing the last row moves nothing
+    ASSERT_FALSE(archetype.RemoveRow(archetype.GetRowCount() - 1, moved_entity));
+}
+
+TEST(Archetype, WorldMovesEntityBetweenArchetypes)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+
+    ecs::World world(CreateRegistry(16));
+
+    ecs::Entity entity_a = world.CreateEntity();
+    ecs::Entity entity_b = world.CreateEntity();
+
+    ASSERT_TRUE(world.AddComponent<PositionComponent>(entity_a, PositionComponentHandle::ID(), nullptr));
+    ASSERT_TRUE(world.AddComponent<PositionComponent>(entity_b, PositionComponentHandle::ID(), nullptr));
+    world.GetComponent<PositionComponent>(entity_a, PositionComponentHandle::ID())->x = 1.0f;
+    world.GetComponent<PositionComponent>(entity_b, PositionComponentHandle::ID())->x = 2.0f;
+
+    // Moving entity_a to the {Position, Velocity} archetype keeps its position component
+    ASSERT_TRUE(world.AddComponent<VelocityComponent>(
+        entity_a, VelocityComponentHandle::ID(), nullptr, 3.0f, 0.0f, 0.0f));
+    ASSERT_TRUE(world.HasComponent(entity_a, VelocityComponentHandle::ID()));
+    ASSERT_FALSE(world.HasComponent(entity_b, VelocityComponentHandle::ID()));
+    EXPECT_EQ(world.GetComponent<PositionComponent>(entity_a, PositionComponentHandle::ID())->x, 1.0f);
+    EXPECT_EQ(world.GetComponent<PositionComponent>(entity_b, PositionComponentHandle::ID())->x, 2.0f);
+    EXPECT_EQ(world.GetComponent<VelocityComponent>(entity_a, VelocityComponentHandle::ID())->x, 3.0f);
+    EXPECT_EQ(world.GetComponent<VelocityComponent>(entity_b, VelocityComponentHandle::ID()), nullptr);
+
+    // Both archetypes appear in the position view
+    EXPECT_EQ(world.View(PositionComponentHandle::ID())().size(), 2);
+    EXPECT_EQ(world.View(VelocityComponentHandle::ID())().size(), 1);
+
+    // Component IDs follow the archetype
+    {
+        utility_header::ConstSharedLockedValue<std::set<ecs::ComponentID>> component_ids
+            = world.GetComponentIDs(entity_a);
+        EXPECT_EQ(component_ids().size(), 2);
+    }
+
+    // Removing the position component moves entity_a to the {Velocity} archetype
+    ASSERT_TRUE(world.RemoveComponent(entity_a, PositionComponentHandle::ID()));
+    ASSERT_FALSE(world.HasComponent(entity_a, PositionComponentHandle::ID()));
+    EXPECT_EQ(world.GetComponent<VelocityComponent>(entity_a, VelocityComponentHandle::ID())->x, 3.0f);
+    EXPECT_EQ(world.View(PositionComponentHandle::ID())().size(), 1);
+
+    // Destroying entity_b does not disturb entity_a
+    ASSERT_TRUE(world.DestroyEntity(entity_b));
+    EXPECT_EQ(world.View(PositionComponentHandle::ID())().size(), 0);
+    EXPECT_EQ(world.GetComponent<VelocityComponent>(entity_a, VelocityComponentHandle::ID())->x, 3.0f);
+
+    // A reused entity index starts without components
+    ecs::Entity entity_c = world.CreateEntity();
+    ASSERT_EQ(entity_c.GetIndex(), entity_b.GetIndex());
+    EXPECT_FALSE(world.HasComponent(entity_c, PositionComponentHandle::ID()));
+}
+
+TEST(Archetype, StructuralChangesInsideView)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+
+    const size_t entity_count = 10;
+    ecs::World world(CreateRegistry(entity_count * 2));
+
+    std::vector<ecs::Entity> entities;
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        entities.emplace_back(world.CreateEntity());
+        ASSERT_TRUE(world.AddComponent<PositionComponent>(entities.back(), PositionComponentHandle::ID(), nullptr));
+    }
+
+    std::unordered_map<ecs::Entity, int> visit_counts;
+    std::vector<ecs::Entity> created_entities;
+    for (const ecs::Entity& entity : world.View(PositionComponentHandle::ID())())
+    {
+        ++visit_counts[entity];
+
+        // Before any entity is reached, remove the position of the last one and destroy the one before it
+        if (visit_counts.size() == 1)
+        {
+            ASSERT_TRUE(world.RemoveComponent(entities[entity_count - 1], PositionComponentHandle::ID()));
+            ASSERT_TRUE(world.DestroyEntity(entities[entity_count - 2]));
+        }
+
+        // Moving the entity to the {Position, Velocity} archetype moves another entity into its row
+        ASSERT_TRUE(world.AddComponent<VelocityComponent>(
+            entity, VelocityComponentHandle::ID(), nullptr, 1.0f, 0.0f, 0.0f));
+
+        // A new entity with the component, it may reuse the index of the destroyed entity
+        created_entities.emplace_back(world.CreateEntity());
+        ASSERT_TRUE(world.AddComponent<PositionComponent>(
+            created_entities.back(), PositionComponentHandle::ID(), nullptr));
+    }
+
+    // Every remaining entity is visited exactly once, removed and created entities are not visited
+    ASSERT_EQ(visit_counts.size(), entity_count - 2);
+    for (size_t i = 0; i < entity_count - 2; ++i)
+    {
+        EXPECT_EQ(visit_counts[entities[i]], 1);
+        EXPECT_TRUE(world.HasComponent(entities[i], VelocityComponentHandle::ID()));
+    }
+    for (const ecs::Entity& created_entity : created_entities)
+        EXPECT_EQ(visit_counts.count(created_entity), 0);
+
+    // The next view has the created entities too
+    EXPECT_EQ(world.View(PositionComponentHandle::ID())().size(), (entity_count - 2) * 2);
+}
+
+TEST(Archetype, IterationBenchmark)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+
+    const size_t entity_count = 100000;
+    const int iteration_count = 10;
+
+    ecs::World world(CreateRegistry(entity_count));
+    MapBasedStorage map_storage(entity_count);
+
+    // Create the same entities in both storages
+    // Every other entity gets a velocity so the position view spans two archetypes
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        ecs::Entity entity = world.CreateEntity();
+        world.AddComponent<PositionComponent>(entity, PositionComponentHandle::ID(), nullptr);
+        map_storage.AddComponent<PositionComponent>(entity, PositionComponentHandle::ID());
+
+        if (i % 2 == 0)
+        {
+            world.AddComponent<VelocityComponent>(entity, VelocityComponentHandle::ID(), nullptr, 1.0f, 0.0f, 0.0f);
+            map_storage.AddComponent<VelocityComponent>(entity, VelocityComponentHandle::ID(), 1.0f, 0.0f, 0.0f);
+        }
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    double sum_map = 0.0;
+    double sum_view = 0.0;
+    double sum_for_each = 0.0;
+
+    // Map based layout: set walk + hash lookup + dynamic_cast per entity
+    Clock::time_point start = Clock::now();
+    for (int it = 0; it < iteration_count; ++it)
+    {
+        for (const ecs::Entity& entity : map_storage.View(PositionComponentHandle::ID()))
+        {
+            PositionComponent* position
+                = map_storage.GetComponent<PositionComponent>(entity, PositionComponentHandle::ID());
+            position->x += 1.0f;
+            sum_map += position->x;
+        }
+    }
+    double map_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Archetype layout through the View + GetComponent API
+    start = Clock::now();
+    for (int it = 0; it < iteration_count; ++it)
+    {
+        for (const ecs::Entity& entity : world.View(PositionComponentHandle::ID())())
+        {
+            PositionComponent* position
+                = world.GetComponent<PositionComponent>(entity, PositionComponentHandle::ID());
+            position->y += 1.0f;
+            sum_view += position->y;
+        }
+    }
+    double view_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Archetype layout through the chunk walk
+    start = Clock::now();
+    for (int it = 0; it < iteration_count; ++it)
+    {
+        world.ForEach<PositionComponent>(PositionComponentHandle::ID(),
+            [&](const ecs::Entity& entity, PositionComponent& position)
+        {
+            position.z += 1.0f;
+            sum_for_each += position.z;
+        });
+    }
+    double for_each_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // All paths visit every entity the same number of times
+    EXPECT_DOUBLE_EQ(sum_map, sum_view);
+    EXPECT_DOUBLE_EQ(sum_map, sum_for_each);
+
+    // The chunk walk has no per entity lookup, so it must beat both lookup based paths
+    EXPECT_LT(for_each_ms, map_ms);
+    EXPECT_LT(for_each_ms, view_ms);
+
+    std::cout << "Iterate " << entity_count << " entities x " << iteration_count << "\n";
+    std::cout << "  map based layout       : " << map_ms << " ms\n";
+    std::cout << "  archetype View         : " << view_ms << " ms\n";
+    std::cout << "  archetype ForEach      : " << for_each_ms << " ms\n";
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+﻿#include "ecs_test/pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "ecs/include/world.h"
+#include "ecs/include/system_scheduler.h"
+
+namespace
+{
+
+// The record of when a synthetic system ran
+struct ExecutionRecord
+{
+    size_t begin = 0; // The sequence number when the system started
+    size_t end = 0; // The sequence number when the system finished
+    std::thread::id thread_id; // The thread the system ran on
+    bool executed = false;
+};
+
+// The shared log of the synthetic systems
+struct ExecutionLog
+{
+    std::atomic<size_t> sequence{1};
+    std::atomic<size_t> running{0}; // The number of systems running now
+    std::atomic<size_t> peak_running{0}; // The most systems that ran at the same time
+    std::vector<ExecutionRecord> records;
+};
+
+// A synthetic system that declares the given access, sleeps and records when it ran
+class SyntheticSystem :
+    public ecs::System
+{
+public:
+    SyntheticSystem(
+        size_t index, ExecutionLog& log,
+        std::vector<ecs::ComponentID> reads, std::vector<ecs::ComponentID> writes,
+        bool declared = true, int sleep_ms = 0, bool result = true) :
+        index_(index), log_(log), reads_(reads), writes_(writes),
+        declared_(declared), sleep_ms_(sleep_ms), result_(result)
+    {
+    }
+
+    bool Update(ecs::World& world) override
+    {
+        ExecutionRecord& record = log_.records[index_];
+        record.begin = log_.sequence.fetch_add(1);
+        record.thread_id = std::this_thread::get_id();
+
+        size_t running = log_.running.fetch_add(1) + 1;
+        size_t peak = log_.peak_running.load();
+        while (running > peak && !log_.peak_running.compare_exchange_weak(peak, running))
+        {
+        }
+
+        if (sleep_ms_ > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+
+        log_.running.fetch_sub(1);
+        record.end = log_.sequence.fetch_add(1);
+        record.executed = true;
+        return result_;
+    }
+
+    ecs::SystemID GetID() const override { return index_; }
+
+    // The components are only accessed in the update phase
+    bool DeclareAccess(ecs::SystemPhase phase, ecs::SystemAccess& access) const override
+    {
+        if (phase != ecs::SystemPhase::Update)
+            return declared_;
+
+        for (ecs::ComponentID component_id : reads_)
+            access.Read(component_id);
+        for (ecs::ComponentID component_id : writes_)
+            access.Write(component_id);
+        return declared_;
+    }
+
+private:
+    const size_t index_;
+    ExecutionLog& log_;
+    const std::vector<ecs::ComponentID> reads_;
+    const std::vector<ecs::ComponentID> writes_;
+    const bool declared_;
+    const int sleep_ms_;
+    const bool result_;
+};
+
+std::vector<ecs::System*> ToPointers(std::vector<std::unique_ptr<ecs::System>>& systems)
+{
+    std::vector<ecs::System*> pointers;
+    for (std::unique_ptr<ecs::System>& system : systems)
+        pointers.push_back(system.get());
+    return pointers;
+}
+
+} // namespace
+
+TEST(SystemScheduler, Dependencies)
+{
+    ExecutionLog log;
+    log.records.resize(5);
+
+    std::vector<std::unique_ptr<ecs::System>> systems;
+    systems.push_back(std::make_unique<SyntheticSystem>(0, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 1 }));
+    systems.push_back(std::make_unique<SyntheticSystem>(1, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{}));
+    systems.push_back(std::make_unique<SyntheticSystem>(2, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{ 2 }));
+    systems.push_back(std::make_unique<SyntheticSystem>(3, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{}, false));
+    systems.push_back(std::make_unique<SyntheticSystem>(4, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 3 }));
+
+    ecs::SystemScheduler scheduler(0);
+    scheduler.Build(ToPointers(systems));
+
+    const ecs::SystemPhase update = ecs::SystemPhase::Update;
+    EXPECT_EQ(scheduler.GetDependencyCount(update, 0), 0); // First system
+    EXPECT_EQ(scheduler.GetDependencyCount(update, 1), 1); // Reads what 0 writes
+    EXPECT_EQ(scheduler.GetDependencyCount(update, 2), 1); // Reads what 0 writes, readers do not conflict
+    EXPECT_EQ(scheduler.GetDependencyCount(update, 3), 3); // Undeclared, depends on everything before
+    EXPECT_EQ(scheduler.GetDependencyCount(update, 4), 1); // Only depends on the undeclared system
+
+    // No component is accessed in the other phases, so only the undeclared system orders them
+    for (ecs::SystemPhase phase : { ecs::SystemPhase::PreUpdate, ecs::SystemPhase::PostUpdate })
+    {
+        EXPECT_EQ(scheduler.GetDependencyCount(phase, 0), 0);
+        EXPECT_EQ(scheduler.GetDependencyCount(phase, 1), 0);
+        EXPECT_EQ(scheduler.GetDependencyCount(phase, 2), 0);
+        EXPECT_EQ(scheduler.GetDependencyCount(phase, 3), 3);
+        EXPECT_EQ(scheduler.GetDependencyCount(phase, 4), 1);
+    }
+}
+
+TEST(SystemScheduler, WorkersStartOnDeclaredAccess)
+{
+    ExecutionLog log;
+    log.records.resize(2);
+
+    std::vector<std::unique_ptr<ecs::System>> systems;
+    systems.push_back(std::make_unique<SyntheticSystem>(
+        0, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{}, false));
+
+    // No thread is created while every system runs exclusively
+    ecs::SystemScheduler scheduler(3);
+    scheduler.Build(ToPointers(systems));
+    EXPECT_EQ(scheduler.GetWorkerCount(), 0);
+
+    systems.push_back(std::make_unique<SyntheticSystem>(
+        1, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 1 }));
+    scheduler.Build(ToPointers(systems));
+    EXPECT_EQ(scheduler.GetWorkerCount(), 3);
+}
+
+TEST(SystemScheduler, ConflictingSystemsKeepOrder)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+    ecs::World world(std::make_unique<ecs::ComponentDescriptorRegistry>());
+
+    const size_t system_count = 8;
+    ExecutionLog log;
+    log.records.resize(system_count);
+
+    // Writer, readers, writer, ... all touching component 1
+    // Plus independent systems touching component 2 in between
+    std::vector<std::unique_ptr<ecs::System>> systems;
+    systems.push_back(std::make_unique<SyntheticSystem>(0, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 1 }, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(1, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{}, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(2, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{}, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(3, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 2 }, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(4, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 1 }, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(5, log, std::vector<ecs::ComponentID>{ 2 }, std::vector<ecs::ComponentID>{}, true, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(6, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{}, false, 5));
+    systems.push_back(std::make_unique<SyntheticSystem>(7, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{ 2 }, true, 5));
+
+    ecs::SystemScheduler scheduler(4);
+    scheduler.Build(ToPointers(systems));
+
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        ASSERT_TRUE(scheduler.Run(ecs::SystemPhase::Update, world));
+
+        for (const ExecutionRecord& record : log.records)
+            ASSERT_TRUE(record.executed);
+
+        // Readers start after the writer before them finished
+        EXPECT_GT(log.records[1].begin, log.records[0].end);
+        EXPECT_GT(log.records[2].begin, log.records[0].end);
+
+        // The next writer starts after all readers before it finished
+        EXPECT_GT(log.records[4].begin, log.records[1].end);
+        EXPECT_GT(log.records[4].begin, log.records[2].end);
+
+        // The reader of component 2 waits for its writer
+        EXPECT_GT(log.records[5].begin, log.records[3].end);
+
+        // The undeclared system runs alone
+        for (size_t i = 0; i < 6; ++i)
+            EXPECT_GT(log.records[6].begin, log.records[i].end);
+        EXPECT_GT(log.records[7].begin, log.records[6].end);
+
+        // The undeclared system runs on the thread calling Run
+        EXPECT_EQ(log.records[6].thread_id, std::this_thread::get_id());
+
+        for (ExecutionRecord& record : log.records)
+            record = ExecutionRecord();
+    }
+}
+
+TEST(SystemScheduler, FailureStopsDependents)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+    ecs::World world(std::make_unique<ecs::ComponentDescriptorRegistry>());
+
+    ExecutionLog log;
+    log.records.resize(2);
+
+    std::vector<std::unique_ptr<ecs::System>> systems;
+    systems.push_back(std::make_unique<SyntheticSystem>(
+        0, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ 1 }, true, 0, false));
+    systems.push_back(std::make_unique<SyntheticSystem>(
+        1, log, std::vector<ecs::ComponentID>{ 1 }, std::vector<ecs::ComponentID>{}));
+
+    ecs::SystemScheduler scheduler(2);
+    scheduler.Build(ToPointers(systems));
+
+    EXPECT_FALSE(scheduler.Run(ecs::SystemPhase::Update, world));
+    EXPECT_TRUE(log.records[0].executed);
+    EXPECT_FALSE(log.records[1].executed);
+
+    // The scheduler can run again after a failure
+    log.records[0] = ExecutionRecord();
+    EXPECT_FALSE(scheduler.Run(ecs::SystemPhase::Update, world));
+    EXPECT_TRUE(log.records[0].executed);
+}
+
+TEST(SystemScheduler, ParallelSpeedup)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+    ecs::World world(std::make_unique<ecs::ComponentDescriptorRegistry>());
+
+    const size_t system_count = 4;
+    const int sleep_ms = 20;
+    const int frame_count = 5;
+
+    ExecutionLog log;
+    log.records.resize(system_count);
+
+    // Systems that write disjoint components
+    std::vector<std::unique_ptr<ecs::System>> systems;
+    for (size_t i = 0; i < system_count; ++i)
+    {
+        systems.push_back(std::make_unique<SyntheticSystem>(
+            i, log, std::vector<ecs::ComponentID>{}, std::vector<ecs::ComponentID>{ i }, true, sleep_ms));
+    }
+
+    // A system reading what the first one writes
+    const size_t reader_index = system_count;
+    log.records.resize(system_count + 1);
+    systems.push_back(std::make_unique<SyntheticSystem>(
+        reader_index, log, std::vector<ecs::ComponentID>{ 0 }, std::vector<ecs::ComponentID>{}, true, sleep_ms));
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Serial
+    log.peak_running = 0;
+    ecs::SystemScheduler serial_scheduler(0);
+    serial_scheduler.Build(ToPointers(systems));
+
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < frame_count; ++frame)
+        ASSERT_TRUE(serial_scheduler.Run(ecs::SystemPhase::Update, world));
+    double serial_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    EXPECT_EQ(log.peak_running, 1);
+
+    // Parallel
+    log.peak_running = 0;
+    ecs::SystemScheduler parallel_scheduler(system_count - 1);
+    parallel_scheduler.Build(ToPointers(systems));
+
+    start = Clock::now();
+    for (int frame = 0; frame < frame_count; ++frame)
+    {
+        ASSERT_TRUE(parallel_scheduler.Run(ecs::SystemPhase::Update, world));
+
+        // The reader starts after its writer finished
+        EXPECT_GT(log.records[reader_index].begin, log.records[0].end);
+    }
+    double parallel_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // The systems only sleep, so they overlap even on a single core
+    EXPECT_GT(log.peak_running, 1);
+
+    std::cout << system_count << " independent systems x " << frame_count << " frames\n";
+    std::cout << "  serial   : " << serial_ms << " ms\n";
+    std::cout << "  parallel : " << parallel_ms << " ms\n";
+    std::cout << "  peak concurrent systems : " << log.peak_running << "\n";
+}
\ No newline at end of file
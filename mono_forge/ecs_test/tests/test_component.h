@@ -4,6 +4,7 @@
 
 #include "ecs/include/component.h"
 #include "memory_allocator/include/fixed_block_allocator.h"
+#include "memory_allocator/include/growable_block_allocator.h"
 
 namespace ecs_test
 {
@@ -80,4 +81,25 @@ public:
     }
 };
 
+// The factory for creating growable allocators for the test component
+class GrowableTestComponentAllocatorFactory :
+    public ecs::IComponentAllocatorFactory
+{
+public:
+    std::unique_ptr<memory_allocator::Allocator> Create(memory_allocator::Pool& pool, size_t block_size) const override
+    {
+        return std::make_unique<memory_allocator::GrowableBlockAllocator>(pool, block_size);
+    }
+
+    void Destroy(std::unique_ptr<memory_allocator::Allocator>& allocator) const override
+    {
+        allocator.reset();
+    }
+
+    size_t GetProductSize() const override
+    {
+        return sizeof(memory_allocator::GrowableBlockAllocator);
+    }
+};
+
 } // namespace ecs_test
\ No newline at end of file
@@ -189,4 +189,51 @@ TEST(World, View)
         else
             FAIL() << "Unexpected entity in view";
     }
+}
+
+TEST(World, MaxCountIsSoftLimitWithGrowableAllocator)
+{
+    // Create singleton instance of ComponentIDGenerator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator 
+        = std::make_unique<ecs::ComponentIDGenerator>();
+
+    // Create component descriptor registry
+    std::unique_ptr<ecs::ComponentDescriptorRegistry> component_descriptor_registry 
+        = std::make_unique<ecs::ComponentDescriptorRegistry>();
+
+    // Register TestComponent with a growable allocator and a small max count
+    const size_t max_count = 2;
+    ecs::RegisterComponentDescriptor<
+        ecs_test::TestComponent, ecs_test::GrowableTestComponentAllocatorFactory, ecs_test::TestComponentHandle>(
+            *component_descriptor_registry, max_count);
+
+    // Create the world
+    ecs::World world(std::move(component_descriptor_registry));
+
+    // Add more components than the max count
+    const size_t entity_count = max_count * 10;
+    std::vector<ecs::Entity> entities;
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        ecs::Entity entity = world.CreateEntity();
+
+        std::unique_ptr<ecs_test::TestComponent::SetupParam> test_param 
+            = std::make_unique<ecs_test::TestComponent::SetupParam>();
+        test_param->value = static_cast<int>(i);
+
+        bool result = world.AddComponent<ecs_test::TestComponent>(
+            entity, ecs_test::TestComponentHandle::ID(), std::move(test_param));
+        ASSERT_TRUE(result);
+
+        entities.push_back(entity);
+    }
+
+    // Every component keeps its own data
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        ecs_test::TestComponent* test_component 
+            = world.GetComponent<ecs_test::TestComponent>(entities[i], ecs_test::TestComponentHandle::ID());
+        ASSERT_NE(test_component, nullptr);
+        ASSERT_EQ(test_component->GetData(), static_cast<int>(i));
+    }
 }
\ No newline at end of file
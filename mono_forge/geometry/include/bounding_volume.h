@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <DirectXMath.h>
+
+#include "geometry/include/dll_config.h"
+#include "geometry/include/geometry.h"
+
+namespace geometry
+{
+
+// Axis-aligned bounding box
+// An empty box has min greater than max, so merging anything into it gives the other box
+struct AABB
+{
+    DirectX::XMFLOAT3 min = DirectX::XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+    DirectX::XMFLOAT3 max = DirectX::XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    // Check if the box contains any point
+    bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+};
+
+// The result of testing a box against a frustum
+enum class FrustumTestResult
+{
+    Outside, // The box is completely outside of the frustum
+    Intersect, // The box crosses some planes of the frustum
+    Inside, // The box is completely inside of the frustum
+};
+
+// View frustum represented by six planes whose normals point inside
+// Each plane is stored as (a, b, c, d), a point p is inside if a*p.x + b*p.y + c*p.z + d >= 0
+struct Frustum
+{
+    static constexpr size_t PLANE_COUNT = 6;
+    DirectX::XMFLOAT4 planes[PLANE_COUNT] = {};
+};
+
+// Compute the bounding box of the vertex positions
+GEOMETRY_DLL AABB ComputeAABB(const Geometry::Vertex* vertices, size_t vertex_count);
+
+// Get the box which contains both boxes
+GEOMETRY_DLL AABB MergeAABB(const AABB& a, const AABB& b);
+
+// Get the surface area of the box, zero if it is empty
+GEOMETRY_DLL float ComputeSurfaceArea(const AABB& box);
+
+// Transform the box and get the box which contains the transformed one
+// The matrix is in row-vector layout as DirectXMath uses
+GEOMETRY_DLL AABB TransformAABB(const AABB& box, DirectX::FXMMATRIX matrix);
+
+// Extract the frustum planes from a view-projection matrix
+// The matrix is in row-vector layout, and the clip space depth is in [0, 1] as Direct3D uses
+GEOMETRY_DLL Frustum CreateFrustum(DirectX::FXMMATRIX view_proj_matrix);
+
+// Test the box against the frustum
+// The test is conservative, some boxes near the frustum corners are reported as intersecting
+GEOMETRY_DLL FrustumTestResult TestFrustumAABB(const Frustum& frustum, const AABB& box);
+
+} // namespace geometry
\ No newline at end of file
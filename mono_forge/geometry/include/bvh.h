@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/include/dll_config.h"
+#include "geometry/include/bounding_volume.h"
+
+namespace geometry
+{
+
+// The maximum number of primitives in a BVH leaf
+constexpr uint32_t BVH_MAX_LEAF_PRIMITIVE_COUNT = 4;
+
+// Bounding volume hierarchy over the boxes of primitives
+// Primitives are identified by their indices in the boxes passed to Build
+// Moving primitives are updated with UpdatePrimitive and applied by Refit, which only
+// recomputes the nodes above the updated primitives, so the tree shape is kept until the next Build
+class GEOMETRY_DLL BVH
+{
+public:
+    BVH() = default;
+    ~BVH() = default;
+
+    // Build the tree from the primitive boxes with the surface area heuristic
+    void Build(const std::vector<AABB>& boxes);
+
+    // Remove all primitives
+    void Clear();
+
+    // Set the box of a primitive, the tree is not updated until Refit
+    void UpdatePrimitive(uint32_t primitive_index, const AABB& box);
+
+    // Refit the nodes above the updated primitives
+    // Returns the number of refitted nodes
+    size_t Refit();
+
+    // Check if the refitted tree has degraded enough that it should be rebuilt
+    // The ratio compares the total surface area of the nodes with the one at the last Build
+    bool NeedsRebuild(float surface_area_ratio = 2.0f) const;
+
+    // Append the indices of the primitives whose boxes are not outside of the frustum
+    void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& primitive_indices) const;
+
+    // Get the box of a primitive
+    const AABB& GetPrimitiveBox(uint32_t primitive_index) const { return primitive_boxes_.at(primitive_index); }
+
+    // Get the number of primitives
+    size_t GetPrimitiveCount() const { return primitive_boxes_.size(); }
+
+    // Get the number of nodes
+    size_t GetNodeCount() const { return nodes_.size(); }
+
+    // Get the box containing all primitives
+    AABB GetBounds() const { return nodes_.empty() ? AABB() : nodes_[0].box; }
+
+private:
+    // A node of the tree
+    // Children are stored next to each other, after their parent
+    struct Node
+    {
+        AABB box;
+
+        // The range of the primitives in the subtree in primitive_indices_
+        uint32_t first_primitive = 0;
+        uint32_t primitive_count = 0;
+
+        // The index of the left child, the right one follows it, zero for leaves
+        uint32_t left_child = 0;
+
+        // The index of the parent, the root is its own parent
+        uint32_t parent = 0;
+    };
+
+    // Split the node into two children, returns false if it should stay a leaf
+    bool SplitNode(uint32_t node_index);
+
+    // Recompute the box of the node from its primitives or children
+    void ComputeNodeBox(Node& node) const;
+
+    // Compute the total surface area of the nodes
+    float ComputeTotalSurfaceArea() const;
+
+    // The nodes, the root is the first
+    std::vector<Node> nodes_;
+
+    // The primitive indices sorted so that every node covers a contiguous range
+    std::vector<uint32_t> primitive_indices_;
+
+    // The boxes of the primitives
+    std::vector<AABB> primitive_boxes_;
+
+    // The leaf which contains each primitive
+    std::vector<uint32_t> primitive_leaves_;
+
+    // The leaves containing updated primitives, and whether each node is already in the list
+    std::vector<uint32_t> dirty_nodes_;
+    std::vector<bool> is_dirty_;
+
+    // The total surface area of the nodes at the last Build
+    float built_surface_area_ = 0.0f;
+};
+
+} // namespace geometry
\ No newline at end of file
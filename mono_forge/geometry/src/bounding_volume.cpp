@@ -0,0 +1,122 @@
+﻿#include "geometry/src/pch.h"
+#include "geometry/include/bounding_volume.h"
+
+using namespace DirectX;
+
+namespace geometry
+{
+
+AABB ComputeAABB(const Geometry::Vertex* vertices, size_t vertex_count)
+{
+    AABB box;
+    if (vertex_count == 0)
+        return box; // Empty box
+
+    XMVECTOR min_vec = XMLoadFloat3(&vertices[0].position);
+    XMVECTOR max_vec = min_vec;
+    for (size_t i = 1; i < vertex_count; ++i)
+    {
+        XMVECTOR position_vec = XMLoadFloat3(&vertices[i].position);
+        min_vec = XMVectorMin(min_vec, position_vec);
+        max_vec = XMVectorMax(max_vec, position_vec);
+    }
+
+    XMStoreFloat3(&box.min, min_vec);
+    XMStoreFloat3(&box.max, max_vec);
+    return box;
+}
+
+AABB MergeAABB(const AABB& a, const AABB& b)
+{
+    AABB box;
+    XMStoreFloat3(&box.min, XMVectorMin(XMLoadFloat3(&a.min), XMLoadFloat3(&b.min)));
+    XMStoreFloat3(&box.max, XMVectorMax(XMLoadFloat3(&a.max), XMLoadFloat3(&b.max)));
+    return box;
+}
+
+float ComputeSurfaceArea(const AABB& box)
+{
+    if (!box.IsValid())
+        return 0.0f;
+
+    float x = box.max.x - box.min.x;
+    float y = box.max.y - box.min.y;
+    float z = box.max.z - box.min.z;
+    return 2.0f * (x * y + y * z + z * x);
+}
+
+AABB TransformAABB(const AABB& box, FXMMATRIX matrix)
+{
+    if (!box.IsValid())
+        return box; // Empty box stays empty
+
+    // Transform the center, and get the extents from the absolute values of the matrix
+    XMVECTOR min_vec = XMLoadFloat3(&box.min);
+    XMVECTOR max_vec = XMLoadFloat3(&box.max);
+    XMVECTOR center_vec = XMVectorScale(XMVectorAdd(min_vec, max_vec), 0.5f);
+    XMVECTOR extents_vec = XMVectorScale(XMVectorSubtract(max_vec, min_vec), 0.5f);
+
+    XMVECTOR transformed_center_vec = XMVector3TransformCoord(center_vec, matrix);
+    XMVECTOR transformed_extents_vec = XMVectorMultiply(XMVectorSplatX(extents_vec), XMVectorAbs(matrix.r[0]));
+    transformed_extents_vec = XMVectorMultiplyAdd(
+        XMVectorSplatY(extents_vec), XMVectorAbs(matrix.r[1]), transformed_extents_vec);
+    transformed_extents_vec = XMVectorMultiplyAdd(
+        XMVectorSplatZ(extents_vec), XMVectorAbs(matrix.r[2]), transformed_extents_vec);
+
+    AABB transformed;
+    XMStoreFloat3(&transformed.min, XMVectorSubtract(transformed_center_vec, transformed_extents_vec));
+    XMStoreFloat3(&transformed.max, XMVectorAdd(transformed_center_vec, transformed_extents_vec));
+    return transformed;
+}
+
+Frustum CreateFrustum(FXMMATRIX view_proj_matrix)
+{
+    // Planes are the combinations of the columns of the matrix
+    XMMATRIX columns = XMMatrixTranspose(view_proj_matrix);
+
+    XMVECTOR planes[Frustum::PLANE_COUNT] =
+    {
+        XMVectorAdd(columns.r[3], columns.r[0]), // Left
+        XMVectorSubtract(columns.r[3], columns.r[0]), // Right
+        XMVectorAdd(columns.r[3], columns.r[1]), // Bottom
+        XMVectorSubtract(columns.r[3], columns.r[1]), // Top
+        columns.r[2], // Near
+        XMVectorSubtract(columns.r[3], columns.r[2]), // Far
+    };
+
+    Frustum frustum;
+    for (size_t i = 0; i < Frustum::PLANE_COUNT; ++i)
+        XMStoreFloat4(&frustum.planes[i], XMPlaneNormalize(planes[i]));
+
+    return frustum;
+}
+
+FrustumTestResult TestFrustumAABB(const Frustum& frustum, const AABB& box)
+{
+    if (!box.IsValid())
+        return FrustumTestResult::Outside;
+
+    XMVECTOR min_vec = XMLoadFloat3(&box.min);
+    XMVECTOR max_vec = XMLoadFloat3(&box.max);
+
+    bool is_inside = true;
+    for (size_t i = 0; i < Frustum::PLANE_COUNT; ++i)
+    {
+        XMVECTOR plane_vec = XMLoadFloat4(&frustum.planes[i]);
+        XMVECTOR is_positive = XMVectorGreaterOrEqual(plane_vec, XMVectorZero());
+
+        // The corner farthest along the plane normal, and the one farthest against it
+        XMVECTOR positive_vertex = XMVectorSelect(min_vec, max_vec, is_positive);
+        XMVECTOR negative_vertex = XMVectorSelect(max_vec, min_vec, is_positive);
+
+        if (XMVectorGetX(XMPlaneDotCoord(plane_vec, positive_vertex)) < 0.0f)
+            return FrustumTestResult::Outside;
+
+        if (XMVectorGetX(XMPlaneDotCoord(plane_vec, negative_vertex)) < 0.0f)
+            is_inside = false;
+    }
+
+    return is_inside ? FrustumTestResult::Inside : FrustumTestResult::Intersect;
+}
+
+} // namespace geometry
\ No newline at end of file
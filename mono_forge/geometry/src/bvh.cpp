@@ -0,0 +1,315 @@
+﻿#include "geometry/src/pch.h"
+#include "geometry/include/bvh.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+using namespace DirectX;
+
+namespace geometry
+{
+
+namespace
+{
+
+// The number of bins along the split axis
+constexpr uint32_t SAH_BIN_COUNT = 12;
+
+// Get the center of the box along the axis
+float GetCenter(const AABB& box, int axis)
+{
+    const float* min = &box.min.x;
+    const float* max = &box.max.x;
+    return (min[axis] + max[axis]) * 0.5f;
+}
+
+} // namespace
+
+void BVH::Build(const std::vector<AABB>& boxes)
+{
+    Clear();
+    primitive_boxes_ = boxes;
+    primitive_leaves_.resize(boxes.size(), 0);
+    if (boxes.empty())
+        return;
+
+    primitive_indices_.resize(boxes.size());
+    for (uint32_t i = 0; i < primitive_indices_.size(); ++i)
+        primitive_indices_[i] = i;
+
+    // A binary tree with at least one primitive per leaf has less than twice the primitives of nodes
+    nodes_.reserve(boxes.size() * 2);
+
+    Node root;
+    root.primitive_count = static_cast<uint32_t>(boxes.size());
+    nodes_.push_back(root);
+    ComputeNodeBox(nodes_[0]);
+
+    // Split the nodes top-down, children are pushed after their parent
+    std::vector<uint32_t> stack = { 0 };
+    while (!stack.empty())
+    {
+        uint32_t node_index = stack.back();
+        stack.pop_back();
+
+        if (!SplitNode(node_index))
+        {
+            // Record the leaf of each primitive
+            const Node& leaf = nodes_[node_index];
+            for (uint32_t i = leaf.first_primitive; i < leaf.first_primitive + leaf.primitive_count; ++i)
+                primitive_leaves_[primitive_indices_[i]] = node_index;
+            continue;
+        }
+
+        stack.push_back(nodes_[node_index].left_child + 1);
+        stack.push_back(nodes_[node_index].left_child);
+    }
+
+    is_dirty_.resize(nodes_.size(), false);
+    built_surface_area_ = ComputeTotalSurfaceArea();
+}
+
+void BVH::Clear()
+{
+    nodes_.clear();
+    primitive_indices_.clear();
+    primitive_boxes_.clear();
+    primitive_leaves_.clear();
+    dirty_nodes_.clear();
+    is_dirty_.clear();
+    built_surface_area_ = 0.0f;
+}
+
+void BVH::UpdatePrimitive(uint32_t primitive_index, const AABB& box)
+{
+    assert(primitive_index < primitive_boxes_.size() && "Primitive index out of range.");
+    primitive_boxes_[primitive_index] = box;
+
+    // Mark the leaf and its ancestors, stopping at the first one already marked
+    uint32_t node_index = primitive_leaves_[primitive_index];
+    while (!is_dirty_[node_index])
+    {
+        is_dirty_[node_index] = true;
+        dirty_nodes_.push_back(node_index);
+
+        if (node_index == 0)
+            break; // Root reached
+
+        node_index = nodes_[node_index].parent;
+    }
+}
+
+size_t BVH::Refit()
+{
+    // Children have larger indices than their parents, so refitting in descending order
+    // updates every child before its parent
+    std::sort(dirty_nodes_.begin(), dirty_nodes_.end(), std::greater<uint32_t>());
+    for (const uint32_t& node_index : dirty_nodes_)
+    {
+        ComputeNodeBox(nodes_[node_index]);
+        is_dirty_[node_index] = false;
+    }
+
+    size_t refitted_count = dirty_nodes_.size();
+    dirty_nodes_.clear();
+    return refitted_count;
+}
+
+bool BVH::NeedsRebuild(float surface_area_ratio) const
+{
+    if (nodes_.empty() || built_surface_area_ <= 0.0f)
+        return false;
+
+    return ComputeTotalSurfaceArea() > built_surface_area_ * surface_area_ratio;
+}
+
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& primitive_indices) const
+{
+    if (nodes_.empty())
+        return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+
+    while (!stack.empty())
+    {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+
+        FrustumTestResult result = TestFrustumAABB(frustum, node.box);
+        if (result == FrustumTestResult::Outside)
+            continue;
+
+        const uint32_t* first = primitive_indices_.data() + node.first_primitive;
+        if (result == FrustumTestResult::Inside)
+        {
+            // The whole subtree is visible without testing further
+            primitive_indices.insert(primitive_indices.end(), first, first + node.primitive_count);
+            continue;
+        }
+
+        if (node.left_child == 0)
+        {
+            // Test each primitive of the leaf
+            for (uint32_t i = 0; i < node.primitive_count; ++i)
+            {
+                if (TestFrustumAABB(frustum, primitive_boxes_[first[i]]) != FrustumTestResult::Outside)
+                    primitive_indices.push_back(first[i]);
+            }
+            continue;
+        }
+
+        stack.push_back(node.left_child + 1);
+        stack.push_back(node.left_child);
+    }
+}
+
+bool BVH::SplitNode(uint32_t node_index)
+{
+    Node node = nodes_[node_index];
+    if (node.primitive_count <= BVH_MAX_LEAF_PRIMITIVE_COUNT)
+        return false;
+
+    uint32_t* first = primitive_indices_.data() + node.first_primitive;
+
+    // Find the bounds of the primitive centers
+    XMFLOAT3 center_min(FLT_MAX, FLT_MAX, FLT_MAX);
+    XMFLOAT3 center_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (uint32_t i = 0; i < node.primitive_count; ++i)
+    {
+        const AABB& box = primitive_boxes_[first[i]];
+        XMFLOAT3 center(GetCenter(box, 0), GetCenter(box, 1), GetCenter(box, 2));
+        center_min = XMFLOAT3(
+            std::min(center_min.x, center.x), std::min(center_min.y, center.y), std::min(center_min.z, center.z));
+        center_max = XMFLOAT3(
+            std::max(center_max.x, center.x), std::max(center_max.y, center.y), std::max(center_max.z, center.z));
+    }
+
+    // Find the cheapest split among the bin boundaries of all axes
+    float best_cost = FLT_MAX;
+    int best_axis = -1;
+    uint32_t best_bin = 0;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float axis_min = (&center_min.x)[axis];
+        float axis_extent = (&center_max.x)[axis] - axis_min;
+        if (axis_extent <= 0.0f)
+            continue; // All centers are on a plane
+
+        // Put the primitives into the bins
+        AABB bin_boxes[SAH_BIN_COUNT];
+        uint32_t bin_counts[SAH_BIN_COUNT] = {};
+        float scale = SAH_BIN_COUNT / axis_extent;
+        for (uint32_t i = 0; i < node.primitive_count; ++i)
+        {
+            const AABB& box = primitive_boxes_[first[i]];
+            uint32_t bin = std::min(
+                SAH_BIN_COUNT - 1, static_cast<uint32_t>((GetCenter(box, axis) - axis_min) * scale));
+            bin_boxes[bin] = MergeAABB(bin_boxes[bin], box);
+            bin_counts[bin]++;
+        }
+
+        // Sweep from the right to get the cost of the right side of each boundary
+        float right_areas[SAH_BIN_COUNT] = {};
+        uint32_t right_counts[SAH_BIN_COUNT] = {};
+        AABB right_box;
+        uint32_t right_count = 0;
+        for (uint32_t bin = SAH_BIN_COUNT - 1; bin > 0; --bin)
+        {
+            right_box = MergeAABB(right_box, bin_boxes[bin]);
+            right_count += bin_counts[bin];
+            right_areas[bin] = ComputeSurfaceArea(right_box);
+            right_counts[bin] = right_count;
+        }
+
+        // Sweep from the left and evaluate each boundary
+        AABB left_box;
+        uint32_t left_count = 0;
+        for (uint32_t bin = 0; bin < SAH_BIN_COUNT - 1; ++bin)
+        {
+            left_box = MergeAABB(left_box, bin_boxes[bin]);
+            left_count += bin_counts[bin];
+            if (left_count == 0 || right_counts[bin + 1] == 0)
+                continue;
+
+            float cost = ComputeSurfaceArea(left_box) * left_count + right_areas[bin + 1] * right_counts[bin + 1];
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = bin;
+            }
+        }
+    }
+
+    uint32_t left_count = 0;
+    if (best_axis >= 0)
+    {
+        // Partition the primitives by the chosen boundary
+        float axis_min = (&center_min.x)[best_axis];
+        float scale = SAH_BIN_COUNT / ((&center_max.x)[best_axis] - axis_min);
+        uint32_t* middle = std::partition(first, first + node.primitive_count, [&](uint32_t primitive_index)
+        {
+            uint32_t bin = std::min(
+                SAH_BIN_COUNT - 1,
+                static_cast<uint32_t>((GetCenter(primitive_boxes_[primitive_index], best_axis) - axis_min) * scale));
+            return bin <= best_bin;
+        });
+        left_count = static_cast<uint32_t>(middle - first);
+    }
+    else
+    {
+        // All centers are at the same point, split in half to keep the leaves small
+        left_count = node.primitive_count / 2;
+    }
+
+    assert(left_count != 0 && left_count != node.primitive_count && "Invalid split.");
+
+    // Create the children
+    uint32_t left_child = static_cast<uint32_t>(nodes_.size());
+
+    Node left;
+    left.first_primitive = node.first_primitive;
+    left.primitive_count = left_count;
+    left.parent = node_index;
+    ComputeNodeBox(left);
+
+    Node right;
+    right.first_primitive = node.first_primitive + left_count;
+    right.primitive_count = node.primitive_count - left_count;
+    right.parent = node_index;
+    ComputeNodeBox(right);
+
+    nodes_.push_back(left);
+    nodes_.push_back(right);
+    nodes_[node_index].left_child = left_child;
+
+    return true;
+}
+
+void BVH::ComputeNodeBox(Node& node) const
+{
+    AABB box;
+    if (node.left_child != 0)
+    {
+        box = MergeAABB(nodes_[node.left_child].box, nodes_[node.left_child + 1].box);
+    }
+    else
+    {
+        for (uint32_t i = node.first_primitive; i < node.first_primitive + node.primitive_count; ++i)
+            box = MergeAABB(box, primitive_boxes_[primitive_indices_[i]]);
+    }
+    node.box = box;
+}
+
+float BVH::ComputeTotalSurfaceArea() const
+{
+    float total = 0.0f;
+    for (const Node& node : nodes_)
+        total += ComputeSurfaceArea(node.box);
+    return total;
+}
+
+} // namespace geometry
\ No newline at end of file
@@ -0,0 +1,119 @@
+﻿#include "geometry_test/pch.h"
+
+#include "geometry/include/bounding_volume.h"
+using namespace DirectX;
+
+namespace bounding_volume_test
+{
+
+// Create a box from its corners
+geometry::AABB MakeBox(const XMFLOAT3& min, const XMFLOAT3& max)
+{
+    geometry::AABB box;
+    box.min = min;
+    box.max = max;
+    return box;
+}
+
+// Create the frustum of a camera at the origin looking along +z
+geometry::Frustum MakeCameraFrustum()
+{
+    XMMATRIX view = XMMatrixLookAtLH(
+        XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 1.0f, 100.0f);
+    return geometry::CreateFrustum(XMMatrixMultiply(view, proj));
+}
+
+} // namespace bounding_volume_test
+
+TEST(BoundingVolume, ComputeAABB)
+{
+    geometry::Geometry::Vertex vertices[3] = {};
+    vertices[0].position = XMFLOAT3(1.0f, -2.0f, 3.0f);
+    vertices[1].position = XMFLOAT3(-1.0f, 4.0f, 0.5f);
+    vertices[2].position = XMFLOAT3(0.0f, 0.0f, -3.0f);
+
+    geometry::AABB box = geometry::ComputeAABB(vertices, 3);
+    EXPECT_TRUE(box.IsValid());
+    EXPECT_FLOAT_EQ(box.min.x, -1.0f);
+    EXPECT_FLOAT_EQ(box.min.y, -2.0f);
+    EXPECT_FLOAT_EQ(box.min.z, -3.0f);
+    EXPECT_FLOAT_EQ(box.max.x, 1.0f);
+    EXPECT_FLOAT_EQ(box.max.y, 4.0f);
+    EXPECT_FLOAT_EQ(box.max.z, 3.0f);
+
+    // No vertices gives an empty box
+    EXPECT_FALSE(geometry::ComputeAABB(vertices, 0).IsValid());
+    EXPECT_FLOAT_EQ(geometry::ComputeSurfaceArea(geometry::AABB()), 0.0f);
+
+    // Merging into an empty box gives the other box
+    geometry::AABB merged = geometry::MergeAABB(geometry::AABB(), box);
+    EXPECT_FLOAT_EQ(merged.min.x, box.min.x);
+    EXPECT_FLOAT_EQ(merged.max.z, box.max.z);
+    EXPECT_FLOAT_EQ(geometry::ComputeSurfaceArea(box), 2.0f * (2.0f * 6.0f + 6.0f * 6.0f + 6.0f * 2.0f));
+}
+
+TEST(BoundingVolume, TransformAABB)
+{
+    geometry::AABB box = bounding_volume_test::MakeBox(XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+    // Scale and translation
+    geometry::AABB moved = geometry::TransformAABB(
+        box, XMMatrixScaling(2.0f, 1.0f, 3.0f) * XMMatrixTranslation(10.0f, 0.0f, -5.0f));
+    EXPECT_NEAR(moved.min.x, 8.0f, 1e-5f);
+    EXPECT_NEAR(moved.max.x, 12.0f, 1e-5f);
+    EXPECT_NEAR(moved.min.y, -1.0f, 1e-5f);
+    EXPECT_NEAR(moved.max.y, 1.0f, 1e-5f);
+    EXPECT_NEAR(moved.min.z, -8.0f, 1e-5f);
+    EXPECT_NEAR(moved.max.z, -2.0f, 1e-5f);
+
+    // Rotating 45 degrees around y grows the box to the diagonal
+    geometry::AABB rotated = geometry::TransformAABB(box, XMMatrixRotationY(XM_PIDIV4));
+    EXPECT_NEAR(rotated.max.x, 1.41421356f, 1e-5f);
+    EXPECT_NEAR(rotated.min.z, -1.41421356f, 1e-5f);
+    EXPECT_NEAR(rotated.max.y, 1.0f, 1e-5f);
+
+    // An empty box stays empty
+    EXPECT_FALSE(geometry::TransformAABB(geometry::AABB(), XMMatrixTranslation(1.0f, 2.0f, 3.0f)).IsValid());
+}
+
+TEST(BoundingVolume, FrustumTest)
+{
+    geometry::Frustum frustum = bounding_volume_test::MakeCameraFrustum();
+
+    // In front of the camera
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(-1.0f, -1.0f, 10.0f), XMFLOAT3(1.0f, 1.0f, 12.0f))),
+        geometry::FrustumTestResult::Inside);
+
+    // Behind the camera
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(-1.0f, -1.0f, -12.0f), XMFLOAT3(1.0f, 1.0f, -10.0f))),
+        geometry::FrustumTestResult::Outside);
+
+    // Beyond the far plane
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(-1.0f, -1.0f, 101.0f), XMFLOAT3(1.0f, 1.0f, 103.0f))),
+        geometry::FrustumTestResult::Outside);
+
+    // Out of the side, the field of view is 90 degrees so x > z is outside
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(20.0f, -1.0f, 10.0f), XMFLOAT3(22.0f, 1.0f, 12.0f))),
+        geometry::FrustumTestResult::Outside);
+
+    // Crossing the left plane
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(-12.0f, -1.0f, 9.0f), XMFLOAT3(-8.0f, 1.0f, 11.0f))),
+        geometry::FrustumTestResult::Intersect);
+
+    // Crossing the near plane
+    EXPECT_EQ(
+        geometry::TestFrustumAABB(frustum, bounding_volume_test::MakeBox(
+            XMFLOAT3(-0.1f, -0.1f, 0.5f), XMFLOAT3(0.1f, 0.1f, 1.5f))),
+        geometry::FrustumTestResult::Intersect);
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+﻿#include "geometry_test/pch.h"
+
+#include <algorithm>
+#include <random>
+
+#include "geometry/include/bvh.h"
+using namespace DirectX;
+
+namespace bvh_test
+{
+
+// Create boxes of random sizes scattered in a cube
+std::vector<geometry::AABB> MakeRandomBoxes(size_t count, float extent, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> size(0.1f, 2.0f);
+
+    std::vector<geometry::AABB> boxes(count);
+    for (geometry::AABB& box : boxes)
+    {
+        box.min = XMFLOAT3(position(random), position(random), position(random));
+        box.max = XMFLOAT3(box.min.x + size(random), box.min.y + size(random), box.min.z + size(random));
+    }
+    return boxes;
+}
+
+// Create the frustum of a camera at the position looking along +z
+geometry::Frustum MakeCameraFrustum(const XMFLOAT3& position)
+{
+    XMVECTOR eye = XMLoadFloat3(&position);
+    XMMATRIX view = XMMatrixLookAtLH(
+        eye, XMVectorAdd(eye, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 200.0f);
+    return geometry::CreateFrustum(XMMatrixMultiply(view, proj));
+}
+
+// Get the indices of the boxes not outside of the frustum by testing all of them
+std::vector<uint32_t> BruteForceQuery(const geometry::Frustum& frustum, const std::vector<geometry::AABB>& boxes)
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        if (geometry::TestFrustumAABB(frustum, boxes[i]) != geometry::FrustumTestResult::Outside)
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+// Query the tree and sort the result to compare with the brute force one
+std::vector<uint32_t> SortedQuery(const geometry::BVH& bvh, const geometry::Frustum& frustum)
+{
+    std::vector<uint32_t> indices;
+    bvh.QueryFrustum(frustum, indices);
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+} // namespace bvh_test
+
+TEST(BVH, Build)
+{
+    geometry::BVH bvh;
+    EXPECT_EQ(bvh.GetNodeCount(), 0);
+    EXPECT_FALSE(bvh.GetBounds().IsValid());
+
+    std::vector<geometry::AABB> boxes = bvh_test::MakeRandomBoxes(1000, 100.0f, 1);
+    bvh.Build(boxes);
+    EXPECT_EQ(bvh.GetPrimitiveCount(), boxes.size());
+    EXPECT_GT(bvh.GetNodeCount(), 1);
+
+    // The root contains all boxes
+    geometry::AABB bounds = bvh.GetBounds();
+    for (const geometry::AABB& box : boxes)
+    {
+        EXPECT_LE(bounds.min.x, box.min.x);
+        EXPECT_LE(bounds.min.y, box.min.y);
+        EXPECT_LE(bounds.min.z, box.min.z);
+        EXPECT_GE(bounds.max.x, box.max.x);
+        EXPECT_GE(bounds.max.y, box.max.y);
+        EXPECT_GE(bounds.max.z, box.max.z);
+    }
+
+    // A freshly built tree does not need rebuilding
+    EXPECT_FALSE(bvh.NeedsRebuild());
+
+    bvh.Clear();
+    EXPECT_EQ(bvh.GetPrimitiveCount(), 0);
+    EXPECT_EQ(bvh.GetNodeCount(), 0);
+}
+
+TEST(BVH, QueryMatchesBruteForce)
+{
+    std::vector<geometry::AABB> boxes = bvh_test::MakeRandomBoxes(5000, 100.0f, 2);
+
+    geometry::BVH bvh;
+    bvh.Build(boxes);
+
+    for (const XMFLOAT3& position : {
+        XMFLOAT3(0.0f, 0.0f, -150.0f), XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(50.0f, -30.0f, 20.0f),
+        XMFLOAT3(0.0f, 0.0f, 150.0f) })
+    {
+        geometry::Frustum frustum = bvh_test::MakeCameraFrustum(position);
+        EXPECT_EQ(bvh_test::SortedQuery(bvh, frustum), bvh_test::BruteForceQuery(frustum, boxes));
+    }
+}
+
+TEST(BVH, RefitMatchesBruteForce)
+{
+    std::vector<geometry::AABB> boxes = bvh_test::MakeRandomBoxes(5000, 100.0f, 3);
+
+    geometry::BVH bvh;
+    bvh.Build(boxes);
+
+    // Move some boxes far from where they were
+    std::mt19937 random(4);
+    std::uniform_int_distribution<uint32_t> index(0, static_cast<uint32_t>(boxes.size() - 1));
+    std::uniform_real_distribution<float> offset(-50.0f, 50.0f);
+    for (int i = 0; i < 50; ++i)
+    {
+        uint32_t moved_index = index(random);
+        XMFLOAT3 move(offset(random), offset(random), offset(random));
+        geometry::AABB& box = boxes[moved_index];
+        box.min = XMFLOAT3(box.min.x + move.x, box.min.y + move.y, box.min.z + move.z);
+        box.max = XMFLOAT3(box.max.x + move.x, box.max.y + move.y, box.max.z + move.z);
+        bvh.UpdatePrimitive(moved_index, box);
+    }
+
+    // Only the nodes above the moved boxes are refitted
+    size_t refitted_count = bvh.Refit();
+    EXPECT_GT(refitted_count, 0);
+    EXPECT_LT(refitted_count, bvh.GetNodeCount());
+
+    // Nothing to refit the second time
+    EXPECT_EQ(bvh.Refit(), 0);
+
+    geometry::Frustum frustum = bvh_test::MakeCameraFrustum(XMFLOAT3(0.0f, 0.0f, -150.0f));
+    EXPECT_EQ(bvh_test::SortedQuery(bvh, frustum), bvh_test::BruteForceQuery(frustum, boxes));
+}
+
+TEST(BVH, NeedsRebuild)
+{
+    std::vector<geometry::AABB> boxes = bvh_test::MakeRandomBoxes(1000, 10.0f, 5);
+
+    geometry::BVH bvh;
+    bvh.Build(boxes);
+
+    // Scatter all boxes over a much larger space, so the refitted nodes overlap a lot
+    std::vector<geometry::AABB> scattered = bvh_test::MakeRandomBoxes(boxes.size(), 1000.0f, 6);
+    for (uint32_t i = 0; i < scattered.size(); ++i)
+        bvh.UpdatePrimitive(i, scattered[i]);
+    bvh.Refit();
+    EXPECT_TRUE(bvh.NeedsRebuild());
+
+    // The refitted tree is still correct
+    geometry::Frustum frustum = bvh_test::MakeCameraFrustum(XMFLOAT3(0.0f, 0.0f, -100.0f));
+    EXPECT_EQ(bvh_test::SortedQuery(bvh, frustum), bvh_test::BruteForceQuery(frustum, scattered));
+
+    bvh.Build(scattered);
+    EXPECT_FALSE(bvh.NeedsRebuild());
+}
\ No newline at end of file
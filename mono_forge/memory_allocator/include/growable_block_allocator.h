@@ -0,0 +1,113 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "memory_allocator/include/dll_config.h"
+#include "memory_allocator/include/allocator.h"
+
+namespace memory_allocator
+{
+
+// The statistics of an allocator
+struct AllocatorStatistics
+{
+    size_t block_size = 0; // The size of each block
+    size_t live_count = 0; // The number of blocks currently allocated
+    size_t peak_count = 0; // The highest number of blocks allocated at once
+    size_t total_allocation_count = 0; // The number of Allocate calls
+    size_t total_deallocation_count = 0; // The number of Deallocate calls
+    size_t requested_bytes = 0; // The total bytes requested by Allocate calls
+    size_t capacity = 0; // The number of blocks in all pools
+    size_t pool_count = 0; // The number of pools including the initial pool
+
+    // The ratio of reserved blocks that are not in use
+    double GetFreeRatio() const
+    {
+        return capacity == 0 ? 0.0 : 1.0 - static_cast<double>(live_count) / static_cast<double>(capacity);
+    }
+
+    // The ratio of allocated block bytes that were not requested
+    double GetInternalFragmentation() const
+    {
+        size_t allocated_bytes = total_allocation_count * block_size;
+        return allocated_bytes == 0 ?
+            0.0 : 1.0 - static_cast<double>(requested_bytes) / static_cast<double>(allocated_bytes);
+    }
+};
+
+// The fixed block allocator that can be used from multiple threads and grows on demand
+// The given pool is used first, when it is exhausted a new pool is chained
+// with as many blocks as the allocator already has, so the block count doubles each time
+// Allocate and Deallocate are lock-free, only growing a pool takes a lock
+class MEMORY_ALLOCATOR_DLL GrowableBlockAllocator :
+    public Allocator
+{
+public:
+    GrowableBlockAllocator(Pool& pool, size_t block_size);
+    virtual ~GrowableBlockAllocator();
+
+    // Allocate a block of memory of the given size
+    std::byte* Allocate(size_t size) override;
+
+    // Deallocate a previously allocated block of memory
+    void Deallocate(std::byte** ptr) override;
+
+    // Get a snapshot of the statistics
+    AllocatorStatistics GetStatistics() const;
+
+private:
+    // The maximum number of pools, including the initial pool
+    static constexpr size_t MAX_POOL_COUNT = 32;
+
+    // The index used as the end of the free list
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    // The link stored in a free block
+    struct FreeBlock { std::atomic<uint32_t> next; };
+
+    // Get the pool index and the first block index of the pool that holds the block index
+    void FindPool(uint32_t index, size_t& pool_index, size_t& first_index) const;
+
+    // Get the block memory of the block index
+    std::byte* GetBlock(uint32_t index) const;
+
+    // Get the block index of the block memory
+    uint32_t GetIndex(const std::byte* block) const;
+
+    // Push the linked blocks from first to last onto the free list
+    void Push(uint32_t first, uint32_t last);
+
+    // Pop a block from the free list, return false if the free list is empty
+    bool Pop(uint32_t& index);
+
+    // Chain a new pool if the free list is still empty
+    void Grow();
+
+    // Pack the free list head from the tag and the block index
+    // The tag is incremented on every change to avoid the ABA problem
+    static uint64_t PackHead(uint32_t tag, uint32_t index)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    std::atomic<uint64_t> free_head_; // The tagged head of the free list
+
+    std::atomic<std::byte*> pool_blocks_[MAX_POOL_COUNT]; // The first block of each pool
+    std::atomic<size_t> pool_count_{0}; // The number of pools in use
+    std::vector<std::unique_ptr<Pool>> grown_pools_; // The pools created by growing
+    std::mutex grow_mutex_; // The mutex used to grow one pool at a time
+
+    // The statistics counters
+    std::atomic<size_t> live_count_{0};
+    std::atomic<size_t> peak_count_{0};
+    std::atomic<size_t> total_allocation_count_{0};
+    std::atomic<size_t> total_deallocation_count_{0};
+    std::atomic<size_t> requested_bytes_{0};
+};
+
+} // namespace memory_allocator
\ No newline at end of file
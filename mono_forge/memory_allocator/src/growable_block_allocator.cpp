@@ -0,0 +1,212 @@
+﻿#include "memory_allocator/src/pch.h"
+#include "memory_allocator/include/growable_block_allocator.h"
+
+namespace memory_allocator
+{
+
+GrowableBlockAllocator::GrowableBlockAllocator(Pool& pool, size_t block_size) :
+    Allocator(pool, block_size),
+    free_head_(PackHead(0, INVALID_INDEX))
+{
+    assert(block_size_ >= sizeof(FreeBlock)); // Block must be able to hold the free list link
+    assert(block_count_ < INVALID_INDEX); // Block indices must fit in 32 bits
+
+    for (std::atomic<std::byte*>& blocks : pool_blocks_)
+        blocks.store(nullptr, std::memory_order_relaxed);
+
+    // Use the given pool as the first pool
+    pool_blocks_[0].store(pool_.Get(), std::memory_order_release);
+    pool_count_.store(1, std::memory_order_release);
+
+    // Link all blocks of the first pool and push them onto the free list
+    for (size_t i = 0; i < block_count_; ++i)
+    {
+        FreeBlock* block = new (pool_.Get() + i * block_size_) FreeBlock();
+        block->next.store((i + 1 < block_count_) ? static_cast<uint32_t>(i + 1) : INVALID_INDEX, std::memory_order_relaxed);
+    }
+    Push(0, static_cast<uint32_t>(block_count_ - 1));
+}
+
+GrowableBlockAllocator::~GrowableBlockAllocator()
+{
+    // The grown pools are released with grown_pools_
+    free_head_.store(PackHead(0, INVALID_INDEX), std::memory_order_relaxed);
+}
+
+std::byte* GrowableBlockAllocator::Allocate(size_t size)
+{
+    assert(size <= block_size_); // Size must be less than or equal to block size
+
+    uint32_t index = INVALID_INDEX;
+    while (!Pop(index))
+        Grow(); // The free list is empty, chain a new pool
+
+    // Update the statistics
+    size_t live_count = live_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak_count = peak_count_.load(std::memory_order_relaxed);
+    while (live_count > peak_count &&
+        !peak_count_.compare_exchange_weak(peak_count, live_count, std::memory_order_relaxed));
+    total_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+    requested_bytes_.fetch_add(size, std::memory_order_relaxed);
+
+    return GetBlock(index);
+}
+
+void GrowableBlockAllocator::Deallocate(std::byte** ptr)
+{
+    assert(ptr != nullptr); // Pointer must not be null
+    assert(*ptr != nullptr); // Pointer to memory must not be null
+
+    // Turn the block back into a free block and push it
+    uint32_t index = GetIndex(*ptr);
+    new (*ptr) FreeBlock();
+    Push(index, index);
+
+    // Update the statistics
+    live_count_.fetch_sub(1, std::memory_order_relaxed);
+    total_deallocation_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // Reset the memory to nullptr
+    *ptr = nullptr;
+}
+
+AllocatorStatistics GrowableBlockAllocator::GetStatistics() const
+{
+    AllocatorStatistics statistics;
+    statistics.block_size = block_size_;
+    statistics.live_count = live_count_.load(std::memory_order_relaxed);
+    statistics.peak_count = peak_count_.load(std::memory_order_relaxed);
+    statistics.total_allocation_count = total_allocation_count_.load(std::memory_order_relaxed);
+    statistics.total_deallocation_count = total_deallocation_count_.load(std::memory_order_relaxed);
+    statistics.requested_bytes = requested_bytes_.load(std::memory_order_relaxed);
+    statistics.pool_count = pool_count_.load(std::memory_order_acquire);
+
+    // The pools double the capacity each time
+    statistics.capacity = block_count_ << (statistics.pool_count - 1);
+
+    return statistics;
+}
+
+void GrowableBlockAllocator::FindPool(uint32_t index, size_t& pool_index, size_t& first_index) const
+{
+    // Pool 0 holds block_count_ blocks, pool k holds block_count_ << (k - 1) blocks
+    pool_index = 0;
+    first_index = 0;
+    size_t pool_block_count = block_count_;
+    while (index >= first_index + pool_block_count)
+    {
+        first_index += pool_block_count;
+        if (pool_index != 0)
+            pool_block_count *= 2;
+        pool_index++;
+    }
+
+    assert(pool_index < pool_count_.load(std::memory_order_acquire)); // Ensure the pool exists
+}
+
+std::byte* GrowableBlockAllocator::GetBlock(uint32_t index) const
+{
+    size_t pool_index = 0;
+    size_t first_index = 0;
+    FindPool(index, pool_index, first_index);
+
+    return pool_blocks_[pool_index].load(std::memory_order_acquire) + (index - first_index) * block_size_;
+}
+
+uint32_t GrowableBlockAllocator::GetIndex(const std::byte* block) const
+{
+    // Find the pool whose memory range contains the block
+    size_t pool_count = pool_count_.load(std::memory_order_acquire);
+    size_t first_index = 0;
+    size_t pool_block_count = block_count_;
+    for (size_t pool_index = 0; pool_index < pool_count; ++pool_index)
+    {
+        const std::byte* blocks = pool_blocks_[pool_index].load(std::memory_order_acquire);
+        if (block >= blocks && block < blocks + pool_block_count * block_size_)
+        {
+            assert((block - blocks) % block_size_ == 0); // Ensure the pointer is at a block boundary
+            return static_cast<uint32_t>(first_index + (block - blocks) / block_size_);
+        }
+
+        first_index += pool_block_count;
+        if (pool_index != 0)
+            pool_block_count *= 2;
+    }
+
+    assert(false && "The block does not belong to this allocator!");
+    return INVALID_INDEX;
+}
+
+void GrowableBlockAllocator::Push(uint32_t first, uint32_t last)
+{
+    FreeBlock* last_block = reinterpret_cast<FreeBlock*>(GetBlock(last));
+
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    uint64_t new_head = 0;
+    do
+    {
+        // Link the last block to the current head
+        last_block->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        new_head = PackHead(static_cast<uint32_t>(head >> 32) + 1, first);
+    }
+    while (!free_head_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool GrowableBlockAllocator::Pop(uint32_t& index)
+{
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (true)
+    {
+        uint32_t head_index = static_cast<uint32_t>(head);
+        if (head_index == INVALID_INDEX)
+            return false; // The free list is empty
+
+        // The block may be taken by another thread meanwhile,
+        // in that case the tag has changed and the exchange fails
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(GetBlock(head_index));
+        uint32_t next = block->next.load(std::memory_order_relaxed);
+
+        uint64_t new_head = PackHead(static_cast<uint32_t>(head >> 32) + 1, next);
+        if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            index = head_index;
+            return true;
+        }
+    }
+}
+
+void GrowableBlockAllocator::Grow()
+{
+    std::unique_lock<std::mutex> lock(grow_mutex_);
+
+    // Another thread may have grown or freed blocks meanwhile
+    if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) != INVALID_INDEX)
+        return;
+
+    size_t pool_index = pool_count_.load(std::memory_order_acquire);
+    assert(pool_index < MAX_POOL_COUNT && "The allocator reached the maximum pool count!");
+
+    // The new pool holds as many blocks as all existing pools
+    size_t first_index = block_count_ << (pool_index - 1);
+    size_t pool_block_count = first_index;
+    assert(first_index + pool_block_count < INVALID_INDEX && "The allocator reached the maximum block count!");
+
+    // Create the pool and link its blocks
+    std::unique_ptr<Pool> pool = std::make_unique<Pool>(pool_block_count * block_size_);
+    for (size_t i = 0; i < pool_block_count; ++i)
+    {
+        FreeBlock* block = new (pool->Get() + i * block_size_) FreeBlock();
+        block->next.store(
+            (i + 1 < pool_block_count) ? static_cast<uint32_t>(first_index + i + 1) : INVALID_INDEX,
+            std::memory_order_relaxed);
+    }
+
+    // Publish the pool before its blocks can be popped
+    pool_blocks_[pool_index].store(pool->Get(), std::memory_order_release);
+    pool_count_.store(pool_index + 1, std::memory_order_release);
+    grown_pools_.emplace_back(std::move(pool));
+
+    Push(static_cast<uint32_t>(first_index), static_cast<uint32_t>(first_index + pool_block_count - 1));
+}
+
+} // namespace memory_allocator
\ No newline at end of file
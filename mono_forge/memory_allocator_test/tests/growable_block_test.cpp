@@ -0,0 +1,243 @@
+﻿#include "memory_allocator_test/pch.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "memory_allocator/include/fixed_block_allocator.h"
+#include "memory_allocator/include/growable_block_allocator.h"
+#pragma comment(lib, "memory_allocator")
+
+TEST(GrowableBlockAllocator, AllocateDeallocate)
+{
+    const size_t block_size = 64;
+    memory_allocator::Pool pool(block_size * 4);
+    memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+
+    // Allocate a block
+    std::byte* block = allocator.Allocate(block_size);
+    ASSERT_NE(block, nullptr);
+
+    // Deallocate the block
+    allocator.Deallocate(&block);
+    ASSERT_EQ(block, nullptr);
+}
+
+TEST(GrowableBlockAllocator, GrowsBeyondInitialPool)
+{
+    const size_t block_size = 32;
+    const size_t initial_count = 4;
+    const size_t allocation_count = 1000;
+    memory_allocator::Pool pool(block_size * initial_count);
+    memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+
+    // Allocate far more blocks than the initial pool holds
+    std::vector<std::byte*> blocks;
+    std::unordered_set<std::byte*> unique_blocks;
+    for (size_t i = 0; i < allocation_count; ++i)
+    {
+        std::byte* block = allocator.Allocate(block_size);
+        ASSERT_NE(block, nullptr);
+        std::memset(block, static_cast<int>(i & 0xFF), block_size);
+        blocks.push_back(block);
+        unique_blocks.insert(block);
+    }
+    EXPECT_EQ(unique_blocks.size(), allocation_count); // No block is handed out twice
+
+    // The written data is not overwritten by other allocations
+    for (size_t i = 0; i < allocation_count; ++i)
+        EXPECT_EQ(blocks[i][block_size - 1], static_cast<std::byte>(i & 0xFF));
+
+    memory_allocator::AllocatorStatistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(statistics.live_count, allocation_count);
+    EXPECT_GE(statistics.capacity, allocation_count);
+    EXPECT_GT(statistics.pool_count, 1);
+
+    // Every block can be returned, including blocks of the grown pools
+    for (std::byte*& block : blocks)
+        allocator.Deallocate(&block);
+
+    statistics = allocator.GetStatistics();
+    EXPECT_EQ(statistics.live_count, 0);
+
+    // Freed blocks are reused without growing again
+    size_t pool_count = statistics.pool_count;
+    for (size_t i = 0; i < allocation_count; ++i)
+        blocks[i] = allocator.Allocate(block_size);
+    EXPECT_EQ(allocator.GetStatistics().pool_count, pool_count);
+
+    for (std::byte*& block : blocks)
+        allocator.Deallocate(&block);
+}
+
+TEST(GrowableBlockAllocator, Statistics)
+{
+    const size_t block_size = 64;
+    memory_allocator::Pool pool(block_size * 8);
+    memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+
+    std::byte* block_a = allocator.Allocate(block_size);
+    std::byte* block_b = allocator.Allocate(block_size / 2);
+    std::byte* block_c = allocator.Allocate(block_size / 2);
+    allocator.Deallocate(&block_c);
+
+    memory_allocator::AllocatorStatistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(statistics.block_size, block_size);
+    EXPECT_EQ(statistics.live_count, 2);
+    EXPECT_EQ(statistics.peak_count, 3);
+    EXPECT_EQ(statistics.total_allocation_count, 3);
+    EXPECT_EQ(statistics.total_deallocation_count, 1);
+    EXPECT_EQ(statistics.requested_bytes, block_size * 2);
+    EXPECT_EQ(statistics.capacity, 8);
+    EXPECT_EQ(statistics.pool_count, 1);
+    EXPECT_DOUBLE_EQ(statistics.GetFreeRatio(), 6.0 / 8.0);
+    EXPECT_DOUBLE_EQ(statistics.GetInternalFragmentation(), 1.0 / 3.0);
+
+    allocator.Deallocate(&block_a);
+    allocator.Deallocate(&block_b);
+}
+
+TEST(GrowableBlockAllocator, MultithreadedStress)
+{
+    const size_t block_size = sizeof(uint64_t) * 4;
+    const size_t thread_count = 8;
+    const size_t round_count = 200;
+    const size_t batch_count = 64;
+
+    // Start small so that threads grow the allocator concurrently
+    memory_allocator::Pool pool(block_size * 16);
+    memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+
+    std::atomic<bool> corrupted{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            std::vector<std::byte*> blocks;
+            for (size_t round = 0; round < round_count; ++round)
+            {
+                // Allocate a batch and stamp each block with its owner
+                for (size_t i = 0; i < batch_count; ++i)
+                {
+                    std::byte* block = allocator.Allocate(block_size);
+                    uint64_t* words = reinterpret_cast<uint64_t*>(block);
+                    for (size_t w = 0; w < 4; ++w)
+                        words[w] = (static_cast<uint64_t>(t) << 32) | (round * batch_count + i);
+                    blocks.push_back(block);
+                }
+
+                // Check the stamps survived, then free half of the blocks
+                size_t keep_count = blocks.size() / 2;
+                while (blocks.size() > keep_count)
+                {
+                    std::byte* block = blocks.back();
+                    blocks.pop_back();
+
+                    uint64_t* words = reinterpret_cast<uint64_t*>(block);
+                    for (size_t w = 1; w < 4; ++w)
+                    {
+                        if (words[w] != words[0] || (words[0] >> 32) != t)
+                            corrupted = true;
+                    }
+                    allocator.Deallocate(&block);
+                }
+            }
+
+            for (std::byte*& block : blocks)
+                allocator.Deallocate(&block);
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_FALSE(corrupted);
+
+    memory_allocator::AllocatorStatistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(statistics.live_count, 0);
+    EXPECT_EQ(statistics.total_allocation_count, thread_count * round_count * batch_count);
+    EXPECT_EQ(statistics.total_allocation_count, statistics.total_deallocation_count);
+    EXPECT_LE(statistics.peak_count, statistics.capacity);
+}
+
+TEST(GrowableBlockAllocator, ThroughputBenchmark)
+{
+    const size_t block_size = 64;
+    const size_t block_count = 1024;
+    const size_t operation_count = 1000000;
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Single thread, FixedBlockAllocator as the baseline
+    double fixed_ms = 0.0;
+    {
+        memory_allocator::Pool pool(block_size * block_count);
+        memory_allocator::FixedBlockAllocator allocator(pool, block_size);
+        std::vector<std::byte*> blocks(block_count);
+
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < operation_count / block_count; ++i)
+        {
+            for (std::byte*& block : blocks)
+                block = allocator.Allocate(block_size);
+            for (std::byte*& block : blocks)
+                allocator.Deallocate(&block);
+        }
+        fixed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Single thread, GrowableBlockAllocator
+    double growable_ms = 0.0;
+    {
+        memory_allocator::Pool pool(block_size * block_count);
+        memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+        std::vector<std::byte*> blocks(block_count);
+
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < operation_count / block_count; ++i)
+        {
+            for (std::byte*& block : blocks)
+                block = allocator.Allocate(block_size);
+            for (std::byte*& block : blocks)
+                allocator.Deallocate(&block);
+        }
+        growable_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Multiple threads sharing one GrowableBlockAllocator
+    const size_t thread_count = 8;
+    double shared_ms = 0.0;
+    {
+        memory_allocator::Pool pool(block_size * block_count);
+        memory_allocator::GrowableBlockAllocator allocator(pool, block_size);
+
+        Clock::time_point start = Clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&]()
+            {
+                std::vector<std::byte*> blocks(block_count / thread_count);
+                for (size_t i = 0; i < operation_count / block_count; ++i)
+                {
+                    for (std::byte*& block : blocks)
+                        block = allocator.Allocate(block_size);
+                    for (std::byte*& block : blocks)
+                        allocator.Deallocate(&block);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        shared_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        EXPECT_EQ(allocator.GetStatistics().live_count, 0);
+    }
+
+    std::cout << operation_count << " allocate/deallocate pairs\n";
+    std::cout << "  FixedBlockAllocator, 1 thread     : " << fixed_ms << " ms\n";
+    std::cout << "  GrowableBlockAllocator, 1 thread  : " << growable_ms << " ms\n";
+    std::cout << "  GrowableBlockAllocator, " << thread_count << " threads : " << shared_ms << " ms\n";
+}
\ No newline at end of file
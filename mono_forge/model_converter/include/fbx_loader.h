@@ -54,6 +54,9 @@ namespace model_converter
         const std::vector<u32>& GetIndices(int material_index = 0) const;
         void AddIndex(u32 index, int material_index = 0);
 
+        // メッシュ全体を書き換える処理（最適化など）のために、メッシュを取得する
+        FBXMesh& GetMesh(int material_index = 0);
+
         const std::unordered_set<int>& GetMaterialIndices() const;
         std::string_view GetMaterialName(int material_index) const;
         void AddMaterial(int material_index, std::string_view material_name);
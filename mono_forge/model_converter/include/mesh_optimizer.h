@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "include/type.h"
+#include "include/fbx_loader.h"
+
+namespace model_converter
+{
+    // メッシュ最適化の設定
+    struct MeshOptimizeSettings
+    {
+        // 頂点を溶接する許容誤差, 0なら全属性がビット単位で一致する頂点のみ溶接する
+        f32 weld_epsilon_ = 0.0f;
+
+        // 頂点キャッシュのサイズ, 並べ替えのスコア計算とACMRの計測に使用する
+        u32 vertex_cache_size_ = 32;
+    };
+
+    // メッシュ最適化の結果
+    struct MeshOptimizeStats
+    {
+        // 最適化前後の頂点数
+        u32 vertex_count_before_ = 0;
+        u32 vertex_count_after_ = 0;
+
+        // 最適化前後のACMR（三角形あたりの頂点キャッシュミス数）
+        f32 acmr_before_ = 0.0f;
+        f32 acmr_after_ = 0.0f;
+    };
+
+    // 同じ頂点を1つにまとめ、インデックスを付け替える
+    // epsilonが0より大きい場合は、各属性をepsilonの格子に丸めて一致する頂点をまとめる
+    // まとめた頂点は最初に出現した頂点の値を持つ
+    void WeldVertices(FBXMesh& mesh, f32 epsilon);
+
+    // 頂点キャッシュのヒット率が上がるように三角形の順序を並べ替える（Forsythの線形時間アルゴリズム）
+    // 各三角形の頂点の順序は変えないため、面の向きは保たれる
+    void OptimizeVertexCache(std::vector<u32>& indices, u32 vertex_count, u32 cache_size);
+
+    // 頂点をインデックスで最初に参照される順に並べ替え、参照されない頂点を取り除く
+    void OptimizeVertexFetch(FBXMesh& mesh);
+
+    // FIFOの頂点キャッシュを模擬してACMRを計算する
+    f32 ComputeACMR(const std::vector<u32>& indices, u32 vertex_count, u32 cache_size);
+
+    // 溶接、三角形の並べ替え、頂点の並べ替えを順に行う
+    // インデックスが三角形リストでない場合は何もせずにfalseを返す
+    bool OptimizeMesh(FBXMesh& mesh, const MeshOptimizeSettings& settings, MeshOptimizeStats& stats);
+
+} // namespace model_converter
@@ -9,62 +9,79 @@
 
 namespace model_converter
 {
+    // コンテンツタイプ(0x0001:メッシュノードのリスト, 0x0002:メッシュのディレクトリテーブル)
+    constexpr u16 MFM_CONTENT_TYPE_MESH_TABLE = 0x0002;
+
+    // レイアウトのバージョン
+    constexpr u16 MFM_VERSION_2 = 2;
+
+    // バージョン2でメッシュディレクトリ、頂点データ、インデックスデータを揃えるアライメント
+    constexpr u32 MFM_V2_ALIGNMENT = 16;
+
     #pragma pack(push, 1)
 
     // ファイルヘッダー構造体
     struct MFMFileHeader
     {
         u16 file_type = 0x4D46; // ファイルタイプ識別子('MF'のASCIIコード)
-        u32 file_size = 0; // ファイルサイズ(ファイルヘッダー + 情報ヘッダー + メッシュデータチャンクの合計)
-        u16 content_type = 0x0001; // コンテンツタイプ(0x0001:メッシュのみ)
+        u32 file_size = 0; // ファイルサイズ(ファイル全体のサイズ)
+        u16 content_type = MFM_CONTENT_TYPE_MESH_TABLE; // コンテンツタイプ
     };
 
-    // 情報ヘッダー構造体
-    struct MFMInfoHeader
+    struct MFMCustomHeader
     {
-        u32 mesh_header_offset = 0; // メッシュヘッダーのオフセット
-        u32 mesh_header_size = 0; // メッシュヘッダーのサイズ
+        u32 custom_data_offset = 0; // カスタムデータチャンクのオフセット
+        u32 custom_data_size = 0; // カスタムデータチャンクのサイズ
 
-        u32 custom_header_offset = 0; // カスタムヘッダーのオフセット
-        u32 custom_header_size = 0; // カスタムヘッダーのサイズ
+        u32 coord_system = 0; // 座標系(0:右手系, 1:左手系)
+        u32 up_axis = 1; // 上方向の軸(0:X軸, 1:Y軸, 2:Z軸)
     };
 
-    struct MFMMeshHeader
+    // モデル空間の軸平行境界ボックス
+    struct MFMBounds
     {
-        u32 mesh_data_offset = 0; // メッシュデータチャンクのオフセット
-        u32 mesh_data_size = 0; // メッシュデータチャンクのサイズ
-
-        u32 material_count = 0; // マテリアル数(メッシュノード数)
+        f32 min[3] = { 0.0f, 0.0f, 0.0f };
+        f32 max[3] = { 0.0f, 0.0f, 0.0f };
     };
 
-    struct MFMCustomHeader
+    // バージョン2のヘッダー, ファイルヘッダーの直後に置く
+    // 並び: ファイルヘッダー, バージョン2ヘッダー, メッシュディレクトリ, カスタムヘッダー, マテリアル名, 各メッシュの頂点とインデックス
+    // メッシュディレクトリと各データはアライメントの倍数の位置から始まる
+    struct MFMHeaderV2
     {
-        u32 custom_data_offset = 0; // カスタムデータチャンクのオフセット
-        u32 custom_data_size = 0; // カスタムデータチャンクのサイズ
+        u16 version = MFM_VERSION_2; // レイアウトのバージョン
+        u16 alignment = MFM_V2_ALIGNMENT; // ディレクトリとデータのアライメント
 
-        u32 coord_system = 0; // 座標系(0:右手系, 1:左手系)
-        u32 up_axis = 1; // 上方向の軸(0:X軸, 1:Y軸, 2:Z軸)
+        u32 mesh_count = 0; // メッシュディレクトリのエントリ数
+        u32 mesh_directory_offset = 0; // メッシュディレクトリのオフセット
+        u32 mesh_entry_size = 0; // メッシュエントリのサイズ
+
+        u32 custom_header_offset = 0; // カスタムヘッダーのオフセット
+        u32 custom_header_size = 0; // カスタムヘッダーのサイズ
+
+        MFMBounds bounds; // 全メッシュの境界
     };
 
-    struct MFMMeshNode
+    // バージョン2のメッシュディレクトリのエントリ
+    struct MFMMeshEntry
     {
-        u32 next_node_offset = 0; // 次のメッシュノードへのオフセット
-
-        u32 material_name_offset = 0; // マテリアル名のオフセット
-        u32 material_name_size = 0; // マテリアル名のサイズ
+        u32 material_name_offset = 0; // マテリアル名のオフセット, 名前の後にnull終端を置く
+        u32 material_name_size = 0; // null終端を含まないマテリアル名のサイズ
 
         u32 vertex_offset = 0; // 頂点データのオフセット
-        u32 vertex_size = 0; // 頂点サイズ
+        u32 vertex_size = 0; // 頂点サイズ, 頂点は位置のfloat3から始まる
         u32 vertex_count = 0; // 頂点数
 
         u32 index_offset = 0; // インデックスデータのオフセット
         u32 index_size = 0; // インデックスサイズ
         u32 index_count = 0; // インデックス数
+
+        MFMBounds bounds; // 頂点位置の境界
     };
 
     #pragma pack(pop)
 
-    // MFM形式(Mono Forge Model Format)への変換を行うクラス
+    // MFM形式(Mono Forge Model Format)のバージョン2への変換を行うクラス
     class MFMConverter : public IConverter
     {
     public:
@@ -1,6 +1,8 @@
 ﻿#include "include/pch.h"
 #include "include/fbx_loader.h"
 
+#include "include/mesh_optimizer.h"
+
 #include <fbxsdk.h>
 #include <fbxsdk/fileio/fbxiosettingspath.h>
 #pragma comment(lib, "libfbxsdk.lib")
@@ -60,6 +62,13 @@ void FBXFileData::AddIndex(u32 index, int material_index)
     mesh.indices_.emplace_back(index);
 }
 
+FBXMesh& FBXFileData::GetMesh(int material_index)
+{
+    auto it = meshes_.find(material_index);
+    assert(it != meshes_.end() && "Material index not found in meshes_");
+    return it->second;
+}
+
 const std::unordered_set<int>& FBXFileData::GetMaterialIndices() const
 {
     return material_indices_;
@@ -456,6 +465,15 @@ std::unique_ptr<IFileData> FBXLoader::Load(std::string_view file_path) const
     scene->Destroy();
     manager->Destroy();
 
+    // ポリゴン頂点ごとに作られた頂点を溶接し、インデックスと頂点を並べ替える
+    const MeshOptimizeSettings optimize_settings{};
+    for (const int material_index : fbx_data->GetMaterialIndices())
+    {
+        // 最適化できないメッシュはそのまま使う
+        MeshOptimizeStats stats{};
+        OptimizeMesh(fbx_data->GetMesh(material_index), optimize_settings, stats);
+    }
+
     return fbx_data;
 }
 
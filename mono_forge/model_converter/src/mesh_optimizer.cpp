@@ -0,0 +1,332 @@
+﻿#include "include/pch.h"
+#include "include/mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace model_converter
+{
+
+namespace
+{
+
+// 溶接のキーとなる頂点属性の要素数
+constexpr size_t VERTEX_KEY_SIZE = sizeof(FBXVertex) / sizeof(f32);
+static_assert(sizeof(FBXVertex) == VERTEX_KEY_SIZE * sizeof(f32), "FBXVertex must consist of floats only");
+
+using VertexKey = std::array<u32, VERTEX_KEY_SIZE>;
+
+struct VertexKeyHash
+{
+    size_t operator()(const VertexKey& key) const
+    {
+        // FNV-1a
+        u64 hash = 14695981039346656037ull;
+        for (u32 element : key)
+        {
+            hash ^= element;
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+// 頂点属性から溶接のキーを作成する
+VertexKey CreateVertexKey(const FBXVertex& vertex, f32 epsilon)
+{
+    f32 elements[VERTEX_KEY_SIZE];
+    std::memcpy(elements, &vertex, sizeof(FBXVertex));
+
+    VertexKey key{};
+    for (size_t i = 0; i < VERTEX_KEY_SIZE; ++i)
+    {
+        if (epsilon > 0.0f)
+        {
+            // 格子に丸めた値をキーにする
+            key[i] = static_cast<u32>(static_cast<s32>(std::floor(elements[i] / epsilon + 0.5f)));
+        }
+        else
+        {
+            // -0と+0は同じ値として扱う
+            f32 element = (elements[i] == 0.0f) ? 0.0f : elements[i];
+            std::memcpy(&key[i], &element, sizeof(f32));
+        }
+    }
+    return key;
+}
+
+// Forsythのアルゴリズムのスコア計算用の定数
+constexpr f32 CACHE_DECAY_POWER = 1.5f;
+constexpr f32 LAST_TRIANGLE_SCORE = 0.75f;
+constexpr f32 VALENCE_BOOST_SCALE = 2.0f;
+constexpr f32 VALENCE_BOOST_POWER = 0.5f;
+
+// 頂点のキャッシュ内の位置と、未出力の三角形数から頂点のスコアを計算する
+f32 ComputeVertexScore(s32 cache_position, u32 remaining_triangle_count, u32 cache_size)
+{
+    // 未出力の三角形が無い頂点は選ばれないようにする
+    if (remaining_triangle_count == 0)
+        return -1.0f;
+
+    f32 score = 0.0f;
+    if (cache_position >= 0)
+    {
+        if (cache_position < 3)
+        {
+            // 直前の三角形の頂点は、同じ辺を使う細長い三角形ばかりにならないよう一定のスコアにする
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            // キャッシュの後ろほどスコアを下げる
+            const f32 scaler = 1.0f / static_cast<f32>(cache_size - 3);
+            score = std::pow(1.0f - static_cast<f32>(cache_position - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    // 未出力の三角形が少ない頂点を優先し、孤立した三角形が残らないようにする
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<f32>(remaining_triangle_count), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+void WeldVertices(FBXMesh& mesh, f32 epsilon)
+{
+    std::vector<FBXVertex> welded_vertices;
+    welded_vertices.reserve(mesh.vertices_.size());
+
+    // 元の頂点インデックスから溶接後の頂点インデックスへの対応表
+    std::vector<u32> remap(mesh.vertices_.size());
+
+    std::unordered_map<VertexKey, u32, VertexKeyHash> key_to_index;
+    key_to_index.reserve(mesh.vertices_.size());
+
+    for (size_t i = 0; i < mesh.vertices_.size(); ++i)
+    {
+        const u32 new_index = static_cast<u32>(welded_vertices.size());
+        auto result = key_to_index.emplace(CreateVertexKey(mesh.vertices_[i], epsilon), new_index);
+        if (result.second)
+            welded_vertices.emplace_back(mesh.vertices_[i]); // 初めて出現した頂点
+
+        remap[i] = result.first->second;
+    }
+
+    // インデックスを付け替える
+    for (u32& index : mesh.indices_)
+    {
+        assert(index < remap.size() && "Index out of range of vertices");
+        index = remap[index];
+    }
+
+    mesh.vertices_ = std::move(welded_vertices);
+}
+
+void OptimizeVertexCache(std::vector<u32>& indices, u32 vertex_count, u32 cache_size)
+{
+    assert(indices.size() % 3 == 0 && "Indices must be a triangle list");
+    assert(cache_size > 3 && "Vertex cache size must be larger than a triangle");
+
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0)
+        return;
+
+    // 各頂点の未出力の三角形数
+    std::vector<u32> remaining_triangle_counts(vertex_count, 0);
+    for (u32 index : indices)
+    {
+        assert(index < vertex_count && "Index out of range of vertices");
+        ++remaining_triangle_counts[index];
+    }
+
+    // 各頂点が使われる三角形のリスト, 頂点ごとの区間をoffsetsで表す
+    std::vector<u32> adjacency_offsets(vertex_count + 1, 0);
+    for (u32 vertex = 0; vertex < vertex_count; ++vertex)
+        adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + remaining_triangle_counts[vertex];
+
+    std::vector<u32> adjacent_triangles(indices.size());
+    {
+        std::vector<u32> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i)
+            adjacent_triangles[cursors[indices[i]]++] = static_cast<u32>(i / 3);
+    }
+
+    // 頂点のキャッシュ内の位置とスコア
+    std::vector<s32> cache_positions(vertex_count, -1);
+    std::vector<f32> vertex_scores(vertex_count);
+    for (u32 vertex = 0; vertex < vertex_count; ++vertex)
+        vertex_scores[vertex] = ComputeVertexScore(-1, remaining_triangle_counts[vertex], cache_size);
+
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<u32> output;
+    output.reserve(indices.size());
+
+    // キャッシュは三角形1つ分はみ出せるようにしておく
+    std::vector<u32> cache;
+    std::vector<u32> new_cache;
+    cache.reserve(cache_size + 3);
+    new_cache.reserve(cache_size + 3);
+
+    // キャッシュから候補が見つからない場合に、入力順で次に出力する三角形の位置
+    size_t input_cursor = 0;
+
+    s64 best_triangle = -1;
+    while (output.size() < indices.size())
+    {
+        if (best_triangle < 0)
+        {
+            // 未出力の三角形を入力順に探す
+            while (emitted[input_cursor])
+                ++input_cursor;
+            best_triangle = static_cast<s64>(input_cursor);
+        }
+
+        // 三角形を出力
+        const u32* triangle_indices = &indices[static_cast<size_t>(best_triangle) * 3];
+        output.insert(output.end(), triangle_indices, triangle_indices + 3);
+        emitted[static_cast<size_t>(best_triangle)] = true;
+
+        new_cache.clear();
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const u32 vertex = triangle_indices[corner];
+
+            // 頂点の三角形リストから出力した三角形を取り除く
+            u32* begin = &adjacent_triangles[adjacency_offsets[vertex]];
+            u32* end = begin + remaining_triangle_counts[vertex];
+            u32* found = std::find(begin, end, static_cast<u32>(best_triangle));
+            assert(found != end && "Triangle not found in adjacency");
+            std::swap(*found, *(end - 1));
+            --remaining_triangle_counts[vertex];
+
+            // 出力した三角形の頂点をキャッシュの先頭に置く
+            if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end())
+                new_cache.push_back(vertex);
+        }
+
+        // 残りの頂点を古い順序のまま後ろに並べる
+        for (u32 vertex : cache)
+        {
+            if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end())
+                new_cache.push_back(vertex);
+        }
+
+        // キャッシュ内の位置を更新, はみ出た頂点はキャッシュから外れる
+        for (size_t position = 0; position < new_cache.size(); ++position)
+        {
+            const u32 vertex = new_cache[position];
+            cache_positions[vertex] = (position < cache_size) ? static_cast<s32>(position) : -1;
+            vertex_scores[vertex]
+                = ComputeVertexScore(cache_positions[vertex], remaining_triangle_counts[vertex], cache_size);
+        }
+
+        // 三角形のスコアは頂点のスコアの合計, キャッシュ内の頂点を使う三角形から次の三角形を選ぶ
+        best_triangle = -1;
+        f32 best_score = -1.0f;
+        for (u32 vertex : new_cache)
+        {
+            const u32 begin = adjacency_offsets[vertex];
+            const u32 end = begin + remaining_triangle_counts[vertex];
+            for (u32 i = begin; i < end; ++i)
+            {
+                const u32 triangle = adjacent_triangles[i];
+                const f32 score
+                    = vertex_scores[indices[triangle * 3 + 0]]
+                    + vertex_scores[indices[triangle * 3 + 1]]
+                    + vertex_scores[indices[triangle * 3 + 2]];
+
+                if (cache_positions[vertex] >= 0 && score > best_score)
+                {
+                    best_score = score;
+                    best_triangle = triangle;
+                }
+            }
+        }
+
+        // キャッシュサイズに切り詰める
+        if (new_cache.size() > cache_size)
+            new_cache.resize(cache_size);
+        std::swap(cache, new_cache);
+    }
+
+    indices = std::move(output);
+}
+
+void OptimizeVertexFetch(FBXMesh& mesh)
+{
+    constexpr u32 UNUSED = 0xFFFFFFFF;
+
+    // 最初に参照された順に新しいインデックスを割り当てる
+    std::vector<u32> remap(mesh.vertices_.size(), UNUSED);
+    std::vector<FBXVertex> ordered_vertices;
+    ordered_vertices.reserve(mesh.vertices_.size());
+
+    for (u32& index : mesh.indices_)
+    {
+        assert(index < remap.size() && "Index out of range of vertices");
+        if (remap[index] == UNUSED)
+        {
+            remap[index] = static_cast<u32>(ordered_vertices.size());
+            ordered_vertices.emplace_back(mesh.vertices_[index]);
+        }
+        index = remap[index];
+    }
+
+    mesh.vertices_ = std::move(ordered_vertices);
+}
+
+f32 ComputeACMR(const std::vector<u32>& indices, u32 vertex_count, u32 cache_size)
+{
+    assert(indices.size() % 3 == 0 && "Indices must be a triangle list");
+
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0)
+        return 0.0f;
+
+    // ミスした時刻を記録し、その後のミス数がキャッシュサイズ未満ならキャッシュ内にある（FIFO）
+    std::vector<u64> miss_times(vertex_count, 0);
+    u64 miss_count = 0;
+    for (u32 index : indices)
+    {
+        assert(index < vertex_count && "Index out of range of vertices");
+        if (miss_times[index] == 0 || miss_count - miss_times[index] >= cache_size)
+        {
+            ++miss_count;
+            miss_times[index] = miss_count;
+        }
+    }
+
+    return static_cast<f32>(miss_count) / static_cast<f32>(triangle_count);
+}
+
+bool OptimizeMesh(FBXMesh& mesh, const MeshOptimizeSettings& settings, MeshOptimizeStats& stats)
+{
+    if (mesh.indices_.size() % 3 != 0)
+    {
+        std::cerr << "Mesh Optimize Error: Indices are not a triangle list." << std::endl;
+        return false;
+    }
+
+    stats.vertex_count_before_ = static_cast<u32>(mesh.vertices_.size());
+    stats.acmr_before_ = ComputeACMR(
+        mesh.indices_, static_cast<u32>(mesh.vertices_.size()), settings.vertex_cache_size_);
+
+    // 頂点を溶接
+    WeldVertices(mesh, settings.weld_epsilon_);
+
+    // 頂点キャッシュのために三角形を並べ替える
+    OptimizeVertexCache(mesh.indices_, static_cast<u32>(mesh.vertices_.size()), settings.vertex_cache_size_);
+
+    // 頂点フェッチのために頂点を並べ替える
+    OptimizeVertexFetch(mesh);
+
+    stats.vertex_count_after_ = static_cast<u32>(mesh.vertices_.size());
+    stats.acmr_after_ = ComputeACMR(
+        mesh.indices_, static_cast<u32>(mesh.vertices_.size()), settings.vertex_cache_size_);
+
+    return true;
+}
+
+} // namespace model_converter
@@ -3,9 +3,24 @@
 
 #include "include/fbx_loader.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 namespace model_converter
 {
 
+namespace
+{
+
+// オフセットをアライメントの倍数に切り上げる
+u64 AlignOffset(u64 offset, u64 alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
 MFMConverter::MFMConverter()
 {
 }
@@ -33,126 +48,140 @@ std::unique_ptr<u8[]> model_converter::MFMConverter::Convert(const IFileData *fi
         return nullptr;
     }
 
-    // メッシュデータチャンクのサイズ
-    u32 mesh_data_size = 0;
-    for (const int material_index : fbx_data->GetMaterialIndices())
+    // メッシュはマテリアルインデックス順に並べる
+    std::vector<int> material_indices(fbx_data->GetMaterialIndices().begin(), fbx_data->GetMaterialIndices().end());
+    std::sort(material_indices.begin(), material_indices.end());
+
+    // レイアウトは64ビットで計算し、32ビットのオフセットに収まらないデータを検出する
+    MFMHeaderV2 header{};
+    header.mesh_count = static_cast<u32>(material_indices.size());
+    header.mesh_entry_size = sizeof(MFMMeshEntry);
+
+    u64 offset = sizeof(MFMFileHeader) + sizeof(MFMHeaderV2);
+
+    // メッシュディレクトリ
+    offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+    const u64 mesh_directory_offset = offset;
+    offset += static_cast<u64>(sizeof(MFMMeshEntry)) * material_indices.size();
+
+    // カスタムヘッダー
+    const u64 custom_header_offset = offset;
+    offset += sizeof(MFMCustomHeader);
+
+    // null終端付きのマテリアル名
+    std::vector<MFMMeshEntry> mesh_entries(material_indices.size());
+    for (size_t i = 0; i < material_indices.size(); ++i)
     {
-        const u32 vertex_count = static_cast<u32>(fbx_data->GetVertices(material_index).size());
-        const u32 index_count = static_cast<u32>(fbx_data->GetIndices(material_index).size());
-        mesh_data_size += sizeof(MFMMeshNode); // メッシュノードサイズ
-        mesh_data_size += fbx_data->GetMaterialName(material_index).size(); // マテリアル名サイズ
-        mesh_data_size += vertex_count * sizeof(FBXVertex); // 頂点データサイズ
-        mesh_data_size += index_count * sizeof(u32); // インデックスデータサイズ
+        const std::string_view material_name = fbx_data->GetMaterialName(material_indices[i]);
+        mesh_entries[i].material_name_offset = static_cast<u32>(offset);
+        mesh_entries[i].material_name_size = static_cast<u32>(material_name.size());
+        offset += material_name.size() + 1;
     }
 
-    // カスタムデータチャンクのサイズ
-    const u32 custom_data_size = 0; // 今回はカスタムデータ無し
+    // 頂点データとインデックスデータ
+    for (size_t i = 0; i < material_indices.size(); ++i)
+    {
+        offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+        mesh_entries[i].vertex_offset = static_cast<u32>(offset);
+        mesh_entries[i].vertex_size = sizeof(FBXVertex);
+        mesh_entries[i].vertex_count = static_cast<u32>(fbx_data->GetVertices(material_indices[i]).size());
+        offset += static_cast<u64>(mesh_entries[i].vertex_size) * mesh_entries[i].vertex_count;
+
+        offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+        mesh_entries[i].index_offset = static_cast<u32>(offset);
+        mesh_entries[i].index_size = sizeof(u32);
+        mesh_entries[i].index_count = static_cast<u32>(fbx_data->GetIndices(material_indices[i]).size());
+        offset += static_cast<u64>(mesh_entries[i].index_size) * mesh_entries[i].index_count;
+
+        if (offset > UINT32_MAX)
+        {
+            std::cerr << "MFM形式への変換に失敗: データが32ビットのオフセットに収まりません。" << std::endl;
+            return nullptr;
+        }
+    }
 
-    // ファイルヘッダーの設定
-    MFMFileHeader file_header{};
-    file_header.file_size 
-        = sizeof(MFMFileHeader) + sizeof(MFMInfoHeader) + sizeof(MFMMeshHeader) + sizeof(MFMCustomHeader) 
-            + custom_data_size + mesh_data_size;
+    // 各メッシュとモデル全体の境界を頂点位置から求める
+    bool is_first = true;
+    for (size_t i = 0; i < material_indices.size(); ++i)
+    {
+        const std::vector<FBXVertex>& vertices = fbx_data->GetVertices(material_indices[i]);
+        MFMBounds& bounds = mesh_entries[i].bounds;
+        for (size_t vertex_index = 0; vertex_index < vertices.size(); ++vertex_index)
+        {
+            const f32 position[3] = { 
+                vertices[vertex_index].position_.x, vertices[vertex_index].position_.y, vertices[vertex_index].position_.z };
 
-    // サイズを返す
-    rt_data_size = file_header.file_size;
+            for (u32 axis = 0; axis < 3; ++axis)
+            {
+                if (vertex_index == 0 || position[axis] < bounds.min[axis])
+                    bounds.min[axis] = position[axis];
+
+                if (vertex_index == 0 || position[axis] > bounds.max[axis])
+                    bounds.max[axis] = position[axis];
+            }
+        }
 
-    // 情報ヘッダーの設定
-    MFMInfoHeader info_header{};
-    info_header.mesh_header_offset =  sizeof(MFMFileHeader) + sizeof(MFMInfoHeader);
-    info_header.mesh_header_size = sizeof(MFMMeshHeader);
-    info_header.custom_header_offset = sizeof(MFMFileHeader) + sizeof(MFMInfoHeader) + sizeof(MFMMeshHeader);
-    info_header.custom_header_size = sizeof(MFMCustomHeader);
+        if (vertices.empty())
+            continue;
 
-    // メッシュヘッダーの設定
-    MFMMeshHeader mesh_header{};
-    mesh_header.mesh_data_offset 
-        = sizeof(MFMFileHeader) + sizeof(MFMInfoHeader) + sizeof(MFMMeshHeader) + sizeof(MFMCustomHeader);
-    mesh_header.mesh_data_size = mesh_data_size;
-    mesh_header.material_count = static_cast<u32>(fbx_data->GetMaterialIndices().size());
+        for (u32 axis = 0; axis < 3; ++axis)
+        {
+            header.bounds.min[axis] = is_first ? bounds.min[axis] : std::min(header.bounds.min[axis], bounds.min[axis]);
+            header.bounds.max[axis] = is_first ? bounds.max[axis] : std::max(header.bounds.max[axis], bounds.max[axis]);
+        }
+        is_first = false;
+    }
+
+    // ファイルヘッダーの設定
+    MFMFileHeader file_header{};
+    file_header.file_size = static_cast<u32>(offset);
+
+    // バージョン2ヘッダーの設定
+    header.mesh_directory_offset = static_cast<u32>(mesh_directory_offset);
+    header.custom_header_offset = static_cast<u32>(custom_header_offset);
+    header.custom_header_size = sizeof(MFMCustomHeader);
 
     // カスタムヘッダーの設定
     MFMCustomHeader custom_header{};
-    custom_header.custom_data_offset 
-        = sizeof(MFMFileHeader) + sizeof(MFMInfoHeader) + sizeof(MFMMeshHeader) + sizeof(MFMCustomHeader) + mesh_data_size;
-    custom_header.custom_data_size = custom_data_size;
+    custom_header.custom_data_offset = 0;
+    custom_header.custom_data_size = 0; // 今回はカスタムデータ無し
     custom_header.coord_system = 0; // 右手系
     custom_header.up_axis = 1; // Y軸が上方向
 
-    // バッファの確保
+    // サイズを返す
+    rt_data_size = file_header.file_size;
+
+    // バッファの確保, パディングは0のまま残す
     std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(file_header.file_size);
 
-    // ファイルヘッダーを書き込む
-    u32 offset = 0;
-    for (u32 i = 0; i < sizeof(MFMFileHeader); ++i)
-        buffer[i] = reinterpret_cast<u8*>(&file_header)[i];
-    offset += sizeof(MFMFileHeader);
-
-    // 情報ヘッダーを書き込む
-    for (u32 i = 0; i < sizeof(MFMInfoHeader); ++i)
-        buffer[offset + i] = reinterpret_cast<u8*>(&info_header)[i];
-    offset += sizeof(MFMInfoHeader);
-
-    // メッシュヘッダーを書き込む
-    for (u32 i = 0; i < sizeof(MFMMeshHeader); ++i)
-        buffer[offset + i] = reinterpret_cast<u8*>(&mesh_header)[i];
-    offset += sizeof(MFMMeshHeader);
-
-    // カスタムヘッダーを書き込む
-    for (u32 i = 0; i < sizeof(MFMCustomHeader); ++i)
-        buffer[offset + i] = reinterpret_cast<u8*>(&custom_header)[i];
-    offset += sizeof(MFMCustomHeader);
+    // ヘッダーを書き込む
+    std::memcpy(buffer.get(), &file_header, sizeof(MFMFileHeader));
+    std::memcpy(buffer.get() + sizeof(MFMFileHeader), &header, sizeof(MFMHeaderV2));
+    std::memcpy(buffer.get() + custom_header_offset, &custom_header, sizeof(MFMCustomHeader));
 
-    // メッシュデータチャンクを書き込む
-    for (const int material_index : fbx_data->GetMaterialIndices())
+    for (size_t i = 0; i < material_indices.size(); ++i)
     {
-        // メッシュノードの設定
-        MFMMeshNode mesh_node{};
-        mesh_node.material_name_offset = offset + sizeof(MFMMeshNode);
-        mesh_node.material_name_size = static_cast<u32>(fbx_data->GetMaterialName(material_index).size());
-
-        mesh_node.vertex_offset = offset + sizeof(MFMMeshNode) + mesh_node.material_name_size;
-        mesh_node.vertex_size = sizeof(FBXVertex);
-        mesh_node.vertex_count = static_cast<u32>(fbx_data->GetVertices(material_index).size());
-
-        mesh_node.index_offset 
-            = offset + sizeof(MFMMeshNode) + mesh_node.material_name_size + mesh_node.vertex_count * mesh_node.vertex_size;
-        mesh_node.index_size = sizeof(u32);
-        mesh_node.index_count = static_cast<u32>(fbx_data->GetIndices(material_index).size());
+        const MFMMeshEntry& mesh_entry = mesh_entries[i];
 
-        // メッシュノードを書き込む
-        for (u32 i = 0; i < sizeof(MFMMeshNode); ++i)
-            buffer[offset + i] = reinterpret_cast<u8*>(&mesh_node)[i];
-        offset += sizeof(MFMMeshNode);
+        // メッシュエントリを書き込む
+        std::memcpy(buffer.get() + mesh_directory_offset + sizeof(MFMMeshEntry) * i, &mesh_entry, sizeof(MFMMeshEntry));
 
         // マテリアル名を書き込む
-        std::string_view material_name = fbx_data->GetMaterialName(material_index);
-        for (u32 i = 0; i < material_name.size(); ++i)
-            buffer[offset + i] = static_cast<u8>(material_name[i]);
-        offset += mesh_node.material_name_size;
+        const std::string_view material_name = fbx_data->GetMaterialName(material_indices[i]);
+        if (!material_name.empty())
+            std::memcpy(buffer.get() + mesh_entry.material_name_offset, material_name.data(), material_name.size());
 
         // 頂点データを書き込む
-        for (size_t vertex_count = 0; vertex_count < fbx_data->GetVertices(material_index).size(); ++vertex_count)
-        {
-            const FBXVertex& vertex = fbx_data->GetVertices(material_index)[vertex_count];
-            for (u32 j = 0; j < sizeof(FBXVertex); ++j)
-                buffer[offset + vertex_count * sizeof(FBXVertex) + j] = reinterpret_cast<const u8*>(&vertex)[j];
-        }
-        offset += mesh_node.vertex_count * mesh_node.vertex_size;
+        const std::vector<FBXVertex>& vertices = fbx_data->GetVertices(material_indices[i]);
+        if (!vertices.empty())
+            std::memcpy(buffer.get() + mesh_entry.vertex_offset, vertices.data(), vertices.size() * sizeof(FBXVertex));
 
         // インデックスデータを書き込む
-        for (size_t index_count = 0; index_count < fbx_data->GetIndices(material_index).size(); ++index_count)
-        {
-            const u32& index = fbx_data->GetIndices(material_index)[index_count];
-            for (u32 j = 0; j < sizeof(u32); ++j)
-                buffer[offset + index_count * sizeof(u32) + j] = reinterpret_cast<const u8*>(&index)[j];
-        }
-        offset += mesh_node.index_count * mesh_node.index_size;
+        const std::vector<u32>& indices = fbx_data->GetIndices(material_indices[i]);
+        if (!indices.empty())
+            std::memcpy(buffer.get() + mesh_entry.index_offset, indices.data(), indices.size() * sizeof(u32));
     }
 
-    // カスタムデータチャンクを書き込む
-    // 今回はカスタムデータ無し
-
     return buffer;
 }
 
@@ -0,0 +1,266 @@
+﻿#include "pch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <tuple>
+
+#include "include/mesh_optimizer.h"
+
+namespace mesh_optimizer_test
+{
+    // 頂点属性を比較用に並べたもの
+    using VertexValue = std::array<float, 11>;
+
+    VertexValue ToVertexValue(const model_converter::FBXVertex& vertex)
+    {
+        return {
+            vertex.position_.x, vertex.position_.y, vertex.position_.z,
+            vertex.uv_.x, vertex.uv_.y,
+            vertex.normal_.x, vertex.normal_.y, vertex.normal_.z,
+            vertex.tangent_.x, vertex.tangent_.y, vertex.tangent_.z };
+    }
+
+    // 三角形を頂点属性で表したもの
+    using Triangle = std::array<VertexValue, 3>;
+
+    // 三角形を頂点属性の組として取り出し、比較できるように並べる
+    // 三角形内の頂点は向きを保ったまま、最小の頂点が先頭になるように回転する
+    std::vector<Triangle> GetSortedTriangles(const model_converter::FBXMesh& mesh)
+    {
+        std::vector<Triangle> triangles;
+        for (size_t i = 0; i + 2 < mesh.indices_.size(); i += 3)
+        {
+            Triangle triangle = {
+                ToVertexValue(mesh.vertices_[mesh.indices_[i + 0]]),
+                ToVertexValue(mesh.vertices_[mesh.indices_[i + 1]]),
+                ToVertexValue(mesh.vertices_[mesh.indices_[i + 2]]) };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    model_converter::FBXVertex CreateGridVertex(int x, int y, int grid_size)
+    {
+        model_converter::FBXVertex vertex{};
+        vertex.position_ = DirectX::XMFLOAT3(static_cast<float>(x), 0.0f, static_cast<float>(y));
+        vertex.uv_ = DirectX::XMFLOAT2(
+            static_cast<float>(x) / static_cast<float>(grid_size), static_cast<float>(y) / static_cast<float>(grid_size));
+        vertex.normal_ = DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
+        vertex.tangent_ = DirectX::XMFLOAT3(1.0f, 0.0f, 0.0f);
+        return vertex;
+    }
+
+    // FBXLoaderと同じく、ポリゴン頂点ごとに頂点を持つグリッドのメッシュを作成する
+    // shuffleがtrueの場合は三角形の順序をばらばらにする
+    model_converter::FBXMesh CreateGridMesh(int grid_size, bool shuffle)
+    {
+        std::vector<std::array<model_converter::FBXVertex, 3>> triangles;
+        for (int y = 0; y < grid_size; ++y)
+        {
+            for (int x = 0; x < grid_size; ++x)
+            {
+                triangles.push_back({
+                    CreateGridVertex(x, y, grid_size),
+                    CreateGridVertex(x, y + 1, grid_size),
+                    CreateGridVertex(x + 1, y, grid_size) });
+                triangles.push_back({
+                    CreateGridVertex(x + 1, y, grid_size),
+                    CreateGridVertex(x, y + 1, grid_size),
+                    CreateGridVertex(x + 1, y + 1, grid_size) });
+            }
+        }
+
+        if (shuffle)
+        {
+            std::mt19937 random(1);
+            std::shuffle(triangles.begin(), triangles.end(), random);
+        }
+
+        model_converter::FBXMesh mesh;
+        for (const std::array<model_converter::FBXVertex, 3>& triangle : triangles)
+        {
+            for (const model_converter::FBXVertex& vertex : triangle)
+            {
+                mesh.indices_.push_back(static_cast<u32>(mesh.vertices_.size()));
+                mesh.vertices_.push_back(vertex);
+            }
+        }
+        return mesh;
+    }
+
+} // namespace mesh_optimizer_test
+
+TEST(MeshOptimizer, ComputeACMR)
+{
+    // 1つの三角形は3回ミスする
+    EXPECT_FLOAT_EQ(model_converter::ComputeACMR({ 0, 1, 2 }, 3, 32), 3.0f);
+
+    // 辺を共有する2つの三角形は4回ミスする
+    EXPECT_FLOAT_EQ(model_converter::ComputeACMR({ 0, 1, 2, 2, 1, 3 }, 4, 32), 2.0f);
+
+    // キャッシュから追い出された頂点は再びミスする
+    EXPECT_FLOAT_EQ(model_converter::ComputeACMR({ 0, 1, 2, 3, 4, 5, 0, 1, 2 }, 6, 4), 3.0f);
+    EXPECT_FLOAT_EQ(model_converter::ComputeACMR({ 0, 1, 2, 3, 4, 5, 0, 1, 2 }, 6, 6), 2.0f);
+
+    // 空のメッシュ
+    EXPECT_FLOAT_EQ(model_converter::ComputeACMR({}, 0, 32), 0.0f);
+}
+
+TEST(MeshOptimizer, WeldVertices)
+{
+    model_converter::FBXMesh mesh = mesh_optimizer_test::CreateGridMesh(4, false);
+    const std::vector<mesh_optimizer_test::Triangle> triangles = mesh_optimizer_test::GetSortedTriangles(mesh);
+
+    model_converter::WeldVertices(mesh, 0.0f);
+
+    // グリッドの格子点の数まで減り、三角形は変わらない
+    EXPECT_EQ(mesh.vertices_.size(), 5u * 5u);
+    EXPECT_EQ(mesh_optimizer_test::GetSortedTriangles(mesh), triangles);
+}
+
+TEST(MeshOptimizer, WeldKeepsAttributeSeams)
+{
+    // 位置が同じでもUVや法線が異なる頂点はまとめない
+    model_converter::FBXMesh mesh;
+    model_converter::FBXVertex vertex = mesh_optimizer_test::CreateGridVertex(0, 0, 1);
+    mesh.vertices_.push_back(vertex);
+
+    vertex.uv_.x = 1.0f;
+    mesh.vertices_.push_back(vertex);
+
+    vertex.normal_ = DirectX::XMFLOAT3(0.0f, -1.0f, 0.0f);
+    mesh.vertices_.push_back(vertex);
+
+    // -0と+0はまとめる
+    model_converter::FBXVertex negative_zero = mesh.vertices_[0];
+    negative_zero.position_.x = -0.0f;
+    mesh.vertices_.push_back(negative_zero);
+
+    mesh.indices_ = { 0, 1, 2, 3, 1, 2 };
+    model_converter::WeldVertices(mesh, 0.0f);
+
+    EXPECT_EQ(mesh.vertices_.size(), 3u);
+    EXPECT_EQ(mesh.indices_, (std::vector<u32>{ 0, 1, 2, 0, 1, 2 }));
+}
+
+TEST(MeshOptimizer, WeldWithEpsilon)
+{
+    // 誤差のある頂点
+    model_converter::FBXMesh mesh = mesh_optimizer_test::CreateGridMesh(4, false);
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> noise(-1e-6f, 1e-6f);
+    for (model_converter::FBXVertex& vertex : mesh.vertices_)
+    {
+        vertex.position_.x += noise(random);
+        vertex.position_.z += noise(random);
+    }
+
+    // 完全一致では溶接されない
+    model_converter::FBXMesh exact_mesh = mesh;
+    model_converter::WeldVertices(exact_mesh, 0.0f);
+    EXPECT_EQ(exact_mesh.vertices_.size(), mesh.vertices_.size());
+
+    // 許容誤差内の頂点は溶接される
+    model_converter::WeldVertices(mesh, 1e-3f);
+    EXPECT_EQ(mesh.vertices_.size(), 5u * 5u);
+
+    // 溶接後の頂点は元の位置の近くにある
+    for (const model_converter::FBXVertex& vertex : mesh.vertices_)
+    {
+        EXPECT_NEAR(vertex.position_.x, std::round(vertex.position_.x), 1e-5f);
+        EXPECT_NEAR(vertex.position_.z, std::round(vertex.position_.z), 1e-5f);
+    }
+}
+
+TEST(MeshOptimizer, OptimizeVertexFetch)
+{
+    model_converter::FBXMesh mesh;
+    for (int i = 0; i < 5; ++i)
+        mesh.vertices_.push_back(mesh_optimizer_test::CreateGridVertex(i, 0, 1));
+    mesh.indices_ = { 3, 1, 4, 4, 1, 0 };
+
+    const std::vector<mesh_optimizer_test::Triangle> triangles = mesh_optimizer_test::GetSortedTriangles(mesh);
+    model_converter::OptimizeVertexFetch(mesh);
+
+    // 参照されない頂点2は取り除かれ、最初に参照される順に並ぶ
+    EXPECT_EQ(mesh.vertices_.size(), 4u);
+    EXPECT_EQ(mesh.indices_, (std::vector<u32>{ 0, 1, 2, 2, 1, 3 }));
+    EXPECT_EQ(mesh.vertices_[0].position_.x, 3.0f);
+    EXPECT_EQ(mesh.vertices_[3].position_.x, 0.0f);
+    EXPECT_EQ(mesh_optimizer_test::GetSortedTriangles(mesh), triangles);
+}
+
+TEST(MeshOptimizer, OptimizeVertexCache)
+{
+    // 三角形の順序がばらばらな溶接済みのメッシュ
+    model_converter::FBXMesh mesh = mesh_optimizer_test::CreateGridMesh(32, true);
+    model_converter::WeldVertices(mesh, 0.0f);
+    const std::vector<mesh_optimizer_test::Triangle> triangles = mesh_optimizer_test::GetSortedTriangles(mesh);
+
+    constexpr u32 CACHE_SIZE = 32;
+    const u32 vertex_count = static_cast<u32>(mesh.vertices_.size());
+    const float acmr_before = model_converter::ComputeACMR(mesh.indices_, vertex_count, CACHE_SIZE);
+
+    model_converter::OptimizeVertexCache(mesh.indices_, vertex_count, CACHE_SIZE);
+    const float acmr_after = model_converter::ComputeACMR(mesh.indices_, vertex_count, CACHE_SIZE);
+
+    std::cout << "ACMR: " << acmr_before << " -> " << acmr_after << std::endl;
+
+    // 三角形は向きを含めて変わらない
+    EXPECT_EQ(mesh_optimizer_test::GetSortedTriangles(mesh), triangles);
+
+    // グリッドの理想値0.5に近づく
+    EXPECT_LT(acmr_after, acmr_before);
+    EXPECT_LT(acmr_after, 0.8f);
+}
+
+TEST(MeshOptimizer, OptimizeMesh)
+{
+    model_converter::FBXMesh mesh = mesh_optimizer_test::CreateGridMesh(32, true);
+    const std::vector<mesh_optimizer_test::Triangle> triangles = mesh_optimizer_test::GetSortedTriangles(mesh);
+    const size_t index_count = mesh.indices_.size();
+
+    model_converter::MeshOptimizeSettings settings{};
+    model_converter::MeshOptimizeStats stats{};
+    ASSERT_TRUE(model_converter::OptimizeMesh(mesh, settings, stats));
+
+    std::cout << "Vertices: " << stats.vertex_count_before_ << " -> " << stats.vertex_count_after_
+        << ", ACMR: " << stats.acmr_before_ << " -> " << stats.acmr_after_ << std::endl;
+
+    // 三角形は変わらない
+    EXPECT_EQ(mesh.indices_.size(), index_count);
+    EXPECT_EQ(mesh_optimizer_test::GetSortedTriangles(mesh), triangles);
+
+    // 頂点は格子点の数まで減り、ACMRは下がる
+    EXPECT_EQ(stats.vertex_count_before_, index_count);
+    EXPECT_EQ(stats.vertex_count_after_, 33u * 33u);
+    EXPECT_EQ(mesh.vertices_.size(), stats.vertex_count_after_);
+    EXPECT_FLOAT_EQ(stats.acmr_before_, 3.0f);
+    EXPECT_LT(stats.acmr_after_, 0.8f);
+
+    // 頂点は最初に参照される順に並ぶ
+    u32 next_vertex = 0;
+    for (u32 index : mesh.indices_)
+    {
+        ASSERT_LE(index, next_vertex);
+        if (index == next_vertex)
+            ++next_vertex;
+    }
+}
+
+TEST(MeshOptimizer, NotTriangleList)
+{
+    model_converter::FBXMesh mesh;
+    for (int i = 0; i < 4; ++i)
+        mesh.vertices_.push_back(mesh_optimizer_test::CreateGridVertex(i, 0, 1));
+    mesh.indices_ = { 0, 1, 2, 3 };
+
+    model_converter::MeshOptimizeStats stats{};
+    EXPECT_FALSE(model_converter::OptimizeMesh(mesh, model_converter::MeshOptimizeSettings{}, stats));
+    EXPECT_EQ(mesh.vertices_.size(), 4u);
+    EXPECT_EQ(mesh.indices_, (std::vector<u32>{ 0, 1, 2, 3 }));
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "include/fbx_loader.h"
 #include "include/file_utils.h"
 
+#include <cstring>
+
 TEST(MFM, Convert)
 {
     // FBXファイルの読み込み
@@ -22,4 +24,76 @@ TEST(MFM, Convert)
     // 変換後のデータをファイルに保存
     bool write_result = model_converter::WriteFile("../output/test_cube.mfm", mfm_data.get(), mfm_data_size);
     EXPECT_TRUE(write_result);
+}
+
+TEST(MFM, ConvertVersion2)
+{
+    // マテリアルを2つ持つデータを作る
+    model_converter::FBXFileData data;
+    data.AddMaterial(0, "first");
+    data.AddMaterial(1, "second_material");
+
+    model_converter::FBXVertex vertex{};
+    for (u32 i = 0; i < 3; ++i)
+    {
+        vertex.position_ = DirectX::XMFLOAT3(static_cast<float>(i), -1.0f, 2.0f);
+        data.AddVertex(vertex, 0);
+        data.AddIndex(i, 0);
+    }
+
+    for (u32 i = 0; i < 4; ++i)
+    {
+        vertex.position_ = DirectX::XMFLOAT3(-3.0f, static_cast<float>(i), 0.5f);
+        data.AddVertex(vertex, 1);
+    }
+    for (u32 index : { 0u, 1u, 2u, 2u, 1u, 3u })
+        data.AddIndex(index, 1);
+
+    model_converter::MFMConverter converter;
+    u32 mfm_data_size = 0;
+    std::unique_ptr<u8[]> mfm_data = converter.Convert(&data, mfm_data_size);
+    ASSERT_NE(mfm_data, nullptr);
+
+    // ヘッダー
+    model_converter::MFMFileHeader file_header{};
+    std::memcpy(&file_header, mfm_data.get(), sizeof(file_header));
+    EXPECT_EQ(file_header.file_size, mfm_data_size);
+    EXPECT_EQ(file_header.content_type, model_converter::MFM_CONTENT_TYPE_MESH_TABLE);
+
+    model_converter::MFMHeaderV2 header{};
+    std::memcpy(&header, mfm_data.get() + sizeof(file_header), sizeof(header));
+    EXPECT_EQ(header.version, model_converter::MFM_VERSION_2);
+    EXPECT_EQ(header.mesh_count, 2u);
+    EXPECT_EQ(header.mesh_directory_offset % model_converter::MFM_V2_ALIGNMENT, 0u);
+    EXPECT_EQ(header.bounds.min[0], -3.0f);
+    EXPECT_EQ(header.bounds.max[0], 2.0f);
+    EXPECT_EQ(header.bounds.min[1], -1.0f);
+    EXPECT_EQ(header.bounds.max[1], 3.0f);
+
+    // メッシュはマテリアルインデックス順に並ぶ
+    const char* material_names[] = { "first", "second_material" };
+    for (u32 i = 0; i < header.mesh_count; ++i)
+    {
+        model_converter::MFMMeshEntry entry{};
+        std::memcpy(
+            &entry, mfm_data.get() + header.mesh_directory_offset + header.mesh_entry_size * i, sizeof(entry));
+
+        EXPECT_EQ(entry.vertex_offset % model_converter::MFM_V2_ALIGNMENT, 0u);
+        EXPECT_EQ(entry.index_offset % model_converter::MFM_V2_ALIGNMENT, 0u);
+        ASSERT_LE(static_cast<u64>(entry.index_offset) + entry.index_size * entry.index_count, mfm_data_size);
+
+        // マテリアル名はnull終端付き
+        const char* name = reinterpret_cast<const char*>(mfm_data.get() + entry.material_name_offset);
+        EXPECT_EQ(std::string(name, entry.material_name_size), material_names[i]);
+        EXPECT_EQ(name[entry.material_name_size], '\0');
+
+        // 頂点とインデックスはそのまま書き込まれる
+        const std::vector<model_converter::FBXVertex>& vertices = data.GetVertices(static_cast<int>(i));
+        const std::vector<u32>& indices = data.GetIndices(static_cast<int>(i));
+        ASSERT_EQ(entry.vertex_count, vertices.size());
+        ASSERT_EQ(entry.index_count, indices.size());
+        EXPECT_EQ(std::memcmp(
+            mfm_data.get() + entry.vertex_offset, vertices.data(), vertices.size() * sizeof(model_converter::FBXVertex)), 0);
+        EXPECT_EQ(std::memcmp(mfm_data.get() + entry.index_offset, indices.data(), indices.size() * sizeof(u32)), 0);
+    }
 }
\ No newline at end of file
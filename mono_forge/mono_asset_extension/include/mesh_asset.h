@@ -6,6 +6,7 @@
 #include "asset_loader/include/asset.h"
 #include "asset_loader/include/asset_loader.h"
 #include "geometry/include/geometry.h"
+#include "geometry/include/bounding_volume.h"
 #include "mono_forge_model/include/mfm.h"
 #include "render_graph/include/resource_handle.h"
 #include "mono_service/include/service_registry.h"
@@ -46,6 +47,9 @@ public:
     // Get the number of indices
     const std::vector<uint32_t>* GetIndexCounts() const;
 
+    // Get the local bounding box of all meshes
+    const geometry::AABB& GetBoundingBox() const;
+
 private:
     // Service proxy for asset management
     std::unique_ptr<mono_service::ServiceProxy> graphics_service_proxy_ = nullptr;
@@ -58,6 +62,9 @@ private:
 
     // Number of indices
     std::vector<uint32_t> index_counts_ = {};
+
+    // Local bounding box of all meshes
+    geometry::AABB bounding_box_ = geometry::AABB();
 };
 
 // Source data for the MeshAsset
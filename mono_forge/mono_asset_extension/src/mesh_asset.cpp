@@ -52,6 +52,11 @@ bool MeshAsset::Setup(
     for (size_t i = 0; i < index_count.size(); ++i)
         index_counts_[i] = index_count[i];
 
+    // Compute the bounding box while the vertex data is still on the CPU
+    bounding_box_ = geometry::AABB();
+    for (size_t i = 0; i < vertex_data.size(); ++i)
+        bounding_box_ = geometry::MergeAABB(bounding_box_, geometry::ComputeAABB(vertex_data[i], vertex_count[i]));
+
     // Create graphics service command list to create buffers
     std::unique_ptr<mono_service::ServiceCommandList> command_list
         = graphics_service_proxy_->CreateCommandList();
@@ -119,6 +124,12 @@ const std::vector<uint32_t>* MeshAsset::GetIndexCounts() const
     return &index_counts_;
 }
 
+const geometry::AABB& MeshAsset::GetBoundingBox() const
+{
+    assert(IsSetup() && "MeshAsset is not set up");
+    return bounding_box_;
+}
+
 MeshAssetSourceData::MeshAssetSourceData(std::unique_ptr<mono_service::ServiceProxy> graphics_service_proxy) :
     graphics_service_proxy_(std::move(graphics_service_proxy))
 {
@@ -177,17 +188,10 @@ std::unique_ptr<asset_loader::Asset> MeshAssetLoader::Load(
 
         if (file_extension == mono_forge_model::MFM_FILE_EXT)
         {
-            // Load MFM file data
-            std::unique_ptr<uint8_t[]> mfm_file_data = nullptr;
-            fpos_t mfm_file_size = 0;
-            mfm_file_data = utility_header::LoadFile(file_path, mfm_file_size);
-            if (mfm_file_data == nullptr)
-                return nullptr; // Failed to load file
-
-            // Create MFM object
-            std::unique_ptr<mono_forge_model::MFM> mfm 
-                = std::make_unique<mono_forge_model::MFM>(
-                    std::move(mfm_file_data), static_cast<uint32_t>(mfm_file_size));
+            // Memory map MFM file, the vertex and index data are read in place
+            std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Open(file_path);
+            if (mfm == nullptr)
+                return nullptr; // Failed to load file or it is corrupted
 
             // Store the MFM data
             mesh_source_data->SetMFMData(std::move(mfm));
@@ -234,14 +238,14 @@ std::unique_ptr<asset_loader::Asset> MeshAssetLoader::Load(
         std::vector<const uint32_t*> index_datas;
         std::vector<uint32_t> index_counts;
 
-        for (uint32_t material_index = 0; material_index < mfm.GetMeshHeader()->material_count; ++material_index)
+        for (uint32_t material_index = 0; material_index < mfm.GetMeshCount(); ++material_index)
         {
-            // Get mesh node
-            const mono_forge_model::MFMMeshNode* mesh_node = mfm.GetMeshNode(material_index);
+            // Get mesh entry
+            const mono_forge_model::MFMMeshEntry& mesh_entry = mfm.GetMeshEntry(material_index);
 
             // Check vertex size same as geometry vertex size
             assert(
-                sizeof(geometry::Geometry::Vertex) == mesh_node->vertex_size && 
+                sizeof(geometry::Geometry::Vertex) == mesh_entry.vertex_size && 
                 "Vertex size mismatch between Geometry and MFM data");
 
             // Cast vertex data type to geometry vertex type
@@ -250,7 +254,7 @@ std::unique_ptr<asset_loader::Asset> MeshAssetLoader::Load(
 
             // Check index size same as geometry index size
             assert(
-                sizeof(geometry::Geometry::Index) == mesh_node->index_size && 
+                sizeof(geometry::Geometry::Index) == mesh_entry.index_size && 
                 "Index size mismatch between Geometry and MFM data");
 
             // Cast index data type to geometry index type
@@ -259,9 +263,9 @@ std::unique_ptr<asset_loader::Asset> MeshAssetLoader::Load(
 
             // Store vertex and index data
             vertex_datas.push_back(vertex_data);
-            vertex_counts.push_back(mesh_node->vertex_count);
+            vertex_counts.push_back(mesh_entry.vertex_count);
             index_datas.push_back(index_data);
-            index_counts.push_back(mesh_node->index_count);
+            index_counts.push_back(mesh_entry.index_count);
         }
 
         // Create the mesh asset instance form the MFM data
@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "class_template/non_copy.h"
+
+#include "asset_loader/include/asset_loader.h"
+#include "asset_loader/include/asset_manager.h"
+#include "asset_loader/include/asset_source.h"
+
+#include "mono_asset_service/include/dll_config.h"
+
+namespace mono_asset_service
+{
+
+// The priority of an asset load, loads with a higher priority start first
+using AssetLoadPriority = int32_t;
+
+// The default priority of an asset load
+constexpr AssetLoadPriority DEFAULT_ASSET_LOAD_PRIORITY = 0;
+
+// The result of a finished asset load
+enum class AssetLoadResult
+{
+    Loaded, // The asset was loaded, committed and registered
+    Failed, // The loader was not found, or Load or Commit failed
+};
+
+// The asset source of a finished asset load
+struct FinishedAssetLoad
+{
+    std::unique_ptr<asset_loader::AssetSource> source = nullptr;
+    AssetLoadResult result = AssetLoadResult::Loaded;
+};
+
+// The pool of persistent worker threads that load asset sources concurrently
+// Each asset source is prepared, loaded and committed on its own staging area by a worker,
+// then its asset is registered as soon as it finishes, so a slow asset does not hold back the others
+// The loader registry is only locked to look up the loader, not while the asset is loading
+class MONO_ASSET_SERVICE_DLL AssetLoadingPool :
+    public class_template::NonCopyable
+{
+public:
+    // worker_count must be at least 1
+    AssetLoadingPool(
+        size_t worker_count, asset_loader::AssetLoaderManager& loader_manager, 
+        asset_loader::AssetRegistrar& asset_registrar);
+
+    // Queued loads are dropped and running loads are waited for
+    ~AssetLoadingPool();
+
+    // Queue the asset source to be loaded
+    // Loads with the same priority start in the order they were pushed
+    void Push(std::unique_ptr<asset_loader::AssetSource> source, AssetLoadPriority priority);
+
+    // Cancel the load of the asset, return false if it is not queued or loading
+    // A queued load is dropped, a running load finishes but its asset is not registered
+    bool Cancel(asset_loader::AssetHandleID handle_id);
+
+    // Move the finished loads into the given vector
+    void TakeFinished(std::vector<FinishedAssetLoad>& finished_loads);
+
+    // Wait until no asset of the loader is queued or loading
+    // Call it before unregistering the loader
+    void WaitForLoader(asset_loader::AssetLoaderID loader_id);
+
+    // Wait until no asset is queued or loading
+    void WaitForAll();
+
+    // Get the number of queued and running loads
+    size_t GetPendingCount() const;
+
+    // Get the number of worker threads
+    size_t GetWorkerCount() const { return workers_.size(); }
+
+private:
+    // The key to order queued loads, higher priority first, then in push order
+    using QueueKey = std::pair<AssetLoadPriority, uint64_t>;
+    struct QueueKeyCompare
+    {
+        bool operator()(const QueueKey& a, const QueueKey& b) const
+        {
+            if (a.first != b.first)
+                return a.first > b.first;
+            return a.second < b.second;
+        }
+    };
+
+    // The state of a running load
+    struct RunningLoad
+    {
+        asset_loader::AssetLoaderID loader_id = asset_loader::AssetLoaderID();
+        bool cancelled = false;
+    };
+
+    // Check if an asset of the loader is queued or loading, mutex_ must be locked
+    bool HasLoader(asset_loader::AssetLoaderID loader_id) const;
+
+    // Load the asset source with its loader, the lock is not held
+    std::unique_ptr<asset_loader::Asset> Load(asset_loader::AssetSource& source);
+
+    // The loop of the worker threads
+    void WorkerLoop();
+
+    asset_loader::AssetLoaderManager& loader_manager_;
+    asset_loader::AssetRegistrar& asset_registrar_;
+
+    std::vector<std::thread> workers_; // The persistent worker threads
+    mutable std::mutex mutex_; // The mutex guarding the state below
+    std::condition_variable work_condition_; // Notified when loads are queued or the workers must exit
+    std::condition_variable idle_condition_; // Notified when a load finishes or is cancelled
+
+    bool stop_ = false; // True when the workers must exit
+    uint64_t push_count_ = 0; // The number of pushed loads, used to keep the push order
+    std::map<QueueKey, std::unique_ptr<asset_loader::AssetSource>, QueueKeyCompare> queue_; // The queued loads
+    std::unordered_map<asset_loader::AssetHandleID, QueueKey> queued_keys_; // The queue key of each queued asset
+    std::unordered_map<asset_loader::AssetHandleID, RunningLoad> running_; // The loads being run by the workers
+    std::vector<FinishedAssetLoad> finished_; // The loads finished since the last TakeFinished
+};
+
+} // namespace mono_asset_service
\ No newline at end of file
@@ -3,7 +3,6 @@
 #include <memory>
 #include <unordered_map>
 #include <vector>
-#include <future>
 
 #include "class_template/thread_safer.h"
 
@@ -14,6 +13,7 @@
 #include "mono_service/include/service_registry.h"
 
 #include "mono_asset_service/include/dll_config.h"
+#include "mono_asset_service/include/asset_loading_pool.h"
 
 namespace mono_asset_service
 {
@@ -42,6 +42,9 @@ public:
     // Get the asset sources
     virtual asset_loader::AssetSources& GetAssetSources() = 0;
 
+    // Get the pool that loads asset sources on worker threads
+    virtual AssetLoadingPool& GetLoadingPool() = 0;
+
     // Get the loading asset sources
     virtual std::unordered_map<
         asset_loader::AssetHandleID, std::unique_ptr<asset_loader::AssetSource>>& GetLoadingAssetSources() = 0;
@@ -65,6 +68,9 @@ public:
 // The number of command queue buffers for asset_service
 constexpr size_t SERVICE_COMMAND_QUEUE_BUFFER_COUNT = 2;
 
+// The default number of worker threads that load assets
+constexpr size_t DEFAULT_LOADING_WORKER_COUNT = 4;
+
 // The asset service handle type
 class MONO_ASSET_SERVICE_DLL AssetServiceHandle : public mono_service::ServiceHandle<AssetServiceHandle> {};
 
@@ -91,6 +97,9 @@ public:
         }
 
         virtual ~SetupParam() override = default;
+
+        // The number of worker threads that load assets
+        size_t loading_worker_count = DEFAULT_LOADING_WORKER_COUNT;
     };
     virtual bool Setup(mono_service::Service::SetupParam& param) override;
     virtual bool PreUpdate() override;
@@ -112,6 +121,7 @@ protected:
     virtual asset_loader::AssetRegistrar& GetAssetRegistrar() override;
     virtual asset_loader::AssetUnregistrar& GetAssetUnregistrar() override;
     virtual asset_loader::AssetSources& GetAssetSources() override;
+    virtual AssetLoadingPool& GetLoadingPool() override;
     virtual std::unordered_map<
         asset_loader::AssetHandleID, std::unique_ptr<asset_loader::AssetSource>>& GetLoadingAssetSources() override;
 
@@ -144,16 +154,8 @@ private:
     std::unordered_map<
     asset_loader::AssetHandleID, std::unique_ptr<asset_loader::AssetSource>> loading_asset_sources_;
 
-    // Futures for loading assets
-    std::vector<std::future<bool>> loading_futures_;
-
-    // In-progress loaded asset info
-    struct LoadingAssetInfo
-    {
-        asset_loader::AssetHandleID handle_id = asset_loader::AssetHandleID();
-        std::unique_ptr<asset_loader::Asset> asset = nullptr;
-    };
-    std::vector<LoadingAssetInfo> in_progress_loaded_assets_;
+    // The pool that loads asset sources on worker threads
+    std::unique_ptr<AssetLoadingPool> loading_pool_ = nullptr;
 
     // Map from loaded asset name to handle ID
     std::unordered_map<std::string, asset_loader::AssetHandleID> loaded_asset_name_to_handle_id_map_;
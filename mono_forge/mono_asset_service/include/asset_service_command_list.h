@@ -23,7 +23,14 @@ public:
     void UnregisterLoader(asset_loader::AssetLoaderID id);
 
     // Load an asset the given asset source
-    void LoadAsset(std::unique_ptr<asset_loader::AssetSource> asset_source);
+    // The asset is loaded on a worker thread, assets with a higher priority start loading first
+    void LoadAsset(
+        std::unique_ptr<asset_loader::AssetSource> asset_source, 
+        AssetLoadPriority priority = DEFAULT_ASSET_LOAD_PRIORITY);
+
+    // Cancel loading the asset with the given handle ID
+    // It does nothing if the asset is already loaded, release it instead
+    void CancelLoadAsset(asset_loader::AssetHandleID handle_id);
 
     // Release an asset with the given handle ID
     void ReleaseAsset(asset_loader::AssetHandleID handle_id);
@@ -0,0 +1,216 @@
+﻿#include "mono_asset_service/src/pch.h"
+#include "mono_asset_service/include/asset_loading_pool.h"
+
+namespace mono_asset_service
+{
+
+AssetLoadingPool::AssetLoadingPool(
+    size_t worker_count, asset_loader::AssetLoaderManager& loader_manager, 
+    asset_loader::AssetRegistrar& asset_registrar) :
+    loader_manager_(loader_manager),
+    asset_registrar_(asset_registrar)
+{
+    assert(worker_count > 0 && "AssetLoadingPool needs at least one worker.");
+
+    // Create the persistent workers
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+        workers_.emplace_back([this]() { WorkerLoop(); });
+}
+
+AssetLoadingPool::~AssetLoadingPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+
+        // Drop the loads that have not started
+        queue_.clear();
+        queued_keys_.clear();
+    }
+    work_condition_.notify_all();
+
+    // Wait for the running loads and the workers to exit
+    for (std::thread& worker : workers_)
+        worker.join();
+}
+
+void AssetLoadingPool::Push(std::unique_ptr<asset_loader::AssetSource> source, AssetLoadPriority priority)
+{
+    assert(source != nullptr && "Asset source is null.");
+    assert(source->description != nullptr && "Asset description is null.");
+    assert(source->source_data != nullptr && "Asset source data is null.");
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        const asset_loader::AssetHandleID handle_id = source->description->GetHandleID();
+        assert(
+            queued_keys_.find(handle_id) == queued_keys_.end() && running_.find(handle_id) == running_.end() &&
+            "The asset is already loading.");
+
+        const QueueKey key(priority, push_count_++);
+        queued_keys_[handle_id] = key;
+        queue_.emplace(key, std::move(source));
+    }
+    work_condition_.notify_one();
+}
+
+bool AssetLoadingPool::Cancel(asset_loader::AssetHandleID handle_id)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Drop the queued load
+        auto queued_it = queued_keys_.find(handle_id);
+        if (queued_it != queued_keys_.end())
+        {
+            queue_.erase(queued_it->second);
+            queued_keys_.erase(queued_it);
+        }
+        else
+        {
+            // Mark the running load, its worker drops the asset when it finishes
+            auto running_it = running_.find(handle_id);
+            if (running_it == running_.end() || running_it->second.cancelled)
+                return false; // Not loading
+
+            running_it->second.cancelled = true;
+            return true;
+        }
+    }
+    idle_condition_.notify_all();
+
+    return true;
+}
+
+void AssetLoadingPool::TakeFinished(std::vector<FinishedAssetLoad>& finished_loads)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (FinishedAssetLoad& finished_load : finished_)
+        finished_loads.emplace_back(std::move(finished_load));
+    finished_.clear();
+}
+
+void AssetLoadingPool::WaitForLoader(asset_loader::AssetLoaderID loader_id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_condition_.wait(lock, [&]() { return !HasLoader(loader_id); });
+}
+
+void AssetLoadingPool::WaitForAll()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_condition_.wait(lock, [&]() { return queue_.empty() && running_.empty(); });
+}
+
+size_t AssetLoadingPool::GetPendingCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return queue_.size() + running_.size();
+}
+
+bool AssetLoadingPool::HasLoader(asset_loader::AssetLoaderID loader_id) const
+{
+    for (const auto& [handle_id, running_load] : running_)
+    {
+        if (running_load.loader_id == loader_id)
+            return true;
+    }
+
+    for (const auto& [key, source] : queue_)
+    {
+        if (source->description->GetLoaderID() == loader_id)
+            return true;
+    }
+
+    return false;
+}
+
+std::unique_ptr<asset_loader::Asset> AssetLoadingPool::Load(asset_loader::AssetSource& source)
+{
+    // Look up the loader, the registry is only locked for the lookup
+    // WaitForLoader keeps the loader registered until this load finishes
+    asset_loader::AssetLoader* loader = nullptr;
+    loader_manager_.WithLock([&](asset_loader::AssetLoaderManager& manager)
+    {
+        if (manager.Contains(source.description->GetLoaderID()))
+            loader = &manager.GetLoader(source.description->GetLoaderID());
+    });
+
+    if (loader == nullptr)
+        return nullptr; // Loader is not registered
+
+    // Each asset has its own staging area, so it can be committed as soon as it is loaded
+    std::unique_ptr<asset_loader::LoadingStagingArea> staging_area = loader->Prepare();
+
+    // Load the asset
+    std::unique_ptr<asset_loader::Asset> asset = loader->Load(*source.source_data, *staging_area);
+    if (asset == nullptr)
+        return nullptr; // Failed to load
+
+    // Commit the changes
+    if (!loader->Commit(*staging_area))
+        return nullptr; // Failed to commit
+
+    return asset;
+}
+
+void AssetLoadingPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        work_condition_.wait(lock, [&]() { return stop_ || !queue_.empty(); });
+        if (stop_)
+            return;
+
+        // Take the load with the highest priority
+        auto queue_it = queue_.begin();
+        std::unique_ptr<asset_loader::AssetSource> source = std::move(queue_it->second);
+        queue_.erase(queue_it);
+
+        const asset_loader::AssetHandleID handle_id = source->description->GetHandleID();
+        queued_keys_.erase(handle_id);
+
+        RunningLoad& running_load = running_[handle_id];
+        running_load.loader_id = source->description->GetLoaderID();
+        running_load.cancelled = false;
+
+        // Load without the lock, so that other workers and the service can continue
+        lock.unlock();
+        std::unique_ptr<asset_loader::Asset> asset = Load(*source);
+        lock.lock();
+
+        // Drop the asset if the load was cancelled while it was running
+        auto running_it = running_.find(handle_id);
+        assert(running_it != running_.end() && "Running load not found.");
+        if (!running_it->second.cancelled)
+        {
+            FinishedAssetLoad finished_load;
+            if (asset != nullptr)
+            {
+                // Register the asset while locked, so that the source is finished once the asset is visible
+                asset_registrar_.RegisterAsset(handle_id, std::move(asset));
+                finished_load.result = AssetLoadResult::Loaded;
+            }
+            else
+            {
+                finished_load.result = AssetLoadResult::Failed;
+            }
+
+            finished_load.source = std::move(source);
+            finished_.emplace_back(std::move(finished_load));
+        }
+        running_.erase(running_it);
+
+        // Destroy the cancelled source and asset without the lock
+        lock.unlock();
+        source.reset();
+        asset.reset();
+        idle_condition_.notify_all();
+        lock.lock();
+    }
+}
+
+} // namespace mono_asset_service
\ No newline at end of file
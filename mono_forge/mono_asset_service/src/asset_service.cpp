@@ -20,6 +20,9 @@ AssetService::~AssetService()
      * Asset loader cleanup
     /******************************************************************************************************************/
 
+    // Stop the loading workers before the loaders and assets they use are destroyed
+    loading_pool_.reset();
+
     loader_unregistrar_.reset();
     loader_registrar_.reset();
     loader_manager_.reset();
@@ -74,6 +77,14 @@ bool AssetService::Setup(mono_service::Service::SetupParam& param)
     // Create asset unregistrar
     asset_unregistrar_ = std::make_unique<asset_loader::AssetUnregistrar>(*asset_registry_);
 
+    // Cast setup param to AssetService::SetupParam
+    AssetService::SetupParam* asset_service_param = dynamic_cast<AssetService::SetupParam*>(&param);
+    assert(asset_service_param != nullptr && "Invalid setup param type for AssetService.");
+
+    // Create loading pool
+    loading_pool_ = std::make_unique<AssetLoadingPool>(
+        asset_service_param->loading_worker_count, *loader_manager_, *asset_registrar_);
+
     return true; // Setup successful
 }
 
@@ -97,6 +108,27 @@ bool AssetService::Update()
 
     bool result = false;
 
+    // Take the loads finished since the last update before executing commands,
+    // so that commands can release the sources of assets that are already visible
+    std::vector<FinishedAssetLoad> finished_loads;
+    loading_pool_->TakeFinished(finished_loads);
+
+    bool load_failed = false;
+    for (FinishedAssetLoad& finished_load : finished_loads)
+    {
+        if (finished_load.result == AssetLoadResult::Failed)
+        {
+            utility_header::ConsoleLogErr(
+                {"Failed to load asset: ", std::string(finished_load.source->source_data->GetName())},
+                __FILE__, __LINE__, __FUNCTION__);
+            load_failed = true;
+            continue;
+        }
+
+        // Store source datas that are used by the loaded assets
+        loading_asset_sources_[finished_load.source->description->GetHandleID()] = std::move(finished_load.source);
+    }
+
     // Execute all command lists in the executable command queue
     while (!GetExecutableCommandQueue().IsEmpty())
     {
@@ -114,112 +146,19 @@ bool AssetService::Update()
         }
     }
 
-    // The map of asset sources grouped by their loader ID
-    std::unordered_map
-    <asset_loader::AssetLoaderID, std::vector<std::unique_ptr<asset_loader::AssetSource>>> sources_by_loader;
-
-    // Group asset sources by their loader ID
+    // Queue asset sources added without a priority
     for (std::unique_ptr<asset_loader::AssetSource>& source : asset_sources_)
-    {
-        // Get the loader ID from the asset source description
-        asset_loader::AssetLoaderID loader_id = source->description->GetLoaderID();
-
-        // Add the asset source to the corresponding loader ID group
-        sources_by_loader[loader_id].emplace_back(std::move(source));
-    }
+        loading_pool_->Push(std::move(source), DEFAULT_ASSET_LOAD_PRIORITY);
 
     // Clear asset sources to prepare for next frame
     asset_sources_.clear();
 
-    if (!sources_by_loader.empty())
-    {
-        // Launch asynchronous task to load assets
-        std::future<bool> load_future 
-            = std::async(std::launch::async, [sources_by_loader = std::move(sources_by_loader), this]() mutable
-        {
-            bool result = false;
-
-            // Load assets for each loader ID group
-            for (auto& [loader_id, sources] : sources_by_loader)
-            {
-                asset_loader::AssetLoaderManager::GetInstance().WithLock([&](asset_loader::AssetLoaderManager& manager)
-                {
-                    // Get the asset loader
-                    asset_loader::AssetLoader& loader = manager.GetLoader(loader_id);
-
-                    // Prepare staging areas for all asset sources
-                    std::unique_ptr<asset_loader::LoadingStagingArea> staging_area = loader.Prepare();
-
-                    // Load each asset source using the loader
-                    for (std::unique_ptr<asset_loader::AssetSource>& source : sources)
-                    {
-                        // Load the asset using the loader
-                        std::unique_ptr<asset_loader::Asset> asset
-                            = loader.Load(*source->source_data, *staging_area);
-                        if (asset == nullptr)
-                            return; // If loading failed, return
-
-                        // Add to in-progress loaded assets
-                        in_progress_loaded_assets_.emplace_back(
-                            LoadingAssetInfo{source->description->GetHandleID(), std::move(asset)});
-                    }
-
-                    // Commit the changes
-                    result = loader.Commit(*staging_area);
-                    if (!result)
-                        return; // If committing failed, return
-
-                });
-
-                if (!result)
-                    return false; // Stop update on failure
-            }
-
-            // Store source datas that are still loading
-            for (auto& [loader_id, sources] : sources_by_loader)
-                for (auto& source : sources)
-                    loading_asset_sources_[source->description->GetHandleID()] = std::move(source);
-
-            return true; // Loading successful
-        });
-
-        // Store the future for tracking
-        loading_futures_.emplace_back(std::move(load_future));
-    }
-
-    // Iterate through loading futures and remove completed ones
-    std::vector<size_t> completed_indices;
-    for (size_t i = 0; i < loading_futures_.size(); ++i)
-    {
-        std::future<bool>& future = loading_futures_[i];
-        if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
-        {
-            // Future is ready, get the result
-            result = future.get();
-            if (!result)
-                return false; // Stop update on failure
-
-            // Mark this index for removal
-            completed_indices.push_back(i);
-        }
-    }
-
-    if (loading_futures_.size() == completed_indices.size() && !completed_indices.empty())
-    {
-        // All futures are completed, clear the vector
-        loading_futures_.clear();
-
-        // Register loaded assets
-        for (LoadingAssetInfo& info : in_progress_loaded_assets_)
-            asset_registrar_->RegisterAsset(info.handle_id, std::move(info.asset));
-
-        // Clear in-progress loaded assets
-        in_progress_loaded_assets_.clear();
-    }
-
     // End frame update
     EndFrame();
 
+    if (load_failed)
+        return false; // Stop update on load failure
+
     return true; // Update successful
 }
 
@@ -272,6 +211,12 @@ asset_loader::AssetSources& AssetService::GetAssetSources()
     return asset_sources_;
 }
 
+AssetLoadingPool& AssetService::GetLoadingPool()
+{
+    assert(IsSetup() && "AssetService is not set up.");
+    return *loading_pool_;
+}
+
 std::unordered_map<
     asset_loader::AssetHandleID, std::unique_ptr<asset_loader::AssetSource>>& AssetService::GetLoadingAssetSources()
 {
@@ -38,6 +38,9 @@ void AssetServiceCommandList::UnregisterLoader(asset_loader::AssetLoaderID id)
             "AssetServiceAPI must be derived from ServiceAPI.");
         AssetServiceAPI& asset_service_api = dynamic_cast<AssetServiceAPI&>(service_api);
 
+        // Wait for the assets being loaded by the loader
+        asset_service_api.GetLoadingPool().WaitForLoader(id);
+
         // Unregister asset loader
         asset_service_api.GetLoaderUnregistrar().Unregister(id);
 
@@ -45,9 +48,10 @@ void AssetServiceCommandList::UnregisterLoader(asset_loader::AssetLoaderID id)
     });
 }
 
-void AssetServiceCommandList::LoadAsset(std::unique_ptr<asset_loader::AssetSource> asset_source)
+void AssetServiceCommandList::LoadAsset(
+    std::unique_ptr<asset_loader::AssetSource> asset_source, AssetLoadPriority priority)
 {
-    AddCommand([asset_source = std::move(asset_source)](mono_service::ServiceAPI& service_api) mutable -> bool
+    AddCommand([asset_source = std::move(asset_source), priority](mono_service::ServiceAPI& service_api) mutable -> bool
     {
         // Get graphics service API
         static_assert(
@@ -59,9 +63,37 @@ void AssetServiceCommandList::LoadAsset(std::unique_ptr<asset_loader::AssetSourc
         asset_service_api.GetLoadedAssetNameToHandleIDMap()[asset_source->source_data->GetName().data()]
             = asset_source->description->GetHandleID();
 
-        // Add asset source
-        // This will trigger the asset loading process in the asset service
-        asset_service_api.GetAssetSources().emplace_back(std::move(asset_source));
+        // Queue asset source in the loading pool
+        asset_service_api.GetLoadingPool().Push(std::move(asset_source), priority);
+
+        return true;
+    });
+}
+
+void AssetServiceCommandList::CancelLoadAsset(asset_loader::AssetHandleID handle_id)
+{
+    AddCommand([handle_id](mono_service::ServiceAPI& service_api) -> bool
+    {
+        // Get graphics service API
+        static_assert(
+            std::is_base_of<mono_service::ServiceAPI, AssetServiceAPI>::value,
+            "AssetServiceAPI must be derived from ServiceAPI.");
+        AssetServiceAPI& asset_service_api = dynamic_cast<AssetServiceAPI&>(service_api);
+
+        // Cancel loading
+        if (!asset_service_api.GetLoadingPool().Cancel(handle_id))
+            return true; // Not loading
+
+        // Remove from loaded asset name to handle ID map
+        auto& name_to_handle_id_map = asset_service_api.GetLoadedAssetNameToHandleIDMap();
+        for (auto it = name_to_handle_id_map.begin(); it != name_to_handle_id_map.end(); ++it)
+        {
+            if (it->second == handle_id)
+            {
+                name_to_handle_id_map.erase(it);
+                break;
+            }
+        }
 
         return true;
     });
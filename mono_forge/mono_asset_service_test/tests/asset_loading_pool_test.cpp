@@ -0,0 +1,362 @@
+﻿#include "mono_asset_service_test/pch.h"
+
+#include "mono_service/include/service_importer.h"
+#include "mono_service/include/thread_affinity.h"
+
+#include "mono_asset_service/include/asset_loading_pool.h"
+#include "mono_asset_service/include/asset_service.h"
+#include "mono_asset_service/include/asset_service_command_list.h"
+#include "mono_asset_service/include/asset_service_view.h"
+
+#include "mono_asset_service_test/tests/test_delayed_asset_loader.h"
+
+namespace mono_asset_service_test
+{
+
+// The loader and asset registries used by the loading pool tests
+class LoadingPoolTestContext
+{
+public:
+    LoadingPoolTestContext()
+    {
+        loader_manager = std::make_unique<asset_loader::AssetLoaderManager>(loader_registry);
+
+        // Register the delayed asset loader
+        std::unique_ptr<DelayedAssetLoader> delayed_loader = std::make_unique<DelayedAssetLoader>();
+        loader = delayed_loader.get();
+        asset_loader::AssetLoaderRegistrar(loader_registry).Register(DelayedAssetLoader::ID(), std::move(delayed_loader));
+
+        asset_registrar = std::make_unique<asset_loader::AssetRegistrar>(asset_registry);
+    }
+
+    // Check if the asset is registered
+    bool IsRegistered(asset_loader::AssetHandleID handle_id)
+    {
+        bool is_registered = false;
+        asset_registry.WithUniqueLock([&](asset_loader::AssetRegistry& registry)
+        {
+            is_registered = registry.Contains(handle_id);
+        });
+        return is_registered;
+    }
+
+    asset_loader::AssetLoaderIDGenerator loader_id_generator;
+    asset_loader::AssetHandleIDGenerator handle_id_generator;
+    asset_loader::AssetLoaderRegistry loader_registry;
+    std::unique_ptr<asset_loader::AssetLoaderManager> loader_manager = nullptr;
+    asset_loader::AssetRegistry asset_registry;
+    std::unique_ptr<asset_loader::AssetRegistrar> asset_registrar = nullptr;
+    DelayedAssetLoader* loader = nullptr;
+};
+
+bool ImportAssetService(mono_service::ServiceRegistry& service_registry, size_t loading_worker_count)
+{
+    // Create service importer
+    std::unique_ptr<mono_service::ServiceImporter> service_importer 
+        = std::make_unique<mono_service::ServiceImporter>(service_registry);
+
+    // Create asset service
+    std::unique_ptr<mono_asset_service::AssetService> asset_service 
+        = std::make_unique<mono_asset_service::AssetService>(0);
+
+    // Create setup parameters
+    mono_asset_service::AssetService::SetupParam setup_param;
+    setup_param.loading_worker_count = loading_worker_count;
+
+    // Import asset service
+    return service_importer->Import(
+        std::move(asset_service), mono_asset_service::AssetServiceHandle::ID(), setup_param);
+}
+
+// The latencies measured by LoadWithAssetService
+struct LoadLatency
+{
+    double first_asset_ms = 0.0; // Time until the first asset is visible
+    double fast_assets_ms = 0.0; // Time until every fast asset is visible
+    double total_ms = 0.0; // Time until every asset is visible
+    std::vector<int> finish_order; // The source values in the order their loads finished
+};
+
+// Load one slow asset followed by fast assets with the asset service and measure the latencies
+LoadLatency LoadWithAssetService(
+    size_t loading_worker_count, size_t fast_asset_count, 
+    std::chrono::milliseconds fast_latency, std::chrono::milliseconds slow_latency)
+{
+    LoadLatency latency;
+
+    // Create service registry and import asset service
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator 
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry 
+        = std::make_unique<mono_service::ServiceRegistry>();
+    bool result = ImportAssetService(*service_registry, loading_worker_count);
+    EXPECT_TRUE(result);
+
+    // Get asset service proxy from asset service
+    std::unique_ptr<mono_service::ServiceProxy> asset_service_proxy = nullptr;
+    service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        asset_service_proxy = registry.Get(mono_asset_service::AssetServiceHandle::ID()).CreateServiceProxy();
+    });
+
+    // Create handle ids, the first one is the slow asset
+    std::vector<asset_loader::AssetHandleID> handle_ids;
+    for (size_t i = 0; i < fast_asset_count + 1; ++i)
+        handle_ids.push_back(asset_loader::AssetHandleIDGenerator::GetInstance().Generate());
+
+    DelayedAssetLoader* loader = nullptr;
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        // Create asset service command list
+        std::unique_ptr<mono_service::ServiceCommandList> command_list = asset_service_proxy->CreateCommandList();
+        mono_asset_service::AssetServiceCommandList& asset_command_list
+            = dynamic_cast<mono_asset_service::AssetServiceCommandList&>(*command_list);
+
+        // Register the delayed asset loader
+        std::unique_ptr<DelayedAssetLoader> delayed_loader = std::make_unique<DelayedAssetLoader>();
+        loader = delayed_loader.get();
+        asset_command_list.RegisterLoader(DelayedAssetLoader::ID(), std::move(delayed_loader));
+
+        // Load the slow asset first, then the fast assets
+        for (size_t i = 0; i < handle_ids.size(); ++i)
+        {
+            asset_command_list.LoadAsset(CreateDelayedAssetSource(
+                handle_ids[i], static_cast<int>(i), (i == 0) ? slow_latency : fast_latency));
+        }
+
+        // Submit command list to asset service
+        asset_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+
+    // Update the service until every asset is visible
+    size_t loaded_count = 0;
+    bool fast_assets_loaded = false;
+    while (loaded_count < handle_ids.size())
+    {
+        service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+        {
+            mono_service::Service& service = registry.Get(mono_asset_service::AssetServiceHandle::ID());
+            EXPECT_TRUE(service.PreUpdate());
+            EXPECT_TRUE(service.Update());
+            EXPECT_TRUE(service.PostUpdate());
+        });
+
+        // Create asset service view
+        std::unique_ptr<mono_service::ServiceView> service_view = asset_service_proxy->CreateView();
+        mono_asset_service::AssetServiceView& asset_view
+            = dynamic_cast<mono_asset_service::AssetServiceView&>(*service_view);
+
+        // Count visible assets
+        loaded_count = 0;
+        size_t fast_loaded_count = 0;
+        for (size_t i = 0; i < handle_ids.size(); ++i)
+        {
+            if (!asset_view.IsAssetLoaded(handle_ids[i]))
+                continue;
+
+            loaded_count++;
+            if (i != 0)
+                fast_loaded_count++;
+        }
+
+        double elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+
+        if (loaded_count != 0 && latency.first_asset_ms == 0.0)
+            latency.first_asset_ms = elapsed_ms;
+
+        if (!fast_assets_loaded && fast_loaded_count == fast_asset_count)
+        {
+            latency.fast_assets_ms = elapsed_ms;
+            fast_assets_loaded = true;
+        }
+
+        latency.total_ms = elapsed_ms;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The loader is owned by the asset service, so take the order before clearing it
+    latency.finish_order = loader->GetFinishOrder();
+
+    // Clear service registry
+    service_registry.reset();
+
+    return latency;
+}
+
+} // namespace mono_asset_service_test
+
+TEST(AssetLoadingPool, LoadConcurrently)
+{
+    mono_asset_service_test::LoadingPoolTestContext context;
+    mono_asset_service::AssetLoadingPool pool(4, *context.loader_manager, *context.asset_registrar);
+    ASSERT_EQ(pool.GetWorkerCount(), 4u);
+
+    // Push assets
+    constexpr int ASSET_COUNT = 8;
+    std::vector<asset_loader::AssetHandleID> handle_ids;
+    for (int i = 0; i < ASSET_COUNT; ++i)
+    {
+        handle_ids.push_back(context.handle_id_generator.Generate());
+        pool.Push(
+            mono_asset_service_test::CreateDelayedAssetSource(handle_ids.back(), i, std::chrono::milliseconds(20)),
+            mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+    }
+
+    pool.WaitForAll();
+    EXPECT_EQ(pool.GetPendingCount(), 0u);
+
+    // Every asset is committed and registered
+    EXPECT_EQ(context.loader->GetCommitCount(), ASSET_COUNT);
+    for (const asset_loader::AssetHandleID& handle_id : handle_ids)
+        EXPECT_TRUE(context.IsRegistered(handle_id));
+
+    // Loads ran at the same time
+    EXPECT_GT(context.loader->GetMaxRunningCount(), 1);
+    EXPECT_LE(context.loader->GetMaxRunningCount(), 4);
+
+    // The sources are returned as finished
+    std::vector<mono_asset_service::FinishedAssetLoad> finished_loads;
+    pool.TakeFinished(finished_loads);
+    ASSERT_EQ(finished_loads.size(), static_cast<size_t>(ASSET_COUNT));
+    for (const mono_asset_service::FinishedAssetLoad& finished_load : finished_loads)
+    {
+        EXPECT_EQ(finished_load.result, mono_asset_service::AssetLoadResult::Loaded);
+        EXPECT_NE(finished_load.source, nullptr);
+    }
+}
+
+TEST(AssetLoadingPool, Priority)
+{
+    mono_asset_service_test::LoadingPoolTestContext context;
+    mono_asset_service::AssetLoadingPool pool(1, *context.loader_manager, *context.asset_registrar);
+
+    // Keep the only worker busy, so that the following loads are queued
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(
+            context.handle_id_generator.Generate(), 0, std::chrono::milliseconds(50)),
+        mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+
+    while (context.loader->GetLoadOrder().empty())
+        std::this_thread::yield();
+
+    // Push loads with different priorities
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(
+            context.handle_id_generator.Generate(), 1, std::chrono::milliseconds(0)), -1);
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(
+            context.handle_id_generator.Generate(), 2, std::chrono::milliseconds(0)), 10);
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(
+            context.handle_id_generator.Generate(), 3, std::chrono::milliseconds(0)), 5);
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(
+            context.handle_id_generator.Generate(), 4, std::chrono::milliseconds(0)), 10);
+
+    pool.WaitForAll();
+
+    // Higher priority first, same priority in push order
+    std::vector<int> expected_order = { 0, 2, 4, 3, 1 };
+    EXPECT_EQ(context.loader->GetLoadOrder(), expected_order);
+}
+
+TEST(AssetLoadingPool, Cancel)
+{
+    mono_asset_service_test::LoadingPoolTestContext context;
+    mono_asset_service::AssetLoadingPool pool(1, *context.loader_manager, *context.asset_registrar);
+
+    // Keep the only worker busy
+    asset_loader::AssetHandleID running_id = context.handle_id_generator.Generate();
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(running_id, 0, std::chrono::milliseconds(50)),
+        mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+
+    while (context.loader->GetLoadOrder().empty())
+        std::this_thread::yield();
+
+    // Queue a load
+    asset_loader::AssetHandleID queued_id = context.handle_id_generator.Generate();
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(queued_id, 1, std::chrono::milliseconds(0)),
+        mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+    EXPECT_EQ(pool.GetPendingCount(), 2u);
+
+    // Cancel the queued load and the running load
+    EXPECT_TRUE(pool.Cancel(queued_id));
+    EXPECT_TRUE(pool.Cancel(running_id));
+    EXPECT_FALSE(pool.Cancel(running_id)); // Already cancelled
+    EXPECT_FALSE(pool.Cancel(context.handle_id_generator.Generate())); // Unknown
+
+    pool.WaitForAll();
+
+    // The queued load never started and the running load is not registered
+    EXPECT_EQ(context.loader->GetLoadOrder().size(), 1u);
+    EXPECT_FALSE(context.IsRegistered(running_id));
+    EXPECT_FALSE(context.IsRegistered(queued_id));
+
+    std::vector<mono_asset_service::FinishedAssetLoad> finished_loads;
+    pool.TakeFinished(finished_loads);
+    EXPECT_TRUE(finished_loads.empty());
+}
+
+TEST(AssetLoadingPool, Failure)
+{
+    mono_asset_service_test::LoadingPoolTestContext context;
+    mono_asset_service::AssetLoadingPool pool(2, *context.loader_manager, *context.asset_registrar);
+
+    asset_loader::AssetHandleID failed_id = context.handle_id_generator.Generate();
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(failed_id, 0, std::chrono::milliseconds(0), true),
+        mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+
+    asset_loader::AssetHandleID loaded_id = context.handle_id_generator.Generate();
+    pool.Push(
+        mono_asset_service_test::CreateDelayedAssetSource(loaded_id, 1, std::chrono::milliseconds(0)),
+        mono_asset_service::DEFAULT_ASSET_LOAD_PRIORITY);
+
+    pool.WaitForAll();
+    EXPECT_FALSE(context.IsRegistered(failed_id));
+    EXPECT_TRUE(context.IsRegistered(loaded_id));
+
+    std::vector<mono_asset_service::FinishedAssetLoad> finished_loads;
+    pool.TakeFinished(finished_loads);
+    ASSERT_EQ(finished_loads.size(), 2u);
+    for (const mono_asset_service::FinishedAssetLoad& finished_load : finished_loads)
+    {
+        const bool is_failed = finished_load.source->description->GetHandleID() == failed_id;
+        EXPECT_EQ(
+            finished_load.result, 
+            is_failed ? mono_asset_service::AssetLoadResult::Failed : mono_asset_service::AssetLoadResult::Loaded);
+    }
+}
+
+TEST(AssetLoadingPool, Benchmark)
+{
+    constexpr size_t FAST_ASSET_COUNT = 16;
+    constexpr std::chrono::milliseconds FAST_LATENCY(10);
+    constexpr std::chrono::milliseconds SLOW_LATENCY(200);
+
+    // One worker loads the assets one by one, like the previous single loading task
+    mono_asset_service_test::LoadLatency serial_latency 
+        = mono_asset_service_test::LoadWithAssetService(1, FAST_ASSET_COUNT, FAST_LATENCY, SLOW_LATENCY);
+
+    // Four workers load the fast assets while the slow asset is loading
+    mono_asset_service_test::LoadLatency parallel_latency 
+        = mono_asset_service_test::LoadWithAssetService(4, FAST_ASSET_COUNT, FAST_LATENCY, SLOW_LATENCY);
+
+    // One worker finishes the slow asset first, as it was pushed first
+    ASSERT_EQ(serial_latency.finish_order.size(), FAST_ASSET_COUNT + 1);
+    EXPECT_EQ(serial_latency.finish_order.front(), 0);
+
+    // The fast assets do not wait for the slow asset
+    ASSERT_EQ(parallel_latency.finish_order.size(), FAST_ASSET_COUNT + 1);
+    EXPECT_EQ(parallel_latency.finish_order.back(), 0);
+
+    std::cout << "Asset loading (1 asset of " << SLOW_LATENCY.count() << " ms, " 
+        << FAST_ASSET_COUNT << " assets of " << FAST_LATENCY.count() << " ms):" << std::endl;
+    std::cout << "  1 worker:  first " << serial_latency.first_asset_ms << " ms, fast assets " 
+        << serial_latency.fast_assets_ms << " ms, total " << serial_latency.total_ms << " ms" << std::endl;
+    std::cout << "  4 workers: first " << parallel_latency.first_asset_ms << " ms, fast assets " 
+        << parallel_latency.fast_assets_ms << " ms, total " << parallel_latency.total_ms << " ms" << std::endl;
+}
\ No newline at end of file
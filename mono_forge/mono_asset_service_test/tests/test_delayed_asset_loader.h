@@ -0,0 +1,155 @@
+﻿#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "asset_loader/include/asset_loader.h"
+#include "mono_asset_service_test/tests/test_asset.h"
+
+namespace mono_asset_service_test
+{
+
+// The source data for the delayed asset loader
+class DelayedAssetSourceData :
+    public asset_loader::AssetSourceData
+{
+public:
+    DelayedAssetSourceData() = default;
+    virtual ~DelayedAssetSourceData() override = default;
+
+    int source_value = 0; // The value stored in the loaded asset
+    std::chrono::milliseconds latency = std::chrono::milliseconds(0); // The time Load takes
+    bool fail = false; // Whether Load fails
+};
+
+// The staging area for the delayed asset loader
+class DelayedAssetStagingArea :
+    public asset_loader::LoadingStagingArea
+{
+public:
+    DelayedAssetStagingArea() = default;
+    virtual ~DelayedAssetStagingArea() override = default;
+
+    int temp_value = 0;
+};
+
+// A fake local asset loader that sleeps for the latency of each source
+// It records the order of the loads and the number of loads running at the same time
+class DelayedAssetLoader : 
+    public asset_loader::AssetLoaderBase<DelayedAssetLoader>
+{
+public:
+    DelayedAssetLoader() = default;
+    virtual ~DelayedAssetLoader() override = default;
+
+    virtual std::unique_ptr<asset_loader::LoadingStagingArea> Prepare() const override
+    {
+        return std::make_unique<DelayedAssetStagingArea>();
+    }
+
+    virtual std::unique_ptr<asset_loader::Asset> Load(
+        asset_loader::AssetSourceData& source_data, asset_loader::LoadingStagingArea& staging_area) const override
+    {
+        DelayedAssetSourceData* delayed_source_data = dynamic_cast<DelayedAssetSourceData*>(&source_data);
+        if (!delayed_source_data)
+            return nullptr; // Invalid source data type
+
+        DelayedAssetStagingArea* delayed_staging_area = dynamic_cast<DelayedAssetStagingArea*>(&staging_area);
+        if (!delayed_staging_area)
+            return nullptr; // Invalid staging area type
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            load_order_.push_back(delayed_source_data->source_value);
+            running_count_++;
+            max_running_count_ = std::max(max_running_count_, running_count_);
+        }
+
+        // Simulate the latency of reading and decoding the source
+        std::this_thread::sleep_for(delayed_source_data->latency);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            finish_order_.push_back(delayed_source_data->source_value);
+            running_count_--;
+        }
+
+        if (delayed_source_data->fail)
+            return nullptr; // Simulated failure
+
+        std::unique_ptr<asset_loader_test::TestAsset> asset = std::make_unique<asset_loader_test::TestAsset>();
+        asset->value = delayed_source_data->source_value;
+        delayed_staging_area->temp_value = asset->value;
+
+        return asset;
+    }
+
+    virtual bool Commit(asset_loader::LoadingStagingArea& staging_area) const override
+    {
+        DelayedAssetStagingArea* delayed_staging_area = dynamic_cast<DelayedAssetStagingArea*>(&staging_area);
+        if (!delayed_staging_area)
+            return false; // Invalid staging area type
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        commit_count_++;
+        return true;
+    }
+
+    // Get the source values in the order their loads started
+    std::vector<int> GetLoadOrder() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return load_order_;
+    }
+
+    // Get the source values in the order their loads finished
+    std::vector<int> GetFinishOrder() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return finish_order_;
+    }
+
+    // Get the maximum number of loads that ran at the same time
+    int GetMaxRunningCount() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return max_running_count_;
+    }
+
+    // Get the number of commits
+    int GetCommitCount() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return commit_count_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::vector<int> load_order_;
+    mutable std::vector<int> finish_order_;
+    mutable int running_count_ = 0;
+    mutable int max_running_count_ = 0;
+    mutable int commit_count_ = 0;
+};
+
+// Create an asset source for the delayed asset loader
+inline std::unique_ptr<asset_loader::AssetSource> CreateDelayedAssetSource(
+    asset_loader::AssetHandleID handle_id, int value, std::chrono::milliseconds latency, bool fail = false)
+{
+    std::unique_ptr<DelayedAssetSourceData> source_data = std::make_unique<DelayedAssetSourceData>();
+    source_data->SetName("delayed_asset_" + std::to_string(value));
+    source_data->source_value = value;
+    source_data->latency = latency;
+    source_data->fail = fail;
+
+    std::unique_ptr<asset_loader::AssetSource> asset_source = std::make_unique<asset_loader::AssetSource>();
+    asset_source->source_data = std::move(source_data);
+    asset_source->description = std::make_unique<asset_loader::AssetDescription>(
+        handle_id, DelayedAssetLoader::ID());
+
+    return asset_source;
+}
+
+} // namespace mono_asset_service_test
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "mono_entity_archive_extension/include/dll_config.h"
 
+#include <istream>
+
 #include "ecs/include/world.h"
 #include "component_editor/include/json.hpp"
 #include "mono_service/include/service_proxy_manager.h"
@@ -9,9 +11,26 @@
 namespace mono_entity_archive_extension
 {
 
+// The import functions below destroy the entities they have created if they fail,
+// so the world is left as it was and out_created_entities is only set on success
+
 // Create entities from exported JSON data
 MONO_ENTITY_ARCHIVE_EXT_DLL bool CreateEntitiesFromExportedJSON(
     ecs::World& world, const nlohmann::json& json, mono_service::ServiceProxyManager& service_proxy_manager,
     std::vector<ecs::Entity>* out_created_entities = nullptr);
 
+// Create entities from exported JSON data read from the stream
+// Each entity is created as soon as its object has been parsed, so the whole archive is never held in memory
+// The entities are the same as the ones CreateEntitiesFromExportedJSON creates from the parsed archive
+// An archive with more than one entities array is rejected, while the DOM parser would keep the last one
+MONO_ENTITY_ARCHIVE_EXT_DLL bool CreateEntitiesFromExportedJSONStream(
+    ecs::World& world, std::istream& stream, mono_service::ServiceProxyManager& service_proxy_manager,
+    std::vector<ecs::Entity>* out_created_entities = nullptr);
+
+// Create entities from an exported binary snapshot
+// Entities are read from the stream one at a time, so the whole archive is never held in memory
+MONO_ENTITY_ARCHIVE_EXT_DLL bool CreateEntitiesFromSnapshot(
+    ecs::World& world, std::istream& stream, mono_service::ServiceProxyManager& service_proxy_manager,
+    std::vector<ecs::Entity>* out_created_entities = nullptr);
+
 } // namespace mono_entity_archive_extension
\ No newline at end of file
@@ -19,6 +19,10 @@ constexpr const wchar_t* PROJECT_ASSET_ARCHIVE_JSON_FILE_PATH = L"/asset/asset_a
 // The default file path for material archive JSON within a project from the project root
 constexpr const wchar_t* PROJECT_MATERIAL_ARCHIVE_JSON_FILE_PATH = L"/material/material_archive.json";
 
+// The default file path for entity archive snapshot within a project from the project root
+// It is loaded instead of the JSON if it is at least as new as the JSON and not broken
+constexpr const wchar_t* PROJECT_ENTITY_ARCHIVE_SNAPSHOT_FILE_PATH = L"/scene/entity_archive.mfes";
+
 // The handle class for the system
 class MONO_ENTITY_ARCHIVE_EXT_DLL ProjectIOSystemHandle :
     public ecs::SystemHandle<ProjectIOSystemHandle> {};
@@ -1,6 +1,8 @@
 #include "mono_entity_archive_extension/src/pch.h"
 #include "mono_entity_archive_extension/include/project_io_system.h"
 
+#include <filesystem>
+
 #include "utility_header/win32.h"
 #include "utility_header/logger.h"
 
@@ -19,6 +21,28 @@
 namespace mono_entity_archive_extension
 {
 
+namespace
+{
+
+// Check if the snapshot exists and was written at or after the JSON
+// A JSON edited after the export makes the snapshot stale
+bool IsSnapshotUpToDate(const std::filesystem::path& snapshot_file_path, const std::filesystem::path& json_file_path)
+{
+    std::error_code error_code;
+    std::filesystem::file_time_type snapshot_write_time
+        = std::filesystem::last_write_time(snapshot_file_path, error_code);
+    if (error_code)
+        return false; // No snapshot
+
+    std::filesystem::file_time_type json_write_time = std::filesystem::last_write_time(json_file_path, error_code);
+    if (error_code)
+        return true; // Only the snapshot exists
+
+    return snapshot_write_time >= json_write_time;
+}
+
+} // namespace
+
 ProjectIOSystem::ProjectIOSystem(
     std::unique_ptr<mono_service::ServiceProxy> entity_archive_service_proxy,
     std::unique_ptr<mono_service::ServiceProxy> asset_service_proxy,
@@ -92,27 +116,49 @@ bool ProjectIOSystem::Update(ecs::World& world)
         // Get relative file path
         std::wstring rel_file_path = utility_header::GetRelativePath(abs_file_path, working_dir);
 
-        // Open project entity archive file
-        std::ifstream input_file(
-            rel_file_path + std::wstring(PROJECT_ENTITY_ARCHIVE_JSON_FILE_PATH));
-        if (!input_file.is_open())
+        std::wstring snapshot_file_path = rel_file_path + std::wstring(PROJECT_ENTITY_ARCHIVE_SNAPSHOT_FILE_PATH);
+        std::wstring json_file_path = rel_file_path + std::wstring(PROJECT_ENTITY_ARCHIVE_JSON_FILE_PATH);
+
+        // Load the project entity archive snapshot, which loads faster than JSON
+        bool is_snapshot_loaded = false;
+        if (IsSnapshotUpToDate(snapshot_file_path, json_file_path))
         {
-            utility_header::ConsoleLog({
-                "Failed to open project entity archive file"},
-                __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failed to open file
+            std::ifstream snapshot_file(snapshot_file_path, std::ios::binary);
+
+            // Create entities from exported snapshot
+            // Entities are rolled back if the snapshot is broken, so the JSON can be loaded instead
+            if (snapshot_file.is_open() && CreateEntitiesFromSnapshot(world, snapshot_file, service_proxy_manager_))
+            {
+                is_snapshot_loaded = true;
+            }
+            else
+            {
+                utility_header::ConsoleLogWrn({
+                    "Failed to load project entity archive snapshot, loading the JSON instead"},
+                    __FILE__, __LINE__, __FUNCTION__);
+            }
         }
 
-        nlohmann::json archive_json;
-        input_file >> archive_json;
-
-        // Create entities from exported JSON
-        if (!CreateEntitiesFromExportedJSON(world, archive_json, service_proxy_manager_))
+        if (!is_snapshot_loaded)
         {
-            utility_header::ConsoleLog({
-                "Failed to create entities from project entity archive file"},
-                __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failed to create entities
+            // Open project entity archive file
+            std::ifstream input_file(json_file_path);
+            if (!input_file.is_open())
+            {
+                utility_header::ConsoleLog({
+                    "Failed to open project entity archive file"},
+                    __FILE__, __LINE__, __FUNCTION__);
+                return false; // Failed to open file
+            }
+
+            // Create entities from exported JSON while parsing it
+            if (!CreateEntitiesFromExportedJSONStream(world, input_file, service_proxy_manager_))
+            {
+                utility_header::ConsoleLog({
+                    "Failed to create entities from project entity archive file"},
+                    __FILE__, __LINE__, __FUNCTION__);
+                return false; // Failed to create entities
+            }
         }
     }
 
@@ -152,6 +198,7 @@ bool ProjectIOSystem::Update(ecs::World& world)
         std::wstring entity_export_file_path = working_dir + std::wstring(PROJECT_ENTITY_ARCHIVE_JSON_FILE_PATH);
         std::wstring asset_export_file_path = working_dir + std::wstring(PROJECT_ASSET_ARCHIVE_JSON_FILE_PATH);
         std::wstring material_export_file_path = working_dir + std::wstring(PROJECT_MATERIAL_ARCHIVE_JSON_FILE_PATH);
+        std::wstring entity_snapshot_file_path = working_dir + std::wstring(PROJECT_ENTITY_ARCHIVE_SNAPSHOT_FILE_PATH);
 
         // Prepare entity list for export
         std::vector<ecs::Entity> entities_to_export;
@@ -163,6 +210,8 @@ bool ProjectIOSystem::Update(ecs::World& world)
         // Export setup params to the project entity archive
         entity_archive_command_list_ptr->ExportComponentSetupParamsToFile(
             entity_export_file_path, entities_to_export, service_proxy_manager_);
+        entity_archive_command_list_ptr->ExportComponentSetupParamsToSnapshot(
+            entity_snapshot_file_path, entities_to_export, service_proxy_manager_);
 
         // Get all loaded asset IDs from asset service view
         std::vector<asset_loader::AssetHandleID> loaded_asset_ids = asset_service_view_ptr->GetLoadedAssetIDs();
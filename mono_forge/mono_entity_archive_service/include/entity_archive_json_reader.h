@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+
+#include "component_editor/include/json.hpp"
+
+#include "mono_entity_archive_service/include/dll_config.h"
+
+namespace mono_entity_archive_service
+{
+
+// The function receiving each record of a JSON archive
+// The record may be moved from, return false to stop reading
+using JSONArchiveRecordFunc = std::function<bool(nlohmann::json& record)>;
+
+// Read the records of an exported JSON archive from the stream
+// The archive is parsed with SAX events, and each element of the array under the tag is passed to the function
+// as soon as it has been parsed, so only one record is held in memory instead of the whole DOM
+// The records are equal to the elements the DOM parser produces, values under other tags are skipped
+// Returns false if the JSON is broken, the tag holds no array or appears more than once, or the function stops reading
+// The records passed before the failure are not taken back, so the caller has to discard what it made of them
+MONO_ENTITY_ARCHIVE_SERVICE_DLL bool ReadJSONArchiveRecords(
+    std::istream& stream, const char* tag, const JSONArchiveRecordFunc& record_func,
+    uint64_t* out_record_count = nullptr);
+
+} // namespace mono_entity_archive_service
\ No newline at end of file
@@ -67,6 +67,16 @@ public:
     void ExportMaterialSetupParamsToFile(
         const std::wstring& file_path, std::vector<render_graph::MaterialHandle> material_handles,
         mono_service::ServiceProxyManager& service_proxy_manager);
+
+    // Export setup params of entities to a binary snapshot file
+    void ExportComponentSetupParamsToSnapshot(
+        const std::string& file_path, std::vector<ecs::Entity> entities, 
+        mono_service::ServiceProxyManager& service_proxy_manager);
+
+    // Export setup params of entities to a binary snapshot file
+    void ExportComponentSetupParamsToSnapshot(
+        const std::wstring& file_path, std::vector<ecs::Entity> entities, 
+        mono_service::ServiceProxyManager& service_proxy_manager);
 };
 
 } // namespace mono_entity_archive_service
\ No newline at end of file
@@ -0,0 +1,273 @@
+﻿#include "mono_entity_archive_service/src/pch.h"
+#include "mono_entity_archive_service/include/entity_archive_json_reader.h"
+
+#include <string>
+#include <vector>
+
+#include "utility_header/logger.h"
+
+namespace mono_entity_archive_service
+{
+
+namespace
+{
+
+// The SAX handler building the records under the tag one at a time
+// The values are built the same way nlohmann's DOM parser builds them
+class RecordSaxHandler :
+    public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    RecordSaxHandler(const char* tag, const JSONArchiveRecordFunc& record_func) :
+        tag_(tag),
+        record_func_(record_func)
+    {
+    }
+
+    ~RecordSaxHandler() override = default;
+
+    bool null() override { return HandleValue(nullptr); }
+    bool boolean(bool val) override { return HandleValue(val); }
+    bool number_integer(number_integer_t val) override { return HandleValue(val); }
+    bool number_unsigned(number_unsigned_t val) override { return HandleValue(val); }
+    bool number_float(number_float_t val, const string_t&) override { return HandleValue(val); }
+    bool string(string_t& val) override { return HandleValue(std::move(val)); }
+    bool binary(binary_t& val) override { return HandleValue(std::move(val)); }
+
+    bool start_object(std::size_t) override
+    {
+        if (!IsInRecord())
+        {
+            if (depth_ == 0)
+                is_root_object_ = true;
+
+            // The tag holds an object instead of an array
+            if (depth_ == 1)
+                is_tag_value_next_ = false;
+
+            depth_++;
+            return true; // Not a part of a record
+        }
+
+        depth_++;
+        return BeginContainer(nlohmann::json::value_t::object);
+    }
+
+    bool key(string_t& val) override
+    {
+        if (!IsInRecord())
+        {
+            // The key of the root object tells if the next value is the records array
+            if (depth_ == 1)
+            {
+                is_tag_value_next_ = (val == tag_);
+                if (is_tag_value_next_)
+                {
+                    // The DOM parser keeps the last value of a duplicate key, but the records under the earlier one
+                    // have already been passed, so the archive is rejected instead
+                    if (has_tag_)
+                    {
+                        utility_header::ConsoleLogErr(
+                            {"JSON archive has more than one ", tag_}, __FILE__, __LINE__, __FUNCTION__);
+                        return false; // Stop parsing
+                    }
+
+                    has_tag_ = true;
+                }
+            }
+
+            return true;
+        }
+
+        // The same as the DOM parser, a duplicate key overwrites the earlier value
+        object_element_ = &(*container_stack_.back())[val];
+        return true;
+    }
+
+    bool end_object() override
+    {
+        depth_--;
+        if (container_stack_.empty())
+            return true; // Not a part of a record
+
+        return EndContainer();
+    }
+
+    bool start_array(std::size_t) override
+    {
+        if (!IsInRecord())
+        {
+            if (depth_ == 1 && is_tag_value_next_)
+            {
+                // The records array begins
+                is_tag_value_next_ = false;
+                is_in_records_ = true;
+                has_records_ = true;
+            }
+
+            depth_++;
+            return true;
+        }
+
+        depth_++;
+        return BeginContainer(nlohmann::json::value_t::array);
+    }
+
+    bool end_array() override
+    {
+        depth_--;
+        if (container_stack_.empty())
+        {
+            // The records array ends
+            if (is_in_records_ && depth_ == 1)
+                is_in_records_ = false;
+
+            return true;
+        }
+
+        return EndContainer();
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to parse JSON archive: ", ex.what()}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Stop parsing
+    }
+
+    // Check if the archive was a root object holding an array under the tag
+    bool IsValidArchive() const { return is_root_object_ && has_records_; }
+
+    // Get the number of records passed to the function
+    uint64_t GetRecordCount() const { return record_count_; }
+
+private:
+    // Check if the next value belongs to a record, or begins one
+    bool IsInRecord() const
+    {
+        return !container_stack_.empty() || (is_in_records_ && depth_ == 2);
+    }
+
+    // Add a value to the record being built, or pass it as a record if it is not in a container
+    template <typename Value>
+    bool HandleValue(Value&& value)
+    {
+        if (!container_stack_.empty())
+        {
+            AddValue(nlohmann::json(std::forward<Value>(value)));
+            return true;
+        }
+
+        if (depth_ == 1 && is_tag_value_next_)
+        {
+            // The tag holds something other than an array
+            is_tag_value_next_ = false;
+            return true;
+        }
+
+        if (!is_in_records_ || depth_ != 2)
+            return true; // Not a part of a record
+
+        // A scalar record
+        record_ = nlohmann::json(std::forward<Value>(value));
+        return PassRecord();
+    }
+
+    // Add a value to the innermost container and get the added value
+    nlohmann::json* AddValue(nlohmann::json&& value)
+    {
+        nlohmann::json& container = *container_stack_.back();
+        if (container.is_array())
+        {
+            container.get_ref<nlohmann::json::array_t&>().emplace_back(std::move(value));
+            return &container.get_ref<nlohmann::json::array_t&>().back();
+        }
+
+        *object_element_ = std::move(value);
+        return object_element_;
+    }
+
+    // Begin an object or array in the record
+    bool BeginContainer(nlohmann::json::value_t type)
+    {
+        if (container_stack_.empty())
+        {
+            // The record itself
+            record_ = nlohmann::json(type);
+            container_stack_.push_back(&record_);
+        }
+        else
+        {
+            container_stack_.push_back(AddValue(nlohmann::json(type)));
+        }
+
+        return true;
+    }
+
+    // End the innermost container, and pass the record when it ends
+    bool EndContainer()
+    {
+        container_stack_.pop_back();
+        if (!container_stack_.empty())
+            return true; // The record continues
+
+        return PassRecord();
+    }
+
+    // Pass the built record to the function and release it
+    bool PassRecord()
+    {
+        record_count_++;
+        bool result = record_func_(record_);
+        record_ = nullptr;
+        return result;
+    }
+
+    const std::string tag_;
+    const JSONArchiveRecordFunc& record_func_;
+
+    // The nesting depth of the containers including the ones outside of records
+    size_t depth_ = 0;
+
+    // The state of the archive structure
+    bool is_root_object_ = false;
+    bool is_tag_value_next_ = false;
+    bool has_tag_ = false;
+    bool is_in_records_ = false;
+    bool has_records_ = false;
+
+    // The record being built, and its open containers
+    nlohmann::json record_;
+    std::vector<nlohmann::json*> container_stack_;
+
+    // The value of the last key in the innermost object
+    nlohmann::json* object_element_ = nullptr;
+
+    uint64_t record_count_ = 0;
+};
+
+} // namespace
+
+bool ReadJSONArchiveRecords(
+    std::istream& stream, const char* tag, const JSONArchiveRecordFunc& record_func, uint64_t* out_record_count)
+{
+    RecordSaxHandler handler(tag, record_func);
+    bool result = nlohmann::json::sax_parse(stream, &handler);
+
+    if (out_record_count != nullptr)
+        *out_record_count = handler.GetRecordCount();
+
+    if (!result)
+        return false; // Broken JSON or stopped by the function
+
+    if (!handler.IsValidArchive())
+    {
+        utility_header::ConsoleLogErr(
+            {"JSON archive has no array of ", tag}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    return true; // Success
+}
+
+} // namespace mono_entity_archive_service
\ No newline at end of file
@@ -1,13 +1,199 @@
 ﻿#include "mono_entity_archive_service/src/pch.h"
 #include "mono_entity_archive_service/include/entity_archive_service_command_list.h"
 
+#include <filesystem>
+
 #include "utility_header/logger.h"
 
 #include "mono_entity_archive_service/include/export_config.h"
+#include "mono_entity_archive_service/include/entity_archive_snapshot.h"
 
 namespace mono_entity_archive_service
 {
 
+namespace
+{
+
+// Export setup params of an entity to JSON with the field type registry
+nlohmann::json ExportEntityToJSON(
+    EntityArchiveServiceAPI& entity_archive_service_api, ecs::Entity entity,
+    mono_service::ServiceProxyManager& service_proxy_manager)
+{
+    // Create JSON object for the entity
+    nlohmann::json entity_json;
+
+    // Get all component IDs which entity has
+    std::vector<ecs::ComponentID> component_ids 
+        = entity_archive_service_api.GetSetupParamManager().GetComponentIDs(entity);
+
+    for (ecs::ComponentID component_id : component_ids)
+    {
+        // Create JSON object for the component
+        nlohmann::json component_json;
+
+        // Get component name
+        std::string_view component_name = entity_archive_service_api.GetComponentNameMap().at(component_id);
+
+        // Get component field map
+        const component_editor::FieldMap& field_map 
+            = entity_archive_service_api.GetComponentFieldMap(component_id);
+
+        for (const auto& [field_name, field_info] : field_map)
+        {
+            // Get setup param field value
+            const uint8_t* field_value 
+                = entity_archive_service_api.GetSetupParamField(entity, component_id, field_name);
+
+            // Get field create function
+            const ComponentSetupParamAnyFieldCreateFunc& field_type_create_func 
+                = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldCreateFunc(
+                    field_info.type_name);
+            assert(field_type_create_func && "Field type create function not found");
+
+            // Create std::any value from field value
+            std::any value = field_type_create_func(field_value, service_proxy_manager);
+
+            // Get field export function
+            const ComponentSetupParamAnyFieldExportFunc& field_type_export_func 
+                = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldExportFunc(
+                    field_info.type_name);
+
+            // Export field value to JSON
+            component_json[field_name.data()] = field_type_export_func(value, field_name, service_proxy_manager);
+        }
+
+        // Add component name to entity JSON
+        entity_json[component_name.data()] = std::move(component_json);
+    }
+
+    return entity_json;
+}
+
+// Export setup param of a material to JSON with the material setup param editor registry
+nlohmann::json ExportMaterialToJSON(
+    EntityArchiveServiceAPI& entity_archive_service_api, render_graph::MaterialHandle& material_handle,
+    mono_service::ServiceProxyManager& service_proxy_manager)
+{
+    // Get setup param
+    const material_editor::SetupParamWrapper* setup_param
+        = entity_archive_service_api.GetMaterialSetupParamManager().GetSetupParam(&material_handle);
+
+    // Get material setup param editor registry
+    const MaterialSetupParamEditorRegistry& material_setup_param_editor_registry
+        = entity_archive_service_api.GetMaterialSetupParamEditorRegistry();
+
+    // Get export function for the material type
+    const MaterialSetupParamExportFunc& export_func
+        = material_setup_param_editor_registry.GetSetupParamExporter(
+            setup_param->GetSetupParam()->GetMaterialTypeHandleID());
+
+    // Export setup param to JSON
+    return export_func(setup_param, service_proxy_manager);
+}
+
+// Get the path of the file which is written before it replaces the destination file
+std::filesystem::path GetTemporaryFilePath(const std::filesystem::path& file_path)
+{
+    std::filesystem::path temporary_file_path = file_path;
+    temporary_file_path += ".tmp";
+    return temporary_file_path;
+}
+
+// Replace the destination file with the written temporary file
+// The destination is only replaced once the whole file has been written, so a failed export keeps the previous file
+bool ReplaceWithTemporaryFile(const std::filesystem::path& file_path)
+{
+    std::filesystem::path temporary_file_path = GetTemporaryFilePath(file_path);
+
+    std::error_code error_code;
+    std::filesystem::rename(temporary_file_path, file_path, error_code);
+    if (error_code)
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to replace file: ", file_path.u8string(), ", ", error_code.message()},
+            __FILE__, __LINE__, __FUNCTION__);
+        std::filesystem::remove(temporary_file_path, error_code);
+        return false; // Failure
+    }
+
+    return true; // Success
+}
+
+// Remove the temporary file of an export which failed
+void RemoveTemporaryFile(const std::filesystem::path& file_path)
+{
+    std::error_code error_code;
+    std::filesystem::remove(GetTemporaryFilePath(file_path), error_code);
+}
+
+// Write JSON data to a file
+bool WriteJSONFile(const std::filesystem::path& file_path, const nlohmann::json& json_data)
+{
+    std::ofstream output_file(GetTemporaryFilePath(file_path));
+    if (!output_file.is_open())
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to open file for writing: ", file_path.u8string()}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    output_file << json_data.dump(4);
+
+    // Close the file
+    output_file.close();
+    if (!output_file)
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to write JSON data to file: ", file_path.u8string()}, __FILE__, __LINE__, __FUNCTION__);
+        RemoveTemporaryFile(file_path);
+        return false; // Failure
+    }
+
+    return ReplaceWithTemporaryFile(file_path);
+}
+
+// Write a snapshot to a file, record_func exports the record at the index
+template <typename RecordFunc>
+bool WriteSnapshotFile(
+    const std::filesystem::path& file_path, SnapshotContent content, size_t record_count, RecordFunc&& record_func)
+{
+    std::ofstream output_file(GetTemporaryFilePath(file_path), std::ios::binary);
+    if (!output_file.is_open())
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to open file for writing: ", file_path.u8string()}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    // Records are exported and written one at a time
+    SnapshotWriter writer(output_file, content, record_count);
+    for (size_t i = 0; i < record_count; ++i)
+    {
+        if (!writer.WriteRecord(record_func(i)))
+        {
+            utility_header::ConsoleLogErr(
+                {"Failed to write snapshot record to file: ", file_path.u8string()}, __FILE__, __LINE__, __FUNCTION__);
+            output_file.close();
+            RemoveTemporaryFile(file_path);
+            return false; // Failure
+        }
+    }
+
+    // Close the file
+    output_file.close();
+    if (!output_file)
+    {
+        utility_header::ConsoleLogErr(
+            {"Failed to write snapshot to file: ", file_path.u8string()}, __FILE__, __LINE__, __FUNCTION__);
+        RemoveTemporaryFile(file_path);
+        return false; // Failure
+    }
+
+    return ReplaceWithTemporaryFile(file_path);
+}
+
+} // namespace
+
 void EntityArchiveServiceCommandList::AddSetupParam(
     ecs::Entity entity, ecs::ComponentID component_id, std::unique_ptr<ecs::Component::SetupParam> setup_param)
 {
@@ -159,85 +345,13 @@ void EntityArchiveServiceCommandList::ExportComponentSetupParamsToFile(
 
         for (const ecs::Entity& entity : entities)
         {
-            // Create JSON object for the entity
-            nlohmann::json entity_json;
-
-            // Get all component IDs which entity has
-            std::vector<ecs::ComponentID> component_ids 
-                = entity_archive_service_api.GetSetupParamManager().GetComponentIDs(entity);
-
-            for (ecs::ComponentID component_id : component_ids)
-            {
-                // Create JSON object for the component
-                nlohmann::json component_json;
-
-                // Get component name
-                std::string_view component_name = entity_archive_service_api.GetComponentNameMap().at(component_id);                
-
-                // Get component field map
-                const component_editor::FieldMap& field_map 
-                    = entity_archive_service_api.GetComponentFieldMap(component_id);
-
-                // Get setup param
-                const ecs::Component::SetupParam& setup_param
-                    = entity_archive_service_api.GetSetupParam(entity, component_id);
-
-                for (const auto& [field_name, field_info] : field_map)
-                {
-                    // Get setup param field value
-                    const uint8_t* field_value 
-                        = entity_archive_service_api.GetSetupParamField(entity, component_id, field_name);
-
-                    // Get field create function
-                    auto field_type_create_func 
-                        = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldCreateFunc(
-                            field_info.type_name);
-                    assert(field_type_create_func && "Field type create function not found");
-
-                    // Create std::any value from field value
-                    std::any value = field_type_create_func(field_value, service_proxy_manager);
-
-                    // Get field export function
-                    auto field_type_export_func 
-                        = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldExportFunc(
-                            field_info.type_name);
-
-                    // Export field value to JSON
-                    nlohmann::json field_json = field_type_export_func(value, field_name, service_proxy_manager);
-
-                    // Add field JSON to component JSON
-                    component_json[field_name.data()] = field_json;
-                }
-
-                // Add component name to component JSON
-                entity_json[component_name.data()] = component_json;
-            }
-
             // Add entity JSON to JSON data
-            json_data[EXPORT_TAG_ENTITIES].push_back(entity_json);
+            json_data[EXPORT_TAG_ENTITIES].push_back(
+                ExportEntityToJSON(entity_archive_service_api, entity, service_proxy_manager));
         }
 
         // Write JSON data to file
-        std::ofstream output_file(file_path);
-        if (!output_file.is_open())
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to open file for writing: ", file_path}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        output_file << json_data.dump(4);
-        if (!output_file)
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to write JSON data to file: ", file_path}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        // Close the file
-        output_file.close();
-
-        return true; // Success
+        return WriteJSONFile(file_path, json_data);
     });
 }
 
@@ -258,85 +372,13 @@ void EntityArchiveServiceCommandList::ExportComponentSetupParamsToFile(
 
         for (const ecs::Entity& entity : entities)
         {
-            // Create JSON object for the entity
-            nlohmann::json entity_json;
-
-            // Get all component IDs which entity has
-            std::vector<ecs::ComponentID> component_ids 
-                = entity_archive_service_api.GetSetupParamManager().GetComponentIDs(entity);
-
-            for (ecs::ComponentID component_id : component_ids)
-            {
-                // Create JSON object for the component
-                nlohmann::json component_json;
-
-                // Get component name
-                std::string_view component_name = entity_archive_service_api.GetComponentNameMap().at(component_id);                
-
-                // Get component field map
-                const component_editor::FieldMap& field_map 
-                    = entity_archive_service_api.GetComponentFieldMap(component_id);
-
-                // Get setup param
-                const ecs::Component::SetupParam& setup_param
-                    = entity_archive_service_api.GetSetupParam(entity, component_id);
-
-                for (const auto& [field_name, field_info] : field_map)
-                {
-                    // Get setup param field value
-                    const uint8_t* field_value 
-                        = entity_archive_service_api.GetSetupParamField(entity, component_id, field_name);
-
-                    // Get field create function
-                    auto field_type_create_func 
-                        = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldCreateFunc(
-                            field_info.type_name);
-                    assert(field_type_create_func && "Field type create function not found");
-
-                    // Create std::any value from field value
-                    std::any value = field_type_create_func(field_value, service_proxy_manager);
-
-                    // Get field export function
-                    auto field_type_export_func 
-                        = entity_archive_service_api.GetSetupParamFieldTypeRegistry().GetSetupParamFieldExportFunc(
-                            field_info.type_name);
-
-                    // Export field value to JSON
-                    nlohmann::json field_json = field_type_export_func(value, field_name, service_proxy_manager);
-
-                    // Add field JSON to component JSON
-                    component_json[field_name.data()] = field_json;
-                }
-
-                // Add component name to component JSON
-                entity_json[component_name.data()] = component_json;
-            }
-
             // Add entity JSON to JSON data
-            json_data[EXPORT_TAG_ENTITIES].push_back(entity_json);
+            json_data[EXPORT_TAG_ENTITIES].push_back(
+                ExportEntityToJSON(entity_archive_service_api, entity, service_proxy_manager));
         }
 
         // Write JSON data to file
-        std::ofstream output_file(file_path);
-        if (!output_file.is_open())
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to open file for writing"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        output_file << json_data.dump(4);
-        if (!output_file)
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to write JSON data to file"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        // Close the file
-        output_file.close();
-
-        return true; // Success
+        return WriteJSONFile(file_path, json_data);
     });
 }
 
@@ -357,47 +399,13 @@ void EntityArchiveServiceCommandList::ExportMaterialSetupParamsToFile(
 
         for (render_graph::MaterialHandle& material_handle : material_handles)
         {
-            // Get setup param
-            const material_editor::SetupParamWrapper* setup_param
-                = entity_archive_service_api.GetMaterialSetupParamManager().GetSetupParam(&material_handle);
-
-            // Get material setup param editor registry
-            const MaterialSetupParamEditorRegistry& material_setup_param_editor_registry
-                = entity_archive_service_api.GetMaterialSetupParamEditorRegistry();
-
-            // Get export function for the material type
-            const MaterialSetupParamExportFunc& export_func
-                = material_setup_param_editor_registry.GetSetupParamExporter(
-                    setup_param->GetSetupParam()->GetMaterialTypeHandleID());
-
-            // Export setup param to JSON
-            nlohmann::json setup_param_json = export_func(setup_param, service_proxy_manager);
-
             // Add material JSON to JSON data
-            json_data[EXPORT_TAG_MATERIALS].push_back(setup_param_json);
+            json_data[EXPORT_TAG_MATERIALS].push_back(
+                ExportMaterialToJSON(entity_archive_service_api, material_handle, service_proxy_manager));
         }
 
         // Write JSON data to file
-        std::ofstream output_file(file_path);
-        if (!output_file.is_open())
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to open file for writing"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        output_file << json_data.dump(4);
-        if (!output_file)
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to write JSON data to file"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
-
-        // Close the file
-        output_file.close();
-
-        return true; // Success
+        return WriteJSONFile(file_path, json_data);
     });
 }
 
@@ -418,47 +426,53 @@ void EntityArchiveServiceCommandList::ExportMaterialSetupParamsToFile(
 
         for (render_graph::MaterialHandle& material_handle : material_handles)
         {
-            // Get setup param
-            const material_editor::SetupParamWrapper* setup_param
-                = entity_archive_service_api.GetMaterialSetupParamManager().GetSetupParam(&material_handle);
-
-            // Get material setup param editor registry
-            const MaterialSetupParamEditorRegistry& material_setup_param_editor_registry
-                = entity_archive_service_api.GetMaterialSetupParamEditorRegistry();
-
-            // Get export function for the material type
-            const MaterialSetupParamExportFunc& export_func
-                = material_setup_param_editor_registry.GetSetupParamExporter(
-                    setup_param->GetSetupParam()->GetMaterialTypeHandleID());
-
-            // Export setup param to JSON
-            nlohmann::json setup_param_json = export_func(setup_param, service_proxy_manager);
-
             // Add material JSON to JSON data
-            json_data[EXPORT_TAG_MATERIALS].push_back(setup_param_json);
+            json_data[EXPORT_TAG_MATERIALS].push_back(
+                ExportMaterialToJSON(entity_archive_service_api, material_handle, service_proxy_manager));
         }
 
         // Write JSON data to file
-        std::ofstream output_file(file_path);
-        if (!output_file.is_open())
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to open file for writing"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
+        return WriteJSONFile(file_path, json_data);
+    });
+}
 
-        output_file << json_data.dump(4);
-        if (!output_file)
-        {
-            utility_header::ConsoleLogErr(
-                {"Failed to write JSON data to file"}, __FILE__, __LINE__, __FUNCTION__);
-            return false; // Failure
-        }
+void EntityArchiveServiceCommandList::ExportComponentSetupParamsToSnapshot(
+    const std::string& file_path, std::vector<ecs::Entity> entities,
+    mono_service::ServiceProxyManager& service_proxy_manager)
+{
+    AddCommand([file_path, entities = std::move(entities), &service_proxy_manager](mono_service::ServiceAPI& api)
+    {
+        static_assert(
+            std::is_base_of<mono_service::ServiceAPI, EntityArchiveServiceAPI>::value,
+            "EntityArchiveServiceAPI must be derived from ServiceAPI.");
+        EntityArchiveServiceAPI& entity_archive_service_api = dynamic_cast<EntityArchiveServiceAPI&>(api);
 
-        // Close the file
-        output_file.close();
+        // Write entities to snapshot file
+        return WriteSnapshotFile(
+            file_path, SnapshotContent::Entities, entities.size(), [&](size_t index)
+            {
+                return ExportEntityToJSON(entity_archive_service_api, entities[index], service_proxy_manager);
+            });
+    });
+}
 
-        return true; // Success
+void EntityArchiveServiceCommandList::ExportComponentSetupParamsToSnapshot(
+    const std::wstring& file_path, std::vector<ecs::Entity> entities,
+    mono_service::ServiceProxyManager& service_proxy_manager)
+{
+    AddCommand([file_path, entities = std::move(entities), &service_proxy_manager](mono_service::ServiceAPI& api)
+    {
+        static_assert(
+            std::is_base_of<mono_service::ServiceAPI, EntityArchiveServiceAPI>::value,
+            "EntityArchiveServiceAPI must be derived from ServiceAPI.");
+        EntityArchiveServiceAPI& entity_archive_service_api = dynamic_cast<EntityArchiveServiceAPI&>(api);
+
+        // Write entities to snapshot file
+        return WriteSnapshotFile(
+            file_path, SnapshotContent::Entities, entities.size(), [&](size_t index)
+            {
+                return ExportEntityToJSON(entity_archive_service_api, entities[index], service_proxy_manager);
+            });
     });
 }
 
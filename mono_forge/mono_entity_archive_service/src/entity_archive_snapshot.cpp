@@ -0,0 +1,634 @@
+﻿#include "mono_entity_archive_service/src/pch.h"
+#include "mono_entity_archive_service/include/entity_archive_snapshot.h"
+
+#include <cstring>
+
+#include "utility_header/logger.h"
+
+#include "mono_entity_archive_service/include/export_config.h"
+
+namespace mono_entity_archive_service
+{
+
+namespace
+{
+
+// The tags of the encoded values
+enum class ValueTag : uint8_t
+{
+    Null = 0,
+    False = 1,
+    True = 2,
+    Integer = 3, // Zigzag encoded variable length integer
+    Unsigned = 4, // Variable length integer
+    Float32 = 5, // Float which is exactly representable as 32 bit
+    Float64 = 6,
+    String = 7, // Length and bytes
+    Array = 8, // Count and values
+    Object = 9, // Count and pairs of name and value
+};
+
+// The maximum nesting depth of values, to reject broken data before the stack overflows
+constexpr uint32_t MAX_VALUE_DEPTH = 256;
+
+// The size of the chunks a string is read in, so a broken length doesn't allocate at once
+constexpr size_t STRING_READ_CHUNK_SIZE = 64 * 1024;
+
+uint64_t EncodeZigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t DecodeZigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// The parameters of the 64 bit FNV-1a hash used as the checksum
+constexpr uint64_t CHECKSUM_OFFSET_BASIS = 0xCBF29CE484222325ull;
+constexpr uint64_t CHECKSUM_PRIME = 0x100000001B3ull;
+
+uint64_t UpdateChecksum(uint64_t checksum, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        checksum ^= bytes[i];
+        checksum *= CHECKSUM_PRIME;
+    }
+    return checksum;
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(std::ostream& stream, SnapshotContent content, uint64_t record_count) :
+    buffer_(stream.rdbuf()),
+    checksum_(CHECKSUM_OFFSET_BASIS),
+    record_count_(record_count)
+{
+    assert(buffer_ != nullptr && "Stream has no buffer.");
+
+    // Write header
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+        WriteByte(static_cast<uint8_t>(SNAPSHOT_MAGIC >> (i * 8)));
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+        WriteByte(static_cast<uint8_t>(SNAPSHOT_VERSION >> (i * 8)));
+    WriteByte(static_cast<uint8_t>(content));
+    WriteVarUInt(record_count_);
+
+    // The checksum follows the last record, an empty snapshot has it right after the header
+    if (record_count_ == 0)
+        WriteChecksum();
+}
+
+bool SnapshotWriter::WriteRecord(const nlohmann::json& record)
+{
+    assert(written_record_count_ < record_count_ && "More records than declared in the header.");
+
+    if (!WriteValue(record))
+        return false; // Failure
+
+    ++written_record_count_;
+    if (written_record_count_ == record_count_)
+        WriteChecksum();
+
+    return !failed_;
+}
+
+bool SnapshotWriter::WriteValue(const nlohmann::json& value)
+{
+    switch (value.type())
+    {
+    case nlohmann::json::value_t::null:
+    case nlohmann::json::value_t::discarded:
+        WriteByte(static_cast<uint8_t>(ValueTag::Null));
+        break;
+
+    case nlohmann::json::value_t::boolean:
+        WriteByte(static_cast<uint8_t>(value.get<bool>() ? ValueTag::True : ValueTag::False));
+        break;
+
+    case nlohmann::json::value_t::number_integer:
+        WriteByte(static_cast<uint8_t>(ValueTag::Integer));
+        WriteVarUInt(EncodeZigzag(value.get<int64_t>()));
+        break;
+
+    case nlohmann::json::value_t::number_unsigned:
+        WriteByte(static_cast<uint8_t>(ValueTag::Unsigned));
+        WriteVarUInt(value.get<uint64_t>());
+        break;
+
+    case nlohmann::json::value_t::number_float:
+    {
+        // Most values come from float fields, so they fit in 32 bits without loss
+        double double_value = value.get<double>();
+        float float_value = static_cast<float>(double_value);
+
+        uint64_t double_bits = 0;
+        std::memcpy(&double_bits, &double_value, sizeof(double_bits));
+
+        double widened_value = static_cast<double>(float_value);
+        uint64_t widened_bits = 0;
+        std::memcpy(&widened_bits, &widened_value, sizeof(widened_bits));
+
+        if (double_bits == widened_bits)
+        {
+            uint32_t float_bits = 0;
+            std::memcpy(&float_bits, &float_value, sizeof(float_bits));
+
+            WriteByte(static_cast<uint8_t>(ValueTag::Float32));
+            for (size_t i = 0; i < sizeof(float_bits); ++i)
+                WriteByte(static_cast<uint8_t>(float_bits >> (i * 8)));
+        }
+        else
+        {
+            WriteByte(static_cast<uint8_t>(ValueTag::Float64));
+            for (size_t i = 0; i < sizeof(double_bits); ++i)
+                WriteByte(static_cast<uint8_t>(double_bits >> (i * 8)));
+        }
+        break;
+    }
+
+    case nlohmann::json::value_t::string:
+    {
+        const std::string& string_value = value.get_ref<const std::string&>();
+        WriteByte(static_cast<uint8_t>(ValueTag::String));
+        WriteVarUInt(string_value.size());
+        WriteBytes(string_value.data(), string_value.size());
+        break;
+    }
+
+    case nlohmann::json::value_t::array:
+        WriteByte(static_cast<uint8_t>(ValueTag::Array));
+        WriteVarUInt(value.size());
+        for (const nlohmann::json& element : value)
+        {
+            if (!WriteValue(element))
+                return false; // Failure
+        }
+        break;
+
+    case nlohmann::json::value_t::object:
+        WriteByte(static_cast<uint8_t>(ValueTag::Object));
+        WriteVarUInt(value.size());
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            if (!WriteName(it.key()))
+                return false; // Failure
+
+            if (!WriteValue(it.value()))
+                return false; // Failure
+        }
+        break;
+
+    default:
+        // Binary values are never exported to the JSON archive
+        utility_header::ConsoleLogErr(
+            {"Unsupported JSON value type in snapshot: ", value.type_name()}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    return !failed_;
+}
+
+bool SnapshotWriter::WriteName(const std::string& name)
+{
+    auto it = name_indices_.find(name);
+    if (it != name_indices_.end())
+    {
+        WriteVarUInt(it->second);
+        return true;
+    }
+
+    if (name.size() > SNAPSHOT_MAX_NAME_SIZE)
+    {
+        utility_header::ConsoleLogErr(
+            {"Name is too long for snapshot: ", std::to_string(name.size()), " bytes"},
+            __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    // A new name is written with the next index, followed by its bytes
+    uint64_t index = name_indices_.size();
+    name_indices_.emplace(name, index);
+
+    WriteVarUInt(index);
+    WriteVarUInt(name.size());
+    WriteBytes(name.data(), name.size());
+    return true;
+}
+
+void SnapshotWriter::WriteVarUInt(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        WriteByte(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    WriteByte(static_cast<uint8_t>(value));
+}
+
+void SnapshotWriter::WriteByte(uint8_t value)
+{
+    checksum_ = UpdateChecksum(checksum_, &value, sizeof(value));
+    if (buffer_->sputc(static_cast<char>(value)) == std::char_traits<char>::eof())
+        failed_ = true;
+}
+
+void SnapshotWriter::WriteBytes(const void* data, size_t size)
+{
+    checksum_ = UpdateChecksum(checksum_, data, size);
+    std::streamsize written_size
+        = buffer_->sputn(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (written_size != static_cast<std::streamsize>(size))
+        failed_ = true;
+}
+
+void SnapshotWriter::WriteChecksum()
+{
+    uint8_t bytes[sizeof(uint64_t)] = {};
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+        bytes[i] = static_cast<uint8_t>(checksum_ >> (i * 8));
+    WriteBytes(bytes, sizeof(bytes));
+}
+
+SnapshotReader::SnapshotReader(std::istream& stream) :
+    buffer_(stream.rdbuf()),
+    checksum_(CHECKSUM_OFFSET_BASIS)
+{
+    assert(buffer_ != nullptr && "Stream has no buffer.");
+
+    // Read header
+    uint8_t header[sizeof(uint32_t) * 2] = {};
+    if (!ReadBytes(header, sizeof(header)))
+    {
+        utility_header::ConsoleLogErr({"Failed to read snapshot header."}, __FILE__, __LINE__, __FUNCTION__);
+        return;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        magic |= static_cast<uint32_t>(header[i]) << (i * 8);
+        version |= static_cast<uint32_t>(header[sizeof(uint32_t) + i]) << (i * 8);
+    }
+
+    if (magic != SNAPSHOT_MAGIC)
+    {
+        utility_header::ConsoleLogErr({"Data is not a snapshot."}, __FILE__, __LINE__, __FUNCTION__);
+        failed_ = true;
+        return;
+    }
+
+    if (version != SNAPSHOT_VERSION)
+    {
+        utility_header::ConsoleLogErr(
+            {"Unsupported snapshot version: ", std::to_string(version)}, __FILE__, __LINE__, __FUNCTION__);
+        failed_ = true;
+        return;
+    }
+
+    uint8_t content = 0;
+    if (!ReadByte(content) || !ReadVarUInt(record_count_))
+        return;
+
+    if (content > static_cast<uint8_t>(SnapshotContent::Materials))
+    {
+        utility_header::ConsoleLogErr(
+            {"Unknown snapshot content: ", std::to_string(content)}, __FILE__, __LINE__, __FUNCTION__);
+        failed_ = true;
+        return;
+    }
+    content_ = static_cast<SnapshotContent>(content);
+
+    // An empty snapshot has the checksum right after the header
+    if (record_count_ == 0)
+        ReadChecksum();
+}
+
+bool SnapshotReader::ReadRecord(nlohmann::json& out_record)
+{
+    if (!HasNextRecord())
+        return false; // No record remains
+
+    if (!ReadValue(out_record, 0))
+    {
+        utility_header::ConsoleLogErr(
+            {"Broken snapshot record: ", std::to_string(read_record_count_)}, __FILE__, __LINE__, __FUNCTION__);
+        failed_ = true;
+        return false; // Failure
+    }
+
+    ++read_record_count_;
+    if (read_record_count_ == record_count_ && !ReadChecksum())
+        return false; // Failure
+
+    return true; // Success
+}
+
+bool SnapshotReader::ReadValue(nlohmann::json& out_value, uint32_t depth)
+{
+    if (depth > MAX_VALUE_DEPTH)
+        return false; // Too deep
+
+    uint8_t tag = 0;
+    if (!ReadByte(tag))
+        return false; // Failure
+
+    switch (static_cast<ValueTag>(tag))
+    {
+    case ValueTag::Null:
+        out_value = nullptr;
+        return true;
+
+    case ValueTag::False:
+        out_value = false;
+        return true;
+
+    case ValueTag::True:
+        out_value = true;
+        return true;
+
+    case ValueTag::Integer:
+    {
+        uint64_t value = 0;
+        if (!ReadVarUInt(value))
+            return false; // Failure
+
+        out_value = DecodeZigzag(value);
+        return true;
+    }
+
+    case ValueTag::Unsigned:
+    {
+        uint64_t value = 0;
+        if (!ReadVarUInt(value))
+            return false; // Failure
+
+        out_value = value;
+        return true;
+    }
+
+    case ValueTag::Float32:
+    {
+        uint8_t bytes[sizeof(uint32_t)] = {};
+        if (!ReadBytes(bytes, sizeof(bytes)))
+            return false; // Failure
+
+        uint32_t float_bits = 0;
+        for (size_t i = 0; i < sizeof(bytes); ++i)
+            float_bits |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+
+        float value = 0.0f;
+        std::memcpy(&value, &float_bits, sizeof(value));
+        out_value = static_cast<double>(value);
+        return true;
+    }
+
+    case ValueTag::Float64:
+    {
+        uint8_t bytes[sizeof(uint64_t)] = {};
+        if (!ReadBytes(bytes, sizeof(bytes)))
+            return false; // Failure
+
+        uint64_t double_bits = 0;
+        for (size_t i = 0; i < sizeof(bytes); ++i)
+            double_bits |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+
+        double value = 0.0;
+        std::memcpy(&value, &double_bits, sizeof(value));
+        out_value = value;
+        return true;
+    }
+
+    case ValueTag::String:
+    {
+        uint64_t size = 0;
+        if (!ReadVarUInt(size))
+            return false; // Failure
+
+        std::string value;
+        while (value.size() < size)
+        {
+            size_t offset = value.size();
+            size_t chunk_size = static_cast<size_t>(std::min<uint64_t>(size - offset, STRING_READ_CHUNK_SIZE));
+            value.resize(offset + chunk_size);
+            if (!ReadBytes(value.data() + offset, chunk_size))
+                return false; // Failure
+        }
+
+        out_value = std::move(value);
+        return true;
+    }
+
+    case ValueTag::Array:
+    {
+        uint64_t count = 0;
+        if (!ReadVarUInt(count))
+            return false; // Failure
+
+        out_value = nlohmann::json::array();
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            nlohmann::json element;
+            if (!ReadValue(element, depth + 1))
+                return false; // Failure
+
+            out_value.push_back(std::move(element));
+        }
+        return true;
+    }
+
+    case ValueTag::Object:
+    {
+        uint64_t count = 0;
+        if (!ReadVarUInt(count))
+            return false; // Failure
+
+        out_value = nlohmann::json::object();
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const std::string* name = nullptr;
+            if (!ReadName(name))
+                return false; // Failure
+
+            if (!ReadValue(out_value[*name], depth + 1))
+                return false; // Failure
+        }
+        return true;
+    }
+
+    default:
+        return false; // Unknown tag
+    }
+}
+
+bool SnapshotReader::ReadName(const std::string*& out_name)
+{
+    uint64_t index = 0;
+    if (!ReadVarUInt(index))
+        return false; // Failure
+
+    if (index < names_.size())
+    {
+        out_name = &names_[static_cast<size_t>(index)];
+        return true;
+    }
+
+    if (index != names_.size())
+        return false; // Names must be defined in order
+
+    // A new name follows its index
+    uint64_t size = 0;
+    if (!ReadVarUInt(size) || size > SNAPSHOT_MAX_NAME_SIZE)
+        return false; // Failure
+
+    std::string name(static_cast<size_t>(size), '\0');
+    if (!ReadBytes(name.data(), name.size()))
+        return false; // Failure
+
+    names_.push_back(std::move(name));
+    out_name = &names_.back();
+    return true;
+}
+
+bool SnapshotReader::ReadVarUInt(uint64_t& out_value)
+{
+    out_value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte = 0;
+        if (!ReadByte(byte))
+            return false; // Failure
+
+        out_value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true; // Success
+    }
+
+    return false; // Too long
+}
+
+bool SnapshotReader::ReadByte(uint8_t& out_value)
+{
+    std::char_traits<char>::int_type value = buffer_->sbumpc();
+    if (value == std::char_traits<char>::eof())
+    {
+        failed_ = true;
+        return false; // End of data
+    }
+
+    out_value = static_cast<uint8_t>(value);
+    checksum_ = UpdateChecksum(checksum_, &out_value, sizeof(out_value));
+    return true;
+}
+
+bool SnapshotReader::ReadBytes(void* data, size_t size)
+{
+    std::streamsize read_size = buffer_->sgetn(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (read_size != static_cast<std::streamsize>(size))
+    {
+        failed_ = true;
+        return false; // End of data
+    }
+
+    checksum_ = UpdateChecksum(checksum_, data, size);
+    return true;
+}
+
+bool SnapshotReader::ReadChecksum()
+{
+    // The checksum covers the bytes before it
+    uint64_t expected_checksum = checksum_;
+
+    uint8_t bytes[sizeof(uint64_t)] = {};
+    if (!ReadBytes(bytes, sizeof(bytes)))
+    {
+        utility_header::ConsoleLogErr({"Failed to read snapshot checksum."}, __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+        checksum |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+
+    if (checksum != expected_checksum)
+    {
+        utility_header::ConsoleLogErr({"Snapshot checksum mismatch."}, __FILE__, __LINE__, __FUNCTION__);
+        failed_ = true;
+        return false; // Failure
+    }
+
+    return true; // Success
+}
+
+const char* GetSnapshotContentTag(SnapshotContent content)
+{
+    switch (content)
+    {
+    case SnapshotContent::Entities:
+        return EXPORT_TAG_ENTITIES;
+
+    case SnapshotContent::Materials:
+        return EXPORT_TAG_MATERIALS;
+
+    default:
+        assert(false && "Unknown snapshot content.");
+        return "";
+    }
+}
+
+bool ConvertJSONToSnapshot(const nlohmann::json& json, std::ostream& stream)
+{
+    // Find the export tag
+    for (SnapshotContent content : { SnapshotContent::Entities, SnapshotContent::Materials })
+    {
+        auto it = json.find(GetSnapshotContentTag(content));
+        if (it == json.end())
+            continue;
+
+        if (!it->is_array() || json.size() != 1)
+        {
+            utility_header::ConsoleLogErr(
+                {"JSON archive must have only an array of ", GetSnapshotContentTag(content)},
+                __FILE__, __LINE__, __FUNCTION__);
+            return false; // Failure
+        }
+
+        SnapshotWriter writer(stream, content, it->size());
+        for (const nlohmann::json& record : *it)
+        {
+            if (!writer.WriteRecord(record))
+                return false; // Failure
+        }
+
+        return writer.IsComplete() && stream.flush().good();
+    }
+
+    utility_header::ConsoleLogErr({"JSON archive has no export tag."}, __FILE__, __LINE__, __FUNCTION__);
+    return false; // Failure
+}
+
+bool ConvertSnapshotToJSON(std::istream& stream, nlohmann::json& out_json)
+{
+    SnapshotReader reader(stream);
+    if (!reader.IsValid())
+        return false; // Failure
+
+    nlohmann::json records = nlohmann::json::array();
+    while (reader.HasNextRecord())
+    {
+        nlohmann::json record;
+        if (!reader.ReadRecord(record))
+            return false; // Failure
+
+        records.push_back(std::move(record));
+    }
+
+    out_json = nlohmann::json::object();
+    out_json[GetSnapshotContentTag(reader.GetContent())] = std::move(records);
+    return true; // Success
+}
+
+} // namespace mono_entity_archive_service
\ No newline at end of file
@@ -0,0 +1,301 @@
+﻿#include "mono_entity_archive_service_test/pch.h"
+
+#include <sstream>
+
+#include "ecs/include/world.h"
+#include "mono_service/include/service_importer.h"
+#include "mono_service/include/thread_affinity.h"
+#include "mono_service/include/service_proxy_manager.h"
+
+#include "mono_entity_archive_service/include/entity_archive_service.h"
+#include "mono_entity_archive_service/include/export_config.h"
+#include "mono_entity_archive_extension/include/allocator_factory.h"
+#include "mono_entity_archive_extension/include/import_helper.h"
+
+#include "mono_entity_archive_service_test/tests/component_reflection.h"
+#include "mono_entity_archive_service_test/tests/test_meta_component.h"
+#include "mono_entity_archive_service_test/tests/test_transform_component.h"
+
+namespace entity_archive_import_test
+{
+
+// Create a JSON archive which looks like the exported one
+nlohmann::json CreateEntitiesJSON(size_t entity_count)
+{
+    nlohmann::json json_data;
+    json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES] = nlohmann::json::array();
+
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        nlohmann::json entity_json;
+
+        nlohmann::json& meta_json = entity_json["component_editor_test::TestMetaComponent"];
+        meta_json["name"] = "Entity " + std::to_string(i);
+        meta_json["active_self"] = (i % 3) != 0;
+        meta_json["tag"] = static_cast<uint64_t>(i % 7);
+        meta_json["layer"] = static_cast<uint64_t>(i % 4);
+
+        // Every other entity only has the meta component
+        if (i % 2 == 0)
+        {
+            float value = static_cast<float>(i) * 0.1f;
+            nlohmann::json& transform_json = entity_json["component_editor_test::TestTransformComponent"];
+            transform_json["position"] = { value, -value, value * 2.0f };
+            transform_json["rotation"] = { 0.0f, value * 0.5f, 0.0f };
+            transform_json["scale"] = { 1.0f, 1.0f, 1.0f };
+        }
+
+        json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES].push_back(std::move(entity_json));
+    }
+
+    return json_data;
+}
+
+// Import the entity archive service with the test components and register its proxy
+void ImportEntityArchiveService(
+    mono_service::ServiceRegistry& service_registry, mono_service::ServiceProxyRegistry& service_proxy_registry)
+{
+    constexpr mono_service::ServiceThreadAffinityID ENTITY_ARCHIVE_SERVICE_THREAD_AFFINITY_ID = 0;
+    {
+        mono_entity_archive_service::EntityArchiveService::SetupParam entity_archive_service_setup_param;
+
+        component_editor::ComponentNameMap& component_name_map = entity_archive_service_setup_param.component_name_map;
+        component_name_map[component_editor_test::TestMetaComponentHandle::ID()]
+            = "component_editor_test::TestMetaComponent";
+        component_name_map[component_editor_test::TestTransformComponentHandle::ID()]
+            = "component_editor_test::TestTransformComponent";
+
+        component_editor::ComponentAdderMap& component_adder_map = entity_archive_service_setup_param.component_adder_map;
+        component_adder_map[component_editor_test::TestMetaComponentHandle::ID()]
+            = std::make_unique<component_editor_test::TestMetaComponentAdder>();
+        component_adder_map[component_editor_test::TestTransformComponentHandle::ID()]
+            = std::make_unique<component_editor_test::TestTransformComponentAdder>();
+
+        entity_archive_service_setup_param.component_reflection_registry
+            = component_editor_test::g_component_reflection_registry;
+        entity_archive_service_setup_param.setup_param_field_value_setter
+            = component_editor_test::g_setup_param_field_value_setter;
+        entity_archive_service_setup_param.setup_param_field_type_registry_
+            = component_editor_test::g_setup_param_field_type_registry;
+
+        bool result = mono_service::ImportService<
+            mono_entity_archive_service::EntityArchiveService,
+            mono_entity_archive_service::EntityArchiveServiceHandle>(
+                service_registry, ENTITY_ARCHIVE_SERVICE_THREAD_AFFINITY_ID,
+                entity_archive_service_setup_param);
+        ASSERT_TRUE(result);
+    }
+
+    // The import helpers get the service proxy from the proxy manager
+    service_registry.WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        mono_service::Service& service = registry.Get(
+            mono_entity_archive_service::EntityArchiveServiceHandle::ID());
+
+        service_proxy_registry.WithUniqueLock([&](mono_service::ServiceProxyRegistry& proxy_registry)
+        {
+            proxy_registry.Register(
+                mono_entity_archive_service::EntityArchiveServiceHandle::ID(), service.CreateServiceProxy());
+        });
+    });
+}
+
+// Create a world which can hold the test components
+std::unique_ptr<ecs::World> CreateWorld(size_t max_entity_count)
+{
+    std::unique_ptr<ecs::ComponentDescriptorRegistry> component_descriptor_registry
+        = std::make_unique<ecs::ComponentDescriptorRegistry>();
+
+    component_descriptor_registry->WithUniqueLock([&](ecs::ComponentDescriptorRegistry& registry)
+    {
+        registry.Register(
+            component_editor_test::TestMetaComponentHandle::ID(),
+            std::make_unique<ecs::ComponentDescriptor>(
+                sizeof(component_editor_test::TestMetaComponent), max_entity_count,
+                std::make_unique<mono_entity_archive_extension::ComponentAllocatorFactory>()));
+        registry.Register(
+            component_editor_test::TestTransformComponentHandle::ID(),
+            std::make_unique<ecs::ComponentDescriptor>(
+                sizeof(component_editor_test::TestTransformComponent), max_entity_count,
+                std::make_unique<mono_entity_archive_extension::ComponentAllocatorFactory>()));
+    });
+
+    return std::make_unique<ecs::World>(std::move(component_descriptor_registry));
+}
+
+// Count the entities which have the test meta component
+size_t CountMetaEntities(ecs::World& world)
+{
+    size_t count = 0;
+    world.ForEach<component_editor_test::TestMetaComponent>(
+        component_editor_test::TestMetaComponentHandle::ID(),
+        [&](const ecs::Entity&, component_editor_test::TestMetaComponent&) { count++; });
+    return count;
+}
+
+// Check if the entities of both worlds have the same components with the same values
+void ExpectSameEntity(
+    ecs::World& expected_world, const ecs::Entity& expected_entity,
+    ecs::World& actual_world, const ecs::Entity& actual_entity)
+{
+    std::set<ecs::ComponentID> expected_ids = *expected_world.GetComponentIDs(expected_entity);
+    std::set<ecs::ComponentID> actual_ids = *actual_world.GetComponentIDs(actual_entity);
+    ASSERT_EQ(expected_ids, actual_ids);
+
+    const component_editor_test::TestMetaComponent* expected_meta
+        = expected_world.GetComponent<component_editor_test::TestMetaComponent>(
+            expected_entity, component_editor_test::TestMetaComponentHandle::ID());
+    const component_editor_test::TestMetaComponent* actual_meta
+        = actual_world.GetComponent<component_editor_test::TestMetaComponent>(
+            actual_entity, component_editor_test::TestMetaComponentHandle::ID());
+    ASSERT_NE(expected_meta, nullptr);
+    ASSERT_NE(actual_meta, nullptr);
+    EXPECT_EQ(expected_meta->GetName(), actual_meta->GetName());
+    EXPECT_EQ(expected_meta->IsActiveSelf(), actual_meta->IsActiveSelf());
+    EXPECT_EQ(expected_meta->GetTag(), actual_meta->GetTag());
+    EXPECT_EQ(expected_meta->GetLayer(), actual_meta->GetLayer());
+
+    const component_editor_test::TestTransformComponent* expected_transform
+        = expected_world.GetComponent<component_editor_test::TestTransformComponent>(
+            expected_entity, component_editor_test::TestTransformComponentHandle::ID());
+    const component_editor_test::TestTransformComponent* actual_transform
+        = actual_world.GetComponent<component_editor_test::TestTransformComponent>(
+            actual_entity, component_editor_test::TestTransformComponentHandle::ID());
+    ASSERT_EQ(expected_transform == nullptr, actual_transform == nullptr);
+    if (expected_transform == nullptr)
+        return; // Only the meta component
+
+    for (auto getter : {
+        &component_editor_test::TestTransformComponent::GetPosition,
+        &component_editor_test::TestTransformComponent::GetRotation,
+        &component_editor_test::TestTransformComponent::GetScale })
+    {
+        const DirectX::XMFLOAT3& expected_value = (expected_transform->*getter)();
+        const DirectX::XMFLOAT3& actual_value = (actual_transform->*getter)();
+        EXPECT_EQ(expected_value.x, actual_value.x);
+        EXPECT_EQ(expected_value.y, actual_value.y);
+        EXPECT_EQ(expected_value.z, actual_value.z);
+    }
+}
+
+} // namespace entity_archive_import_test
+
+TEST(EntityArchiveImport, StreamSameAsDOM)
+{
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+    std::unique_ptr<mono_service::ServiceProxyRegistry> service_proxy_registry
+        = std::make_unique<mono_service::ServiceProxyRegistry>();
+    entity_archive_import_test::ImportEntityArchiveService(*service_registry, *service_proxy_registry);
+    std::unique_ptr<mono_service::ServiceProxyManager> service_proxy_manager
+        = std::make_unique<mono_service::ServiceProxyManager>(*service_proxy_registry);
+
+    constexpr size_t ENTITY_COUNT = 16;
+    nlohmann::json archive_json = entity_archive_import_test::CreateEntitiesJSON(ENTITY_COUNT);
+
+    // Import the parsed archive
+    std::unique_ptr<ecs::World> dom_world = entity_archive_import_test::CreateWorld(ENTITY_COUNT);
+    std::vector<ecs::Entity> dom_entities;
+    ASSERT_TRUE(mono_entity_archive_extension::CreateEntitiesFromExportedJSON(
+        *dom_world, archive_json, *service_proxy_manager, &dom_entities));
+
+    // Stream the same archive
+    std::unique_ptr<ecs::World> stream_world = entity_archive_import_test::CreateWorld(ENTITY_COUNT);
+    std::vector<ecs::Entity> stream_entities;
+    {
+        std::istringstream stream(archive_json.dump(4));
+        ASSERT_TRUE(mono_entity_archive_extension::CreateEntitiesFromExportedJSONStream(
+            *stream_world, stream, *service_proxy_manager, &stream_entities));
+    }
+
+    ASSERT_EQ(dom_entities.size(), ENTITY_COUNT);
+    ASSERT_EQ(stream_entities.size(), ENTITY_COUNT);
+    for (size_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        entity_archive_import_test::ExpectSameEntity(
+            *dom_world, dom_entities[i], *stream_world, stream_entities[i]);
+    }
+
+    // The values come from the archive, not from the default setup params
+    const component_editor_test::TestMetaComponent* meta
+        = stream_world->GetComponent<component_editor_test::TestMetaComponent>(
+            stream_entities[ENTITY_COUNT - 1], component_editor_test::TestMetaComponentHandle::ID());
+    ASSERT_NE(meta, nullptr);
+    EXPECT_EQ(meta->GetName(), "Entity " + std::to_string(ENTITY_COUNT - 1));
+
+    stream_world.reset();
+    dom_world.reset();
+    service_proxy_manager.reset();
+    service_proxy_registry.reset();
+    service_registry.reset();
+}
+
+TEST(EntityArchiveImport, RollbackOnFailure)
+{
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+    std::unique_ptr<mono_service::ServiceProxyRegistry> service_proxy_registry
+        = std::make_unique<mono_service::ServiceProxyRegistry>();
+    entity_archive_import_test::ImportEntityArchiveService(*service_registry, *service_proxy_registry);
+    std::unique_ptr<mono_service::ServiceProxyManager> service_proxy_manager
+        = std::make_unique<mono_service::ServiceProxyManager>(*service_proxy_registry);
+
+    constexpr size_t ENTITY_COUNT = 4;
+    std::string archive_text = entity_archive_import_test::CreateEntitiesJSON(ENTITY_COUNT).dump();
+    std::unique_ptr<ecs::World> world = entity_archive_import_test::CreateWorld(ENTITY_COUNT);
+
+    // The archive is cut in the last entity, the entities before it have been created when the parse fails
+    {
+        std::istringstream stream(archive_text.substr(0, archive_text.size() - 20));
+        std::vector<ecs::Entity> created_entities;
+        EXPECT_FALSE(mono_entity_archive_extension::CreateEntitiesFromExportedJSONStream(
+            *world, stream, *service_proxy_manager, &created_entities));
+        EXPECT_TRUE(created_entities.empty());
+        EXPECT_EQ(entity_archive_import_test::CountMetaEntities(*world), 0);
+    }
+
+    // The records of the first array have been created when the duplicate tag is found
+    {
+        nlohmann::json entities_json
+            = entity_archive_import_test::CreateEntitiesJSON(1)[mono_entity_archive_service::EXPORT_TAG_ENTITIES];
+        std::string tag = std::string("\"") + mono_entity_archive_service::EXPORT_TAG_ENTITIES + "\": ";
+        std::istringstream stream("{" + tag + entities_json.dump() + ", " + tag + entities_json.dump() + "}");
+        EXPECT_FALSE(mono_entity_archive_extension::CreateEntitiesFromExportedJSONStream(
+            *world, stream, *service_proxy_manager));
+        EXPECT_EQ(entity_archive_import_test::CountMetaEntities(*world), 0);
+    }
+
+    // An unknown component fails after the first entity has been created
+    {
+        nlohmann::json archive_json = entity_archive_import_test::CreateEntitiesJSON(2);
+        archive_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES][1]["UnknownComponent"] = nlohmann::json::object();
+        EXPECT_FALSE(mono_entity_archive_extension::CreateEntitiesFromExportedJSON(
+            *world, archive_json, *service_proxy_manager));
+        EXPECT_EQ(entity_archive_import_test::CountMetaEntities(*world), 0);
+    }
+
+    // The world is usable after the failures
+    {
+        std::istringstream stream(archive_text);
+        std::vector<ecs::Entity> created_entities;
+        EXPECT_TRUE(mono_entity_archive_extension::CreateEntitiesFromExportedJSONStream(
+            *world, stream, *service_proxy_manager, &created_entities));
+        EXPECT_EQ(created_entities.size(), ENTITY_COUNT);
+        EXPECT_EQ(entity_archive_import_test::CountMetaEntities(*world), ENTITY_COUNT);
+    }
+
+    world.reset();
+    service_proxy_manager.reset();
+    service_proxy_registry.reset();
+    service_registry.reset();
+}
\ No newline at end of file
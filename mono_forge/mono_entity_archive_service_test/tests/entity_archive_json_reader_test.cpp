@@ -0,0 +1,256 @@
+﻿#include "mono_entity_archive_service_test/pch.h"
+
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+#include "mono_entity_archive_service/include/entity_archive_json_reader.h"
+#include "mono_entity_archive_service/include/export_config.h"
+
+namespace entity_archive_json_reader_test
+{
+
+// Create the JSON of an entity which looks like the exported one
+nlohmann::json CreateEntityJSON(size_t index)
+{
+    nlohmann::json entity_json;
+
+    nlohmann::json& meta_json = entity_json["component_editor_test::TestMetaComponent"];
+    meta_json["name"] = "Entity " + std::to_string(index);
+    meta_json["active_self"] = (index % 3) != 0;
+    meta_json["tag"] = static_cast<uint64_t>(index % 7);
+    meta_json["layer"] = static_cast<uint64_t>(index % 4);
+
+    float value = static_cast<float>(index) * 0.1f;
+    nlohmann::json& transform_json = entity_json["component_editor_test::TestTransformComponent"];
+    transform_json["position"] = { value, -value, value * 2.0f };
+    transform_json["rotation"] = { 0.0f, value * 0.5f, 0.0f };
+    transform_json["scale"] = { 1.0f, 1.0f, 1.0f };
+
+    return entity_json;
+}
+
+// Write an archive of the entities to the stream without holding them all in memory
+void WriteEntitiesArchive(std::ostream& stream, size_t entity_count)
+{
+    stream << "{\n    \"" << mono_entity_archive_service::EXPORT_TAG_ENTITIES << "\": [";
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        if (i != 0)
+            stream << ",";
+        stream << "\n        " << CreateEntityJSON(i).dump(4);
+    }
+    stream << "\n    ]\n}";
+}
+
+// Read the records of the archive text into an array
+bool ReadRecords(const std::string& text, nlohmann::json& out_records)
+{
+    std::istringstream stream(text);
+    out_records = nlohmann::json::array();
+    return mono_entity_archive_service::ReadJSONArchiveRecords(
+        stream, mono_entity_archive_service::EXPORT_TAG_ENTITIES,
+        [&](nlohmann::json& record) -> bool
+        {
+            out_records.push_back(std::move(record));
+            return true;
+        });
+}
+
+// Check if the values are equal including their JSON types
+void ExpectSameJSON(const nlohmann::json& expected, const nlohmann::json& actual)
+{
+    ASSERT_EQ(expected.type(), actual.type()) << expected.dump();
+    switch (expected.type())
+    {
+    case nlohmann::json::value_t::array:
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            ExpectSameJSON(expected[i], actual[i]);
+        break;
+
+    case nlohmann::json::value_t::object:
+        ASSERT_EQ(expected.size(), actual.size());
+        for (auto it = expected.begin(); it != expected.end(); ++it)
+        {
+            ASSERT_TRUE(actual.contains(it.key())) << it.key();
+            ExpectSameJSON(it.value(), actual.at(it.key()));
+        }
+        break;
+
+    default:
+        EXPECT_EQ(expected.dump(), actual.dump());
+        break;
+    }
+}
+
+} // namespace entity_archive_json_reader_test
+
+TEST(EntityArchiveJSONReader, SameAsDOM)
+{
+    // An archive with every kind of value, and other tags before and after the entities
+    nlohmann::json json_data;
+    json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES] = nlohmann::json::array();
+    nlohmann::json& entities_json = json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES];
+    for (size_t i = 0; i < 100; ++i)
+        entities_json.push_back(entity_archive_json_reader_test::CreateEntityJSON(i));
+
+    nlohmann::json& edge_json = entities_json[0]["edge"];
+    edge_json["null"] = nullptr;
+    edge_json["negative"] = (std::numeric_limits<int64_t>::min)();
+    edge_json["unsigned"] = (std::numeric_limits<uint64_t>::max)();
+    edge_json["double"] = 0.1;
+    edge_json["float"] = 0.1f;
+    edge_json["empty_string"] = "";
+    edge_json["escaped"] = "quote \" backslash \\ newline \n";
+    edge_json["utf8"] = "\xE3\x82\xA8\xE3\x83\xB3\xE3\x83\x86\xE3\x82\xA3\xE3\x83\x86\xE3\x82\xA3";
+    edge_json["empty_array"] = nlohmann::json::array();
+    edge_json["empty_object"] = nlohmann::json::object();
+    edge_json["nested"] = { { "array", { 1, -2, { { "key", "value" } }, { { 1, 2 }, {} } } } };
+
+    // Records which are not objects are passed as they are
+    entities_json.push_back(nlohmann::json::object());
+    entities_json.push_back(nlohmann::json::array({ 1, 2 }));
+    entities_json.push_back(42);
+
+    json_data["aaa_before"] = { { "entities", { 1, 2, 3 } } };
+    json_data[mono_entity_archive_service::EXPORT_TAG_MATERIALS] = { { { "type", "lambert" } } };
+
+    for (int indent : { -1, 4 })
+    {
+        std::string text = json_data.dump(indent);
+
+        nlohmann::json records;
+        ASSERT_TRUE(entity_archive_json_reader_test::ReadRecords(text, records));
+
+        nlohmann::json dom_json = nlohmann::json::parse(text);
+        const nlohmann::json& dom_records = dom_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES];
+        EXPECT_EQ(records, dom_records);
+        entity_archive_json_reader_test::ExpectSameJSON(dom_records, records);
+    }
+
+    // A duplicate key overwrites the earlier value, as the DOM parser does
+    std::string duplicate_text = "{\"entities\": [{\"a\": 1, \"a\": {\"b\": 2}}]}";
+    nlohmann::json duplicate_records;
+    ASSERT_TRUE(entity_archive_json_reader_test::ReadRecords(duplicate_text, duplicate_records));
+    EXPECT_EQ(duplicate_records, nlohmann::json::parse(duplicate_text)["entities"]);
+
+    // An empty array has no records
+    nlohmann::json empty_records;
+    ASSERT_TRUE(entity_archive_json_reader_test::ReadRecords("{\"entities\": []}", empty_records));
+    EXPECT_TRUE(empty_records.empty());
+}
+
+TEST(EntityArchiveJSONReader, BrokenArchive)
+{
+    std::string text = "{\"entities\": [{\"a\": 1}, {\"b\": [1, 2]}, {\"c\": 3}]}";
+    nlohmann::json records;
+
+    // The records before the broken part have been passed
+    for (size_t size : { size_t(0), size_t(10), size_t(25), text.size() - 1 })
+    {
+        EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords(text.substr(0, size), records)) << size;
+        EXPECT_LE(records.size(), 3);
+    }
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("{\"entities\": [{\"a\": 1},, ]}", records));
+    EXPECT_EQ(records.size(), 1);
+
+    // Archives without the array of records
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("{\"materials\": []}", records));
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("{\"entities\": {\"a\": []}}", records));
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("{\"entities\": 1}", records));
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("[{\"entities\": []}]", records));
+
+    // A duplicate tag is rejected, the records of the first array have already been passed
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords(
+        "{\"entities\": [{\"a\": 1}], \"entities\": [{\"b\": 2}]}", records));
+    EXPECT_EQ(records.size(), 1);
+    EXPECT_FALSE(entity_archive_json_reader_test::ReadRecords("{\"entities\": 1, \"entities\": []}", records));
+
+    // The function stops reading
+    std::istringstream stream(text);
+    uint64_t record_count = 0;
+    EXPECT_FALSE(mono_entity_archive_service::ReadJSONArchiveRecords(
+        stream, mono_entity_archive_service::EXPORT_TAG_ENTITIES,
+        [](nlohmann::json& record) { return !record.contains("b"); }, &record_count));
+    EXPECT_EQ(record_count, 2);
+}
+
+TEST(EntityArchiveJSONReader, Benchmark)
+{
+    constexpr size_t ENTITY_COUNT = 100000;
+    const std::string JSON_FILE_PATH = "output/json_reader_benchmark.json";
+
+    // Write the archive one entity at a time
+    {
+        std::ofstream json_file(JSON_FILE_PATH);
+        ASSERT_TRUE(json_file.is_open());
+        entity_archive_json_reader_test::WriteEntitiesArchive(json_file, ENTITY_COUNT);
+    }
+
+    // The peak working set of the process depends on the tests run before, so only the times are measured here
+    // Stream the records, one entity is held at a time
+    uint64_t stream_record_count = 0;
+    size_t stream_received_count = 0;
+    double stream_first_record_ms = 0.0;
+    auto stream_start = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream input_file(JSON_FILE_PATH);
+        ASSERT_TRUE(input_file.is_open());
+
+        ASSERT_TRUE(mono_entity_archive_service::ReadJSONArchiveRecords(
+            input_file, mono_entity_archive_service::EXPORT_TAG_ENTITIES,
+            [&](nlohmann::json& record) -> bool
+            {
+                if (stream_received_count++ == 0)
+                {
+                    stream_first_record_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - stream_start).count();
+                }
+                return record.is_object();
+            },
+            &stream_record_count));
+    }
+    auto stream_end = std::chrono::high_resolution_clock::now();
+
+    // Parse the whole archive as ProjectIOSystem did, no entity is available until it ends
+    size_t dom_record_count = 0;
+    auto dom_start = std::chrono::high_resolution_clock::now();
+    nlohmann::json archive_json;
+    {
+        std::ifstream input_file(JSON_FILE_PATH);
+        ASSERT_TRUE(input_file.is_open());
+        input_file >> archive_json;
+        dom_record_count = archive_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES].size();
+    }
+    auto dom_end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_EQ(stream_record_count, ENTITY_COUNT);
+    EXPECT_EQ(stream_received_count, ENTITY_COUNT);
+    EXPECT_EQ(dom_record_count, ENTITY_COUNT);
+
+    // The streamed records are the same as the parsed ones
+    {
+        std::ifstream input_file(JSON_FILE_PATH);
+        ASSERT_TRUE(input_file.is_open());
+
+        const nlohmann::json& dom_records = archive_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES];
+        size_t index = 0;
+        ASSERT_TRUE(mono_entity_archive_service::ReadJSONArchiveRecords(
+            input_file, mono_entity_archive_service::EXPORT_TAG_ENTITIES,
+            [&](nlohmann::json& record) -> bool
+            {
+                return index < dom_records.size() && record == dom_records[index++];
+            }));
+        EXPECT_EQ(index, ENTITY_COUNT);
+    }
+
+    // The first streamed entity is available long before the DOM of the whole archive
+    double dom_ms = std::chrono::duration<double, std::milli>(dom_end - dom_start).count();
+    EXPECT_LT(stream_first_record_ms, dom_ms);
+
+    std::cout << "Entities: " << ENTITY_COUNT << std::endl;
+    std::cout << "Stream: " << std::chrono::duration<double, std::milli>(stream_end - stream_start).count() << " ms, "
+        << "first entity after " << stream_first_record_ms << " ms" << std::endl;
+    std::cout << "DOM: " << dom_ms << " ms, first entity after the whole parse" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,540 @@
+﻿#include "mono_entity_archive_service_test/pch.h"
+
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+#include "mono_service/include/service_importer.h"
+#include "mono_service/include/thread_affinity.h"
+#include "mono_service/include/service_proxy_manager.h"
+
+#include "mono_entity_archive_service/include/entity_archive_service.h"
+#include "mono_entity_archive_service/include/entity_archive_service_command_list.h"
+#include "mono_entity_archive_service/include/entity_archive_snapshot.h"
+#include "mono_entity_archive_service/include/export_config.h"
+
+#include "mono_entity_archive_service_test/tests/component_reflection.h"
+#include "mono_entity_archive_service_test/tests/test_meta_component.h"
+#include "mono_entity_archive_service_test/tests/test_transform_component.h"
+
+namespace entity_archive_snapshot_test
+{
+
+// Create a JSON archive which looks like the exported one
+nlohmann::json CreateEntitiesJSON(size_t entity_count)
+{
+    nlohmann::json json_data;
+    json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES] = nlohmann::json::array();
+
+    for (size_t i = 0; i < entity_count; ++i)
+    {
+        nlohmann::json entity_json;
+
+        nlohmann::json& meta_json = entity_json["component_editor_test::TestMetaComponent"];
+        meta_json["name"] = "Entity " + std::to_string(i);
+        meta_json["active_self"] = (i % 3) != 0;
+        meta_json["tag"] = static_cast<uint64_t>(i % 7);
+        meta_json["layer"] = static_cast<uint64_t>(i % 4);
+
+        float value = static_cast<float>(i) * 0.1f;
+        nlohmann::json& transform_json = entity_json["component_editor_test::TestTransformComponent"];
+        transform_json["position"] = { value, -value, value * 2.0f };
+        transform_json["rotation"] = { 0.0f, value * 0.5f, 0.0f };
+        transform_json["scale"] = { 1.0f, 1.0f, 1.0f };
+
+        json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES].push_back(std::move(entity_json));
+    }
+
+    return json_data;
+}
+
+// Check if the values are equal including their JSON types
+void ExpectSameJSON(const nlohmann::json& expected, const nlohmann::json& actual)
+{
+    ASSERT_EQ(expected.type(), actual.type()) << expected.dump();
+    switch (expected.type())
+    {
+    case nlohmann::json::value_t::array:
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            ExpectSameJSON(expected[i], actual[i]);
+        break;
+
+    case nlohmann::json::value_t::object:
+        ASSERT_EQ(expected.size(), actual.size());
+        for (auto it = expected.begin(); it != expected.end(); ++it)
+        {
+            ASSERT_TRUE(actual.contains(it.key())) << it.key();
+            ExpectSameJSON(it.value(), actual.at(it.key()));
+        }
+        break;
+
+    default:
+        EXPECT_EQ(expected.dump(), actual.dump());
+        break;
+    }
+}
+
+// Estimate the heap memory held by a JSON value
+// It is computed from the container sizes, allocator overhead is not measured
+size_t EstimateJSONMemory(const nlohmann::json& value)
+{
+    // The size of a node of std::map, which holds the pair and three pointers and a color
+    constexpr size_t MAP_NODE_SIZE = sizeof(std::pair<const std::string, nlohmann::json>) + sizeof(void*) * 4;
+
+    size_t size = 0;
+    switch (value.type())
+    {
+    case nlohmann::json::value_t::string:
+        size += sizeof(std::string) + value.get_ref<const std::string&>().capacity() + 1;
+        break;
+
+    case nlohmann::json::value_t::array:
+        size += sizeof(nlohmann::json::array_t)
+            + value.get_ref<const nlohmann::json::array_t&>().capacity() * sizeof(nlohmann::json);
+        for (const nlohmann::json& element : value)
+            size += EstimateJSONMemory(element);
+        break;
+
+    case nlohmann::json::value_t::object:
+        size += sizeof(nlohmann::json::object_t);
+        for (auto it = value.begin(); it != value.end(); ++it)
+            size += MAP_NODE_SIZE + it.key().capacity() + 1 + EstimateJSONMemory(it.value());
+        break;
+
+    default:
+        break; // Stored in the value itself
+    }
+
+    return size;
+}
+
+// Count the fields of an entity record
+size_t CountFields(const nlohmann::json& entity_json)
+{
+    size_t field_count = 0;
+    for (auto it = entity_json.begin(); it != entity_json.end(); ++it)
+        field_count += it.value().size();
+    return field_count;
+}
+
+// Run a frame of the service
+void UpdateService(mono_service::ServiceRegistry& service_registry)
+{
+    service_registry.WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        mono_service::Service& service = registry.Get(
+            mono_entity_archive_service::EntityArchiveServiceHandle::ID());
+
+        ASSERT_TRUE(service.PreUpdate());
+        ASSERT_TRUE(service.Update());
+        ASSERT_TRUE(service.PostUpdate());
+    });
+}
+
+} // namespace entity_archive_snapshot_test
+
+TEST(EntityArchiveSnapshot, RoundTrip)
+{
+    // Entities with every kind of value the exporters produce
+    nlohmann::json entities_json = entity_archive_snapshot_test::CreateEntitiesJSON(16);
+    nlohmann::json& edge_json = entities_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES][0]["edge"];
+    edge_json["null"] = nullptr;
+    edge_json["negative"] = std::numeric_limits<int64_t>::min();
+    edge_json["unsigned"] = std::numeric_limits<uint64_t>::max();
+    edge_json["double"] = 0.1;
+    edge_json["float"] = 0.1f;
+    edge_json["empty_string"] = "";
+    edge_json["utf8"] = "\xE3\x82\xA8\xE3\x83\xB3\xE3\x83\x86\xE3\x82\xA3\xE3\x83\x86\xE3\x82\xA3";
+    edge_json["empty_array"] = nlohmann::json::array();
+    edge_json["empty_object"] = nlohmann::json::object();
+    edge_json["nested"] = { { "array", { 1, -2, { { "key", "value" } } } } };
+
+    // Materials are objects whose layout the material exporters decide
+    nlohmann::json materials_json;
+    materials_json[mono_entity_archive_service::EXPORT_TAG_MATERIALS] = nlohmann::json::array();
+    materials_json[mono_entity_archive_service::EXPORT_TAG_MATERIALS].push_back(
+        { { "type", "lambert" }, { "base_color", { 1.0f, 0.5f, 0.25f, 1.0f } }, { "albedo_source", 0 } });
+    materials_json[mono_entity_archive_service::EXPORT_TAG_MATERIALS].push_back(
+        { { "type", "phong" }, { "shininess", 32.0f }, { "texture", "asset/texture.png" } });
+
+    for (const nlohmann::json& json_data : { entities_json, materials_json })
+    {
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        ASSERT_TRUE(mono_entity_archive_service::ConvertJSONToSnapshot(json_data, stream));
+
+        nlohmann::json converted_json;
+        ASSERT_TRUE(mono_entity_archive_service::ConvertSnapshotToJSON(stream, converted_json));
+
+        EXPECT_EQ(converted_json, json_data);
+        entity_archive_snapshot_test::ExpectSameJSON(json_data, converted_json);
+    }
+
+    // JSON without export tag can't be converted
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    EXPECT_FALSE(mono_entity_archive_service::ConvertJSONToSnapshot({ { "unknown", nlohmann::json::array() } }, stream));
+}
+
+TEST(EntityArchiveSnapshot, StreamedRecords)
+{
+    constexpr size_t ENTITY_COUNT = 100;
+    nlohmann::json json_data = entity_archive_snapshot_test::CreateEntitiesJSON(ENTITY_COUNT);
+    const nlohmann::json& entities_json = json_data[mono_entity_archive_service::EXPORT_TAG_ENTITIES];
+
+    // Write records one at a time
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    {
+        mono_entity_archive_service::SnapshotWriter writer(
+            stream, mono_entity_archive_service::SnapshotContent::Entities, ENTITY_COUNT);
+        for (const nlohmann::json& entity_json : entities_json)
+        {
+            EXPECT_FALSE(writer.IsComplete());
+            ASSERT_TRUE(writer.WriteRecord(entity_json));
+        }
+        EXPECT_TRUE(writer.IsComplete());
+    }
+
+    // Names are written once, so the snapshot is much smaller than the JSON
+    size_t snapshot_size = stream.str().size();
+    EXPECT_LT(snapshot_size * 2, json_data.dump().size());
+
+    // MessagePack writes the names in every record
+    size_t msgpack_size = 0;
+    for (const nlohmann::json& entity_json : entities_json)
+        msgpack_size += nlohmann::json::to_msgpack(entity_json).size();
+    EXPECT_LT(snapshot_size * 2, msgpack_size);
+
+    // Read records one at a time
+    mono_entity_archive_service::SnapshotReader reader(stream);
+    ASSERT_TRUE(reader.IsValid());
+    EXPECT_EQ(reader.GetContent(), mono_entity_archive_service::SnapshotContent::Entities);
+    EXPECT_EQ(reader.GetRecordCount(), ENTITY_COUNT);
+
+    size_t record_index = 0;
+    nlohmann::json record;
+    while (reader.HasNextRecord())
+    {
+        ASSERT_TRUE(reader.ReadRecord(record));
+        EXPECT_EQ(record, entities_json[record_index]);
+        ++record_index;
+    }
+    EXPECT_EQ(record_index, ENTITY_COUNT);
+    EXPECT_FALSE(reader.ReadRecord(record));
+}
+
+TEST(EntityArchiveSnapshot, BrokenData)
+{
+    nlohmann::json json_data = entity_archive_snapshot_test::CreateEntitiesJSON(4);
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    ASSERT_TRUE(mono_entity_archive_service::ConvertJSONToSnapshot(json_data, stream));
+    const std::string snapshot = stream.str();
+
+    // Not a snapshot
+    {
+        std::stringstream broken_stream(json_data.dump(), std::ios::in | std::ios::binary);
+        mono_entity_archive_service::SnapshotReader reader(broken_stream);
+        EXPECT_FALSE(reader.IsValid());
+    }
+
+    // Unsupported version
+    {
+        std::string broken_snapshot = snapshot;
+        broken_snapshot[4] = static_cast<char>(mono_entity_archive_service::SNAPSHOT_VERSION + 1);
+        std::stringstream broken_stream(broken_snapshot, std::ios::in | std::ios::binary);
+
+        nlohmann::json converted_json;
+        EXPECT_FALSE(mono_entity_archive_service::ConvertSnapshotToJSON(broken_stream, converted_json));
+    }
+
+    // Broken record which still decodes, only the checksum catches it
+    {
+        std::string broken_snapshot = snapshot;
+        size_t name_offset = broken_snapshot.find("Entity 2");
+        ASSERT_NE(name_offset, std::string::npos);
+        broken_snapshot[name_offset + 7] = '3';
+        std::stringstream broken_stream(broken_snapshot, std::ios::in | std::ios::binary);
+
+        nlohmann::json converted_json;
+        EXPECT_FALSE(mono_entity_archive_service::ConvertSnapshotToJSON(broken_stream, converted_json));
+    }
+
+    // Broken checksum
+    {
+        std::string broken_snapshot = snapshot;
+        broken_snapshot.back() = static_cast<char>(broken_snapshot.back() ^ 0x01);
+        std::stringstream broken_stream(broken_snapshot, std::ios::in | std::ios::binary);
+
+        nlohmann::json converted_json;
+        EXPECT_FALSE(mono_entity_archive_service::ConvertSnapshotToJSON(broken_stream, converted_json));
+    }
+
+    // Truncated at every position
+    for (size_t size = 0; size < snapshot.size(); ++size)
+    {
+        std::stringstream broken_stream(snapshot.substr(0, size), std::ios::in | std::ios::binary);
+
+        nlohmann::json converted_json;
+        EXPECT_FALSE(mono_entity_archive_service::ConvertSnapshotToJSON(broken_stream, converted_json)) << size;
+    }
+}
+
+TEST(EntityArchiveSnapshot, MaxNameSize)
+{
+    // The longest name is written and read back
+    nlohmann::json record;
+    record[std::string(mono_entity_archive_service::SNAPSHOT_MAX_NAME_SIZE, 'a')] = 1;
+    {
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        mono_entity_archive_service::SnapshotWriter writer(
+            stream, mono_entity_archive_service::SnapshotContent::Entities, 1);
+        ASSERT_TRUE(writer.WriteRecord(record));
+
+        mono_entity_archive_service::SnapshotReader reader(stream);
+        ASSERT_TRUE(reader.IsValid());
+
+        nlohmann::json read_record;
+        ASSERT_TRUE(reader.ReadRecord(read_record));
+        EXPECT_EQ(read_record, record);
+    }
+
+    // A longer name is rejected by the writer, as the reader would reject it
+    record = nlohmann::json::object();
+    record[std::string(mono_entity_archive_service::SNAPSHOT_MAX_NAME_SIZE + 1, 'a')] = 1;
+    {
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        mono_entity_archive_service::SnapshotWriter writer(
+            stream, mono_entity_archive_service::SnapshotContent::Entities, 1);
+        EXPECT_FALSE(writer.WriteRecord(record));
+        EXPECT_FALSE(writer.IsComplete());
+    }
+}
+
+TEST(EntityArchiveSnapshot, ExportMatchesJSON)
+{
+    // Create component id generator
+    std::unique_ptr<ecs::ComponentIDGenerator> component_id_generator
+        = std::make_unique<ecs::ComponentIDGenerator>();
+
+    // Create service id generator
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+
+    // Create service registry
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+
+    // Import entity archive service in to registry
+    constexpr mono_service::ServiceThreadAffinityID ENTITY_ARCHIVE_SERVICE_THREAD_AFFINITY_ID = 0;
+    {
+        mono_entity_archive_service::EntityArchiveService::SetupParam entity_archive_service_setup_param;
+
+        component_editor::ComponentNameMap& component_name_map = entity_archive_service_setup_param.component_name_map;
+        component_name_map[component_editor_test::TestMetaComponentHandle::ID()]
+            = "component_editor_test::TestMetaComponent";
+        component_name_map[component_editor_test::TestTransformComponentHandle::ID()]
+            = "component_editor_test::TestTransformComponent";
+
+        component_editor::ComponentAdderMap& component_adder_map = entity_archive_service_setup_param.component_adder_map;
+        component_adder_map[component_editor_test::TestMetaComponentHandle::ID()]
+            = std::make_unique<component_editor_test::TestMetaComponentAdder>();
+        component_adder_map[component_editor_test::TestTransformComponentHandle::ID()]
+            = std::make_unique<component_editor_test::TestTransformComponentAdder>();
+
+        entity_archive_service_setup_param.component_reflection_registry
+            = component_editor_test::g_component_reflection_registry;
+        entity_archive_service_setup_param.setup_param_field_value_setter
+            = component_editor_test::g_setup_param_field_value_setter;
+        entity_archive_service_setup_param.setup_param_field_type_registry_
+            = component_editor_test::g_setup_param_field_type_registry;
+
+        bool result = mono_service::ImportService<
+            mono_entity_archive_service::EntityArchiveService,
+            mono_entity_archive_service::EntityArchiveServiceHandle>(
+                *service_registry, ENTITY_ARCHIVE_SERVICE_THREAD_AFFINITY_ID,
+                entity_archive_service_setup_param);
+        ASSERT_TRUE(result);
+    }
+
+    // Create entity archive service proxy
+    std::unique_ptr<mono_service::ServiceProxy> entity_archive_service_proxy = nullptr;
+    service_registry->WithUniqueLock([&](const mono_service::ServiceRegistry& registry)
+    {
+        mono_service::Service& service = registry.Get(
+            mono_entity_archive_service::EntityArchiveServiceHandle::ID());
+        entity_archive_service_proxy = service.CreateServiceProxy();
+    });
+    ASSERT_NE(entity_archive_service_proxy, nullptr);
+
+    // Create service proxy manager
+    std::unique_ptr<mono_service::ServiceProxyRegistry> service_registry_proxy
+        = std::make_unique<mono_service::ServiceProxyRegistry>();
+    std::unique_ptr<mono_service::ServiceProxyManager> service_proxy_manager
+        = std::make_unique<mono_service::ServiceProxyManager>(*service_registry_proxy);
+
+    // Add setup params of entities
+    constexpr uint32_t ENTITY_COUNT = 32;
+    std::vector<ecs::Entity> entities;
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list
+            = entity_archive_service_proxy->CreateCommandList();
+        mono_entity_archive_service::EntityArchiveServiceCommandList* entity_archive_command_list
+            = dynamic_cast<mono_entity_archive_service::EntityArchiveServiceCommandList*>(command_list.get());
+        ASSERT_NE(entity_archive_command_list, nullptr);
+
+        for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+        {
+            ecs::Entity entity(i, 0);
+            entities.push_back(entity);
+
+            std::unique_ptr<component_editor_test::TestMetaComponent::SetupParam> meta_setup_param
+                = std::make_unique<component_editor_test::TestMetaComponent::SetupParam>();
+            meta_setup_param->name = "Entity " + std::to_string(i);
+            meta_setup_param->active_self = (i % 2) == 0;
+            meta_setup_param->tag = i;
+
+            std::unique_ptr<component_editor_test::TestTransformComponent::SetupParam> transform_setup_param
+                = std::make_unique<component_editor_test::TestTransformComponent::SetupParam>();
+            transform_setup_param->position = DirectX::XMFLOAT3(i * 0.1f, i * -0.2f, i * 0.3f);
+
+            entity_archive_command_list->AddSetupParam(
+                entity, component_editor_test::TestMetaComponentHandle::ID(), std::move(meta_setup_param));
+            entity_archive_command_list->AddSetupParam(
+                entity, component_editor_test::TestTransformComponentHandle::ID(), std::move(transform_setup_param));
+        }
+
+        entity_archive_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    entity_archive_snapshot_test::UpdateService(*service_registry);
+
+    // Export setup params to JSON and snapshot
+    const std::string JSON_FILE_PATH = "output/snapshot_setup_params.json";
+    const std::string SNAPSHOT_FILE_PATH = "output/snapshot_setup_params.mfes";
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list
+            = entity_archive_service_proxy->CreateCommandList();
+        mono_entity_archive_service::EntityArchiveServiceCommandList* entity_archive_command_list
+            = dynamic_cast<mono_entity_archive_service::EntityArchiveServiceCommandList*>(command_list.get());
+        ASSERT_NE(entity_archive_command_list, nullptr);
+
+        entity_archive_command_list->ExportComponentSetupParamsToFile(
+            JSON_FILE_PATH, entities, *service_proxy_manager);
+        entity_archive_command_list->ExportComponentSetupParamsToSnapshot(
+            SNAPSHOT_FILE_PATH, entities, *service_proxy_manager);
+
+        entity_archive_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    entity_archive_snapshot_test::UpdateService(*service_registry);
+
+    // The snapshot holds the same values as the JSON
+    nlohmann::json exported_json;
+    {
+        std::ifstream input_file(JSON_FILE_PATH);
+        ASSERT_TRUE(input_file.is_open());
+        input_file >> exported_json;
+    }
+
+    nlohmann::json snapshot_json;
+    {
+        std::ifstream input_file(SNAPSHOT_FILE_PATH, std::ios::binary);
+        ASSERT_TRUE(input_file.is_open());
+        ASSERT_TRUE(mono_entity_archive_service::ConvertSnapshotToJSON(input_file, snapshot_json));
+    }
+
+    ASSERT_EQ(snapshot_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES].size(), ENTITY_COUNT);
+    EXPECT_EQ(snapshot_json, exported_json);
+
+    // The values import back to the same fields
+    const mono_entity_archive_service::ComponentSetupParamFieldTypeRegistry& registry
+        = component_editor_test::g_setup_param_field_type_registry;
+    for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        const nlohmann::json& meta_json
+            = snapshot_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES][i]["component_editor_test::TestMetaComponent"];
+        std::any name = registry.GetSetupParamFieldImportFunc("std::string")("name", meta_json["name"], *service_proxy_manager);
+        EXPECT_EQ(std::any_cast<std::string>(name), "Entity " + std::to_string(i));
+
+        const nlohmann::json& transform_json
+            = snapshot_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES][i]["component_editor_test::TestTransformComponent"];
+        std::any position = registry.GetSetupParamFieldImportFunc("DirectX::XMFLOAT3")(
+            "position", transform_json["position"], *service_proxy_manager);
+        EXPECT_EQ(std::any_cast<DirectX::XMFLOAT3>(position).z, i * 0.3f);
+    }
+}
+
+TEST(EntityArchiveSnapshot, Benchmark)
+{
+    constexpr size_t ENTITY_COUNT = 20000;
+    const std::string JSON_FILE_PATH = "output/snapshot_benchmark.json";
+    const std::string SNAPSHOT_FILE_PATH = "output/snapshot_benchmark.mfes";
+
+    // Write the same archive in both formats
+    size_t json_file_size = 0;
+    size_t snapshot_file_size = 0;
+    {
+        nlohmann::json json_data = entity_archive_snapshot_test::CreateEntitiesJSON(ENTITY_COUNT);
+
+        std::ofstream json_file(JSON_FILE_PATH);
+        ASSERT_TRUE(json_file.is_open());
+        std::string json_text = json_data.dump(4);
+        json_file << json_text;
+        json_file_size = json_text.size();
+
+        std::ofstream snapshot_file(SNAPSHOT_FILE_PATH, std::ios::binary);
+        ASSERT_TRUE(snapshot_file.is_open());
+        ASSERT_TRUE(mono_entity_archive_service::ConvertJSONToSnapshot(json_data, snapshot_file));
+        snapshot_file_size = static_cast<size_t>(snapshot_file.tellp());
+    }
+
+    // Load the JSON as ProjectIOSystem did, the whole archive is parsed before entities are created
+    size_t json_field_count = 0;
+    size_t json_estimated_memory = 0;
+    auto json_start = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream input_file(JSON_FILE_PATH);
+        ASSERT_TRUE(input_file.is_open());
+
+        nlohmann::json archive_json;
+        input_file >> archive_json;
+
+        for (const nlohmann::json& entity_json : archive_json[mono_entity_archive_service::EXPORT_TAG_ENTITIES])
+            json_field_count += entity_archive_snapshot_test::CountFields(entity_json);
+
+        json_estimated_memory = entity_archive_snapshot_test::EstimateJSONMemory(archive_json);
+    }
+    auto json_end = std::chrono::high_resolution_clock::now();
+
+    // Load the snapshot, one entity is held at a time
+    size_t snapshot_field_count = 0;
+    size_t snapshot_estimated_memory = 0;
+    auto snapshot_start = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream input_file(SNAPSHOT_FILE_PATH, std::ios::binary);
+        ASSERT_TRUE(input_file.is_open());
+
+        mono_entity_archive_service::SnapshotReader reader(input_file);
+        ASSERT_TRUE(reader.IsValid());
+
+        nlohmann::json entity_json;
+        while (reader.HasNextRecord())
+        {
+            ASSERT_TRUE(reader.ReadRecord(entity_json));
+            snapshot_field_count += entity_archive_snapshot_test::CountFields(entity_json);
+            snapshot_estimated_memory
+                = std::max(snapshot_estimated_memory, entity_archive_snapshot_test::EstimateJSONMemory(entity_json));
+        }
+    }
+    auto snapshot_end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_EQ(snapshot_field_count, json_field_count);
+    EXPECT_LT(snapshot_file_size, json_file_size);
+    EXPECT_LT(snapshot_estimated_memory, json_estimated_memory);
+
+    std::cout << "Entities: " << ENTITY_COUNT << std::endl;
+    std::cout << "JSON: " << json_file_size << " bytes, "
+        << std::chrono::duration<double, std::milli>(json_end - json_start).count() << " ms, "
+        << json_estimated_memory << " bytes decoded (estimated)" << std::endl;
+    std::cout << "Snapshot: " << snapshot_file_size << " bytes, "
+        << std::chrono::duration<double, std::milli>(snapshot_end - snapshot_start).count() << " ms, "
+        << snapshot_estimated_memory << " bytes decoded (estimated)" << std::endl;
+}
\ No newline at end of file
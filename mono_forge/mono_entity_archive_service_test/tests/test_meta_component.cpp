@@ -62,6 +62,16 @@ bool TestMetaComponentAdder::Add(
         entity, TestMetaComponentHandle::ID(), std::move(setup_param));
 }
 
+bool TestMetaComponentAdder::Add(
+    ecs::World& world, const ecs::Entity& entity,
+    std::unique_ptr<ecs::Component::SetupParam> setup_param,
+    mono_service::ServiceProxyManager& service_proxy_manager) const
+{
+    // Add component to the world with the given setup param
+    return world.AddComponent<TestMetaComponent>(
+        entity, TestMetaComponentHandle::ID(), std::move(setup_param));
+}
+
 std::unique_ptr<ecs::Component::SetupParam> TestMetaComponentAdder::GetSetupParam(
     mono_service::ServiceProxyManager& service_proxy_manager) const
 {
@@ -55,6 +55,18 @@ public:
     virtual ecs::ComponentID GetID() const override;
     virtual bool Apply(const ecs::Component::SetupParam& param) override;
 
+    // Get the name of the entity
+    std::string_view GetName() const { return name_; }
+
+    // Get whether the entity is active
+    bool IsActiveSelf() const { return active_self_; }
+
+    // Get the tag of the entity
+    uint64_t GetTag() const { return tag_; }
+
+    // Get the layer of the entity
+    uint64_t GetLayer() const { return layer_; }
+
 private:
     // The name of the entity
     std::string name_ = DEFAULT_NAME;
@@ -79,6 +91,10 @@ public:
     virtual bool Add(
         ecs::World& world, const ecs::Entity& entity,
         mono_service::ServiceProxyManager& service_proxy_manager) const override;
+    virtual bool Add(
+        ecs::World& world, const ecs::Entity& entity,
+        std::unique_ptr<ecs::Component::SetupParam> setup_param,
+        mono_service::ServiceProxyManager& service_proxy_manager) const override;
     virtual std::unique_ptr<ecs::Component::SetupParam> GetSetupParam(
         mono_service::ServiceProxyManager& service_proxy_manager) const override;
 };
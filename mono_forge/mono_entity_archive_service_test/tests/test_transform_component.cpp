@@ -59,6 +59,15 @@ bool TestTransformComponentAdder::Add(
     return world.AddComponent<TestTransformComponent>(entity, TestTransformComponentHandle::ID(), std::move(setup_param));
 }
 
+bool TestTransformComponentAdder::Add(
+    ecs::World& world, const ecs::Entity& entity,
+    std::unique_ptr<ecs::Component::SetupParam> setup_param,
+    mono_service::ServiceProxyManager& service_proxy_manager) const
+{
+    // Add component to the world with the given setup param
+    return world.AddComponent<TestTransformComponent>(entity, TestTransformComponentHandle::ID(), std::move(setup_param));
+}
+
 std::unique_ptr<ecs::Component::SetupParam> TestTransformComponentAdder::GetSetupParam(
     mono_service::ServiceProxyManager& service_proxy_manager) const
 {
@@ -46,6 +46,15 @@ public:
     virtual ecs::ComponentID GetID() const override;
     virtual bool Apply(const ecs::Component::SetupParam& param) override;
 
+    // Get the position of the Transform
+    const DirectX::XMFLOAT3& GetPosition() const { return position_; }
+
+    // Get the rotation of the Transform (degrees)
+    const DirectX::XMFLOAT3& GetRotation() const { return rotation_; }
+
+    // Get the scale of the Transform
+    const DirectX::XMFLOAT3& GetScale() const { return scale_; }
+
 private:
     // The position of the Transform
     DirectX::XMFLOAT3 position_ = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
@@ -67,6 +76,10 @@ public:
     virtual bool Add(
         ecs::World& world, const ecs::Entity& entity,
         mono_service::ServiceProxyManager& service_proxy_manager) const override;
+    virtual bool Add(
+        ecs::World& world, const ecs::Entity& entity,
+        std::unique_ptr<ecs::Component::SetupParam> setup_param,
+        mono_service::ServiceProxyManager& service_proxy_manager) const override;
     virtual std::unique_ptr<ecs::Component::SetupParam> GetSetupParam(
         mono_service::ServiceProxyManager& service_proxy_manager) const override;
 };
@@ -510,6 +510,7 @@ mono_entity_archive_service::ComponentSetupParamFieldTypeRegistrar g_mesh_set_fi
                         casted_value.vertex_buffer_handles = *mesh_asset->GetVertexBufferHandles();
                         casted_value.index_buffer_handles = *mesh_asset->GetIndexBufferHandles();
                         casted_value.index_counts = *mesh_asset->GetIndexCounts();
+                        casted_value.bounding_box = mesh_asset->GetBoundingBox();
 
                         ImGui::EndPopup();
                         return true; // Edited
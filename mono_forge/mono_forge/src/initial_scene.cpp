@@ -568,6 +568,7 @@ bool InitialScene::CreateEntities(ecs::World& world)
             param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
             param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
             param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();
+            param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
             
             std::vector<const render_graph::MaterialHandle*> material_handles;
             material_handles.resize(mesh_asset_ptr->GetIndexCounts()->size());
@@ -587,6 +588,7 @@ bool InitialScene::CreateEntities(ecs::World& world)
             param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
             param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
             param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();
+            param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
 
             std::vector<const render_graph::MaterialHandle*> archive_material_handles;
             archive_material_handles.resize(mesh_asset_ptr->GetIndexCounts()->size());
@@ -695,6 +697,7 @@ bool InitialScene::CreateEntities(ecs::World& world)
             param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
             param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
             param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();
+            param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
 
             std::vector<const render_graph::MaterialHandle*> material_handles;
             material_handles.resize(mesh_asset_ptr->GetIndexCounts()->size());
@@ -714,6 +717,7 @@ bool InitialScene::CreateEntities(ecs::World& world)
             param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
             param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
             param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();
+            param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
 
             std::vector<const render_graph::MaterialHandle*> archive_material_handles;
             archive_material_handles.resize(mesh_asset_ptr->GetIndexCounts()->size());
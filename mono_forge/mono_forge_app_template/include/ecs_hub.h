@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "ecs/include/system.h"
+#include "ecs/include/system_scheduler.h"
 #include "ecs/include/world.h"
 
 namespace mono_forge_app_template
@@ -38,6 +39,8 @@ public:
     void CreateWorld(std::unique_ptr<ecs::ComponentDescriptorRegistry> component_descriptor_registry);
 
     // Update systems in the given order
+    // Systems that declare non-conflicting component access run in parallel,
+    // conflicting systems keep the given order
     bool Update(const std::vector<ecs::SystemID>& update_order);
 
     // Get the ECS world
@@ -49,6 +52,12 @@ private:
 
     // The ECS world
     std::unique_ptr<ecs::World> ecs_world = nullptr;
+
+    // The scheduler that runs the system phases
+    std::unique_ptr<ecs::SystemScheduler> system_scheduler = nullptr;
+
+    // The update order the scheduler was built for
+    std::vector<ecs::SystemID> scheduled_order;
 };
 
 } // namespace mono_forge_app_template
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "mono_service/include/service_importer.h"
 #include "mono_service/include/thread_affinity.h"
 #include "mono_service/include/service_proxy_manager.h"
+#include "mono_service/include/service_thread_pool.h"
 
 namespace mono_forge_app_template
 {
@@ -77,6 +78,9 @@ private:
     std::vector<mono_service::ServiceHandleID> service_update_order;
 
     std::unique_ptr<mono_service::ServiceThreadAffinityIDGenerator> service_thread_affinity_id_generator = nullptr;
+
+    // The persistent worker threads, one for each thread affinity
+    std::unique_ptr<mono_service::ServiceThreadPool> service_thread_pool = nullptr;
 };
 
 } // namespace mono_forge_app_template
\ No newline at end of file
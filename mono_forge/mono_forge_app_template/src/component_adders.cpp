@@ -367,6 +367,7 @@ std::unique_ptr<ecs::Component::SetupParam> RenderableComponentAdder::GetSetupPa
     param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
     param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
     param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();
+    param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
 
     std::vector<const render_graph::MaterialHandle*> material_handles;
     material_handles.resize(mesh_asset_ptr->GetIndexCounts()->size());
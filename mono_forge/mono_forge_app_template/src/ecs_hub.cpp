@@ -6,11 +6,16 @@ namespace mono_forge_app_template
 
 ECSHub::ECSHub()
 {
+    // Create the scheduler, the calling thread works as one of the threads
+    // The worker threads are started once a system declares its access
+    unsigned int thread_count = std::thread::hardware_concurrency();
+    system_scheduler = std::make_unique<ecs::SystemScheduler>(thread_count > 1 ? thread_count - 1 : 0);
 }
 
 ECSHub::~ECSHub()
 {
     // Cleanup
+    system_scheduler.reset();
     ecs_world.reset();
     systems.clear();
 }
@@ -28,35 +33,29 @@ bool ECSHub::Update(const std::vector<ecs::SystemID>& update_order)
 {
     assert(ecs_world != nullptr && "ECS world is not created!");
 
-    for (const auto& system_id : update_order)
+    // Rebuild the dependency graph when the order changed
+    if (update_order != scheduled_order)
     {
-        // Get system
-        ecs::System& system = *systems.at(system_id);
+        std::vector<ecs::System*> ordered_systems;
+        ordered_systems.reserve(update_order.size());
+        for (const auto& system_id : update_order)
+            ordered_systems.push_back(systems.at(system_id).get());
 
-        // Pre-update
-        if (!system.PreUpdate(*ecs_world))
-            return false;
+        system_scheduler->Build(ordered_systems);
+        scheduled_order = update_order;
     }
 
-    for (const auto& system_id : update_order)
-    {
-        // Get system
-        ecs::System& system = *systems.at(system_id);
+    // Pre-update
+    if (!system_scheduler->Run(ecs::SystemPhase::PreUpdate, *ecs_world))
+        return false;
 
-        // Update
-        if (!system.Update(*ecs_world))
-            return false;
-    }
+    // Update
+    if (!system_scheduler->Run(ecs::SystemPhase::Update, *ecs_world))
+        return false;
 
-    for (const auto& system_id : update_order)
-    {
-        // Get system
-        ecs::System& system = *systems.at(system_id);
-
-        // Post-update
-        if (!system.PostUpdate(*ecs_world))
-            return false;
-    }
+    // Post-update
+    if (!system_scheduler->Run(ecs::SystemPhase::PostUpdate, *ecs_world))
+        return false;
 
     return true; // Success
 }
@@ -4,70 +4,6 @@
 namespace mono_forge_app_template
 {
 
-// bool(Service&)
-using ServiceUpdateFunc = std::function<bool(mono_service::Service&)>;
-
-// Helper function to perform parallel service updates
-bool ParallelServiceUpdate(
-    std::vector<mono_service::ServiceHandleID>& service_update_order,
-    mono_service::ServiceRegistry& registry, ServiceUpdateFunc update_func)
-{
-    // Map to hold futures for service updates
-    std::unordered_map<mono_service::ServiceThreadAffinityID, std::future<bool>> service_update_futures;
-    bool service_update_result = true;
-
-    for (const auto& service_id : service_update_order)
-    {
-        // Get service
-        mono_service::Service& service = registry.Get(service_id);
-
-        // Get thread affinity ID
-        mono_service::ServiceThreadAffinityID thread_affinity_id = service.GetThreadAffinityID();
-
-        if (thread_affinity_id == MainThreadAffinityHandle::ID())
-        {
-            // Main thread affinity, execute directly
-            if (!update_func(service))
-                service_update_result = false;
-            continue; // Skip to next service
-        }
-
-        if (service_update_futures.find(thread_affinity_id) == service_update_futures.end())
-        {
-            // No existing future for this thread affinity, create one
-            service_update_futures[thread_affinity_id] = std::async(std::launch::async, [&service, &update_func]() -> bool
-            {
-                return update_func(service);
-            });
-        }
-        else // Existing future for this thread affinity
-        {
-            // Get previous future
-            std::future<bool>& previous_future = service_update_futures[thread_affinity_id];
-
-            // Wait for previous update to complete
-            if (!previous_future.get())
-                service_update_result = false;
-
-            // Create new future for current update
-            service_update_futures[thread_affinity_id] = std::async(std::launch::async, [&service, &update_func]() -> bool
-            {
-                return update_func(service);
-            });
-        }
-    }
-
-    // Iterate through all futures
-    for (auto& [thread_affinity_id, future] : service_update_futures)
-    {
-        // Wait for update to complete
-        if (!future.get())
-            service_update_result = false;
-    }
-
-    return service_update_result;
-}
-
 ServiceHub::ServiceHub()
 {
     // Create service id generator
@@ -84,11 +20,15 @@ ServiceHub::ServiceHub()
 
     // Create service thread affinity ID generator
     service_thread_affinity_id_generator = std::make_unique<mono_service::ServiceThreadAffinityIDGenerator>();
+
+    // Create service thread pool, its workers are created when services of each thread affinity are updated
+    service_thread_pool = std::make_unique<mono_service::ServiceThreadPool>(MainThreadAffinityHandle::ID());
 }
 
 ServiceHub::~ServiceHub()
 {
     // Cleanup
+    service_thread_pool.reset();
     service_proxy_manager.reset();
     service_proxy_registry.reset();
     service_registry.reset();
@@ -100,24 +40,24 @@ bool ServiceHub::Update()
     bool service_update_result = true;
     service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
     {
-        ParallelServiceUpdate(
-            service_update_order, registry,
+        service_thread_pool->RunPhase(
+            registry, service_update_order,
             [&](mono_service::Service& service) -> bool
             {
                 // Pre-update
                 return service.PreUpdate();
             });
 
-        ParallelServiceUpdate(
-            service_update_order, registry,
+        service_thread_pool->RunPhase(
+            registry, service_update_order,
             [&](mono_service::Service& service) -> bool
             {
                 // Update
                 return service.Update();
             });
 
-        ParallelServiceUpdate(
-            service_update_order, registry,
+        service_thread_pool->RunPhase(
+            registry, service_update_order,
             [&](mono_service::Service& service) -> bool
             {
                 // Post-update
@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include <stdint.h>
+#include <string_view>
+#include <memory>
+
+#include "class_template/non_copy.h"
+
+#include "mono_forge_model/include/dll_config.h"
+
+namespace mono_forge_model
+{
+
+// Read-only memory mapping of a whole file
+// The mapped view stays valid while the MappedFile is alive
+class MONO_FORGE_MODEL_DLL MappedFile :
+    public class_template::NonCopyable
+{
+public:
+    ~MappedFile();
+
+    // Map the file, return nullptr if it cannot be opened or is empty
+    static std::unique_ptr<MappedFile> Open(std::string_view file_path);
+
+    // Get the mapped data
+    const uint8_t* GetData() const { return data_; }
+
+    // Get the size of the mapped data
+    size_t GetSize() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    // The mapped view
+    const uint8_t* data_ = nullptr;
+
+    // The size of the mapped view
+    size_t size_ = 0;
+
+    // Platform handles of the file and the mapping
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+};
+
+} // namespace mono_forge_model
\ No newline at end of file
@@ -3,50 +3,137 @@
 #include <stdint.h>
 #include <string_view>
 #include <memory>
+#include <vector>
 
 #include "mono_forge_model/include/dll_config.h"
 #include "mono_forge_model/include/mfm_layout.h"
+#include "mono_forge_model/include/mapped_file.h"
 
 namespace mono_forge_model
 {
 
+// Read-only view of an element array inside MFM data
+struct MFMDataSpan
+{
+    const uint8_t* data = nullptr; // Pointer to the first element
+    uint32_t element_size = 0; // Size of an element
+    uint32_t count = 0; // Number of elements
+
+    // Get the size of the array in bytes
+    size_t GetByteSize() const { return static_cast<size_t>(element_size) * count; }
+
+    // Check if the array has no elements
+    bool IsEmpty() const { return count == 0; }
+};
+
+// MFM data reader for layout version 1 and 2
+// All offsets are validated once when the data is set, so the getters never read outside of it
+// Meshes are kept in a directory table, so random access to a mesh is O(1) for both versions
 class MONO_FORGE_MODEL_DLL MFM
 {
 public:
-    // Construct with mfm file data
+    // Construct with mfm file data, the data must be valid
+    // Use Create to load data which may be corrupted
     MFM(std::unique_ptr<uint8_t[]> data, uint32_t data_size);
     ~MFM() = default;
 
+    // Create with mfm file data, return nullptr if the data is corrupted or truncated
+    static std::unique_ptr<MFM> Create(std::unique_ptr<uint8_t[]> data, uint32_t data_size);
+
+    // Create by memory mapping the mfm file, the vertex and index data are read without copies
+    // Return nullptr if the file cannot be mapped or is corrupted or truncated
+    static std::unique_ptr<MFM> Open(std::string_view file_path);
+
+    // Get the layout version
+    uint16_t GetVersion() const { return version_; }
+
     // Get MFM file header
     const MFMFileHeader* GetFileHeader() const;
 
-    // Get MFM info header
+    // Get MFM info header, nullptr if it is not version 1
     const MFMInfoHeader* GetInfoHeader() const;
 
-    // Get MFM mesh header
+    // Get MFM mesh header, nullptr if it is not version 1
     const MFMMeshHeader* GetMeshHeader() const;
 
-    // Get MFM custom header
+    // Get MFM version 2 header, nullptr if it is not version 2
+    const MFMHeaderV2* GetHeaderV2() const;
+
+    // Get MFM custom header, nullptr if there is none
     const MFMCustomHeader* GetCustomHeader() const;
 
-    // Get mesh node by index
+    // Get mesh node by index, nullptr if it is not version 1
     const MFMMeshNode* GetMeshNode(uint32_t material_index) const;
 
+    // Get the number of meshes
+    uint32_t GetMeshCount() const { return static_cast<uint32_t>(mesh_entries_.size()); }
+
+    // Get the mesh directory entry by index, version 1 mesh nodes are converted to entries
+    const MFMMeshEntry& GetMeshEntry(uint32_t material_index) const;
+
+    // Get the bounds of all meshes
+    const MFMBounds& GetBounds() const { return bounds_; }
+
     // Get material name
+    // It is null terminated in version 2, use GetMaterialNameView for version 1
     const char* GetMaterialName(uint32_t material_index) const;
 
+    // Get material name with its size
+    std::string_view GetMaterialNameView(uint32_t material_index) const;
+
     // Get pointer to vertex data
     const uint8_t* GetVertexData(uint32_t material_index) const;
 
     // Get pointer to index data
     const uint8_t* GetIndexData(uint32_t material_index) const;
 
+    // Get vertex data as a span
+    MFMDataSpan GetVertexSpan(uint32_t material_index) const;
+
+    // Get index data as a span
+    MFMDataSpan GetIndexSpan(uint32_t material_index) const;
+
 private:
-    // MFM file data buffer
-    const std::unique_ptr<uint8_t[]> data_;
+    MFM() = default;
+
+    // Validate the data and build the mesh directory, return false if it is corrupted or truncated
+    bool Parse();
+
+    // Parse version 1 data within the given size
+    bool ParseV1(uint32_t file_size);
+
+    // Parse version 2 data within the given size
+    bool ParseV2(uint32_t file_size);
+
+    // Validate the custom header range
+    bool ParseCustomHeader(uint32_t offset, uint32_t size, uint32_t file_size);
+
+    // MFM file data buffer, null if the data is memory mapped
+    std::unique_ptr<uint8_t[]> owned_data_ = nullptr;
+
+    // Memory mapped MFM file, null if the data is owned
+    std::unique_ptr<MappedFile> mapped_file_ = nullptr;
+
+    // MFM file data
+    const uint8_t* data_ = nullptr;
     
     // MFM file data size
-    const uint32_t data_size_;
+    uint32_t data_size_ = 0;
+
+    // Layout version
+    uint16_t version_ = 0;
+
+    // Offset to the custom header, 0 if there is none
+    uint32_t custom_header_offset_ = 0;
+
+    // Mesh directory
+    std::vector<MFMMeshEntry> mesh_entries_;
+
+    // Offsets to the version 1 mesh nodes
+    std::vector<uint32_t> mesh_node_offsets_;
+
+    // Bounds of all meshes
+    MFMBounds bounds_;
 };
 
 } // namespace mono_forge_model
\ No newline at end of file
@@ -5,14 +5,28 @@
 namespace mono_forge_model
 {
 
+// File type identifier (ASCII code of 'MF')
+constexpr uint16_t MFM_FILE_TYPE = 0x4D46;
+
+// Content types, they also select the layout version
+constexpr uint16_t MFM_CONTENT_TYPE_MESH = 0x0001; // Version 1, mesh nodes linked from the mesh header
+constexpr uint16_t MFM_CONTENT_TYPE_MESH_TABLE = 0x0002; // Version 2, mesh entries in a directory table
+
+// Layout versions
+constexpr uint16_t MFM_VERSION_1 = 1;
+constexpr uint16_t MFM_VERSION_2 = 2;
+
+// The alignment of the mesh directory, vertex data and index data in version 2
+constexpr uint32_t MFM_V2_ALIGNMENT = 16;
+
 #pragma pack(push, 1)
 
 // File header structure
 struct MFMFileHeader
 {
-    uint16_t file_type = 0x4D46; // File type identifier (ASCII code of 'MF')
+    uint16_t file_type = MFM_FILE_TYPE; // File type identifier (ASCII code of 'MF')
     uint32_t file_size = 0; // File size (total of file header + info header + mesh data chunks)
-    uint16_t content_type = 0x0001; // Content type (0x0001: mesh only)
+    uint16_t content_type = MFM_CONTENT_TYPE_MESH; // Content type (0x0001: mesh only, 0x0002: mesh table)
 };
 
 // Information header structure
@@ -58,6 +72,47 @@ struct MFMMeshNode
     uint32_t index_count = 0; // Number of indices
 };
 
+// Axis aligned bounding box in the model space
+struct MFMBounds
+{
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+// Version 2 header, it follows the file header when the content type is MFM_CONTENT_TYPE_MESH_TABLE
+// Layout: file header, version 2 header, mesh directory, custom header, material names, then
+// vertex and index data of each mesh. The directory and every data block start at a multiple of the alignment
+struct MFMHeaderV2
+{
+    uint16_t version = MFM_VERSION_2; // Layout version
+    uint16_t alignment = MFM_V2_ALIGNMENT; // Alignment of the directory and data blocks
+
+    uint32_t mesh_count = 0; // Number of mesh entries in the directory
+    uint32_t mesh_directory_offset = 0; // Offset to the mesh directory
+    uint32_t mesh_entry_size = 0; // Size of a mesh entry, larger entries are allowed for future extensions
+
+    uint32_t custom_header_offset = 0; // Offset to the custom header
+    uint32_t custom_header_size = 0; // Size of the custom header, 0 if there is none
+
+    MFMBounds bounds; // Bounds of all meshes
+};
+
+// Version 2 mesh directory entry
+struct MFMMeshEntry
+{
+    uint32_t material_name_offset = 0; // Offset to the material name, it is followed by a null terminator
+    uint32_t material_name_size = 0; // Size of the material name without the null terminator
+
+    uint32_t vertex_offset = 0; // Offset to vertex data
+    uint32_t vertex_size = 0; // Size of a vertex, the vertex starts with a float3 position
+    uint32_t vertex_count = 0; // Number of vertices
+
+    uint32_t index_offset = 0; // Offset to index data
+    uint32_t index_size = 0; // Size of an index (2 or 4)
+    uint32_t index_count = 0; // Number of indices
+
+    MFMBounds bounds; // Bounds of the vertex positions
+};
 
 #pragma pack(pop)
 
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <stdint.h>
+#include <string_view>
+#include <memory>
+#include <vector>
+
+#include "mono_forge_model/include/dll_config.h"
+#include "mono_forge_model/include/mfm_layout.h"
+
+namespace mono_forge_model
+{
+
+// Source data of a mesh written to MFM
+struct MFMMeshSource
+{
+    std::string_view material_name; // Material name
+
+    const uint8_t* vertex_data = nullptr; // Vertex data, every vertex starts with a float3 position
+    uint32_t vertex_size = 0; // Size of a vertex
+    uint32_t vertex_count = 0; // Number of vertices
+
+    const uint8_t* index_data = nullptr; // Index data
+    uint32_t index_size = sizeof(uint32_t); // Size of an index (2 or 4)
+    uint32_t index_count = 0; // Number of indices
+};
+
+// Write the meshes as MFM version 2 data, the mesh bounds are computed from the vertex positions
+// Return nullptr if the data does not fit in the 32 bit offsets
+MONO_FORGE_MODEL_DLL std::unique_ptr<uint8_t[]> WriteMFM(
+    const std::vector<MFMMeshSource>& meshes, uint32_t& rt_data_size,
+    const MFMCustomHeader& custom_header = MFMCustomHeader());
+
+} // namespace mono_forge_model
\ No newline at end of file
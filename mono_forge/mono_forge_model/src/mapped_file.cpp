@@ -0,0 +1,94 @@
+﻿#include "mono_forge_model/src/pch.h"
+#include "mono_forge_model/include/mapped_file.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mono_forge_model
+{
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+
+    if (mapping_handle_ != nullptr)
+        CloseHandle(mapping_handle_);
+
+    if (file_handle_ != nullptr)
+        CloseHandle(file_handle_);
+#else
+    if (data_ != nullptr)
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+}
+
+std::unique_ptr<MappedFile> MappedFile::Open(std::string_view file_path)
+{
+    // Make sure the path is null terminated
+    const std::string path(file_path);
+
+    // Cannot use make_unique because the constructor is private
+    std::unique_ptr<MappedFile> mapped_file(new MappedFile());
+
+#ifdef _WIN32
+    // Open the file for reading
+    HANDLE file_handle = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE)
+        return nullptr; // Failed to open the file
+    mapped_file->file_handle_ = file_handle;
+
+    // Get the file size, an empty file cannot be mapped
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+        return nullptr;
+
+    // Create the read-only mapping of the whole file
+    HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr)
+        return nullptr; // Failed to create the mapping
+    mapped_file->mapping_handle_ = mapping_handle;
+
+    // Map the view
+    void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+        return nullptr; // Failed to map the view
+
+    mapped_file->data_ = static_cast<const uint8_t*>(view);
+    mapped_file->size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    // Open the file for reading
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+        return nullptr; // Failed to open the file
+
+    // Get the file size, an empty file cannot be mapped
+    struct stat file_stat{};
+    if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close(file_descriptor);
+        return nullptr;
+    }
+
+    // Map the whole file, the mapping keeps its own reference so the descriptor can be closed
+    void* view = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    if (view == MAP_FAILED)
+        return nullptr; // Failed to map the file
+
+    mapped_file->data_ = static_cast<const uint8_t*>(view);
+    mapped_file->size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    return mapped_file;
+}
+
+} // namespace mono_forge_model
\ No newline at end of file
@@ -4,72 +4,449 @@
 namespace mono_forge_model
 {
 
+namespace
+{
+
+// Check if the range [offset, offset + size) is inside [0, limit)
+// It is computed in 64 bits so that offsets and sizes read from the file cannot overflow
+bool IsRangeInside(uint64_t offset, uint64_t size, uint64_t limit)
+{
+    return offset <= limit && size <= limit - offset;
+}
+
+// Check the minimum is not greater than the maximum on each axis, NaN is rejected
+bool IsBoundsValid(const MFMBounds& bounds)
+{
+    for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+        if (!(bounds.min[axis] <= bounds.max[axis]))
+            return false;
+    }
+
+    return true;
+}
+
+// Compute the bounds of the float3 positions at the beginning of each vertex
+// Version 1 data is not aligned, so the positions are copied out instead of being read in place
+MFMBounds ComputeBounds(const uint8_t* vertex_data, uint32_t vertex_size, uint32_t vertex_count)
+{
+    MFMBounds bounds;
+    for (uint32_t i = 0; i < vertex_count; ++i)
+    {
+        float position[3];
+        std::memcpy(position, vertex_data + static_cast<size_t>(i) * vertex_size, sizeof(position));
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            if (i == 0 || position[axis] < bounds.min[axis])
+                bounds.min[axis] = position[axis];
+
+            if (i == 0 || position[axis] > bounds.max[axis])
+                bounds.max[axis] = position[axis];
+        }
+    }
+
+    return bounds;
+}
+
+// Merge the bounds of a mesh into the bounds of the model
+void MergeBounds(MFMBounds& bounds, const MFMBounds& mesh_bounds, bool is_first)
+{
+    for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+        bounds.min[axis] = is_first ? mesh_bounds.min[axis] : std::min(bounds.min[axis], mesh_bounds.min[axis]);
+        bounds.max[axis] = is_first ? mesh_bounds.max[axis] : std::max(bounds.max[axis], mesh_bounds.max[axis]);
+    }
+}
+
+// Validate the ranges and element sizes of a mesh entry
+bool IsMeshEntryValid(const MFMMeshEntry& entry, uint32_t file_size)
+{
+    // Material name
+    if (!IsRangeInside(entry.material_name_offset, entry.material_name_size, file_size))
+        return false;
+
+    // Vertex data, every vertex starts with a float3 position
+    if (entry.vertex_count != 0 && entry.vertex_size < sizeof(float) * 3)
+        return false;
+
+    if (!IsRangeInside(
+        entry.vertex_offset, static_cast<uint64_t>(entry.vertex_size) * entry.vertex_count, file_size))
+        return false;
+
+    // Index data
+    if (entry.index_count != 0 && entry.index_size != sizeof(uint16_t) && entry.index_size != sizeof(uint32_t))
+        return false;
+
+    if (!IsRangeInside(
+        entry.index_offset, static_cast<uint64_t>(entry.index_size) * entry.index_count, file_size))
+        return false;
+
+    return true;
+}
+
+} // namespace
+
 MFM::MFM(std::unique_ptr<uint8_t[]> data, uint32_t data_size) :
-    data_(std::move(data)),
+    owned_data_(std::move(data)),
     data_size_(data_size)
 {
-    assert(data_ != nullptr && "MFM file data is null.");
+    assert(owned_data_ != nullptr && "MFM file data is null.");
     assert(data_size_ > 0 && "MFM file data size is zero.");
+    data_ = owned_data_.get();
+
+    bool result = Parse();
+    assert(result && "MFM file data is corrupted or truncated.");
+}
+
+std::unique_ptr<MFM> MFM::Create(std::unique_ptr<uint8_t[]> data, uint32_t data_size)
+{
+    if (data == nullptr || data_size == 0)
+        return nullptr;
+
+    // Cannot use make_unique because the constructor is private
+    std::unique_ptr<MFM> mfm(new MFM());
+    mfm->owned_data_ = std::move(data);
+    mfm->data_ = mfm->owned_data_.get();
+    mfm->data_size_ = data_size;
+
+    if (!mfm->Parse())
+        return nullptr; // Corrupted or truncated
+
+    return mfm;
+}
+
+std::unique_ptr<MFM> MFM::Open(std::string_view file_path)
+{
+    std::unique_ptr<MappedFile> mapped_file = MappedFile::Open(file_path);
+    if (mapped_file == nullptr)
+        return nullptr; // Failed to map the file
+
+    // The offsets in MFM are 32 bits
+    if (mapped_file->GetSize() > UINT32_MAX)
+        return nullptr;
+
+    // Cannot use make_unique because the constructor is private
+    std::unique_ptr<MFM> mfm(new MFM());
+    mfm->data_ = mapped_file->GetData();
+    mfm->data_size_ = static_cast<uint32_t>(mapped_file->GetSize());
+    mfm->mapped_file_ = std::move(mapped_file);
+
+    if (!mfm->Parse())
+        return nullptr; // Corrupted or truncated
+
+    return mfm;
 }
 
 const MFMFileHeader* MFM::GetFileHeader() const
 {
-    return reinterpret_cast<const MFMFileHeader*>(data_.get());
+    return reinterpret_cast<const MFMFileHeader*>(data_);
 }
 
 const MFMInfoHeader* MFM::GetInfoHeader() const
 {
-    return reinterpret_cast<const MFMInfoHeader*>(data_.get() + sizeof(MFMFileHeader));
+    if (version_ != MFM_VERSION_1)
+        return nullptr;
+
+    return reinterpret_cast<const MFMInfoHeader*>(data_ + sizeof(MFMFileHeader));
 }
 
 const MFMMeshHeader* MFM::GetMeshHeader() const
 {
     const MFMInfoHeader* info_header = GetInfoHeader();
-    return reinterpret_cast<const MFMMeshHeader*>(data_.get() + info_header->mesh_header_offset);
+    if (info_header == nullptr)
+        return nullptr;
+
+    return reinterpret_cast<const MFMMeshHeader*>(data_ + info_header->mesh_header_offset);
+}
+
+const MFMHeaderV2* MFM::GetHeaderV2() const
+{
+    if (version_ != MFM_VERSION_2)
+        return nullptr;
+
+    return reinterpret_cast<const MFMHeaderV2*>(data_ + sizeof(MFMFileHeader));
 }
 
 const MFMCustomHeader* MFM::GetCustomHeader() const
 {
-    const MFMInfoHeader* info_header = GetInfoHeader();
-    return reinterpret_cast<const MFMCustomHeader*>(data_.get() + info_header->custom_header_offset);
+    if (custom_header_offset_ == 0)
+        return nullptr;
+
+    return reinterpret_cast<const MFMCustomHeader*>(data_ + custom_header_offset_);
 }
 
 const MFMMeshNode* MFM::GetMeshNode(uint32_t material_index) const
 {
-    // Get mesh header
-    const MFMMeshHeader* mesh_header = GetMeshHeader();
+    if (version_ != MFM_VERSION_1)
+        return nullptr;
 
-    // Get mesh data offset
-    uint32_t offset = mesh_header->mesh_data_offset;
-
-    // Traverse to the specified mesh node
-    const MFMMeshNode* mesh_node = nullptr;
-    for (uint32_t i = 0; i <= material_index; ++i)
-    {
-        mesh_node = reinterpret_cast<const MFMMeshNode*>(data_.get() + offset);
-        offset += mesh_node->next_node_offset;
-    }
+    assert(material_index < mesh_node_offsets_.size() && "Material index is out of range.");
+    return reinterpret_cast<const MFMMeshNode*>(data_ + mesh_node_offsets_[material_index]);
+}
 
-    // Return the mesh node
-    return mesh_node;
+const MFMMeshEntry& MFM::GetMeshEntry(uint32_t material_index) const
+{
+    assert(material_index < mesh_entries_.size() && "Material index is out of range.");
+    return mesh_entries_[material_index];
 }
 
 const char* MFM::GetMaterialName(uint32_t material_index) const
 {
-    const MFMMeshNode* mesh_node = GetMeshNode(material_index);
-    return reinterpret_cast<const char*>(data_.get() + mesh_node->material_name_offset);
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+    return reinterpret_cast<const char*>(data_ + mesh_entry.material_name_offset);
+}
+
+std::string_view MFM::GetMaterialNameView(uint32_t material_index) const
+{
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+    return std::string_view(
+        reinterpret_cast<const char*>(data_ + mesh_entry.material_name_offset), mesh_entry.material_name_size);
 }
 
 const uint8_t* MFM::GetVertexData(uint32_t material_index) const
 {
-    const MFMMeshNode* mesh_node = GetMeshNode(material_index);
-    return data_.get() + mesh_node->vertex_offset;
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+    return data_ + mesh_entry.vertex_offset;
 }
 
 const uint8_t* MFM::GetIndexData(uint32_t material_index) const
 {
-    const MFMMeshNode* mesh_node = GetMeshNode(material_index);
-    return data_.get() + mesh_node->index_offset;
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+    return data_ + mesh_entry.index_offset;
+}
+
+MFMDataSpan MFM::GetVertexSpan(uint32_t material_index) const
+{
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+
+    MFMDataSpan span;
+    span.data = data_ + mesh_entry.vertex_offset;
+    span.element_size = mesh_entry.vertex_size;
+    span.count = mesh_entry.vertex_count;
+    return span;
+}
+
+MFMDataSpan MFM::GetIndexSpan(uint32_t material_index) const
+{
+    const MFMMeshEntry& mesh_entry = GetMeshEntry(material_index);
+
+    MFMDataSpan span;
+    span.data = data_ + mesh_entry.index_offset;
+    span.element_size = mesh_entry.index_size;
+    span.count = mesh_entry.index_count;
+    return span;
+}
+
+bool MFM::Parse()
+{
+    // File header
+    if (data_size_ < sizeof(MFMFileHeader))
+        return false;
+
+    const MFMFileHeader* file_header = GetFileHeader();
+    if (file_header->file_type != MFM_FILE_TYPE)
+        return false;
+
+    // The data is truncated if it is smaller than the recorded file size
+    // All following ranges are validated against the recorded file size
+    if (file_header->file_size < sizeof(MFMFileHeader) || file_header->file_size > data_size_)
+        return false;
+
+    // The content type selects the layout version
+    switch (file_header->content_type)
+    {
+    case MFM_CONTENT_TYPE_MESH:
+        return ParseV1(file_header->file_size);
+
+    case MFM_CONTENT_TYPE_MESH_TABLE:
+        return ParseV2(file_header->file_size);
+
+    default:
+        return false; // Unknown content type
+    }
+}
+
+bool MFM::ParseV1(uint32_t file_size)
+{
+    // Info header
+    if (!IsRangeInside(sizeof(MFMFileHeader), sizeof(MFMInfoHeader), file_size))
+        return false;
+
+    const MFMInfoHeader* info_header = reinterpret_cast<const MFMInfoHeader*>(data_ + sizeof(MFMFileHeader));
+
+    // Mesh header
+    if (info_header->mesh_header_size < sizeof(MFMMeshHeader) 
+        || !IsRangeInside(info_header->mesh_header_offset, info_header->mesh_header_size, file_size))
+        return false;
+
+    const MFMMeshHeader* mesh_header 
+        = reinterpret_cast<const MFMMeshHeader*>(data_ + info_header->mesh_header_offset);
+
+    // Custom header
+    if (!ParseCustomHeader(info_header->custom_header_offset, info_header->custom_header_size, file_size))
+        return false;
+
+    // Mesh data chunk
+    if (!IsRangeInside(mesh_header->mesh_data_offset, mesh_header->mesh_data_size, file_size))
+        return false;
+
+    const uint64_t mesh_data_begin = mesh_header->mesh_data_offset;
+    const uint64_t mesh_data_end = mesh_data_begin + mesh_header->mesh_data_size;
+
+    // Every mesh node needs its own space, so the count is limited by the chunk size
+    if (mesh_header->material_count > mesh_header->mesh_data_size / sizeof(MFMMeshNode))
+        return false;
+
+    mesh_entries_.clear();
+    mesh_entries_.reserve(mesh_header->material_count);
+    mesh_node_offsets_.clear();
+    mesh_node_offsets_.reserve(mesh_header->material_count);
+
+    // Walk the mesh nodes once and store them in the directory
+    uint64_t node_offset = mesh_data_begin;
+    for (uint32_t material_index = 0; material_index < mesh_header->material_count; ++material_index)
+    {
+        if (node_offset < mesh_data_begin || !IsRangeInside(node_offset, sizeof(MFMMeshNode), mesh_data_end))
+            return false;
+
+        const MFMMeshNode* mesh_node = reinterpret_cast<const MFMMeshNode*>(data_ + node_offset);
+
+        MFMMeshEntry mesh_entry;
+        mesh_entry.material_name_offset = mesh_node->material_name_offset;
+        mesh_entry.material_name_size = mesh_node->material_name_size;
+        mesh_entry.vertex_offset = mesh_node->vertex_offset;
+        mesh_entry.vertex_size = mesh_node->vertex_size;
+        mesh_entry.vertex_count = mesh_node->vertex_count;
+        mesh_entry.index_offset = mesh_node->index_offset;
+        mesh_entry.index_size = mesh_node->index_size;
+        mesh_entry.index_count = mesh_node->index_count;
+
+        if (!IsMeshEntryValid(mesh_entry, file_size))
+            return false;
+
+        // Version 1 has no bounds, compute them from the vertices
+        mesh_entry.bounds = ComputeBounds(
+            data_ + mesh_entry.vertex_offset, mesh_entry.vertex_size, mesh_entry.vertex_count);
+
+        mesh_entries_.push_back(mesh_entry);
+        mesh_node_offsets_.push_back(static_cast<uint32_t>(node_offset));
+
+        // The next node is at next_node_offset from this node
+        // The converter leaves it 0 and writes the next node right after the index data
+        const uint64_t next_node_offset = (mesh_node->next_node_offset != 0)
+            ? node_offset + mesh_node->next_node_offset
+            : static_cast<uint64_t>(mesh_entry.index_offset) 
+                + static_cast<uint64_t>(mesh_entry.index_size) * mesh_entry.index_count;
+
+        // The nodes must move forward, otherwise a corrupted file could alias them
+        if (next_node_offset < node_offset + sizeof(MFMMeshNode))
+        {
+            if (material_index + 1 < mesh_header->material_count)
+                return false;
+        }
+
+        node_offset = next_node_offset;
+    }
+
+    // Model bounds
+    bool is_first = true;
+    for (const MFMMeshEntry& mesh_entry : mesh_entries_)
+    {
+        if (mesh_entry.vertex_count == 0)
+            continue;
+
+        MergeBounds(bounds_, mesh_entry.bounds, is_first);
+        is_first = false;
+    }
+
+    version_ = MFM_VERSION_1;
+    return true;
+}
+
+bool MFM::ParseV2(uint32_t file_size)
+{
+    // Version 2 header
+    if (!IsRangeInside(sizeof(MFMFileHeader), sizeof(MFMHeaderV2), file_size))
+        return false;
+
+    const MFMHeaderV2* header = reinterpret_cast<const MFMHeaderV2*>(data_ + sizeof(MFMFileHeader));
+    if (header->version != MFM_VERSION_2)
+        return false;
+
+    // The alignment must be a power of two
+    const uint32_t alignment = header->alignment;
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        return false;
+
+    // Custom header
+    if (!ParseCustomHeader(header->custom_header_offset, header->custom_header_size, file_size))
+        return false;
+
+    // Mesh directory
+    if (header->mesh_entry_size < sizeof(MFMMeshEntry) || header->mesh_directory_offset % alignment != 0)
+        return false;
+
+    if (!IsRangeInside(
+        header->mesh_directory_offset, 
+        static_cast<uint64_t>(header->mesh_entry_size) * header->mesh_count, file_size))
+        return false;
+
+    if (!IsBoundsValid(header->bounds))
+        return false;
+
+    mesh_entries_.clear();
+    mesh_entries_.reserve(header->mesh_count);
+    mesh_node_offsets_.clear();
+
+    for (uint32_t material_index = 0; material_index < header->mesh_count; ++material_index)
+    {
+        // The entry may be larger than this version knows, only the known part is read
+        MFMMeshEntry mesh_entry;
+        std::memcpy(
+            &mesh_entry, 
+            data_ + header->mesh_directory_offset + static_cast<size_t>(header->mesh_entry_size) * material_index,
+            sizeof(MFMMeshEntry));
+
+        if (!IsMeshEntryValid(mesh_entry, file_size))
+            return false;
+
+        // The material name is followed by a null terminator
+        if (!IsRangeInside(mesh_entry.material_name_offset, mesh_entry.material_name_size + 1ull, file_size)
+            || data_[mesh_entry.material_name_offset + mesh_entry.material_name_size] != '\0')
+            return false;
+
+        // Vertex and index data must be aligned
+        if (mesh_entry.vertex_offset % alignment != 0 || mesh_entry.index_offset % alignment != 0)
+            return false;
+
+        if (!IsBoundsValid(mesh_entry.bounds))
+            return false;
+
+        mesh_entries_.push_back(mesh_entry);
+    }
+
+    bounds_ = header->bounds;
+    version_ = MFM_VERSION_2;
+    return true;
+}
+
+bool MFM::ParseCustomHeader(uint32_t offset, uint32_t size, uint32_t file_size)
+{
+    custom_header_offset_ = 0;
+    if (size == 0)
+        return true; // No custom header
+
+    if (size < sizeof(MFMCustomHeader) || offset == 0 || !IsRangeInside(offset, size, file_size))
+        return false;
+
+    const MFMCustomHeader* custom_header = reinterpret_cast<const MFMCustomHeader*>(data_ + offset);
+    if (custom_header->custom_data_size != 0 
+        && !IsRangeInside(custom_header->custom_data_offset, custom_header->custom_data_size, file_size))
+        return false;
+
+    custom_header_offset_ = offset;
+    return true;
 }
 
 } // namespace mono_forge_model
\ No newline at end of file
@@ -0,0 +1,168 @@
+﻿#include "mono_forge_model/src/pch.h"
+#include "mono_forge_model/include/mfm_writer.h"
+
+namespace mono_forge_model
+{
+
+namespace
+{
+
+// Round the offset up to the alignment
+uint64_t AlignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Write a value at the offset
+template <typename T>
+void WriteValue(uint8_t* buffer, uint64_t offset, const T& value)
+{
+    std::memcpy(buffer + offset, &value, sizeof(T));
+}
+
+} // namespace
+
+std::unique_ptr<uint8_t[]> WriteMFM(
+    const std::vector<MFMMeshSource>& meshes, uint32_t& rt_data_size, const MFMCustomHeader& custom_header)
+{
+    rt_data_size = 0;
+
+    // Compute the layout in 64 bits, so that too large data is detected instead of wrapping
+    MFMHeaderV2 header;
+    header.mesh_count = static_cast<uint32_t>(meshes.size());
+    header.mesh_entry_size = sizeof(MFMMeshEntry);
+
+    uint64_t offset = sizeof(MFMFileHeader) + sizeof(MFMHeaderV2);
+
+    // Mesh directory
+    offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+    const uint64_t mesh_directory_offset = offset;
+    offset += static_cast<uint64_t>(sizeof(MFMMeshEntry)) * meshes.size();
+
+    // Custom header
+    const uint64_t custom_header_offset = offset;
+    offset += sizeof(MFMCustomHeader);
+
+    // Material names with null terminators
+    std::vector<MFMMeshEntry> mesh_entries(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        mesh_entries[i].material_name_offset = static_cast<uint32_t>(offset);
+        mesh_entries[i].material_name_size = static_cast<uint32_t>(meshes[i].material_name.size());
+        offset += meshes[i].material_name.size() + 1;
+    }
+
+    // Vertex and index data
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MFMMeshSource& mesh = meshes[i];
+        assert(
+            (mesh.vertex_count == 0 || mesh.vertex_size >= sizeof(float) * 3) && 
+            "The vertex must start with a float3 position.");
+        assert(
+            (mesh.index_size == sizeof(uint16_t) || mesh.index_size == sizeof(uint32_t)) && 
+            "The index size must be 2 or 4.");
+
+        offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+        mesh_entries[i].vertex_offset = static_cast<uint32_t>(offset);
+        mesh_entries[i].vertex_size = mesh.vertex_size;
+        mesh_entries[i].vertex_count = mesh.vertex_count;
+        offset += static_cast<uint64_t>(mesh.vertex_size) * mesh.vertex_count;
+
+        offset = AlignOffset(offset, MFM_V2_ALIGNMENT);
+        mesh_entries[i].index_offset = static_cast<uint32_t>(offset);
+        mesh_entries[i].index_size = mesh.index_size;
+        mesh_entries[i].index_count = mesh.index_count;
+        offset += static_cast<uint64_t>(mesh.index_size) * mesh.index_count;
+
+        if (offset > UINT32_MAX)
+            return nullptr; // Too large for the 32 bit offsets
+    }
+
+    if (offset > UINT32_MAX)
+        return nullptr; // Too large for the 32 bit offsets
+
+    const uint32_t file_size = static_cast<uint32_t>(offset);
+
+    // Compute the bounds of each mesh and of the model
+    bool is_first = true;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MFMMeshSource& mesh = meshes[i];
+        MFMBounds& bounds = mesh_entries[i].bounds;
+        for (uint32_t vertex_index = 0; vertex_index < mesh.vertex_count; ++vertex_index)
+        {
+            float position[3];
+            std::memcpy(
+                position, mesh.vertex_data + static_cast<size_t>(vertex_index) * mesh.vertex_size, sizeof(position));
+
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                if (vertex_index == 0 || position[axis] < bounds.min[axis])
+                    bounds.min[axis] = position[axis];
+
+                if (vertex_index == 0 || position[axis] > bounds.max[axis])
+                    bounds.max[axis] = position[axis];
+            }
+        }
+
+        if (mesh.vertex_count == 0)
+            continue;
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            header.bounds.min[axis] = is_first ? bounds.min[axis] : std::min(header.bounds.min[axis], bounds.min[axis]);
+            header.bounds.max[axis] = is_first ? bounds.max[axis] : std::max(header.bounds.max[axis], bounds.max[axis]);
+        }
+        is_first = false;
+    }
+
+    // Headers
+    MFMFileHeader file_header;
+    file_header.file_size = file_size;
+    file_header.content_type = MFM_CONTENT_TYPE_MESH_TABLE;
+
+    header.mesh_directory_offset = static_cast<uint32_t>(mesh_directory_offset);
+    header.custom_header_offset = static_cast<uint32_t>(custom_header_offset);
+    header.custom_header_size = sizeof(MFMCustomHeader);
+
+    // Allocate zero initialized buffer, the padding stays zero
+    std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(file_size);
+
+    WriteValue(buffer.get(), 0, file_header);
+    WriteValue(buffer.get(), sizeof(MFMFileHeader), header);
+    WriteValue(buffer.get(), custom_header_offset, custom_header);
+
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const MFMMeshSource& mesh = meshes[i];
+        const MFMMeshEntry& mesh_entry = mesh_entries[i];
+
+        WriteValue(buffer.get(), mesh_directory_offset + sizeof(MFMMeshEntry) * i, mesh_entry);
+
+        if (!mesh.material_name.empty())
+        {
+            std::memcpy(
+                buffer.get() + mesh_entry.material_name_offset, mesh.material_name.data(), mesh.material_name.size());
+        }
+
+        if (mesh.vertex_count != 0)
+        {
+            std::memcpy(
+                buffer.get() + mesh_entry.vertex_offset, mesh.vertex_data, 
+                static_cast<size_t>(mesh.vertex_size) * mesh.vertex_count);
+        }
+
+        if (mesh.index_count != 0)
+        {
+            std::memcpy(
+                buffer.get() + mesh_entry.index_offset, mesh.index_data, 
+                static_cast<size_t>(mesh.index_size) * mesh.index_count);
+        }
+    }
+
+    rt_data_size = file_size;
+    return buffer;
+}
+
+} // namespace mono_forge_model
\ No newline at end of file
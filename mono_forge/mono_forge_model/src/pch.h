@@ -4,4 +4,7 @@
 #include <string>
 #include <string_view>
 #include <memory>
+#include <vector>
+#include <cstring>
+#include <algorithm>
 #include <cassert>
@@ -0,0 +1,529 @@
+﻿#include "mono_forge_model_test/pch.h"
+
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "mono_forge_model/include/mfm.h"
+#include "mono_forge_model/include/mfm_writer.h"
+#include "utility_header/file_loader.h"
+
+namespace mono_forge_model_test
+{
+
+constexpr const char* TEST_MFM_V1_FILE_PATH = "../resources/mono_forge_model/cube.mfm";
+
+// Same layout as geometry::Geometry::Vertex
+struct TestVertex
+{
+    float position[3];
+    float uv[2];
+    float normal[3];
+    float tangent[3];
+};
+
+// Synthetic mesh data
+struct TestMesh
+{
+    std::string material_name;
+    std::vector<TestVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Create a grid mesh with the given number of vertices
+TestMesh CreateTestMesh(uint32_t mesh_index, uint32_t vertex_count)
+{
+    TestMesh mesh;
+    mesh.material_name = "material_" + std::to_string(mesh_index);
+
+    mesh.vertices.resize(vertex_count);
+    for (uint32_t i = 0; i < vertex_count; ++i)
+    {
+        TestVertex& vertex = mesh.vertices[i];
+        vertex.position[0] = static_cast<float>(i % 256) + static_cast<float>(mesh_index);
+        vertex.position[1] = -static_cast<float>(i / 256);
+        vertex.position[2] = static_cast<float>(mesh_index) * 0.5f;
+        vertex.uv[0] = vertex.uv[1] = 0.0f;
+        vertex.normal[0] = vertex.normal[2] = 0.0f;
+        vertex.normal[1] = 1.0f;
+        vertex.tangent[0] = 1.0f;
+        vertex.tangent[1] = vertex.tangent[2] = 0.0f;
+    }
+
+    mesh.indices.resize(static_cast<size_t>(vertex_count) * 3);
+    for (size_t i = 0; i < mesh.indices.size(); ++i)
+        mesh.indices[i] = static_cast<uint32_t>((i * 7) % vertex_count);
+
+    return mesh;
+}
+
+// Write the meshes as MFM version 2 data
+std::unique_ptr<uint8_t[]> WriteTestMeshes(const std::vector<TestMesh>& meshes, uint32_t& rt_data_size)
+{
+    std::vector<mono_forge_model::MFMMeshSource> sources(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        sources[i].material_name = meshes[i].material_name;
+        sources[i].vertex_data = reinterpret_cast<const uint8_t*>(meshes[i].vertices.data());
+        sources[i].vertex_size = sizeof(TestVertex);
+        sources[i].vertex_count = static_cast<uint32_t>(meshes[i].vertices.size());
+        sources[i].index_data = reinterpret_cast<const uint8_t*>(meshes[i].indices.data());
+        sources[i].index_size = sizeof(uint32_t);
+        sources[i].index_count = static_cast<uint32_t>(meshes[i].indices.size());
+    }
+
+    return mono_forge_model::WriteMFM(sources, rt_data_size);
+}
+
+// Copy the data into a new buffer of the given size
+std::unique_ptr<uint8_t[]> CopyData(const uint8_t* data, uint32_t data_size)
+{
+    std::unique_ptr<uint8_t[]> copy = std::make_unique<uint8_t[]>(data_size);
+    std::memcpy(copy.get(), data, data_size);
+    return copy;
+}
+
+// Write the data to a file
+void WriteFile(const char* file_path, const uint8_t* data, uint32_t data_size)
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data), data_size);
+}
+
+// Load the version 1 test file
+std::unique_ptr<uint8_t[]> LoadV1File(uint32_t& rt_data_size)
+{
+    fpos_t file_size = 0;
+    std::unique_ptr<uint8_t[]> file_data = utility_header::LoadFile(TEST_MFM_V1_FILE_PATH, file_size);
+    rt_data_size = static_cast<uint32_t>(file_size);
+    return file_data;
+}
+
+// Check the meshes read from MFM match the source meshes
+void ExpectMeshesEqual(const mono_forge_model::MFM& mfm, const std::vector<TestMesh>& meshes)
+{
+    ASSERT_EQ(mfm.GetMeshCount(), meshes.size());
+    for (uint32_t i = 0; i < mfm.GetMeshCount(); ++i)
+    {
+        EXPECT_EQ(mfm.GetMaterialNameView(i), meshes[i].material_name);
+        EXPECT_STREQ(mfm.GetMaterialName(i), meshes[i].material_name.c_str());
+
+        mono_forge_model::MFMDataSpan vertex_span = mfm.GetVertexSpan(i);
+        ASSERT_EQ(vertex_span.count, meshes[i].vertices.size());
+        ASSERT_EQ(vertex_span.element_size, sizeof(TestVertex));
+        EXPECT_EQ(std::memcmp(vertex_span.data, meshes[i].vertices.data(), vertex_span.GetByteSize()), 0);
+
+        mono_forge_model::MFMDataSpan index_span = mfm.GetIndexSpan(i);
+        ASSERT_EQ(index_span.count, meshes[i].indices.size());
+        ASSERT_EQ(index_span.element_size, sizeof(uint32_t));
+        EXPECT_EQ(std::memcmp(index_span.data, meshes[i].indices.data(), index_span.GetByteSize()), 0);
+
+        // Spans are aligned in version 2
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(vertex_span.data) % mono_forge_model::MFM_V2_ALIGNMENT, 0u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(index_span.data) % mono_forge_model::MFM_V2_ALIGNMENT, 0u);
+    }
+}
+
+// Read one byte of every page of the vertex and index data, as an upload to the gpu would
+uint64_t TouchMeshData(const mono_forge_model::MFM& mfm)
+{
+    constexpr size_t PAGE_SIZE = 4096;
+
+    uint64_t checksum = 0;
+    for (uint32_t i = 0; i < mfm.GetMeshCount(); ++i)
+    {
+        mono_forge_model::MFMDataSpan vertex_span = mfm.GetVertexSpan(i);
+        for (size_t offset = 0; offset < vertex_span.GetByteSize(); offset += PAGE_SIZE)
+            checksum += vertex_span.data[offset];
+
+        mono_forge_model::MFMDataSpan index_span = mfm.GetIndexSpan(i);
+        for (size_t offset = 0; offset < index_span.GetByteSize(); offset += PAGE_SIZE)
+            checksum += index_span.data[offset];
+    }
+
+    return checksum;
+}
+
+} // namespace mono_forge_model_test
+
+TEST(MFMV2, WriteAndRead)
+{
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(0, 300));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(1, 17));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(2, 1000));
+
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::WriteTestMeshes(meshes, data_size);
+    ASSERT_NE(data, nullptr);
+
+    std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Create(std::move(data), data_size);
+    ASSERT_NE(mfm, nullptr);
+    EXPECT_EQ(mfm->GetVersion(), mono_forge_model::MFM_VERSION_2);
+    EXPECT_EQ(mfm->GetInfoHeader(), nullptr);
+    EXPECT_EQ(mfm->GetMeshHeader(), nullptr);
+    EXPECT_EQ(mfm->GetMeshNode(0), nullptr);
+    ASSERT_NE(mfm->GetHeaderV2(), nullptr);
+    ASSERT_NE(mfm->GetCustomHeader(), nullptr);
+    EXPECT_EQ(mfm->GetCustomHeader()->up_axis, 1u);
+
+    mono_forge_model_test::ExpectMeshesEqual(*mfm, meshes);
+
+    // Mesh bounds
+    const mono_forge_model::MFMBounds& bounds = mfm->GetMeshEntry(1).bounds;
+    EXPECT_FLOAT_EQ(bounds.min[0], 1.0f);
+    EXPECT_FLOAT_EQ(bounds.max[0], 17.0f);
+    EXPECT_FLOAT_EQ(bounds.min[1], 0.0f);
+    EXPECT_FLOAT_EQ(bounds.max[1], 0.0f);
+    EXPECT_FLOAT_EQ(bounds.min[2], 0.5f);
+    EXPECT_FLOAT_EQ(bounds.max[2], 0.5f);
+
+    // Model bounds
+    EXPECT_FLOAT_EQ(mfm->GetBounds().min[0], 0.0f);
+    EXPECT_FLOAT_EQ(mfm->GetBounds().max[0], 257.0f);
+    EXPECT_FLOAT_EQ(mfm->GetBounds().min[1], -3.0f);
+    EXPECT_FLOAT_EQ(mfm->GetBounds().max[2], 1.0f);
+}
+
+TEST(MFMV2, OpenMapped)
+{
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(0, 64));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(1, 128));
+
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::WriteTestMeshes(meshes, data_size);
+    ASSERT_NE(data, nullptr);
+
+    const char* file_path = "mfm_v2_open_mapped_test.mfm";
+    mono_forge_model_test::WriteFile(file_path, data.get(), data_size);
+
+    {
+        std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Open(file_path);
+        ASSERT_NE(mfm, nullptr);
+        EXPECT_EQ(mfm->GetVersion(), mono_forge_model::MFM_VERSION_2);
+        mono_forge_model_test::ExpectMeshesEqual(*mfm, meshes);
+    }
+
+    std::remove(file_path);
+
+    // Missing file
+    EXPECT_EQ(mono_forge_model::MFM::Open(file_path), nullptr);
+}
+
+TEST(MFMV2, ReadV1)
+{
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::LoadV1File(data_size);
+    ASSERT_NE(data, nullptr);
+
+    std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Create(std::move(data), data_size);
+    ASSERT_NE(mfm, nullptr);
+    EXPECT_EQ(mfm->GetVersion(), mono_forge_model::MFM_VERSION_1);
+    ASSERT_NE(mfm->GetMeshHeader(), nullptr);
+    EXPECT_EQ(mfm->GetHeaderV2(), nullptr);
+    ASSERT_EQ(mfm->GetMeshCount(), mfm->GetMeshHeader()->material_count);
+
+    for (uint32_t i = 0; i < mfm->GetMeshCount(); ++i)
+    {
+        const mono_forge_model::MFMMeshNode* mesh_node = mfm->GetMeshNode(i);
+        ASSERT_NE(mesh_node, nullptr);
+
+        mono_forge_model::MFMDataSpan vertex_span = mfm->GetVertexSpan(i);
+        EXPECT_EQ(vertex_span.count, mesh_node->vertex_count);
+        EXPECT_EQ(vertex_span.element_size, mesh_node->vertex_size);
+        EXPECT_EQ(vertex_span.data, mfm->GetVertexData(i));
+
+        mono_forge_model::MFMDataSpan index_span = mfm->GetIndexSpan(i);
+        EXPECT_EQ(index_span.count, mesh_node->index_count);
+        EXPECT_EQ(index_span.data, mfm->GetIndexData(i));
+
+        // Bounds are computed for version 1
+        const mono_forge_model::MFMBounds& bounds = mfm->GetMeshEntry(i).bounds;
+        for (uint32_t axis = 0; axis < 3; ++axis)
+            EXPECT_LT(bounds.min[axis], bounds.max[axis]);
+    }
+
+    // The same file can be memory mapped
+    std::unique_ptr<mono_forge_model::MFM> mapped_mfm 
+        = mono_forge_model::MFM::Open(mono_forge_model_test::TEST_MFM_V1_FILE_PATH);
+    ASSERT_NE(mapped_mfm, nullptr);
+    EXPECT_EQ(mapped_mfm->GetVersion(), mono_forge_model::MFM_VERSION_1);
+    EXPECT_EQ(mapped_mfm->GetMeshCount(), mfm->GetMeshCount());
+}
+
+TEST(MFMV2, Truncated)
+{
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(0, 8));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(1, 4));
+
+    uint32_t v2_size = 0;
+    std::unique_ptr<uint8_t[]> v2_data = mono_forge_model_test::WriteTestMeshes(meshes, v2_size);
+    ASSERT_NE(v2_data, nullptr);
+
+    uint32_t v1_size = 0;
+    std::unique_ptr<uint8_t[]> v1_data = mono_forge_model_test::LoadV1File(v1_size);
+    ASSERT_NE(v1_data, nullptr);
+
+    // Every truncated size is rejected
+    for (uint32_t size = 1; size < v2_size; ++size)
+    {
+        EXPECT_EQ(
+            mono_forge_model::MFM::Create(mono_forge_model_test::CopyData(v2_data.get(), size), size), nullptr) 
+            << "v2 size " << size;
+    }
+
+    for (uint32_t size = 1; size < v1_size; ++size)
+    {
+        EXPECT_EQ(
+            mono_forge_model::MFM::Create(mono_forge_model_test::CopyData(v1_data.get(), size), size), nullptr) 
+            << "v1 size " << size;
+    }
+
+    // The full data is accepted
+    EXPECT_NE(
+        mono_forge_model::MFM::Create(mono_forge_model_test::CopyData(v2_data.get(), v2_size), v2_size), nullptr);
+    EXPECT_NE(
+        mono_forge_model::MFM::Create(mono_forge_model_test::CopyData(v1_data.get(), v1_size), v1_size), nullptr);
+}
+
+TEST(MFMV2, Corrupted)
+{
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(0, 8));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(1, 4));
+
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::WriteTestMeshes(meshes, data_size);
+    ASSERT_NE(data, nullptr);
+
+    const uint32_t header_offset = sizeof(mono_forge_model::MFMFileHeader);
+    mono_forge_model::MFMHeaderV2 header;
+    std::memcpy(&header, data.get() + header_offset, sizeof(header));
+    const uint32_t entry_offset = header.mesh_directory_offset;
+
+    // Apply the corruption to a copy of the data and check it is rejected
+    auto expect_rejected = [&](const char* name, std::function<void(uint8_t*)> corrupt)
+    {
+        std::unique_ptr<uint8_t[]> copy = mono_forge_model_test::CopyData(data.get(), data_size);
+        corrupt(copy.get());
+        EXPECT_EQ(mono_forge_model::MFM::Create(std::move(copy), data_size), nullptr) << name;
+    };
+
+    // Write a value into the file header, the version 2 header or the first mesh entry
+    auto write_u32 = [](uint8_t* buffer, size_t offset, uint32_t value)
+    {
+        std::memcpy(buffer + offset, &value, sizeof(value));
+    };
+
+    expect_rejected("file type", [&](uint8_t* buffer) { buffer[0] = 'X'; });
+    expect_rejected("content type", [&](uint8_t* buffer) { buffer[6] = 0x7F; });
+    expect_rejected("file size", [&](uint8_t* buffer) { write_u32(buffer, 2, data_size + 1); });
+    expect_rejected("version", [&](uint8_t* buffer) { buffer[header_offset] = 3; });
+    expect_rejected("alignment", [&](uint8_t* buffer) { buffer[header_offset + 2] = 12; });
+
+    expect_rejected("mesh count", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, header_offset + offsetof(mono_forge_model::MFMHeaderV2, mesh_count), UINT32_MAX);
+    });
+
+    expect_rejected("directory offset", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, header_offset + offsetof(mono_forge_model::MFMHeaderV2, mesh_directory_offset), data_size);
+    });
+
+    expect_rejected("entry size", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, header_offset + offsetof(mono_forge_model::MFMHeaderV2, mesh_entry_size), 4);
+    });
+
+    expect_rejected("custom header", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, header_offset + offsetof(mono_forge_model::MFMHeaderV2, custom_header_offset), UINT32_MAX);
+    });
+
+    expect_rejected("vertex offset", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, vertex_offset), data_size - 16);
+    });
+
+    expect_rejected("vertex count overflow", [&](uint8_t* buffer) 
+    {
+        // vertex_size * vertex_count wraps to a small value in 32 bits
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, vertex_size), 0x10000);
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, vertex_count), 0x10000);
+    });
+
+    expect_rejected("vertex alignment", [&](uint8_t* buffer) 
+    {
+        uint32_t vertex_offset = 0;
+        std::memcpy(
+            &vertex_offset, buffer + entry_offset + offsetof(mono_forge_model::MFMMeshEntry, vertex_offset), 4);
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, vertex_offset), vertex_offset + 4);
+    });
+
+    expect_rejected("index size", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, index_size), 3);
+    });
+
+    expect_rejected("index count", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, index_count), UINT32_MAX);
+    });
+
+    expect_rejected("material name", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, entry_offset + offsetof(mono_forge_model::MFMMeshEntry, material_name_size), data_size);
+    });
+
+    expect_rejected("bounds", [&](uint8_t* buffer) 
+    {
+        const float inverted = -1.0e9f;
+        std::memcpy(
+            buffer + entry_offset + offsetof(mono_forge_model::MFMMeshEntry, bounds) 
+                + offsetof(mono_forge_model::MFMBounds, max), 
+            &inverted, sizeof(inverted));
+    });
+
+    // Version 1 corruptions
+    uint32_t v1_size = 0;
+    std::unique_ptr<uint8_t[]> v1_data = mono_forge_model_test::LoadV1File(v1_size);
+    ASSERT_NE(v1_data, nullptr);
+
+    mono_forge_model::MFMInfoHeader info_header;
+    std::memcpy(&info_header, v1_data.get() + sizeof(mono_forge_model::MFMFileHeader), sizeof(info_header));
+    mono_forge_model::MFMMeshHeader mesh_header;
+    std::memcpy(&mesh_header, v1_data.get() + info_header.mesh_header_offset, sizeof(mesh_header));
+
+    auto expect_v1_rejected = [&](const char* name, std::function<void(uint8_t*)> corrupt)
+    {
+        std::unique_ptr<uint8_t[]> copy = mono_forge_model_test::CopyData(v1_data.get(), v1_size);
+        corrupt(copy.get());
+        EXPECT_EQ(mono_forge_model::MFM::Create(std::move(copy), v1_size), nullptr) << name;
+    };
+
+    expect_v1_rejected("mesh header offset", [&](uint8_t* buffer) 
+    {
+        write_u32(buffer, sizeof(mono_forge_model::MFMFileHeader), v1_size);
+    });
+
+    expect_v1_rejected("material count", [&](uint8_t* buffer) 
+    {
+        write_u32(
+            buffer, info_header.mesh_header_offset + offsetof(mono_forge_model::MFMMeshHeader, material_count), 
+            UINT32_MAX);
+    });
+
+    expect_v1_rejected("node vertex count", [&](uint8_t* buffer) 
+    {
+        write_u32(
+            buffer, mesh_header.mesh_data_offset + offsetof(mono_forge_model::MFMMeshNode, vertex_count), 
+            UINT32_MAX);
+    });
+
+    expect_v1_rejected("node index offset", [&](uint8_t* buffer) 
+    {
+        write_u32(
+            buffer, mesh_header.mesh_data_offset + offsetof(mono_forge_model::MFMMeshNode, index_offset), 
+            UINT32_MAX - 4);
+    });
+}
+
+TEST(MFMV2, RandomCorruption)
+{
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(0, 8));
+    meshes.push_back(mono_forge_model_test::CreateTestMesh(1, 4));
+
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::WriteTestMeshes(meshes, data_size);
+    ASSERT_NE(data, nullptr);
+
+    // Flip random bytes in the headers and the directory
+    // Any accepted result must still keep every span inside the data
+    const uint32_t header_size = static_cast<uint32_t>(
+        sizeof(mono_forge_model::MFMFileHeader) + sizeof(mono_forge_model::MFMHeaderV2)
+        + sizeof(mono_forge_model::MFMMeshEntry) * meshes.size() + 16);
+
+    std::mt19937 random(12345);
+    for (int i = 0; i < 10000; ++i)
+    {
+        std::unique_ptr<uint8_t[]> copy = mono_forge_model_test::CopyData(data.get(), data_size);
+        const uint8_t* begin = copy.get();
+        for (int flip = 0; flip < 4; ++flip)
+            copy[random() % header_size] = static_cast<uint8_t>(random());
+
+        std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Create(std::move(copy), data_size);
+        if (mfm == nullptr)
+            continue;
+
+        for (uint32_t mesh_index = 0; mesh_index < mfm->GetMeshCount(); ++mesh_index)
+        {
+            mono_forge_model::MFMDataSpan vertex_span = mfm->GetVertexSpan(mesh_index);
+            EXPECT_LE(vertex_span.data + vertex_span.GetByteSize(), begin + data_size);
+
+            mono_forge_model::MFMDataSpan index_span = mfm->GetIndexSpan(mesh_index);
+            EXPECT_LE(index_span.data + index_span.GetByteSize(), begin + data_size);
+        }
+    }
+}
+
+TEST(MFMV2, LoadBenchmark)
+{
+    constexpr uint32_t MESH_COUNT = 64;
+    constexpr uint32_t VERTEX_COUNT = 16384;
+
+    std::vector<mono_forge_model_test::TestMesh> meshes;
+    for (uint32_t i = 0; i < MESH_COUNT; ++i)
+        meshes.push_back(mono_forge_model_test::CreateTestMesh(i, VERTEX_COUNT));
+
+    uint32_t data_size = 0;
+    std::unique_ptr<uint8_t[]> data = mono_forge_model_test::WriteTestMeshes(meshes, data_size);
+    ASSERT_NE(data, nullptr);
+
+    const char* file_path = "mfm_v2_load_benchmark.mfm";
+    mono_forge_model_test::WriteFile(file_path, data.get(), data_size);
+    data.reset();
+
+    constexpr int ITERATION_COUNT = 10;
+
+    // Read the whole file into a buffer and read the mesh data
+    auto load_start = std::chrono::high_resolution_clock::now();
+    uint64_t load_checksum = 0;
+    for (int i = 0; i < ITERATION_COUNT; ++i)
+    {
+        fpos_t file_size = 0;
+        std::unique_ptr<uint8_t[]> file_data = utility_header::LoadFile(file_path, file_size);
+        std::unique_ptr<mono_forge_model::MFM> mfm 
+            = mono_forge_model::MFM::Create(std::move(file_data), static_cast<uint32_t>(file_size));
+        ASSERT_NE(mfm, nullptr);
+
+        load_checksum += mono_forge_model_test::TouchMeshData(*mfm);
+    }
+    auto load_end = std::chrono::high_resolution_clock::now();
+
+    // Memory map the file and read the mesh data in place
+    auto open_start = std::chrono::high_resolution_clock::now();
+    uint64_t open_checksum = 0;
+    for (int i = 0; i < ITERATION_COUNT; ++i)
+    {
+        std::unique_ptr<mono_forge_model::MFM> mfm = mono_forge_model::MFM::Open(file_path);
+        ASSERT_NE(mfm, nullptr);
+
+        open_checksum += mono_forge_model_test::TouchMeshData(*mfm);
+    }
+    auto open_end = std::chrono::high_resolution_clock::now();
+
+    EXPECT_EQ(load_checksum, open_checksum);
+    std::remove(file_path);
+
+    double load_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count() / ITERATION_COUNT;
+    double open_ms = std::chrono::duration<double, std::milli>(open_end - open_start).count() / ITERATION_COUNT;
+
+    std::cout << "MFM load benchmark (" << MESH_COUNT << " meshes, " << data_size / (1024 * 1024) << " MB):" << std::endl;
+    std::cout << "  Copy into buffer: " << load_ms << " ms" << std::endl;
+    std::cout << "  Memory mapped: " << open_ms << " ms" << std::endl;
+}
\ No newline at end of file
@@ -87,6 +87,8 @@ public:
     virtual std::unique_ptr<render_graph::Light::SetupParam> GetLightSetupParam() const override;
     virtual const render_graph::LightHandle* GetLightHandle() const override { return &light_handle_; }
     virtual bool CastShadow() const override { return true; }
+    virtual bool ComputeShadowViewProjMatrix(
+        const DirectX::XMFLOAT3& euler_angles_deg, DirectX::XMMATRIX& view_proj_matrix) const override;
 
     // Get light color
     const DirectX::XMFLOAT4& GetLightColor() const { return light_color_; }
@@ -4,6 +4,8 @@
 #include "mono_service/include/service.h"
 #include "render_graph/include/command_handle.h"
 #include "mono_graphics_extension/include/dll_config.h"
+#include "mono_graphics_extension/include/renderable_culler.h"
+#include "mono_graphics_extension/include/world_buffer_ring.h"
 
 namespace mono_graphics_extension
 {
@@ -15,6 +17,16 @@ constexpr uint32_t BACK_BUFFER_COUNT = 2;
 constexpr DirectX::XMFLOAT4 FORWARD_VECTOR = DirectX::XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f);
 constexpr DirectX::XMFLOAT4 UP_VECTOR = DirectX::XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f);
 
+// The state of a drawn scene kept across frames
+struct SceneDrawState
+{
+    // The culler refitting the BVH of the renderables
+    RenderableCuller culler;
+
+    // The ring staging the world buffer uploads of the renderables
+    WorldBufferRing world_buffer_ring;
+};
+
 // The handle class for the graphics system
 class MONO_GRAPHICS_EXT_DLL GraphicsSystemHandle :
     public ecs::SystemHandle<GraphicsSystemHandle> {};
@@ -35,6 +47,9 @@ public:
 private:
     // The graphics service proxy
     std::unique_ptr<mono_service::ServiceProxy> graphics_service_proxy_ = nullptr;
+
+    // The draw states of the scenes
+    std::unordered_map<ecs::Entity, std::unique_ptr<SceneDrawState>> scene_draw_states_;
 };
 
 
@@ -21,6 +21,15 @@ public:
 
     // Check if the light casts shadows
     virtual bool CastShadow() const = 0;
+
+    // Compute the view-projection matrix the shadow map of the light is rendered with
+    // The rotation is the world rotation of the light entity in Euler angles (degrees)
+    // Returns false if the light has no shadow frustum, then no shadow caster is culled for it
+    virtual bool ComputeShadowViewProjMatrix(
+        const DirectX::XMFLOAT3& euler_angles_deg, DirectX::XMMATRIX& view_proj_matrix) const
+    {
+        return false;
+    }
 };
 
 } // namespace mono_graphics_extension
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "mono_service/include/service.h"
 #include "mono_graphics_extension/include/dll_config.h"
 #include "asset_loader/include/asset_handle.h"
+#include "geometry/include/bounding_volume.h"
 
 namespace mono_graphics_extension
 {
@@ -22,6 +23,9 @@ struct MeshSet
     std::vector<render_graph::ResourceHandle> index_buffer_handles;
     std::vector<uint32_t> index_counts;
     std::vector<const render_graph::MaterialHandle*> material_handles;
+
+    // The local bounding box of the meshes, the renderable is never culled if it is empty
+    geometry::AABB bounding_box = geometry::AABB();
 };
 
 // The renderable component class
@@ -82,6 +86,12 @@ public:
     // Get world matrix buffer handle
     const render_graph::ResourceHandle* GetWorldMatrixBufferHandle() const { return &world_matrix_buffer_handle_; }
 
+    // Get the local bounding box of the meshes
+    const geometry::AABB& GetBoundingBox() const { return bounding_box_; }
+
+    // Set the local bounding box of the meshes
+    void SetBoundingBox(const geometry::AABB& bounding_box) { bounding_box_ = bounding_box; }
+
     // Get whether the renderable casts shadows
     bool NeedsCastShadow() const { return cast_shadow_; }
 
@@ -109,6 +119,9 @@ private:
 
     // Whether the renderable casts shadows
     bool cast_shadow_ = true;
+
+    // The local bounding box of the meshes
+    geometry::AABB bounding_box_ = geometry::AABB();
 };
 
 } // namespace mono_graphics_extension
\ No newline at end of file
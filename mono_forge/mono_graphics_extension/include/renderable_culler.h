@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "ecs/include/entity.h"
+#include "geometry/include/bounding_volume.h"
+#include "geometry/include/bvh.h"
+#include "mono_graphics_extension/include/dll_config.h"
+
+namespace mono_graphics_extension
+{
+
+// A renderable passed to the culler
+struct CullingRenderable
+{
+    ecs::Entity entity;
+
+    // The local bounding box of the meshes, the renderable is never culled if it is empty
+    geometry::AABB local_box;
+
+    // The world matrix of the renderable
+    DirectX::XMFLOAT4X4 world_matrix;
+};
+
+// How the last Update of the culler changed its BVH
+enum class RenderableCullerUpdateResult
+{
+    None, // Not updated yet
+    Rebuilt, // The renderables were changed, or the refitted BVH degraded, so it was built from scratch
+    Refitted, // Only the nodes above the moved renderables were refitted
+    Unchanged, // No renderable moved
+};
+
+// The culler of the renderables in a scene
+// It keeps a BVH over the world bounding boxes of the renderables across frames
+// and culls them against frustums, such as the camera and the shadow casting lights
+class MONO_GRAPHICS_EXT_DLL RenderableCuller
+{
+public:
+    RenderableCuller() = default;
+    ~RenderableCuller() = default;
+
+    // Update the renderables of the frame
+    // If the entities are the same as the last update, only the renderables whose world matrix or
+    // local box changed are refitted, otherwise the BVH is rebuilt
+    void Update(const std::vector<CullingRenderable>& renderables);
+
+    // Get the indices of the renderables of the last Update which are not outside of the frustum
+    // The indices are in ascending order
+    void Cull(const geometry::Frustum& frustum, std::vector<uint32_t>& visible_indices) const;
+
+    // Get how the last Update changed the BVH
+    RenderableCullerUpdateResult GetLastUpdateResult() const { return last_update_result_; }
+
+    // Get the number of renderables moved in the last Update
+    size_t GetLastMovedCount() const { return last_moved_count_; }
+
+    // Get the world matrix of a renderable of the last Update
+    const DirectX::XMFLOAT4X4& GetWorldMatrix(uint32_t index) const { return world_matrices_.at(index); }
+
+    // Get the world bounding box of a renderable of the last Update
+    const geometry::AABB& GetWorldBox(uint32_t index) const { return world_boxes_.at(index); }
+
+    // Get the BVH over the bounded renderables
+    const geometry::BVH& GetBVH() const { return bvh_; }
+
+private:
+    // Build the BVH from the world boxes
+    void Rebuild();
+
+    // The entities of the last Update
+    std::vector<ecs::Entity> entities_;
+
+    // The local boxes and world matrices of the last Update, to find the moved renderables
+    std::vector<geometry::AABB> local_boxes_;
+    std::vector<DirectX::XMFLOAT4X4> world_matrices_;
+
+    // The world bounding boxes of the renderables
+    std::vector<geometry::AABB> world_boxes_;
+
+    // The BVH primitive of each renderable, or UNBOUNDED if it has no box
+    static constexpr uint32_t UNBOUNDED = UINT32_MAX;
+    std::vector<uint32_t> primitive_indices_;
+
+    // The renderable of each BVH primitive
+    std::vector<uint32_t> renderable_indices_;
+
+    // The renderables which have no box and are always visible
+    std::vector<uint32_t> unbounded_indices_;
+
+    // The BVH over the bounded renderables
+    geometry::BVH bvh_;
+
+    // How the last Update changed the BVH
+    RenderableCullerUpdateResult last_update_result_ = RenderableCullerUpdateResult::None;
+
+    // The number of renderables moved in the last Update
+    size_t last_moved_count_ = 0;
+};
+
+} // namespace mono_graphics_extension
\ No newline at end of file
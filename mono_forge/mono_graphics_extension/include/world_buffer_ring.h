@@ -0,0 +1,123 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "ecs/include/entity.h"
+#include "mono_service/include/service.h"
+#include "render_graph/include/resource_handle.h"
+#include "render_graph/include/geometry_pass.h"
+#include "mono_graphics_extension/include/dll_config.h"
+
+// Forward declaration
+namespace mono_graphics_service
+{
+    class GraphicsCommandList;
+} // namespace mono_graphics_service
+
+namespace mono_graphics_extension
+{
+
+// The default number of frame slots in the world buffer ring
+constexpr size_t DEFAULT_WORLD_BUFFER_RING_FRAME_COUNT = 3;
+
+// The ring staging the world buffer uploads of the renderables in a scene
+// Each entity remembers the world matrix it uploaded last, so only the renderables whose transform changed are staged
+// The staged data of a frame is stored contiguously in the frame's slot and recorded as a single command
+// A slot is reused when the ring wraps around, after the service has reached the progress of its submission
+class MONO_GRAPHICS_EXT_DLL WorldBufferRing
+{
+public:
+    WorldBufferRing(size_t frame_count = DEFAULT_WORLD_BUFFER_RING_FRAME_COUNT);
+    ~WorldBufferRing() = default;
+
+    // Get the progress the service must reach before BeginFrame overwrites the next slot
+    mono_service::ServiceProgress GetNextFrameProgress() const;
+
+    // Begin staging a frame in the next slot
+    void BeginFrame();
+
+    // Check if the renderable needs its world buffer uploaded
+    // It does when it was not uploaded yet, its buffer changed, or its world matrix differs from the uploaded one
+    bool NeedsUpload(
+        const ecs::Entity& entity, const render_graph::ResourceHandle* buffer_handle,
+        const DirectX::XMFLOAT4X4& world_matrix) const;
+
+    // Stage the world buffer of the renderable in the current slot and remember its world matrix
+    void Stage(
+        const ecs::Entity& entity, const render_graph::ResourceHandle* buffer_handle,
+        const DirectX::XMFLOAT4X4& world_matrix, DirectX::FXMMATRIX world_inverse_transpose);
+
+    // Record the uploads staged in the current slot to the command list
+    // Returns the number of recorded uploads, nothing is recorded if none was staged
+    size_t Record(mono_graphics_service::GraphicsCommandList& command_list) const;
+
+    // End the frame with the progress of the submission the slot was recorded to
+    void EndFrame(mono_service::ServiceProgress progress);
+
+    // Get the progress the service must reach before the ring can be destroyed
+    mono_service::ServiceProgress GetLatestProgress() const;
+
+    // Forget the entities which are not in the list, they are uploaded again if they come back
+    void Retain(const std::vector<ecs::Entity>& entities);
+
+    // Get the number of uploads staged in the current slot
+    size_t GetStagedCount() const { return frames_[frame_index_].buffer_handles.size(); }
+
+    // Get the world buffers staged in the current slot
+    const render_graph::geometry_pass::WorldBuffer* GetStagedWorldBuffers() const
+    {
+        return frames_[frame_index_].world_buffers.data();
+    }
+
+    // Get the buffer handles staged in the current slot
+    const render_graph::ResourceHandle* const* GetStagedBufferHandles() const
+    {
+        return frames_[frame_index_].buffer_handles.data();
+    }
+
+    // Get the number of entities whose uploaded world matrix is remembered
+    size_t GetEntityCount() const { return entries_.size(); }
+
+    // Get the number of frame slots
+    size_t GetFrameCount() const { return frames_.size(); }
+
+    // Get the index of the current slot
+    size_t GetFrameIndex() const { return frame_index_; }
+
+private:
+    // The world buffer uploaded last by an entity
+    struct Entry
+    {
+        const render_graph::ResourceHandle* buffer_handle = nullptr;
+        DirectX::XMFLOAT4X4 world_matrix;
+
+        // The mark of the last Retain which found the entity
+        uint32_t retain_mark = 0;
+    };
+
+    // The uploads staged in a frame
+    // The arrays keep their capacity, so a slot allocates nothing once it has grown enough
+    struct FrameSlot
+    {
+        std::vector<const render_graph::ResourceHandle*> buffer_handles;
+        std::vector<render_graph::geometry_pass::WorldBuffer> world_buffers;
+
+        // The progress of the submission which reads the arrays
+        mono_service::ServiceProgress progress = 0;
+    };
+
+    // The entries of the entities
+    std::unordered_map<ecs::Entity, Entry> entries_;
+
+    // The frame slots, and the index of the current one
+    std::vector<FrameSlot> frames_;
+    size_t frame_index_ = 0;
+
+    // The mark of the last Retain
+    uint32_t retain_mark_ = 0;
+};
+
+} // namespace mono_graphics_extension
\ No newline at end of file
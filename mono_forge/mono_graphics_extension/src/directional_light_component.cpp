@@ -118,4 +118,18 @@ std::unique_ptr<render_graph::Light::SetupParam> DirectionalLightComponent::GetL
     return setup_param;
 }
 
+bool DirectionalLightComponent::ComputeShadowViewProjMatrix(
+    const DirectX::XMFLOAT3& euler_angles_deg, DirectX::XMMATRIX& view_proj_matrix) const
+{
+    // Compute the matrices the same way as the light in the graphics service
+    DirectX::XMMATRIX view_matrix;
+    DirectX::XMMATRIX proj_matrix;
+    render_graph::DirectionalLight::ComputeViewProjMatrices(
+        render_graph::Light::ToRotation(euler_angles_deg),
+        distance_, ortho_width_, ortho_height_, near_z_, far_z_, view_matrix, proj_matrix);
+
+    view_proj_matrix = DirectX::XMMatrixMultiply(view_matrix, proj_matrix);
+    return true; // Has shadow frustum
+}
+
 } // namespace mono_graphics_extension
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#include "mono_graphics_extension/src/pch.h"
 #include "mono_graphics_extension/include/graphics_system.h"
 
+#include "utility_header/logger.h"
 #include "ecs/include/world.h"
 #include "mono_graphics_service/include/graphics_command_list.h"
 #include "mono_graphics_service/include/graphics_service_view.h"
@@ -34,11 +35,14 @@ struct RenderContext
         ecs::World& world,
         mono_service::ServiceProxy& graphics_service_proxy,
         const ecs::Entity& scene_entity,
-        const mono_scene_extension::SceneComponent& scene_component) :
+        const mono_scene_extension::SceneComponent& scene_component,
+        SceneDrawState& draw_state) :
         world(world),
         graphics_service_proxy(graphics_service_proxy),
         scene_entity(scene_entity),
-        scene_component(scene_component)
+        scene_component(scene_component),
+        culler(draw_state.culler),
+        world_buffer_ring(draw_state.world_buffer_ring)
     {
     }
 
@@ -46,6 +50,28 @@ struct RenderContext
     mono_service::ServiceProxy& graphics_service_proxy;
     const ecs::Entity& scene_entity;
     const mono_scene_extension::SceneComponent& scene_component;
+    RenderableCuller& culler;
+    WorldBufferRing& world_buffer_ring;
+};
+
+// The time to wait for the service to release a slot of the world buffer ring
+constexpr std::chrono::milliseconds WORLD_BUFFER_RING_WAIT_TIMEOUT = std::chrono::milliseconds(5000);
+
+// The renderables which passed the culling in a frame
+struct CullingResult
+{
+    // The components of the renderable entities, in the order of the scene
+    std::vector<RenderableComponent*> renderable_components;
+    std::vector<mono_transform_extension::TransformComponent*> transform_components;
+
+    // The indices of the renderables visible from the main camera
+    std::vector<uint32_t> camera_visible_indices;
+
+    // The indices of the shadow casters visible from each shadow casting light
+    std::vector<std::pair<const render_graph::LightHandle*, std::vector<uint32_t>>> light_visible_casters;
+
+    // Whether each renderable is drawn by any pass, only those need their world buffer updated
+    std::vector<bool> is_drawn;
 };
 
 // Helper function to get current back buffer index
@@ -64,51 +90,8 @@ uint32_t GetCurrentBackBufferIndex(
     return graphics_service_view->GetCurrentBackBufferIndex(swap_chain_handle);
 }
 
-// Update renderable components in the scene
-void UpdateRenderable(RenderContext& draw_context, const render_graph::CommandSetHandle* command_set_handle)
-{
-    // Create graphics service command list
-    std::unique_ptr<mono_service::ServiceCommandList> command_list
-        = draw_context.graphics_service_proxy.CreateCommandList();
-    mono_graphics_service::GraphicsCommandList* graphics_command_list
-        = dynamic_cast<mono_graphics_service::GraphicsCommandList*>(command_list.get());
-    assert(graphics_command_list != nullptr && "Failed to create graphics service command list");
-
-    // Set command set handle
-    graphics_command_list->SetCommandSetHandle(command_set_handle);
-
-    // Iterate through all renderable entities in the scene
-    for (const ecs::Entity& renderable_entity : draw_context.scene_component.GetRenderableEntities())
-    {
-        RenderableComponent* renderable_component
-            = draw_context.world.GetComponent<RenderableComponent>(
-                renderable_entity, RenderableComponentHandle::ID());
-        assert(renderable_component != nullptr && "Renderable component is null");
-
-        // Get TransformComponent
-        mono_transform_extension::TransformComponent* transform_component
-            = draw_context.world.GetComponent<mono_transform_extension::TransformComponent>(
-                renderable_entity, mono_transform_extension::TransformComponentHandle::ID());
-        assert(transform_component != nullptr && "Renderable entity must have TransformComponent");
-
-        // Create world buffer for geometry pass
-        std::unique_ptr<render_graph::geometry_pass::WorldBuffer> world_buffer
-            = std::make_unique<render_graph::geometry_pass::WorldBuffer>();
-        world_buffer->world_matrix = XMMatrixTranspose(transform_component->GetWorldMatrix());
-        world_buffer->world_inverse_transpose
-            = XMMatrixTranspose(XMMatrixInverse(nullptr, transform_component->GetWorldMatrix()));
-
-        // Update world buffer in graphics service
-        graphics_command_list->UpdateWorldBufferForGeometryPass(
-            renderable_component->GetWorldMatrixBufferHandle(), std::move(world_buffer));
-    }
-
-    // Submit command list to graphics service
-    draw_context.graphics_service_proxy.SubmitCommandList(std::move(command_list));
-}
-
-// Update view-projection matrix from main camera in the scene
-void UpdateCamera(RenderContext& draw_context, const render_graph::CommandSetHandle* command_set_handle)
+// Compute the view-projection matrix of the main camera in the scene
+XMMATRIX ComputeCameraViewProjMatrix(RenderContext& draw_context)
 {
     // Get main camera entity
     const ecs::Entity& main_camera_entity = draw_context.scene_component.GetMainCameraEntity();
@@ -146,7 +129,174 @@ void UpdateCamera(RenderContext& draw_context, const render_graph::CommandSetHan
         camera_component->GetNearZ(), camera_component->GetFarZ());
 
     // Combine view and projection matrix
-    XMMATRIX view_proj_matrix = XMMatrixMultiply(view_matrix, projection_matrix);
+    return XMMatrixMultiply(view_matrix, projection_matrix);
+}
+
+// Cull renderable entities in the scene against the main camera and the shadow casting lights
+void CullRenderables(RenderContext& draw_context, CullingResult& culling_result)
+{
+    const std::vector<ecs::Entity>& renderable_entities = draw_context.scene_component.GetRenderableEntities();
+    culling_result.renderable_components.resize(renderable_entities.size());
+    culling_result.transform_components.resize(renderable_entities.size());
+
+    // Collect the bounds and world matrices of the renderables
+    std::vector<CullingRenderable> culling_renderables(renderable_entities.size());
+    for (size_t i = 0; i < renderable_entities.size(); ++i)
+    {
+        RenderableComponent* renderable_component
+            = draw_context.world.GetComponent<RenderableComponent>(
+                renderable_entities[i], RenderableComponentHandle::ID());
+        assert(renderable_component != nullptr && "Renderable component is null");
+
+        // Get TransformComponent
+        mono_transform_extension::TransformComponent* transform_component
+            = draw_context.world.GetComponent<mono_transform_extension::TransformComponent>(
+                renderable_entities[i], mono_transform_extension::TransformComponentHandle::ID());
+        assert(transform_component != nullptr && "Renderable entity must have TransformComponent");
+
+        culling_result.renderable_components[i] = renderable_component;
+        culling_result.transform_components[i] = transform_component;
+
+        culling_renderables[i].entity = renderable_entities[i];
+        culling_renderables[i].local_box = renderable_component->GetBoundingBox();
+        XMStoreFloat4x4(&culling_renderables[i].world_matrix, transform_component->GetWorldMatrix());
+    }
+
+    // Refit or rebuild the BVH of the scene
+    draw_context.culler.Update(culling_renderables);
+
+    // Forget the uploads of the renderables which left the scene
+    if (draw_context.culler.GetLastUpdateResult() == RenderableCullerUpdateResult::Rebuilt)
+        draw_context.world_buffer_ring.Retain(renderable_entities);
+
+    // Cull against the main camera
+    draw_context.culler.Cull(
+        geometry::CreateFrustum(ComputeCameraViewProjMatrix(draw_context)), culling_result.camera_visible_indices);
+
+    culling_result.is_drawn.assign(renderable_entities.size(), false);
+    for (const uint32_t& index : culling_result.camera_visible_indices)
+        culling_result.is_drawn[index] = true;
+
+    // Cull the shadow casters against each shadow casting light
+    std::vector<uint32_t> light_visible_indices;
+    for (const auto& [component_id, light_entity] : draw_context.scene_component.GetLightEntities())
+    {
+        // Get LightComponent
+        LightComponent* light_component
+            = draw_context.world.GetComponent<LightComponent>(light_entity, component_id);
+        assert(light_component != nullptr && "Light entity must have LightComponent");
+
+        if (!light_component->CastShadow())
+            continue; // No shadow map
+
+        // Get transform component
+        mono_transform_extension::TransformComponent* transform_component
+            = draw_context.world.GetComponent<mono_transform_extension::TransformComponent>(
+                light_entity, mono_transform_extension::TransformComponentHandle::ID());
+        assert(transform_component != nullptr && "Light entity must have TransformComponent");
+
+        // If the light has no frustum, every shadow caster is rendered for it
+        XMMATRIX light_view_proj_matrix;
+        if (light_component->ComputeShadowViewProjMatrix(transform_component->GetWorldEulerAngles(), light_view_proj_matrix))
+        {
+            draw_context.culler.Cull(geometry::CreateFrustum(light_view_proj_matrix), light_visible_indices);
+        }
+        else
+        {
+            light_visible_indices.resize(renderable_entities.size());
+            for (uint32_t i = 0; i < light_visible_indices.size(); ++i)
+                light_visible_indices[i] = i;
+        }
+
+        // Keep only the shadow casters
+        std::vector<uint32_t> caster_indices;
+        for (const uint32_t& index : light_visible_indices)
+        {
+            if (!culling_result.renderable_components[index]->NeedsCastShadow())
+                continue;
+
+            caster_indices.push_back(index);
+            culling_result.is_drawn[index] = true;
+        }
+
+        culling_result.light_visible_casters.emplace_back(light_component->GetLightHandle(), std::move(caster_indices));
+    }
+}
+
+// Upload the world buffers of the renderables which are drawn in the frame and moved since their last upload
+bool UpdateRenderable(
+    RenderContext& draw_context, const CullingResult& culling_result,
+    const render_graph::CommandSetHandle* command_set_handle)
+{
+    WorldBufferRing& world_buffer_ring = draw_context.world_buffer_ring;
+
+    // Wait until the service has executed the uploads which last used the next slot
+    mono_service::ServiceWaitResult wait_result = draw_context.graphics_service_proxy.WaitForProgress(
+        world_buffer_ring.GetNextFrameProgress(), WORLD_BUFFER_RING_WAIT_TIMEOUT);
+    if (wait_result != mono_service::ServiceWaitResult::Complete)
+    {
+        utility_header::ConsoleLogErr(
+            {"GraphicsSystem: Graphics service did not release the world buffer ring slot"},
+            __FILE__, __LINE__, __FUNCTION__);
+        return false; // Failure
+    }
+
+    world_buffer_ring.BeginFrame();
+
+    // Stage the renderables drawn by any pass whose world matrix changed
+    for (size_t i = 0; i < culling_result.renderable_components.size(); ++i)
+    {
+        if (!culling_result.is_drawn[i])
+            continue; // Culled by all passes
+
+        const RenderableComponent* renderable_component = culling_result.renderable_components[i];
+        const DirectX::XMFLOAT4X4& world_matrix = draw_context.culler.GetWorldMatrix(static_cast<uint32_t>(i));
+        if (!world_buffer_ring.NeedsUpload(
+            draw_context.scene_component.GetRenderableEntities()[i],
+            renderable_component->GetWorldMatrixBufferHandle(), world_matrix))
+            continue; // Not moved since the last upload
+
+        world_buffer_ring.Stage(
+            draw_context.scene_component.GetRenderableEntities()[i],
+            renderable_component->GetWorldMatrixBufferHandle(), world_matrix,
+            culling_result.transform_components[i]->GetWorldInverseTransposeMatrix());
+    }
+
+    if (world_buffer_ring.GetStagedCount() == 0)
+        return true; // Nothing to upload
+
+    // Create graphics service command list
+    std::unique_ptr<mono_service::ServiceCommandList> command_list
+        = draw_context.graphics_service_proxy.CreateCommandList();
+    mono_graphics_service::GraphicsCommandList* graphics_command_list
+        = dynamic_cast<mono_graphics_service::GraphicsCommandList*>(command_list.get());
+    assert(graphics_command_list != nullptr && "Failed to create graphics service command list");
+
+    // Set command set handle
+    graphics_command_list->SetCommandSetHandle(command_set_handle);
+
+    // Upload the staged world buffers with a single command
+    world_buffer_ring.Record(*graphics_command_list);
+
+    // Submit command list to graphics service, the slot is kept until the service reaches its progress
+    world_buffer_ring.EndFrame(draw_context.graphics_service_proxy.SubmitCommandList(std::move(command_list)));
+    return true; // Success
+}
+
+// Update view-projection matrix from main camera in the scene
+void UpdateCamera(RenderContext& draw_context, const render_graph::CommandSetHandle* command_set_handle)
+{
+    // Get main camera entity
+    const ecs::Entity& main_camera_entity = draw_context.scene_component.GetMainCameraEntity();
+
+    // Get CameraComponent
+    CameraComponent* camera_component
+        = draw_context.world.GetComponent<CameraComponent>(
+            main_camera_entity, CameraComponentHandle::ID());
+    assert(camera_component != nullptr && "Main camera entity must have CameraComponent");
+
+    // Compute view-projection matrix
+    XMMATRIX view_proj_matrix = ComputeCameraViewProjMatrix(draw_context);
 
     // Create inverse view-projection matrix
     XMMATRIX inv_view_proj_matrix = XMMatrixInverse(nullptr, view_proj_matrix);
@@ -256,8 +406,8 @@ void UpdateLight(
     draw_context.graphics_service_proxy.SubmitCommandList(std::move(command_list));
 }
 
-// Draw entities in the scene
-void DrawEntities(RenderContext& draw_context, 
+// Draw entities in the scene which passed the culling
+void DrawEntities(RenderContext& draw_context, const CullingResult& culling_result,
     const render_graph::CommandSetHandle* command_set_handle, const render_graph::ResourceHandle* swap_chain_handle)
 {
     // Create graphics service command list
@@ -273,14 +423,10 @@ void DrawEntities(RenderContext& draw_context,
     // Set swap chain handle
     graphics_command_list->SetSwapChainHandle(swap_chain_handle);
 
-    // Iterate through all renderable entities in the scene
-    for (const ecs::Entity& renderable_entity : draw_context.scene_component.GetRenderableEntities())
+    // Iterate through the renderables visible from the main camera
+    for (const uint32_t& index : culling_result.camera_visible_indices)
     {
-        RenderableComponent* renderable_component
-            = draw_context.world.GetComponent<RenderableComponent>(
-                renderable_entity, RenderableComponentHandle::ID());
-        assert(renderable_component != nullptr && "Renderable component is null");
-
+        const RenderableComponent* renderable_component = culling_result.renderable_components[index];
         for (uint32_t i = 0; i < renderable_component->GetIndexCounts()->size(); ++i)
         {
             // Add draw mesh command
@@ -290,15 +436,23 @@ void DrawEntities(RenderContext& draw_context,
                 &renderable_component->GetVertexBufferHandles()->at(i),
                 &renderable_component->GetIndexBufferHandles()->at(i),
                 renderable_component->GetIndexCounts()->at(i));
+        }
+    }
 
-            if (renderable_component->NeedsCastShadow())
+    // Iterate through the shadow casters visible from each light
+    for (const auto& [light_handle, caster_indices] : culling_result.light_visible_casters)
+    {
+        for (const uint32_t& index : caster_indices)
+        {
+            const RenderableComponent* renderable_component = culling_result.renderable_components[index];
+            for (uint32_t i = 0; i < renderable_component->GetIndexCounts()->size(); ++i)
             {
-                // Add draw mesh to shadow map command
+                // Add draw mesh to shadow map of the light command
                 graphics_command_list->DrawShadowCasterMesh(
                     renderable_component->GetWorldMatrixBufferHandle(),
                     &renderable_component->GetVertexBufferHandles()->at(i),
                     &renderable_component->GetIndexBufferHandles()->at(i),
-                    renderable_component->GetIndexCounts()->at(i));
+                    renderable_component->GetIndexCounts()->at(i), light_handle);
             }
         }
     }
@@ -496,8 +650,13 @@ void DrawScene(RenderContext& draw_context)
     const render_graph::CommandSetHandle* command_set_handle
         = &window_render_bind_component->GetCommandSetHandles()->at(current_back_buffer_index);
 
+    // Cull renderables against the camera and the lights
+    CullingResult culling_result;
+    CullRenderables(draw_context, culling_result);
+
     // Update world matrixes
-    UpdateRenderable(draw_context, command_set_handle);
+    if (!UpdateRenderable(draw_context, culling_result, command_set_handle))
+        return; // Skip drawing this frame
 
     // Update view-projection matrixes
     UpdateCamera(draw_context, command_set_handle);
@@ -508,8 +667,9 @@ void DrawScene(RenderContext& draw_context)
         window_render_bind_component, current_back_buffer_index,
         window_component->GetClientWidth(), window_component->GetClientHeight());
 
-    // Draw all renderable entities in the scene
-    DrawEntities(draw_context, command_set_handle, window_render_bind_component->GetSwapChainHandle());
+    // Draw renderable entities which passed the culling
+    DrawEntities(
+        draw_context, culling_result, command_set_handle, window_render_bind_component->GetSwapChainHandle());
 
     // Draw UI
     render_graph::ImguiPass::DrawFunc ui_draw_func = DrawUI(draw_context);
@@ -530,6 +690,12 @@ GraphicsSystem::GraphicsSystem(std::unique_ptr<mono_service::ServiceProxy> graph
 
 GraphicsSystem::~GraphicsSystem()
 {
+    // Wait until the service has executed the uploads reading the world buffer rings
+    for (const auto& [scene_entity, draw_state] : scene_draw_states_)
+    {
+        graphics_service_proxy_->WaitForProgress(
+            draw_state->world_buffer_ring.GetLatestProgress(), WORLD_BUFFER_RING_WAIT_TIMEOUT);
+    }
 }
 
 bool GraphicsSystem::PreUpdate(ecs::World& world)
@@ -539,6 +705,9 @@ bool GraphicsSystem::PreUpdate(ecs::World& world)
 
 bool GraphicsSystem::Update(ecs::World& world)
 {
+    // The scenes drawn this frame, the draw states of the others are released
+    std::vector<ecs::Entity> drawn_scene_entities;
+
     // Iterate through all entities with SceneComponent
     for (const ecs::Entity& entity : world.View(mono_scene_extension::SceneComponentHandle::ID())())
     {
@@ -559,14 +728,35 @@ bool GraphicsSystem::Update(ecs::World& world)
         if (!meta_component->IsActiveSelf())
             continue; // Skip inactive scenes
 
+        // Get the draw state of the scene
+        std::unique_ptr<SceneDrawState>& draw_state = scene_draw_states_[entity];
+        if (draw_state == nullptr)
+            draw_state = std::make_unique<SceneDrawState>();
+        drawn_scene_entities.push_back(entity);
+
         // Create render context
         RenderContext draw_context(
-            world, *graphics_service_proxy_, entity, *scene_component);
+            world, *graphics_service_proxy_, entity, *scene_component, *draw_state);
 
         // Draw the scene
         DrawScene(draw_context);
     }
 
+    // Release the draw states of the scenes which were not drawn
+    for (auto it = scene_draw_states_.begin(); it != scene_draw_states_.end();)
+    {
+        if (std::find(drawn_scene_entities.begin(), drawn_scene_entities.end(), it->first) != drawn_scene_entities.end())
+        {
+            ++it;
+            continue;
+        }
+
+        // The world buffer ring must outlive the uploads reading it
+        graphics_service_proxy_->WaitForProgress(
+            it->second->world_buffer_ring.GetLatestProgress(), WORLD_BUFFER_RING_WAIT_TIMEOUT);
+        it = scene_draw_states_.erase(it);
+    }
+
     return true; // Success
 }
 
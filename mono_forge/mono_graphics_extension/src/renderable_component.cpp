@@ -58,6 +58,7 @@ bool RenderableComponent::Setup(ecs::Component::SetupParam& param)
     index_counts_ = renderable_param->mesh_set_.index_counts;
     material_handles_ = renderable_param->mesh_set_.material_handles;
     cast_shadow_ = renderable_param->cast_shadow_;
+    bounding_box_ = renderable_param->mesh_set_.bounding_box;
 
     // Create graphics service command list
     std::unique_ptr<mono_service::ServiceCommandList> command_list
@@ -88,6 +89,7 @@ bool RenderableComponent::Apply(const ecs::Component::SetupParam& param)
     index_counts_ = renderable_param->mesh_set_.index_counts;
     material_handles_ = renderable_param->mesh_set_.material_handles;
     cast_shadow_ = renderable_param->cast_shadow_;
+    bounding_box_ = renderable_param->mesh_set_.bounding_box;
 
     return true; // Success
 }
@@ -0,0 +1,145 @@
+﻿#include "mono_graphics_extension/src/pch.h"
+#include "mono_graphics_extension/include/renderable_culler.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mono_graphics_extension
+{
+
+namespace
+{
+
+// Check if the boxes are the same
+bool IsSameBox(const geometry::AABB& a, const geometry::AABB& b)
+{
+    return std::memcmp(&a, &b, sizeof(geometry::AABB)) == 0;
+}
+
+// Check if the matrices are the same
+bool IsSameMatrix(const DirectX::XMFLOAT4X4& a, const DirectX::XMFLOAT4X4& b)
+{
+    return std::memcmp(&a, &b, sizeof(DirectX::XMFLOAT4X4)) == 0;
+}
+
+// Compute the world bounding box of the local box
+geometry::AABB ComputeWorldBox(const geometry::AABB& local_box, const DirectX::XMFLOAT4X4& world_matrix)
+{
+    return geometry::TransformAABB(local_box, DirectX::XMLoadFloat4x4(&world_matrix));
+}
+
+} // namespace
+
+void RenderableCuller::Update(const std::vector<CullingRenderable>& renderables)
+{
+    last_moved_count_ = 0;
+
+    // Check if the renderables are the same entities in the same order as the last update
+    bool is_same_set =
+        last_update_result_ != RenderableCullerUpdateResult::None && entities_.size() == renderables.size();
+    for (size_t i = 0; i < renderables.size() && is_same_set; ++i)
+    {
+        // A renderable whose box becomes empty or bounded moves between the BVH and the unbounded list
+        is_same_set =
+            entities_[i] == renderables[i].entity &&
+            local_boxes_[i].IsValid() == renderables[i].local_box.IsValid();
+    }
+
+    if (!is_same_set)
+    {
+        entities_.resize(renderables.size());
+        local_boxes_.resize(renderables.size());
+        world_matrices_.resize(renderables.size());
+        world_boxes_.resize(renderables.size());
+        for (size_t i = 0; i < renderables.size(); ++i)
+        {
+            entities_[i] = renderables[i].entity;
+            local_boxes_[i] = renderables[i].local_box;
+            world_matrices_[i] = renderables[i].world_matrix;
+            world_boxes_[i] = ComputeWorldBox(local_boxes_[i], world_matrices_[i]);
+        }
+
+        last_moved_count_ = renderables.size();
+        Rebuild();
+        return;
+    }
+
+    // Refit only the renderables which moved
+    for (size_t i = 0; i < renderables.size(); ++i)
+    {
+        const CullingRenderable& renderable = renderables[i];
+        if (IsSameMatrix(world_matrices_[i], renderable.world_matrix) && IsSameBox(local_boxes_[i], renderable.local_box))
+            continue; // Not moved
+
+        local_boxes_[i] = renderable.local_box;
+        world_matrices_[i] = renderable.world_matrix;
+        world_boxes_[i] = ComputeWorldBox(local_boxes_[i], world_matrices_[i]);
+        last_moved_count_++;
+
+        if (primitive_indices_[i] != UNBOUNDED)
+            bvh_.UpdatePrimitive(primitive_indices_[i], world_boxes_[i]);
+    }
+
+    if (last_moved_count_ == 0)
+    {
+        last_update_result_ = RenderableCullerUpdateResult::Unchanged;
+        return;
+    }
+
+    bvh_.Refit();
+
+    // Rebuild if the renderables moved so far that the tree shape no longer fits them
+    if (bvh_.NeedsRebuild())
+    {
+        Rebuild();
+        return;
+    }
+
+    last_update_result_ = RenderableCullerUpdateResult::Refitted;
+}
+
+void RenderableCuller::Cull(const geometry::Frustum& frustum, std::vector<uint32_t>& visible_indices) const
+{
+    visible_indices.clear();
+
+    // Query the BVH and map the primitives back to the renderables
+    std::vector<uint32_t> primitives;
+    primitives.reserve(renderable_indices_.size());
+    bvh_.QueryFrustum(frustum, primitives);
+
+    visible_indices.reserve(primitives.size() + unbounded_indices_.size());
+    for (const uint32_t& primitive_index : primitives)
+        visible_indices.push_back(renderable_indices_[primitive_index]);
+
+    // The renderables without a box are always visible
+    visible_indices.insert(visible_indices.end(), unbounded_indices_.begin(), unbounded_indices_.end());
+
+    std::sort(visible_indices.begin(), visible_indices.end());
+}
+
+void RenderableCuller::Rebuild()
+{
+    primitive_indices_.assign(world_boxes_.size(), UNBOUNDED);
+    renderable_indices_.clear();
+    unbounded_indices_.clear();
+
+    std::vector<geometry::AABB> boxes;
+    boxes.reserve(world_boxes_.size());
+    for (uint32_t i = 0; i < world_boxes_.size(); ++i)
+    {
+        if (!world_boxes_[i].IsValid())
+        {
+            unbounded_indices_.push_back(i);
+            continue;
+        }
+
+        primitive_indices_[i] = static_cast<uint32_t>(boxes.size());
+        renderable_indices_.push_back(i);
+        boxes.push_back(world_boxes_[i]);
+    }
+
+    bvh_.Build(boxes);
+    last_update_result_ = RenderableCullerUpdateResult::Rebuilt;
+}
+
+} // namespace mono_graphics_extension
\ No newline at end of file
@@ -0,0 +1,119 @@
+﻿#include "mono_graphics_extension/src/pch.h"
+#include "mono_graphics_extension/include/world_buffer_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mono_graphics_service/include/graphics_command_list.h"
+
+using namespace DirectX;
+
+namespace mono_graphics_extension
+{
+
+WorldBufferRing::WorldBufferRing(size_t frame_count) :
+    frames_(frame_count)
+{
+    assert(frame_count != 0 && "World buffer ring needs at least one frame slot.");
+
+    // Start before the first slot, so the first BeginFrame uses it
+    frame_index_ = frame_count - 1;
+}
+
+mono_service::ServiceProgress WorldBufferRing::GetNextFrameProgress() const
+{
+    return frames_[(frame_index_ + 1) % frames_.size()].progress;
+}
+
+void WorldBufferRing::BeginFrame()
+{
+    frame_index_ = (frame_index_ + 1) % frames_.size();
+
+    // The service has executed the uploads of the slot, so its arrays can be overwritten
+    FrameSlot& frame = frames_[frame_index_];
+    frame.buffer_handles.clear();
+    frame.world_buffers.clear();
+    frame.progress = 0;
+}
+
+bool WorldBufferRing::NeedsUpload(
+    const ecs::Entity& entity, const render_graph::ResourceHandle* buffer_handle,
+    const XMFLOAT4X4& world_matrix) const
+{
+    auto it = entries_.find(entity);
+    if (it == entries_.end())
+        return true; // Not uploaded yet
+
+    const Entry& entry = it->second;
+    if (entry.buffer_handle != buffer_handle)
+        return true; // The world buffer was recreated
+
+    return std::memcmp(&entry.world_matrix, &world_matrix, sizeof(XMFLOAT4X4)) != 0;
+}
+
+void WorldBufferRing::Stage(
+    const ecs::Entity& entity, const render_graph::ResourceHandle* buffer_handle,
+    const XMFLOAT4X4& world_matrix, FXMMATRIX world_inverse_transpose)
+{
+    // Remember the uploaded world matrix
+    Entry& entry = entries_[entity];
+    entry.buffer_handle = buffer_handle;
+    entry.world_matrix = world_matrix;
+    entry.retain_mark = retain_mark_;
+
+    // Stage the world buffer data next to the others of the frame
+    render_graph::geometry_pass::WorldBuffer world_buffer;
+    world_buffer.world_matrix = XMMatrixTranspose(XMLoadFloat4x4(&world_matrix));
+    world_buffer.world_inverse_transpose = world_inverse_transpose;
+
+    FrameSlot& frame = frames_[frame_index_];
+    frame.buffer_handles.push_back(buffer_handle);
+    frame.world_buffers.push_back(world_buffer);
+}
+
+size_t WorldBufferRing::Record(mono_graphics_service::GraphicsCommandList& command_list) const
+{
+    const FrameSlot& frame = frames_[frame_index_];
+    if (frame.buffer_handles.empty())
+        return 0; // Nothing staged
+
+    command_list.UpdateWorldBuffersForGeometryPass(
+        frame.buffer_handles.data(), frame.world_buffers.data(), frame.buffer_handles.size());
+    return frame.buffer_handles.size();
+}
+
+void WorldBufferRing::EndFrame(mono_service::ServiceProgress progress)
+{
+    frames_[frame_index_].progress = progress;
+}
+
+mono_service::ServiceProgress WorldBufferRing::GetLatestProgress() const
+{
+    mono_service::ServiceProgress latest_progress = 0;
+    for (const FrameSlot& frame : frames_)
+        latest_progress = std::max(latest_progress, frame.progress);
+    return latest_progress;
+}
+
+void WorldBufferRing::Retain(const std::vector<ecs::Entity>& entities)
+{
+    // Mark the entries of the entities in the list
+    retain_mark_++;
+    for (const ecs::Entity& entity : entities)
+    {
+        auto it = entries_.find(entity);
+        if (it != entries_.end())
+            it->second.retain_mark = retain_mark_;
+    }
+
+    // Remove the entries which were not marked
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        if (it->second.retain_mark != retain_mark_)
+            it = entries_.erase(it);
+        else
+            ++it;
+    }
+}
+
+} // namespace mono_graphics_extension
\ No newline at end of file
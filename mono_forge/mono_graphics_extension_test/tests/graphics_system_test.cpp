@@ -807,6 +807,7 @@ private:
                 param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
                 param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
                 param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts(); 
+                param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
                 
                 std::vector<const render_graph::MaterialHandle*> material_handles;
                 for (size_t i = 0; i < mesh_asset_ptr->GetIndexCounts()->size(); ++i)
@@ -903,6 +904,7 @@ private:
                 param->mesh_set_.vertex_buffer_handles = *mesh_asset_ptr->GetVertexBufferHandles();
                 param->mesh_set_.index_buffer_handles = *mesh_asset_ptr->GetIndexBufferHandles();
                 param->mesh_set_.index_counts = *mesh_asset_ptr->GetIndexCounts();  
+                param->mesh_set_.bounding_box = mesh_asset_ptr->GetBoundingBox();
 
                 std::vector<const render_graph::MaterialHandle*> material_handles;
                 for (size_t i = 0; i < mesh_asset_ptr->GetIndexCounts()->size(); ++i)
@@ -0,0 +1,200 @@
+﻿#include "mono_graphics_extension_test/pch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "mono_graphics_extension/include/renderable_culler.h"
+using namespace DirectX;
+
+namespace renderable_culler_test
+{
+
+// Create renderables with unit boxes scattered in a cube
+std::vector<mono_graphics_extension::CullingRenderable> MakeScatteredRenderables(
+    size_t count, float extent, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-extent, extent);
+
+    std::vector<mono_graphics_extension::CullingRenderable> renderables(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        renderables[i].entity = ecs::Entity(i, 0);
+        renderables[i].local_box.min = XMFLOAT3(-0.5f, -0.5f, -0.5f);
+        renderables[i].local_box.max = XMFLOAT3(0.5f, 0.5f, 0.5f);
+        XMStoreFloat4x4(
+            &renderables[i].world_matrix, XMMatrixTranslation(position(random), position(random), position(random)));
+    }
+    return renderables;
+}
+
+// Create the frustum of a camera at the position looking along +z
+geometry::Frustum MakeCameraFrustum(const XMFLOAT3& position, float far_z)
+{
+    XMVECTOR eye = XMLoadFloat3(&position);
+    XMMATRIX view = XMMatrixLookAtLH(
+        eye, XMVectorAdd(eye, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, far_z);
+    return geometry::CreateFrustum(XMMatrixMultiply(view, proj));
+}
+
+// Cull all renderables one by one, as GraphicsSystem would without the BVH
+std::vector<uint32_t> BruteForceCull(
+    const geometry::Frustum& frustum, const std::vector<mono_graphics_extension::CullingRenderable>& renderables)
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < renderables.size(); ++i)
+    {
+        if (!renderables[i].local_box.IsValid())
+        {
+            indices.push_back(i);
+            continue;
+        }
+
+        geometry::AABB world_box = geometry::TransformAABB(
+            renderables[i].local_box, XMLoadFloat4x4(&renderables[i].world_matrix));
+        if (geometry::TestFrustumAABB(frustum, world_box) != geometry::FrustumTestResult::Outside)
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+// Translate the world matrix of a renderable
+void MoveRenderable(mono_graphics_extension::CullingRenderable& renderable, const XMFLOAT3& offset)
+{
+    XMStoreFloat4x4(
+        &renderable.world_matrix,
+        XMLoadFloat4x4(&renderable.world_matrix) * XMMatrixTranslation(offset.x, offset.y, offset.z));
+}
+
+} // namespace renderable_culler_test
+
+TEST(RenderableCuller, UpdateResult)
+{
+    std::vector<mono_graphics_extension::CullingRenderable> renderables
+        = renderable_culler_test::MakeScatteredRenderables(1000, 100.0f, 1);
+
+    mono_graphics_extension::RenderableCuller culler;
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::None);
+
+    // The first update builds the BVH
+    culler.Update(renderables);
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Rebuilt);
+
+    // Nothing moved
+    culler.Update(renderables);
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Unchanged);
+    EXPECT_EQ(culler.GetLastMovedCount(), 0);
+
+    // A few renderables moved a little
+    for (uint32_t i = 0; i < 10; ++i)
+        renderable_culler_test::MoveRenderable(renderables[i * 100], XMFLOAT3(1.0f, 0.0f, 0.0f));
+    culler.Update(renderables);
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Refitted);
+    EXPECT_EQ(culler.GetLastMovedCount(), 10);
+    EXPECT_NEAR(culler.GetWorldBox(100).min.x, renderables[100].world_matrix._41 - 0.5f, 1e-4f);
+
+    // A renderable was removed
+    renderables.pop_back();
+    culler.Update(renderables);
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Rebuilt);
+}
+
+TEST(RenderableCuller, MatchesBruteForce)
+{
+    std::vector<mono_graphics_extension::CullingRenderable> renderables
+        = renderable_culler_test::MakeScatteredRenderables(5000, 200.0f, 2);
+
+    // Renderables without a box are never culled
+    renderables[10].local_box = geometry::AABB();
+    renderables[4000].local_box = geometry::AABB();
+    XMStoreFloat4x4(&renderables[10].world_matrix, XMMatrixTranslation(0.0f, 0.0f, -10000.0f));
+
+    mono_graphics_extension::RenderableCuller culler;
+    culler.Update(renderables);
+
+    geometry::Frustum frustum = renderable_culler_test::MakeCameraFrustum(XMFLOAT3(0.0f, 0.0f, -250.0f), 300.0f);
+    std::vector<uint32_t> visible_indices;
+    culler.Cull(frustum, visible_indices);
+    EXPECT_EQ(visible_indices, renderable_culler_test::BruteForceCull(frustum, renderables));
+    EXPECT_TRUE(std::binary_search(visible_indices.begin(), visible_indices.end(), 10));
+    EXPECT_TRUE(std::binary_search(visible_indices.begin(), visible_indices.end(), 4000));
+
+    // Move a part of the renderables and cull again after the refit
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+    for (uint32_t i = 0; i < renderables.size(); i += 7)
+        renderable_culler_test::MoveRenderable(renderables[i], XMFLOAT3(offset(random), offset(random), offset(random)));
+
+    culler.Update(renderables);
+    EXPECT_NE(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Unchanged);
+    culler.Cull(frustum, visible_indices);
+    EXPECT_EQ(visible_indices, renderable_culler_test::BruteForceCull(frustum, renderables));
+}
+
+TEST(RenderableCuller, Benchmark)
+{
+    constexpr size_t RENDERABLE_COUNT = 50000;
+    constexpr int REPEAT = 20;
+
+    std::vector<mono_graphics_extension::CullingRenderable> renderables
+        = renderable_culler_test::MakeScatteredRenderables(RENDERABLE_COUNT, 1000.0f, 42);
+    geometry::Frustum frustum = renderable_culler_test::MakeCameraFrustum(XMFLOAT3(0.0f, 0.0f, -1500.0f), 2000.0f);
+
+    // Test every renderable against the frustum
+    std::vector<uint32_t> brute_force_indices;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < REPEAT; ++r)
+        brute_force_indices = renderable_culler_test::BruteForceCull(frustum, renderables);
+    auto end = std::chrono::high_resolution_clock::now();
+    double brute_force_ms = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    // Build the BVH
+    mono_graphics_extension::RenderableCuller culler;
+    begin = std::chrono::high_resolution_clock::now();
+    culler.Update(renderables);
+    end = std::chrono::high_resolution_clock::now();
+    double build_ms = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    // Cull with the BVH
+    std::vector<uint32_t> visible_indices;
+    begin = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < REPEAT; ++r)
+        culler.Cull(frustum, visible_indices);
+    end = std::chrono::high_resolution_clock::now();
+    double cull_ms = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+    EXPECT_EQ(visible_indices, brute_force_indices);
+
+    // Move 1% of the renderables every frame and refit
+    std::mt19937 random(7);
+    std::uniform_int_distribution<size_t> index(0, RENDERABLE_COUNT - 1);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    double update_ms = 0.0;
+    for (int r = 0; r < REPEAT; ++r)
+    {
+        for (size_t i = 0; i < RENDERABLE_COUNT / 100; ++i)
+        {
+            renderable_culler_test::MoveRenderable(
+                renderables[index(random)], XMFLOAT3(offset(random), offset(random), offset(random)));
+        }
+
+        begin = std::chrono::high_resolution_clock::now();
+        culler.Update(renderables);
+        end = std::chrono::high_resolution_clock::now();
+        update_ms += std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+    update_ms /= REPEAT;
+    EXPECT_EQ(culler.GetLastUpdateResult(), mono_graphics_extension::RenderableCullerUpdateResult::Refitted);
+
+    culler.Cull(frustum, visible_indices);
+    EXPECT_EQ(visible_indices, renderable_culler_test::BruteForceCull(frustum, renderables));
+
+    std::cout << "Renderables: " << RENDERABLE_COUNT
+        << ", visible: " << visible_indices.size()
+        << ", brute force: " << brute_force_ms << " ms"
+        << ", BVH build: " << build_ms << " ms"
+        << ", BVH cull: " << cull_ms << " ms"
+        << ", refit after moving 1%: " << update_ms << " ms" << std::endl;
+}
\ No newline at end of file
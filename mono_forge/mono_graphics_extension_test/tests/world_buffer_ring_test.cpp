@@ -0,0 +1,262 @@
+﻿#include "mono_graphics_extension_test/pch.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#include "mono_graphics_service/include/graphics_command_list.h"
+#include "mono_graphics_extension/include/world_buffer_ring.h"
+using namespace DirectX;
+
+namespace world_buffer_ring_test
+{
+
+// The graphics command list recording the batched world buffer uploads instead of adding commands
+class MockGraphicsCommandList :
+    public mono_graphics_service::GraphicsCommandList
+{
+public:
+    MockGraphicsCommandList() = default;
+    ~MockGraphicsCommandList() override = default;
+
+    void UpdateWorldBuffersForGeometryPass(
+        const render_graph::ResourceHandle* const* buffer_handles,
+        const render_graph::geometry_pass::WorldBuffer* world_buffers_data, size_t count) override
+    {
+        call_count++;
+        last_buffer_handles = buffer_handles;
+        last_world_buffers = world_buffers_data;
+        last_count = count;
+    }
+
+    size_t call_count = 0;
+    const render_graph::ResourceHandle* const* last_buffer_handles = nullptr;
+    const render_graph::geometry_pass::WorldBuffer* last_world_buffers = nullptr;
+    size_t last_count = 0;
+};
+
+// The renderables driven by the tests
+struct Renderables
+{
+    std::vector<ecs::Entity> entities;
+    std::vector<render_graph::ResourceHandle> buffer_handles;
+    std::vector<XMFLOAT4X4> world_matrices;
+};
+
+Renderables MakeRenderables(size_t count)
+{
+    Renderables renderables;
+    for (size_t i = 0; i < count; ++i)
+    {
+        renderables.entities.emplace_back(i, 0);
+        renderables.buffer_handles.emplace_back(i, 0);
+
+        XMFLOAT4X4 world_matrix;
+        XMStoreFloat4x4(&world_matrix, XMMatrixTranslation(static_cast<float>(i), 0.0f, 0.0f));
+        renderables.world_matrices.push_back(world_matrix);
+    }
+    return renderables;
+}
+
+// Stage the renderables which need an upload, as GraphicsSystem does, and return the staged count
+size_t StageFrame(mono_graphics_extension::WorldBufferRing& ring, const Renderables& renderables)
+{
+    ring.BeginFrame();
+    for (size_t i = 0; i < renderables.entities.size(); ++i)
+    {
+        if (!ring.NeedsUpload(renderables.entities[i], &renderables.buffer_handles[i], renderables.world_matrices[i]))
+            continue;
+
+        XMMATRIX world_matrix = XMLoadFloat4x4(&renderables.world_matrices[i]);
+        ring.Stage(
+            renderables.entities[i], &renderables.buffer_handles[i], renderables.world_matrices[i],
+            XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix)));
+    }
+    return ring.GetStagedCount();
+}
+
+// Translate the world matrix of a renderable
+void MoveRenderable(Renderables& renderables, size_t index, float x)
+{
+    XMStoreFloat4x4(
+        &renderables.world_matrices[index],
+        XMLoadFloat4x4(&renderables.world_matrices[index]) * XMMatrixTranslation(x, 0.0f, 0.0f));
+}
+
+} // namespace world_buffer_ring_test
+
+TEST(WorldBufferRing, UploadsOnlyChanged)
+{
+    world_buffer_ring_test::Renderables renderables = world_buffer_ring_test::MakeRenderables(100);
+    mono_graphics_extension::WorldBufferRing ring;
+
+    // Every renderable is uploaded the first time
+    EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), 100);
+    EXPECT_EQ(ring.GetEntityCount(), 100);
+
+    world_buffer_ring_test::MockGraphicsCommandList command_list;
+    EXPECT_EQ(ring.Record(command_list), 100);
+    EXPECT_EQ(command_list.call_count, 1);
+    EXPECT_EQ(command_list.last_count, 100);
+    ring.EndFrame(1);
+
+    // Nothing moved, so nothing is staged nor recorded
+    EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), 0);
+    EXPECT_EQ(ring.Record(command_list), 0);
+    EXPECT_EQ(command_list.call_count, 1);
+    ring.EndFrame(0);
+
+    // Only the moved renderables are uploaded, contiguously
+    world_buffer_ring_test::MoveRenderable(renderables, 10, 1.0f);
+    world_buffer_ring_test::MoveRenderable(renderables, 70, -1.0f);
+    EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), 2);
+    EXPECT_EQ(ring.Record(command_list), 2);
+    EXPECT_EQ(command_list.call_count, 2);
+    ASSERT_EQ(command_list.last_count, 2);
+    EXPECT_EQ(command_list.last_buffer_handles[0], &renderables.buffer_handles[10]);
+    EXPECT_EQ(command_list.last_buffer_handles[1], &renderables.buffer_handles[70]);
+
+    // The world matrix is transposed for the shader
+    XMFLOAT4X4 uploaded;
+    XMStoreFloat4x4(&uploaded, XMMatrixTranspose(command_list.last_world_buffers[0].world_matrix));
+    EXPECT_EQ(std::memcmp(&uploaded, &renderables.world_matrices[10], sizeof(XMFLOAT4X4)), 0);
+    XMStoreFloat4x4(&uploaded, XMMatrixTranspose(command_list.last_world_buffers[1].world_matrix));
+    EXPECT_EQ(std::memcmp(&uploaded, &renderables.world_matrices[70], sizeof(XMFLOAT4X4)), 0);
+    ring.EndFrame(3);
+
+    // A recreated world buffer is uploaded even if the renderable did not move
+    render_graph::ResourceHandle recreated_handle(1000, 0);
+    ring.BeginFrame();
+    EXPECT_FALSE(ring.NeedsUpload(renderables.entities[5], &renderables.buffer_handles[5], renderables.world_matrices[5]));
+    EXPECT_TRUE(ring.NeedsUpload(renderables.entities[5], &recreated_handle, renderables.world_matrices[5]));
+}
+
+TEST(WorldBufferRing, FrameSlots)
+{
+    world_buffer_ring_test::Renderables renderables = world_buffer_ring_test::MakeRenderables(8);
+    mono_graphics_extension::WorldBufferRing ring(3);
+    EXPECT_EQ(ring.GetFrameCount(), 3);
+
+    // Nothing to wait for before the slots are used
+    EXPECT_EQ(ring.GetNextFrameProgress(), 0);
+
+    // Upload in every frame, each frame in the next slot
+    const render_graph::geometry_pass::WorldBuffer* slot_data[3] = {};
+    for (mono_service::ServiceProgress progress = 1; progress <= 3; ++progress)
+    {
+        world_buffer_ring_test::MoveRenderable(renderables, 0, 1.0f);
+        EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), (progress == 1) ? 8 : 1);
+        EXPECT_EQ(ring.GetFrameIndex(), progress - 1);
+        slot_data[progress - 1] = ring.GetStagedWorldBuffers();
+        ring.EndFrame(progress);
+    }
+    EXPECT_EQ(ring.GetLatestProgress(), 3);
+
+    // The slots hold separate data, so earlier frames stay valid while the service reads them
+    EXPECT_NE(slot_data[0], slot_data[1]);
+    EXPECT_NE(slot_data[1], slot_data[2]);
+
+    // The first slot is reused next, after the service reaches the progress of its submission
+    EXPECT_EQ(ring.GetNextFrameProgress(), 1);
+    world_buffer_ring_test::MoveRenderable(renderables, 0, 1.0f);
+    EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), 1);
+    EXPECT_EQ(ring.GetFrameIndex(), 0);
+
+    // The slot keeps its memory
+    EXPECT_EQ(ring.GetStagedWorldBuffers(), slot_data[0]);
+}
+
+TEST(WorldBufferRing, Retain)
+{
+    world_buffer_ring_test::Renderables renderables = world_buffer_ring_test::MakeRenderables(10);
+    mono_graphics_extension::WorldBufferRing ring;
+    world_buffer_ring_test::StageFrame(ring, renderables);
+    ring.EndFrame(1);
+
+    // Remove half of the renderables
+    std::vector<ecs::Entity> retained(renderables.entities.begin(), renderables.entities.begin() + 5);
+    ring.Retain(retained);
+    EXPECT_EQ(ring.GetEntityCount(), 5);
+
+    // The removed ones are uploaded again when they come back
+    EXPECT_EQ(world_buffer_ring_test::StageFrame(ring, renderables), 5);
+    EXPECT_EQ(ring.GetEntityCount(), 10);
+}
+
+TEST(WorldBufferRing, Benchmark)
+{
+    constexpr size_t RENDERABLE_COUNT = 10000;
+    constexpr size_t MOVED_COUNT = RENDERABLE_COUNT / 100;
+    constexpr int FRAME_COUNT = 100;
+
+    world_buffer_ring_test::Renderables renderables = world_buffer_ring_test::MakeRenderables(RENDERABLE_COUNT);
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> index(0, RENDERABLE_COUNT - 1);
+
+    // A world buffer per renderable and a command per renderable every frame, as GraphicsSystem did
+    size_t per_entity_allocation_count = 0;
+    size_t per_entity_command_count = 0;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        mono_graphics_service::GraphicsCommandList command_list;
+        for (size_t i = 0; i < RENDERABLE_COUNT; ++i)
+        {
+            XMMATRIX world_matrix = XMLoadFloat4x4(&renderables.world_matrices[i]);
+            std::unique_ptr<render_graph::geometry_pass::WorldBuffer> world_buffer
+                = std::make_unique<render_graph::geometry_pass::WorldBuffer>();
+            world_buffer->world_matrix = XMMatrixTranspose(world_matrix);
+            world_buffer->world_inverse_transpose = XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix));
+            per_entity_allocation_count++;
+
+            command_list.UpdateWorldBufferForGeometryPass(&renderables.buffer_handles[i], std::move(world_buffer));
+        }
+        per_entity_command_count += command_list.GetCommands().size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double per_entity_ms = std::chrono::duration<double, std::milli>(end - begin).count() / FRAME_COUNT;
+
+    // The ring, moving 1% of the renderables every frame
+    mono_graphics_extension::WorldBufferRing ring;
+    world_buffer_ring_test::StageFrame(ring, renderables);
+    ring.EndFrame(0);
+
+    size_t ring_upload_count = 0;
+    size_t ring_command_count = 0;
+    size_t ring_slot_growth_count = 0;
+    std::vector<const render_graph::geometry_pass::WorldBuffer*> slot_data(ring.GetFrameCount(), nullptr);
+    double ring_ms = 0.0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        for (size_t i = 0; i < MOVED_COUNT; ++i)
+            world_buffer_ring_test::MoveRenderable(renderables, index(random), 0.5f);
+
+        begin = std::chrono::high_resolution_clock::now();
+        mono_graphics_service::GraphicsCommandList command_list;
+        ring_upload_count += world_buffer_ring_test::StageFrame(ring, renderables);
+        ring.Record(command_list);
+        ring.EndFrame(0);
+        end = std::chrono::high_resolution_clock::now();
+        ring_ms += std::chrono::duration<double, std::milli>(end - begin).count();
+        ring_command_count += command_list.GetCommands().size();
+
+        // A slot allocates only when a frame stages more than it ever did
+        if (slot_data[ring.GetFrameIndex()] != ring.GetStagedWorldBuffers())
+            ring_slot_growth_count++;
+        slot_data[ring.GetFrameIndex()] = ring.GetStagedWorldBuffers();
+    }
+    ring_ms /= FRAME_COUNT;
+
+    EXPECT_EQ(ring_command_count, FRAME_COUNT);
+    EXPECT_LE(ring_upload_count, MOVED_COUNT * FRAME_COUNT);
+
+    std::cout << "Renderables: " << RENDERABLE_COUNT << ", moved per frame: " << MOVED_COUNT << std::endl
+        << "Per entity: " << per_entity_ms << " ms"
+        << ", allocations per frame: " << per_entity_allocation_count / FRAME_COUNT
+        << ", commands per frame: " << per_entity_command_count / FRAME_COUNT << std::endl
+        << "Ring: " << ring_ms << " ms"
+        << ", uploads per frame: " << ring_upload_count / FRAME_COUNT
+        << ", slot allocations in " << FRAME_COUNT << " frames: " << ring_slot_growth_count
+        << ", commands per frame: " << ring_command_count / FRAME_COUNT << std::endl;
+}
\ No newline at end of file
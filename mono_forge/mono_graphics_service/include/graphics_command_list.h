@@ -239,6 +239,12 @@ public:
         const render_graph::ResourceHandle* buffer_handle, 
         std::unique_ptr<render_graph::geometry_pass::WorldBuffer> world_buffer_data);
 
+    // Update world buffers data for geometry pass in render graph with a single command
+    // The arrays are not copied, they must stay valid until the service reaches the progress of the command list
+    virtual void UpdateWorldBuffersForGeometryPass(
+        const render_graph::ResourceHandle* const* buffer_handles,
+        const render_graph::geometry_pass::WorldBuffer* world_buffers_data, size_t count);
+
     // Update material data in render graph
     void UpdateMaterialBuffer(
         const render_graph::MaterialHandle* material_handle,
@@ -279,10 +285,12 @@ public:
     void CastShadow(const render_graph::LightHandle* light_handle);
 
     // Add draw shadow caster mesh command to geometry pass
+    // If the light handle is not null, the mesh is only rendered to the shadow map of the light
     void DrawShadowCasterMesh(
         const render_graph::ResourceHandle* world_matrix_buffer_handle,
         const render_graph::ResourceHandle* vertex_buffer_handle,
-        const render_graph::ResourceHandle* index_buffer_handle, uint32_t index_count);
+        const render_graph::ResourceHandle* index_buffer_handle, uint32_t index_count,
+        const render_graph::LightHandle* light_handle = nullptr);
 
     // Add shadowing pass to render graph
     void AddShadowingPassToGraph(UINT frame_index);
@@ -3,6 +3,7 @@
 #include "directx12_util/include/wrapper.h"
 #include "render_graph/include/render_graph.h"
 #include "render_graph/include/resource_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/heap_manager.h"
 #include "render_graph/include/command_manager.h"
 #include "render_graph/include/imgui_context_manager.h"
@@ -161,6 +162,9 @@ private:
      * Render Graph Resources
     /******************************************************************************************************************/
 
+    // The backend which the resources are created and the passes are recorded through
+    std::unique_ptr<render_graph::DirectX12RenderBackend> render_backend_ = nullptr;
+
     std::unique_ptr<render_graph::ResourceContainer> resource_container_ = nullptr;
     std::unique_ptr<render_graph::ResourceManager> resource_manager_ = nullptr;
     std::unique_ptr<render_graph::ResourceAdder> resource_adder_ = nullptr;
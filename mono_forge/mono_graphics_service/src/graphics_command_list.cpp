@@ -1289,6 +1289,41 @@ void GraphicsCommandList::UpdateWorldBufferForGeometryPass(
     });
 }
 
+void GraphicsCommandList::UpdateWorldBuffersForGeometryPass(
+    const render_graph::ResourceHandle* const* buffer_handles,
+    const render_graph::geometry_pass::WorldBuffer* world_buffers_data, size_t count)
+{
+    AddCommand([
+        buffer_handles, world_buffers_data, count](mono_service::ServiceAPI& api) -> bool
+    {
+        // Get graphics service API
+        static_assert(
+            std::is_base_of<mono_service::ServiceAPI, GraphicsServiceAPI>::value,
+            "GraphicsServiceAPI must be derived from ServiceAPI.");
+        GraphicsServiceAPI& graphics_service_api = dynamic_cast<GraphicsServiceAPI&>(api);
+
+        // Get buffer update pass
+        render_graph::RenderPassBase& pass 
+            = graphics_service_api.GetRenderPass(render_graph::BufferUploadPassHandle::ID());
+        render_graph::BufferUploadPass* buffer_update_pass 
+            = dynamic_cast<render_graph::BufferUploadPass*>(&pass);
+        assert(buffer_update_pass && "Failed to cast to BufferUploadPass.");
+
+        // Add buffer update task for each buffer, reading from the contiguous data
+        for (size_t i = 0; i < count; ++i)
+        {
+            render_graph::BufferUploadPass::UploadTask task;
+            task.buffer_handle = buffer_handles[i];
+            task.data = &world_buffers_data[i];
+            task.size = sizeof(render_graph::geometry_pass::WorldBuffer);
+            if (!buffer_update_pass->AddUploadTask(std::move(task)))
+                return false; // Failure
+        }
+
+        return true; // Success
+    });
+}
+
 void GraphicsCommandList::UpdateMaterialBuffer(
     const render_graph::MaterialHandle* material_handle,
     std::unique_ptr<render_graph::Material::SetupParam> material_setup_param)
@@ -1626,10 +1661,11 @@ void GraphicsCommandList::CastShadow(const render_graph::LightHandle* light_hand
 void GraphicsCommandList::DrawShadowCasterMesh(
     const render_graph::ResourceHandle* world_matrix_buffer_handle,
     const render_graph::ResourceHandle* vertex_buffer_handle,
-    const render_graph::ResourceHandle* index_buffer_handle, uint32_t index_count)
+    const render_graph::ResourceHandle* index_buffer_handle, uint32_t index_count,
+    const render_graph::LightHandle* light_handle)
 {
     AddCommand([
-        world_matrix_buffer_handle, vertex_buffer_handle, index_buffer_handle, index_count]
+        world_matrix_buffer_handle, vertex_buffer_handle, index_buffer_handle, index_count, light_handle]
         (mono_service::ServiceAPI& api) -> bool
     {
         // Get graphics service API
@@ -1651,6 +1687,7 @@ void GraphicsCommandList::DrawShadowCasterMesh(
         mesh_info.vertex_buffer_handle = vertex_buffer_handle;
         mesh_info.index_buffer_handle = index_buffer_handle;
         mesh_info.index_count = index_count;
+        mesh_info.light_handle = light_handle;
         shadowing_pass->AddShadowCasterMeshInfo(std::move(mesh_info));
 
         return true; // Success
@@ -101,6 +101,7 @@ GraphicsService::~GraphicsService()
     resource_adder_.reset();
     resource_eraser_.reset();
     resource_container_.reset();
+    render_backend_.reset();
 
     /*******************************************************************************************************************
      * Descriptor Heaps and Heap Manager Cleanup
@@ -157,6 +158,9 @@ bool GraphicsService::Setup(mono_service::Service::SetupParam& param)
      * Initialize Render Graph Resources
     /******************************************************************************************************************/
 
+    // Create render backend
+    render_backend_ = std::make_unique<render_graph::DirectX12RenderBackend>();
+
     // Create resource container
     resource_container_ = std::make_unique<render_graph::ResourceContainer>();
 
@@ -164,10 +168,10 @@ bool GraphicsService::Setup(mono_service::Service::SetupParam& param)
     resource_manager_ = std::make_unique<render_graph::ResourceManager>(*resource_container_);
 
     // Create resource adder
-    resource_adder_ = std::make_unique<render_graph::ResourceAdder>(*resource_container_);
+    resource_adder_ = std::make_unique<render_graph::ResourceAdder>(*resource_container_, *render_backend_);
 
     // Create resource eraser
-    resource_eraser_ = std::make_unique<render_graph::ResourceEraser>(*resource_container_);
+    resource_eraser_ = std::make_unique<render_graph::ResourceEraser>(*resource_container_, *render_backend_);
 
     /*******************************************************************************************************************
      * Initialize Descriptor Heaps and Heap Manager
@@ -591,7 +595,7 @@ bool GraphicsService::Update()
 
         // Create render pass context
         std::unique_ptr<render_graph::RenderPassContext> context
-            = std::make_unique<render_graph::RenderPassContext>(command_set->GetCommandList());
+            = std::make_unique<render_graph::RenderPassContext>(*render_backend_, command_set->GetCommandList());
 
         // Execute render graph
         result = render_graph_->Execute(*context);
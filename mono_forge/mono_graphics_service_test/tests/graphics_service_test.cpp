@@ -380,7 +380,7 @@ TEST(GraphicsService, Execute)
 
     // Submit command list to graphics service
     mono_service::ServiceProgress progress = graphics_service_proxy->SubmitCommandList(std::move(command_list));
-    ASSERT_EQ(progress, graphics_service_proxy->GetProgress());
+    ASSERT_FALSE(graphics_service_proxy->IsComplete(progress));
 
     /*******************************************************************************************************************
      * Update graphics service
@@ -403,8 +403,8 @@ TEST(GraphicsService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     bool is_runnning = true;
@@ -799,8 +799,8 @@ TEST(GraphicsService, Rendering)
             = dynamic_cast<mono_graphics_service::GraphicsService&>(service);
 
         // Check progress
-        // Progress should have advanced by 1 after one update cycle
-        ASSERT_EQ(graphics_service.GetProgress(), progress + 1);
+        // Progress should have reached the fence value of the command list after one update cycle
+        ASSERT_EQ(graphics_service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -1,7 +1,7 @@
 #include "mono_meta_extension/src/pch.h"
 #include "mono_meta_extension/include/allocator_factory.h"
 
-#include "memory_allocator/include/fixed_block_allocator.h"
+#include "memory_allocator/include/growable_block_allocator.h"
 
 namespace mono_meta_extension
 {
@@ -9,7 +9,7 @@ namespace mono_meta_extension
 std::unique_ptr<memory_allocator::Allocator> ComponentAllocatorFactory::Create(
     memory_allocator::Pool& pool, size_t block_size) const
 {
-    return std::make_unique<memory_allocator::FixedBlockAllocator>(pool, block_size);
+    return std::make_unique<memory_allocator::GrowableBlockAllocator>(pool, block_size);
 }
 
 void ComponentAllocatorFactory::Destroy(
@@ -20,7 +20,7 @@ void ComponentAllocatorFactory::Destroy(
 
 size_t ComponentAllocatorFactory::GetProductSize() const
 {
-    return sizeof(memory_allocator::FixedBlockAllocator);
+    return sizeof(memory_allocator::GrowableBlockAllocator);
 }
 
 } // namespace mono_meta_extension
\ No newline at end of file
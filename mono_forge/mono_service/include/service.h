@@ -1,5 +1,8 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <vector>
 
 #include "class_template/non_copy.h"
@@ -19,6 +22,14 @@ class Service;
 // Type alias for service fence
 using ServiceProgress = uint64_t;
 
+// The result of waiting for a service progress
+enum class ServiceWaitResult
+{
+    Complete, // The service reached the progress
+    Timeout, // The timeout expired before the service reached the progress
+    Shutdown, // The service was shut down before it reached the progress
+};
+
 // The proxy class for services
 // It provides limited access to the service for external users
 class MONO_SERVICE_DLL ServiceProxy
@@ -28,9 +39,11 @@ public:
     ~ServiceProxy() = default;
 
     // Create a new command list for the associated service
+    // The command list takes its arena from the service's arena pool
     std::unique_ptr<ServiceCommandList> CreateCommandList();
 
     // Submit a command list to the associated service
+    // Returns the fence value, the progress the service reaches once the command list has been executed
     ServiceProgress SubmitCommandList(std::unique_ptr<ServiceCommandList> command_list);
 
     // Create a view for the associated service
@@ -39,6 +52,13 @@ public:
     // Get the current service progress from the associated service
     ServiceProgress GetProgress() const;
 
+    // Check if the associated service has reached the progress, without blocking
+    bool IsComplete(ServiceProgress progress) const;
+
+    // Block until the associated service reaches the progress, the timeout expires or the service is shut down
+    // It must not be called from the thread updating the service, which would never reach the progress
+    ServiceWaitResult WaitForProgress(ServiceProgress progress, std::chrono::milliseconds timeout) const;
+
     // Clone the service proxy
     std::unique_ptr<ServiceProxy> Clone();
 
@@ -64,14 +84,19 @@ public:
     class SetupParam
     {
     public:
-        SetupParam(size_t command_queue_buffer_count) :
-            command_queue_buffer_count_(command_queue_buffer_count)
+        SetupParam(
+            size_t command_queue_buffer_count, size_t command_queue_capacity = DEFAULT_COMMAND_QUEUE_CAPACITY) :
+            command_queue_buffer_count_(command_queue_buffer_count),
+            command_queue_capacity_(command_queue_capacity)
         {
         }
         virtual ~SetupParam() = default;
 
         // The number of command queue buffers
         const size_t command_queue_buffer_count_;
+
+        // The number of command lists each command queue holds without locking, a power of two
+        const size_t command_queue_capacity_;
     };
 
     // Setup the service with the given setup parameters
@@ -108,7 +133,8 @@ public:
     // Submit a command list to the service's command queue
     // Submitted command lists will be executed in the Update function
     // It will be call by ServiceProxy, so this function required thread-safe
-    // You can use lock logic in ThreadSafer mix-in class
+    // It is lock-free, command lists submitted by the same thread are executed in the submitted order
+    // Returns the fence value, the progress the service reaches once the command list has been executed
     ServiceProgress SubmitCommandList(std::unique_ptr<ServiceCommandList> command_list);
 
     // Get the current service progress
@@ -116,6 +142,23 @@ public:
     // You can use lock logic in ThreadSafer mix-in class
     ServiceProgress GetProgress() const;
 
+    // Check if the service has reached the progress
+    // It is thread-safe and never blocks, even while the service is updating
+    bool IsComplete(ServiceProgress progress) const;
+
+    // Block until the service reaches the progress, the timeout expires or the service is shut down
+    // It is thread-safe, but must not be called from the thread updating the service
+    ServiceWaitResult WaitForProgress(ServiceProgress progress, std::chrono::milliseconds timeout) const;
+
+    // Wake all threads waiting for a progress, and make later waits return ServiceWaitResult::Shutdown
+    // It is called by the destructor, which also waits for the woken threads to leave WaitForProgress
+    void Shutdown();
+
+    // Get the pool of command arenas shared by the command lists of this service
+    // Arenas return to it when executed command lists are destroyed, and are reused by the next recorded ones
+    // It is thread-safe
+    const std::shared_ptr<ServiceCommandArenaPool>& GetCommandArenaPool() const;
+
     // Create a view for the service
     // The view provides a way to interact with the service's data and functionality
     // You can create derived classes to implement specific views for different services
@@ -144,20 +187,42 @@ private:
     // Queue of service commands
     std::vector<std::unique_ptr<ServiceCommandQueue>> command_queues_;
 
-    // Current command queue index for round-robin submission
-    int current_command_queue_index_ = 0;
+    // Pool of command arenas recycled through the command queue rotation
+    // It is shared with the command lists, so lists destroyed after the service can still return their arenas
+    std::shared_ptr<ServiceCommandArenaPool> command_arena_pool_;
+
+    // The frame whose command queue records submitted command lists, counted up by BeginFrame
+    // The record command queue index is derived from it, so a submitted command list and its fence value always agree
+    // Command lists recorded for frame N are executed in frame N + 1, whose EndFrame sets the progress to N + 1
+    std::atomic<ServiceProgress> recording_frame_ = 0;
+
+    // The number of threads inside SubmitCommandList
+    // BeginFrame waits for it to be zero, so no command list is added to the executable queue after the switch
+    std::atomic<size_t> submitting_count_ = 0;
 
     // Current executable command queue index
     int executable_command_queue_index_ = INVALID_COMMAND_QUEUE_INDEX;
 
     // The progress value of the service
-    ServiceProgress progress_ = 0;
+    std::atomic<ServiceProgress> progress_ = 0;
+
+    // Guards the waits for the progress
+    mutable std::mutex progress_mutex_;
+
+    // Notified when the progress is updated or the service is shut down
+    mutable std::condition_variable progress_condition_;
+
+    // Notified when the last waiting thread leaves WaitForProgress after shutdown
+    mutable std::condition_variable waiter_exit_condition_;
+
+    // The number of threads inside WaitForProgress
+    mutable size_t waiting_count_ = 0;
+
+    // Whether the service has been shut down
+    bool shutdown_ = false;
 
     // Lock held during frame processing
     std::unique_lock<std::shared_mutex> holding_lock_;
-
-    // Mutex for queue operations
-    mutable std::shared_mutex queue_mutex_;
 };
 
 } // namespace mono_service
\ No newline at end of file
@@ -1,9 +1,14 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <memory>
 #include <queue>
 #include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
 
 #include "class_template/non_copy.h"
 #include "class_template/thread_safer.h"
@@ -51,6 +56,118 @@ private:
     Func func_;
 };
 
+// The class holding service commands inline in reusable memory blocks
+// Commands are constructed in place by bump allocation and destroyed in bulk by Reset
+// Reset keeps the blocks, so a reused arena allocates nothing once it has grown enough
+// Blocks start at the initial size and double up to the block size, so a short-lived arena stays small
+class MONO_SERVICE_DLL ServiceCommandArena :
+    public class_template::NonCopyable
+{
+public:
+    // The default size of a memory block
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    // The initial block size of an arena which is not reused through a pool
+    static constexpr size_t SMALL_INITIAL_BLOCK_SIZE = 512;
+
+    ServiceCommandArena(
+        size_t block_size = DEFAULT_BLOCK_SIZE, size_t initial_block_size = DEFAULT_BLOCK_SIZE);
+    ~ServiceCommandArena();
+
+    // Construct a service command in the arena
+    template <typename Func>
+    void AddCommand(Func func)
+    {
+        using Decayed = std::decay_t<Func>;
+        using CommandType = ServiceCommandImpl<Decayed>;
+
+        // Construct the command in place
+        void* memory = Allocate(sizeof(CommandType), alignof(CommandType));
+        CommandType* command = new (memory) CommandType(std::move(func));
+        PushCommand(commands_, command);
+
+        // Only commands holding non-trivial captures need their destructor called
+        if (!std::is_trivially_destructible_v<Decayed>)
+            PushCommand(destructible_commands_, command);
+    }
+
+    // Get the list of service commands in the order they were added
+    const std::vector<ServiceCommand*>& GetCommands() const { return commands_; }
+
+    // Destroy all commands and rewind the blocks for reuse
+    void Reset();
+
+    // Get the number of memory blocks
+    size_t GetBlockCount() const { return blocks_.size(); }
+
+    // Get the total size of the memory blocks
+    size_t GetReservedSize() const;
+
+    // Get the number of heap allocations made by the arena since it was created
+    // It counts the memory blocks and the growth of the command lists
+    size_t GetAllocationCount() const { return allocation_count_; }
+
+private:
+    // Allocate memory from the blocks, a new block is added if no block has enough space
+    void* Allocate(size_t size, size_t alignment);
+
+    // Add the command to the list, counting the growth of the list as an allocation
+    void PushCommand(std::vector<ServiceCommand*>& commands, ServiceCommand* command);
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    // The maximum size of a new memory block
+    const size_t block_size_;
+
+    // The size of the next new memory block
+    size_t next_block_size_;
+
+    // The number of heap allocations made by the arena
+    size_t allocation_count_ = 0;
+
+    // The memory blocks and the current position in them
+    std::vector<Block> blocks_;
+    size_t block_index_ = 0;
+    size_t block_offset_ = 0;
+
+    // The commands in the order they were added
+    std::vector<ServiceCommand*> commands_;
+
+    // The commands whose destructor must be called
+    std::vector<ServiceCommand*> destructible_commands_;
+};
+
+// The thread-safe pool of service command arenas
+// Command lists take an arena from it and return it when they are destroyed after execution
+class MONO_SERVICE_DLL ServiceCommandArenaPool :
+    public class_template::NonCopyable
+{
+public:
+    ServiceCommandArenaPool() = default;
+    ~ServiceCommandArenaPool() = default;
+
+    // Take an arena from the pool, a new one is created if the pool is empty
+    std::unique_ptr<ServiceCommandArena> Acquire();
+
+    // Reset the arena and return it to the pool
+    void Release(std::unique_ptr<ServiceCommandArena> arena);
+
+    // Get the number of arenas created by the pool
+    size_t GetCreatedCount() const;
+
+    // Get the number of arenas waiting in the pool
+    size_t GetPooledCount() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ServiceCommandArena>> arenas_;
+    size_t created_count_ = 0;
+};
+
 // The class representing a list of service commands
 // It holds multiple service commands to be executed in sequence
 // You can create derived classes to implement specific command lists and add commands from the derived classes
@@ -59,37 +176,53 @@ class MONO_SERVICE_DLL ServiceCommandList :
 {
 public:
     ServiceCommandList() = default;
-    virtual ~ServiceCommandList() = default;
+    virtual ~ServiceCommandList();
 
     // Get the list of service commands
-    const std::vector<std::unique_ptr<ServiceCommand>>& GetCommands() const;
+    const std::vector<ServiceCommand*>& GetCommands() const;
+
+    // Set the pool to take the arena from, the arena is returned to it when the list is destroyed
+    // It must be called before any command is added
+    void SetArenaPool(std::shared_ptr<ServiceCommandArenaPool> arena_pool);
 
 protected:
     // Add a service command to the list
     template <typename Func>
     void AddCommand(Func func)
     {
-        using Decayed = std::decay_t<Func>;
-        using CommandType = ServiceCommandImpl<Decayed>;
-
-        // Add the command to the list
-        commands_.emplace_back(std::make_unique<CommandType>(std::move(func)));
+        // Construct the command in the arena
+        GetArena().AddCommand(std::move(func));
     }
 
 private:
-    std::vector<std::unique_ptr<ServiceCommand>> commands_;
+    // Get the arena, it is taken from the pool or created on first use
+    ServiceCommandArena& GetArena();
+
+    // The pool the arena is taken from, null if the list owns its arena
+    std::shared_ptr<ServiceCommandArenaPool> arena_pool_;
+
+    // The arena holding the commands
+    std::unique_ptr<ServiceCommandArena> arena_;
 };
 
+// The default number of command lists a command queue holds without falling back to its overflow list
+constexpr size_t DEFAULT_COMMAND_QUEUE_CAPACITY = 1024;
+
 // The class representing a service command queue
 // It holds and manages service command lists
+// Command lists are enqueued into a bounded lock-free ring, so many threads can submit without a mutex
+// The order of command lists enqueued by the same thread is kept
+// When the ring is full, command lists go to a mutex-guarded overflow list which is dequeued after the ring
+// It must be dequeued only by one thread at a time, after the threads enqueueing into it have finished
 class MONO_SERVICE_DLL ServiceCommandQueue :
     public class_template::NonCopyable
 {
 public:
-    ServiceCommandQueue() = default;
-    virtual ~ServiceCommandQueue() = default;
+    ServiceCommandQueue(size_t capacity = DEFAULT_COMMAND_QUEUE_CAPACITY);
+    virtual ~ServiceCommandQueue();
 
     // Enqueue a service command list
+    // It is thread-safe and lock-free unless the ring is full
     void EnqueueCommandList(std::unique_ptr<ServiceCommandList> command_list);
 
     // Dequeue a service command list
@@ -98,9 +231,39 @@ public:
     // Check if the queue is empty
     bool IsEmpty() const;
 
+    // Get the number of command lists the ring holds
+    size_t GetCapacity() const { return capacity_; }
+
 private:
-    // Queue of service command lists
-    std::queue<std::unique_ptr<ServiceCommandList>> command_lists_;
+    // Try to enqueue the command list into the ring, returns false if the ring is full
+    bool TryEnqueueRing(ServiceCommandList* command_list);
+
+    struct Slot
+    {
+        // The position the slot is ready for
+        // It equals the position when the slot can be written, and the position + 1 when it can be read
+        std::atomic<size_t> sequence;
+
+        ServiceCommandList* command_list = nullptr;
+    };
+
+    // The number of slots, a power of two
+    const size_t capacity_;
+
+    // The ring of slots
+    std::unique_ptr<Slot[]> slots_;
+
+    // The next position to enqueue, shared by the enqueueing threads
+    // It is on its own cache line so that enqueueing does not invalidate the dequeue position
+    alignas(64) std::atomic<size_t> enqueue_pos_ = 0;
+
+    // The next position to dequeue, only used by the dequeueing thread
+    alignas(64) size_t dequeue_pos_ = 0;
+
+    // Command lists enqueued while the ring was full
+    std::queue<std::unique_ptr<ServiceCommandList>> overflow_command_lists_;
+    std::atomic<bool> has_overflow_ = false;
+    std::mutex overflow_mutex_;
 };
 
 } // namespace mono_service
\ No newline at end of file
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "class_template/non_copy.h"
+
+#include "mono_service/include/dll_config.h"
+#include "mono_service/include/thread_affinity.h"
+#include "mono_service/include/service.h"
+#include "mono_service/include/service_registry.h"
+
+namespace mono_service
+{
+
+// bool(Service&)
+using ServiceUpdateFunc = std::function<bool(Service&)>;
+
+// The pool of persistent worker threads updating services
+// Each thread affinity has its own worker which lives as long as the pool,
+// so services of the same thread affinity always run on the same OS thread
+// Services with the main thread affinity run on the thread calling RunPhase
+class MONO_SERVICE_DLL ServiceThreadPool :
+    public class_template::NonCopyable
+{
+public:
+    ServiceThreadPool(ServiceThreadAffinityID main_thread_affinity_id);
+    ~ServiceThreadPool();
+
+    // Run a phase, such as PreUpdate, Update or PostUpdate, for the services
+    // Services of the same thread affinity are updated in the given order, different ones in parallel
+    // It returns after all services are updated, which is the barrier between phases
+    // Returns false if any update function failed
+    bool RunPhase(
+        ServiceRegistry& registry, const std::vector<ServiceHandleID>& order, const ServiceUpdateFunc& update_func);
+
+    // Get the number of worker threads
+    size_t GetWorkerCount() const;
+
+    // Get the OS thread ID of the worker for the thread affinity
+    // It is a default ID if the thread affinity has no worker yet
+    std::thread::id GetWorkerThreadID(ServiceThreadAffinityID thread_affinity_id) const;
+
+private:
+    struct Worker
+    {
+        std::thread thread;
+
+        // The services to update in the current phase
+        std::vector<Service*> services;
+
+        // The result of the current phase
+        bool result = true;
+
+        // The last phase the worker started
+        uint64_t started_phase = 0;
+    };
+
+    // The loop of worker threads
+    void WorkerLoop(Worker& worker);
+
+    // The thread affinity whose services run on the calling thread
+    const ServiceThreadAffinityID main_thread_affinity_id_;
+
+    // The workers for each thread affinity
+    std::unordered_map<ServiceThreadAffinityID, std::unique_ptr<Worker>> workers_;
+
+    // The services with the main thread affinity in the current phase
+    std::vector<Service*> main_thread_services_;
+
+    // Guards the members below and the services of workers
+    mutable std::mutex mutex_;
+
+    // Notified when a phase starts or the pool stops
+    std::condition_variable phase_start_condition_;
+
+    // Notified when all workers finished the phase
+    std::condition_variable phase_end_condition_;
+
+    // The current phase, incremented every RunPhase
+    uint64_t phase_ = 0;
+
+    // The number of workers which have not finished the current phase
+    size_t running_worker_count_ = 0;
+
+    // The update function of the current phase
+    const ServiceUpdateFunc* update_func_ = nullptr;
+
+    // Whether the workers must exit
+    bool stop_ = false;
+};
+
+} // namespace mono_service
\ No newline at end of file
@@ -4,4 +4,8 @@
 #include <cassert>
 #include <memory>
 #include <type_traits>
-#include <functional>
\ No newline at end of file
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
\ No newline at end of file
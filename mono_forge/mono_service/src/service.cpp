@@ -1,6 +1,8 @@
 ﻿#include "mono_service/src/pch.h"
 #include "mono_service/include/service.h"
 
+#include <thread>
+
 #include "utility_header/logger.h"
 
 namespace mono_service
@@ -8,7 +10,12 @@ namespace mono_service
 
 std::unique_ptr<ServiceCommandList> ServiceProxy::CreateCommandList()
 {
-    return service_.CreateCommandList();
+    std::unique_ptr<ServiceCommandList> command_list = service_.CreateCommandList();
+
+    // Let the command list use the service's arena pool
+    command_list->SetArenaPool(service_.GetCommandArenaPool());
+
+    return command_list;
 }
 
 ServiceProgress ServiceProxy::SubmitCommandList(std::unique_ptr<ServiceCommandList> command_list)
@@ -26,6 +33,16 @@ ServiceProgress ServiceProxy::GetProgress() const
     return service_.GetProgress();
 }
 
+bool ServiceProxy::IsComplete(ServiceProgress progress) const
+{
+    return service_.IsComplete(progress);
+}
+
+ServiceWaitResult ServiceProxy::WaitForProgress(ServiceProgress progress, std::chrono::milliseconds timeout) const
+{
+    return service_.WaitForProgress(progress, timeout);
+}
+
 std::unique_ptr<ServiceProxy> mono_service::ServiceProxy::Clone()
 {
     // Create a new ServiceProxy for the same service
@@ -33,12 +50,18 @@ std::unique_ptr<ServiceProxy> mono_service::ServiceProxy::Clone()
 }
 
 Service::Service(ServiceThreadAffinityID thread_affinity_id) :
-    thread_affinity_id_(thread_affinity_id)
+    thread_affinity_id_(thread_affinity_id),
+    command_arena_pool_(std::make_shared<ServiceCommandArenaPool>())
 {
 }
 
 Service::~Service()
 {
+    // Wake the waiting threads and wait for them to leave before the condition variables are destroyed
+    Shutdown();
+
+    std::unique_lock<std::mutex> lock(progress_mutex_);
+    waiter_exit_condition_.wait(lock, [this]() { return waiting_count_ == 0; });
 }
 
 bool Service::Setup(SetupParam& param)
@@ -47,7 +70,7 @@ bool Service::Setup(SetupParam& param)
 
     // Create service command queues
     for (size_t i = 0; i < param.command_queue_buffer_count_; ++i)
-        command_queues_.emplace_back(std::make_unique<ServiceCommandQueue>());
+        command_queues_.emplace_back(std::make_unique<ServiceCommandQueue>(param.command_queue_capacity_));
 
     // Mark as set up
     setup_ = true;
@@ -91,17 +114,20 @@ bool Service::IsSetup() const
 
 ServiceProgress Service::SubmitCommandList(std::unique_ptr<ServiceCommandList> command_list)
 {
-    // Lock for unique access in queue operations
-    std::unique_lock<std::shared_mutex> queue_lock = std::unique_lock<std::shared_mutex>(queue_mutex_);
-
     assert(setup_ && "Service must be set up before submitting command lists.");
     assert(command_list != nullptr && "Command list must not be null.");
 
-    // Enqueue the command list to the current command queue
-    command_queues_[current_command_queue_index_]->EnqueueCommandList(std::move(command_list));
+    // Mark this thread as submitting before reading the queue index, BeginFrame waits for it
+    submitting_count_.fetch_add(1);
 
-    // Return the current progress
-    return progress_;
+    // Enqueue the command list to the command queue of the recording frame
+    ServiceProgress recording_frame = recording_frame_.load();
+    command_queues_[recording_frame % command_queues_.size()]->EnqueueCommandList(std::move(command_list));
+
+    submitting_count_.fetch_sub(1);
+
+    // The command list is executed in the next frame, which ends with this progress
+    return recording_frame + 1;
 }
 
 ServiceProgress Service::GetProgress() const
@@ -113,6 +139,50 @@ ServiceProgress Service::GetProgress() const
     return progress_;
 }
 
+bool Service::IsComplete(ServiceProgress progress) const
+{
+    return progress_.load() >= progress;
+}
+
+ServiceWaitResult Service::WaitForProgress(ServiceProgress progress, std::chrono::milliseconds timeout) const
+{
+    // Return without locking if the progress is already reached
+    if (IsComplete(progress))
+        return ServiceWaitResult::Complete;
+
+    std::unique_lock<std::mutex> lock(progress_mutex_);
+    ++waiting_count_;
+
+    // Wait for the progress or the shutdown
+    progress_condition_.wait_for(lock, timeout, [&]() { return shutdown_ || IsComplete(progress); });
+
+    ServiceWaitResult result = ServiceWaitResult::Timeout;
+    if (IsComplete(progress))
+        result = ServiceWaitResult::Complete;
+    else if (shutdown_)
+        result = ServiceWaitResult::Shutdown;
+
+    // Let the destructor know the last waiting thread has left
+    if (--waiting_count_ == 0 && shutdown_)
+        waiter_exit_condition_.notify_all();
+
+    return result;
+}
+
+void Service::Shutdown()
+{
+    {
+        std::unique_lock<std::mutex> lock(progress_mutex_);
+        shutdown_ = true;
+    }
+    progress_condition_.notify_all();
+}
+
+const std::shared_ptr<ServiceCommandArenaPool>& Service::GetCommandArenaPool() const
+{
+    return command_arena_pool_;
+}
+
 ServiceCommandQueue& Service::GetExecutableCommandQueue()
 {
     assert(holding_lock_.owns_lock() && "Must hold unique lock to get executable command queue.");
@@ -122,34 +192,37 @@ ServiceCommandQueue& Service::GetExecutableCommandQueue()
 
 void Service::BeginFrame()
 {
-    // Lock for unique access in queue operations
-    std::unique_lock<std::shared_mutex> queue_lock = std::unique_lock<std::shared_mutex>(queue_mutex_);
-
     // Set unique lock for thread-safe access
     holding_lock_ = LockUnique();
 
     // Store the current executable command queue index
-    executable_command_queue_index_ = current_command_queue_index_;
-
-    // Switch to next command queue
-    current_command_queue_index_ = (current_command_queue_index_ + 1) % command_queues_.size();
+    ServiceProgress recording_frame = recording_frame_.load();
+    executable_command_queue_index_ = static_cast<int>(recording_frame % command_queues_.size());
 
-    // Check the new record queue is empty
+    // Check the next record queue is empty
     assert(
-        command_queues_[current_command_queue_index_]->IsEmpty() && 
+        command_queues_[(recording_frame + 1) % command_queues_.size()]->IsEmpty() && 
         "Record command queue is not empty at the beginning of the frame. Did you forget to execute commands?");
+
+    // Switch to next command queue
+    recording_frame_.store(recording_frame + 1);
+
+    // Wait for the threads which may still be submitting to the executable command queue
+    while (submitting_count_.load() != 0)
+        std::this_thread::yield();
 }
 
 void Service::EndFrame()
 {
-    // Lock for unique access in queue operations
-    std::unique_lock<std::shared_mutex> queue_lock = std::unique_lock<std::shared_mutex>(queue_mutex_);
-
     // Clear the executable command queue index
     executable_command_queue_index_ = INVALID_COMMAND_QUEUE_INDEX;
 
-    // Update the progress value
-    ++progress_;
+    // Update the progress value and wake the threads waiting for it
+    {
+        std::unique_lock<std::mutex> lock(progress_mutex_);
+        progress_.fetch_add(1);
+    }
+    progress_condition_.notify_all();
 
     // Release the unique lock
     holding_lock_.unlock();
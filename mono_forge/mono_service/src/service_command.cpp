@@ -4,33 +4,266 @@
 namespace mono_service
 {
 
-const std::vector<std::unique_ptr<ServiceCommand>>& ServiceCommandList::GetCommands() const
+ServiceCommandArena::ServiceCommandArena(size_t block_size, size_t initial_block_size) :
+    block_size_(block_size),
+    next_block_size_(std::min(initial_block_size, block_size))
 {
-    return commands_;
+    assert(block_size_ > 0 && "Block size must be greater than zero.");
+    assert(next_block_size_ > 0 && "Initial block size must be greater than zero.");
+}
+
+ServiceCommandArena::~ServiceCommandArena()
+{
+    Reset();
+}
+
+void ServiceCommandArena::Reset()
+{
+    // Destroy the commands in the order they were added
+    for (ServiceCommand* command : destructible_commands_)
+        command->~ServiceCommand();
+
+    commands_.clear();
+    destructible_commands_.clear();
+
+    // Rewind to the first block
+    block_index_ = 0;
+    block_offset_ = 0;
+}
+
+size_t ServiceCommandArena::GetReservedSize() const
+{
+    size_t reserved_size = 0;
+    for (const Block& block : blocks_)
+        reserved_size += block.size;
+    return reserved_size;
+}
+
+void* ServiceCommandArena::Allocate(size_t size, size_t alignment)
+{
+    assert((alignment & (alignment - 1)) == 0 && "Alignment must be a power of two.");
+
+    while (true)
+    {
+        if (block_index_ == blocks_.size())
+        {
+            // Add a new block, large enough for the allocation
+            Block block;
+            block.size = std::max(next_block_size_, size + alignment);
+            block.data = std::make_unique<std::byte[]>(block.size);
+            blocks_.emplace_back(std::move(block));
+            ++allocation_count_;
+
+            // The next block is twice as large, up to the block size
+            next_block_size_ = std::min(next_block_size_ * 2, block_size_);
+        }
+
+        // Try to allocate from the current block
+        Block& block = blocks_[block_index_];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        uintptr_t aligned = (base + block_offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        size_t end_offset = static_cast<size_t>(aligned - base) + size;
+        if (end_offset <= block.size)
+        {
+            block_offset_ = end_offset;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // Move to the next block
+        ++block_index_;
+        block_offset_ = 0;
+    }
+}
+
+void ServiceCommandArena::PushCommand(std::vector<ServiceCommand*>& commands, ServiceCommand* command)
+{
+    size_t capacity = commands.capacity();
+    commands.push_back(command);
+
+    if (commands.capacity() != capacity)
+        ++allocation_count_;
+}
+
+std::unique_ptr<ServiceCommandArena> ServiceCommandArenaPool::Acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (arenas_.empty())
+    {
+        ++created_count_;
+        return std::make_unique<ServiceCommandArena>();
+    }
+
+    // Take the most recently returned arena, its blocks are likely still in cache
+    std::unique_ptr<ServiceCommandArena> arena = std::move(arenas_.back());
+    arenas_.pop_back();
+    return arena;
+}
+
+void ServiceCommandArenaPool::Release(std::unique_ptr<ServiceCommandArena> arena)
+{
+    assert(arena != nullptr && "Arena must not be null.");
+
+    // Destroy the commands outside the lock
+    arena->Reset();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    arenas_.emplace_back(std::move(arena));
+}
+
+size_t ServiceCommandArenaPool::GetCreatedCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return created_count_;
+}
+
+size_t ServiceCommandArenaPool::GetPooledCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return arenas_.size();
+}
+
+ServiceCommandList::~ServiceCommandList()
+{
+    if (arena_ == nullptr)
+        return; // No commands were added
+
+    // Return the arena to the pool, the commands are destroyed there
+    if (arena_pool_ != nullptr)
+        arena_pool_->Release(std::move(arena_));
+}
+
+const std::vector<ServiceCommand*>& ServiceCommandList::GetCommands() const
+{
+    // The list without any command has no arena
+    static const std::vector<ServiceCommand*> empty_commands;
+    return (arena_ != nullptr) ? arena_->GetCommands() : empty_commands;
+}
+
+void ServiceCommandList::SetArenaPool(std::shared_ptr<ServiceCommandArenaPool> arena_pool)
+{
+    assert(arena_ == nullptr && "Arena pool must be set before adding commands.");
+    arena_pool_ = std::move(arena_pool);
+}
+
+ServiceCommandArena& ServiceCommandList::GetArena()
+{
+    if (arena_ == nullptr)
+    {
+        // Take the arena from the pool if there is one
+        // The list owning its arena starts small because the arena is freed with the list
+        arena_ = (arena_pool_ != nullptr) ?
+            arena_pool_->Acquire() :
+            std::make_unique<ServiceCommandArena>(
+                ServiceCommandArena::DEFAULT_BLOCK_SIZE, ServiceCommandArena::SMALL_INITIAL_BLOCK_SIZE);
+    }
+
+    return *arena_;
+}
+
+ServiceCommandQueue::ServiceCommandQueue(size_t capacity) :
+    capacity_(std::max<size_t>(2, capacity))
+{
+    assert((capacity_ & (capacity_ - 1)) == 0 && "Command queue capacity must be a power of two.");
+
+    // Each slot is ready to be written at its own position
+    slots_ = std::make_unique<Slot[]>(capacity_);
+    for (size_t i = 0; i < capacity_; ++i)
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+ServiceCommandQueue::~ServiceCommandQueue()
+{
+    // Destroy the command lists which were not dequeued
+    while (!IsEmpty())
+        DequeueCommandList();
 }
 
 void ServiceCommandQueue::EnqueueCommandList(std::unique_ptr<ServiceCommandList> command_list)
 {
-    // Add the command list to the queue
-    command_lists_.emplace(std::move(command_list));
+    assert(command_list != nullptr && "Command list must not be null.");
+
+    // Add the command list to the ring
+    if (TryEnqueueRing(command_list.get()))
+    {
+        command_list.release(); // Owned by the ring
+        return;
+    }
+
+    // The ring is full, add the command list to the overflow list
+    // The ring stays full until it is dequeued, so later command lists of this thread also go here
+    std::unique_lock<std::mutex> lock(overflow_mutex_);
+    overflow_command_lists_.emplace(std::move(command_list));
+    has_overflow_.store(true, std::memory_order_release);
 }
 
 std::unique_ptr<ServiceCommandList> ServiceCommandQueue::DequeueCommandList()
 {
-    assert(!command_lists_.empty() && "Attempted to dequeue from an empty command queue.");
+    assert(!IsEmpty() && "Attempted to dequeue from an empty command queue.");
+
+    Slot& slot = slots_[dequeue_pos_ & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1)
+    {
+        // Take the command list from the ring
+        std::unique_ptr<ServiceCommandList> command_list(slot.command_list);
+        slot.command_list = nullptr;
 
-    // Get the front command list
-    std::unique_ptr<ServiceCommandList> command_list = std::move(command_lists_.front());
+        // Make the slot ready to be written in the next lap
+        slot.sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+        ++dequeue_pos_;
 
-    // Remove the front command list from the queue
-    command_lists_.pop();
+        return command_list; // Return the dequeued command list
+    }
+
+    // The ring is empty, take the command list from the overflow list
+    std::unique_lock<std::mutex> lock(overflow_mutex_);
+    std::unique_ptr<ServiceCommandList> command_list = std::move(overflow_command_lists_.front());
+    overflow_command_lists_.pop();
+    has_overflow_.store(!overflow_command_lists_.empty(), std::memory_order_release);
 
     return command_list; // Return the dequeued command list
 }
 
 bool ServiceCommandQueue::IsEmpty() const
 {
-    return command_lists_.empty();
+    const Slot& slot = slots_[dequeue_pos_ & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1)
+        return false; // The ring has a command list
+
+    return !has_overflow_.load(std::memory_order_acquire);
+}
+
+bool ServiceCommandQueue::TryEnqueueRing(ServiceCommandList* command_list)
+{
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots_[pos & (capacity_ - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0)
+        {
+            // The slot is ready to be written, reserve the position
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                // Write the command list and publish it to the dequeueing thread
+                slot.command_list = command_list;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // Another thread reserved the position, pos is reloaded by compare_exchange_weak
+        }
+        else if (diff < 0)
+        {
+            return false; // The slot is not dequeued yet, the ring is full
+        }
+        else
+        {
+            // Another thread has written the slot, retry with the latest position
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
 }
 
 } // namespace mono_service
\ No newline at end of file
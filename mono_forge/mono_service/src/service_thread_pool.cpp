@@ -0,0 +1,148 @@
+﻿#include "mono_service/src/pch.h"
+#include "mono_service/include/service_thread_pool.h"
+
+namespace mono_service
+{
+
+ServiceThreadPool::ServiceThreadPool(ServiceThreadAffinityID main_thread_affinity_id) :
+    main_thread_affinity_id_(main_thread_affinity_id)
+{
+}
+
+ServiceThreadPool::~ServiceThreadPool()
+{
+    // Stop all workers
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    phase_start_condition_.notify_all();
+
+    for (auto& [thread_affinity_id, worker] : workers_)
+        worker->thread.join();
+}
+
+bool ServiceThreadPool::RunPhase(
+    ServiceRegistry& registry, const std::vector<ServiceHandleID>& order, const ServiceUpdateFunc& update_func)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        assert(running_worker_count_ == 0 && "Previous phase is still running.");
+
+        // Assign services to the workers of their thread affinity
+        // The lists keep their capacity, so nothing is allocated once all workers exist
+        for (auto& [thread_affinity_id, worker] : workers_)
+            worker->services.clear();
+        main_thread_services_.clear();
+
+        for (const ServiceHandleID& service_id : order)
+        {
+            // Get service
+            Service& service = registry.Get(service_id);
+
+            // Get thread affinity ID
+            ServiceThreadAffinityID thread_affinity_id = service.GetThreadAffinityID();
+
+            if (thread_affinity_id == main_thread_affinity_id_)
+            {
+                main_thread_services_.push_back(&service);
+                continue; // Run on this thread
+            }
+
+            std::unique_ptr<Worker>& worker = workers_[thread_affinity_id];
+            if (worker == nullptr)
+            {
+                // Create the worker for the new thread affinity
+                worker = std::make_unique<Worker>();
+                worker->started_phase = phase_;
+                worker->thread = std::thread(&ServiceThreadPool::WorkerLoop, this, std::ref(*worker));
+            }
+            worker->services.push_back(&service);
+        }
+
+        // Start the phase
+        running_worker_count_ = 0;
+        for (auto& [thread_affinity_id, worker] : workers_)
+        {
+            if (!worker->services.empty())
+                ++running_worker_count_;
+        }
+        update_func_ = &update_func;
+        ++phase_;
+    }
+    phase_start_condition_.notify_all();
+
+    // Update services with the main thread affinity
+    bool result = true;
+    for (Service* service : main_thread_services_)
+    {
+        if (!update_func(*service))
+            result = false;
+    }
+
+    // Wait for all workers to finish the phase
+    std::unique_lock<std::mutex> lock(mutex_);
+    phase_end_condition_.wait(lock, [this]() { return running_worker_count_ == 0; });
+    update_func_ = nullptr;
+
+    for (auto& [thread_affinity_id, worker] : workers_)
+    {
+        if (!worker->services.empty() && !worker->result)
+            result = false;
+    }
+
+    return result;
+}
+
+size_t ServiceThreadPool::GetWorkerCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return workers_.size();
+}
+
+std::thread::id ServiceThreadPool::GetWorkerThreadID(ServiceThreadAffinityID thread_affinity_id) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = workers_.find(thread_affinity_id);
+    if (it == workers_.end())
+        return std::thread::id();
+
+    return it->second->thread.get_id();
+}
+
+void ServiceThreadPool::WorkerLoop(Worker& worker)
+{
+    while (true)
+    {
+        const ServiceUpdateFunc* update_func = nullptr;
+        {
+            // Wait for the next phase
+            std::unique_lock<std::mutex> lock(mutex_);
+            phase_start_condition_.wait(lock, [&]() { return stop_ || phase_ != worker.started_phase; });
+            if (stop_)
+                return;
+
+            worker.started_phase = phase_;
+            if (worker.services.empty())
+                continue; // Nothing to update in this phase
+
+            update_func = update_func_;
+        }
+
+        // Update services, the services are not changed until this worker finishes the phase
+        bool result = true;
+        for (Service* service : worker.services)
+        {
+            if (!(*update_func)(*service))
+                result = false;
+        }
+
+        // Finish the phase
+        std::unique_lock<std::mutex> lock(mutex_);
+        worker.result = result;
+        if (--running_worker_count_ == 0)
+            phase_end_condition_.notify_one();
+    }
+}
+
+} // namespace mono_service
\ No newline at end of file
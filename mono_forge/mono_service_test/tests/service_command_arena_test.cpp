@@ -0,0 +1,384 @@
+﻿#include "mono_service_test/pch.h"
+
+#include <array>
+
+#include "mono_service/include/service.h"
+#include "mono_service/include/service_command.h"
+#include "mono_service/include/service_view.h"
+
+namespace service_command_arena_test
+{
+
+constexpr size_t TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT = 2;
+
+class TestServiceAPI :
+    public mono_service::ServiceAPI
+{
+public:
+    TestServiceAPI() = default;
+    virtual ~TestServiceAPI() override = default;
+
+    // The values recorded by the commands
+    std::vector<int> values;
+};
+
+class TestServiceCommandList :
+    public mono_service::ServiceCommandList
+{
+public:
+    TestServiceCommandList() = default;
+    virtual ~TestServiceCommandList() override = default;
+
+    // Add a command recording the value
+    void RecordValue(int value)
+    {
+        AddCommand([value](mono_service::ServiceAPI& service_api)
+        {
+            TestServiceAPI* test_api = dynamic_cast<TestServiceAPI*>(&service_api);
+            if (test_api == nullptr)
+                return false;
+
+            test_api->values.push_back(value);
+            return true;
+        });
+    }
+
+    // Add a command with any callable object
+    template <typename Func>
+    void Add(Func func)
+    {
+        AddCommand(std::move(func));
+    }
+};
+
+class TestServiceView :
+    public mono_service::ServiceView
+{
+public:
+    TestServiceView(const mono_service::ServiceAPI& service_api) :
+        mono_service::ServiceView(service_api)
+    {
+    }
+
+    virtual ~TestServiceView() override = default;
+};
+
+class TestService :
+    public mono_service::Service,
+    private TestServiceAPI
+{
+public:
+    TestService() : Service(0)
+    {
+    }
+
+    virtual ~TestService() override = default;
+
+    virtual bool PreUpdate() override
+    {
+        BeginFrame();
+        return Service::PreUpdate();
+    }
+
+    virtual bool Update() override
+    {
+        if (!Service::Update())
+            return false;
+
+        // Execute all enqueued command lists
+        while (!GetExecutableCommandQueue().IsEmpty())
+        {
+            std::unique_ptr<mono_service::ServiceCommandList> command_list
+                = GetExecutableCommandQueue().DequeueCommandList();
+
+            for (const auto& command : command_list->GetCommands())
+            {
+                if (!command->Execute(GetAPI()))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    virtual bool PostUpdate() override
+    {
+        bool result = Service::PostUpdate();
+        EndFrame();
+        return result;
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceCommandList> CreateCommandList() override
+    {
+        return std::make_unique<TestServiceCommandList>();
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceView> CreateView() override
+    {
+        return std::make_unique<TestServiceView>(GetAPI());
+    }
+
+    // Get the values recorded by the executed commands
+    std::vector<int>& GetValues()
+    {
+        return values;
+    }
+
+private:
+    TestServiceAPI& GetAPI()
+    {
+        return static_cast<TestServiceAPI&>(*this);
+    }
+};
+
+// Run a frame of the service
+bool RunFrame(mono_service::Service& service)
+{
+    return service.PreUpdate() && service.Update() && service.PostUpdate();
+}
+
+// The object counting its destructions
+struct DestructionCounter
+{
+    DestructionCounter(int& count) : count_(&count) {}
+    DestructionCounter(DestructionCounter&& other) noexcept : count_(other.count_) { other.count_ = nullptr; }
+    ~DestructionCounter() { if (count_ != nullptr) ++(*count_); }
+
+    DestructionCounter(const DestructionCounter&) = delete;
+    DestructionCounter& operator=(const DestructionCounter&) = delete;
+
+    int* count_;
+};
+
+} // namespace service_command_arena_test
+
+TEST(ServiceCommandArena, Ordering)
+{
+    service_command_arena_test::TestServiceAPI api;
+    service_command_arena_test::TestServiceCommandList command_list;
+
+    // Mix small captures and captures larger than a block
+    constexpr int COMMAND_COUNT = 2000;
+    for (int i = 0; i < COMMAND_COUNT; ++i)
+    {
+        if (i % 100 == 0)
+        {
+            std::array<int, mono_service::ServiceCommandArena::DEFAULT_BLOCK_SIZE / sizeof(int)> large = {};
+            large.back() = i;
+            command_list.Add([large](mono_service::ServiceAPI& service_api)
+            {
+                dynamic_cast<service_command_arena_test::TestServiceAPI&>(service_api).values.push_back(large.back());
+                return true;
+            });
+        }
+        else
+        {
+            command_list.RecordValue(i);
+        }
+    }
+
+    ASSERT_EQ(command_list.GetCommands().size(), COMMAND_COUNT);
+    for (const auto& command : command_list.GetCommands())
+        EXPECT_TRUE(command->Execute(api));
+
+    ASSERT_EQ(api.values.size(), COMMAND_COUNT);
+    for (int i = 0; i < COMMAND_COUNT; ++i)
+        EXPECT_EQ(api.values[i], i);
+}
+
+TEST(ServiceCommandArena, Destruction)
+{
+    int destruction_count = 0;
+    {
+        service_command_arena_test::TestServiceCommandList command_list;
+        for (int i = 0; i < 100; ++i)
+        {
+            service_command_arena_test::DestructionCounter counter(destruction_count);
+            command_list.Add([counter = std::move(counter)](mono_service::ServiceAPI&) { return true; });
+        }
+
+        // Moved-from captures don't count, the commands are still alive
+        EXPECT_EQ(destruction_count, 0);
+    }
+
+    // The commands are destroyed with the list
+    EXPECT_EQ(destruction_count, 100);
+
+    // The commands are destroyed when the arena returns to the pool, and the arena is reused
+    std::shared_ptr<mono_service::ServiceCommandArenaPool> arena_pool
+        = std::make_shared<mono_service::ServiceCommandArenaPool>();
+
+    destruction_count = 0;
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        service_command_arena_test::TestServiceCommandList command_list;
+        command_list.SetArenaPool(arena_pool);
+        for (int i = 0; i < 10; ++i)
+        {
+            service_command_arena_test::DestructionCounter counter(destruction_count);
+            command_list.Add([counter = std::move(counter)](mono_service::ServiceAPI&) { return true; });
+        }
+    }
+
+    EXPECT_EQ(destruction_count, 30);
+    EXPECT_EQ(arena_pool->GetCreatedCount(), 1);
+    EXPECT_EQ(arena_pool->GetPooledCount(), 1);
+}
+
+TEST(ServiceCommandArena, MoveOnlyCapture)
+{
+    service_command_arena_test::TestServiceAPI api;
+    service_command_arena_test::TestServiceCommandList command_list;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::unique_ptr<int> value = std::make_unique<int>(i * 10);
+        command_list.Add([value = std::move(value)](mono_service::ServiceAPI& service_api)
+        {
+            dynamic_cast<service_command_arena_test::TestServiceAPI&>(service_api).values.push_back(*value);
+            return true;
+        });
+    }
+
+    for (const auto& command : command_list.GetCommands())
+        EXPECT_TRUE(command->Execute(api));
+
+    ASSERT_EQ(api.values.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(api.values[i], i * 10);
+}
+
+TEST(ServiceCommandArena, QueueRotation)
+{
+    service_command_arena_test::TestService service;
+    mono_service::Service::SetupParam setup_param(
+        service_command_arena_test::TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT);
+    ASSERT_TRUE(service.Setup(setup_param));
+
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service.CreateServiceProxy();
+    const std::shared_ptr<mono_service::ServiceCommandArenaPool>& arena_pool = service.GetCommandArenaPool();
+
+    constexpr int FRAME_COUNT = 10;
+    constexpr int LIST_COUNT = 4;
+    constexpr int COMMAND_COUNT = 1000;
+
+    int expected_value = 0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        // Record command lists for this frame
+        for (int list = 0; list < LIST_COUNT; ++list)
+        {
+            std::unique_ptr<mono_service::ServiceCommandList> command_list = service_proxy->CreateCommandList();
+            service_command_arena_test::TestServiceCommandList* test_command_list
+                = dynamic_cast<service_command_arena_test::TestServiceCommandList*>(command_list.get());
+            ASSERT_NE(test_command_list, nullptr);
+
+            for (int i = 0; i < COMMAND_COUNT; ++i)
+                test_command_list->RecordValue(expected_value++);
+
+            service_proxy->SubmitCommandList(std::move(command_list));
+        }
+
+        ASSERT_TRUE(service_command_arena_test::RunFrame(service));
+
+        // The executed lists returned their arenas
+        EXPECT_EQ(arena_pool->GetPooledCount(), arena_pool->GetCreatedCount());
+    }
+
+    // The arenas are reused every frame
+    EXPECT_EQ(arena_pool->GetCreatedCount(), LIST_COUNT);
+
+    // The commands were executed in the submission order
+    ASSERT_EQ(service.GetValues().size(), static_cast<size_t>(expected_value));
+    for (int i = 0; i < expected_value; ++i)
+        ASSERT_EQ(service.GetValues()[i], i);
+}
+
+TEST(ServiceCommandArena, AllocationCount)
+{
+    constexpr int FRAME_COUNT = 100;
+    constexpr int COMMAND_COUNT = 10000;
+
+    service_command_arena_test::TestServiceAPI api;
+    api.values.reserve(COMMAND_COUNT);
+
+    // The command captures as much as a transform update
+    struct TransformUpdate
+    {
+        float values[10];
+        int index;
+    };
+    auto make_command = [](int index)
+    {
+        TransformUpdate update = {};
+        update.index = index;
+        return [update](mono_service::ServiceAPI& service_api)
+        {
+            static_cast<service_command_arena_test::TestServiceAPI&>(service_api).values.push_back(update.index);
+            return true;
+        };
+    };
+
+    // The arena recycled through the pool allocates only while it grows in the first frame
+    std::shared_ptr<mono_service::ServiceCommandArenaPool> arena_pool
+        = std::make_shared<mono_service::ServiceCommandArenaPool>();
+
+    size_t grown_allocation_count = 0;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        api.values.clear();
+        {
+            service_command_arena_test::TestServiceCommandList command_list;
+            command_list.SetArenaPool(arena_pool);
+            for (int i = 0; i < COMMAND_COUNT; ++i)
+                command_list.Add(make_command(i));
+
+            for (const auto& command : command_list.GetCommands())
+                EXPECT_TRUE(command->Execute(api));
+        }
+        ASSERT_EQ(api.values.size(), COMMAND_COUNT);
+
+        // Look at the arena returned to the pool
+        std::unique_ptr<mono_service::ServiceCommandArena> arena = arena_pool->Acquire();
+        if (frame == 0)
+        {
+            grown_allocation_count = arena->GetAllocationCount();
+            EXPECT_GT(grown_allocation_count, 0);
+        }
+        else
+        {
+            EXPECT_EQ(arena->GetAllocationCount(), grown_allocation_count);
+        }
+        arena_pool->Release(std::move(arena));
+    }
+
+    EXPECT_EQ(arena_pool->GetCreatedCount(), 1);
+}
+
+TEST(ServiceCommandArena, SmallInitialBlock)
+{
+    mono_service::ServiceCommandArena arena(
+        mono_service::ServiceCommandArena::DEFAULT_BLOCK_SIZE,
+        mono_service::ServiceCommandArena::SMALL_INITIAL_BLOCK_SIZE);
+
+    // Nothing is allocated before the first command
+    EXPECT_EQ(arena.GetBlockCount(), 0);
+    EXPECT_EQ(arena.GetAllocationCount(), 0);
+
+    // A few small commands fit in the initial block
+    for (int i = 0; i < 4; ++i)
+        arena.AddCommand([i](mono_service::ServiceAPI&) { return i >= 0; });
+
+    EXPECT_EQ(arena.GetBlockCount(), 1);
+    EXPECT_EQ(arena.GetReservedSize(), mono_service::ServiceCommandArena::SMALL_INITIAL_BLOCK_SIZE);
+
+    // The blocks double while the arena grows, up to the block size
+    for (int i = 0; i < 10000; ++i)
+        arena.AddCommand([i](mono_service::ServiceAPI&) { return i >= 0; });
+
+    EXPECT_GT(arena.GetBlockCount(), 1);
+    EXPECT_LE(
+        arena.GetReservedSize(),
+        arena.GetBlockCount() * mono_service::ServiceCommandArena::DEFAULT_BLOCK_SIZE);
+    EXPECT_EQ(arena.GetCommands().size(), 10004);
+}
\ No newline at end of file
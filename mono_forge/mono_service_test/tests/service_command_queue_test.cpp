@@ -0,0 +1,286 @@
+﻿#include "mono_service_test/pch.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "mono_service/include/service.h"
+#include "mono_service/include/service_command.h"
+#include "mono_service/include/service_view.h"
+
+namespace service_command_queue_test
+{
+
+constexpr size_t PRODUCER_COUNT = 8;
+constexpr size_t TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT = 2;
+
+// The command list recording which producer submitted it and in which order
+class TestServiceCommandList :
+    public mono_service::ServiceCommandList
+{
+public:
+    TestServiceCommandList(size_t producer, size_t sequence) :
+        producer_(producer),
+        sequence_(sequence)
+    {
+    }
+
+    virtual ~TestServiceCommandList() override = default;
+
+    size_t GetProducer() const { return producer_; }
+    size_t GetSequence() const { return sequence_; }
+
+private:
+    const size_t producer_;
+    const size_t sequence_;
+};
+
+class TestServiceView :
+    public mono_service::ServiceView
+{
+public:
+    TestServiceView(const mono_service::ServiceAPI& service_api) :
+        mono_service::ServiceView(service_api)
+    {
+    }
+
+    virtual ~TestServiceView() override = default;
+};
+
+// The service checking the order of the command lists it executes
+class TestService :
+    public mono_service::Service,
+    private mono_service::ServiceAPI
+{
+public:
+    TestService() :
+        Service(0)
+    {
+    }
+
+    virtual ~TestService() override = default;
+
+    virtual bool PreUpdate() override
+    {
+        BeginFrame();
+        return Service::PreUpdate();
+    }
+
+    virtual bool Update() override
+    {
+        // Execute the command lists in the executable queue
+        while (!GetExecutableCommandQueue().IsEmpty())
+        {
+            std::unique_ptr<mono_service::ServiceCommandList> command_list
+                = GetExecutableCommandQueue().DequeueCommandList();
+            Execute(static_cast<const TestServiceCommandList&>(*command_list));
+        }
+
+        return Service::Update();
+    }
+
+    virtual bool PostUpdate() override
+    {
+        bool result = Service::PostUpdate();
+        EndFrame();
+        return result;
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceCommandList> CreateCommandList() override
+    {
+        return std::make_unique<TestServiceCommandList>(0, 0);
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceView> CreateView() override
+    {
+        return std::make_unique<TestServiceView>(static_cast<mono_service::ServiceAPI&>(*this));
+    }
+
+    // Get the number of executed command lists for each producer
+    const std::vector<size_t>& GetExecutedCounts() const { return executed_counts_; }
+
+    // Whether every producer's command lists were executed in the submitted order
+    bool IsInOrder() const { return in_order_; }
+
+private:
+    void Execute(const TestServiceCommandList& command_list)
+    {
+        if (executed_counts_.size() <= command_list.GetProducer())
+            executed_counts_.resize(command_list.GetProducer() + 1, 0);
+
+        // The sequence must be the next one of the producer
+        size_t& executed_count = executed_counts_[command_list.GetProducer()];
+        if (command_list.GetSequence() != executed_count)
+            in_order_ = false;
+        ++executed_count;
+    }
+
+    std::vector<size_t> executed_counts_;
+    bool in_order_ = true;
+};
+
+// Run a frame of the service
+void RunFrame(TestService& service)
+{
+    service.PreUpdate();
+    service.Update();
+    service.PostUpdate();
+}
+
+// Enqueue command lists from the producers at the same time
+// The command lists are created before the producers start, so only the enqueueing overlaps
+void EnqueueConcurrently(
+    mono_service::ServiceCommandQueue& queue, size_t producer_count, size_t list_count_per_producer)
+{
+    std::vector<std::vector<std::unique_ptr<mono_service::ServiceCommandList>>> command_lists(producer_count);
+    for (size_t producer = 0; producer < producer_count; ++producer)
+    {
+        for (size_t sequence = 0; sequence < list_count_per_producer; ++sequence)
+            command_lists[producer].emplace_back(std::make_unique<TestServiceCommandList>(producer, sequence));
+    }
+
+    std::atomic<size_t> ready_count = 0;
+    std::atomic<bool> start = false;
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producer_count; ++producer)
+    {
+        producers.emplace_back([&, producer]()
+        {
+            ++ready_count;
+            while (!start.load())
+                std::this_thread::yield();
+
+            for (std::unique_ptr<mono_service::ServiceCommandList>& command_list : command_lists[producer])
+                queue.EnqueueCommandList(std::move(command_list));
+        });
+    }
+
+    while (ready_count.load() != producer_count)
+        std::this_thread::yield();
+
+    start = true;
+    for (std::thread& producer : producers)
+        producer.join();
+}
+
+// Dequeue all command lists and check each producer's command lists are in the submitted order
+void ExpectAllInOrder(mono_service::ServiceCommandQueue& queue, size_t producer_count, size_t list_count_per_producer)
+{
+    std::vector<size_t> next_sequences(producer_count, 0);
+    while (!queue.IsEmpty())
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list = queue.DequeueCommandList();
+        const TestServiceCommandList& test_command_list = static_cast<const TestServiceCommandList&>(*command_list);
+
+        ASSERT_EQ(test_command_list.GetSequence(), next_sequences[test_command_list.GetProducer()]);
+        ++next_sequences[test_command_list.GetProducer()];
+    }
+
+    for (size_t producer = 0; producer < producer_count; ++producer)
+        EXPECT_EQ(next_sequences[producer], list_count_per_producer);
+}
+
+} // namespace service_command_queue_test
+
+TEST(ServiceCommandQueue, MultiProducerOrder)
+{
+    constexpr size_t LIST_COUNT_PER_PRODUCER = 20000;
+
+    // All command lists fit in the ring
+    {
+        mono_service::ServiceCommandQueue queue(256 * 1024);
+        service_command_queue_test::EnqueueConcurrently(
+            queue, service_command_queue_test::PRODUCER_COUNT, LIST_COUNT_PER_PRODUCER);
+        service_command_queue_test::ExpectAllInOrder(
+            queue, service_command_queue_test::PRODUCER_COUNT, LIST_COUNT_PER_PRODUCER);
+    }
+
+    // Most command lists go to the overflow list
+    {
+        mono_service::ServiceCommandQueue queue(64);
+        service_command_queue_test::EnqueueConcurrently(
+            queue, service_command_queue_test::PRODUCER_COUNT, LIST_COUNT_PER_PRODUCER);
+        service_command_queue_test::ExpectAllInOrder(
+            queue, service_command_queue_test::PRODUCER_COUNT, LIST_COUNT_PER_PRODUCER);
+    }
+}
+
+TEST(ServiceCommandQueue, Reuse)
+{
+    mono_service::ServiceCommandQueue queue(8);
+
+    // Go around the ring many times, with and without overflow
+    size_t sequence = 0;
+    for (size_t round = 0; round < 100; ++round)
+    {
+        size_t count = round % 20;
+        for (size_t i = 0; i < count; ++i)
+            queue.EnqueueCommandList(std::make_unique<service_command_queue_test::TestServiceCommandList>(0, sequence + i));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            ASSERT_FALSE(queue.IsEmpty());
+            std::unique_ptr<mono_service::ServiceCommandList> command_list = queue.DequeueCommandList();
+            EXPECT_EQ(
+                static_cast<const service_command_queue_test::TestServiceCommandList&>(*command_list).GetSequence(),
+                sequence + i);
+        }
+        EXPECT_TRUE(queue.IsEmpty());
+        sequence += count;
+    }
+
+    // Command lists left in the queue are destroyed with it
+    queue.EnqueueCommandList(std::make_unique<service_command_queue_test::TestServiceCommandList>(0, 0));
+}
+
+TEST(ServiceCommandQueue, SubmitDuringFrames)
+{
+    constexpr size_t LIST_COUNT_PER_PRODUCER = 20000;
+
+    // A small capacity so that the overflow list is also used
+    service_command_queue_test::TestService service;
+    mono_service::Service::SetupParam setup_param(service_command_queue_test::TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT, 128);
+    ASSERT_TRUE(service.Setup(setup_param));
+
+    // Submit from the producers while the service switches and executes its queues
+    std::atomic<size_t> finished_count = 0;
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < service_command_queue_test::PRODUCER_COUNT; ++producer)
+    {
+        producers.emplace_back([&, producer]()
+        {
+            std::unique_ptr<mono_service::ServiceProxy> service_proxy = service.CreateServiceProxy();
+            for (size_t sequence = 0; sequence < LIST_COUNT_PER_PRODUCER; ++sequence)
+            {
+                service_proxy->SubmitCommandList(
+                    std::make_unique<service_command_queue_test::TestServiceCommandList>(producer, sequence));
+
+                // Let the frames run between submissions
+                if (sequence % 16 == 0)
+                    std::this_thread::yield();
+            }
+            ++finished_count;
+        });
+    }
+
+    size_t frame_count = 0;
+    while (finished_count.load() != service_command_queue_test::PRODUCER_COUNT)
+    {
+        service_command_queue_test::RunFrame(service);
+        ++frame_count;
+    }
+
+    for (std::thread& producer : producers)
+        producer.join();
+
+    // The last submitted command lists are executed in the next frame
+    service_command_queue_test::RunFrame(service);
+    service_command_queue_test::RunFrame(service);
+
+    std::cout << "Frames while submitting: " << frame_count << std::endl;
+
+    EXPECT_TRUE(service.IsInOrder());
+    ASSERT_EQ(service.GetExecutedCounts().size(), service_command_queue_test::PRODUCER_COUNT);
+    for (size_t executed_count : service.GetExecutedCounts())
+        EXPECT_EQ(executed_count, LIST_COUNT_PER_PRODUCER);
+}
\ No newline at end of file
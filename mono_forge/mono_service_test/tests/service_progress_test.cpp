@@ -0,0 +1,304 @@
+﻿#include "mono_service_test/pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mono_service/include/service.h"
+#include "mono_service/include/service_command.h"
+#include "mono_service/include/service_view.h"
+
+namespace service_progress_test
+{
+
+constexpr size_t TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT = 2;
+
+// The timeout long enough not to expire in the tests
+constexpr std::chrono::milliseconds LONG_TIMEOUT = std::chrono::milliseconds(10000);
+
+class TestServiceCommandList :
+    public mono_service::ServiceCommandList
+{
+public:
+    TestServiceCommandList() = default;
+    virtual ~TestServiceCommandList() override = default;
+
+    // Add a command setting the value when executed
+    void SetValue(std::atomic<int>* target, int value)
+    {
+        AddCommand([target, value](mono_service::ServiceAPI&)
+        {
+            target->store(value);
+            return true;
+        });
+    }
+};
+
+class TestServiceView :
+    public mono_service::ServiceView
+{
+public:
+    TestServiceView(const mono_service::ServiceAPI& service_api) :
+        mono_service::ServiceView(service_api)
+    {
+    }
+
+    virtual ~TestServiceView() override = default;
+};
+
+class TestService :
+    public mono_service::Service,
+    private mono_service::ServiceAPI
+{
+public:
+    TestService() :
+        Service(0)
+    {
+    }
+
+    virtual ~TestService() override = default;
+
+    virtual bool PreUpdate() override
+    {
+        BeginFrame();
+        return Service::PreUpdate();
+    }
+
+    virtual bool Update() override
+    {
+        // Execute the command lists in the executable queue
+        while (!GetExecutableCommandQueue().IsEmpty())
+        {
+            std::unique_ptr<mono_service::ServiceCommandList> command_list
+                = GetExecutableCommandQueue().DequeueCommandList();
+            for (mono_service::ServiceCommand* command : command_list->GetCommands())
+                command->Execute(*this);
+        }
+
+        return Service::Update();
+    }
+
+    virtual bool PostUpdate() override
+    {
+        bool result = Service::PostUpdate();
+        EndFrame();
+        return result;
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceCommandList> CreateCommandList() override
+    {
+        return std::make_unique<TestServiceCommandList>();
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceView> CreateView() override
+    {
+        return std::make_unique<TestServiceView>(static_cast<mono_service::ServiceAPI&>(*this));
+    }
+};
+
+// Create a set up test service
+std::unique_ptr<TestService> CreateTestService()
+{
+    std::unique_ptr<TestService> service = std::make_unique<TestService>();
+    mono_service::Service::SetupParam setup_param(TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT);
+    service->Setup(setup_param);
+    return service;
+}
+
+// Submit a command list setting the value, and return its fence value
+mono_service::ServiceProgress SubmitSetValue(mono_service::ServiceProxy& service_proxy, std::atomic<int>* target, int value)
+{
+    std::unique_ptr<mono_service::ServiceCommandList> command_list = service_proxy.CreateCommandList();
+    dynamic_cast<TestServiceCommandList&>(*command_list).SetValue(target, value);
+    return service_proxy.SubmitCommandList(std::move(command_list));
+}
+
+// Run a frame of the service
+void RunFrame(TestService& service)
+{
+    service.PreUpdate();
+    service.Update();
+    service.PostUpdate();
+}
+
+} // namespace service_progress_test
+
+TEST(ServiceProgress, FenceValue)
+{
+    std::unique_ptr<service_progress_test::TestService> service = service_progress_test::CreateTestService();
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service->CreateServiceProxy();
+
+    // The fence is reached when the frame executing the command list ends
+    std::atomic<int> value = 0;
+    mono_service::ServiceProgress fence = service_progress_test::SubmitSetValue(*service_proxy, &value, 1);
+    EXPECT_FALSE(service_proxy->IsComplete(fence));
+
+    service_progress_test::RunFrame(*service);
+    EXPECT_TRUE(service_proxy->IsComplete(fence));
+    EXPECT_EQ(service_proxy->GetProgress(), fence);
+    EXPECT_EQ(value.load(), 1);
+
+    // A command list submitted while the frame is updating is executed in the next frame
+    service->PreUpdate();
+    mono_service::ServiceProgress next_fence = service_progress_test::SubmitSetValue(*service_proxy, &value, 2);
+    service->Update();
+    service->PostUpdate();
+    EXPECT_FALSE(service_proxy->IsComplete(next_fence));
+    EXPECT_EQ(value.load(), 1);
+
+    service_progress_test::RunFrame(*service);
+    EXPECT_TRUE(service_proxy->IsComplete(next_fence));
+    EXPECT_EQ(value.load(), 2);
+
+    // Reached fences stay complete
+    EXPECT_TRUE(service_proxy->IsComplete(fence));
+    EXPECT_EQ(
+        service_proxy->WaitForProgress(fence, std::chrono::milliseconds(0)), mono_service::ServiceWaitResult::Complete);
+}
+
+TEST(ServiceProgress, Timeout)
+{
+    std::unique_ptr<service_progress_test::TestService> service = service_progress_test::CreateTestService();
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service->CreateServiceProxy();
+
+    std::atomic<int> value = 0;
+    mono_service::ServiceProgress fence = service_progress_test::SubmitSetValue(*service_proxy, &value, 1);
+
+    // No frame runs, so the wait times out
+    constexpr std::chrono::milliseconds TIMEOUT = std::chrono::milliseconds(50);
+    auto begin = std::chrono::steady_clock::now();
+    mono_service::ServiceWaitResult result = service_proxy->WaitForProgress(fence, TIMEOUT);
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    EXPECT_EQ(result, mono_service::ServiceWaitResult::Timeout);
+    EXPECT_GE(elapsed, TIMEOUT);
+    EXPECT_FALSE(service_proxy->IsComplete(fence));
+    EXPECT_EQ(value.load(), 0);
+
+    // A zero timeout only checks
+    EXPECT_EQ(
+        service_proxy->WaitForProgress(fence, std::chrono::milliseconds(0)), mono_service::ServiceWaitResult::Timeout);
+}
+
+TEST(ServiceProgress, CompletionOrder)
+{
+    std::unique_ptr<service_progress_test::TestService> service = service_progress_test::CreateTestService();
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service->CreateServiceProxy();
+
+    constexpr int FRAME_COUNT = 8;
+    std::atomic<int> values[FRAME_COUNT] = {};
+    mono_service::ServiceProgress fences[FRAME_COUNT] = {};
+
+    // Submit one command list per frame, and wait for each of them on its own thread
+    std::atomic<int> completed_count = 0;
+    std::atomic<bool> in_order = true;
+    std::vector<std::thread> waiters;
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        fences[frame] = service_progress_test::SubmitSetValue(*service_proxy, &values[frame], frame + 1);
+        if (frame != 0)
+        {
+            EXPECT_EQ(fences[frame], fences[frame - 1] + 1);
+        }
+
+        waiters.emplace_back([&, frame, fence = fences[frame]]()
+        {
+            mono_service::ServiceWaitResult result = service_proxy->WaitForProgress(
+                fence, service_progress_test::LONG_TIMEOUT);
+            EXPECT_EQ(result, mono_service::ServiceWaitResult::Complete);
+
+            // The command list and all earlier ones have been executed when the wait returns
+            for (int executed = 0; executed <= frame; ++executed)
+            {
+                if (values[executed].load() != executed + 1)
+                    in_order = false;
+            }
+
+            ++completed_count;
+        });
+
+        service_progress_test::RunFrame(*service);
+    }
+
+    for (std::thread& waiter : waiters)
+        waiter.join();
+
+    EXPECT_EQ(completed_count.load(), FRAME_COUNT);
+    EXPECT_TRUE(in_order.load());
+}
+
+TEST(ServiceProgress, WaitWhileUpdating)
+{
+    std::unique_ptr<service_progress_test::TestService> service = service_progress_test::CreateTestService();
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service->CreateServiceProxy();
+
+    std::atomic<int> value = 0;
+    mono_service::ServiceProgress fence = service_progress_test::SubmitSetValue(*service_proxy, &value, 1);
+
+    // The waiter blocks until the service thread runs the frame
+    std::atomic<bool> waiting = false;
+    std::thread waiter([&]()
+    {
+        waiting = true;
+        mono_service::ServiceWaitResult result = service_proxy->WaitForProgress(fence, service_progress_test::LONG_TIMEOUT);
+        EXPECT_EQ(result, mono_service::ServiceWaitResult::Complete);
+        EXPECT_EQ(value.load(), 1);
+    });
+
+    while (!waiting.load())
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    service_progress_test::RunFrame(*service);
+    waiter.join();
+}
+
+TEST(ServiceProgress, ShutdownWhileWaiting)
+{
+    std::unique_ptr<service_progress_test::TestService> service = service_progress_test::CreateTestService();
+    std::unique_ptr<mono_service::ServiceProxy> service_proxy = service->CreateServiceProxy();
+
+    std::atomic<int> value = 0;
+    mono_service::ServiceProgress fence = service_progress_test::SubmitSetValue(*service_proxy, &value, 1);
+
+    // Block several waiters on a fence which is never reached
+    constexpr int WAITER_COUNT = 4;
+    std::atomic<int> started_count = 0;
+    std::atomic<int> shutdown_count = 0;
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < WAITER_COUNT; ++i)
+    {
+        waiters.emplace_back([&]()
+        {
+            ++started_count;
+            mono_service::ServiceWaitResult result = service_proxy->WaitForProgress(
+                fence, service_progress_test::LONG_TIMEOUT);
+            if (result == mono_service::ServiceWaitResult::Shutdown)
+                ++shutdown_count;
+        });
+    }
+
+    while (started_count.load() != WAITER_COUNT)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // All waiters wake without waiting for the timeout
+    auto begin = std::chrono::steady_clock::now();
+    service->Shutdown();
+    for (std::thread& waiter : waiters)
+        waiter.join();
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    EXPECT_EQ(shutdown_count.load(), WAITER_COUNT);
+    EXPECT_LT(elapsed, service_progress_test::LONG_TIMEOUT);
+
+    // Later waits return immediately
+    EXPECT_EQ(
+        service_proxy->WaitForProgress(fence, service_progress_test::LONG_TIMEOUT),
+        mono_service::ServiceWaitResult::Shutdown);
+
+    // Reached progress is still reported as complete
+    EXPECT_EQ(
+        service_proxy->WaitForProgress(service_proxy->GetProgress(), service_progress_test::LONG_TIMEOUT),
+        mono_service::ServiceWaitResult::Complete);
+}
\ No newline at end of file
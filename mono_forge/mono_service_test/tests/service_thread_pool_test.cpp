@@ -0,0 +1,365 @@
+﻿#include "mono_service_test/pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <thread>
+
+#include "mono_service/include/service.h"
+#include "mono_service/include/service_importer.h"
+#include "mono_service/include/service_registry.h"
+#include "mono_service/include/service_thread_pool.h"
+#include "mono_service/include/service_view.h"
+#include "mono_service/include/thread_affinity.h"
+
+namespace service_thread_pool_test
+{
+
+constexpr size_t TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT = 2;
+
+// Thread affinity tags
+struct MainThreadTag {};
+struct AssetThreadTag {};
+struct TransformThreadTag {};
+struct GraphicsThreadTag {};
+struct EntityArchiveThreadTag {};
+
+// Service tags
+struct MainServiceTag {};
+struct AssetServiceTag {};
+struct TransformServiceTag {};
+struct GraphicsServiceTag {};
+struct GraphicsSubServiceTag {};
+struct EntityArchiveServiceTag {};
+
+class TestServiceCommandList :
+    public mono_service::ServiceCommandList
+{
+public:
+    TestServiceCommandList() = default;
+    virtual ~TestServiceCommandList() override = default;
+};
+
+class TestServiceView :
+    public mono_service::ServiceView
+{
+public:
+    TestServiceView(const mono_service::ServiceAPI& service_api) :
+        mono_service::ServiceView(service_api)
+    {
+    }
+
+    virtual ~TestServiceView() override = default;
+};
+
+// The service recording the threads it was updated on
+class TestService :
+    public mono_service::Service,
+    private mono_service::ServiceAPI
+{
+public:
+    TestService(mono_service::ServiceThreadAffinityID thread_affinity_id) :
+        Service(thread_affinity_id)
+    {
+    }
+
+    virtual ~TestService() override = default;
+
+    virtual bool PreUpdate() override
+    {
+        BeginFrame();
+        Record();
+        return Service::PreUpdate();
+    }
+
+    virtual bool Update() override
+    {
+        Record();
+        return Service::Update();
+    }
+
+    virtual bool PostUpdate() override
+    {
+        Record();
+        bool result = Service::PostUpdate();
+        EndFrame();
+        return result;
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceCommandList> CreateCommandList() override
+    {
+        return std::make_unique<TestServiceCommandList>();
+    }
+
+    virtual std::unique_ptr<mono_service::ServiceView> CreateView() override
+    {
+        return std::make_unique<TestServiceView>(static_cast<mono_service::ServiceAPI&>(*this));
+    }
+
+    // Get the threads the service was updated on
+    const std::vector<std::thread::id>& GetThreadIDs() const { return thread_ids_; }
+
+    // Get the update count of the services before each update of this service
+    const std::vector<uint64_t>& GetUpdateStamps() const { return update_stamps_; }
+
+    // The update count shared by all services, used to check the order
+    static std::atomic<uint64_t> update_count;
+
+private:
+    void Record()
+    {
+        thread_ids_.push_back(std::this_thread::get_id());
+        update_stamps_.push_back(update_count.fetch_add(1));
+    }
+
+    std::vector<std::thread::id> thread_ids_;
+    std::vector<uint64_t> update_stamps_;
+};
+
+std::atomic<uint64_t> TestService::update_count = 0;
+
+// Import a test service with the thread affinity
+template <typename ServiceTag, typename ThreadTag>
+void ImportTestService(mono_service::ServiceRegistry& registry, std::vector<mono_service::ServiceHandleID>& order)
+{
+    mono_service::Service::SetupParam setup_param(TEST_SERVICE_COMMAND_QUEUE_BUFFER_COUNT);
+    bool result = mono_service::ImportService<TestService, mono_service::ServiceHandle<ServiceTag>>(
+        registry, mono_service::ServiceThreadAffinityHandle<ThreadTag>::ID(), setup_param);
+    ASSERT_TRUE(result);
+
+    order.push_back(mono_service::ServiceHandle<ServiceTag>::ID());
+}
+
+// Import the services in the same layout as the service hub
+void ImportTestServices(mono_service::ServiceRegistry& registry, std::vector<mono_service::ServiceHandleID>& order)
+{
+    ImportTestService<MainServiceTag, MainThreadTag>(registry, order);
+    ImportTestService<AssetServiceTag, AssetThreadTag>(registry, order);
+    ImportTestService<TransformServiceTag, TransformThreadTag>(registry, order);
+    ImportTestService<GraphicsServiceTag, GraphicsThreadTag>(registry, order);
+    ImportTestService<GraphicsSubServiceTag, GraphicsThreadTag>(registry, order);
+    ImportTestService<EntityArchiveServiceTag, EntityArchiveThreadTag>(registry, order);
+}
+
+// Run a frame with the three phases
+bool RunFrame(
+    mono_service::ServiceThreadPool& thread_pool,
+    mono_service::ServiceRegistry& registry, const std::vector<mono_service::ServiceHandleID>& order)
+{
+    bool result = true;
+    result &= thread_pool.RunPhase(registry, order, [](mono_service::Service& service) { return service.PreUpdate(); });
+    result &= thread_pool.RunPhase(registry, order, [](mono_service::Service& service) { return service.Update(); });
+    result &= thread_pool.RunPhase(registry, order, [](mono_service::Service& service) { return service.PostUpdate(); });
+    return result;
+}
+
+// The parallel update the service hub used before the pool, a task is launched for every service in every phase
+bool AsyncServiceUpdate(
+    const std::vector<mono_service::ServiceHandleID>& order, mono_service::ServiceRegistry& registry,
+    const mono_service::ServiceUpdateFunc& update_func)
+{
+    std::unordered_map<mono_service::ServiceThreadAffinityID, std::future<bool>> service_update_futures;
+    bool result = true;
+
+    for (const auto& service_id : order)
+    {
+        mono_service::Service& service = registry.Get(service_id);
+        mono_service::ServiceThreadAffinityID thread_affinity_id = service.GetThreadAffinityID();
+
+        if (thread_affinity_id == mono_service::ServiceThreadAffinityHandle<MainThreadTag>::ID())
+        {
+            if (!update_func(service))
+                result = false;
+            continue;
+        }
+
+        auto it = service_update_futures.find(thread_affinity_id);
+        if (it != service_update_futures.end() && !it->second.get())
+            result = false;
+
+        service_update_futures[thread_affinity_id] = std::async(std::launch::async, [&service, &update_func]()
+        {
+            return update_func(service);
+        });
+    }
+
+    for (auto& [thread_affinity_id, future] : service_update_futures)
+    {
+        if (!future.get())
+            result = false;
+    }
+
+    return result;
+}
+
+} // namespace service_thread_pool_test
+
+TEST(ServiceThreadPool, SameThreadForThreadAffinity)
+{
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+    std::unique_ptr<mono_service::ServiceThreadAffinityIDGenerator> thread_affinity_id_generator
+        = std::make_unique<mono_service::ServiceThreadAffinityIDGenerator>();
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+
+    std::vector<mono_service::ServiceHandleID> order;
+    service_thread_pool_test::ImportTestServices(*service_registry, order);
+
+    constexpr int FRAME_COUNT = 100;
+    {
+        mono_service::ServiceThreadPool thread_pool(
+            mono_service::ServiceThreadAffinityHandle<service_thread_pool_test::MainThreadTag>::ID());
+
+        service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+        {
+            for (int frame = 0; frame < FRAME_COUNT; ++frame)
+                ASSERT_TRUE(service_thread_pool_test::RunFrame(thread_pool, registry, order));
+        });
+
+        // One worker for each thread affinity except the main thread
+        EXPECT_EQ(thread_pool.GetWorkerCount(), 4);
+
+        // The service and the thread affinity of the service
+        auto get_service = [&](mono_service::ServiceHandleID service_id) -> const service_thread_pool_test::TestService&
+        {
+            const service_thread_pool_test::TestService* service = nullptr;
+            service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+            {
+                service = dynamic_cast<const service_thread_pool_test::TestService*>(&registry.Get(service_id));
+            });
+            return *service;
+        };
+
+        std::unordered_map<std::thread::id, mono_service::ServiceThreadAffinityID> thread_affinities;
+        for (const mono_service::ServiceHandleID& service_id : order)
+        {
+            const service_thread_pool_test::TestService& service = get_service(service_id);
+            const std::vector<std::thread::id>& thread_ids = service.GetThreadIDs();
+            ASSERT_EQ(thread_ids.size(), FRAME_COUNT * 3);
+
+            // Every phase of every frame ran on the same thread
+            for (const std::thread::id& thread_id : thread_ids)
+                ASSERT_EQ(thread_id, thread_ids.front());
+
+            // The thread is the worker of the thread affinity, or the calling thread for the main thread affinity
+            if (service.GetThreadAffinityID()
+                == mono_service::ServiceThreadAffinityHandle<service_thread_pool_test::MainThreadTag>::ID())
+                EXPECT_EQ(thread_ids.front(), std::this_thread::get_id());
+            else
+                EXPECT_EQ(thread_ids.front(), thread_pool.GetWorkerThreadID(service.GetThreadAffinityID()));
+
+            // A thread is used by one thread affinity only
+            auto [it, inserted] = thread_affinities.emplace(thread_ids.front(), service.GetThreadAffinityID());
+            EXPECT_EQ(it->second, service.GetThreadAffinityID());
+        }
+        EXPECT_EQ(thread_affinities.size(), 5);
+
+        // Services of the same thread affinity run in the given order
+        const std::vector<uint64_t>& graphics_stamps
+            = get_service(mono_service::ServiceHandle<service_thread_pool_test::GraphicsServiceTag>::ID()).GetUpdateStamps();
+        const std::vector<uint64_t>& graphics_sub_stamps
+            = get_service(mono_service::ServiceHandle<service_thread_pool_test::GraphicsSubServiceTag>::ID()).GetUpdateStamps();
+        for (size_t i = 0; i < graphics_stamps.size(); ++i)
+            EXPECT_LT(graphics_stamps[i], graphics_sub_stamps[i]);
+
+        // All services finish a phase before any service starts the next phase
+        uint64_t services_per_phase = order.size();
+        for (const mono_service::ServiceHandleID& service_id : order)
+        {
+            const std::vector<uint64_t>& stamps = get_service(service_id).GetUpdateStamps();
+            for (size_t phase = 0; phase < stamps.size(); ++phase)
+            {
+                EXPECT_GE(stamps[phase], phase * services_per_phase);
+                EXPECT_LT(stamps[phase], (phase + 1) * services_per_phase);
+            }
+        }
+    }
+}
+
+TEST(ServiceThreadPool, FailedUpdate)
+{
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+    std::unique_ptr<mono_service::ServiceThreadAffinityIDGenerator> thread_affinity_id_generator
+        = std::make_unique<mono_service::ServiceThreadAffinityIDGenerator>();
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+
+    std::vector<mono_service::ServiceHandleID> order;
+    service_thread_pool_test::ImportTestServices(*service_registry, order);
+
+    mono_service::ServiceThreadPool thread_pool(
+        mono_service::ServiceThreadAffinityHandle<service_thread_pool_test::MainThreadTag>::ID());
+
+    service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        // A failure on a worker fails the phase, the other services still run
+        const mono_service::ServiceThreadAffinityID failing_thread_affinity_id
+            = mono_service::ServiceThreadAffinityHandle<service_thread_pool_test::TransformThreadTag>::ID();
+        std::atomic<size_t> update_count = 0;
+        bool result = thread_pool.RunPhase(registry, order, [&](mono_service::Service& service)
+        {
+            ++update_count;
+            return service.GetThreadAffinityID() != failing_thread_affinity_id;
+        });
+        EXPECT_FALSE(result);
+        EXPECT_EQ(update_count, order.size());
+
+        // The next phase succeeds
+        result = thread_pool.RunPhase(registry, order, [](mono_service::Service&) { return true; });
+        EXPECT_TRUE(result);
+    });
+}
+
+TEST(ServiceThreadPool, Benchmark)
+{
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+    std::unique_ptr<mono_service::ServiceThreadAffinityIDGenerator> thread_affinity_id_generator
+        = std::make_unique<mono_service::ServiceThreadAffinityIDGenerator>();
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry
+        = std::make_unique<mono_service::ServiceRegistry>();
+
+    std::vector<mono_service::ServiceHandleID> order;
+    service_thread_pool_test::ImportTestServices(*service_registry, order);
+
+    // Services doing nothing, so only the per-frame overhead of the hub is measured
+    const mono_service::ServiceUpdateFunc empty_func = [](mono_service::Service&) { return true; };
+    constexpr int FRAME_COUNT = 2000;
+    constexpr int PHASE_COUNT = 3;
+
+    double async_us = 0.0;
+    double pool_us = 0.0;
+    service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        // A task for each service in each phase
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            for (int phase = 0; phase < PHASE_COUNT; ++phase)
+                service_thread_pool_test::AsyncServiceUpdate(order, registry, empty_func);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        async_us = std::chrono::duration<double, std::micro>(end - start).count() / FRAME_COUNT;
+
+        // Persistent workers
+        mono_service::ServiceThreadPool thread_pool(
+            mono_service::ServiceThreadAffinityHandle<service_thread_pool_test::MainThreadTag>::ID());
+        thread_pool.RunPhase(registry, order, empty_func); // Create workers
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            for (int phase = 0; phase < PHASE_COUNT; ++phase)
+                thread_pool.RunPhase(registry, order, empty_func);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        pool_us = std::chrono::duration<double, std::micro>(end - start).count() / FRAME_COUNT;
+    });
+
+    std::cout << "Services: " << order.size() << ", phases per frame: " << PHASE_COUNT << std::endl;
+    std::cout << "std::async: " << async_us << " us/frame" << std::endl;
+    std::cout << "ServiceThreadPool: " << pool_us << " us/frame" << std::endl;
+}
\ No newline at end of file
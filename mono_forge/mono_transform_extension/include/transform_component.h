@@ -76,6 +76,9 @@ public:
     // Get the world TRS matrix of the Transform
     DirectX::XMMATRIX GetWorldMatrix() const;
 
+    // Get the inverse-transpose of the world TRS matrix of the Transform, for transforming normals
+    DirectX::XMMATRIX GetWorldInverseTransposeMatrix() const;
+
 private:
     // The service proxy for the Transform service
     std::unique_ptr<mono_service::ServiceProxy> transform_service_proxy_ = nullptr;
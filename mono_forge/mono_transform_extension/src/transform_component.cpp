@@ -303,4 +303,19 @@ XMMATRIX TransformComponent::GetWorldMatrix() const
     return transform_view->GetWorldMatrix(transform_handle_);
 }
 
+XMMATRIX TransformComponent::GetWorldInverseTransposeMatrix() const
+{
+    assert(transform_handle_.IsValid() && "Transform handle is not valid");
+
+    // Create service view
+    std::unique_ptr<mono_service::ServiceView> service_view
+        = transform_service_proxy_->CreateView();
+    mono_transform_service::TransformServiceView* transform_view
+        = dynamic_cast<mono_transform_service::TransformServiceView*>(service_view.get());
+    assert(transform_view != nullptr && "Failed to create TransformServiceView");
+
+    // Get the inverse-transpose cached by the transform service, instead of inverting the world matrix here
+    return transform_view->GetWorldInverseTransposeMatrix(transform_handle_);
+}
+
 } // namespace mono_transform_extension
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #include <DirectXMath.h>
 
-#include "transform_evaluator/include/transform_manager.h"
+#include "transform_evaluator/include/transform_hierarchy.h"
 #include "mono_service/include/service.h"
 #include "mono_service/include/service_registry.h"
 
@@ -20,15 +20,19 @@ public:
     TransformServiceAPI() = default;
     virtual ~TransformServiceAPI() = default;
 
-    // Get the transform adder
-    virtual transform_evaluator::TransformAdder& GetTransformAdder() = 0;
+    // Get the transform hierarchy
+    virtual transform_evaluator::TransformHierarchy& GetTransformHierarchy() = 0;
 
-    // Get the transform eraser
-    virtual transform_evaluator::TransformEraser& GetTransformEraser() = 0;
+    // Get the parent of a Transform using its Handle, invalid if it is a root
+    virtual transform_evaluator::TransformHandle GetParent(const transform_evaluator::TransformHandle& handle) const = 0;
 
     // Get the world matrix of a Transform using its Handle
     virtual DirectX::XMMATRIX GetWorldMatrix(const transform_evaluator::TransformHandle& handle) const = 0;
 
+    // Get the inverse-transpose of the world matrix of a Transform using its Handle
+    virtual DirectX::XMMATRIX GetWorldInverseTransposeMatrix(
+        const transform_evaluator::TransformHandle& handle) const = 0;
+
     // Get the translation of a Transform using its Handle
     virtual DirectX::XMFLOAT3 GetTranslation(const transform_evaluator::TransformHandle& handle) const = 0;
 
@@ -84,10 +88,12 @@ protected:
     TransformServiceAPI& GetAPI() { return *this; }
     const TransformServiceAPI& GetAPI() const { return *this; }
 
-    virtual transform_evaluator::TransformAdder& GetTransformAdder() override;
-    virtual transform_evaluator::TransformEraser& GetTransformEraser() override;
+    virtual transform_evaluator::TransformHierarchy& GetTransformHierarchy() override;
+    virtual transform_evaluator::TransformHandle GetParent(const transform_evaluator::TransformHandle& handle) const override;
 
     virtual DirectX::XMMATRIX GetWorldMatrix(const transform_evaluator::TransformHandle& handle) const override;
+    virtual DirectX::XMMATRIX GetWorldInverseTransposeMatrix(
+        const transform_evaluator::TransformHandle& handle) const override;
     virtual DirectX::XMFLOAT3 GetTranslation(const transform_evaluator::TransformHandle& handle) const override;
     virtual DirectX::XMFLOAT4 GetRotation(const transform_evaluator::TransformHandle& handle) const override;
     virtual DirectX::XMFLOAT3 GetScale(const transform_evaluator::TransformHandle& handle) const override;
@@ -97,10 +103,8 @@ private:
      * Transform data manipulation
     /******************************************************************************************************************/
 
-    std::unique_ptr<transform_evaluator::TransformContainer> transform_container_ = nullptr;
-    std::unique_ptr<transform_evaluator::TransformManager> transform_manager_ = nullptr;
-    std::unique_ptr<transform_evaluator::TransformAdder> transform_adder_ = nullptr;
-    std::unique_ptr<transform_evaluator::TransformEraser> transform_eraser_ = nullptr;
+    // The hierarchy that stores the Transforms and caches their world matrices
+    std::unique_ptr<transform_evaluator::TransformHierarchy> transform_hierarchy_ = nullptr;
 
 };
 
@@ -42,7 +42,19 @@ public:
     void UpdateWorldScale(
         const transform_evaluator::TransformHandle& handle, const DirectX::XMFLOAT3& scale);
 
+    // Update the local TRS of a Transform using its Handle
+    // The local TRS is relative to the parent, for a root it is the world TRS
+    void UpdateLocalTRS(
+        const transform_evaluator::TransformHandle& handle,
+        const DirectX::XMFLOAT3& translation, const DirectX::XMFLOAT4& rotation, const DirectX::XMFLOAT3& scale);
+
+    // Set the parent of a Transform using their Handles, an invalid parent Handle makes it a root
+    // The Handles are captured when recording, so the Transforms must already exist
+    void SetParent(
+        const transform_evaluator::TransformHandle& handle, const transform_evaluator::TransformHandle& parent_handle);
+
     // Destroy a Transform using its Handle
+    // Its children are attached to its parent and keep their world TRS
     void DestroyTransform(const transform_evaluator::TransformHandle& handle);
         
 };
@@ -20,6 +20,12 @@ public:
     // Get the world matrix of a Transform using its Handle
     DirectX::XMMATRIX GetWorldMatrix(const transform_evaluator::TransformHandle& handle) const;
 
+    // Get the inverse-transpose of the world matrix of a Transform using its Handle, for transforming normals
+    DirectX::XMMATRIX GetWorldInverseTransposeMatrix(const transform_evaluator::TransformHandle& handle) const;
+
+    // Get the parent of a Transform using its Handle, invalid if it is a root
+    transform_evaluator::TransformHandle GetParent(const transform_evaluator::TransformHandle& handle) const;
+
     // Get the translation of a Transform using its Handle
     DirectX::XMFLOAT3 GetTranslation(const transform_evaluator::TransformHandle& handle) const;
 
@@ -20,10 +20,7 @@ TransformService::~TransformService()
      * Transform data manipulation Cleanup
     /******************************************************************************************************************/
 
-    transform_eraser_.reset();
-    transform_adder_.reset();
-    transform_manager_.reset();
-    transform_container_.reset();
+    transform_hierarchy_.reset();
 }
 
 bool TransformService::Setup(mono_service::Service::SetupParam& param)
@@ -36,17 +33,8 @@ bool TransformService::Setup(mono_service::Service::SetupParam& param)
      * Transform data manipulation
     /******************************************************************************************************************/
 
-    // Create TransformContainer
-    transform_container_ = std::make_unique<transform_evaluator::TransformContainer>();
-
-    // Create TransformManager
-    transform_manager_ = std::make_unique<transform_evaluator::TransformManager>(*transform_container_);
-
-    // Create TransformAdder
-    transform_adder_ = std::make_unique<transform_evaluator::TransformAdder>(*transform_container_);
-
-    // Create TransformEraser
-    transform_eraser_ = std::make_unique<transform_evaluator::TransformEraser>(*transform_container_);
+    // Create TransformHierarchy
+    transform_hierarchy_ = std::make_unique<transform_evaluator::TransformHierarchy>();
 
     return true; // Setup successful
 }
@@ -72,7 +60,6 @@ bool TransformService::Update()
     bool result = false;
 
     // Execute all enqueued command lists
-    // TODO: Add logic to determine the value considering the parent-child relationship
     while (!GetExecutableCommandQueue().IsEmpty())
     {
         // Dequeue command list
@@ -89,6 +76,9 @@ bool TransformService::Update()
         }
     }
 
+    // Re-evaluate the world matrices of the changed subtrees
+    transform_hierarchy_->Evaluate();
+
     // End frame update
     EndFrame();
 
@@ -114,16 +104,21 @@ std::unique_ptr<mono_service::ServiceView> TransformService::CreateView()
     return std::make_unique<TransformServiceView>(GetAPI());
 }
 
-transform_evaluator::TransformAdder& TransformService::GetTransformAdder()
+transform_evaluator::TransformHierarchy& TransformService::GetTransformHierarchy()
 {
     assert(IsSetup() && "TransformService is not set up.");
-    return *transform_adder_;
+    return *transform_hierarchy_;
 }
 
-transform_evaluator::TransformEraser& TransformService::GetTransformEraser()
+transform_evaluator::TransformHandle TransformService::GetParent(
+    const transform_evaluator::TransformHandle& handle) const
 {
     assert(IsSetup() && "TransformService is not set up.");
-    return *transform_eraser_;
+
+    // Lock for shared access
+    std::shared_lock<std::shared_mutex> lock = LockShared();
+
+    return transform_hierarchy_->GetParent(handle);
 }
 
 XMMATRIX TransformService::GetWorldMatrix(
@@ -134,31 +129,20 @@ XMMATRIX TransformService::GetWorldMatrix(
     // Lock for shared access
     std::shared_lock<std::shared_mutex> lock = LockShared();
 
-    // Default world matrix (identity)
-    XMMATRIX world_matrix = XMMatrixIdentity();
-
-    transform_evaluator::TransformManager& transform_manager = transform_evaluator::TransformManager::GetInstance();
-    transform_manager.WithLock([&](const transform_evaluator::TransformManager& manager)
-    {
-        // Get the Transform using its Handle
-        const transform_evaluator::Transform& transform = manager.GetTransform(handle);
-        
-        // Get world TRS
-        const transform_evaluator::TRS& world_trs = transform.GetWorldTRS();
-
-        // Compute world matrix from TRS
-        XMVECTOR translation = XMLoadFloat3(&world_trs.translation);
-        XMVECTOR rotation = XMLoadFloat4(&world_trs.rotation);
-        XMVECTOR scale = XMLoadFloat3(&world_trs.scale);
+    // Return the world matrix cached by the last update
+    return XMLoadFloat4x4(&transform_hierarchy_->GetWorldMatrix(handle));
+}
 
-        XMMATRIX scale_matrix = XMMatrixScalingFromVector(scale);
-        XMMATRIX rotation_matrix = XMMatrixRotationQuaternion(rotation);
-        XMMATRIX translation_matrix = XMMatrixTranslationFromVector(translation);
+XMMATRIX TransformService::GetWorldInverseTransposeMatrix(
+    const transform_evaluator::TransformHandle &handle) const
+{
+    assert(IsSetup() && "TransformService is not set up.");
 
-        world_matrix = scale_matrix * rotation_matrix * translation_matrix;
-    });
+    // Lock for shared access
+    std::shared_lock<std::shared_mutex> lock = LockShared();
 
-    return world_matrix;
+    // Return the inverse-transpose cached by the last update
+    return XMLoadFloat4x4(&transform_hierarchy_->GetWorldInverseTransposeMatrix(handle));
 }
 
 DirectX::XMFLOAT3 TransformService::GetTranslation(const transform_evaluator::TransformHandle &handle) const
@@ -168,22 +152,7 @@ DirectX::XMFLOAT3 TransformService::GetTranslation(const transform_evaluator::Tr
     // Lock for shared access
     std::shared_lock<std::shared_mutex> lock = LockShared();
 
-    // Pointer to hold the translation
-    DirectX::XMFLOAT3 translation = {};
-
-    transform_evaluator::TransformManager& transform_manager = transform_evaluator::TransformManager::GetInstance();
-    transform_manager.WithLock([&](const transform_evaluator::TransformManager& manager)
-    {
-        // Get the Transform using its Handle
-        const transform_evaluator::Transform& transform = manager.GetTransform(handle);
-        
-        // Get world TRS
-        const transform_evaluator::TRS& world_trs = transform.GetWorldTRS();
-
-        translation = world_trs.translation;
-    });
-
-    return translation;
+    return transform_hierarchy_->GetWorldTRS(handle).translation;
 }
 
 DirectX::XMFLOAT4 TransformService::GetRotation(const transform_evaluator::TransformHandle &handle) const
@@ -193,22 +162,7 @@ DirectX::XMFLOAT4 TransformService::GetRotation(const transform_evaluator::Trans
     // Lock for shared access
     std::shared_lock<std::shared_mutex> lock = LockShared();
 
-    // Pointer to hold the rotation
-    DirectX::XMFLOAT4 rotation = {};
-
-    transform_evaluator::TransformManager& transform_manager = transform_evaluator::TransformManager::GetInstance();
-    transform_manager.WithLock([&](const transform_evaluator::TransformManager& manager)
-    {
-        // Get the Transform using its Handle
-        const transform_evaluator::Transform& transform = manager.GetTransform(handle);
-        
-        // Get world TRS
-        const transform_evaluator::TRS& world_trs = transform.GetWorldTRS();
-
-        rotation = world_trs.rotation;
-    });
-
-    return rotation;
+    return transform_hierarchy_->GetWorldTRS(handle).rotation;
 }
 
 DirectX::XMFLOAT3 TransformService::GetScale(const transform_evaluator::TransformHandle &handle) const
@@ -218,22 +172,7 @@ DirectX::XMFLOAT3 TransformService::GetScale(const transform_evaluator::Transfor
     // Lock for shared access
     std::shared_lock<std::shared_mutex> lock = LockShared();
 
-    // Pointer to hold the scale
-    DirectX::XMFLOAT3 scale = {};
-
-    transform_evaluator::TransformManager& transform_manager = transform_evaluator::TransformManager::GetInstance();
-    transform_manager.WithLock([&](const transform_evaluator::TransformManager& manager)
-    {
-        // Get the Transform using its Handle
-        const transform_evaluator::Transform& transform = manager.GetTransform(handle);
-        
-        // Get world TRS
-        const transform_evaluator::TRS& world_trs = transform.GetWorldTRS();
-
-        scale = world_trs.scale;
-    });
-
-    return scale;
+    return transform_hierarchy_->GetWorldTRS(handle).scale;
 }
 
 } // namespace mono_transform_service
\ No newline at end of file
@@ -21,12 +21,14 @@ void TransformServiceCommandList::CreateTransform(
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            // Create transform
-            std::unique_ptr<transform_evaluator::Transform> transform
-                = std::make_unique<transform_evaluator::Transform>(position, rotation, scale);
-
-            // Add transform to transform adder
-            out_handle = transform_service_api.GetTransformAdder().AddTransform(std::move(transform));
+            // Create transform as a root, its local TRS is its world TRS
+            transform_evaluator::TRS trs;
+            trs.translation = position;
+            trs.rotation = rotation;
+            trs.scale = scale;
+
+            // Add transform to transform hierarchy
+            out_handle = transform_service_api.GetTransformHierarchy().Add(trs);
             if (!out_handle.IsValid())
                 return false; // Failure
 
@@ -47,22 +49,14 @@ void TransformServiceCommandList::UpdateWorldTRS(
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            transform_evaluator::TransformManager& transform_manager 
-                = transform_evaluator::TransformManager::GetInstance();
-            transform_manager.WithLock([&](transform_evaluator::TransformManager& manager)
-            {
-                // Get the Transform using its Handle
-                transform_evaluator::Transform& transform = manager.GetTransform(handle);
-
-                // Create new world TRS
-                transform_evaluator::TRS world_trs;
-                world_trs.translation = translation;
-                world_trs.rotation = rotation;
-                world_trs.scale = scale;
+            // Create new world TRS
+            transform_evaluator::TRS world_trs;
+            world_trs.translation = translation;
+            world_trs.rotation = rotation;
+            world_trs.scale = scale;
 
-                // Update world TRS
-                transform.SetWorldTRS(std::move(world_trs));
-            });
+            // Update world TRS, it is converted into the local space of the parent
+            transform_service_api.GetTransformHierarchy().SetWorldTRS(handle, world_trs);
 
             return true; // Success
         });
@@ -80,20 +74,8 @@ void TransformServiceCommandList::UpdateWorldTranslation(
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            transform_evaluator::TransformManager& transform_manager 
-                = transform_evaluator::TransformManager::GetInstance();
-            transform_manager.WithLock([&](transform_evaluator::TransformManager& manager)
-            {
-                // Get the Transform using its Handle
-                transform_evaluator::Transform& transform = manager.GetTransform(handle);
-
-                // Create new world TRS
-                transform_evaluator::TRS world_trs = transform.GetWorldTRS();
-                world_trs.translation = translation;
-
-                // Update world TRS
-                transform.SetWorldTRS(std::move(world_trs));
-            });
+            // Update world translation
+            transform_service_api.GetTransformHierarchy().SetWorldTranslation(handle, translation);
 
             return true; // Success
         });
@@ -111,20 +93,8 @@ void TransformServiceCommandList::UpdateWorldRotation(
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            transform_evaluator::TransformManager& transform_manager 
-                = transform_evaluator::TransformManager::GetInstance();
-            transform_manager.WithLock([&](transform_evaluator::TransformManager& manager)
-            {
-                // Get the Transform using its Handle
-                transform_evaluator::Transform& transform = manager.GetTransform(handle);
-
-                // Create new world TRS
-                transform_evaluator::TRS world_trs = transform.GetWorldTRS();
-                world_trs.rotation = rotation;
-
-                // Update world TRS
-                transform.SetWorldTRS(std::move(world_trs));
-            });
+            // Update world rotation
+            transform_service_api.GetTransformHierarchy().SetWorldRotation(handle, rotation);
 
             return true; // Success
         });
@@ -142,20 +112,53 @@ void TransformServiceCommandList::UpdateWorldScale(
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            transform_evaluator::TransformManager& transform_manager 
-                = transform_evaluator::TransformManager::GetInstance();
-            transform_manager.WithLock([&](transform_evaluator::TransformManager& manager)
-            {
-                // Get the Transform using its Handle
-                transform_evaluator::Transform& transform = manager.GetTransform(handle);
+            // Update world scale
+            transform_service_api.GetTransformHierarchy().SetWorldScale(handle, scale);
+
+            return true; // Success
+        });
+}
 
-                // Create new world TRS
-                transform_evaluator::TRS world_trs = transform.GetWorldTRS();
-                world_trs.scale = scale;
+void TransformServiceCommandList::UpdateLocalTRS(
+    const transform_evaluator::TransformHandle& handle,
+    const DirectX::XMFLOAT3& translation, const DirectX::XMFLOAT4& rotation, const DirectX::XMFLOAT3& scale)
+{
+    AddCommand(
+        [handle, translation, rotation, scale](mono_service::ServiceAPI& service_api) -> bool
+        {
+            // Get graphics service API
+            static_assert(
+                std::is_base_of<mono_service::ServiceAPI, TransformService>::value,
+                "TransformService must be derived from ServiceAPI.");
+            TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
+
+            // Create new local TRS
+            transform_evaluator::TRS local_trs;
+            local_trs.translation = translation;
+            local_trs.rotation = rotation;
+            local_trs.scale = scale;
+
+            // Update local TRS
+            transform_service_api.GetTransformHierarchy().SetLocalTRS(handle, local_trs);
+
+            return true; // Success
+        });
+}
+
+void TransformServiceCommandList::SetParent(
+    const transform_evaluator::TransformHandle& handle, const transform_evaluator::TransformHandle& parent_handle)
+{
+    AddCommand(
+        [handle, parent_handle](mono_service::ServiceAPI& service_api) -> bool
+        {
+            // Get graphics service API
+            static_assert(
+                std::is_base_of<mono_service::ServiceAPI, TransformService>::value,
+                "TransformService must be derived from ServiceAPI.");
+            TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-                // Update world TRS
-                transform.SetWorldTRS(std::move(world_trs));
-            });
+            // Set parent, the local TRS is kept
+            transform_service_api.GetTransformHierarchy().SetParent(handle, parent_handle);
 
             return true; // Success
         });
@@ -172,8 +175,8 @@ void TransformServiceCommandList::DestroyTransform(const transform_evaluator::Tr
                 "TransformService must be derived from ServiceAPI.");
             TransformServiceAPI& transform_service_api = dynamic_cast<TransformServiceAPI&>(service_api);
 
-            // Erase transform using transform eraser
-            transform_service_api.GetTransformEraser().EraseTransform(handle);
+            // Erase transform from transform hierarchy
+            transform_service_api.GetTransformHierarchy().Erase(handle);
 
             return true; // Success
         });
@@ -20,6 +20,30 @@ DirectX::XMMATRIX TransformServiceView::GetWorldMatrix(const transform_evaluator
     return transform_service_api.GetWorldMatrix(handle);
 }
 
+DirectX::XMMATRIX TransformServiceView::GetWorldInverseTransposeMatrix(
+    const transform_evaluator::TransformHandle& handle) const
+{
+    static_assert(
+        std::is_base_of<mono_service::ServiceAPI, TransformServiceAPI>::value,
+        "TransformServiceAPI must be derived from ServiceAPI.");
+    const TransformServiceAPI& transform_service_api = dynamic_cast<const TransformServiceAPI&>(service_api_);
+
+    // Return the inverse-transpose of the world matrix
+    return transform_service_api.GetWorldInverseTransposeMatrix(handle);
+}
+
+transform_evaluator::TransformHandle TransformServiceView::GetParent(
+    const transform_evaluator::TransformHandle& handle) const
+{
+    static_assert(
+        std::is_base_of<mono_service::ServiceAPI, TransformServiceAPI>::value,
+        "TransformServiceAPI must be derived from ServiceAPI.");
+    const TransformServiceAPI& transform_service_api = dynamic_cast<const TransformServiceAPI&>(service_api_);
+
+    // Return the parent
+    return transform_service_api.GetParent(handle);
+}
+
 DirectX::XMFLOAT3 TransformServiceView::GetTranslation(const transform_evaluator::TransformHandle& handle) const
 {
     static_assert(
@@ -125,8 +125,8 @@ TEST(TransformService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -203,8 +203,8 @@ TEST(TransformService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -276,8 +276,8 @@ TEST(TransformService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -299,6 +299,184 @@ TEST(TransformService, Execute)
      * Cleanup
     /******************************************************************************************************************/
 
+    // Cleanup services
+    service_registry.reset();
+}
+
+TEST(TransformService, Hierarchy)
+{
+    /*******************************************************************************************************************
+     * Import transform service
+    /******************************************************************************************************************/
+
+    // Create service id generator
+    std::unique_ptr<mono_service::ServiceIDGenerator> service_id_generator 
+        = std::make_unique<mono_service::ServiceIDGenerator>();
+
+    // Create service registry
+    std::unique_ptr<mono_service::ServiceRegistry> service_registry 
+        = std::make_unique<mono_service::ServiceRegistry>();
+
+    // Import transform service in to registry
+    bool result = mono_transform_service_test::ImportTransformService(*service_registry);
+    ASSERT_TRUE(result);
+
+    // Get transform service proxy from transform service
+    std::unique_ptr<mono_service::ServiceProxy> transform_service_proxy = nullptr;
+    service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+    {
+        // Get transform service
+        mono_service::Service* service 
+            = &registry.Get(mono_transform_service::TransformServiceHandle::ID());
+        mono_transform_service::TransformService& transform_service
+            = dynamic_cast<mono_transform_service::TransformService&>(*service);
+
+        // Create service proxy
+        transform_service_proxy = transform_service.CreateServiceProxy();
+    });
+
+    // Run one frame of the transform service
+    auto update_service = [&]()
+    {
+        service_registry->WithUniqueLock([&](mono_service::ServiceRegistry& registry)
+        {
+            mono_service::Service& service = registry.Get(mono_transform_service::TransformServiceHandle::ID());
+            ASSERT_TRUE(service.PreUpdate());
+            ASSERT_TRUE(service.Update());
+            ASSERT_TRUE(service.PostUpdate());
+        });
+    };
+
+    /*******************************************************************************************************************
+     * Create parent and child transforms
+    /******************************************************************************************************************/
+
+    transform_evaluator::TransformHandle parent_handle;
+    transform_evaluator::TransformHandle child_handle;
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list 
+            = transform_service_proxy->CreateCommandList();
+        mono_transform_service::TransformServiceCommandList& transform_command_list
+            = dynamic_cast<mono_transform_service::TransformServiceCommandList&>(*command_list);
+
+        transform_command_list.CreateTransform(
+            parent_handle, XMFLOAT3(10.0f, 0.0f, 0.0f), XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT3(2.0f, 2.0f, 2.0f));
+        transform_command_list.CreateTransform(child_handle, XMFLOAT3(1.0f, 2.0f, 3.0f));
+
+        transform_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    update_service();
+
+    /*******************************************************************************************************************
+     * Attach the child to the parent
+    /******************************************************************************************************************/
+
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list 
+            = transform_service_proxy->CreateCommandList();
+        mono_transform_service::TransformServiceCommandList& transform_command_list
+            = dynamic_cast<mono_transform_service::TransformServiceCommandList&>(*command_list);
+
+        // The local TRS of the child is kept, so it is placed relative to the parent
+        transform_command_list.SetParent(child_handle, parent_handle);
+
+        transform_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    update_service();
+
+    {
+        std::unique_ptr<mono_service::ServiceView> service_view
+            = transform_service_proxy->CreateView();
+        mono_transform_service::TransformServiceView& transform_view
+            = dynamic_cast<mono_transform_service::TransformServiceView&>(*service_view);
+
+        ASSERT_TRUE(transform_view.GetParent(child_handle) == parent_handle);
+        ASSERT_FALSE(transform_view.GetParent(parent_handle).IsValid());
+
+        const XMFLOAT3& got_translation = transform_view.GetTranslation(child_handle);
+        ASSERT_FLOAT_EQ(got_translation.x, 12.0f);
+        ASSERT_FLOAT_EQ(got_translation.y, 4.0f);
+        ASSERT_FLOAT_EQ(got_translation.z, 6.0f);
+
+        const XMFLOAT3& got_scale = transform_view.GetScale(child_handle);
+        ASSERT_FLOAT_EQ(got_scale.x, 2.0f);
+
+        // The world matrix is the child matrix times the parent matrix
+        XMFLOAT4X4 world_matrix;
+        XMStoreFloat4x4(&world_matrix, transform_view.GetWorldMatrix(child_handle));
+        ASSERT_FLOAT_EQ(world_matrix._41, 12.0f);
+        ASSERT_FLOAT_EQ(world_matrix._42, 4.0f);
+        ASSERT_FLOAT_EQ(world_matrix._43, 6.0f);
+    }
+
+    /*******************************************************************************************************************
+     * Move the parent, the child follows
+    /******************************************************************************************************************/
+
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list 
+            = transform_service_proxy->CreateCommandList();
+        mono_transform_service::TransformServiceCommandList& transform_command_list
+            = dynamic_cast<mono_transform_service::TransformServiceCommandList&>(*command_list);
+
+        transform_command_list.UpdateWorldTranslation(parent_handle, XMFLOAT3(0.0f, 10.0f, 0.0f));
+
+        // The world translation of the child is converted into the parent space
+        transform_command_list.UpdateWorldTranslation(child_handle, XMFLOAT3(4.0f, 10.0f, 0.0f));
+
+        transform_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    update_service();
+
+    {
+        std::unique_ptr<mono_service::ServiceView> service_view
+            = transform_service_proxy->CreateView();
+        mono_transform_service::TransformServiceView& transform_view
+            = dynamic_cast<mono_transform_service::TransformServiceView&>(*service_view);
+
+        const XMFLOAT3& got_translation = transform_view.GetTranslation(child_handle);
+        ASSERT_FLOAT_EQ(got_translation.x, 4.0f);
+        ASSERT_FLOAT_EQ(got_translation.y, 10.0f);
+        ASSERT_FLOAT_EQ(got_translation.z, 0.0f);
+    }
+
+    /*******************************************************************************************************************
+     * Destroy the parent, the child keeps its world TRS
+    /******************************************************************************************************************/
+
+    {
+        std::unique_ptr<mono_service::ServiceCommandList> command_list 
+            = transform_service_proxy->CreateCommandList();
+        mono_transform_service::TransformServiceCommandList& transform_command_list
+            = dynamic_cast<mono_transform_service::TransformServiceCommandList&>(*command_list);
+
+        transform_command_list.DestroyTransform(parent_handle);
+
+        transform_service_proxy->SubmitCommandList(std::move(command_list));
+    }
+    update_service();
+
+    {
+        std::unique_ptr<mono_service::ServiceView> service_view
+            = transform_service_proxy->CreateView();
+        mono_transform_service::TransformServiceView& transform_view
+            = dynamic_cast<mono_transform_service::TransformServiceView&>(*service_view);
+
+        ASSERT_FALSE(transform_view.GetParent(child_handle).IsValid());
+
+        const XMFLOAT3& got_translation = transform_view.GetTranslation(child_handle);
+        ASSERT_FLOAT_EQ(got_translation.x, 4.0f);
+        ASSERT_FLOAT_EQ(got_translation.y, 10.0f);
+        ASSERT_FLOAT_EQ(got_translation.z, 0.0f);
+
+        const XMFLOAT3& got_scale = transform_view.GetScale(child_handle);
+        ASSERT_FLOAT_EQ(got_scale.x, 2.0f);
+    }
+
+    /*******************************************************************************************************************
+     * Cleanup
+    /******************************************************************************************************************/
+
     // Cleanup services
     service_registry.reset();
 }
\ No newline at end of file
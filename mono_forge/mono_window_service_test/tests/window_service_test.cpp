@@ -154,8 +154,8 @@ TEST(WindowService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -193,8 +193,8 @@ TEST(WindowService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -250,8 +250,8 @@ TEST(WindowService, Execute)
         result = service.PostUpdate();
         ASSERT_TRUE(result);
 
-        // Check progress
-        ASSERT_EQ(service.GetProgress(), progress + 1);
+        // Check the submitted command list has been executed
+        ASSERT_EQ(service.GetProgress(), progress);
     });
 
     /*******************************************************************************************************************
@@ -60,6 +60,9 @@ public:
     bool AddUploadTask(StructuredBufferUploadTask&& task);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     // List of buffer update tasks
     std::vector<UploadTask> tasks_;
 
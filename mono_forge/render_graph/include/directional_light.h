@@ -72,6 +72,11 @@ public:
     LightTypeHandleID GetLightTypeHandleID() const override;
     void UpdateViewProjMatrix();
 
+    // Compute the view and projection matrices of a directional light, without transposing them
+    static void ComputeViewProjMatrices(
+        const DirectX::XMFLOAT4& rotation, float distance, float ortho_width, float ortho_height,
+        float near_z, float far_z, DirectX::XMMATRIX& view_matrix, DirectX::XMMATRIX& proj_matrix);
+
     // Get color of the directional light
     const DirectX::XMFLOAT4& GetColor() const { return buffer_.color; }
 
@@ -180,6 +180,9 @@ public:
     void SetScissorRect(const D3D12_RECT& scissor_rect);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     PassAPI& GetPassAPI() override { return *this; }
     const PassAPI& GetPassAPI() const override { return *this; }
 
@@ -54,6 +54,9 @@ public:
     void SetImguiContext(const ImguiContextHandle* context_handle);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     // Handle of the target texture resource
     const ResourceHandle* target_texture_handle_ = nullptr;
 
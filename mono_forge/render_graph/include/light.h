@@ -141,6 +141,9 @@ public:
     // Set rotation of the light using Euler angles in degrees
     void SetRotation(const DirectX::XMFLOAT3& euler_angles_deg);
 
+    // Convert Euler angles in degrees to the rotation quaternion SetRotation stores
+    static DirectX::XMFLOAT4 ToRotation(const DirectX::XMFLOAT3& euler_angles_deg);
+
     // Update light matrices based on position and rotation
     void UpdateWorldMatrices();
 
@@ -44,6 +44,9 @@ public:
     void SetLightConfig(Light::LightConfigBuffer config);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     // List of light handles to be uploaded
     std::vector<const LightHandle*> light_handles_;
 
@@ -199,6 +199,9 @@ public:
     void SetDepthStencilTextureHandle(const ResourceHandle* depth_stencil_texture_handle);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     PassAPI& GetPassAPI() override { return *this; }
     const PassAPI& GetPassAPI() const override { return *this; }
     const ResourceHandle* GetInvViewProjMatrixBufferHandle() const override;
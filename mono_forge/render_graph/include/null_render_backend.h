@@ -0,0 +1,211 @@
+﻿#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "render_graph/include/dll_config.h"
+#include "render_graph/include/render_backend.h"
+#include "render_graph/include/render_pass.h"
+
+namespace render_graph
+{
+
+// The resource created by the null render backend
+// It has no ID3D12Resource and only keeps its description
+class RENDER_GRAPH_DLL NullResource :
+    public dx12_util::Resource
+{
+public:
+    NullResource(const RenderResourceDesc& desc) : desc_(desc) {}
+    ~NullResource() override = default;
+
+    // Always returns nullptr
+    ID3D12Resource* Get() override { return nullptr; }
+
+    // Get the description of the resource
+    const RenderResourceDesc& GetDesc() const { return desc_; }
+
+private:
+    const RenderResourceDesc desc_;
+};
+
+// The type of events recorded by the null render backend
+enum class RenderBackendEventType
+{
+    AddResource,
+    EraseResource,
+    ExecutePass,
+    Transition,
+    UpdateBuffer,
+    CopyBuffer,
+    UploadTexture,
+    SetPipeline,
+    SetRootParameters,
+    SetDescriptorHeaps,
+    SetViewport,
+    SetScissorRect,
+    SetRenderTarget,
+    SetDepthStencil,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    DrawIndexed,
+    NewImguiFrame,
+    RenderImgui,
+};
+
+// An event recorded by the null render backend
+struct RenderBackendEvent
+{
+    RenderBackendEventType type = RenderBackendEventType::AddResource;
+
+    // The resource the event is recorded for, the destination of CopyBuffer and UploadTexture events
+    ResourceHandle resource_handle;
+
+    // The source of CopyBuffer and UploadTexture events
+    ResourceHandle source_handle;
+
+    // The pass of ExecutePass events and of the events recorded inside a pass
+    RenderPassHandleID pass_id = 0;
+
+    // Whether the event is recorded inside a pass
+    bool in_pass = false;
+
+    // The states of Transition events, also after_state is the initial state of AddResource events
+    D3D12_RESOURCE_STATES before_state = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_STATES after_state = D3D12_RESOURCE_STATE_COMMON;
+
+    // The slot of SetRenderTarget events
+    uint32_t slot = 0;
+
+    // The index count of DrawIndexed events
+    uint32_t index_count = 0;
+
+    // The byte size of UpdateBuffer and CopyBuffer events, and the byte offset of UpdateBuffer events
+    uint32_t size = 0;
+    uint32_t offset = 0;
+};
+
+// The backend which needs no device
+// It records the commands which the passes submit instead of issuing them,
+// so that the graph wiring and the recorded commands can be tested without GPU
+class RENDER_GRAPH_DLL NullRenderBackend :
+    public RenderBackend
+{
+public:
+    NullRenderBackend() = default;
+    ~NullRenderBackend() override = default;
+
+    // Create a NullResource from the description
+    std::unique_ptr<dx12_util::Resource> CreateResource(const RenderResourceDesc& desc) override;
+
+    // Start tracking the state of the resource
+    // Resources which are not NullResource are tracked as buffers in the common state
+    void OnResourceAdded(const ResourceHandle& handle, dx12_util::Resource& resource) override;
+
+    // Stop tracking the state of the resource
+    void OnResourceErased(const ResourceHandle& handle) override;
+
+    // Execute the pass, the events it records carry its handle ID
+    // Returns false if the pass declares a resource which is not tracked
+    bool ExecutePass(RenderPass& pass, RenderPassContext& context) override;
+
+    // Record the transition of the resource if its state changes
+    void TransitionResource(
+        const ResourceHandle& handle, dx12_util::Resource& resource, D3D12_RESOURCE_STATES state,
+        RenderPassContext& context) override;
+
+    void UpdateBuffer(
+        const ResourceHandle& handle, dx12_util::Resource& resource, const void* data, uint32_t size,
+        uint32_t offset, RenderPassContext& context) override;
+
+    // The destination must be in the copy destination state
+    void CopyBuffer(
+        const ResourceHandle& dest_handle, dx12_util::Resource& dest,
+        const ResourceHandle& source_handle, const dx12_util::Resource& source, uint32_t size,
+        RenderPassContext& context) override;
+
+    // The texture must be in the copy destination state
+    void UploadTexture(
+        const ResourceHandle& texture_handle, dx12_util::Resource& texture,
+        const ResourceHandle& upload_buffer_handle, dx12_util::Resource& upload_buffer, const void* data,
+        RenderPassContext& context) override;
+
+    void SetPipeline(Pipeline& pipeline, RenderPassContext& context) override;
+    void SetRootParameters(Pipeline& pipeline, const PassAPI& pass_api, RenderPassContext& context) override;
+    void SetDescriptorHeaps(RenderPassContext& context) override;
+    void SetViewport(const D3D12_VIEWPORT& viewport, RenderPassContext& context) override;
+    void SetScissorRect(const D3D12_RECT& scissor_rect, RenderPassContext& context) override;
+
+    // Record a SetRenderTarget event for each render target, then a SetDepthStencil event
+    // The render targets must be in the render target state, and the depth stencil in the depth write state
+    void SetRenderTargets(
+        const std::vector<RenderTargetBinding>& render_targets, const RenderTargetBinding* depth_stencil,
+        RenderPassContext& context) override;
+
+    // The render target must be in the render target state
+    void ClearRenderTarget(
+        const RenderTargetBinding& render_target, const float clear_color[4], RenderPassContext& context) override;
+
+    // The depth stencil must be in the depth write state
+    void ClearDepthStencil(
+        const RenderTargetBinding& depth_stencil, float depth, UINT8 stencil,
+        RenderPassContext& context) override;
+
+    void SetVertexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, UINT stride,
+        RenderPassContext& context) override;
+    void SetIndexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, DXGI_FORMAT format,
+        RenderPassContext& context) override;
+    void DrawIndexed(UINT index_count, RenderPassContext& context) override;
+
+    void NewImguiFrame(RenderPassContext& context) override;
+    void RenderImgui(RenderPassContext& context) override;
+
+    // Get the recorded events in order
+    const std::vector<RenderBackendEvent>& GetEvents() const { return events_; }
+
+    // Clear the recorded events
+    void ClearEvents();
+
+    // Get the handle IDs of the executed passes in order
+    std::vector<RenderPassHandleID> GetExecutedPasses() const;
+
+    // Get the recorded events of the type in order
+    std::vector<RenderBackendEvent> GetEvents(RenderBackendEventType type) const;
+
+    // Get the current state of the tracked resource
+    D3D12_RESOURCE_STATES GetResourceState(const ResourceHandle& handle) const;
+
+    // Get the number of tracked resources
+    size_t GetResourceCount() const;
+
+private:
+    // Record the event as recorded by the executing pass
+    // The resources of the event must be tracked
+    void Record(RenderBackendEvent event);
+
+    // Record the event, its resource must be in the state
+    void RecordInState(const RenderBackendEvent& event, D3D12_RESOURCE_STATES state);
+
+    // The tracked resource
+    struct TrackedResource
+    {
+        RenderResourceDesc desc;
+        D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+    };
+
+    // Resources are added and erased from several threads
+    mutable std::mutex mutex_;
+
+    std::unordered_map<ResourceHandle, TrackedResource> resources_;
+    std::vector<RenderBackendEvent> events_;
+
+    // The pass being executed, nullptr if none is
+    const RenderPass* executing_pass_ = nullptr;
+};
+
+} // namespace render_graph
\ No newline at end of file
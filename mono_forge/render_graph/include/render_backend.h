@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <d3d12.h>
+
+#include "directx12_util/include/wrapper.h"
+
+#include "render_graph/include/dll_config.h"
+#include "render_graph/include/resource_handle.h"
+
+namespace render_graph
+{
+
+// Forward declaration
+class RenderPass;
+class RenderPassContext;
+class Pipeline;
+class PassAPI;
+
+// The type of resources created through a render backend
+enum class RenderResourceType
+{
+    Buffer,
+    Texture2D,
+};
+
+// Description of a resource created through a render backend
+struct RenderResourceDesc
+{
+    RenderResourceType type = RenderResourceType::Buffer;
+
+    // Buffer size in bytes, only for Buffer
+    uint32_t size = 0;
+
+    // Texture size and format, only for Texture2D
+    UINT width = 0;
+    UINT height = 0;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+    // The format of the shader resource view, DXGI_FORMAT_UNKNOWN to use the texture format
+    DXGI_FORMAT srv_format = DXGI_FORMAT_UNKNOWN;
+
+    D3D12_HEAP_TYPE heap_type = D3D12_HEAP_TYPE_UPLOAD;
+    D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE;
+    D3D12_RESOURCE_STATES initial_state = D3D12_RESOURCE_STATE_GENERIC_READ;
+
+    // Optimized clear value for render targets and depth stencils
+    bool has_clear_value = false;
+    D3D12_CLEAR_VALUE clear_value = {};
+
+    std::wstring debug_name;
+};
+
+// A render target or depth stencil bound through a render backend
+struct RenderTargetBinding
+{
+    const ResourceHandle* handle = nullptr;
+    dx12_util::Resource* resource = nullptr;
+};
+
+// The backend which the render graph creates resources and executes passes through
+// The render passes record all their commands through the backend of their context
+class RENDER_GRAPH_DLL RenderBackend
+{
+public:
+    RenderBackend() = default;
+    virtual ~RenderBackend() = default;
+
+    // Create a resource from the description
+    // Returns nullptr if creation fails
+    virtual std::unique_ptr<dx12_util::Resource> CreateResource(const RenderResourceDesc& desc) = 0;
+
+    // Called after a resource is added to the resource container
+    virtual void OnResourceAdded(const ResourceHandle& handle, dx12_util::Resource& resource) = 0;
+
+    // Called before a resource is erased from the resource container
+    virtual void OnResourceErased(const ResourceHandle& handle) = 0;
+
+    // Execute a render pass of the render graph
+    virtual bool ExecutePass(RenderPass& pass, RenderPassContext& context) = 0;
+
+    // Transition a resource to the state, nothing is done if it is already in the state
+    virtual void TransitionResource(
+        const ResourceHandle& handle, dx12_util::Resource& resource, D3D12_RESOURCE_STATES state,
+        RenderPassContext& context) = 0;
+
+    // Write the data to the upload heap buffer from CPU
+    virtual void UpdateBuffer(
+        const ResourceHandle& handle, dx12_util::Resource& resource, const void* data, uint32_t size,
+        uint32_t offset, RenderPassContext& context) = 0;
+
+    // Copy the size bytes from the beginning of the source buffer to the destination buffer
+    virtual void CopyBuffer(
+        const ResourceHandle& dest_handle, dx12_util::Resource& dest,
+        const ResourceHandle& source_handle, const dx12_util::Resource& source, uint32_t size,
+        RenderPassContext& context) = 0;
+
+    // Upload the pixel data to the texture through the upload buffer
+    virtual void UploadTexture(
+        const ResourceHandle& texture_handle, dx12_util::Resource& texture,
+        const ResourceHandle& upload_buffer_handle, dx12_util::Resource& upload_buffer, const void* data,
+        RenderPassContext& context) = 0;
+
+    // Set the pipeline state and the root signature, with the triangle list topology
+    virtual void SetPipeline(Pipeline& pipeline, RenderPassContext& context) = 0;
+
+    // Set the root parameters of the pipeline from the pass
+    virtual void SetRootParameters(Pipeline& pipeline, const PassAPI& pass_api, RenderPassContext& context) = 0;
+
+    // Set the shader visible descriptor heaps of the HeapManager
+    virtual void SetDescriptorHeaps(RenderPassContext& context) = 0;
+
+    virtual void SetViewport(const D3D12_VIEWPORT& viewport, RenderPassContext& context) = 0;
+    virtual void SetScissorRect(const D3D12_RECT& scissor_rect, RenderPassContext& context) = 0;
+
+    // Set the render targets and the depth stencil, depth_stencil is nullptr if there is none
+    virtual void SetRenderTargets(
+        const std::vector<RenderTargetBinding>& render_targets, const RenderTargetBinding* depth_stencil,
+        RenderPassContext& context) = 0;
+
+    virtual void ClearRenderTarget(
+        const RenderTargetBinding& render_target, const float clear_color[4], RenderPassContext& context) = 0;
+    virtual void ClearDepthStencil(
+        const RenderTargetBinding& depth_stencil, float depth, UINT8 stencil,
+        RenderPassContext& context) = 0;
+
+    virtual void SetVertexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, UINT stride,
+        RenderPassContext& context) = 0;
+    virtual void SetIndexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, DXGI_FORMAT format,
+        RenderPassContext& context) = 0;
+
+    virtual void DrawIndexed(UINT index_count, RenderPassContext& context) = 0;
+
+    // Start a new frame of the Dear ImGui platform and renderer backends
+    virtual void NewImguiFrame(RenderPassContext& context) = 0;
+
+    // Record the draw data of the current Dear ImGui context
+    virtual void RenderImgui(RenderPassContext& context) = 0;
+};
+
+// The backend creating resources on the D3D12 device and recording the passes to the command list
+class RENDER_GRAPH_DLL DirectX12RenderBackend :
+    public RenderBackend
+{
+public:
+    DirectX12RenderBackend() = default;
+    ~DirectX12RenderBackend() override = default;
+
+    // Create a resource on the device
+    // The descriptors are allocated from the heaps of the HeapManager
+    std::unique_ptr<dx12_util::Resource> CreateResource(const RenderResourceDesc& desc) override;
+
+    void OnResourceAdded(const ResourceHandle& handle, dx12_util::Resource& resource) override;
+    void OnResourceErased(const ResourceHandle& handle) override;
+
+    // Execute the pass, which records its commands to the command list of the context
+    bool ExecutePass(RenderPass& pass, RenderPassContext& context) override;
+
+    // Record a resource barrier to the command list of the context
+    // The back buffer of a swap chain is transitioned between the present and render target states
+    void TransitionResource(
+        const ResourceHandle& handle, dx12_util::Resource& resource, D3D12_RESOURCE_STATES state,
+        RenderPassContext& context) override;
+
+    void UpdateBuffer(
+        const ResourceHandle& handle, dx12_util::Resource& resource, const void* data, uint32_t size,
+        uint32_t offset, RenderPassContext& context) override;
+    void CopyBuffer(
+        const ResourceHandle& dest_handle, dx12_util::Resource& dest,
+        const ResourceHandle& source_handle, const dx12_util::Resource& source, uint32_t size,
+        RenderPassContext& context) override;
+    void UploadTexture(
+        const ResourceHandle& texture_handle, dx12_util::Resource& texture,
+        const ResourceHandle& upload_buffer_handle, dx12_util::Resource& upload_buffer, const void* data,
+        RenderPassContext& context) override;
+
+    void SetPipeline(Pipeline& pipeline, RenderPassContext& context) override;
+    void SetRootParameters(Pipeline& pipeline, const PassAPI& pass_api, RenderPassContext& context) override;
+    void SetDescriptorHeaps(RenderPassContext& context) override;
+    void SetViewport(const D3D12_VIEWPORT& viewport, RenderPassContext& context) override;
+    void SetScissorRect(const D3D12_RECT& scissor_rect, RenderPassContext& context) override;
+
+    // The back buffer view is used for a swap chain
+    void SetRenderTargets(
+        const std::vector<RenderTargetBinding>& render_targets, const RenderTargetBinding* depth_stencil,
+        RenderPassContext& context) override;
+    void ClearRenderTarget(
+        const RenderTargetBinding& render_target, const float clear_color[4], RenderPassContext& context) override;
+    void ClearDepthStencil(
+        const RenderTargetBinding& depth_stencil, float depth, UINT8 stencil,
+        RenderPassContext& context) override;
+
+    void SetVertexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, UINT stride,
+        RenderPassContext& context) override;
+    void SetIndexBuffer(
+        const ResourceHandle& handle, const dx12_util::Resource& resource, DXGI_FORMAT format,
+        RenderPassContext& context) override;
+    void DrawIndexed(UINT index_count, RenderPassContext& context) override;
+
+    void NewImguiFrame(RenderPassContext& context) override;
+    void RenderImgui(RenderPassContext& context) override;
+};
+
+} // namespace render_graph
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -8,6 +9,7 @@
 
 #include "render_graph/include/dll_config.h"
 #include "render_graph/include/render_pass.h"
+#include "render_graph/include/transient_resource.h"
 
 namespace render_graph
 {
@@ -19,6 +21,18 @@ struct RenderGraphNode
     std::vector<RenderGraphNode*> dependencies;
 };
 
+// The hash of a render pass handle ID and its resource accesses
+using RenderPassSignature = uint64_t;
+
+// How the last Compile produced the execution order
+enum class RenderGraphCompileResult
+{
+    None, // Not compiled yet or the last compile failed
+    Rebuilt, // Compiled from scratch
+    Incremental, // Only the changed passes were recompiled
+    Reused, // The previous execution order was reused as is
+};
+
 // The render graph class
 // Manages render passes and their execution order based on dependencies
 class RENDER_GRAPH_DLL RenderGraph :
@@ -32,16 +46,72 @@ public:
     bool AddPass(
         RenderPassHandleID handleID, RenderPass::SetupFunc setup, RenderPass::ExecuteFunc execute);
 
+    // Declare a resource as transient, which is only used within the frame
+    // Compile computes its lifetime from the passes accessing it and assigns it a memory slot
+    // shared with other transient resources whose lifetimes do not overlap
+    // The declaration is cleared with the passes after execution
+    void AddTransientResource(const ResourceHandle& resource_handle, const RenderResourceDesc& desc);
+
     // Compile the render graph (resolve dependencies, etc.)
+    // The compiled result is kept across frames, if the passes are the same as the last compile
+    // the previous execution order is reused, otherwise only the changed passes are recompiled
     bool Compile();
 
     // Execute the render graph
     bool Execute(RenderPassContext& context);
 
     // Clear the render graph
+    // The compiled result is kept for the next Compile
     void Clear();
 
+    // Discard the compiled result so that the next Compile rebuilds from scratch
+    void InvalidateCompiled();
+
+    // Get the sorted render pass handle IDs of the last Compile
+    const std::vector<RenderPassHandleID>& GetSortedPasses() const { return sorted_passes_; }
+
+    // Get how the last Compile produced the execution order
+    RenderGraphCompileResult GetLastCompileResult() const { return last_compile_result_; }
+
+    // Get the number of passes whose dependencies were recomputed by the last Compile
+    size_t GetLastRecompiledPassCount() const { return last_recompiled_pass_count_; }
+
+    // Get the memory slots of the transient resources used by the passes of the last Compile
+    // Transient resources which no pass accesses are not included
+    const std::vector<TransientResourceAllocation>& GetTransientAllocations() const
+    {
+        return transient_allocations_;
+    }
+
+    // Get the transient memory with and without aliasing of the last Compile
+    const TransientMemoryStats& GetTransientMemoryStats() const { return transient_memory_stats_; }
+
 private:
+    // The compiled data of a render pass, kept across frames
+    struct CompiledPass
+    {
+        RenderPassSignature signature = 0;
+        std::vector<ResourceHandle> reads;
+        std::vector<ResourceHandle> writes;
+        std::vector<RenderPassHandleID> dependencies;
+    };
+
+    // Remove the resource accesses of a compiled pass from the writer and reader maps
+    void UnregisterCompiledAccesses(RenderPassHandleID handleID, const CompiledPass& compiled);
+
+    // Add the resource accesses of a compiled pass to the writer and reader maps
+    void RegisterCompiledAccesses(RenderPassHandleID handleID, const CompiledPass& compiled);
+
+    // Recompute the dependencies of a compiled pass from the writer map
+    // Returns true if the dependencies were changed
+    bool UpdateCompiledDependencies(RenderPassHandleID handleID, CompiledPass& compiled);
+
+    // Sort the compiled passes and store the result to compiled_order_
+    bool SortCompiledPasses();
+
+    // Compute the lifetimes of the transient resources in the execution order and allocate them
+    void AllocateCompiledTransientResources();
+
     // List of render passes in the graph
     std::unordered_map<RenderPassHandleID, std::unique_ptr<RenderPass>> pass_map_;
 
@@ -49,10 +119,51 @@ private:
     // It sames the order in which passes were added
     std::vector<RenderPassHandleID> added_pass_order_;
 
+    // Signatures of the added render passes, in the same order as added_pass_order_
+    std::vector<RenderPassSignature> added_pass_signatures_;
+
     // Sorted list of render pass handle IDs after compilation
     std::vector<RenderPassHandleID> sorted_passes_;
+
+    // The signature of the whole graph at the last successful compile
+    RenderPassSignature compiled_graph_signature_ = 0;
+
+    // Compiled data of the passes at the last successful compile
+    std::unordered_map<RenderPassHandleID, CompiledPass> compiled_passes_;
+
+    // The writer of each resource at the last successful compile
+    std::unordered_map<ResourceHandle, RenderPassHandleID> compiled_writers_;
+
+    // The readers of each resource at the last successful compile
+    std::unordered_map<ResourceHandle, std::vector<RenderPassHandleID>> compiled_readers_;
+
+    // The execution order at the last successful compile
+    std::vector<RenderPassHandleID> compiled_order_;
+
+    // How the last Compile produced the execution order
+    RenderGraphCompileResult last_compile_result_ = RenderGraphCompileResult::None;
+
+    // The number of passes whose dependencies were recomputed by the last Compile
+    size_t last_recompiled_pass_count_ = 0;
+
+    // The sizes of the transient resources declared this frame
+    std::unordered_map<ResourceHandle, uint64_t> transient_sizes_;
+
+    // The signature of the transient resources at the last allocation
+    RenderPassSignature transient_signature_ = 0;
+
+    // The transient allocations of the last Compile
+    std::vector<TransientResourceAllocation> transient_allocations_;
+
+    // The transient memory stats of the last Compile
+    TransientMemoryStats transient_memory_stats_;
 };
 
+// Function to compute the signature of a render pass from its handle ID and access tokens
+// The signature does not depend on the order in which the resources were declared
+RENDER_GRAPH_DLL RenderPassSignature ComputePassSignature(
+    RenderPassHandleID handleID, const ResourceAccessToken& read_token, const ResourceAccessToken& write_token);
+
 // Function to create nodes from the pass map
 RENDER_GRAPH_DLL std::unordered_map<RenderPassHandleID, RenderGraphNode> CreateNodes(
     const std::unordered_map<RenderPassHandleID, std::unique_ptr<RenderPass>>& pass_map,
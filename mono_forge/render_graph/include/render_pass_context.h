@@ -9,20 +9,35 @@
 namespace render_graph
 {
 
+// Forward declaration
+class RenderBackend;
+
 // Context provided to a RenderPass during execution
+// The render passes record their commands through the backend of the context
 class RENDER_GRAPH_DLL RenderPassContext :
     public class_template::NonCopyable
 {
 public:
-    RenderPassContext(dx12_util::CommandList& command_list);
+    RenderPassContext(RenderBackend& backend, dx12_util::CommandList& command_list);
+
+    // Create a context without command list, used with the null render backend
+    RenderPassContext(RenderBackend& backend);
+
     virtual ~RenderPassContext();
 
+    // Get the backend which the render passes record their commands through
+    RenderBackend& GetBackend();
+
     // Get the command list for this render pass
+    // It must not be called on a context without command list
     dx12_util::CommandList& GetCommandList();
 
 private:
-    // The command list for this render pass
-    dx12_util::CommandList& command_list_;
+    // The backend which the render passes record their commands through
+    RenderBackend& backend_;
+
+    // The command list for this render pass, nullptr if the context has none
+    dx12_util::CommandList* command_list_ = nullptr;
 };
 
 } // namespace render_graph
\ No newline at end of file
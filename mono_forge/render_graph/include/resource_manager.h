@@ -13,6 +13,10 @@
 namespace render_graph
 {
 
+// Forward declaration
+struct RenderResourceDesc;
+class RenderBackend;
+
 // The container type used to contain resources
 using ResourceContainer = utility_header::Container<dx12_util::Resource>;
 
@@ -74,29 +78,41 @@ private:
 class RENDER_GRAPH_DLL ResourceAdder
 {
 public:
-    ResourceAdder(ResourceContainer& container) : container_(container) {}
+    ResourceAdder(ResourceContainer& container, RenderBackend& backend) : container_(container), backend_(backend) {}
     ~ResourceAdder() = default;
 
     // Adds a new resource and returns its associated ResourceHandle
+    // The render backend is notified of the resource
     ResourceHandle AddResource(std::unique_ptr<dx12_util::Resource> resource);
 
+    // Creates a resource through the render backend, adds it and returns its associated ResourceHandle
+    // Returns an invalid handle if creation fails
+    ResourceHandle CreateResource(const RenderResourceDesc& desc);
+
 private:
     // The resource container reference
     ResourceContainer& container_;
+
+    // The backend creating the resources and notified of the added resources
+    RenderBackend& backend_;
 };
 
 class RENDER_GRAPH_DLL ResourceEraser
 {
 public:
-    ResourceEraser(ResourceContainer& container) : container_(container) {}
+    ResourceEraser(ResourceContainer& container, RenderBackend& backend) : container_(container), backend_(backend) {}
     ~ResourceEraser() = default;
 
     // Erase a resource associated with the given ResourceHandle
+    // The render backend is notified before the resource is released
     void EraseResource(const ResourceHandle* handle);
 
 private:
     // The resource container reference
     ResourceContainer& container_;
+
+    // The backend notified of the erased resources
+    RenderBackend& backend_;
 };
 
 } // namespace render_graph
\ No newline at end of file
@@ -108,6 +108,9 @@ public:
 
         // Handle of the world matrix buffer
         const ResourceHandle* world_matrix_buffer_handle = nullptr;
+
+        // The light whose shadow map the mesh is rendered to, all lights if null
+        const LightHandle* light_handle = nullptr;
     };
 
     // Set the current frame index
@@ -120,6 +123,9 @@ public:
     void AddShadowCastingLight(const LightHandle* light_handle);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     PassAPI& GetPassAPI() override { return *this; }
     const PassAPI& GetPassAPI() const override { return *this; }
     const ResourceHandle* GetDrawingLightViewMatrixBufferHandle() const override;
@@ -43,6 +43,9 @@ public:
     bool AddUploadTask(UploadTask&& task);
 
 private:
+    // Reset the data set for a frame, called at the end of the execution
+    void ResetFrameData();
+
     // List of texture upload tasks
     std::vector<UploadTask> tasks_;
 };
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "render_graph/include/dll_config.h"
+#include "render_graph/include/resource_handle.h"
+#include "render_graph/include/render_backend.h"
+
+namespace render_graph
+{
+
+// The alignment of resources placed in a heap
+constexpr uint64_t TRANSIENT_RESOURCE_ALIGNMENT = 64 * 1024;
+
+// The lifetime of a transient resource in the execution order
+// The resource is only used from the first pass to the last pass, both inclusive
+struct TransientResourceLifetime
+{
+    ResourceHandle handle;
+
+    // The size in bytes the resource occupies in the heap
+    uint64_t size = 0;
+
+    // The indices of the first and last passes using the resource in the sorted passes
+    size_t first_pass_index = 0;
+    size_t last_pass_index = 0;
+};
+
+// Where a transient resource is placed in the shared heap
+struct TransientResourceAllocation
+{
+    ResourceHandle handle;
+    uint64_t size = 0;
+    size_t first_pass_index = 0;
+    size_t last_pass_index = 0;
+
+    // The memory slot the resource is assigned to
+    // Resources in the same slot have disjoint lifetimes and alias the same memory
+    uint32_t slot = 0;
+
+    // The offset of the slot in the heap
+    uint64_t heap_offset = 0;
+};
+
+// The memory used by transient resources
+struct TransientMemoryStats
+{
+    // The number of transient resources used by any pass
+    size_t resource_count = 0;
+
+    // The number of memory slots the resources are assigned to
+    size_t slot_count = 0;
+
+    // The memory if each resource has its own allocation
+    uint64_t unaliased_bytes = 0;
+
+    // The memory of the shared heap, the sum of the slot sizes
+    uint64_t aliased_bytes = 0;
+
+    // The largest sum of the sizes of the resources alive at the same pass
+    // No allocation can use less memory than this
+    uint64_t peak_live_bytes = 0;
+};
+
+// Compute the size in bytes a resource occupies in the heap, aligned to TRANSIENT_RESOURCE_ALIGNMENT
+// Textures are estimated from their size and format, without the padding of the device layout
+RENDER_GRAPH_DLL uint64_t ComputeTransientResourceSize(const RenderResourceDesc& desc);
+
+// Assign the resources to memory slots so that resources in the same slot never are alive at the same time
+// The resources are placed from the largest, each into the smallest slot which is free during its lifetime
+// and large enough, otherwise into the largest free slot which is grown, otherwise into a new slot
+// The allocations are stored in the same order as the lifetimes
+RENDER_GRAPH_DLL void AllocateTransientResources(
+    const std::vector<TransientResourceLifetime>& lifetimes,
+    std::vector<TransientResourceAllocation>& allocations, TransientMemoryStats& stats);
+
+} // namespace render_graph
\ No newline at end of file
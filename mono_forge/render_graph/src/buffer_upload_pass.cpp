@@ -2,6 +2,7 @@
 #include "render_graph/include/buffer_upload_pass.h"
 
 #include "render_graph/include/resource_manager.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph
 {
@@ -56,8 +57,8 @@ bool BufferUploadPass::AddToGraph(RenderGraph &render_graph)
             // Get read access token
             const ResourceAccessToken& read_token = self_pass.GetReadToken();
 
-            // Get command list from context
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Update each buffer
             for (const UploadTask& task : tasks_)
@@ -68,13 +69,8 @@ bool BufferUploadPass::AddToGraph(RenderGraph &render_graph)
                     // Get the buffer resource for writing
                     dx12_util::Resource& resource = manager.GetWriteResource(task.buffer_handle, write_token);
 
-                    // Cast to dx12_util::Buffer
-                    dx12_util::Buffer* buffer = dynamic_cast<dx12_util::Buffer*>(&resource);
-                    assert(buffer != nullptr); // Ensure the cast succeeded
-
                     // Update the buffer data
-                    bool result = buffer->UpdateData(task.data, task.size);
-                    assert(result); // Ensure the update succeeded
+                    backend.UpdateBuffer(*task.buffer_handle, resource, task.data, task.size, 0, context);
                 });
             }
 
@@ -87,42 +83,38 @@ bool BufferUploadPass::AddToGraph(RenderGraph &render_graph)
                     // Get the buffer resource for writing
                     dx12_util::Resource& resource = manager.GetWriteResource(task.buffer_handle, write_token);
 
-                    // Cast to dx12_util::StructuredBuffer
-                    dx12_util::StructuredBuffer* buffer = dynamic_cast<dx12_util::StructuredBuffer*>(&resource);
-                    assert(buffer != nullptr); // Ensure the cast succeeded
-
-                    // Get the upload buffer resource for writing
-                    const dx12_util::Resource& upload_resource = manager.GetReadResource(task.upload_buffer_handle, read_token);
-                    const dx12_util::Buffer* upload_buffer = dynamic_cast<const dx12_util::Buffer*>(&upload_resource);
-                    assert(upload_buffer != nullptr); // Ensure the cast succeeded
+                    // Get the upload buffer resource for reading
+                    const dx12_util::Resource& upload_resource
+                        = manager.GetReadResource(task.upload_buffer_handle, read_token);
 
                     // Transition structured buffer to COPY_DEST state
-                    dx12_util::Barrier barrier_to_copy_dest(
-                            buffer->Get(), command_list.Get(),
-                            buffer->GetCurrentState(), D3D12_RESOURCE_STATE_COPY_DEST);
-                    buffer->SetCurrentState(D3D12_RESOURCE_STATE_COPY_DEST);
+                    backend.TransitionResource(*task.buffer_handle, resource, D3D12_RESOURCE_STATE_COPY_DEST, context);
 
                     // Copy data from upload buffer to structured buffer
-                    command_list.Get()->CopyBufferRegion(
-                        buffer->Get(), 0, upload_buffer->Get(), 0, task.size);
+                    backend.CopyBuffer(
+                        *task.buffer_handle, resource, *task.upload_buffer_handle, upload_resource, task.size, context);
 
                     // Transition structured buffer back to GENERIC_READ state
-                    dx12_util::Barrier barrier_to_generic_read(
-                            buffer->Get(), command_list.Get(),
-                            buffer->GetCurrentState(), D3D12_RESOURCE_STATE_GENERIC_READ);
-                    buffer->SetCurrentState(D3D12_RESOURCE_STATE_GENERIC_READ);
+                    backend.TransitionResource(
+                        *task.buffer_handle, resource, D3D12_RESOURCE_STATE_GENERIC_READ, context);
                 });
             }
 
-            // Clear tasks after execution
-            tasks_.clear();
-            structured_buffer_tasks_.clear();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void BufferUploadPass::ResetFrameData()
+{
+    // Clear tasks after execution
+    tasks_.clear();
+    structured_buffer_tasks_.clear();
+}
+
 bool BufferUploadPass::AddUploadTask(UploadTask &&task)
 {
     assert(IsSetup() && "Instance is not setup");
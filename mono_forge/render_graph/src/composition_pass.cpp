@@ -8,7 +8,7 @@ using Microsoft::WRL::ComPtr;
 #include "directx12_util/include/d3dx12.h"
 #include "directx12_util/include/helper.h"
 #include "render_graph/include/resource_manager.h"
-#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph
 {
@@ -75,113 +75,81 @@ bool CompositionPass::AddToGraph(RenderGraph &render_graph)
             const ResourceAccessToken& read_token = self_pass.GetReadToken();
             current_read_token_ = read_token;
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Set pipeline
-            composition_pipeline_->SetPipeline(command_list.Get());
+            backend.SetPipeline(*composition_pipeline_, context);
 
             // Set viewport and scissor rect
-            command_list.Get()->RSSetViewports(1, &viewport_);
-            command_list.Get()->RSSetScissorRects(1, &scissor_rect_);
-
-            // Set primitive topology
-            command_list.Get()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-            // Get heap manager
-            HeapManager& heap_manager = HeapManager::GetInstance();
-
-            // Create descriptor heaps vector
-            std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
-            heap_manager.WithUniqueLock([&](HeapManager& manager) 
-            {
-                descriptor_heaps.push_back(manager.GetSrvHeap().Get());
-            });
+            backend.SetViewport(viewport_, context);
+            backend.SetScissorRect(scissor_rect_, context);
 
             // Set descriptor heaps
-            command_list.Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+            backend.SetDescriptorHeaps(context);
 
             ResourceManager& resource_manager = ResourceManager::GetInstance();
             resource_manager.WithLock([&](ResourceManager& manager)
             {
                 // Get swap chain for writing
-                dx12_util::SwapChain* swap_chain
-                    = dynamic_cast<dx12_util::SwapChain*>(&manager.GetWriteResource(swap_chain_handle_, write_token));
-                assert(swap_chain != nullptr); // Ensure the cast succeeded
+                RenderTargetBinding swap_chain;
+                swap_chain.handle = swap_chain_handle_;
+                swap_chain.resource = &manager.GetWriteResource(swap_chain_handle_, write_token);
 
                 // Set present to render target barrier
-                dx12_util::Barrier barrier_plensent_to_rt(
-                    swap_chain->GetCurrentBackBuffer(), command_list.Get(), 
-                    D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-                // Get render target view
-                D3D12_CPU_DESCRIPTOR_HANDLE rtv_handle = swap_chain->GetCurrentBackBufferView();
+                backend.TransitionResource(
+                    *swap_chain.handle, *swap_chain.resource, D3D12_RESOURCE_STATE_RENDER_TARGET, context);
 
                 // Set render target
-                command_list.Get()->OMSetRenderTargets(1, &rtv_handle, FALSE, nullptr);
+                backend.SetRenderTargets({ swap_chain }, nullptr, context);
 
                 // Clear render target
-                command_list.Get()->ClearRenderTargetView(rtv_handle, clear_color_, 0, nullptr);
+                backend.ClearRenderTarget(swap_chain, clear_color_, context);
 
                 // Set root parameters
-                composition_pipeline_->SetRootParameters(command_list.Get(), GetPassAPI());
-
-                // Get vertex buffer
-                const dx12_util::Resource& vertex_buffer_resource
-                    = manager.GetReadResource(full_screen_triangle_info_.vertex_buffer_handle, read_token);
-                const dx12_util::Buffer& vertex_buffer
-                    = dynamic_cast<const dx12_util::Buffer&>(vertex_buffer_resource);
-
-                // Create vertex buffer view
-                D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = {};
-                vertex_buffer_view.BufferLocation = vertex_buffer.GetGPUVirtualAddress();
-                vertex_buffer_view.SizeInBytes = vertex_buffer.GetSize();
-                vertex_buffer_view.StrideInBytes = sizeof(Vertex);
-
-                // Set vertex buffer view
-                command_list.Get()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
-
-                // Get index buffer
-                const dx12_util::Resource& index_buffer_resource
-                    = manager.GetReadResource(full_screen_triangle_info_.index_buffer_handle, read_token);
-                const dx12_util::Buffer& index_buffer
-                    = dynamic_cast<const dx12_util::Buffer&>(index_buffer_resource);
-
-                // Create index buffer view
-                D3D12_INDEX_BUFFER_VIEW index_buffer_view = {};
-                index_buffer_view.BufferLocation = index_buffer.GetGPUVirtualAddress();
-                index_buffer_view.SizeInBytes = index_buffer.GetSize();
-                index_buffer_view.Format = INDEX_BUFFER_FORMAT;
-
-                // Set index buffer view
-                command_list.Get()->IASetIndexBuffer(&index_buffer_view);
+                backend.SetRootParameters(*composition_pipeline_, GetPassAPI(), context);
+
+                // Set vertex buffer
+                backend.SetVertexBuffer(
+                    *full_screen_triangle_info_.vertex_buffer_handle,
+                    manager.GetReadResource(full_screen_triangle_info_.vertex_buffer_handle, read_token),
+                    sizeof(Vertex), context);
+
+                // Set index buffer
+                backend.SetIndexBuffer(
+                    *full_screen_triangle_info_.index_buffer_handle,
+                    manager.GetReadResource(full_screen_triangle_info_.index_buffer_handle, read_token),
+                    INDEX_BUFFER_FORMAT, context);
 
                 // Draw call
-                command_list.Get()->DrawIndexedInstanced(
-                    full_screen_triangle_info_.index_count, 1, 0, 0, 0);
+                backend.DrawIndexed(full_screen_triangle_info_.index_count, context);
 
                 // Set render target to present barrier
-                dx12_util::Barrier barrier_rt_to_present(
-                    swap_chain->GetCurrentBackBuffer(), command_list.Get(), 
-                    D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+                backend.TransitionResource(
+                    *swap_chain.handle, *swap_chain.resource, D3D12_RESOURCE_STATE_PRESENT, context);
             });
 
-            // Reset
-            swap_chain_handle_ = nullptr;
-            clear_color_[0] = 0.0f;
-            clear_color_[1] = 0.0f;
-            clear_color_[2] = 0.0f;
-            clear_color_[3] = 1.0f;
-            post_process_texture_handle_ = nullptr;
-            ui_texture_handle_ = nullptr;
-            full_screen_triangle_info_ = FullScreenTriangleInfo();
-            has_viewport_ = false;
-            has_scissor_rect_ = false;
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         });
 }
 
+void CompositionPass::ResetFrameData()
+{
+    swap_chain_handle_ = nullptr;
+    clear_color_[0] = 0.0f;
+    clear_color_[1] = 0.0f;
+    clear_color_[2] = 0.0f;
+    clear_color_[3] = 1.0f;
+    post_process_texture_handle_ = nullptr;
+    ui_texture_handle_ = nullptr;
+    full_screen_triangle_info_ = FullScreenTriangleInfo();
+    has_viewport_ = false;
+    has_scissor_rect_ = false;
+}
+
 const ResourceHandle* CompositionPass::GetPostProcessTextureHandle() const
 {
     assert(IsSetup() && "Instance must be setup before use.");
@@ -72,13 +72,27 @@ LightTypeHandleID DirectionalLight::GetLightTypeHandleID() const
 }
 
 void DirectionalLight::UpdateViewProjMatrix()
+{
+    XMMATRIX view_matrix;
+    XMMATRIX proj_matrix;
+    ComputeViewProjMatrices(
+        rotation_, distance_, ortho_width_, ortho_height_, near_z_, far_z_, view_matrix, proj_matrix);
+
+    // Transpose for HLSL and store the view and projection matrices
+    view_matrix_ = XMMatrixTranspose(view_matrix);
+    proj_matrix_ = XMMatrixTranspose(proj_matrix);
+}
+
+void DirectionalLight::ComputeViewProjMatrices(
+    const XMFLOAT4& rotation, float distance, float ortho_width, float ortho_height,
+    float near_z, float far_z, XMMATRIX& view_matrix, XMMATRIX& proj_matrix)
 {
     // Store direction and up vectors
     XMVECTOR up_vec = XMLoadFloat3(&light::DEFAULT_LIGHT_UP);
     XMVECTOR forward_vec = XMLoadFloat3(&light::DEFAULT_LIGHT_DIRECTION);
 
     // Rotate direction and up vectors by the light's rotation
-	XMVECTOR rot_vec = XMLoadFloat4(&rotation_);
+	XMVECTOR rot_vec = XMLoadFloat4(&rotation);
     XMVECTOR rotated_forward_vec = XMVector3Rotate(forward_vec, rot_vec);
     XMVECTOR rotated_up_vec = XMVector3Rotate(up_vec, rot_vec);
 
@@ -87,17 +101,13 @@ void DirectionalLight::UpdateViewProjMatrix()
 
     // Calculate light position based on scene center and rotated direction
     XMVECTOR pos_vec = XMVectorAdd(
-        scene_center_vec, XMVectorScale(rotated_forward_vec, -distance_));
+        scene_center_vec, XMVectorScale(rotated_forward_vec, -distance));
 
     // Create view matrix
-    XMMATRIX view_matrix = XMMatrixLookAtLH(pos_vec, scene_center_vec, rotated_up_vec);
+    view_matrix = XMMatrixLookAtLH(pos_vec, scene_center_vec, rotated_up_vec);
 
     // Create orthographic projection matrix
-    XMMATRIX proj_matrix = XMMatrixOrthographicLH(ortho_width_, ortho_height_, near_z_, far_z_);
-
-    // Transpose for HLSL and store the view and projection matrices
-    view_matrix_ = XMMatrixTranspose(view_matrix);
-    proj_matrix_ = XMMatrixTranspose(proj_matrix);
+    proj_matrix = XMMatrixOrthographicLH(ortho_width, ortho_height, near_z, far_z);
 }
 
 } // namespace render_graph
\ No newline at end of file
@@ -9,7 +9,7 @@ using namespace DirectX;
 #include "directx12_util/include/d3dx12.h"
 #include "directx12_util/include/helper.h"
 
-#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/material_manager.h"
 
 namespace render_graph
@@ -107,107 +107,47 @@ bool GeometryPass::AddToGraph(RenderGraph &render_graph)
             const ResourceAccessToken& read_token = self_pass.GetReadToken();
             current_read_token_ = read_token;
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Set viewport and scissor rect
-            command_list.Get()->RSSetViewports(1, &viewport_);
-            command_list.Get()->RSSetScissorRects(1, &scissor_rect_);
-
-            // Set primitive topology
-            command_list.Get()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-            // Get heap manager
-            HeapManager& heap_manager = HeapManager::GetInstance();
-
-            // Create descriptor heaps vector
-            std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
-            heap_manager.WithUniqueLock([&](HeapManager& manager) 
-            {
-                descriptor_heaps.push_back(manager.GetSrvHeap().Get());
-            });
+            backend.SetViewport(viewport_, context);
+            backend.SetScissorRect(scissor_rect_, context);
 
             // Set descriptor heaps
-            command_list.Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+            backend.SetDescriptorHeaps(context);
 
             ResourceManager& resource_manager = ResourceManager::GetInstance();
             resource_manager.WithLock([&](ResourceManager& manager)
             {
-                // Get render targets
-                dx12_util::Texture2D* render_target_textures[(UINT)GBufferIndex::COUNT];
-                for (UINT i = 0; i < (UINT)GBufferIndex::COUNT; ++i)
-                {
-                    // Get resource
-                    dx12_util::Resource& render_target_resource 
-                        = manager.GetWriteResource(&gbuffer_texture_handles_->at(i), write_token);
-
-                    // Cast to Texture2D and store
-                    dx12_util::Texture2D* render_target_texture 
-                        = dynamic_cast<dx12_util::Texture2D*>(&render_target_resource);
-                    
-                    // Store in array
-                    render_target_textures[i] = render_target_texture;
-                }
-
-                // Set before to render target state barriers
-                for (UINT i = 0; i < (UINT)GBufferIndex::COUNT; ++i)
-                {
-                    if (render_target_textures[i]->GetCurrentState() == D3D12_RESOURCE_STATE_RENDER_TARGET)
-                        continue; // Skip if already in render target state
-
-                    dx12_util::Barrier rt_barrier(
-                        render_target_textures[i]->Get(), command_list.Get(),
-                        render_target_textures[i]->GetCurrentState(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-                    // Set current state to render target
-                    render_target_textures[i]->SetCurrentState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-                }
-
-                // Create RTV handles array
-                D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[(UINT)GBufferIndex::COUNT];
+                // Get render targets and set before to render target state barriers
+                std::vector<RenderTargetBinding> render_targets((UINT)GBufferIndex::COUNT);
                 for (UINT i = 0; i < (UINT)GBufferIndex::COUNT; ++i)
-                    rtv_handles[i] = render_target_textures[i]->GetRtvCpuHandle();
-
-                // Get depth stencil
-                dx12_util::Resource& depth_resource = manager.GetWriteResource(depth_stencil_texture_handle_, write_token);
-                dx12_util::Texture2D& depth_texture_2d = dynamic_cast<dx12_util::Texture2D&>(depth_resource);
-
-                // Set before to depth write state barrier
-                if (depth_texture_2d.GetCurrentState() != D3D12_RESOURCE_STATE_DEPTH_WRITE)
                 {
-                    dx12_util::Barrier depth_to_dw_barrier(
-                        depth_texture_2d.Get(), command_list.Get(),
-                        depth_texture_2d.GetCurrentState(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+                    render_targets[i].handle = &gbuffer_texture_handles_->at(i);
+                    render_targets[i].resource = &manager.GetWriteResource(render_targets[i].handle, write_token);
 
-                    // Set current state to depth write
-                    depth_texture_2d.SetCurrentState(D3D12_RESOURCE_STATE_DEPTH_WRITE);
+                    backend.TransitionResource(
+                        *render_targets[i].handle, *render_targets[i].resource,
+                        D3D12_RESOURCE_STATE_RENDER_TARGET, context);
                 }
 
-                // Get DSV handle
-                D3D12_CPU_DESCRIPTOR_HANDLE dsv_handle = depth_texture_2d.GetDsvCpuHandle();
+                // Get depth stencil and set before to depth write state barrier
+                RenderTargetBinding depth_stencil;
+                depth_stencil.handle = depth_stencil_texture_handle_;
+                depth_stencil.resource = &manager.GetWriteResource(depth_stencil.handle, write_token);
+                backend.TransitionResource(
+                    *depth_stencil.handle, *depth_stencil.resource, D3D12_RESOURCE_STATE_DEPTH_WRITE, context);
 
                 // Set render targets
-                command_list.Get()->OMSetRenderTargets(
-                    (UINT)GBufferIndex::COUNT, rtv_handles, FALSE, &dsv_handle);
+                backend.SetRenderTargets(render_targets, &depth_stencil, context);
 
                 // Clear render targets
                 for (UINT i = 0; i < (UINT)GBufferIndex::COUNT; ++i)
-                {
-                    float clear_color[4] = 
-                    {
-                        GBUFFER_CLEAR_COLORS[i][0],
-                        GBUFFER_CLEAR_COLORS[i][1],
-                        GBUFFER_CLEAR_COLORS[i][2],
-                        GBUFFER_CLEAR_COLORS[i][3]
-                    };
-
-                    command_list.Get()->ClearRenderTargetView(
-                        rtv_handles[i], clear_color, 0, nullptr);
-                }
+                    backend.ClearRenderTarget(render_targets[i], GBUFFER_CLEAR_COLORS[i], context);
 
                 // Clear depth stencil
-                command_list.Get()->ClearDepthStencilView(
-                    dsv_handle, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, &scissor_rect_);
+                backend.ClearDepthStencil(depth_stencil, DEPTH_CLEAR_VALUE, STENCIL_CLEAR_VALUE, context);
 
                 // Render each mesh buffer
                 for (const MeshInfo& mesh_info : mesh_infos_)
@@ -233,7 +173,7 @@ bool GeometryPass::AddToGraph(RenderGraph &render_graph)
                     Pipeline& pipeline = *(pipeline_iter->second);
 
                     // Set pipeline state and root signature
-                    pipeline.SetPipeline(command_list.Get());
+                    backend.SetPipeline(pipeline, context);
 
                     material_manager.WithLock([&](MaterialManager& manager)
                     {
@@ -244,71 +184,52 @@ bool GeometryPass::AddToGraph(RenderGraph &render_graph)
                         drawing_material_handle_ = mesh_info.material_handle;
 
                         // Set root parameters
-                        pipeline.SetRootParameters(command_list.Get(), GetPassAPI());
+                        backend.SetRootParameters(pipeline, GetPassAPI(), context);
                     });
 
-                    // Get vertex buffer
-                    const dx12_util::Resource& vertex_buffer_resource
-                        = manager.GetReadResource(mesh_info.vertex_buffer_handle, read_token);
-                    const dx12_util::Buffer& vertex_buffer 
-                        = dynamic_cast<const dx12_util::Buffer&>(vertex_buffer_resource);
-
-                    // Create vertex buffer view
-                    D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = {};
-                    vertex_buffer_view.BufferLocation = vertex_buffer.GetGPUVirtualAddress();
-                    vertex_buffer_view.SizeInBytes = vertex_buffer.GetSize();
-                    vertex_buffer_view.StrideInBytes = sizeof(Vertex);
-
-                    // Set vertex buffer view
-                    command_list.Get()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
-
-                    // Get index buffer
-                    const dx12_util::Resource& index_buffer_resource
-                        = manager.GetReadResource(mesh_info.index_buffer_handle, read_token);
-                    const dx12_util::Buffer& index_buffer 
-                        = dynamic_cast<const dx12_util::Buffer&>(index_buffer_resource);
+                    // Set vertex buffer
+                    backend.SetVertexBuffer(
+                        *mesh_info.vertex_buffer_handle,
+                        manager.GetReadResource(mesh_info.vertex_buffer_handle, read_token), sizeof(Vertex), context);
 
-                    // Create index buffer view
-                    D3D12_INDEX_BUFFER_VIEW index_buffer_view = {};
-                    index_buffer_view.BufferLocation = index_buffer.GetGPUVirtualAddress();
-                    index_buffer_view.SizeInBytes = index_buffer.GetSize();
-                    index_buffer_view.Format = INDEX_BUFFER_FORMAT;
-
-                    // Set index buffer view
-                    command_list.Get()->IASetIndexBuffer(&index_buffer_view);
+                    // Set index buffer
+                    backend.SetIndexBuffer(
+                        *mesh_info.index_buffer_handle,
+                        manager.GetReadResource(mesh_info.index_buffer_handle, read_token), INDEX_BUFFER_FORMAT,
+                        context);
 
                     // Draw call
-                    command_list.Get()->DrawIndexedInstanced(mesh_info.index_count, 1, 0, 0, 0);
+                    backend.DrawIndexed(mesh_info.index_count, context);
                 }
 
                 // Set render target to pixel shader resource state barriers
-                for (UINT i = 0; i < (UINT)GBufferIndex::COUNT; ++i)
+                for (const RenderTargetBinding& render_target : render_targets)
                 {
-                    dx12_util::Barrier rt_to_pr_barrier(
-                        render_target_textures[i]->Get(), command_list.Get(),
-                        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-                    // Set current state to pixel shader resource
-                    render_target_textures[i]->SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                    backend.TransitionResource(
+                        *render_target.handle, *render_target.resource,
+                        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
                 }
 
                 // Set depth stencil to pixel shader resource state barrier
-                dx12_util::Barrier depth_to_dr_barrier(
-                    depth_texture_2d.Get(), command_list.Get(),
-                    D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-                // Set current state to pixel shader resource
-                depth_texture_2d.SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                backend.TransitionResource(
+                    *depth_stencil.handle, *depth_stencil.resource,
+                    D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
             });
 
-            // Clear draw target mesh info for next frame
-            mesh_infos_.clear();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void GeometryPass::ResetFrameData()
+{
+    // Clear draw target mesh info for next frame
+    mesh_infos_.clear();
+}
+
 void render_graph::GeometryPass::SetGBuffers(const ResourceHandles* texture_handles)
 {
     assert(IsSetup() && "Instance is not setup");
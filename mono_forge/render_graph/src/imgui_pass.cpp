@@ -2,11 +2,9 @@
 #include "render_graph/include/imgui_pass.h"
 
 #include "imgui_internal.h" // DockBuilder API
-#include "imgui_impl_win32.h"
-#include "imgui_impl_dx12.h"
 #include "ImGuizmo.h"
 #include "directx12_util/include/wrapper.h"
-#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/imgui_context_manager.h"
 
 namespace render_graph
@@ -56,8 +54,8 @@ bool ImguiPass::AddToGraph(RenderGraph &render_graph)
             // Get write access token for target texture
             const ResourceAccessToken& write_token = self_pass.GetWriteToken();
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Get Imgui context manager
             ImguiContextManager& context_manager = ImguiContextManager::GetInstance();
@@ -72,8 +70,7 @@ bool ImguiPass::AddToGraph(RenderGraph &render_graph)
                 ImGuizmo::SetImGuiContext(imgui_context.Get());
 
                 // Start new frame for backends
-                ImGui_ImplDX12_NewFrame();
-                ImGui_ImplWin32_NewFrame();
+                backend.NewImguiFrame(context);
                 ImGui::NewFrame();
                 ImGuizmo::BeginFrame();
 
@@ -85,78 +82,51 @@ bool ImguiPass::AddToGraph(RenderGraph &render_graph)
                 ImGui::Render();
             });
 
-            // Get heap manager
-            HeapManager& heap_manager = HeapManager::GetInstance();
-
-            // Create descriptor heaps vector
-            std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
-            heap_manager.WithUniqueLock([&](HeapManager& manager) 
-            {
-                descriptor_heaps.push_back(manager.GetSrvHeap().Get());
-            });
-
             // Set descriptor heaps
-            command_list.Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+            backend.SetDescriptorHeaps(context);
 
             ResourceManager& resource_manager = ResourceManager::GetInstance();
             resource_manager.WithLock([&](ResourceManager& manager)
             {
                 // Get target texture
-                dx12_util::Resource& target_texture_resource =
-                    manager.GetWriteResource(target_texture_handle_, write_token);
-                dx12_util::Texture2D& target_texture =
-                    static_cast<dx12_util::Texture2D&>(target_texture_resource);
+                RenderTargetBinding target_texture;
+                target_texture.handle = target_texture_handle_;
+                target_texture.resource = &manager.GetWriteResource(target_texture_handle_, write_token);
 
                 // Set barrier to transition target texture to render target state
-                if (target_texture.GetCurrentState() != D3D12_RESOURCE_STATE_RENDER_TARGET)
-                {
-                    dx12_util::Barrier rt_barrier(
-                        target_texture.Get(), command_list.Get(),
-                        target_texture.GetCurrentState(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-                    // Update current state
-                    target_texture.SetCurrentState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-                }
-
-                // Get RTV CPU descriptor handle
-                D3D12_CPU_DESCRIPTOR_HANDLE rtv_handle = target_texture.GetRtvCpuHandle();
+                backend.TransitionResource(
+                    *target_texture.handle, *target_texture.resource, D3D12_RESOURCE_STATE_RENDER_TARGET, context);
 
                 // Setup render target
-                command_list.Get()->OMSetRenderTargets(1, &rtv_handle, FALSE, nullptr);
+                backend.SetRenderTargets({ target_texture }, nullptr, context);
 
                 // Clear render target
-                float clear_color[4] =
-                {
-                    TARGET_CLEAR_COLOR[0],
-                    TARGET_CLEAR_COLOR[1],
-                    TARGET_CLEAR_COLOR[2],
-                    TARGET_CLEAR_COLOR[3]
-                };
-
-                command_list.Get()->ClearRenderTargetView(rtv_handle, clear_color, 0, nullptr);
+                backend.ClearRenderTarget(target_texture, TARGET_CLEAR_COLOR, context);
 
                 // Record Dear ImGui draw data
-                ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), command_list.Get());
+                backend.RenderImgui(context);
 
                 // Set barrier to transition target texture to shader resource state
-                dx12_util::Barrier srv_barrier(
-                    target_texture.Get(), command_list.Get(),
-                    D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-                
-                // Update current state
-                target_texture.SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                backend.TransitionResource(
+                    *target_texture.handle, *target_texture.resource,
+                    D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
             });
 
-            // Reset
-            target_texture_handle_ = nullptr;
-            context_handle_ = nullptr;
-            draw_func_ = nullptr;
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void ImguiPass::ResetFrameData()
+{
+    target_texture_handle_ = nullptr;
+    context_handle_ = nullptr;
+    draw_func_ = nullptr;
+}
+
 void ImguiPass::SetTargetTexture(const ResourceHandle* target_texture_handle)
 {
     assert(IsSetup() && "Instance is not setup");
@@ -17,6 +17,11 @@ XMMATRIX CreateMatrix(const XMFLOAT3& position, const XMFLOAT4& rotation)
 }
 
 void Light::SetRotation(const DirectX::XMFLOAT3& euler_angles_deg)
+{
+    rotation_ = ToRotation(euler_angles_deg);
+}
+
+XMFLOAT4 Light::ToRotation(const DirectX::XMFLOAT3& euler_angles_deg)
 {
     // Convert Euler angles from degrees to radians
     XMFLOAT3 euler_angles_rad = XMFLOAT3(
@@ -29,7 +34,9 @@ void Light::SetRotation(const DirectX::XMFLOAT3& euler_angles_deg)
         euler_angles_rad.x, euler_angles_rad.y, euler_angles_rad.z);
 
     // Store rotation
-    XMStoreFloat4(&rotation_, rot_vec);
+    XMFLOAT4 rotation;
+    XMStoreFloat4(&rotation, rot_vec);
+    return rotation;
 }
 
 void Light::UpdateWorldMatrices()
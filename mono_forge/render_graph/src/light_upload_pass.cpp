@@ -3,6 +3,7 @@
 
 #include "render_graph/include/resource_manager.h"
 #include "render_graph/include/light_manager.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph
 {
@@ -54,17 +55,19 @@ bool LightUploadPass::AddToGraph(RenderGraph &render_graph)
             // Set number of lights in light config
             light_config_.num_lights = static_cast<uint>(light_handles_.size());
 
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
+
             ResourceManager::GetInstance().WithLock([&](ResourceManager& manager)
             {
                 // Get light config buffer for writing
                 dx12_util::Resource& light_config_resource 
                     = manager.GetWriteResource(light_config_buffer_handle_, write_token);
-                dx12_util::Buffer* light_config_buffer 
-                    = dynamic_cast<dx12_util::Buffer*>(&light_config_resource);
-                assert(light_config_buffer != nullptr && "Failed to cast to dx12_util::Buffer");
 
                 // Update light config buffer data
-                light_config_buffer->UpdateData(&light_config_, sizeof(Light::LightConfigBuffer));
+                backend.UpdateBuffer(
+                    *light_config_buffer_handle_, light_config_resource,
+                    &light_config_, sizeof(Light::LightConfigBuffer), 0, context);
             });
 
             LightManager::GetInstance().WithLock([&](LightManager& light_manager)
@@ -74,9 +77,6 @@ bool LightUploadPass::AddToGraph(RenderGraph &render_graph)
                     // Get lights upload buffer for writing
                     dx12_util::Resource& lights_upload_resource 
                         = resource_manager.GetWriteResource(lights_upload_buffer_handle_, write_token);
-                    dx12_util::Buffer* lights_buffer 
-                        = dynamic_cast<dx12_util::Buffer*>(&lights_upload_resource);
-                    assert(lights_buffer != nullptr && "Failed to cast to dx12_util::Buffer");
 
                     // For each light handle, get light data and upload to buffer
                     for (size_t i = 0; i < light_handles_.size(); ++i)
@@ -89,26 +89,34 @@ bool LightUploadPass::AddToGraph(RenderGraph &render_graph)
 
                         // Update lights upload buffer at the correct offset
                         size_t offset = i * sizeof(Light::LightBuffer);
-                        lights_buffer->UpdateData(light_buffer, sizeof(Light::LightBuffer), offset);
+                        backend.UpdateBuffer(
+                            *lights_upload_buffer_handle_, lights_upload_resource,
+                            light_buffer, sizeof(Light::LightBuffer), offset, context);
                     }
                 });
             });
 
-            // Clear light handles after upload
-            light_handles_.clear();
-
-            // Reset buffer handles
-            lights_upload_buffer_handle_ = nullptr;
-            light_config_buffer_handle_ = nullptr;
-
-            // Clear light config
-            light_config_ = Light::LightConfigBuffer();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void LightUploadPass::ResetFrameData()
+{
+    // Clear light handles after upload
+    light_handles_.clear();
+
+    // Reset buffer handles
+    lights_upload_buffer_handle_ = nullptr;
+    light_config_buffer_handle_ = nullptr;
+
+    // Clear light config
+    light_config_ = Light::LightConfigBuffer();
+}
+
 void LightUploadPass::AddUploadLight(const LightHandle* light_handle)
 {
     assert(IsSetup() && "Instance is not setup");
@@ -1,7 +1,7 @@
 #include "render_graph/src/pch.h"
 #include "render_graph/include/lighting_pass.h"
 
-#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/resource_manager.h"
 
 namespace render_graph
@@ -96,152 +96,90 @@ bool LightingPass::AddToGraph(RenderGraph &render_graph)
             const ResourceAccessToken& read_token = self_pass.GetReadToken();
             current_read_token_ = read_token;
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Set pipeline
-            lighting_pipeline_->SetPipeline(command_list.Get());
+            backend.SetPipeline(*lighting_pipeline_, context);
 
             // Set viewport and scissor rect
-            command_list.Get()->RSSetViewports(1, &viewport_);
-            command_list.Get()->RSSetScissorRects(1, &scissor_rect_);
-
-            // Set primitive topology
-            command_list.Get()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-            // Get heap manager
-            HeapManager& heap_manager = HeapManager::GetInstance();
-
-            // Create descriptor heaps vector
-            std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
-            heap_manager.WithUniqueLock([&](HeapManager& manager) 
-            {
-                descriptor_heaps.push_back(manager.GetSrvHeap().Get());
-            });
+            backend.SetViewport(viewport_, context);
+            backend.SetScissorRect(scissor_rect_, context);
 
             // Set descriptor heaps
-            command_list.Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+            backend.SetDescriptorHeaps(context);
 
             ResourceManager& resource_manager = ResourceManager::GetInstance();
             resource_manager.WithLock([&](ResourceManager& manager)
             {
-                // Get render targets
-                dx12_util::Texture2D* render_target_textures[(uint32_t)lighting_pass::RenderTargetIndex::COUNT];
+                // Get render targets and set before state to render target barriers
+                std::vector<RenderTargetBinding> render_targets((uint32_t)lighting_pass::RenderTargetIndex::COUNT);
                 for (uint32_t i = 0; i < (uint32_t)lighting_pass::RenderTargetIndex::COUNT; ++i)
                 {
-                    // Get render target texture
-                    dx12_util::Resource& render_target_resource
-                        = manager.GetWriteResource(&render_target_texture_handles_->at(i), write_token);
-                    dx12_util::Texture2D* render_target_texture
-                        = dynamic_cast<dx12_util::Texture2D*>(&render_target_resource);
-                    assert(render_target_texture != nullptr && "Final color buffer is not a Texture2D.");
-
-                    // Store render target texture
-                    render_target_textures[i] = render_target_texture;
-                }
+                    render_targets[i].handle = &render_target_texture_handles_->at(i);
+                    render_targets[i].resource = &manager.GetWriteResource(render_targets[i].handle, write_token);
 
-                // Set before state to render target barriers
-                for (uint32_t i = 0; i < (uint32_t)lighting_pass::RenderTargetIndex::COUNT; ++i)
-                {
-                    dx12_util::Texture2D* final_color_texture = render_target_textures[i];
-
-                    if (final_color_texture->GetCurrentState() != D3D12_RESOURCE_STATE_RENDER_TARGET)
-                    {
-                        dx12_util::Barrier barrier_before_rt(
-                            final_color_texture->Get(), command_list.Get(), 
-                            final_color_texture->GetCurrentState(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-                        final_color_texture->SetCurrentState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-                    }
+                    backend.TransitionResource(
+                        *render_targets[i].handle, *render_targets[i].resource,
+                        D3D12_RESOURCE_STATE_RENDER_TARGET, context);
                 }
 
-                // Create RTV handle array
-                D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[(uint32_t)lighting_pass::RenderTargetIndex::COUNT];
-                for (uint32_t i = 0; i < (uint32_t)lighting_pass::RenderTargetIndex::COUNT; ++i)
-                    rtv_handles[i] = render_target_textures[i]->GetRtvCpuHandle();
-
                 // Set render target
-                command_list.Get()->OMSetRenderTargets(
-                    (uint32_t)lighting_pass::RenderTargetIndex::COUNT, rtv_handles, FALSE, nullptr);
+                backend.SetRenderTargets(render_targets, nullptr, context);
 
                 // Clear render targets
                 for (uint32_t i = 0; i < (uint32_t)lighting_pass::RenderTargetIndex::COUNT; ++i)
-                {
-                    float clear_color[4] = 
-                    {
-                        lighting_pass::RENDER_TARGET_CLEAR_COLORS[i][0],
-                        lighting_pass::RENDER_TARGET_CLEAR_COLORS[i][1],
-                        lighting_pass::RENDER_TARGET_CLEAR_COLORS[i][2],
-                        lighting_pass::RENDER_TARGET_CLEAR_COLORS[i][3]
-                    };
-
-                    command_list.Get()->ClearRenderTargetView(rtv_handles[i], clear_color, 0, nullptr);
-                }
+                    backend.ClearRenderTarget(render_targets[i], lighting_pass::RENDER_TARGET_CLEAR_COLORS[i], context);
 
                 // Set root parameters
-                lighting_pipeline_->SetRootParameters(command_list.Get(), GetPassAPI());
-
-                // Get vertex buffer
-                const dx12_util::Resource& vertex_buffer_resource
-                    = manager.GetReadResource(full_screen_triangle_info_.vertex_buffer_handle, read_token);
-                const dx12_util::Buffer& vertex_buffer
-                    = dynamic_cast<const dx12_util::Buffer&>(vertex_buffer_resource);
-
-                // Create vertex buffer view
-                D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = {};
-                vertex_buffer_view.BufferLocation = vertex_buffer.GetGPUVirtualAddress();
-                vertex_buffer_view.SizeInBytes = vertex_buffer.GetSize();
-                vertex_buffer_view.StrideInBytes = sizeof(lighting_pass::Vertex);
-
-                // Set vertex buffer view
-                command_list.Get()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
-
-                // Get index buffer
-                const dx12_util::Resource& index_buffer_resource
-                    = manager.GetReadResource(full_screen_triangle_info_.index_buffer_handle, read_token);
-                const dx12_util::Buffer& index_buffer
-                    = dynamic_cast<const dx12_util::Buffer&>(index_buffer_resource);
-
-                // Create index buffer view
-                D3D12_INDEX_BUFFER_VIEW index_buffer_view = {};
-                index_buffer_view.BufferLocation = index_buffer.GetGPUVirtualAddress();
-                index_buffer_view.SizeInBytes = index_buffer.GetSize();
-                index_buffer_view.Format = lighting_pass::INDEX_BUFFER_FORMAT;
-
-                // Set index buffer view
-                command_list.Get()->IASetIndexBuffer(&index_buffer_view);
+                backend.SetRootParameters(*lighting_pipeline_, GetPassAPI(), context);
+
+                // Set vertex buffer
+                backend.SetVertexBuffer(
+                    *full_screen_triangle_info_.vertex_buffer_handle,
+                    manager.GetReadResource(full_screen_triangle_info_.vertex_buffer_handle, read_token),
+                    sizeof(lighting_pass::Vertex), context);
+
+                // Set index buffer
+                backend.SetIndexBuffer(
+                    *full_screen_triangle_info_.index_buffer_handle,
+                    manager.GetReadResource(full_screen_triangle_info_.index_buffer_handle, read_token),
+                    lighting_pass::INDEX_BUFFER_FORMAT, context);
 
                 // Draw call
-                command_list.Get()->DrawIndexedInstanced(
-                    full_screen_triangle_info_.index_count, 1, 0, 0, 0);
+                backend.DrawIndexed(full_screen_triangle_info_.index_count, context);
 
                 // Set render target to pixel shader resource barriers
-                for (uint32_t i = 0; i < (uint32_t)lighting_pass::RenderTargetIndex::COUNT; ++i)
+                for (const RenderTargetBinding& render_target : render_targets)
                 {
-                    dx12_util::Barrier rt_to_pr_barrier(
-                        render_target_textures[i]->Get(), command_list.Get(),
-                        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-                    // Set current state to pixel shader resource
-                    render_target_textures[i]->SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                    backend.TransitionResource(
+                        *render_target.handle, *render_target.resource,
+                        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
                 }
             });
 
-            // Reset buffer handles
-            full_screen_triangle_info_ = FullScreenTriangleInfo();
-            render_target_texture_handles_ = nullptr;
-            inv_view_proj_matrix_buffer_handle_ = nullptr;
-            right_config_buffer_handle_ = nullptr;
-            rights_buffer_handle_ = nullptr;
-
-            // Clear current tokens
-            current_read_token_ = ResourceAccessToken();
-            current_write_token_ = ResourceAccessToken();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void LightingPass::ResetFrameData()
+{
+    // Reset buffer handles
+    full_screen_triangle_info_ = FullScreenTriangleInfo();
+    render_target_texture_handles_ = nullptr;
+    inv_view_proj_matrix_buffer_handle_ = nullptr;
+    right_config_buffer_handle_ = nullptr;
+    rights_buffer_handle_ = nullptr;
+
+    // Clear current tokens
+    current_read_token_ = ResourceAccessToken();
+    current_write_token_ = ResourceAccessToken();
+}
+
 void LightingPass::SetFullScreenTriangleInfo(FullScreenTriangleInfo&& fs_triangle_info)
 {
     assert(IsSetup() && "Instance is not setup");
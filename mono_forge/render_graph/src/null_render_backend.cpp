@@ -0,0 +1,345 @@
+﻿#include "render_graph/src/pch.h"
+#include "render_graph/include/null_render_backend.h"
+
+#include "utility_header/logger.h"
+
+namespace render_graph
+{
+
+std::unique_ptr<dx12_util::Resource> NullRenderBackend::CreateResource(const RenderResourceDesc& desc)
+{
+    return std::make_unique<NullResource>(desc);
+}
+
+void NullRenderBackend::OnResourceAdded(const ResourceHandle& handle, dx12_util::Resource& resource)
+{
+    TrackedResource tracked_resource;
+
+    // Use the description of the null resource, otherwise track it as a buffer
+    NullResource* null_resource = dynamic_cast<NullResource*>(&resource);
+    if (null_resource != nullptr)
+    {
+        tracked_resource.desc = null_resource->GetDesc();
+        tracked_resource.state = tracked_resource.desc.initial_state;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(resources_.find(handle) == resources_.end() && "Resource is already tracked.");
+
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::AddResource;
+    event.resource_handle = handle;
+    event.after_state = tracked_resource.state;
+    events_.emplace_back(event);
+
+    resources_.emplace(handle, tracked_resource);
+}
+
+void NullRenderBackend::OnResourceErased(const ResourceHandle& handle)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    resources_.erase(handle);
+
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::EraseResource;
+    event.resource_handle = handle;
+    events_.emplace_back(event);
+}
+
+bool NullRenderBackend::ExecutePass(RenderPass& pass, RenderPassContext& context)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // Check all declared resources are tracked
+        for (const ResourceAccessToken* token : { &pass.GetReadToken(), &pass.GetWriteToken() })
+        {
+            for (const ResourceHandle* handle : token->GetAccessibleResourceHandles())
+            {
+                if (resources_.find(*handle) != resources_.end())
+                    continue;
+
+                utility_header::ConsoleLogErr(
+                    { "Render pass declares a resource which is not created. HandleID: "
+                        + std::to_string(pass.GetHandleID()) },
+                    __FILE__, __LINE__, __FUNCTION__);
+                return false; // Failure
+            }
+        }
+
+        RenderBackendEvent event;
+        event.type = RenderBackendEventType::ExecutePass;
+        event.pass_id = pass.GetHandleID();
+        events_.emplace_back(event);
+
+        executing_pass_ = &pass;
+    }
+
+    // The pass records its commands back to this backend
+    bool result = pass.Execute(context);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    executing_pass_ = nullptr;
+
+    return result;
+}
+
+void NullRenderBackend::TransitionResource(
+    const ResourceHandle& handle, dx12_util::Resource& resource, D3D12_RESOURCE_STATES state,
+    RenderPassContext& context)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = resources_.find(handle);
+    assert(it != resources_.end() && "Resource is not tracked.");
+
+    if (it->second.state == state)
+        return; // Already in the state
+
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::Transition;
+    event.resource_handle = handle;
+    if (executing_pass_ != nullptr)
+    {
+        event.pass_id = executing_pass_->GetHandleID();
+        event.in_pass = true;
+    }
+    event.before_state = it->second.state;
+    event.after_state = state;
+    events_.emplace_back(event);
+
+    it->second.state = state;
+}
+
+void NullRenderBackend::UpdateBuffer(
+    const ResourceHandle& handle, dx12_util::Resource& resource, const void* data, uint32_t size,
+    uint32_t offset, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::UpdateBuffer;
+    event.resource_handle = handle;
+    event.size = size;
+    event.offset = offset;
+    Record(event);
+}
+
+void NullRenderBackend::CopyBuffer(
+    const ResourceHandle& dest_handle, dx12_util::Resource& dest,
+    const ResourceHandle& source_handle, const dx12_util::Resource& source, uint32_t size,
+    RenderPassContext& context)
+{
+    assert(GetResourceState(dest_handle) == D3D12_RESOURCE_STATE_COPY_DEST && "Buffer is not in copy dest state.");
+
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::CopyBuffer;
+    event.resource_handle = dest_handle;
+    event.source_handle = source_handle;
+    event.size = size;
+    Record(event);
+}
+
+void NullRenderBackend::UploadTexture(
+    const ResourceHandle& texture_handle, dx12_util::Resource& texture,
+    const ResourceHandle& upload_buffer_handle, dx12_util::Resource& upload_buffer, const void* data,
+    RenderPassContext& context)
+{
+    assert(
+        GetResourceState(texture_handle) == D3D12_RESOURCE_STATE_COPY_DEST && "Texture is not in copy dest state.");
+
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::UploadTexture;
+    event.resource_handle = texture_handle;
+    event.source_handle = upload_buffer_handle;
+    Record(event);
+}
+
+void NullRenderBackend::SetPipeline(Pipeline& pipeline, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetPipeline;
+    Record(event);
+}
+
+void NullRenderBackend::SetRootParameters(Pipeline& pipeline, const PassAPI& pass_api, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetRootParameters;
+    Record(event);
+}
+
+void NullRenderBackend::SetDescriptorHeaps(RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetDescriptorHeaps;
+    Record(event);
+}
+
+void NullRenderBackend::SetViewport(const D3D12_VIEWPORT& viewport, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetViewport;
+    Record(event);
+}
+
+void NullRenderBackend::SetScissorRect(const D3D12_RECT& scissor_rect, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetScissorRect;
+    Record(event);
+}
+
+void NullRenderBackend::SetRenderTargets(
+    const std::vector<RenderTargetBinding>& render_targets, const RenderTargetBinding* depth_stencil,
+    RenderPassContext& context)
+{
+    for (uint32_t i = 0; i < render_targets.size(); ++i)
+    {
+        RenderBackendEvent event;
+        event.type = RenderBackendEventType::SetRenderTarget;
+        event.resource_handle = *render_targets[i].handle;
+        event.slot = i;
+        RecordInState(event, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+
+    if (depth_stencil != nullptr)
+    {
+        RenderBackendEvent event;
+        event.type = RenderBackendEventType::SetDepthStencil;
+        event.resource_handle = *depth_stencil->handle;
+        RecordInState(event, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+    }
+}
+
+void NullRenderBackend::ClearRenderTarget(
+    const RenderTargetBinding& render_target, const float clear_color[4], RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::ClearRenderTarget;
+    event.resource_handle = *render_target.handle;
+    RecordInState(event, D3D12_RESOURCE_STATE_RENDER_TARGET);
+}
+
+void NullRenderBackend::ClearDepthStencil(
+    const RenderTargetBinding& depth_stencil, float depth, UINT8 stencil, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::ClearDepthStencil;
+    event.resource_handle = *depth_stencil.handle;
+    RecordInState(event, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+}
+
+void NullRenderBackend::SetVertexBuffer(
+    const ResourceHandle& handle, const dx12_util::Resource& resource, UINT stride, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetVertexBuffer;
+    event.resource_handle = handle;
+    Record(event);
+}
+
+void NullRenderBackend::SetIndexBuffer(
+    const ResourceHandle& handle, const dx12_util::Resource& resource, DXGI_FORMAT format,
+    RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::SetIndexBuffer;
+    event.resource_handle = handle;
+    Record(event);
+}
+
+void NullRenderBackend::DrawIndexed(UINT index_count, RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::DrawIndexed;
+    event.index_count = index_count;
+    Record(event);
+}
+
+void NullRenderBackend::NewImguiFrame(RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::NewImguiFrame;
+    Record(event);
+}
+
+void NullRenderBackend::RenderImgui(RenderPassContext& context)
+{
+    RenderBackendEvent event;
+    event.type = RenderBackendEventType::RenderImgui;
+    Record(event);
+}
+
+void NullRenderBackend::ClearEvents()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    events_.clear();
+}
+
+std::vector<RenderPassHandleID> NullRenderBackend::GetExecutedPasses() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::vector<RenderPassHandleID> executed_passes;
+    for (const RenderBackendEvent& event : events_)
+    {
+        if (event.type == RenderBackendEventType::ExecutePass)
+            executed_passes.emplace_back(event.pass_id);
+    }
+
+    return executed_passes;
+}
+
+std::vector<RenderBackendEvent> NullRenderBackend::GetEvents(RenderBackendEventType type) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::vector<RenderBackendEvent> events;
+    for (const RenderBackendEvent& event : events_)
+    {
+        if (event.type == type)
+            events.emplace_back(event);
+    }
+
+    return events;
+}
+
+D3D12_RESOURCE_STATES NullRenderBackend::GetResourceState(const ResourceHandle& handle) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = resources_.find(handle);
+    assert(it != resources_.end() && "Resource is not tracked.");
+    return it->second.state;
+}
+
+size_t NullRenderBackend::GetResourceCount() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return resources_.size();
+}
+
+void NullRenderBackend::Record(RenderBackendEvent event)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    assert(
+        (!event.resource_handle.IsValid() || resources_.find(event.resource_handle) != resources_.end()) &&
+        "Resource is not tracked.");
+    assert(
+        (!event.source_handle.IsValid() || resources_.find(event.source_handle) != resources_.end()) &&
+        "Resource is not tracked.");
+
+    if (executing_pass_ != nullptr)
+    {
+        event.pass_id = executing_pass_->GetHandleID();
+        event.in_pass = true;
+    }
+    events_.emplace_back(event);
+}
+
+void NullRenderBackend::RecordInState(const RenderBackendEvent& event, D3D12_RESOURCE_STATES state)
+{
+    assert(GetResourceState(event.resource_handle) == state && "Resource is not in the state the command requires.");
+    Record(event);
+}
+
+} // namespace render_graph
\ No newline at end of file
@@ -11,3 +11,4 @@
 #include <algorithm>
 #include <map>
 #include <set>
+#include <queue>
@@ -0,0 +1,292 @@
+﻿#include "render_graph/src/pch.h"
+#include "render_graph/include/render_backend.h"
+
+#include "imgui.h"
+#include "imgui_impl_win32.h"
+#include "imgui_impl_dx12.h"
+#include "utility_header/logger.h"
+#include "directx12_util/include/helper.h"
+#include "directx12_util/include/d3dx12.h"
+
+#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/pipeline.h"
+#include "render_graph/include/render_pass.h"
+#include "render_graph/include/render_pass_context.h"
+
+namespace render_graph
+{
+
+namespace
+{
+
+// Get the render target view of a texture, or of the current back buffer of a swap chain
+D3D12_CPU_DESCRIPTOR_HANDLE GetRtvHandle(dx12_util::Resource& resource)
+{
+    dx12_util::SwapChain* swap_chain = dynamic_cast<dx12_util::SwapChain*>(&resource);
+    if (swap_chain != nullptr)
+        return swap_chain->GetCurrentBackBufferView();
+
+    dx12_util::Texture2D& texture = dynamic_cast<dx12_util::Texture2D&>(resource);
+    return texture.GetRtvCpuHandle();
+}
+
+// Get the depth stencil view of a texture
+D3D12_CPU_DESCRIPTOR_HANDLE GetDsvHandle(dx12_util::Resource& resource)
+{
+    dx12_util::Texture2D& texture = dynamic_cast<dx12_util::Texture2D&>(resource);
+    return texture.GetDsvCpuHandle();
+}
+
+} // namespace
+
+std::unique_ptr<dx12_util::Resource> DirectX12RenderBackend::CreateResource(const RenderResourceDesc& desc)
+{
+    ID3D12Device4* device = dx12_util::Device::GetInstance().Get();
+
+    if (desc.type == RenderResourceType::Buffer)
+    {
+        std::unique_ptr<dx12_util::Buffer> buffer = dx12_util::Buffer::CreateInstance<dx12_util::Buffer>(
+            desc.size, desc.heap_type, desc.debug_name, device, nullptr);
+        if (!buffer)
+        {
+            utility_header::ConsoleLogErr(
+                { "Failed to create buffer resource." }, __FILE__, __LINE__, __FUNCTION__);
+            return nullptr;
+        }
+
+        return buffer;
+    }
+
+    assert(desc.type == RenderResourceType::Texture2D && "Unknown render resource type.");
+
+    // Copy the clear value because Setup takes a non-const pointer
+    D3D12_CLEAR_VALUE clear_value = desc.clear_value;
+
+    std::unique_ptr<dx12_util::Texture2D> texture = nullptr;
+    HeapManager::GetInstance().WithUniqueLock([&](HeapManager& heap_manager)
+    {
+        // Create the views which the flags allow
+        bool is_render_target = (desc.flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) != 0;
+        bool is_depth_stencil = (desc.flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0;
+
+        texture = dx12_util::Texture2D::CreateInstance<dx12_util::Texture2D>(
+            desc.width, desc.height, desc.format, desc.heap_type, desc.flags, desc.initial_state, desc.debug_name,
+            device, desc.has_clear_value ? &clear_value : nullptr,
+            (desc.srv_format != DXGI_FORMAT_UNKNOWN) ? &desc.srv_format : nullptr, nullptr, nullptr, nullptr,
+            &heap_manager.GetSrvHeapAllocator(),
+            is_render_target ? &heap_manager.GetRtvHeapAllocator() : nullptr,
+            is_depth_stencil ? &heap_manager.GetDsvHeapAllocator() : nullptr);
+    });
+
+    if (!texture)
+    {
+        utility_header::ConsoleLogErr(
+            { "Failed to create texture resource." }, __FILE__, __LINE__, __FUNCTION__);
+        return nullptr;
+    }
+
+    return texture;
+}
+
+void DirectX12RenderBackend::OnResourceAdded(const ResourceHandle& handle, dx12_util::Resource& resource)
+{
+    // Nothing to do, the resource lives on the device
+}
+
+void DirectX12RenderBackend::OnResourceErased(const ResourceHandle& handle)
+{
+    // Nothing to do, the resource is released with its wrapper
+}
+
+bool DirectX12RenderBackend::ExecutePass(RenderPass& pass, RenderPassContext& context)
+{
+    return pass.Execute(context);
+}
+
+void DirectX12RenderBackend::TransitionResource(
+    const ResourceHandle& handle, dx12_util::Resource& resource, D3D12_RESOURCE_STATES state,
+    RenderPassContext& context)
+{
+    // The back buffer is only ever in the present or render target state
+    dx12_util::SwapChain* swap_chain = dynamic_cast<dx12_util::SwapChain*>(&resource);
+    if (swap_chain != nullptr)
+    {
+        D3D12_RESOURCE_STATES back_buffer_state = (state == D3D12_RESOURCE_STATE_RENDER_TARGET) ?
+            D3D12_RESOURCE_STATE_PRESENT : D3D12_RESOURCE_STATE_RENDER_TARGET;
+        dx12_util::Barrier barrier(
+            swap_chain->GetCurrentBackBuffer(), context.GetCommandList().Get(), back_buffer_state, state);
+        return;
+    }
+
+    // Only the resources which track their state can be transitioned
+    D3D12_RESOURCE_STATES current_state = D3D12_RESOURCE_STATE_COMMON;
+    dx12_util::Texture2D* texture = dynamic_cast<dx12_util::Texture2D*>(&resource);
+    dx12_util::StructuredBuffer* structured_buffer = dynamic_cast<dx12_util::StructuredBuffer*>(&resource);
+    if (texture != nullptr)
+        current_state = texture->GetCurrentState();
+    else if (structured_buffer != nullptr)
+        current_state = structured_buffer->GetCurrentState();
+    else
+        return; // The state of the resource is not tracked
+
+    if (current_state == state)
+        return; // Already in the state
+
+    dx12_util::Barrier barrier(resource.Get(), context.GetCommandList().Get(), current_state, state);
+
+    if (texture != nullptr)
+        texture->SetCurrentState(state);
+    else
+        structured_buffer->SetCurrentState(state);
+}
+
+void DirectX12RenderBackend::UpdateBuffer(
+    const ResourceHandle& handle, dx12_util::Resource& resource, const void* data, uint32_t size,
+    uint32_t offset, RenderPassContext& context)
+{
+    dx12_util::Buffer& buffer = dynamic_cast<dx12_util::Buffer&>(resource);
+
+    bool result = buffer.UpdateData(data, size, offset);
+    assert(result && "Failed to update buffer data.");
+}
+
+void DirectX12RenderBackend::CopyBuffer(
+    const ResourceHandle& dest_handle, dx12_util::Resource& dest,
+    const ResourceHandle& source_handle, const dx12_util::Resource& source, uint32_t size,
+    RenderPassContext& context)
+{
+    const dx12_util::Buffer& source_buffer = dynamic_cast<const dx12_util::Buffer&>(source);
+    context.GetCommandList().Get()->CopyBufferRegion(dest.Get(), 0, source_buffer.Get(), 0, size);
+}
+
+void DirectX12RenderBackend::UploadTexture(
+    const ResourceHandle& texture_handle, dx12_util::Resource& texture,
+    const ResourceHandle& upload_buffer_handle, dx12_util::Resource& upload_buffer, const void* data,
+    RenderPassContext& context)
+{
+    dx12_util::Texture2D& texture_2d = dynamic_cast<dx12_util::Texture2D&>(texture);
+
+    // Create a subresource data structure to update the subresource data of a texture
+    const UINT subresource_count = 1;
+    D3D12_SUBRESOURCE_DATA subresource_data = {};
+    subresource_data.pData = data;
+    subresource_data.RowPitch = texture_2d.GetWidth() * dx12_util::GetDXGIFormatPixelSize(texture_2d.GetFormat());
+    subresource_data.SlicePitch = subresource_data.RowPitch * texture_2d.GetHeight();
+
+    // Copy the data from the upload buffer to the texture
+    UpdateSubresources(
+        context.GetCommandList().Get(), texture_2d.Get(), upload_buffer.Get(),
+        0, 0, subresource_count, &subresource_data);
+}
+
+void DirectX12RenderBackend::SetPipeline(Pipeline& pipeline, RenderPassContext& context)
+{
+    ID3D12GraphicsCommandList* command_list = context.GetCommandList().Get();
+    pipeline.SetPipeline(command_list);
+    command_list->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void DirectX12RenderBackend::SetRootParameters(
+    Pipeline& pipeline, const PassAPI& pass_api, RenderPassContext& context)
+{
+    pipeline.SetRootParameters(context.GetCommandList().Get(), pass_api);
+}
+
+void DirectX12RenderBackend::SetDescriptorHeaps(RenderPassContext& context)
+{
+    std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
+    HeapManager::GetInstance().WithUniqueLock([&](HeapManager& heap_manager)
+    {
+        descriptor_heaps.push_back(heap_manager.GetSrvHeap().Get());
+    });
+
+    context.GetCommandList().Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+}
+
+void DirectX12RenderBackend::SetViewport(const D3D12_VIEWPORT& viewport, RenderPassContext& context)
+{
+    context.GetCommandList().Get()->RSSetViewports(1, &viewport);
+}
+
+void DirectX12RenderBackend::SetScissorRect(const D3D12_RECT& scissor_rect, RenderPassContext& context)
+{
+    context.GetCommandList().Get()->RSSetScissorRects(1, &scissor_rect);
+}
+
+void DirectX12RenderBackend::SetRenderTargets(
+    const std::vector<RenderTargetBinding>& render_targets, const RenderTargetBinding* depth_stencil,
+    RenderPassContext& context)
+{
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> rtv_handles;
+    for (const RenderTargetBinding& render_target : render_targets)
+        rtv_handles.emplace_back(GetRtvHandle(*render_target.resource));
+
+    D3D12_CPU_DESCRIPTOR_HANDLE dsv_handle = {};
+    if (depth_stencil != nullptr)
+        dsv_handle = GetDsvHandle(*depth_stencil->resource);
+
+    context.GetCommandList().Get()->OMSetRenderTargets(
+        (UINT)rtv_handles.size(), rtv_handles.empty() ? nullptr : rtv_handles.data(), FALSE,
+        (depth_stencil != nullptr) ? &dsv_handle : nullptr);
+}
+
+void DirectX12RenderBackend::ClearRenderTarget(
+    const RenderTargetBinding& render_target, const float clear_color[4], RenderPassContext& context)
+{
+    context.GetCommandList().Get()->ClearRenderTargetView(
+        GetRtvHandle(*render_target.resource), clear_color, 0, nullptr);
+}
+
+void DirectX12RenderBackend::ClearDepthStencil(
+    const RenderTargetBinding& depth_stencil, float depth, UINT8 stencil,
+    RenderPassContext& context)
+{
+    context.GetCommandList().Get()->ClearDepthStencilView(
+        GetDsvHandle(*depth_stencil.resource), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL,
+        depth, stencil, 0, nullptr);
+}
+
+void DirectX12RenderBackend::SetVertexBuffer(
+    const ResourceHandle& handle, const dx12_util::Resource& resource, UINT stride, RenderPassContext& context)
+{
+    const dx12_util::Buffer& vertex_buffer = dynamic_cast<const dx12_util::Buffer&>(resource);
+
+    D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = {};
+    vertex_buffer_view.BufferLocation = vertex_buffer.GetGPUVirtualAddress();
+    vertex_buffer_view.SizeInBytes = vertex_buffer.GetSize();
+    vertex_buffer_view.StrideInBytes = stride;
+
+    context.GetCommandList().Get()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
+}
+
+void DirectX12RenderBackend::SetIndexBuffer(
+    const ResourceHandle& handle, const dx12_util::Resource& resource, DXGI_FORMAT format,
+    RenderPassContext& context)
+{
+    const dx12_util::Buffer& index_buffer = dynamic_cast<const dx12_util::Buffer&>(resource);
+
+    D3D12_INDEX_BUFFER_VIEW index_buffer_view = {};
+    index_buffer_view.BufferLocation = index_buffer.GetGPUVirtualAddress();
+    index_buffer_view.SizeInBytes = index_buffer.GetSize();
+    index_buffer_view.Format = format;
+
+    context.GetCommandList().Get()->IASetIndexBuffer(&index_buffer_view);
+}
+
+void DirectX12RenderBackend::DrawIndexed(UINT index_count, RenderPassContext& context)
+{
+    context.GetCommandList().Get()->DrawIndexedInstanced(index_count, 1, 0, 0, 0);
+}
+
+void DirectX12RenderBackend::NewImguiFrame(RenderPassContext& context)
+{
+    ImGui_ImplDX12_NewFrame();
+    ImGui_ImplWin32_NewFrame();
+}
+
+void DirectX12RenderBackend::RenderImgui(RenderPassContext& context)
+{
+    ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), context.GetCommandList().Get());
+}
+
+} // namespace render_graph
\ No newline at end of file
@@ -3,9 +3,59 @@
 
 #include "utility_header/logger.h"
 
+#include "render_graph/include/render_backend.h"
+
 namespace render_graph
 {
 
+namespace
+{
+
+// FNV-1a parameters used to hash the signatures
+constexpr RenderPassSignature SIGNATURE_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr RenderPassSignature SIGNATURE_PRIME = 1099511628211ULL;
+
+// Mix a 64-bit value into the signature
+RenderPassSignature CombineSignature(RenderPassSignature signature, uint64_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        signature ^= (value >> (i * 8)) & 0xFF;
+        signature *= SIGNATURE_PRIME;
+    }
+    return signature;
+}
+
+// Get the resource handles of an access token in ascending order without duplicates
+std::vector<ResourceHandle> GetSortedResourceHandles(const ResourceAccessToken& token)
+{
+    std::vector<ResourceHandle> handles;
+    handles.reserve(token.GetAccessibleResourceHandles().size());
+    for (const ResourceHandle* resource_handle : token.GetAccessibleResourceHandles())
+        handles.push_back(*resource_handle);
+
+    std::sort(handles.begin(), handles.end());
+    handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+    return handles;
+}
+
+// Mix the sorted resource handles into the signature
+RenderPassSignature CombineResourceHandles(
+    RenderPassSignature signature, const std::vector<ResourceHandle>& handles)
+{
+    signature = CombineSignature(signature, handles.size());
+    for (const ResourceHandle& resource_handle : handles)
+    {
+        signature = CombineSignature(
+            signature,
+            (static_cast<uint64_t>(resource_handle.GetGeneration()) << 32) |
+            static_cast<uint64_t>(resource_handle.GetIndex()));
+    }
+    return signature;
+}
+
+} // namespace
+
 bool RenderGraph::AddPass(
     RenderPassHandleID handleID, RenderPass::SetupFunc setup, RenderPass::ExecuteFunc execute)
 {
@@ -26,6 +76,10 @@ bool RenderGraph::AddPass(
         return false;
     }
 
+    // Record the signature of the pass for Compile
+    added_pass_signatures_.push_back(
+        ComputePassSignature(handleID, newPass->GetReadToken(), newPass->GetWriteToken()));
+
     // Add the new pass to the map
     pass_map_[handleID] = std::move(newPass);
 
@@ -35,21 +89,143 @@ bool RenderGraph::AddPass(
     return true; // Successfully added
 }
 
+void RenderGraph::AddTransientResource(const ResourceHandle& resource_handle, const RenderResourceDesc& desc)
+{
+    transient_sizes_[resource_handle] = ComputeTransientResourceSize(desc);
+}
+
 bool RenderGraph::Compile()
 {
-    // Create nodes for all passes
-    std::unordered_map<RenderPassHandleID, RenderGraphNode> node_map = CreateNodes(pass_map_, added_pass_order_);
+    assert(added_pass_signatures_.size() == added_pass_order_.size() && "Pass signatures are out of sync.");
+    last_recompiled_pass_count_ = 0;
 
-    // Sort nodes topologically using Kahn's algorithm
-    sorted_passes_.clear();
-    if (!StableTopologicalSortKahn(node_map, sorted_passes_))
+    // Combine the pass signatures into the graph signature
+    RenderPassSignature graph_signature = CombineSignature(SIGNATURE_OFFSET_BASIS, added_pass_order_.size());
+    for (const RenderPassSignature& pass_signature : added_pass_signatures_)
+        graph_signature = CombineSignature(graph_signature, pass_signature);
+
+    // Check if there is a compiled result to start from
+    bool has_compiled = last_compile_result_ != RenderGraphCompileResult::None;
+
+    // Reuse the previous execution order if the graph is the same as the last compile
+    if (
+        has_compiled && graph_signature == compiled_graph_signature_ &&
+        compiled_passes_.size() == added_pass_order_.size())
+    {
+        // Compare each pass signature to guard against graph signature collisions
+        bool is_same = true;
+        for (size_t i = 0; i < added_pass_order_.size() && is_same; ++i)
+        {
+            auto it = compiled_passes_.find(added_pass_order_[i]);
+            is_same = it != compiled_passes_.end() && it->second.signature == added_pass_signatures_[i];
+        }
+
+        if (is_same)
+        {
+            sorted_passes_ = compiled_order_;
+            last_compile_result_ = RenderGraphCompileResult::Reused;
+            AllocateCompiledTransientResources();
+            return true; // Successfully compiled
+        }
+    }
+
+    // Whether the nodes or edges of the graph were changed, the passes must be sorted again if so
+    bool is_graph_changed = !has_compiled;
+
+    // Resources whose writer might have been changed, their readers must recompute their dependencies
+    std::vector<ResourceHandle> affected_resources;
+
+    // Passes whose dependencies must be recomputed
+    std::vector<RenderPassHandleID> dirty_passes;
+
+    // Remove the passes which were not added this time
+    for (auto it = compiled_passes_.begin(); it != compiled_passes_.end();)
+    {
+        if (pass_map_.find(it->first) != pass_map_.end())
+        {
+            ++it;
+            continue;
+        }
+
+        affected_resources.insert(affected_resources.end(), it->second.writes.begin(), it->second.writes.end());
+        UnregisterCompiledAccesses(it->first, it->second);
+        it = compiled_passes_.erase(it);
+        is_graph_changed = true;
+    }
+
+    // Remove the stale accesses of the passes which were added or changed
+    // All of them are removed before registering new ones so that writers can move between passes
+    std::vector<size_t> changed_pass_indices;
+    for (size_t i = 0; i < added_pass_order_.size(); ++i)
+    {
+        auto it = compiled_passes_.find(added_pass_order_[i]);
+        if (it == compiled_passes_.end())
+        {
+            changed_pass_indices.push_back(i);
+            is_graph_changed = true; // New node
+            continue;
+        }
+
+        if (it->second.signature == added_pass_signatures_[i])
+            continue; // Not changed
+
+        affected_resources.insert(affected_resources.end(), it->second.writes.begin(), it->second.writes.end());
+        UnregisterCompiledAccesses(it->first, it->second);
+        changed_pass_indices.push_back(i);
+    }
+
+    // Register the accesses of the passes which were added or changed
+    for (const size_t& index : changed_pass_indices)
+    {
+        RenderPassHandleID handleID = added_pass_order_[index];
+        RenderPass& pass = *pass_map_.at(handleID);
+
+        CompiledPass& compiled = compiled_passes_[handleID];
+        compiled.signature = added_pass_signatures_[index];
+        compiled.reads = GetSortedResourceHandles(pass.GetReadToken());
+        compiled.writes = GetSortedResourceHandles(pass.GetWriteToken());
+
+        affected_resources.insert(affected_resources.end(), compiled.writes.begin(), compiled.writes.end());
+        RegisterCompiledAccesses(handleID, compiled);
+        dirty_passes.push_back(handleID);
+    }
+
+    // Collect the readers of the affected resources
+    for (const ResourceHandle& resource_handle : affected_resources)
+    {
+        auto it = compiled_readers_.find(resource_handle);
+        if (it != compiled_readers_.end())
+            dirty_passes.insert(dirty_passes.end(), it->second.begin(), it->second.end());
+    }
+
+    std::sort(dirty_passes.begin(), dirty_passes.end());
+    dirty_passes.erase(std::unique(dirty_passes.begin(), dirty_passes.end()), dirty_passes.end());
+
+    // Recompute the dependencies of the dirty passes
+    for (const RenderPassHandleID& handleID : dirty_passes)
+    {
+        if (UpdateCompiledDependencies(handleID, compiled_passes_.at(handleID)))
+            is_graph_changed = true;
+    }
+    last_recompiled_pass_count_ = dirty_passes.size();
+
+    // The execution order only depends on the nodes and edges, keep it if they were not changed
+    if (is_graph_changed && !SortCompiledPasses())
     {
         utility_header::ConsoleLogErr(
             { "Failed to compile render graph due to cyclic dependencies." },
             __FILE__, __LINE__, __FUNCTION__);
+
+        InvalidateCompiled();
+        sorted_passes_.clear();
         return false; // Compilation failed due to cycles
     }
 
+    sorted_passes_ = compiled_order_;
+    compiled_graph_signature_ = graph_signature;
+    last_compile_result_ = has_compiled ? RenderGraphCompileResult::Incremental : RenderGraphCompileResult::Rebuilt;
+    AllocateCompiledTransientResources();
+
     return true; // Successfully compiled
 }
 
@@ -64,8 +240,9 @@ bool RenderGraph::Execute(RenderPassContext& context)
         // Get the render pass
         RenderPass& pass = *it->second;
 
-        // Execute the render pass
-        if (!pass.Execute(context))
+        // Execute the render pass through the backend of the context
+        bool result = context.GetBackend().ExecutePass(pass, context);
+        if (!result)
         {
             utility_header::ConsoleLogErr(
                 { "Failed to execute render pass with HandleID: " + std::to_string(handleID) },
@@ -78,6 +255,8 @@ bool RenderGraph::Execute(RenderPassContext& context)
     pass_map_.clear();
     sorted_passes_.clear();
     added_pass_order_.clear();
+    added_pass_signatures_.clear();
+    transient_sizes_.clear();
 
     return true; // Successfully executed the render graph
 }
@@ -86,6 +265,225 @@ void render_graph::RenderGraph::Clear()
 {
     pass_map_.clear();
     sorted_passes_.clear();
+    added_pass_order_.clear();
+    added_pass_signatures_.clear();
+    transient_sizes_.clear();
+}
+
+void RenderGraph::InvalidateCompiled()
+{
+    compiled_graph_signature_ = 0;
+    compiled_passes_.clear();
+    compiled_writers_.clear();
+    compiled_readers_.clear();
+    compiled_order_.clear();
+    last_compile_result_ = RenderGraphCompileResult::None;
+
+    transient_signature_ = 0;
+    transient_allocations_.clear();
+    transient_memory_stats_ = TransientMemoryStats();
+}
+
+void RenderGraph::UnregisterCompiledAccesses(RenderPassHandleID handleID, const CompiledPass& compiled)
+{
+    // Unregister writers
+    for (const ResourceHandle& resource_handle : compiled.writes)
+    {
+        auto it = compiled_writers_.find(resource_handle);
+        assert(it != compiled_writers_.end() && it->second == handleID && "Compiled writer is out of sync.");
+        compiled_writers_.erase(it);
+    }
+
+    // Unregister readers
+    for (const ResourceHandle& resource_handle : compiled.reads)
+    {
+        auto it = compiled_readers_.find(resource_handle);
+        assert(it != compiled_readers_.end() && "Compiled reader is out of sync.");
+
+        std::vector<RenderPassHandleID>& readers = it->second;
+        readers.erase(std::remove(readers.begin(), readers.end(), handleID), readers.end());
+        if (readers.empty())
+            compiled_readers_.erase(it);
+    }
+}
+
+void RenderGraph::RegisterCompiledAccesses(RenderPassHandleID handleID, const CompiledPass& compiled)
+{
+    // Register writers
+    for (const ResourceHandle& resource_handle : compiled.writes)
+    {
+        assert(
+            compiled_writers_.find(resource_handle) == compiled_writers_.end() &&
+            "Multiple writers for the same resource detected.");
+
+        compiled_writers_[resource_handle] = handleID;
+    }
+
+    // Register readers
+    for (const ResourceHandle& resource_handle : compiled.reads)
+        compiled_readers_[resource_handle].push_back(handleID);
+}
+
+bool RenderGraph::UpdateCompiledDependencies(RenderPassHandleID handleID, CompiledPass& compiled)
+{
+    // Reader depends on the writer of each resource it reads
+    std::vector<RenderPassHandleID> dependencies;
+    for (const ResourceHandle& resource_handle : compiled.reads)
+    {
+        auto it = compiled_writers_.find(resource_handle);
+        if (it == compiled_writers_.end())
+            continue; // No writer for this resource
+
+        assert(it->second != handleID && "Writer cannot be a reader of the same resource.");
+        dependencies.push_back(it->second);
+    }
+
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+    if (dependencies == compiled.dependencies)
+        return false; // Not changed
+
+    compiled.dependencies = std::move(dependencies);
+    return true;
+}
+
+bool RenderGraph::SortCompiledPasses()
+{
+    // Give dense indices in ascending handle ID order
+    // The smallest index is taken first among ready passes, which is the same as StableTopologicalSortKahn
+    std::vector<RenderPassHandleID> ids;
+    ids.reserve(compiled_passes_.size());
+    for (const auto& [handleID, compiled] : compiled_passes_)
+        ids.push_back(handleID);
+    std::sort(ids.begin(), ids.end());
+
+    std::unordered_map<RenderPassHandleID, size_t> indices;
+    indices.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        indices[ids[i]] = i;
+
+    // Build in-degrees and reverse edges in CSR layout
+    std::vector<size_t> in_degrees(ids.size(), 0);
+    std::vector<size_t> edge_offsets(ids.size() + 1, 0);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        for (const RenderPassHandleID& dependency : compiled_passes_.at(ids[i]).dependencies)
+        {
+            in_degrees[i]++;
+            edge_offsets[indices.at(dependency) + 1]++;
+        }
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i)
+        edge_offsets[i + 1] += edge_offsets[i];
+
+    std::vector<size_t> edges(edge_offsets.back());
+    std::vector<size_t> edge_cursors(edge_offsets.begin(), edge_offsets.end() - 1);
+    for (size_t i = 0; i < ids.size(); ++i)
+        for (const RenderPassHandleID& dependency : compiled_passes_.at(ids[i]).dependencies)
+            edges[edge_cursors[indices.at(dependency)]++] = i;
+
+    // Initialize zero in-degree queue
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> zero_in_degree;
+    for (size_t i = 0; i < ids.size(); ++i)
+        if (in_degrees[i] == 0) zero_in_degree.push(i);
+
+    compiled_order_.clear();
+    compiled_order_.reserve(ids.size());
+    while (!zero_in_degree.empty())
+    {
+        size_t index = zero_in_degree.top();
+        zero_in_degree.pop();
+        compiled_order_.push_back(ids[index]);
+
+        // Decrease in-degrees of neighbors
+        for (size_t edge = edge_offsets[index]; edge < edge_offsets[index + 1]; ++edge)
+            if (--in_degrees[edges[edge]] == 0)
+                zero_in_degree.push(edges[edge]);
+    }
+
+    // Check for cycles
+    if (compiled_order_.size() != ids.size())
+    {
+        utility_header::ConsoleLogErr(
+            { "Cycle detected in render graph during stable topological sort." },
+            __FILE__, __LINE__, __FUNCTION__);
+
+        compiled_order_.clear();
+        return false;
+    }
+    return true;
+}
+
+void RenderGraph::AllocateCompiledTransientResources()
+{
+    // Combine the sorted transient declarations into the signature
+    std::vector<std::pair<ResourceHandle, uint64_t>> transients(transient_sizes_.begin(), transient_sizes_.end());
+    std::sort(transients.begin(), transients.end());
+
+    RenderPassSignature signature = CombineSignature(SIGNATURE_OFFSET_BASIS, transients.size());
+    for (const auto& [resource_handle, size] : transients)
+    {
+        signature = CombineSignature(
+            signature,
+            (static_cast<uint64_t>(resource_handle.GetGeneration()) << 32) |
+            static_cast<uint64_t>(resource_handle.GetIndex()));
+        signature = CombineSignature(signature, size);
+    }
+
+    // The lifetimes only depend on the execution order and the declarations, keep them if both are the same
+    if (last_compile_result_ == RenderGraphCompileResult::Reused && signature == transient_signature_)
+        return;
+
+    transient_signature_ = signature;
+
+    // Find the first and last passes accessing each transient resource in the execution order
+    std::unordered_map<ResourceHandle, TransientResourceLifetime> lifetime_map;
+    for (size_t pass_index = 0; pass_index < compiled_order_.size(); ++pass_index)
+    {
+        const CompiledPass& compiled = compiled_passes_.at(compiled_order_[pass_index]);
+        for (const std::vector<ResourceHandle>* accesses : { &compiled.reads, &compiled.writes })
+        {
+            for (const ResourceHandle& resource_handle : *accesses)
+            {
+                auto size_it = transient_sizes_.find(resource_handle);
+                if (size_it == transient_sizes_.end())
+                    continue; // Not a transient resource
+
+                auto [it, inserted] = lifetime_map.try_emplace(resource_handle);
+                TransientResourceLifetime& lifetime = it->second;
+                if (inserted)
+                {
+                    lifetime.handle = resource_handle;
+                    lifetime.size = size_it->second;
+                    lifetime.first_pass_index = pass_index;
+                }
+                lifetime.last_pass_index = pass_index;
+            }
+        }
+    }
+
+    // Allocate in ascending handle order so that the result does not depend on the hash map
+    std::vector<TransientResourceLifetime> lifetimes;
+    lifetimes.reserve(lifetime_map.size());
+    for (const auto& [resource_handle, size] : transients)
+    {
+        auto it = lifetime_map.find(resource_handle);
+        if (it != lifetime_map.end())
+            lifetimes.push_back(it->second);
+    }
+
+    AllocateTransientResources(lifetimes, transient_allocations_, transient_memory_stats_);
+}
+
+RENDER_GRAPH_DLL RenderPassSignature ComputePassSignature(
+    RenderPassHandleID handleID, const ResourceAccessToken& read_token, const ResourceAccessToken& write_token)
+{
+    RenderPassSignature signature = CombineSignature(SIGNATURE_OFFSET_BASIS, handleID);
+    signature = CombineResourceHandles(signature, GetSortedResourceHandles(read_token));
+    signature = CombineResourceHandles(signature, GetSortedResourceHandles(write_token));
+    return signature;
 }
 
 RENDER_GRAPH_DLL std::unordered_map<RenderPassHandleID, RenderGraphNode> CreateNodes(
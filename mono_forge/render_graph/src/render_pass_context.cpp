@@ -4,8 +4,14 @@
 namespace render_graph
 {
 
-RenderPassContext::RenderPassContext(dx12_util::CommandList& command_list) :
-    command_list_(command_list)
+RenderPassContext::RenderPassContext(RenderBackend& backend, dx12_util::CommandList& command_list) :
+    backend_(backend),
+    command_list_(&command_list)
+{
+}
+
+RenderPassContext::RenderPassContext(RenderBackend& backend) :
+    backend_(backend)
 {
 }
 
@@ -13,9 +19,15 @@ RenderPassContext::~RenderPassContext()
 {
 }
 
+RenderBackend& RenderPassContext::GetBackend()
+{
+    return backend_;
+}
+
 dx12_util::CommandList& RenderPassContext::GetCommandList()
 {
-    return command_list_;
+    assert(command_list_ != nullptr && "Context has no command list.");
+    return *command_list_;
 }
 
 } // namespace render_graph
\ No newline at end of file
@@ -1,6 +1,8 @@
 ﻿#include "render_graph/src/pch.h"
 #include "render_graph/include/resource_manager.h"
 
+#include "render_graph/include/render_backend.h"
+
 namespace render_graph
 {
 
@@ -46,19 +48,38 @@ ResourceHandle ResourceAdder::AddResource(std::unique_ptr<dx12_util::Resource> r
     ResourceHandle handle;
     container_.WithUniqueLock([&](ResourceContainer& container) 
     {
+        // Keep the resource reference to notify the backend
+        dx12_util::Resource& added_resource = *resource;
+
         // Add the resource and get its handle
         handle = container.Add(std::move(resource));
+
+        // Notify the backend in the lock, so it sees the resources in the same order as the container
+        backend_.OnResourceAdded(handle, added_resource);
     });
 
     return handle;
 }
 
+ResourceHandle ResourceAdder::CreateResource(const RenderResourceDesc& desc)
+{
+    // Create the resource through the backend
+    std::unique_ptr<dx12_util::Resource> resource = backend_.CreateResource(desc);
+    if (!resource)
+        return ResourceHandle(); // Failure
+
+    return AddResource(std::move(resource));
+}
+
 void ResourceEraser::EraseResource(const ResourceHandle* handle)
 {
     assert(handle != nullptr && "ResourceHandle pointer is null.");
 
     container_.WithUniqueLock([&](ResourceContainer& container) 
     {
+        // Notify the backend before the resource is released
+        backend_.OnResourceErased(*handle);
+
         container.Erase(*handle);
     });
 }
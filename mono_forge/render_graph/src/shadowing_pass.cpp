@@ -3,7 +3,7 @@
 
 #include "render_graph/include/light_manager.h"
 #include "render_graph/include/resource_manager.h"
-#include "render_graph/include/heap_manager.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph
 {
@@ -85,21 +85,11 @@ bool ShadowingPass::AddToGraph(RenderGraph &render_graph)
             const ResourceAccessToken& read_token = self_pass.GetReadToken();
             current_read_token_ = read_token;
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
-
-            // Set primitive topology
-            command_list.Get()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-            // Create descriptor heaps vector
-            std::vector<ID3D12DescriptorHeap*> descriptor_heaps;
-            HeapManager::GetInstance().WithUniqueLock([&](HeapManager& heap_manager) 
-            {
-                descriptor_heaps.push_back(heap_manager.GetSrvHeap().Get());
-            });
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Set descriptor heaps
-            command_list.Get()->SetDescriptorHeaps(descriptor_heaps.size(), descriptor_heaps.data());
+            backend.SetDescriptorHeaps(context);
 
             for (int i = 0; i < render_light_handles_.size(); ++i)
             {
@@ -127,125 +117,92 @@ bool ShadowingPass::AddToGraph(RenderGraph &render_graph)
                     scissor_rect = light.GetScissorRect();
                 });
 
-                D3D12_CPU_DESCRIPTOR_HANDLE dsv_handle = D3D12_CPU_DESCRIPTOR_HANDLE();
+                RenderTargetBinding shadow_map;
                 ResourceManager::GetInstance().WithLock([&](ResourceManager& resource_manager) 
                 {
                     // Get shadow map texture
-                    dx12_util::Resource& shadow_map_texture_resource
-                        = resource_manager.GetWriteResource(shadow_map_handle, write_token); 
-                    dx12_util::Texture2D* shadow_map_texture 
-                        = dynamic_cast<dx12_util::Texture2D*>(&shadow_map_texture_resource);
-                    assert(shadow_map_texture != nullptr && "Failed to get shadow map texture.");
+                    shadow_map.handle = shadow_map_handle;
+                    shadow_map.resource = &resource_manager.GetWriteResource(shadow_map_handle, write_token);
 
                     // Set before to depth write state barrier
-                    if (shadow_map_texture->GetCurrentState() != D3D12_RESOURCE_STATE_DEPTH_WRITE)
-                    {
-                        dx12_util::Barrier to_depth_write_barrier(
-                            shadow_map_texture->Get(), command_list.Get(),
-                            shadow_map_texture->GetCurrentState(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
-
-                        // Set current state to depth write
-                        shadow_map_texture->SetCurrentState(D3D12_RESOURCE_STATE_DEPTH_WRITE);
-                    }
-
-                    // Get DSV handle
-                    dsv_handle = shadow_map_texture->GetDsvCpuHandle();
+                    backend.TransitionResource(
+                        *shadow_map.handle, *shadow_map.resource, D3D12_RESOURCE_STATE_DEPTH_WRITE, context);
                 });
 
                 // Set viewport and scissor rect
-                command_list.Get()->RSSetViewports(1, &viewport);
-                command_list.Get()->RSSetScissorRects(1, &scissor_rect);
+                backend.SetViewport(viewport, context);
+                backend.SetScissorRect(scissor_rect, context);
 
                 // Set pipeline
-                shadowing_pipeline_->SetPipeline(command_list.Get());
+                backend.SetPipeline(*shadowing_pipeline_, context);
 
                 // Set render targets
-                command_list.Get()->OMSetRenderTargets(0, nullptr, FALSE, &dsv_handle);
+                backend.SetRenderTargets({}, &shadow_map, context);
 
                 // Clear depth stencil
-                command_list.Get()->ClearDepthStencilView(
-                    dsv_handle, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 
-                    shadowing_pass::SHADOW_MAP_CLEAR_VALUE, shadowing_pass::SHADOW_MAP_STENCIL_CLEAR_VALUE, 0, &scissor_rect);
+                backend.ClearDepthStencil(
+                    shadow_map, shadowing_pass::SHADOW_MAP_CLEAR_VALUE, shadowing_pass::SHADOW_MAP_STENCIL_CLEAR_VALUE,
+                    context);
 
                 // Render each mesh buffer
                 for (const MeshInfo& mesh_info : mesh_infos_)
                 {
+                    if (mesh_info.light_handle != nullptr && mesh_info.light_handle != light_handle)
+                        continue; // The mesh is culled for this light
+
                     ResourceManager::GetInstance().WithLock([&](ResourceManager& resource_manager) 
                     {
                         // Set drawing world matrix buffer handle
                         drawing_world_matrix_buffer_handle_ = mesh_info.world_matrix_buffer_handle;
 
                         // Set root parameters
-                        shadowing_pipeline_->SetRootParameters(command_list.Get(), GetPassAPI());
-
-                        // Get vertex buffer
-                        const dx12_util::Resource& vertex_buffer_resource
-                            = resource_manager.GetReadResource(mesh_info.vertex_buffer_handle, read_token);
-                        const dx12_util::Buffer* vertex_buffer = dynamic_cast<const dx12_util::Buffer*>(&vertex_buffer_resource);
-                        assert(vertex_buffer != nullptr && "Failed to get vertex buffer.");
-
-                        // Create vertex buffer view
-                        D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view = {};
-                        vertex_buffer_view.BufferLocation = vertex_buffer->GetGPUVirtualAddress();
-                        vertex_buffer_view.SizeInBytes = vertex_buffer->GetSize();
-                        vertex_buffer_view.StrideInBytes = sizeof(shadowing_pass::Vertex);
-
-                        // Set vertex buffer view
-                        command_list.Get()->IASetVertexBuffers(0, 1, &vertex_buffer_view);
-
-                        // Get index buffer
-                        const dx12_util::Resource& index_buffer_resource
-                            = resource_manager.GetReadResource(mesh_info.index_buffer_handle, read_token);
-                        const dx12_util::Buffer& index_buffer 
-                            = dynamic_cast<const dx12_util::Buffer&>(index_buffer_resource);
-
-                        // Create index buffer view
-                        D3D12_INDEX_BUFFER_VIEW index_buffer_view = {};
-                        index_buffer_view.BufferLocation = index_buffer.GetGPUVirtualAddress();
-                        index_buffer_view.SizeInBytes = index_buffer.GetSize();
-                        index_buffer_view.Format = shadowing_pass::INDEX_BUFFER_FORMAT;
-
-                        // Set index buffer view
-                        command_list.Get()->IASetIndexBuffer(&index_buffer_view);
+                        backend.SetRootParameters(*shadowing_pipeline_, GetPassAPI(), context);
+
+                        // Set vertex buffer
+                        backend.SetVertexBuffer(
+                            *mesh_info.vertex_buffer_handle,
+                            resource_manager.GetReadResource(mesh_info.vertex_buffer_handle, read_token),
+                            sizeof(shadowing_pass::Vertex), context);
+
+                        // Set index buffer
+                        backend.SetIndexBuffer(
+                            *mesh_info.index_buffer_handle,
+                            resource_manager.GetReadResource(mesh_info.index_buffer_handle, read_token),
+                            shadowing_pass::INDEX_BUFFER_FORMAT, context);
 
                         // Draw call
-                        command_list.Get()->DrawIndexedInstanced(mesh_info.index_count, 1, 0, 0, 0);
+                        backend.DrawIndexed(mesh_info.index_count, context);
                     });
                 }
 
                 ResourceManager::GetInstance().WithLock([&](ResourceManager& resource_manager) 
                 {
-                    // Get shadow map texture
-                    dx12_util::Resource& shadow_map_texture_resource
-                        = resource_manager.GetWriteResource(shadow_map_handle, write_token);
-                    dx12_util::Texture2D* shadow_map_texture 
-                        = dynamic_cast<dx12_util::Texture2D*>(&shadow_map_texture_resource);
-                    assert(shadow_map_texture != nullptr && "Failed to get shadow map texture.");
-
                     // Set shadow map to pixel shader resource state barrier
-                    dx12_util::Barrier depth_to_pr_barrier(
-                        shadow_map_texture->Get(), command_list.Get(),
-                        D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-                    // Set current state to pixel shader resource
-                    shadow_map_texture->SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                    backend.TransitionResource(
+                        *shadow_map.handle, *shadow_map.resource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
                 });
             }
 
-            // Clear handles after rendering
-            render_light_handles_.clear();
-            drawing_light_view_matrix_buffer_handle_ = nullptr;
-            drawing_light_proj_matrix_buffer_handle_ = nullptr;
-            drawing_world_matrix_buffer_handle_ = nullptr;
-
-            // Clear mesh infos after rendering
-            mesh_infos_.clear();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void ShadowingPass::ResetFrameData()
+{
+    // Clear handles after rendering
+    render_light_handles_.clear();
+    drawing_light_view_matrix_buffer_handle_ = nullptr;
+    drawing_light_proj_matrix_buffer_handle_ = nullptr;
+    drawing_world_matrix_buffer_handle_ = nullptr;
+
+    // Clear mesh infos after rendering
+    mesh_infos_.clear();
+}
+
 void ShadowingPass::AddShadowCasterMeshInfo(MeshInfo&& mesh_buffer_info)
 {
     mesh_infos_.emplace_back(std::move(mesh_buffer_info));
@@ -1,8 +1,7 @@
 #include "render_graph/src/pch.h"
 #include "render_graph/include/texture_upload_pass.h"
 
-#include "directx12_util/include/helper.h"
-#include "directx12_util/include/d3dx12.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph
 {
@@ -51,8 +50,8 @@ bool TextureUploadPass::AddToGraph(RenderGraph &render_graph)
             // Get write access token
             const ResourceAccessToken& write_token = self_pass.GetWriteToken();
 
-            // Get command list
-            dx12_util::CommandList& command_list = context.GetCommandList();
+            // Get backend to record commands
+            RenderBackend& backend = context.GetBackend();
 
             // Iterate through each upload task
             for (const UploadTask& task : tasks_)
@@ -64,52 +63,39 @@ bool TextureUploadPass::AddToGraph(RenderGraph &render_graph)
                     dx12_util::Resource& upload_resource 
                         = manager.GetWriteResource(task.upload_buffer_handle, write_token);
 
-                    // Cast to dx12_util::Buffer
-                    dx12_util::Buffer* upload_buffer = dynamic_cast<dx12_util::Buffer*>(&upload_resource);
-                    assert(upload_buffer != nullptr); // Ensure the cast succeeded
-
                     // Get the texture resource for writing
                     dx12_util::Resource& texture_resource 
                         = manager.GetWriteResource(task.texture_handle, write_token);
 
-                    // Cast to dx12_util::Texture2D
-                    dx12_util::Texture2D* texture = dynamic_cast<dx12_util::Texture2D*>(&texture_resource);
-                    assert(texture != nullptr); // Ensure the cast succeeded
-
-                    // Create a subresource data structure to update the subresource data of a texture
-                    const UINT subresourceCount = 1;
-                    D3D12_SUBRESOURCE_DATA subresourceData = {};
-                    subresourceData.pData = task.data;
-                    subresourceData.RowPitch = texture->GetWidth() * dx12_util::GetDXGIFormatPixelSize(texture->GetFormat());
-                    subresourceData.SlicePitch = subresourceData.RowPitch * texture->GetHeight();
-
-                    // Create barrier to transition texture to COPY_DEST state
-                    dx12_util::Barrier to_copy_dest_barrier(
-                        texture->Get(), command_list.Get(),
-                        texture->GetCurrentState(), D3D12_RESOURCE_STATE_COPY_DEST);
-                    texture->SetCurrentState(D3D12_RESOURCE_STATE_COPY_DEST);
-                    
-                    // Use UpdateSubresources to copy data from the upload buffer to the texture
-                    UpdateSubresources(
-                        command_list.Get(), texture->Get(), upload_buffer->Get(),
-                        0, 0, subresourceCount, &subresourceData);
-
-                    // Create barrier to transition texture back to PIXEL_SHADER_RESOURCE state
-                    dx12_util::Barrier to_pixel_shader_resource_barrier(
-                        texture->Get(), command_list.Get(),
-                        texture->GetCurrentState(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-                    texture->SetCurrentState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                    // Transition texture to COPY_DEST state
+                    backend.TransitionResource(
+                        *task.texture_handle, texture_resource, D3D12_RESOURCE_STATE_COPY_DEST, context);
+
+                    // Copy data from the upload buffer to the texture
+                    backend.UploadTexture(
+                        *task.texture_handle, texture_resource, *task.upload_buffer_handle, upload_resource,
+                        task.data, context);
+
+                    // Transition texture back to PIXEL_SHADER_RESOURCE state
+                    backend.TransitionResource(
+                        *task.texture_handle, texture_resource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, context);
                 });
             }
 
-            // Clear tasks after execution
-            tasks_.clear();
+            // Reset the frame data for the next frame
+            ResetFrameData();
 
             return true; // Execution successful
         }
     );
 }
 
+void TextureUploadPass::ResetFrameData()
+{
+    // Clear tasks after execution
+    tasks_.clear();
+}
+
 bool TextureUploadPass::AddUploadTask(UploadTask&& task)
 {
     assert(IsSetup() && "Instance is not setup");
@@ -0,0 +1,153 @@
+﻿#include "render_graph/src/pch.h"
+#include "render_graph/include/transient_resource.h"
+
+#include "directx12_util/include/helper.h"
+
+namespace render_graph
+{
+
+namespace
+{
+
+// Round the size up to the alignment
+uint64_t AlignSize(uint64_t size, uint64_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// Check if the lifetimes share any pass
+bool IsOverlapped(const TransientResourceLifetime& a, const TransientResourceLifetime& b)
+{
+    return a.first_pass_index <= b.last_pass_index && b.first_pass_index <= a.last_pass_index;
+}
+
+// A memory slot shared by resources with disjoint lifetimes
+struct MemorySlot
+{
+    uint64_t size = 0;
+    std::vector<const TransientResourceLifetime*> lifetimes;
+};
+
+} // namespace
+
+uint64_t ComputeTransientResourceSize(const RenderResourceDesc& desc)
+{
+    uint64_t size = 0;
+    if (desc.type == RenderResourceType::Buffer)
+        size = desc.size;
+    else
+        size = static_cast<uint64_t>(desc.width) * desc.height * dx12_util::GetDXGIFormatPixelSize(desc.format);
+
+    return AlignSize(size, TRANSIENT_RESOURCE_ALIGNMENT);
+}
+
+void AllocateTransientResources(
+    const std::vector<TransientResourceLifetime>& lifetimes,
+    std::vector<TransientResourceAllocation>& allocations, TransientMemoryStats& stats)
+{
+    allocations.clear();
+    allocations.resize(lifetimes.size());
+    stats = TransientMemoryStats();
+    stats.resource_count = lifetimes.size();
+
+    // Place the largest resources first, so that smaller ones fill the slots around them
+    std::vector<size_t> order(lifetimes.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        if (lifetimes[a].size != lifetimes[b].size)
+            return lifetimes[a].size > lifetimes[b].size;
+        if (lifetimes[a].first_pass_index != lifetimes[b].first_pass_index)
+            return lifetimes[a].first_pass_index < lifetimes[b].first_pass_index;
+        return lifetimes[a].handle < lifetimes[b].handle;
+    });
+
+    std::vector<MemorySlot> slots;
+    std::vector<uint32_t> assigned_slots(lifetimes.size(), 0);
+    for (const size_t& index : order)
+    {
+        const TransientResourceLifetime& lifetime = lifetimes[index];
+        stats.unaliased_bytes += lifetime.size;
+
+        // Find the smallest free slot which fits, and the largest free slot to grow otherwise
+        size_t best_fit = slots.size();
+        size_t largest = slots.size();
+        for (size_t slot_index = 0; slot_index < slots.size(); ++slot_index)
+        {
+            const MemorySlot& slot = slots[slot_index];
+
+            bool is_free = true;
+            for (const TransientResourceLifetime* other : slot.lifetimes)
+            {
+                if (IsOverlapped(lifetime, *other))
+                {
+                    is_free = false;
+                    break;
+                }
+            }
+
+            if (!is_free)
+                continue;
+
+            if (slot.size >= lifetime.size)
+            {
+                if (best_fit == slots.size() || slot.size < slots[best_fit].size)
+                    best_fit = slot_index;
+            }
+            else if (largest == slots.size() || slot.size > slots[largest].size)
+            {
+                largest = slot_index;
+            }
+        }
+
+        size_t slot_index = (best_fit != slots.size()) ? best_fit : largest;
+        if (slot_index == slots.size())
+            slots.emplace_back(); // No free slot, create a new one
+
+        MemorySlot& slot = slots[slot_index];
+        slot.size = std::max(slot.size, lifetime.size);
+        slot.lifetimes.push_back(&lifetime);
+        assigned_slots[index] = static_cast<uint32_t>(slot_index);
+    }
+
+    // Place the slots one after another in the heap
+    std::vector<uint64_t> slot_offsets(slots.size(), 0);
+    for (size_t slot_index = 0; slot_index < slots.size(); ++slot_index)
+    {
+        slot_offsets[slot_index] = stats.aliased_bytes;
+        stats.aliased_bytes += slots[slot_index].size;
+    }
+    stats.slot_count = slots.size();
+
+    for (size_t i = 0; i < lifetimes.size(); ++i)
+    {
+        TransientResourceAllocation& allocation = allocations[i];
+        allocation.handle = lifetimes[i].handle;
+        allocation.size = lifetimes[i].size;
+        allocation.first_pass_index = lifetimes[i].first_pass_index;
+        allocation.last_pass_index = lifetimes[i].last_pass_index;
+        allocation.slot = assigned_slots[i];
+        allocation.heap_offset = slot_offsets[assigned_slots[i]];
+    }
+
+    // Sweep the pass indices to find the peak of the live resources
+    std::vector<std::pair<size_t, int64_t>> events;
+    events.reserve(lifetimes.size() * 2);
+    for (const TransientResourceLifetime& lifetime : lifetimes)
+    {
+        events.emplace_back(lifetime.first_pass_index * 2, static_cast<int64_t>(lifetime.size));
+        events.emplace_back(lifetime.last_pass_index * 2 + 1, -static_cast<int64_t>(lifetime.size));
+    }
+    std::sort(events.begin(), events.end());
+
+    int64_t live_bytes = 0;
+    for (const std::pair<size_t, int64_t>& event : events)
+    {
+        live_bytes += event.second;
+        stats.peak_live_bytes = std::max(stats.peak_live_bytes, static_cast<uint64_t>(live_bytes));
+    }
+}
+
+} // namespace render_graph
\ No newline at end of file
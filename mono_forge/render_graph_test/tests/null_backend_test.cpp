@@ -0,0 +1,709 @@
+﻿#include "render_graph_test/pch.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "render_graph/include/render_graph.h"
+#include "render_graph/include/resource_manager.h"
+#include "render_graph/include/render_pass_context.h"
+#include "render_graph/include/material_manager.h"
+#include "render_graph/include/null_render_backend.h"
+
+#include "render_graph/include/geometry_pass.h"
+#include "render_graph/include/shadow_composition_pass.h"
+#include "render_graph/include/lighting_pass.h"
+#include "render_graph/include/composition_pass.h"
+#include "render_graph/include/light.h"
+
+namespace null_backend_test
+{
+
+constexpr UINT WIDTH = 1280;
+constexpr UINT HEIGHT = 720;
+constexpr UINT FRAME_COUNT = 2;
+constexpr uint32_t LIGHT_MAX_COUNT = 16;
+constexpr uint32_t FULL_SCREEN_TRIANGLE_VERTEX_COUNT = 3;
+
+// The pipeline which creates nothing, as the null backend records the commands instead of issuing them
+class NullPipeline :
+    public render_graph::Pipeline
+{
+public:
+    NullPipeline() = default;
+    ~NullPipeline() override = default;
+
+    bool Setup() override { return true; }
+    void SetRootParameters(
+        ID3D12GraphicsCommandList* command_list, const render_graph::PassAPI& pass_api) override {}
+};
+
+class TestMaterialTypeHandle :
+    public render_graph::MaterialTypeHandle<TestMaterialTypeHandle> {};
+
+// The material which only reads its buffer
+class TestMaterial :
+    public render_graph::Material
+{
+public:
+    TestMaterial(const render_graph::ResourceHandle& buffer_handle) : buffer_handle_(buffer_handle) {}
+    ~TestMaterial() override = default;
+
+    bool Setup(SetupParam& param) override { return true; }
+    bool Apply(const SetupParam& param) override { return true; }
+    const render_graph::ResourceHandle* GetBufferHandle() const override { return &buffer_handle_; }
+    render_graph::MaterialTypeHandleID GetMaterialTypeHandleID() const override { return TestMaterialTypeHandle::ID(); }
+
+    void DeclareResources(render_graph::RenderPassBuilder& builder) const override
+    {
+        builder.Read(&buffer_handle_);
+    }
+
+    const void* GetBufferData(uint32_t& size) const override
+    {
+        size = 0;
+        return nullptr;
+    }
+
+private:
+    const render_graph::ResourceHandle buffer_handle_;
+};
+
+// The resources and passes of the deferred frame in render_test, created on the null backend
+struct DeferredScene
+{
+    std::unique_ptr<render_graph::RenderPassIDGenerator> render_pass_id_generator;
+    std::unique_ptr<render_graph::MaterialTypeHandleIDGenerator> material_type_handle_id_generator;
+
+    // The backend is created first, so it is notified of all resources
+    std::unique_ptr<render_graph::NullRenderBackend> backend;
+
+    std::unique_ptr<render_graph::ResourceContainer> resource_container;
+    std::unique_ptr<render_graph::ResourceManager> resource_manager;
+    std::unique_ptr<render_graph::ResourceAdder> resource_adder;
+    std::unique_ptr<render_graph::ResourceEraser> resource_eraser;
+
+    std::unique_ptr<render_graph::MaterialContainer> material_container;
+    std::unique_ptr<render_graph::MaterialManager> material_manager;
+    std::unique_ptr<render_graph::MaterialAdder> material_adder;
+
+    render_graph::ResourceHandles gbuffer_render_target_handles[FRAME_COUNT];
+    render_graph::ResourceHandle gbuffer_depth_stencil_handles[FRAME_COUNT];
+    render_graph::ResourceHandles shadow_composition_render_target_handles[FRAME_COUNT];
+    render_graph::ResourceHandles final_color_texture_handles[FRAME_COUNT];
+    render_graph::ResourceHandle imgui_render_target_handles[FRAME_COUNT];
+    render_graph::ResourceHandle lights_buffer_handles[FRAME_COUNT];
+    render_graph::ResourceHandle swap_chain_handle;
+
+    render_graph::ResourceHandle full_screen_triangle_vertex_buffer_handle;
+    render_graph::ResourceHandle full_screen_triangle_index_buffer_handle;
+    render_graph::ResourceHandle view_proj_matrix_buffer_handle;
+    render_graph::ResourceHandle inv_view_proj_matrix_buffer_handle;
+    render_graph::ResourceHandle light_config_buffer_handle;
+    render_graph::ResourceHandle shadow_composition_config_buffer_handle;
+
+    render_graph::ResourceHandle mesh_vertex_buffer_handle;
+    render_graph::ResourceHandle mesh_index_buffer_handle;
+    render_graph::ResourceHandle world_buffer_handle;
+    render_graph::ResourceHandle material_buffer_handle;
+    render_graph::MaterialHandle material_handle;
+
+    std::unique_ptr<render_graph::GeometryPass> geometry_pass;
+    std::unique_ptr<render_graph::ShadowCompositionPass> shadow_composition_pass;
+    std::unique_ptr<render_graph::LightingPass> lighting_pass;
+    std::unique_ptr<render_graph::CompositionPass> composition_pass;
+
+    D3D12_VIEWPORT view_port = {};
+    D3D12_RECT scissor_rect = {};
+};
+
+render_graph::RenderResourceDesc BufferDesc(uint32_t size, std::wstring debug_name)
+{
+    render_graph::RenderResourceDesc desc;
+    desc.type = render_graph::RenderResourceType::Buffer;
+    desc.size = size;
+    desc.heap_type = D3D12_HEAP_TYPE_UPLOAD;
+    desc.initial_state = D3D12_RESOURCE_STATE_GENERIC_READ;
+    desc.debug_name = debug_name;
+    return desc;
+}
+
+render_graph::RenderResourceDesc RenderTargetDesc(DXGI_FORMAT format, const float clear_color[4], std::wstring debug_name)
+{
+    render_graph::RenderResourceDesc desc;
+    desc.type = render_graph::RenderResourceType::Texture2D;
+    desc.width = WIDTH;
+    desc.height = HEIGHT;
+    desc.format = format;
+    desc.heap_type = D3D12_HEAP_TYPE_DEFAULT;
+    desc.flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+    desc.initial_state = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    desc.has_clear_value = true;
+    desc.clear_value.Format = format;
+    for (int i = 0; i < 4; ++i)
+        desc.clear_value.Color[i] = clear_color[i];
+    desc.debug_name = debug_name;
+    return desc;
+}
+
+// Create the resources, materials and passes of the scene
+void CreateDeferredScene(DeferredScene& scene)
+{
+    scene.render_pass_id_generator = std::make_unique<render_graph::RenderPassIDGenerator>();
+    scene.material_type_handle_id_generator = std::make_unique<render_graph::MaterialTypeHandleIDGenerator>();
+
+    scene.backend = std::make_unique<render_graph::NullRenderBackend>();
+
+    scene.resource_container = std::make_unique<render_graph::ResourceContainer>();
+    scene.resource_manager = std::make_unique<render_graph::ResourceManager>(*scene.resource_container);
+    scene.resource_adder = std::make_unique<render_graph::ResourceAdder>(*scene.resource_container, *scene.backend);
+    scene.resource_eraser = std::make_unique<render_graph::ResourceEraser>(*scene.resource_container, *scene.backend);
+
+    scene.material_container = std::make_unique<render_graph::MaterialContainer>();
+    scene.material_manager = std::make_unique<render_graph::MaterialManager>(*scene.material_container);
+    scene.material_adder = std::make_unique<render_graph::MaterialAdder>(*scene.material_container);
+
+    render_graph::ResourceAdder& adder = *scene.resource_adder;
+    for (UINT frame_index = 0; frame_index < FRAME_COUNT; ++frame_index)
+    {
+        // G-buffers
+        for (UINT i = 0; i < (UINT)render_graph::geometry_pass::GBufferIndex::COUNT; ++i)
+        {
+            scene.gbuffer_render_target_handles[frame_index].emplace_back(adder.CreateResource(RenderTargetDesc(
+                render_graph::geometry_pass::GBUFFER_FORMATS[i],
+                render_graph::geometry_pass::GBUFFER_CLEAR_COLORS[i], L"GBuffer")));
+        }
+
+        // Depth stencil
+        render_graph::RenderResourceDesc depth_desc;
+        depth_desc.type = render_graph::RenderResourceType::Texture2D;
+        depth_desc.width = WIDTH;
+        depth_desc.height = HEIGHT;
+        depth_desc.format = render_graph::geometry_pass::DEPTH_STENCIL_FORMAT;
+        depth_desc.srv_format = render_graph::geometry_pass::DEPTH_STENCIL_SRV_FORMAT;
+        depth_desc.heap_type = D3D12_HEAP_TYPE_DEFAULT;
+        depth_desc.flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+        depth_desc.initial_state = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+        depth_desc.has_clear_value = true;
+        depth_desc.clear_value.Format = render_graph::geometry_pass::DEPTH_STENCIL_FORMAT;
+        depth_desc.clear_value.DepthStencil.Depth = render_graph::geometry_pass::DEPTH_CLEAR_VALUE;
+        depth_desc.clear_value.DepthStencil.Stencil = render_graph::geometry_pass::STENCIL_CLEAR_VALUE;
+        depth_desc.debug_name = L"DepthStencil";
+        scene.gbuffer_depth_stencil_handles[frame_index] = adder.CreateResource(depth_desc);
+
+        // Shadow composition render targets
+        for (UINT i = 0; i < (UINT)render_graph::shadow_composition_pass::RenderTargetIndex::COUNT; ++i)
+        {
+            scene.shadow_composition_render_target_handles[frame_index].emplace_back(adder.CreateResource(
+                RenderTargetDesc(
+                    render_graph::shadow_composition_pass::RENDER_TARGET_FORMATS[i],
+                    render_graph::shadow_composition_pass::RENDER_TARGET_CLEAR_COLORS[i], L"ShadowComposition")));
+        }
+
+        // Lighting render targets
+        for (UINT i = 0; i < (UINT)render_graph::lighting_pass::RenderTargetIndex::COUNT; ++i)
+        {
+            scene.final_color_texture_handles[frame_index].emplace_back(adder.CreateResource(RenderTargetDesc(
+                render_graph::lighting_pass::RENDER_TARGET_FORMATS[i],
+                render_graph::lighting_pass::RENDER_TARGET_CLEAR_COLORS[i], L"FinalColor")));
+        }
+
+        // UI render target
+        const float ui_clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        scene.imgui_render_target_handles[frame_index] = adder.CreateResource(
+            RenderTargetDesc(DXGI_FORMAT_R8G8B8A8_UNORM, ui_clear_color, L"ImguiRenderTarget"));
+
+        // Lights structured buffer, written by the light upload pass
+        render_graph::RenderResourceDesc lights_desc
+            = BufferDesc(sizeof(render_graph::Light::LightBuffer) * LIGHT_MAX_COUNT, L"Lights");
+        lights_desc.heap_type = D3D12_HEAP_TYPE_DEFAULT;
+        lights_desc.initial_state = D3D12_RESOURCE_STATE_COPY_DEST;
+        scene.lights_buffer_handles[frame_index] = adder.CreateResource(lights_desc);
+    }
+
+    // The swap chain is tracked as the render target of the back buffer
+    const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    render_graph::RenderResourceDesc swap_chain_desc
+        = RenderTargetDesc(DXGI_FORMAT_R8G8B8A8_UNORM, black, L"SwapChain");
+    swap_chain_desc.initial_state = D3D12_RESOURCE_STATE_PRESENT;
+    scene.swap_chain_handle = adder.CreateResource(swap_chain_desc);
+
+    scene.full_screen_triangle_vertex_buffer_handle = adder.CreateResource(BufferDesc(
+        sizeof(render_graph::lighting_pass::Vertex) * FULL_SCREEN_TRIANGLE_VERTEX_COUNT, L"FullScreenTriangleVB"));
+    scene.full_screen_triangle_index_buffer_handle = adder.CreateResource(BufferDesc(
+        sizeof(render_graph::lighting_pass::Index) * FULL_SCREEN_TRIANGLE_VERTEX_COUNT, L"FullScreenTriangleIB"));
+    scene.view_proj_matrix_buffer_handle = adder.CreateResource(BufferDesc(sizeof(DirectX::XMMATRIX), L"ViewProj"));
+    scene.inv_view_proj_matrix_buffer_handle
+        = adder.CreateResource(BufferDesc(sizeof(DirectX::XMMATRIX), L"InvViewProj"));
+    scene.light_config_buffer_handle
+        = adder.CreateResource(BufferDesc(sizeof(render_graph::Light::LightConfigBuffer), L"LightConfig"));
+    scene.shadow_composition_config_buffer_handle = adder.CreateResource(BufferDesc(
+        sizeof(render_graph::shadow_composition_pass::ShadowCompositionConfigBuffer), L"ShadowCompositionConfig"));
+
+    // A mesh with its material
+    scene.mesh_vertex_buffer_handle
+        = adder.CreateResource(BufferDesc(sizeof(render_graph::geometry_pass::Vertex) * 24, L"MeshVB"));
+    scene.mesh_index_buffer_handle
+        = adder.CreateResource(BufferDesc(sizeof(render_graph::geometry_pass::Index) * 36, L"MeshIB"));
+    scene.world_buffer_handle
+        = adder.CreateResource(BufferDesc(sizeof(render_graph::geometry_pass::WorldBuffer), L"World"));
+    scene.material_buffer_handle = adder.CreateResource(BufferDesc(256, L"Material"));
+    scene.material_handle = scene.material_adder->AddMaterial(
+        std::make_unique<TestMaterial>(scene.material_buffer_handle));
+
+    // Passes
+    {
+        render_graph::GeometryPass::PipelineMap pipelines;
+        pipelines.emplace(TestMaterialTypeHandle::ID(), std::make_unique<NullPipeline>());
+        scene.geometry_pass
+            = render_graph::GeometryPass::CreateInstance<render_graph::GeometryPass>(std::move(pipelines));
+    }
+    scene.shadow_composition_pass
+        = render_graph::ShadowCompositionPass::CreateInstance<render_graph::ShadowCompositionPass>(
+            std::make_unique<NullPipeline>());
+    scene.lighting_pass
+        = render_graph::LightingPass::CreateInstance<render_graph::LightingPass>(std::make_unique<NullPipeline>());
+    scene.composition_pass = render_graph::CompositionPass::CreateInstance<render_graph::CompositionPass>(
+        std::make_unique<NullPipeline>());
+
+    scene.view_port = { 0.0f, 0.0f, (float)WIDTH, (float)HEIGHT, 0.0f, 1.0f };
+    scene.scissor_rect = { 0, 0, (LONG)WIDTH, (LONG)HEIGHT };
+}
+
+// Destroy the scene, the backend last
+void DestroyDeferredScene(DeferredScene& scene)
+{
+    scene.composition_pass.reset();
+    scene.lighting_pass.reset();
+    scene.shadow_composition_pass.reset();
+    scene.geometry_pass.reset();
+
+    scene.material_adder.reset();
+    scene.material_manager.reset();
+    scene.material_container.reset();
+
+    scene.resource_eraser.reset();
+    scene.resource_adder.reset();
+    scene.resource_manager.reset();
+    scene.resource_container.reset();
+
+    scene.backend.reset();
+
+    scene.material_type_handle_id_generator.reset();
+    scene.render_pass_id_generator.reset();
+}
+
+// Add the passes of a frame to the graph, wired as in render_test
+void AddDeferredPasses(DeferredScene& scene, render_graph::RenderGraph& render_graph, UINT frame_index)
+{
+    // Geometry pass
+    {
+        scene.geometry_pass->SetGBuffers(&scene.gbuffer_render_target_handles[frame_index]);
+        scene.geometry_pass->SetDepthStencil(&scene.gbuffer_depth_stencil_handles[frame_index]);
+
+        render_graph::GeometryPass::MeshInfo mesh_info = {};
+        mesh_info.vertex_buffer_handle = &scene.mesh_vertex_buffer_handle;
+        mesh_info.index_buffer_handle = &scene.mesh_index_buffer_handle;
+        mesh_info.index_count = 36;
+        mesh_info.material_handle = &scene.material_handle;
+        mesh_info.world_matrix_buffer_handle = &scene.world_buffer_handle;
+        scene.geometry_pass->AddDrawMeshInfo(std::move(mesh_info));
+
+        scene.geometry_pass->SetViewProjMatrixBuffer(&scene.view_proj_matrix_buffer_handle);
+        scene.geometry_pass->SetViewport(scene.view_port);
+        scene.geometry_pass->SetScissorRect(scene.scissor_rect);
+        ASSERT_TRUE(scene.geometry_pass->AddToGraph(render_graph));
+    }
+
+    // Shadow composition pass, without shadow casting lights
+    {
+        render_graph::ShadowCompositionPass::FullScreenTriangleInfo fs_triangle_info = {};
+        fs_triangle_info.vertex_buffer_handle = &scene.full_screen_triangle_vertex_buffer_handle;
+        fs_triangle_info.index_buffer_handle = &scene.full_screen_triangle_index_buffer_handle;
+        fs_triangle_info.index_count = FULL_SCREEN_TRIANGLE_VERTEX_COUNT;
+        scene.shadow_composition_pass->SetFullScreenTriangleInfo(std::move(fs_triangle_info));
+
+        scene.shadow_composition_pass->SetRenderTargetHandles(
+            &scene.shadow_composition_render_target_handles[frame_index]);
+        scene.shadow_composition_pass->SetShadowCompositionConfigBufferHandle(
+            &scene.shadow_composition_config_buffer_handle);
+        scene.shadow_composition_pass->SetCameraInvViewProjMatrixBufferHandle(
+            &scene.inv_view_proj_matrix_buffer_handle);
+        scene.shadow_composition_pass->SetDepthTextureHandle(&scene.gbuffer_depth_stencil_handles[frame_index]);
+        scene.shadow_composition_pass->SetNormalTextureHandle(
+            &scene.gbuffer_render_target_handles[frame_index][(UINT)render_graph::geometry_pass::GBufferIndex::NORMAL]);
+        scene.shadow_composition_pass->SetViewport(scene.view_port);
+        scene.shadow_composition_pass->SetScissorRect(scene.scissor_rect);
+        ASSERT_TRUE(scene.shadow_composition_pass->AddToGraph(render_graph));
+    }
+
+    // Lighting pass
+    {
+        const render_graph::ResourceHandles& gbuffers = scene.gbuffer_render_target_handles[frame_index];
+
+        render_graph::LightingPass::FullScreenTriangleInfo fs_triangle_info = {};
+        fs_triangle_info.vertex_buffer_handle = &scene.full_screen_triangle_vertex_buffer_handle;
+        fs_triangle_info.index_buffer_handle = &scene.full_screen_triangle_index_buffer_handle;
+        fs_triangle_info.index_count = FULL_SCREEN_TRIANGLE_VERTEX_COUNT;
+        scene.lighting_pass->SetFullScreenTriangleInfo(std::move(fs_triangle_info));
+
+        scene.lighting_pass->SetViewport(scene.view_port);
+        scene.lighting_pass->SetScissorRect(scene.scissor_rect);
+        scene.lighting_pass->SetRenderTargetTextureHandles(&scene.final_color_texture_handles[frame_index]);
+        scene.lighting_pass->SetInvViewProjMatrixBufferHandle(&scene.inv_view_proj_matrix_buffer_handle);
+        scene.lighting_pass->SetLightConfigBufferHandle(&scene.light_config_buffer_handle);
+        scene.lighting_pass->SetLightsBufferHandle(&scene.lights_buffer_handles[frame_index]);
+        scene.lighting_pass->SetAlbedoTextureHandle(&gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::ALBEDO]);
+        scene.lighting_pass->SetNormalTextureHandle(&gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::NORMAL]);
+        scene.lighting_pass->SetMetalnessTextureHandle(
+            &gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::METALNESS]);
+        scene.lighting_pass->SetRoughnessTextureHandle(
+            &gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::ROUGHNESS]);
+        scene.lighting_pass->SetSpecularTextureHandle(
+            &gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::SPECULAR]);
+        scene.lighting_pass->SetAOTextureHandle(&gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::AO]);
+        scene.lighting_pass->SetEmissionTextureHandle(
+            &gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::EMISSION]);
+        scene.lighting_pass->SetMaskMaterialTextureHandle(
+            &gbuffers[(UINT)render_graph::geometry_pass::GBufferIndex::MASK_MATERIAL]);
+        scene.lighting_pass->SetMaskShadowTextureHandle(
+            &scene.shadow_composition_render_target_handles[frame_index]
+                [(UINT)render_graph::shadow_composition_pass::RenderTargetIndex::SHADOW_MASK]);
+        scene.lighting_pass->SetDepthStencilTextureHandle(&scene.gbuffer_depth_stencil_handles[frame_index]);
+        ASSERT_TRUE(scene.lighting_pass->AddToGraph(render_graph));
+    }
+
+    // Composition pass
+    {
+        const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        scene.composition_pass->SetTargetSwapChain(&scene.swap_chain_handle, clear_color);
+        scene.composition_pass->SetPostProcessTexture(
+            &scene.final_color_texture_handles[frame_index]
+                [(uint32_t)render_graph::lighting_pass::RenderTargetIndex::FINAL_COLOR]);
+        scene.composition_pass->SetUITexture(&scene.imgui_render_target_handles[frame_index]);
+
+        render_graph::CompositionPass::FullScreenTriangleInfo fs_triangle_info = {};
+        fs_triangle_info.vertex_buffer_handle = &scene.full_screen_triangle_vertex_buffer_handle;
+        fs_triangle_info.index_buffer_handle = &scene.full_screen_triangle_index_buffer_handle;
+        fs_triangle_info.index_count = FULL_SCREEN_TRIANGLE_VERTEX_COUNT;
+        scene.composition_pass->SetFullScreenTriangleInfo(std::move(fs_triangle_info));
+
+        scene.composition_pass->SetViewport(scene.view_port);
+        scene.composition_pass->SetScissorRect(scene.scissor_rect);
+        ASSERT_TRUE(scene.composition_pass->AddToGraph(render_graph));
+    }
+}
+
+// Compile and execute a frame on the null backend
+bool ExecuteDeferredFrame(DeferredScene& scene, render_graph::RenderGraph& render_graph, UINT frame_index)
+{
+    AddDeferredPasses(scene, render_graph, frame_index);
+
+    if (!render_graph.Compile())
+        return false; // Failure
+
+    render_graph::RenderPassContext context(*scene.backend);
+    if (!render_graph.Execute(context))
+        return false; // Failure
+
+    render_graph.Clear();
+    return true; // Success
+}
+
+// Get the recorded events of the type which the pass recorded
+std::vector<render_graph::RenderBackendEvent> GetPassEvents(
+    const render_graph::NullRenderBackend& backend, render_graph::RenderBackendEventType type,
+    render_graph::RenderPassHandleID pass_id)
+{
+    std::vector<render_graph::RenderBackendEvent> pass_events;
+    for (const render_graph::RenderBackendEvent& event : backend.GetEvents(type))
+    {
+        if (event.pass_id == pass_id)
+            pass_events.emplace_back(event);
+    }
+
+    return pass_events;
+}
+
+// Get the position of the pass in the executed passes
+size_t FindPass(
+    const std::vector<render_graph::RenderPassHandleID>& executed_passes, render_graph::RenderPassHandleID pass_id)
+{
+    auto it = std::find(executed_passes.begin(), executed_passes.end(), pass_id);
+    EXPECT_NE(it, executed_passes.end());
+    return static_cast<size_t>(it - executed_passes.begin());
+}
+
+class UnknownResourcePassHandle :
+    public render_graph::RenderPassHandle<UnknownResourcePassHandle> {};
+
+// The resource without description, as a resource created outside the backend
+class ExternalResource :
+    public dx12_util::Resource
+{
+public:
+    ID3D12Resource* Get() override { return nullptr; }
+};
+
+} // namespace null_backend_test
+
+TEST(NullBackend, ResourceEvents)
+{
+    render_graph::NullRenderBackend backend;
+    render_graph::ResourceContainer container;
+    render_graph::ResourceManager manager(container);
+    render_graph::ResourceAdder adder(container, backend);
+    render_graph::ResourceEraser eraser(container, backend);
+
+    const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    render_graph::ResourceHandle texture_handle = adder.CreateResource(
+        null_backend_test::RenderTargetDesc(DXGI_FORMAT_R8G8B8A8_UNORM, clear_color, L"Texture"));
+    render_graph::ResourceHandle buffer_handle = adder.CreateResource(null_backend_test::BufferDesc(64, L"Buffer"));
+    render_graph::ResourceHandle external_handle
+        = adder.AddResource(std::make_unique<null_backend_test::ExternalResource>());
+
+    ASSERT_TRUE(texture_handle.IsValid());
+    ASSERT_TRUE(buffer_handle.IsValid());
+    EXPECT_EQ(backend.GetResourceCount(), 3);
+    EXPECT_EQ(backend.GetResourceState(texture_handle), D3D12_RESOURCE_STATE_RENDER_TARGET);
+    EXPECT_EQ(backend.GetResourceState(buffer_handle), D3D12_RESOURCE_STATE_GENERIC_READ);
+    EXPECT_EQ(backend.GetResourceState(external_handle), D3D12_RESOURCE_STATE_COMMON);
+
+    // The null resources keep their descriptions
+    manager.WithLock([&](render_graph::ResourceManager& manager)
+    {
+        render_graph::ResourceAccessToken token;
+        token.PermitAccess(&texture_handle);
+
+        const render_graph::NullResource* texture
+            = dynamic_cast<const render_graph::NullResource*>(&manager.GetReadResource(&texture_handle, token));
+        ASSERT_NE(texture, nullptr);
+        EXPECT_EQ(texture->GetDesc().type, render_graph::RenderResourceType::Texture2D);
+        EXPECT_EQ(texture->GetDesc().width, null_backend_test::WIDTH);
+        EXPECT_EQ(texture->GetDesc().format, DXGI_FORMAT_R8G8B8A8_UNORM);
+    });
+
+    eraser.EraseResource(&buffer_handle);
+    EXPECT_EQ(backend.GetResourceCount(), 2);
+
+    const std::vector<render_graph::RenderBackendEvent>& events = backend.GetEvents();
+    ASSERT_EQ(events.size(), 4);
+    EXPECT_EQ(events[0].type, render_graph::RenderBackendEventType::AddResource);
+    EXPECT_EQ(events[0].resource_handle, texture_handle);
+    EXPECT_EQ(events[0].after_state, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    EXPECT_EQ(events[1].type, render_graph::RenderBackendEventType::AddResource);
+    EXPECT_EQ(events[1].resource_handle, buffer_handle);
+    EXPECT_EQ(events[2].type, render_graph::RenderBackendEventType::AddResource);
+    EXPECT_EQ(events[2].resource_handle, external_handle);
+    EXPECT_EQ(events[3].type, render_graph::RenderBackendEventType::EraseResource);
+    EXPECT_EQ(events[3].resource_handle, buffer_handle);
+
+    backend.ClearEvents();
+    EXPECT_TRUE(backend.GetEvents().empty());
+}
+
+TEST(NullBackend, DeferredFrame)
+{
+    null_backend_test::DeferredScene scene;
+    null_backend_test::CreateDeferredScene(scene);
+    scene.backend->ClearEvents();
+
+    render_graph::RenderGraph render_graph;
+    ASSERT_TRUE(null_backend_test::ExecuteDeferredFrame(scene, render_graph, 0));
+
+    // The passes are executed in the order of their dependencies
+    std::vector<render_graph::RenderPassHandleID> executed_passes = scene.backend->GetExecutedPasses();
+    ASSERT_EQ(executed_passes.size(), 4);
+    size_t geometry = null_backend_test::FindPass(executed_passes, render_graph::GeometryPassHandle::ID());
+    size_t shadow_composition
+        = null_backend_test::FindPass(executed_passes, render_graph::ShadowCompositionPassHandle::ID());
+    size_t lighting = null_backend_test::FindPass(executed_passes, render_graph::LightingPassHandle::ID());
+    size_t composition = null_backend_test::FindPass(executed_passes, render_graph::CompositionPassHandle::ID());
+    EXPECT_LT(geometry, shadow_composition);
+    EXPECT_LT(geometry, lighting);
+    EXPECT_LT(shadow_composition, lighting);
+    EXPECT_LT(lighting, composition);
+
+    // The geometry pass binds and clears all G-buffers with the depth stencil, then draws the mesh
+    const render_graph::RenderPassHandleID geometry_id = render_graph::GeometryPassHandle::ID();
+    std::vector<render_graph::RenderBackendEvent> render_targets = null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::SetRenderTarget, geometry_id);
+    ASSERT_EQ(render_targets.size(), (size_t)render_graph::geometry_pass::GBufferIndex::COUNT);
+    for (UINT i = 0; i < (UINT)render_graph::geometry_pass::GBufferIndex::COUNT; ++i)
+    {
+        EXPECT_EQ(render_targets[i].resource_handle, scene.gbuffer_render_target_handles[0][i]);
+        EXPECT_EQ(render_targets[i].slot, i);
+    }
+
+    std::vector<render_graph::RenderBackendEvent> depth_stencils = null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::SetDepthStencil, geometry_id);
+    ASSERT_EQ(depth_stencils.size(), 1);
+    EXPECT_EQ(depth_stencils[0].resource_handle, scene.gbuffer_depth_stencil_handles[0]);
+
+    EXPECT_EQ(
+        null_backend_test::GetPassEvents(
+            *scene.backend, render_graph::RenderBackendEventType::ClearRenderTarget, geometry_id).size(),
+        (size_t)render_graph::geometry_pass::GBufferIndex::COUNT);
+    EXPECT_EQ(
+        null_backend_test::GetPassEvents(
+            *scene.backend, render_graph::RenderBackendEventType::ClearDepthStencil, geometry_id).size(),
+        1);
+
+    std::vector<render_graph::RenderBackendEvent> vertex_buffers = null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::SetVertexBuffer, geometry_id);
+    ASSERT_EQ(vertex_buffers.size(), 1);
+    EXPECT_EQ(vertex_buffers[0].resource_handle, scene.mesh_vertex_buffer_handle);
+
+    std::vector<render_graph::RenderBackendEvent> geometry_draws = null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::DrawIndexed, geometry_id);
+    ASSERT_EQ(geometry_draws.size(), 1);
+    EXPECT_EQ(geometry_draws[0].index_count, 36);
+
+    // The shadow composition pass draws nothing without shadow casting lights
+    EXPECT_TRUE(null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::DrawIndexed,
+        render_graph::ShadowCompositionPassHandle::ID()).empty());
+
+    // The lighting and composition passes draw the full screen triangle
+    for (render_graph::RenderPassHandleID pass_id :
+        { render_graph::LightingPassHandle::ID(), render_graph::CompositionPassHandle::ID() })
+    {
+        std::vector<render_graph::RenderBackendEvent> draws = null_backend_test::GetPassEvents(
+            *scene.backend, render_graph::RenderBackendEventType::DrawIndexed, pass_id);
+        ASSERT_EQ(draws.size(), 1);
+        EXPECT_EQ(draws[0].index_count, null_backend_test::FULL_SCREEN_TRIANGLE_VERTEX_COUNT);
+    }
+
+    // The composition pass renders to the back buffer and presents it
+    std::vector<render_graph::RenderBackendEvent> swap_chain_transitions = null_backend_test::GetPassEvents(
+        *scene.backend, render_graph::RenderBackendEventType::Transition, render_graph::CompositionPassHandle::ID());
+    ASSERT_EQ(swap_chain_transitions.size(), 2);
+    EXPECT_EQ(swap_chain_transitions[0].resource_handle, scene.swap_chain_handle);
+    EXPECT_EQ(swap_chain_transitions[0].after_state, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    EXPECT_EQ(swap_chain_transitions[1].after_state, D3D12_RESOURCE_STATE_PRESENT);
+
+    // All commands are recorded inside the passes
+    for (const render_graph::RenderBackendEvent& event : scene.backend->GetEvents())
+    {
+        if (event.type != render_graph::RenderBackendEventType::ExecutePass)
+            EXPECT_TRUE(event.in_pass);
+    }
+
+    // The G-buffers are left as shader resources by the geometry pass
+    const render_graph::ResourceHandle& albedo_handle
+        = scene.gbuffer_render_target_handles[0][(UINT)render_graph::geometry_pass::GBufferIndex::ALBEDO];
+    EXPECT_EQ(scene.backend->GetResourceState(albedo_handle), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    EXPECT_EQ(
+        scene.backend->GetResourceState(scene.gbuffer_depth_stencil_handles[0]),
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    EXPECT_EQ(scene.backend->GetResourceState(scene.swap_chain_handle), D3D12_RESOURCE_STATE_PRESENT);
+
+    // The G-buffers of the other frame are not touched
+    EXPECT_EQ(
+        scene.backend->GetResourceState(
+            scene.gbuffer_render_target_handles[1][(UINT)render_graph::geometry_pass::GBufferIndex::ALBEDO]),
+        D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // Run the next frames, the geometry pass of the third frame writes the first G-buffers again
+    ASSERT_TRUE(null_backend_test::ExecuteDeferredFrame(scene, render_graph, 1));
+    scene.backend->ClearEvents();
+    ASSERT_TRUE(null_backend_test::ExecuteDeferredFrame(scene, render_graph, 0));
+
+    std::vector<render_graph::RenderBackendEvent> albedo_transitions;
+    for (const render_graph::RenderBackendEvent& event : scene.backend->GetEvents())
+    {
+        if (event.type == render_graph::RenderBackendEventType::Transition && event.resource_handle == albedo_handle)
+            albedo_transitions.emplace_back(event);
+    }
+
+    ASSERT_EQ(albedo_transitions.size(), 2);
+    EXPECT_EQ(albedo_transitions[0].pass_id, geometry_id);
+    EXPECT_EQ(albedo_transitions[0].before_state, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    EXPECT_EQ(albedo_transitions[0].after_state, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    EXPECT_EQ(albedo_transitions[1].pass_id, geometry_id);
+    EXPECT_EQ(albedo_transitions[1].before_state, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    EXPECT_EQ(albedo_transitions[1].after_state, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    null_backend_test::DestroyDeferredScene(scene);
+}
+
+TEST(NullBackend, TransientShadowMask)
+{
+    null_backend_test::DeferredScene scene;
+    null_backend_test::CreateDeferredScene(scene);
+
+    render_graph::RenderGraph render_graph;
+    null_backend_test::AddDeferredPasses(scene, render_graph, 0);
+    ASSERT_TRUE(render_graph.Compile());
+
+    // The shadow mask is the transient resource, alive from the shadow composition pass to the lighting pass
+    const std::vector<render_graph::TransientResourceAllocation>& allocations
+        = render_graph.GetTransientAllocations();
+    ASSERT_EQ(allocations.size(), 1);
+    EXPECT_EQ(
+        allocations[0].handle,
+        scene.shadow_composition_render_target_handles[0]
+            [(UINT)render_graph::shadow_composition_pass::RenderTargetIndex::SHADOW_MASK]);
+    EXPECT_GT(allocations[0].size, 0);
+    EXPECT_LT(allocations[0].first_pass_index, allocations[0].last_pass_index);
+    EXPECT_EQ(render_graph.GetTransientMemoryStats().resource_count, 1);
+
+    render_graph.Clear();
+    null_backend_test::DestroyDeferredScene(scene);
+}
+
+TEST(NullBackend, UnknownResource)
+{
+    render_graph::RenderPassIDGenerator render_pass_id_generator;
+    render_graph::NullRenderBackend backend;
+
+    // A handle which no resource is added for
+    render_graph::ResourceHandle unknown_handle(0, 0);
+
+    render_graph::RenderGraph render_graph;
+    bool executed = false;
+    ASSERT_TRUE(render_graph.AddPass
+    (
+        null_backend_test::UnknownResourcePassHandle::ID(),
+        [&](render_graph::RenderPassBuilder& builder)
+        {
+            builder.Read(&unknown_handle);
+            return true;
+        },
+        [&](render_graph::RenderPass& self_pass, render_graph::RenderPassContext& context)
+        {
+            executed = true;
+            return true;
+        }
+    ));
+    ASSERT_TRUE(render_graph.Compile());
+
+    render_graph::RenderPassContext context(backend);
+    EXPECT_FALSE(render_graph.Execute(context));
+    EXPECT_FALSE(executed);
+
+    render_graph.Clear();
+}
+
+TEST(NullBackend, Benchmark)
+{
+    constexpr UINT RUN_FRAME_COUNT = 10000;
+
+    null_backend_test::DeferredScene scene;
+    null_backend_test::CreateDeferredScene(scene);
+
+    render_graph::RenderGraph render_graph;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (UINT frame = 0; frame < RUN_FRAME_COUNT; ++frame)
+    {
+        ASSERT_TRUE(null_backend_test::ExecuteDeferredFrame(scene, render_graph, frame % null_backend_test::FRAME_COUNT));
+
+        // Keep the log from growing over the frames
+        scene.backend->ClearEvents();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double us_per_frame = std::chrono::duration<double, std::micro>(end - begin).count() / RUN_FRAME_COUNT;
+    std::cout << "Headless deferred frame: " << us_per_frame << " us/frame" << std::endl;
+
+    null_backend_test::DestroyDeferredScene(scene);
+}
\ No newline at end of file
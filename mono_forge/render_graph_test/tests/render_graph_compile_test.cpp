@@ -0,0 +1,408 @@
+﻿#include "render_graph_test/pch.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "render_graph/include/render_graph.h"
+#include "render_graph/include/render_backend.h"
+
+namespace render_graph_compile_test
+{
+
+// The description of a dummy CPU-only pass
+struct DummyPassDesc
+{
+    render_graph::RenderPassHandleID handle_id;
+    std::vector<size_t> reads; // Indices into the resource list
+    std::vector<size_t> writes; // Indices into the resource list
+};
+
+// Create resource handles which stay alive while the passes use them
+std::vector<render_graph::ResourceHandle> CreateResources(size_t count)
+{
+    std::vector<render_graph::ResourceHandle> resources;
+    resources.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        resources.emplace_back(i, 0);
+    return resources;
+}
+
+// Add a dummy pass which only records its execution order
+bool AddDummyPass(
+    render_graph::RenderGraph& graph, const DummyPassDesc& desc,
+    const std::vector<render_graph::ResourceHandle>& resources,
+    std::vector<render_graph::RenderPassHandleID>* executed)
+{
+    return graph.AddPass
+    (
+        // Render pass handle ID
+        desc.handle_id,
+
+        // Setup function
+        [&](render_graph::RenderPassBuilder& builder)
+        {
+            for (const size_t& read : desc.reads)
+                builder.Read(&resources[read]);
+
+            for (const size_t& write : desc.writes)
+                builder.Write(&resources[write]);
+
+            return true; // Setup successful
+        },
+
+        // Execute function
+        [executed](render_graph::RenderPass& self_pass, render_graph::RenderPassContext& context)
+        {
+            if (executed != nullptr)
+                executed->push_back(self_pass.GetHandleID());
+
+            return true; // Execution successful
+        }
+    );
+}
+
+// Add all dummy passes to the graph
+void AddDummyPasses(
+    render_graph::RenderGraph& graph, const std::vector<DummyPassDesc>& descs,
+    const std::vector<render_graph::ResourceHandle>& resources,
+    std::vector<render_graph::RenderPassHandleID>* executed = nullptr)
+{
+    for (const DummyPassDesc& desc : descs)
+        ASSERT_TRUE(AddDummyPass(graph, desc, resources, executed));
+}
+
+// Compute the execution order with CreateNodes and StableTopologicalSortKahn, without any cache
+std::vector<render_graph::RenderPassHandleID> ComputeReferenceOrder(
+    const std::vector<DummyPassDesc>& descs, const std::vector<render_graph::ResourceHandle>& resources)
+{
+    std::unordered_map<render_graph::RenderPassHandleID, std::unique_ptr<render_graph::RenderPass>> pass_map;
+    std::vector<render_graph::RenderPassHandleID> added_pass_order;
+
+    for (const DummyPassDesc& desc : descs)
+    {
+        std::unique_ptr<render_graph::RenderPass> pass = std::make_unique<render_graph::RenderPass>
+        (
+            desc.handle_id,
+            [&](render_graph::RenderPassBuilder& builder)
+            {
+                for (const size_t& read : desc.reads)
+                    builder.Read(&resources[read]);
+
+                for (const size_t& write : desc.writes)
+                    builder.Write(&resources[write]);
+
+                return true;
+            },
+            [](render_graph::RenderPass&, render_graph::RenderPassContext&) { return true; }
+        );
+
+        render_graph::RenderPassBuilder builder(*pass);
+        pass->Setup(builder);
+
+        added_pass_order.push_back(desc.handle_id);
+        pass_map[desc.handle_id] = std::move(pass);
+    }
+
+    std::vector<render_graph::RenderPassHandleID> sorted;
+    render_graph::StableTopologicalSortKahn(render_graph::CreateNodes(pass_map, added_pass_order), sorted);
+    return sorted;
+}
+
+// Create a layered graph where each pass writes its own resource and reads resources of earlier passes
+std::vector<DummyPassDesc> CreateLayeredPasses(size_t pass_count, std::mt19937& random)
+{
+    std::vector<DummyPassDesc> descs(pass_count);
+    for (size_t i = 0; i < pass_count; ++i)
+    {
+        // Add passes in reverse handle ID order so that the sort has to reorder them
+        descs[i].handle_id = 1000 + pass_count - i;
+        descs[i].writes.push_back(i);
+
+        if (i == 0)
+            continue;
+
+        std::uniform_int_distribution<size_t> dist(0, i - 1);
+        for (size_t r = 0; r < 3; ++r)
+            descs[i].reads.push_back(dist(random));
+    }
+    return descs;
+}
+
+// Rewire the reads of a pass to other resources written before it
+void RewirePass(DummyPassDesc& desc, size_t pass_index, std::mt19937& random)
+{
+    desc.reads.clear();
+    if (pass_index == 0)
+        return;
+
+    std::uniform_int_distribution<size_t> dist(0, pass_index - 1);
+    for (size_t r = 0; r < 3; ++r)
+        desc.reads.push_back(dist(random));
+}
+
+} // namespace render_graph_compile_test
+
+TEST(RenderGraphCompile, ReuseCompiled)
+{
+    std::vector<render_graph::ResourceHandle> resources = render_graph_compile_test::CreateResources(4);
+
+    // A -> B -> C, D is independent
+    std::vector<render_graph_compile_test::DummyPassDesc> descs =
+    {
+        { 30, {}, { 0 } },
+        { 20, { 0 }, { 1 } },
+        { 10, { 1 }, { 2 } },
+        { 5, {}, { 3 } },
+    };
+
+    // Mock command list for context
+    dx12_util::CommandAllocator mock_command_allocator;
+    dx12_util::CommandList mock_command_list(mock_command_allocator);
+    render_graph::DirectX12RenderBackend render_backend;
+    render_graph::RenderPassContext context(render_backend, mock_command_list);
+
+    render_graph::RenderGraph render_graph;
+    std::vector<render_graph::RenderPassHandleID> expected_order = { 5, 30, 20, 10 };
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        std::vector<render_graph::RenderPassHandleID> executed;
+        render_graph_compile_test::AddDummyPasses(render_graph, descs, resources, &executed);
+
+        ASSERT_TRUE(render_graph.Compile());
+        EXPECT_EQ(render_graph.GetSortedPasses(), expected_order);
+
+        // The first frame compiles from scratch, later frames reuse it
+        if (frame == 0)
+        {
+            EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Rebuilt);
+            EXPECT_EQ(render_graph.GetLastRecompiledPassCount(), descs.size());
+        }
+        else
+        {
+            EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Reused);
+            EXPECT_EQ(render_graph.GetLastRecompiledPassCount(), 0);
+        }
+
+        ASSERT_TRUE(render_graph.Execute(context));
+        EXPECT_EQ(executed, expected_order);
+    }
+
+    // Declaring the same resources in another order keeps the pass signatures
+    render_graph::ResourceAccessToken read_token_a;
+    read_token_a.PermitAccess(&resources[0]);
+    read_token_a.PermitAccess(&resources[1]);
+    render_graph::ResourceAccessToken read_token_b;
+    read_token_b.PermitAccess(&resources[1]);
+    read_token_b.PermitAccess(&resources[0]);
+    render_graph::ResourceAccessToken write_token;
+    write_token.PermitAccess(&resources[2]);
+
+    EXPECT_EQ(
+        render_graph::ComputePassSignature(1, read_token_a, write_token),
+        render_graph::ComputePassSignature(1, read_token_b, write_token));
+
+    // Swapping reads and writes or the handle ID changes it
+    EXPECT_NE(
+        render_graph::ComputePassSignature(1, read_token_a, write_token),
+        render_graph::ComputePassSignature(1, write_token, read_token_a));
+    EXPECT_NE(
+        render_graph::ComputePassSignature(1, read_token_a, write_token),
+        render_graph::ComputePassSignature(2, read_token_a, write_token));
+}
+
+TEST(RenderGraphCompile, IncrementalRecompile)
+{
+    std::vector<render_graph::ResourceHandle> resources = render_graph_compile_test::CreateResources(8);
+
+    // Two independent chains, A0 -> A1 -> A2 and B0 -> B1 -> B2
+    std::vector<render_graph_compile_test::DummyPassDesc> descs =
+    {
+        { 1, {}, { 0 } },
+        { 2, { 0 }, { 1 } },
+        { 3, { 1 }, { 2 } },
+        { 4, {}, { 3 } },
+        { 5, { 3 }, { 4 } },
+        { 6, { 4 }, { 5 } },
+    };
+
+    render_graph::RenderGraph render_graph;
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+
+    // Make A2 also write a resource nobody reads, only A2 is recompiled and the order is kept
+    descs[2].writes.push_back(6);
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Incremental);
+    EXPECT_EQ(render_graph.GetLastRecompiledPassCount(), 1);
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+
+    // Make B0 read the output of A2, B0 and its readers are recompiled
+    descs[3].reads.push_back(2);
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Incremental);
+    EXPECT_EQ(render_graph.GetLastRecompiledPassCount(), 2);
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+
+    // Remove A1, A2 loses its dependency
+    std::vector<render_graph_compile_test::DummyPassDesc> removed_descs = descs;
+    removed_descs.erase(removed_descs.begin() + 1);
+    render_graph_compile_test::AddDummyPasses(render_graph, removed_descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Incremental);
+    EXPECT_EQ(
+        render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(removed_descs, resources));
+    render_graph.Clear();
+
+    // Add A1 back
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Incremental);
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+
+    // Invalidating the compiled result compiles from scratch
+    render_graph.InvalidateCompiled();
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Rebuilt);
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+}
+
+TEST(RenderGraphCompile, Cycle)
+{
+    std::vector<render_graph::ResourceHandle> resources = render_graph_compile_test::CreateResources(2);
+
+    std::vector<render_graph_compile_test::DummyPassDesc> descs =
+    {
+        { 1, {}, { 0 } },
+        { 2, { 0 }, { 1 } },
+    };
+
+    render_graph::RenderGraph render_graph;
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    render_graph.Clear();
+
+    // Make the first pass read the output of the second pass
+    descs[0].reads.push_back(1);
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    EXPECT_FALSE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::None);
+    EXPECT_TRUE(render_graph.GetSortedPasses().empty());
+    render_graph.Clear();
+
+    // The next compile starts from scratch
+    descs[0].reads.clear();
+    render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+    ASSERT_TRUE(render_graph.Compile());
+    EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Rebuilt);
+    EXPECT_EQ(render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(descs, resources));
+    render_graph.Clear();
+}
+
+TEST(RenderGraphCompile, RandomFrames)
+{
+    constexpr size_t PASS_COUNT = 64;
+    constexpr int FRAME_COUNT = 200;
+
+    std::mt19937 random(12345);
+    std::vector<render_graph::ResourceHandle> resources = render_graph_compile_test::CreateResources(PASS_COUNT);
+    std::vector<render_graph_compile_test::DummyPassDesc> descs
+        = render_graph_compile_test::CreateLayeredPasses(PASS_COUNT, random);
+
+    render_graph::RenderGraph render_graph;
+    std::uniform_int_distribution<size_t> pass_dist(0, PASS_COUNT - 1);
+    std::uniform_int_distribution<int> change_dist(0, 3);
+
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        // Rewire some passes and skip some passes in this frame
+        std::vector<render_graph_compile_test::DummyPassDesc> frame_descs;
+        int change = change_dist(random);
+        for (int i = 0; i < change; ++i)
+        {
+            size_t pass_index = pass_dist(random);
+            render_graph_compile_test::RewirePass(descs[pass_index], pass_index, random);
+        }
+
+        size_t skipped_index = (change == 3) ? pass_dist(random) : PASS_COUNT;
+        for (size_t i = 0; i < PASS_COUNT; ++i)
+            if (i != skipped_index)
+                frame_descs.push_back(descs[i]);
+
+        render_graph_compile_test::AddDummyPasses(render_graph, frame_descs, resources);
+        ASSERT_TRUE(render_graph.Compile());
+        ASSERT_EQ(
+            render_graph.GetSortedPasses(), render_graph_compile_test::ComputeReferenceOrder(frame_descs, resources))
+            << "Frame: " << frame;
+
+        if (change == 0 && frame != 0 && skipped_index == PASS_COUNT)
+            EXPECT_NE(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Rebuilt);
+
+        render_graph.Clear();
+    }
+}
+
+TEST(RenderGraphCompile, Benchmark)
+{
+    constexpr int FRAME_COUNT = 100;
+
+    for (size_t pass_count : { 50, 100, 250, 500 })
+    {
+        std::mt19937 random(static_cast<unsigned int>(pass_count));
+        std::vector<render_graph::ResourceHandle> resources = render_graph_compile_test::CreateResources(pass_count);
+        std::vector<render_graph_compile_test::DummyPassDesc> descs
+            = render_graph_compile_test::CreateLayeredPasses(pass_count, random);
+
+        render_graph::RenderGraph render_graph;
+
+        // Measure the time to compile the same passes every frame
+        // rebuild: the compiled result is discarded every frame
+        // changed: one pass is rewired every frame
+        // reused: the passes are the same as the last frame
+        auto measure = [&](bool invalidate, bool rewire)
+        {
+            std::chrono::nanoseconds total(0);
+            for (int frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                if (invalidate)
+                    render_graph.InvalidateCompiled();
+
+                if (rewire)
+                {
+                    size_t pass_index = (frame * 7919) % pass_count;
+                    render_graph_compile_test::RewirePass(descs[pass_index], pass_index, random);
+                }
+
+                render_graph_compile_test::AddDummyPasses(render_graph, descs, resources);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                EXPECT_TRUE(render_graph.Compile());
+                auto end = std::chrono::high_resolution_clock::now();
+                total += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+                render_graph.Clear();
+            }
+            return std::chrono::duration<double, std::micro>(total).count() / FRAME_COUNT;
+        };
+
+        double rebuild_us = measure(true, false);
+        double changed_us = measure(false, true);
+        double reused_us = measure(false, false);
+        EXPECT_EQ(render_graph.GetLastCompileResult(), render_graph::RenderGraphCompileResult::Reused);
+
+        std::cout << "Passes: " << pass_count
+            << ", rebuild: " << rebuild_us << " us"
+            << ", changed: " << changed_us << " us"
+            << ", reused: " << reused_us << " us" << std::endl;
+    }
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#include "render_graph_test/pch.h"
 
 #include "render_graph/include/render_graph.h"
+#include "render_graph/include/render_backend.h"
 
 namespace render_graph_test
 {
@@ -159,9 +160,12 @@ TEST(RenderGraph, AddPass)
     // Mock command list for context
     dx12_util::CommandList mock_command_list(mock_command_allocator);
 
+    // Backend which executes the passes directly
+    render_graph::DirectX12RenderBackend render_backend;
+
     // Create a render pass context
     std::unique_ptr<render_graph::RenderPassContext> context 
-        = std::make_unique<render_graph::RenderPassContext>(mock_command_list);
+        = std::make_unique<render_graph::RenderPassContext>(render_backend, mock_command_list);
 
     // Execute the render graph
     EXPECT_TRUE(render_graph.Execute(*context));
@@ -257,9 +261,12 @@ TEST(RenderGraph, RenderPassByClass)
     // Mock command list for context
     dx12_util::CommandList mock_command_list(mock_command_allocator);
 
+    // Backend which executes the passes directly
+    render_graph::DirectX12RenderBackend render_backend;
+
     // Create a render pass context
     std::unique_ptr<render_graph::RenderPassContext> context 
-        = std::make_unique<render_graph::RenderPassContext>(mock_command_list);
+        = std::make_unique<render_graph::RenderPassContext>(render_backend, mock_command_list);
 
     // Execute the render graph
     EXPECT_TRUE(render_graph.Execute(*context));
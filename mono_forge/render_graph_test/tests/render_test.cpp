@@ -17,6 +17,7 @@ using namespace DirectX;
 
 #include "render_graph/include/render_graph.h"
 #include "render_graph/include/resource_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/heap_manager.h"
 #include "render_graph/include/command_manager.h"
 #include "render_graph/include/imgui_context_manager.h"
@@ -132,6 +133,7 @@ struct AppContext
     std::unique_ptr<dx12_util::Device> dx_device = nullptr; // Device instance
     std::unique_ptr<dx12_util::CommandQueue> dx_command_queue = nullptr; // CommandQueue instance
 
+    std::unique_ptr<render_graph::DirectX12RenderBackend> render_backend = nullptr; // Render backend
     std::unique_ptr<render_graph::ResourceContainer> resource_container = nullptr; // Resource container
     std::unique_ptr<render_graph::ResourceManager> resource_manager = nullptr; // Resource manager singleton
     std::unique_ptr<render_graph::ResourceAdder> resource_adder = nullptr; // Resource adder
@@ -242,6 +244,9 @@ bool InitRenderGraph(AppContext& app_context)
     result = app_context.dx_command_queue->Setup(app_context.dx_device->Get());
     if (!result) return false;
 
+    // Create render backend
+    app_context.render_backend = std::make_unique<render_graph::DirectX12RenderBackend>();
+
     // Create resource container
     app_context.resource_container = std::make_unique<render_graph::ResourceContainer>();
 
@@ -249,10 +254,12 @@ bool InitRenderGraph(AppContext& app_context)
     app_context.resource_manager = std::make_unique<render_graph::ResourceManager>(*app_context.resource_container);
 
     // Create resource adder
-    app_context.resource_adder = std::make_unique<render_graph::ResourceAdder>(*app_context.resource_container);
+    app_context.resource_adder = std::make_unique<render_graph::ResourceAdder>(
+        *app_context.resource_container, *app_context.render_backend);
 
     // Create resource eraser
-    app_context.resource_eraser = std::make_unique<render_graph::ResourceEraser>(*app_context.resource_container);
+    app_context.resource_eraser = std::make_unique<render_graph::ResourceEraser>(
+        *app_context.resource_container, *app_context.render_backend);
 
     // Create RTV descriptor heap
     app_context.rtv_heap = dx12_util::DescriptorHeap::CreateInstance<dx12_util::DescriptorHeap>(
@@ -406,6 +413,7 @@ void CleanupRenderGraph(AppContext& app_context)
     app_context.resource_adder.reset();
     app_context.resource_eraser.reset();
     app_context.resource_container.reset();
+    app_context.render_backend.reset();
 
     app_context.heap_manager.reset();
     app_context.srv_heap.reset();
@@ -464,6 +472,7 @@ void CleanupRenderTest(AppContext& app_context)
 }
 
 bool ExecuteRenderGraph(
+    AppContext& app_context,
     render_graph::RenderGraph& render_graph,
     render_graph::ResourceHandle* target_swap_chain_handle,
     render_graph::CommandSetHandle* target_command_handle)
@@ -486,7 +495,8 @@ bool ExecuteRenderGraph(
 
     // Create render pass context
     std::unique_ptr<render_graph::RenderPassContext> context 
-        = std::make_unique<render_graph::RenderPassContext>(command_set->GetCommandList());
+        = std::make_unique<render_graph::RenderPassContext>(
+            *app_context.render_backend, command_set->GetCommandList());
 
     // Execute render graph
     result = render_graph.Execute(*context);
@@ -1571,7 +1581,7 @@ TEST(Render, Template)
             
             // Execute render graph
             result = render_graph_test::ExecuteRenderGraph(
-                render_graph, &swap_chain_handle, &command_set_handles[current_frame_index]);
+                app_context, render_graph, &swap_chain_handle, &command_set_handles[current_frame_index]);
             if (!result)
                 return false; // Stop on failure
 
@@ -3343,7 +3353,7 @@ TEST(Render, Basic)
             /**********************************************************************************************************/
 
             result = render_graph_test::ExecuteRenderGraph(
-                render_graph, &swap_chain_handle, &command_set_handles[frame_index]);
+                app_context, render_graph, &swap_chain_handle, &command_set_handles[frame_index]);
             if (!result)
                 return false; // Stop on failure
 
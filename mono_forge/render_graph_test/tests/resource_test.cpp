@@ -3,6 +3,7 @@
 #include "directx12_util/include/wrapper.h"
 
 #include "render_graph/include/resource_manager.h"
+#include "render_graph/include/render_backend.h"
 #include "render_graph/include/heap_manager.h"
 
 namespace resource_test
@@ -14,6 +15,10 @@ struct TestHandleTag {};
 
 TEST(Resource, ResourceManager)
 {
+    // Create render backend
+    std::unique_ptr<render_graph::DirectX12RenderBackend> render_backend
+        = std::make_unique<render_graph::DirectX12RenderBackend>();
+
     // Create a resource container
     std::unique_ptr<render_graph::ResourceContainer> resource_container 
         = std::make_unique<render_graph::ResourceContainer>();
@@ -24,11 +29,11 @@ TEST(Resource, ResourceManager)
 
     // Create resource adder
     std::unique_ptr<render_graph::ResourceAdder> resource_adder 
-        = std::make_unique<render_graph::ResourceAdder>(*resource_container);
+        = std::make_unique<render_graph::ResourceAdder>(*resource_container, *render_backend);
 
     // Create resource eraser
     std::unique_ptr<render_graph::ResourceEraser> resource_eraser
-        = std::make_unique<render_graph::ResourceEraser>(*resource_container);
+        = std::make_unique<render_graph::ResourceEraser>(*resource_container, *render_backend);
 
     // Create dx12 factory
     std::unique_ptr<dx12_util::DXFactory> dx_factory = std::make_unique<dx12_util::DXFactory>();
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <DirectXMath.h>
+
+#include "transform_evaluator/include/dll_config.h"
+
+namespace transform_evaluator
+{
+
+// The instruction set used by ComputeWorldMatrices
+// It is the widest one the build enables, AVX with /arch:AVX or -mavx, SSE on any x64 build
+enum class TransformBatchInstructionSet
+{
+    Scalar, // One transform at a time
+    SSE, // Four transforms at a time
+    AVX, // Eight transforms at a time
+};
+
+// Get the instruction set used by ComputeWorldMatrices
+TRANSFORM_EVALUATOR_DLL TransformBatchInstructionSet GetTransformBatchInstructionSet();
+
+// Compute the S*R*T matrices of contiguous TRS arrays, several transforms at a time with SIMD
+// If inverse_transposes is not null, the inverse-transpose matrices for transforming normals are also computed
+// They are computed from the TRS directly instead of inverting the matrix, so the scale must not be zero
+// Every instruction set runs the same floating-point operations in the same order,
+// so the results are bitwise equal to ComputeWorldMatricesScalar
+// The rotations must be normalized quaternions
+TRANSFORM_EVALUATOR_DLL void ComputeWorldMatrices(
+    size_t count,
+    const DirectX::XMFLOAT3* translations, const DirectX::XMFLOAT4* rotations, const DirectX::XMFLOAT3* scales,
+    DirectX::XMFLOAT4X4* world_matrices, DirectX::XMFLOAT4X4* inverse_transposes);
+
+// The scalar version of ComputeWorldMatrices, used as the fallback and as the reference in tests
+TRANSFORM_EVALUATOR_DLL void ComputeWorldMatricesScalar(
+    size_t count,
+    const DirectX::XMFLOAT3* translations, const DirectX::XMFLOAT4* rotations, const DirectX::XMFLOAT3* scales,
+    DirectX::XMFLOAT4X4* world_matrices, DirectX::XMFLOAT4X4* inverse_transposes);
+
+} // namespace transform_evaluator
\ No newline at end of file
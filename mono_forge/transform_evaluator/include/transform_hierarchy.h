@@ -0,0 +1,151 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+#include "class_template/non_copy.h"
+
+#include "transform_evaluator/include/dll_config.h"
+#include "transform_evaluator/include/transform.h"
+#include "transform_evaluator/include/transform_handle.h"
+
+namespace transform_evaluator
+{
+
+// The TransformHierarchy class that stores Transforms with parent-child links
+// Transform data is kept in SoA arrays ordered depth-first, so every subtree is a contiguous range
+// that starts at its root and parents are always evaluated before their children
+// Changing a Transform only marks it dirty, Evaluate re-evaluates the dirty subtrees
+// and caches their world matrices, their inverse-transposes and world TRS for the getters
+// It is not thread-safe, the owner must lock around it
+class TRANSFORM_EVALUATOR_DLL TransformHierarchy :
+    public class_template::NonCopyable
+{
+public:
+    TransformHierarchy() = default;
+    ~TransformHierarchy() = default;
+
+    // Add a new root Transform with the given local TRS and return its Handle
+    TransformHandle Add(const TRS& local_trs);
+
+    // Erase a Transform using its Handle
+    // Its children are attached to its parent and keep their world TRS
+    void Erase(const TransformHandle& handle);
+
+    // Check if the Handle refers to a Transform in the hierarchy
+    bool Contains(const TransformHandle& handle) const;
+
+    // Get the number of Transforms
+    size_t GetCount() const;
+
+    // Set the parent of a Transform, an invalid parent Handle makes it a root
+    // The local TRS is kept, so the Transform is placed relative to the new parent
+    void SetParent(const TransformHandle& handle, const TransformHandle& parent_handle);
+
+    // Get the parent of a Transform, invalid if it is a root
+    TransformHandle GetParent(const TransformHandle& handle) const;
+
+    // Get the local TRS of a Transform
+    TRS GetLocalTRS(const TransformHandle& handle) const;
+
+    // Set the local TRS of a Transform
+    void SetLocalTRS(const TransformHandle& handle, const TRS& local_trs);
+
+    // Set the world TRS of a Transform, converted into the local space of its parent
+    void SetWorldTRS(const TransformHandle& handle, const TRS& world_trs);
+
+    // Set the world translation of a Transform
+    void SetWorldTranslation(const TransformHandle& handle, const DirectX::XMFLOAT3& translation);
+
+    // Set the world rotation of a Transform
+    void SetWorldRotation(const TransformHandle& handle, const DirectX::XMFLOAT4& rotation);
+
+    // Set the world scale of a Transform
+    void SetWorldScale(const TransformHandle& handle, const DirectX::XMFLOAT3& scale);
+
+    // Re-evaluate the world matrices and world TRS of the dirty subtrees
+    void Evaluate();
+
+    // Get the number of Transforms re-evaluated by the last Evaluate
+    size_t GetEvaluatedCount() const { return evaluated_count_; }
+
+    // Get the cached world matrix of a Transform, valid after Evaluate
+    const DirectX::XMFLOAT4X4& GetWorldMatrix(const TransformHandle& handle) const;
+
+    // Get the cached inverse-transpose of the world matrix of a Transform for transforming normals, valid after Evaluate
+    const DirectX::XMFLOAT4X4& GetWorldInverseTransposeMatrix(const TransformHandle& handle) const;
+
+    // Get the cached world TRS of a Transform, valid after Evaluate
+    // The world scale is the product of the scales along the chain, it ignores skew
+    TRS GetWorldTRS(const TransformHandle& handle) const;
+
+private:
+    // The slot value used for no slot
+    static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+    // Get the slot of a Handle
+    uint32_t GetSlot(const TransformHandle& handle) const;
+
+    // Mark the slot dirty so that its subtree is re-evaluated
+    void MarkDirty(uint32_t slot);
+
+    // Set the given world components of a slot, null components are kept
+    void SetWorld(
+        uint32_t slot, const DirectX::XMFLOAT3* translation, const DirectX::XMFLOAT4* rotation,
+        const DirectX::XMFLOAT3* scale);
+
+    // Compute the current world matrix of a slot by walking up its parents
+    // It does not rely on the cache, so it can be used before Evaluate
+    DirectX::XMMATRIX ComputeWorldMatrix(uint32_t slot) const;
+
+    // Compute the current world rotation and scale of a slot by walking up its parents
+    void ComputeWorldRotationScale(uint32_t slot, DirectX::XMVECTOR& rotation, DirectX::XMVECTOR& scale) const;
+
+    // Rebuild the depth-first order after parents were changed or Transforms were erased
+    void RebuildOrder();
+
+    // Evaluate the world data of a slot from its parent
+    // The local matrices of the slot must be in the world matrix cache
+    void EvaluateSlot(uint32_t slot);
+
+    // Handle data, indexed by the Handle index
+    std::vector<size_t> generations_;
+    std::vector<uint32_t> slots_;
+    std::vector<size_t> free_indices_;
+
+    // Transform data, indexed by the slot in depth-first order
+    std::vector<uint32_t> handle_indices_; // INVALID_SLOT for erased slots
+    std::vector<uint32_t> parents_; // The parent slot, INVALID_SLOT for roots
+    std::vector<uint32_t> subtree_sizes_; // The number of slots in the subtree including itself
+    std::vector<uint8_t> dirty_flags_;
+    std::vector<DirectX::XMFLOAT3> local_translations_;
+    std::vector<DirectX::XMFLOAT4> local_rotations_;
+    std::vector<DirectX::XMFLOAT3> local_scales_;
+    std::vector<DirectX::XMFLOAT3> world_translations_;
+    std::vector<DirectX::XMFLOAT4> world_rotations_;
+    std::vector<DirectX::XMFLOAT3> world_scales_;
+    std::vector<DirectX::XMFLOAT4X4> world_matrices_;
+    std::vector<DirectX::XMFLOAT4X4> world_inverse_transposes_;
+
+    // The slots marked dirty since the last Evaluate
+    std::vector<uint32_t> dirty_slots_;
+
+    // Whether the depth-first order must be rebuilt
+    bool order_dirty_ = false;
+
+    // The number of slots in use
+    size_t count_ = 0;
+
+    // The number of slots re-evaluated by the last Evaluate
+    size_t evaluated_count_ = 0;
+
+    // Scratch buffers reused by RebuildOrder
+    std::vector<uint32_t> child_offsets_;
+    std::vector<uint32_t> child_slots_;
+    std::vector<uint32_t> new_order_;
+    std::vector<uint32_t> new_slots_;
+    std::vector<uint32_t> stack_;
+};
+
+} // namespace transform_evaluator
\ No newline at end of file
@@ -0,0 +1,288 @@
+﻿#include "transform_evaluator/src/pch.h"
+#include "transform_evaluator/include/transform_batch.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define TRANSFORM_BATCH_SSE
+#include <immintrin.h>
+#endif
+
+#if defined(TRANSFORM_BATCH_SSE) && defined(__AVX__)
+#define TRANSFORM_BATCH_AVX
+#endif
+
+using namespace DirectX;
+
+namespace transform_evaluator
+{
+
+namespace
+{
+
+// The lane operations of one transform at a time
+struct ScalarLanes
+{
+    using Value = float;
+    static constexpr size_t COUNT = 1;
+
+    static Value Set(float value) { return value; }
+    static Value Add(Value a, Value b) { return a + b; }
+    static Value Sub(Value a, Value b) { return a - b; }
+    static Value Mul(Value a, Value b) { return a * b; }
+    static Value Div(Value a, Value b) { return a / b; }
+
+    static void Load3(const XMFLOAT3* values, Value& x, Value& y, Value& z)
+    {
+        x = values->x;
+        y = values->y;
+        z = values->z;
+    }
+
+    static void Load4(const XMFLOAT4* values, Value& x, Value& y, Value& z, Value& w)
+    {
+        x = values->x;
+        y = values->y;
+        z = values->z;
+        w = values->w;
+    }
+
+    static void StoreRow(Value m0, Value m1, Value m2, Value m3, XMFLOAT4X4* matrices, int row)
+    {
+        matrices->m[row][0] = m0;
+        matrices->m[row][1] = m1;
+        matrices->m[row][2] = m2;
+        matrices->m[row][3] = m3;
+    }
+};
+
+#ifdef TRANSFORM_BATCH_SSE
+
+// The lane operations of four transforms at a time
+struct SSELanes
+{
+    using Value = __m128;
+    static constexpr size_t COUNT = 4;
+
+    static Value Set(float value) { return _mm_set1_ps(value); }
+    static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+    static Value Sub(Value a, Value b) { return _mm_sub_ps(a, b); }
+    static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+    static Value Div(Value a, Value b) { return _mm_div_ps(a, b); }
+
+    static void Load3(const XMFLOAT3* values, Value& x, Value& y, Value& z)
+    {
+        x = _mm_setr_ps(values[0].x, values[1].x, values[2].x, values[3].x);
+        y = _mm_setr_ps(values[0].y, values[1].y, values[2].y, values[3].y);
+        z = _mm_setr_ps(values[0].z, values[1].z, values[2].z, values[3].z);
+    }
+
+    static void Load4(const XMFLOAT4* values, Value& x, Value& y, Value& z, Value& w)
+    {
+        // Load one transform per register and transpose them into one component per register
+        x = _mm_loadu_ps(&values[0].x);
+        y = _mm_loadu_ps(&values[1].x);
+        z = _mm_loadu_ps(&values[2].x);
+        w = _mm_loadu_ps(&values[3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+    }
+
+    static void StoreRow(Value m0, Value m1, Value m2, Value m3, XMFLOAT4X4* matrices, int row)
+    {
+        // Transpose one column per register into one transform per register
+        _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+        _mm_storeu_ps(matrices[0].m[row], m0);
+        _mm_storeu_ps(matrices[1].m[row], m1);
+        _mm_storeu_ps(matrices[2].m[row], m2);
+        _mm_storeu_ps(matrices[3].m[row], m3);
+    }
+};
+
+#endif // TRANSFORM_BATCH_SSE
+
+#ifdef TRANSFORM_BATCH_AVX
+
+// The lane operations of eight transforms at a time
+struct AVXLanes
+{
+    using Value = __m256;
+    static constexpr size_t COUNT = 8;
+
+    static Value Set(float value) { return _mm256_set1_ps(value); }
+    static Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+    static Value Sub(Value a, Value b) { return _mm256_sub_ps(a, b); }
+    static Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+    static Value Div(Value a, Value b) { return _mm256_div_ps(a, b); }
+
+    static Value Combine(__m128 low, __m128 high)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+    }
+
+    static void Load3(const XMFLOAT3* values, Value& x, Value& y, Value& z)
+    {
+        __m128 x0, y0, z0, x1, y1, z1;
+        SSELanes::Load3(values, x0, y0, z0);
+        SSELanes::Load3(values + 4, x1, y1, z1);
+        x = Combine(x0, x1);
+        y = Combine(y0, y1);
+        z = Combine(z0, z1);
+    }
+
+    static void Load4(const XMFLOAT4* values, Value& x, Value& y, Value& z, Value& w)
+    {
+        __m128 x0, y0, z0, w0, x1, y1, z1, w1;
+        SSELanes::Load4(values, x0, y0, z0, w0);
+        SSELanes::Load4(values + 4, x1, y1, z1, w1);
+        x = Combine(x0, x1);
+        y = Combine(y0, y1);
+        z = Combine(z0, z1);
+        w = Combine(w0, w1);
+    }
+
+    static void StoreRow(Value m0, Value m1, Value m2, Value m3, XMFLOAT4X4* matrices, int row)
+    {
+        SSELanes::StoreRow(
+            _mm256_castps256_ps128(m0), _mm256_castps256_ps128(m1),
+            _mm256_castps256_ps128(m2), _mm256_castps256_ps128(m3), matrices, row);
+        SSELanes::StoreRow(
+            _mm256_extractf128_ps(m0, 1), _mm256_extractf128_ps(m1, 1),
+            _mm256_extractf128_ps(m2, 1), _mm256_extractf128_ps(m3, 1), matrices + 4, row);
+    }
+};
+
+#endif // TRANSFORM_BATCH_AVX
+
+// Compute the matrices of Lanes::COUNT transforms
+// The operations are written out one by one, so every lane type rounds exactly the same way
+template <typename Lanes>
+void ComputeLanes(
+    const XMFLOAT3* translations, const XMFLOAT4* rotations, const XMFLOAT3* scales,
+    XMFLOAT4X4* world_matrices, XMFLOAT4X4* inverse_transposes)
+{
+    using Value = typename Lanes::Value;
+
+    Value tx, ty, tz;
+    Lanes::Load3(translations, tx, ty, tz);
+    Value qx, qy, qz, qw;
+    Lanes::Load4(rotations, qx, qy, qz, qw);
+    Value sx, sy, sz;
+    Lanes::Load3(scales, sx, sy, sz);
+
+    const Value zero = Lanes::Set(0.0f);
+    const Value one = Lanes::Set(1.0f);
+
+    // The rotation matrix of the quaternion, the same as XMMatrixRotationQuaternion
+    Value qx2 = Lanes::Add(qx, qx);
+    Value qy2 = Lanes::Add(qy, qy);
+    Value qz2 = Lanes::Add(qz, qz);
+    Value xx = Lanes::Mul(qx, qx2);
+    Value yy = Lanes::Mul(qy, qy2);
+    Value zz = Lanes::Mul(qz, qz2);
+    Value xy = Lanes::Mul(qx, qy2);
+    Value xz = Lanes::Mul(qx, qz2);
+    Value yz = Lanes::Mul(qy, qz2);
+    Value wx = Lanes::Mul(qw, qx2);
+    Value wy = Lanes::Mul(qw, qy2);
+    Value wz = Lanes::Mul(qw, qz2);
+
+    Value r00 = Lanes::Sub(one, Lanes::Add(yy, zz));
+    Value r01 = Lanes::Add(xy, wz);
+    Value r02 = Lanes::Sub(xz, wy);
+    Value r10 = Lanes::Sub(xy, wz);
+    Value r11 = Lanes::Sub(one, Lanes::Add(xx, zz));
+    Value r12 = Lanes::Add(yz, wx);
+    Value r20 = Lanes::Add(xz, wy);
+    Value r21 = Lanes::Sub(yz, wx);
+    Value r22 = Lanes::Sub(one, Lanes::Add(xx, yy));
+
+    // S*R*T scales the rotation rows and puts the translation in the last row
+    Lanes::StoreRow(Lanes::Mul(sx, r00), Lanes::Mul(sx, r01), Lanes::Mul(sx, r02), zero, world_matrices, 0);
+    Lanes::StoreRow(Lanes::Mul(sy, r10), Lanes::Mul(sy, r11), Lanes::Mul(sy, r12), zero, world_matrices, 1);
+    Lanes::StoreRow(Lanes::Mul(sz, r20), Lanes::Mul(sz, r21), Lanes::Mul(sz, r22), zero, world_matrices, 2);
+    Lanes::StoreRow(tx, ty, tz, one, world_matrices, 3);
+
+    if (inverse_transposes == nullptr)
+        return; // Only the world matrices are needed
+
+    // The inverse of S*R*T has the rotation rows divided by the scale as columns,
+    // and the translation rotated back into them, so its transpose is written by rows
+    Value inv_sx = Lanes::Div(one, sx);
+    Value inv_sy = Lanes::Div(one, sy);
+    Value inv_sz = Lanes::Div(one, sz);
+
+    Value t0 = Lanes::Add(Lanes::Add(Lanes::Mul(tx, r00), Lanes::Mul(ty, r01)), Lanes::Mul(tz, r02));
+    Value t1 = Lanes::Add(Lanes::Add(Lanes::Mul(tx, r10), Lanes::Mul(ty, r11)), Lanes::Mul(tz, r12));
+    Value t2 = Lanes::Add(Lanes::Add(Lanes::Mul(tx, r20), Lanes::Mul(ty, r21)), Lanes::Mul(tz, r22));
+
+    Lanes::StoreRow(
+        Lanes::Mul(r00, inv_sx), Lanes::Mul(r01, inv_sx), Lanes::Mul(r02, inv_sx),
+        Lanes::Sub(zero, Lanes::Mul(t0, inv_sx)), inverse_transposes, 0);
+    Lanes::StoreRow(
+        Lanes::Mul(r10, inv_sy), Lanes::Mul(r11, inv_sy), Lanes::Mul(r12, inv_sy),
+        Lanes::Sub(zero, Lanes::Mul(t1, inv_sy)), inverse_transposes, 1);
+    Lanes::StoreRow(
+        Lanes::Mul(r20, inv_sz), Lanes::Mul(r21, inv_sz), Lanes::Mul(r22, inv_sz),
+        Lanes::Sub(zero, Lanes::Mul(t2, inv_sz)), inverse_transposes, 2);
+    Lanes::StoreRow(zero, zero, zero, one, inverse_transposes, 3);
+}
+
+// Compute the matrices of the transforms from the index, Lanes::COUNT at a time
+// Returns the index of the first transform left, fewer than Lanes::COUNT remain after it
+template <typename Lanes>
+size_t ComputeBlocks(
+    size_t index, size_t count,
+    const XMFLOAT3* translations, const XMFLOAT4* rotations, const XMFLOAT3* scales,
+    XMFLOAT4X4* world_matrices, XMFLOAT4X4* inverse_transposes)
+{
+    for (; index + Lanes::COUNT <= count; index += Lanes::COUNT)
+    {
+        ComputeLanes<Lanes>(
+            translations + index, rotations + index, scales + index, world_matrices + index,
+            (inverse_transposes != nullptr) ? inverse_transposes + index : nullptr);
+    }
+
+    return index;
+}
+
+} // namespace
+
+TransformBatchInstructionSet GetTransformBatchInstructionSet()
+{
+#if defined(TRANSFORM_BATCH_AVX)
+    return TransformBatchInstructionSet::AVX;
+#elif defined(TRANSFORM_BATCH_SSE)
+    return TransformBatchInstructionSet::SSE;
+#else
+    return TransformBatchInstructionSet::Scalar;
+#endif
+}
+
+void ComputeWorldMatrices(
+    size_t count,
+    const XMFLOAT3* translations, const XMFLOAT4* rotations, const XMFLOAT3* scales,
+    XMFLOAT4X4* world_matrices, XMFLOAT4X4* inverse_transposes)
+{
+    size_t index = 0;
+
+    // Use the widest lanes first, the rest is computed by the narrower ones
+#ifdef TRANSFORM_BATCH_AVX
+    index = ComputeBlocks<AVXLanes>(
+        index, count, translations, rotations, scales, world_matrices, inverse_transposes);
+#endif
+
+#ifdef TRANSFORM_BATCH_SSE
+    index = ComputeBlocks<SSELanes>(
+        index, count, translations, rotations, scales, world_matrices, inverse_transposes);
+#endif
+
+    ComputeBlocks<ScalarLanes>(index, count, translations, rotations, scales, world_matrices, inverse_transposes);
+}
+
+void ComputeWorldMatricesScalar(
+    size_t count,
+    const XMFLOAT3* translations, const XMFLOAT4* rotations, const XMFLOAT3* scales,
+    XMFLOAT4X4* world_matrices, XMFLOAT4X4* inverse_transposes)
+{
+    ComputeBlocks<ScalarLanes>(0, count, translations, rotations, scales, world_matrices, inverse_transposes);
+}
+
+} // namespace transform_evaluator
\ No newline at end of file
@@ -0,0 +1,467 @@
+﻿#include "transform_evaluator/src/pch.h"
+#include "transform_evaluator/include/transform_hierarchy.h"
+#include "transform_evaluator/include/transform_batch.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+
+namespace transform_evaluator
+{
+
+namespace
+{
+
+// Compute the S*R*T matrix of a TRS
+XMMATRIX ComputeLocalMatrix(const XMFLOAT3& translation, const XMFLOAT4& rotation, const XMFLOAT3& scale)
+{
+    return
+        XMMatrixScalingFromVector(XMLoadFloat3(&scale)) *
+        XMMatrixRotationQuaternion(XMLoadFloat4(&rotation)) *
+        XMMatrixTranslationFromVector(XMLoadFloat3(&translation));
+}
+
+// Reorder the elements so that the new element i is the old element order[i]
+template <typename T>
+void Permute(std::vector<T>& elements, const std::vector<uint32_t>& order)
+{
+    std::vector<T> permuted(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        permuted[i] = elements[order[i]];
+    elements.swap(permuted);
+}
+
+} // namespace
+
+TransformHandle TransformHierarchy::Add(const TRS& local_trs)
+{
+    // Get a handle index, reuse an erased one if possible
+    size_t index = 0;
+    if (free_indices_.empty())
+    {
+        index = generations_.size();
+        generations_.emplace_back(utility_header::DEFAULT_GENERATION);
+        slots_.emplace_back(INVALID_SLOT);
+    }
+    else
+    {
+        index = free_indices_.back();
+        free_indices_.pop_back();
+    }
+
+    // A root is evaluated right away, its world matrix is its local matrix
+    XMFLOAT4X4 world_matrix;
+    XMFLOAT4X4 world_inverse_transpose;
+    ComputeWorldMatrices(
+        1, &local_trs.translation, &local_trs.rotation, &local_trs.scale, &world_matrix, &world_inverse_transpose);
+
+    // Append the new root, a root at the end keeps the depth-first order valid
+    uint32_t slot = static_cast<uint32_t>(handle_indices_.size());
+    handle_indices_.emplace_back(static_cast<uint32_t>(index));
+    parents_.emplace_back(INVALID_SLOT);
+    subtree_sizes_.emplace_back(1);
+    dirty_flags_.emplace_back(0);
+    local_translations_.emplace_back(local_trs.translation);
+    local_rotations_.emplace_back(local_trs.rotation);
+    local_scales_.emplace_back(local_trs.scale);
+    world_translations_.emplace_back(local_trs.translation);
+    world_rotations_.emplace_back(local_trs.rotation);
+    world_scales_.emplace_back(local_trs.scale);
+    world_matrices_.emplace_back(world_matrix);
+    world_inverse_transposes_.emplace_back(world_inverse_transpose);
+
+    slots_[index] = slot;
+    count_++;
+
+    return TransformHandle(index, generations_[index]);
+}
+
+void TransformHierarchy::Erase(const TransformHandle& handle)
+{
+    uint32_t slot = GetSlot(handle);
+    uint32_t parent = parents_[slot];
+
+    // Attach the children to the parent, keeping their world TRS
+    // While the order is valid the children are inside the subtree range
+    uint32_t begin = order_dirty_ ? 0 : slot + 1;
+    uint32_t end = order_dirty_ ? static_cast<uint32_t>(handle_indices_.size()) : slot + subtree_sizes_[slot];
+    for (uint32_t child = begin; child < end; ++child)
+    {
+        if (handle_indices_[child] == INVALID_SLOT || parents_[child] != slot)
+            continue;
+
+        XMFLOAT3 world_translation;
+        XMStoreFloat3(&world_translation, ComputeWorldMatrix(child).r[3]);
+
+        XMVECTOR world_rotation, world_scale;
+        ComputeWorldRotationScale(child, world_rotation, world_scale);
+
+        XMFLOAT4 rotation;
+        XMStoreFloat4(&rotation, world_rotation);
+        XMFLOAT3 scale;
+        XMStoreFloat3(&scale, world_scale);
+
+        parents_[child] = parent;
+        SetWorld(child, &world_translation, &rotation, &scale);
+    }
+
+    // Release the handle index with a new generation
+    size_t index = handle.GetIndex();
+    generations_[index]++;
+    slots_[index] = INVALID_SLOT;
+    free_indices_.emplace_back(index);
+
+    // Leave the slot as a hole until the order is rebuilt
+    handle_indices_[slot] = INVALID_SLOT;
+    dirty_flags_[slot] = 0;
+    count_--;
+    order_dirty_ = true;
+}
+
+bool TransformHierarchy::Contains(const TransformHandle& handle) const
+{
+    if (!handle.IsValid() || handle.GetIndex() >= generations_.size())
+        return false;
+
+    return
+        slots_[handle.GetIndex()] != INVALID_SLOT &&
+        generations_[handle.GetIndex()] == handle.GetGeneration();
+}
+
+size_t TransformHierarchy::GetCount() const
+{
+    return count_;
+}
+
+void TransformHierarchy::SetParent(const TransformHandle& handle, const TransformHandle& parent_handle)
+{
+    uint32_t slot = GetSlot(handle);
+    uint32_t parent = parent_handle.IsValid() ? GetSlot(parent_handle) : INVALID_SLOT;
+
+    // Ensure the new parent is not inside the subtree of the Transform
+    for (uint32_t ancestor = parent; ancestor != INVALID_SLOT; ancestor = parents_[ancestor])
+        assert(ancestor != slot && "The parent must not be the Transform itself or one of its descendants!");
+
+    if (parents_[slot] == parent)
+        return; // Nothing to change
+
+    parents_[slot] = parent;
+    order_dirty_ = true;
+    MarkDirty(slot);
+}
+
+TransformHandle TransformHierarchy::GetParent(const TransformHandle& handle) const
+{
+    uint32_t parent = parents_[GetSlot(handle)];
+    if (parent == INVALID_SLOT)
+        return TransformHandle(); // Root
+
+    size_t index = handle_indices_[parent];
+    return TransformHandle(index, generations_[index]);
+}
+
+TRS TransformHierarchy::GetLocalTRS(const TransformHandle& handle) const
+{
+    uint32_t slot = GetSlot(handle);
+
+    TRS trs;
+    trs.translation = local_translations_[slot];
+    trs.rotation = local_rotations_[slot];
+    trs.scale = local_scales_[slot];
+    return trs;
+}
+
+void TransformHierarchy::SetLocalTRS(const TransformHandle& handle, const TRS& local_trs)
+{
+    uint32_t slot = GetSlot(handle);
+
+    local_translations_[slot] = local_trs.translation;
+    local_rotations_[slot] = local_trs.rotation;
+    local_scales_[slot] = local_trs.scale;
+    MarkDirty(slot);
+}
+
+void TransformHierarchy::SetWorldTRS(const TransformHandle& handle, const TRS& world_trs)
+{
+    SetWorld(GetSlot(handle), &world_trs.translation, &world_trs.rotation, &world_trs.scale);
+}
+
+void TransformHierarchy::SetWorldTranslation(const TransformHandle& handle, const XMFLOAT3& translation)
+{
+    SetWorld(GetSlot(handle), &translation, nullptr, nullptr);
+}
+
+void TransformHierarchy::SetWorldRotation(const TransformHandle& handle, const XMFLOAT4& rotation)
+{
+    SetWorld(GetSlot(handle), nullptr, &rotation, nullptr);
+}
+
+void TransformHierarchy::SetWorldScale(const TransformHandle& handle, const XMFLOAT3& scale)
+{
+    SetWorld(GetSlot(handle), nullptr, nullptr, &scale);
+}
+
+void TransformHierarchy::Evaluate()
+{
+    if (order_dirty_)
+        RebuildOrder();
+
+    evaluated_count_ = 0;
+    if (dirty_slots_.empty())
+        return; // Nothing changed
+
+    // Evaluate each dirty subtree once, in depth-first order
+    // A dirty slot inside an already evaluated subtree is skipped
+    std::sort(dirty_slots_.begin(), dirty_slots_.end());
+    uint32_t evaluated_end = 0;
+    for (uint32_t dirty_slot : dirty_slots_)
+    {
+        if (dirty_slot < evaluated_end)
+            continue;
+
+        evaluated_end = dirty_slot + subtree_sizes_[dirty_slot];
+
+        // The local matrices of the subtree are contiguous, compute them in a batch into the world matrix cache
+        ComputeWorldMatrices(
+            subtree_sizes_[dirty_slot],
+            &local_translations_[dirty_slot], &local_rotations_[dirty_slot], &local_scales_[dirty_slot],
+            &world_matrices_[dirty_slot], &world_inverse_transposes_[dirty_slot]);
+
+        for (uint32_t slot = dirty_slot; slot < evaluated_end; ++slot)
+        {
+            EvaluateSlot(slot);
+            dirty_flags_[slot] = 0;
+        }
+        evaluated_count_ += subtree_sizes_[dirty_slot];
+    }
+
+    dirty_slots_.clear();
+}
+
+const XMFLOAT4X4& TransformHierarchy::GetWorldMatrix(const TransformHandle& handle) const
+{
+    return world_matrices_[GetSlot(handle)];
+}
+
+const XMFLOAT4X4& TransformHierarchy::GetWorldInverseTransposeMatrix(const TransformHandle& handle) const
+{
+    return world_inverse_transposes_[GetSlot(handle)];
+}
+
+TRS TransformHierarchy::GetWorldTRS(const TransformHandle& handle) const
+{
+    uint32_t slot = GetSlot(handle);
+
+    TRS trs;
+    trs.translation = world_translations_[slot];
+    trs.rotation = world_rotations_[slot];
+    trs.scale = world_scales_[slot];
+    return trs;
+}
+
+uint32_t TransformHierarchy::GetSlot(const TransformHandle& handle) const
+{
+    assert(handle.IsValid()); // Ensure the Handle is valid
+    assert(handle.GetIndex() < generations_.size()); // Ensure the Handle index is within bounds
+    assert(generations_[handle.GetIndex()] == handle.GetGeneration()); // Ensure the Handle generation matches
+    assert(slots_[handle.GetIndex()] != INVALID_SLOT); // Ensure the Transform exists
+
+    return slots_[handle.GetIndex()];
+}
+
+void TransformHierarchy::MarkDirty(uint32_t slot)
+{
+    if (dirty_flags_[slot])
+        return; // Already marked
+
+    dirty_flags_[slot] = 1;
+    dirty_slots_.emplace_back(slot);
+}
+
+void TransformHierarchy::SetWorld(
+    uint32_t slot, const XMFLOAT3* translation, const XMFLOAT4* rotation, const XMFLOAT3* scale)
+{
+    uint32_t parent = parents_[slot];
+    if (parent == INVALID_SLOT)
+    {
+        // The local TRS of a root is its world TRS
+        if (translation != nullptr)
+            local_translations_[slot] = *translation;
+        if (rotation != nullptr)
+            local_rotations_[slot] = *rotation;
+        if (scale != nullptr)
+            local_scales_[slot] = *scale;
+    }
+    else
+    {
+        // Convert into the local space of the parent
+        if (translation != nullptr)
+        {
+            XMMATRIX inverse_parent_matrix = XMMatrixInverse(nullptr, ComputeWorldMatrix(parent));
+            XMStoreFloat3(
+                &local_translations_[slot],
+                XMVector3TransformCoord(XMLoadFloat3(translation), inverse_parent_matrix));
+        }
+
+        if (rotation != nullptr || scale != nullptr)
+        {
+            XMVECTOR parent_rotation, parent_scale;
+            ComputeWorldRotationScale(parent, parent_rotation, parent_scale);
+
+            if (rotation != nullptr)
+            {
+                XMStoreFloat4(
+                    &local_rotations_[slot],
+                    XMQuaternionMultiply(XMLoadFloat4(rotation), XMQuaternionInverse(parent_rotation)));
+            }
+
+            if (scale != nullptr)
+                XMStoreFloat3(&local_scales_[slot], XMVectorDivide(XMLoadFloat3(scale), parent_scale));
+        }
+    }
+
+    MarkDirty(slot);
+}
+
+XMMATRIX TransformHierarchy::ComputeWorldMatrix(uint32_t slot) const
+{
+    XMMATRIX world_matrix = XMMatrixIdentity();
+    for (uint32_t current = slot; current != INVALID_SLOT; current = parents_[current])
+    {
+        world_matrix = world_matrix * ComputeLocalMatrix(
+            local_translations_[current], local_rotations_[current], local_scales_[current]);
+    }
+
+    return world_matrix;
+}
+
+void TransformHierarchy::ComputeWorldRotationScale(uint32_t slot, XMVECTOR& rotation, XMVECTOR& scale) const
+{
+    rotation = XMQuaternionIdentity();
+    scale = XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
+    for (uint32_t current = slot; current != INVALID_SLOT; current = parents_[current])
+    {
+        rotation = XMQuaternionMultiply(rotation, XMLoadFloat4(&local_rotations_[current]));
+        scale = XMVectorMultiply(scale, XMLoadFloat3(&local_scales_[current]));
+    }
+}
+
+void TransformHierarchy::RebuildOrder()
+{
+    const uint32_t slot_count = static_cast<uint32_t>(handle_indices_.size());
+
+    // Collect the children of each slot, siblings keep their slot order
+    child_offsets_.assign(slot_count + 1, 0);
+    for (uint32_t slot = 0; slot < slot_count; ++slot)
+    {
+        if (handle_indices_[slot] != INVALID_SLOT && parents_[slot] != INVALID_SLOT)
+            child_offsets_[parents_[slot] + 1]++;
+    }
+    for (uint32_t slot = 0; slot < slot_count; ++slot)
+        child_offsets_[slot + 1] += child_offsets_[slot];
+
+    child_slots_.resize(child_offsets_[slot_count]);
+    new_slots_.assign(child_offsets_.begin(), child_offsets_.end() - 1); // Used as write cursors
+    for (uint32_t slot = 0; slot < slot_count; ++slot)
+    {
+        if (handle_indices_[slot] != INVALID_SLOT && parents_[slot] != INVALID_SLOT)
+            child_slots_[new_slots_[parents_[slot]]++] = slot;
+    }
+
+    // Walk every root depth-first
+    new_order_.clear();
+    for (uint32_t root = 0; root < slot_count; ++root)
+    {
+        if (handle_indices_[root] == INVALID_SLOT || parents_[root] != INVALID_SLOT)
+            continue;
+
+        stack_.emplace_back(root);
+        while (!stack_.empty())
+        {
+            uint32_t slot = stack_.back();
+            stack_.pop_back();
+            new_order_.emplace_back(slot);
+
+            // Push in reverse so that the first child is visited first
+            for (uint32_t i = child_offsets_[slot + 1]; i > child_offsets_[slot]; --i)
+                stack_.emplace_back(child_slots_[i - 1]);
+        }
+    }
+    assert(new_order_.size() == count_ && "Every Transform must be reachable from a root!");
+
+    // Map the old slots to the new slots
+    new_slots_.assign(slot_count, INVALID_SLOT);
+    for (uint32_t slot = 0; slot < new_order_.size(); ++slot)
+        new_slots_[new_order_[slot]] = slot;
+
+    // Reorder the Transform data
+    Permute(handle_indices_, new_order_);
+    Permute(parents_, new_order_);
+    Permute(dirty_flags_, new_order_);
+    Permute(local_translations_, new_order_);
+    Permute(local_rotations_, new_order_);
+    Permute(local_scales_, new_order_);
+    Permute(world_translations_, new_order_);
+    Permute(world_rotations_, new_order_);
+    Permute(world_scales_, new_order_);
+    Permute(world_matrices_, new_order_);
+    Permute(world_inverse_transposes_, new_order_);
+
+    for (uint32_t slot = 0; slot < new_order_.size(); ++slot)
+    {
+        if (parents_[slot] != INVALID_SLOT)
+            parents_[slot] = new_slots_[parents_[slot]];
+        slots_[handle_indices_[slot]] = slot;
+    }
+
+    // Parents come before their children, so accumulating backwards gives the subtree sizes
+    subtree_sizes_.assign(new_order_.size(), 1);
+    for (size_t slot = new_order_.size(); slot > 0; --slot)
+    {
+        if (parents_[slot - 1] != INVALID_SLOT)
+            subtree_sizes_[parents_[slot - 1]] += subtree_sizes_[slot - 1];
+    }
+
+    // The dirty slots moved as well
+    dirty_slots_.clear();
+    for (uint32_t slot = 0; slot < new_order_.size(); ++slot)
+    {
+        if (dirty_flags_[slot])
+            dirty_slots_.emplace_back(slot);
+    }
+
+    order_dirty_ = false;
+}
+
+void TransformHierarchy::EvaluateSlot(uint32_t slot)
+{
+    uint32_t parent = parents_[slot];
+    if (parent == INVALID_SLOT)
+    {
+        // The world TRS and matrices of a root are its local ones, already in the cache
+        world_translations_[slot] = local_translations_[slot];
+        world_rotations_[slot] = local_rotations_[slot];
+        world_scales_[slot] = local_scales_[slot];
+        return;
+    }
+
+    // The parent is already evaluated since it comes first
+    // The inverse-transpose of a product is the product of the inverse-transposes, so no inverse is needed
+    XMMATRIX world_matrix = XMLoadFloat4x4(&world_matrices_[slot]) * XMLoadFloat4x4(&world_matrices_[parent]);
+    XMMATRIX world_inverse_transpose
+        = XMLoadFloat4x4(&world_inverse_transposes_[slot]) * XMLoadFloat4x4(&world_inverse_transposes_[parent]);
+
+    XMStoreFloat3(&world_translations_[slot], world_matrix.r[3]);
+    XMStoreFloat4(
+        &world_rotations_[slot],
+        XMQuaternionMultiply(XMLoadFloat4(&local_rotations_[slot]), XMLoadFloat4(&world_rotations_[parent])));
+    XMStoreFloat3(
+        &world_scales_[slot],
+        XMVectorMultiply(XMLoadFloat3(&local_scales_[slot]), XMLoadFloat3(&world_scales_[parent])));
+
+    XMStoreFloat4x4(&world_matrices_[slot], world_matrix);
+    XMStoreFloat4x4(&world_inverse_transposes_[slot], world_inverse_transpose);
+}
+
+} // namespace transform_evaluator
\ No newline at end of file
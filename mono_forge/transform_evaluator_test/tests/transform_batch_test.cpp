@@ -0,0 +1,241 @@
+﻿#include "transform_evaluator_test/pch.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "transform_evaluator/include/transform_batch.h"
+#include "transform_evaluator/include/transform_hierarchy.h"
+
+using namespace DirectX;
+
+namespace
+{
+
+// Contiguous TRS arrays, as the transform hierarchy stores them
+struct TRSArrays
+{
+    std::vector<XMFLOAT3> translations;
+    std::vector<XMFLOAT4> rotations;
+    std::vector<XMFLOAT3> scales;
+};
+
+TRSArrays MakeRandomTRSArrays(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+    std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+    TRSArrays arrays;
+    for (size_t i = 0; i < count; ++i)
+    {
+        arrays.translations.push_back(XMFLOAT3(position(random), position(random), position(random)));
+
+        XMFLOAT4 rotation;
+        XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(angle(random), angle(random), angle(random)));
+        arrays.rotations.push_back(rotation);
+
+        // Uniform and non-uniform scales
+        if (i % 2 == 0)
+        {
+            float uniform = scale(random);
+            arrays.scales.push_back(XMFLOAT3(uniform, uniform, uniform));
+        }
+        else
+        {
+            arrays.scales.push_back(XMFLOAT3(scale(random), scale(random), scale(random)));
+        }
+    }
+    return arrays;
+}
+
+void ExpectMatrixNear(const XMFLOAT4X4& actual, XMMATRIX expected_matrix, float tolerance)
+{
+    XMFLOAT4X4 expected;
+    XMStoreFloat4x4(&expected, expected_matrix);
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            float scaled_tolerance = tolerance * std::max(1.0f, std::fabs(expected.m[row][column]));
+            EXPECT_NEAR(actual.m[row][column], expected.m[row][column], scaled_tolerance)
+                << "row " << row << ", column " << column;
+        }
+    }
+}
+
+// The matrices the consumers built one transform at a time before the batch API
+XMMATRIX ComputeReferenceWorldMatrix(const TRSArrays& arrays, size_t i)
+{
+    return
+        XMMatrixScalingFromVector(XMLoadFloat3(&arrays.scales[i])) *
+        XMMatrixRotationQuaternion(XMLoadFloat4(&arrays.rotations[i])) *
+        XMMatrixTranslationFromVector(XMLoadFloat3(&arrays.translations[i]));
+}
+
+} // namespace
+
+TEST(TransformBatch, MatchesDirectXMath)
+{
+    constexpr size_t COUNT = 1000;
+    TRSArrays arrays = MakeRandomTRSArrays(COUNT, 1);
+
+    std::vector<XMFLOAT4X4> world_matrices(COUNT);
+    std::vector<XMFLOAT4X4> inverse_transposes(COUNT);
+    transform_evaluator::ComputeWorldMatrices(
+        COUNT, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+        world_matrices.data(), inverse_transposes.data());
+
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        XMMATRIX world_matrix = ComputeReferenceWorldMatrix(arrays, i);
+        ExpectMatrixNear(world_matrices[i], world_matrix, 1e-5f);
+        ExpectMatrixNear(inverse_transposes[i], XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix)), 1e-4f);
+    }
+}
+
+TEST(TransformBatch, BitwiseEqualToScalar)
+{
+    std::cout << "Instruction set: ";
+    switch (transform_evaluator::GetTransformBatchInstructionSet())
+    {
+    case transform_evaluator::TransformBatchInstructionSet::Scalar: std::cout << "Scalar" << std::endl; break;
+    case transform_evaluator::TransformBatchInstructionSet::SSE: std::cout << "SSE" << std::endl; break;
+    case transform_evaluator::TransformBatchInstructionSet::AVX: std::cout << "AVX" << std::endl; break;
+    }
+
+    // Counts around the lane widths, so full blocks and every tail length are covered
+    for (size_t count = 0; count <= 37; ++count)
+    {
+        TRSArrays arrays = MakeRandomTRSArrays(count, static_cast<uint32_t>(count) + 100);
+
+        std::vector<XMFLOAT4X4> simd_world(count);
+        std::vector<XMFLOAT4X4> simd_inverse_transposes(count);
+        transform_evaluator::ComputeWorldMatrices(
+            count, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+            simd_world.data(), simd_inverse_transposes.data());
+
+        std::vector<XMFLOAT4X4> scalar_world(count);
+        std::vector<XMFLOAT4X4> scalar_inverse_transposes(count);
+        transform_evaluator::ComputeWorldMatricesScalar(
+            count, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+            scalar_world.data(), scalar_inverse_transposes.data());
+
+        EXPECT_EQ(std::memcmp(simd_world.data(), scalar_world.data(), count * sizeof(XMFLOAT4X4)), 0)
+            << "count " << count;
+        EXPECT_EQ(
+            std::memcmp(
+                simd_inverse_transposes.data(), scalar_inverse_transposes.data(), count * sizeof(XMFLOAT4X4)), 0)
+            << "count " << count;
+
+        // The world matrices do not depend on whether the inverse-transposes are requested
+        std::vector<XMFLOAT4X4> world_only(count);
+        transform_evaluator::ComputeWorldMatrices(
+            count, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+            world_only.data(), nullptr);
+        EXPECT_EQ(std::memcmp(world_only.data(), scalar_world.data(), count * sizeof(XMFLOAT4X4)), 0)
+            << "count " << count;
+    }
+}
+
+TEST(TransformBatch, HierarchyInverseTranspose)
+{
+    // A chain with non-uniform scales, where the world matrix has skew
+    transform_evaluator::TransformHierarchy hierarchy;
+    TRSArrays arrays = MakeRandomTRSArrays(16, 7);
+
+    std::vector<transform_evaluator::TransformHandle> handles;
+    for (size_t i = 0; i < arrays.translations.size(); ++i)
+    {
+        transform_evaluator::TRS trs;
+        trs.translation = XMFLOAT3(arrays.translations[i].x * 0.1f, arrays.translations[i].y * 0.1f, 0.0f);
+        trs.rotation = arrays.rotations[i];
+        trs.scale = XMFLOAT3(
+            0.5f + arrays.scales[i].x * 0.25f, 0.5f + arrays.scales[i].y * 0.25f, 0.5f + arrays.scales[i].z * 0.25f);
+
+        handles.push_back(hierarchy.Add(trs));
+        if (i % 4 != 0)
+            hierarchy.SetParent(handles.back(), handles[i - 1]);
+    }
+    hierarchy.Evaluate();
+
+    for (const transform_evaluator::TransformHandle& handle : handles)
+    {
+        XMMATRIX world_matrix = XMLoadFloat4x4(&hierarchy.GetWorldMatrix(handle));
+        ExpectMatrixNear(
+            hierarchy.GetWorldInverseTransposeMatrix(handle),
+            XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix)), 1e-3f);
+    }
+
+    // Changing a parent re-evaluates the inverse-transposes of its subtree
+    transform_evaluator::TRS trs = hierarchy.GetLocalTRS(handles[1]);
+    trs.scale = XMFLOAT3(2.0f, 0.5f, 1.5f);
+    hierarchy.SetLocalTRS(handles[1], trs);
+    hierarchy.Evaluate();
+
+    for (const transform_evaluator::TransformHandle& handle : handles)
+    {
+        XMMATRIX world_matrix = XMLoadFloat4x4(&hierarchy.GetWorldMatrix(handle));
+        ExpectMatrixNear(
+            hierarchy.GetWorldInverseTransposeMatrix(handle),
+            XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix)), 1e-3f);
+    }
+}
+
+TEST(TransformBatch, Benchmark)
+{
+    for (size_t count : { size_t(1000), size_t(10000), size_t(100000) })
+    {
+        TRSArrays arrays = MakeRandomTRSArrays(count, 42);
+        std::vector<XMFLOAT4X4> world_matrices(count);
+        std::vector<XMFLOAT4X4> inverse_transposes(count);
+
+        // Repeat smaller batches more, so every size runs about the same number of transforms
+        const size_t repeat = 1000000 / count;
+
+        // One transform at a time, inverting the matrix for the normals as GraphicsSystem did
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < repeat; ++r)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                XMMATRIX world_matrix = ComputeReferenceWorldMatrix(arrays, i);
+                XMStoreFloat4x4(&world_matrices[i], world_matrix);
+                XMStoreFloat4x4(&inverse_transposes[i], XMMatrixTranspose(XMMatrixInverse(nullptr, world_matrix)));
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double single_ms = std::chrono::duration<double, std::milli>(end - begin).count() / repeat;
+
+        // Batch without SIMD
+        begin = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < repeat; ++r)
+        {
+            transform_evaluator::ComputeWorldMatricesScalar(
+                count, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+                world_matrices.data(), inverse_transposes.data());
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double scalar_ms = std::chrono::duration<double, std::milli>(end - begin).count() / repeat;
+
+        // Batch with SIMD
+        begin = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < repeat; ++r)
+        {
+            transform_evaluator::ComputeWorldMatrices(
+                count, arrays.translations.data(), arrays.rotations.data(), arrays.scales.data(),
+                world_matrices.data(), inverse_transposes.data());
+        }
+        end = std::chrono::high_resolution_clock::now();
+        double simd_ms = std::chrono::duration<double, std::milli>(end - begin).count() / repeat;
+
+        std::cout << "Transforms: " << count
+            << ", one at a time: " << single_ms << " ms"
+            << ", batch scalar: " << scalar_ms << " ms"
+            << ", batch SIMD: " << simd_ms << " ms" << std::endl;
+    }
+}
\ No newline at end of file
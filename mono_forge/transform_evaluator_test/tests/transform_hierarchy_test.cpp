@@ -0,0 +1,321 @@
+﻿#include "transform_evaluator_test/pch.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "transform_evaluator/include/transform_hierarchy.h"
+
+using namespace DirectX;
+
+namespace
+{
+
+transform_evaluator::TRS MakeTRS(XMFLOAT3 translation, XMFLOAT4 rotation, XMFLOAT3 scale)
+{
+    transform_evaluator::TRS trs;
+    trs.translation = translation;
+    trs.rotation = rotation;
+    trs.scale = scale;
+    return trs;
+}
+
+XMMATRIX ToMatrix(const transform_evaluator::TRS& trs)
+{
+    return
+        XMMatrixScalingFromVector(XMLoadFloat3(&trs.scale)) *
+        XMMatrixRotationQuaternion(XMLoadFloat4(&trs.rotation)) *
+        XMMatrixTranslationFromVector(XMLoadFloat3(&trs.translation));
+}
+
+void ExpectMatrixNear(const XMFLOAT4X4& actual, XMMATRIX expected_matrix, float tolerance)
+{
+    XMFLOAT4X4 expected;
+    XMStoreFloat4x4(&expected, expected_matrix);
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+            EXPECT_NEAR(actual.m[row][column], expected.m[row][column], tolerance);
+    }
+}
+
+void ExpectFloat3Near(const XMFLOAT3& actual, const XMFLOAT3& expected, float tolerance)
+{
+    EXPECT_NEAR(actual.x, expected.x, tolerance);
+    EXPECT_NEAR(actual.y, expected.y, tolerance);
+    EXPECT_NEAR(actual.z, expected.z, tolerance);
+}
+
+} // namespace
+
+TEST(TransformHierarchy, Root)
+{
+    transform_evaluator::TransformHierarchy hierarchy;
+
+    XMFLOAT4 rotation;
+    XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.3f, 0.5f, 0.1f));
+    transform_evaluator::TRS trs = MakeTRS(XMFLOAT3(1.0f, 2.0f, 3.0f), rotation, XMFLOAT3(2.0f, 2.0f, 2.0f));
+
+    transform_evaluator::TransformHandle handle = hierarchy.Add(trs);
+    EXPECT_TRUE(hierarchy.Contains(handle));
+    EXPECT_EQ(hierarchy.GetCount(), 1);
+    EXPECT_FALSE(hierarchy.GetParent(handle).IsValid());
+
+    // A root is usable right after it is added
+    ExpectMatrixNear(hierarchy.GetWorldMatrix(handle), ToMatrix(trs), 1e-5f);
+
+    hierarchy.Evaluate();
+    ExpectMatrixNear(hierarchy.GetWorldMatrix(handle), ToMatrix(trs), 1e-5f);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(handle).translation, trs.translation, 1e-5f);
+
+    // Erased handles are not reused with the same generation
+    hierarchy.Erase(handle);
+    EXPECT_FALSE(hierarchy.Contains(handle));
+    transform_evaluator::TransformHandle new_handle = hierarchy.Add(trs);
+    EXPECT_EQ(new_handle.GetIndex(), handle.GetIndex());
+    EXPECT_FALSE(hierarchy.Contains(handle));
+    EXPECT_TRUE(hierarchy.Contains(new_handle));
+}
+
+TEST(TransformHierarchy, DeepHierarchy)
+{
+    transform_evaluator::TransformHierarchy hierarchy;
+
+    // Build a chain where each link is offset and rotated from its parent
+    const size_t depth = 256;
+    XMFLOAT4 rotation;
+    XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.0f, 0.01f, 0.0f));
+    transform_evaluator::TRS link = MakeTRS(XMFLOAT3(1.0f, 0.0f, 0.0f), rotation, XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+    std::vector<transform_evaluator::TransformHandle> handles;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        handles.push_back(hierarchy.Add(link));
+        if (i != 0)
+            hierarchy.SetParent(handles[i], handles[i - 1]);
+    }
+    hierarchy.Evaluate();
+
+    // Compare every link against the product of the local matrices
+    XMMATRIX expected = XMMatrixIdentity();
+    for (size_t i = 0; i < depth; ++i)
+    {
+        expected = ToMatrix(link) * expected;
+        ExpectMatrixNear(hierarchy.GetWorldMatrix(handles[i]), expected, 1e-3f);
+    }
+
+    // Nothing changed, nothing is evaluated
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), 0);
+
+    // Changing the leaf only evaluates the leaf
+    hierarchy.SetLocalTRS(handles[depth - 1], link);
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), 1);
+
+    // Changing a middle link evaluates its subtree once, even with dirty descendants
+    hierarchy.SetLocalTRS(handles[depth - 10], link);
+    hierarchy.SetLocalTRS(handles[depth - 5], link);
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), 10);
+
+    // Moving the root moves the whole chain
+    transform_evaluator::TRS moved_root = link;
+    moved_root.translation = XMFLOAT3(0.0f, 100.0f, 0.0f);
+    hierarchy.SetLocalTRS(handles[0], moved_root);
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), depth);
+
+    expected = XMMatrixIdentity();
+    for (size_t i = 0; i < depth; ++i)
+    {
+        expected = ToMatrix(i == 0 ? moved_root : link) * expected;
+        ExpectMatrixNear(hierarchy.GetWorldMatrix(handles[i]), expected, 1e-3f);
+    }
+}
+
+TEST(TransformHierarchy, Reparent)
+{
+    transform_evaluator::TransformHierarchy hierarchy;
+    const XMFLOAT4 identity_rotation(0.0f, 0.0f, 0.0f, 1.0f);
+    const XMFLOAT3 unit_scale(1.0f, 1.0f, 1.0f);
+
+    transform_evaluator::TransformHandle a
+        = hierarchy.Add(MakeTRS(XMFLOAT3(10.0f, 0.0f, 0.0f), identity_rotation, unit_scale));
+    transform_evaluator::TransformHandle b
+        = hierarchy.Add(MakeTRS(XMFLOAT3(0.0f, 5.0f, 0.0f), identity_rotation, XMFLOAT3(2.0f, 2.0f, 2.0f)));
+    transform_evaluator::TransformHandle c
+        = hierarchy.Add(MakeTRS(XMFLOAT3(1.0f, 0.0f, 0.0f), identity_rotation, unit_scale));
+    transform_evaluator::TransformHandle d
+        = hierarchy.Add(MakeTRS(XMFLOAT3(0.0f, 0.0f, 1.0f), identity_rotation, unit_scale));
+
+    // a <- c <- d
+    hierarchy.SetParent(c, a);
+    hierarchy.SetParent(d, c);
+    hierarchy.Evaluate();
+    EXPECT_TRUE(hierarchy.GetParent(c) == a);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(c).translation, XMFLOAT3(11.0f, 0.0f, 0.0f), 1e-5f);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(d).translation, XMFLOAT3(11.0f, 0.0f, 1.0f), 1e-5f);
+
+    // b <- c <- d, the local TRS is kept and the scale of b applies
+    hierarchy.SetParent(c, b);
+    hierarchy.Evaluate();
+    EXPECT_TRUE(hierarchy.GetParent(c) == b);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(c).translation, XMFLOAT3(2.0f, 5.0f, 0.0f), 1e-5f);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(d).translation, XMFLOAT3(2.0f, 5.0f, 2.0f), 1e-5f);
+    ExpectFloat3Near(hierarchy.GetWorldTRS(d).scale, XMFLOAT3(2.0f, 2.0f, 2.0f), 1e-5f);
+
+    // Changing a only evaluates a, c is no longer below it
+    hierarchy.SetLocalTRS(a, MakeTRS(XMFLOAT3(20.0f, 0.0f, 0.0f), identity_rotation, unit_scale));
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), 1);
+
+    // Setting the world translation of a child is converted into its parent space
+    hierarchy.SetWorldTranslation(d, XMFLOAT3(-3.0f, 4.0f, 7.0f));
+    hierarchy.Evaluate();
+    ExpectFloat3Near(hierarchy.GetWorldTRS(d).translation, XMFLOAT3(-3.0f, 4.0f, 7.0f), 1e-5f);
+    ExpectFloat3Near(hierarchy.GetLocalTRS(d).translation, XMFLOAT3(-2.5f, -0.5f, 3.5f), 1e-5f);
+
+    // Setting the world rotation of a rotated child is converted as well
+    XMFLOAT4 b_rotation;
+    XMStoreFloat4(&b_rotation, XMQuaternionRotationRollPitchYaw(0.0f, XM_PIDIV2, 0.0f));
+    hierarchy.SetWorldRotation(b, b_rotation);
+    XMFLOAT4 d_rotation;
+    XMStoreFloat4(&d_rotation, XMQuaternionRotationRollPitchYaw(0.4f, 0.0f, 0.0f));
+    hierarchy.SetWorldRotation(d, d_rotation);
+    hierarchy.Evaluate();
+
+    XMFLOAT4 world_rotation = hierarchy.GetWorldTRS(d).rotation;
+    EXPECT_NEAR(std::abs(XMVectorGetX(XMVector4Dot(XMLoadFloat4(&world_rotation), XMLoadFloat4(&d_rotation)))), 1.0f, 1e-5f);
+
+    // Back to a root
+    hierarchy.SetParent(c, transform_evaluator::TransformHandle());
+    hierarchy.Evaluate();
+    EXPECT_FALSE(hierarchy.GetParent(c).IsValid());
+    ExpectFloat3Near(hierarchy.GetWorldTRS(c).translation, XMFLOAT3(1.0f, 0.0f, 0.0f), 1e-5f);
+    EXPECT_TRUE(hierarchy.GetParent(d) == c);
+}
+
+TEST(TransformHierarchy, EraseKeepsChildrenWorld)
+{
+    transform_evaluator::TransformHierarchy hierarchy;
+    const XMFLOAT4 identity_rotation(0.0f, 0.0f, 0.0f, 1.0f);
+    const XMFLOAT3 unit_scale(1.0f, 1.0f, 1.0f);
+
+    transform_evaluator::TransformHandle root
+        = hierarchy.Add(MakeTRS(XMFLOAT3(1.0f, 0.0f, 0.0f), identity_rotation, unit_scale));
+    transform_evaluator::TransformHandle middle
+        = hierarchy.Add(MakeTRS(XMFLOAT3(0.0f, 1.0f, 0.0f), identity_rotation, XMFLOAT3(3.0f, 3.0f, 3.0f)));
+    transform_evaluator::TransformHandle leaf_a
+        = hierarchy.Add(MakeTRS(XMFLOAT3(0.0f, 0.0f, 1.0f), identity_rotation, unit_scale));
+    transform_evaluator::TransformHandle leaf_b
+        = hierarchy.Add(MakeTRS(XMFLOAT3(1.0f, 1.0f, 1.0f), identity_rotation, unit_scale));
+
+    hierarchy.SetParent(middle, root);
+    hierarchy.SetParent(leaf_a, middle);
+    hierarchy.SetParent(leaf_b, middle);
+    hierarchy.Evaluate();
+
+    XMFLOAT4X4 leaf_a_world = hierarchy.GetWorldMatrix(leaf_a);
+    XMFLOAT4X4 leaf_b_world = hierarchy.GetWorldMatrix(leaf_b);
+
+    // The leaves move up to the root and keep where they are
+    hierarchy.Erase(middle);
+    EXPECT_FALSE(hierarchy.Contains(middle));
+    EXPECT_EQ(hierarchy.GetCount(), 3);
+
+    hierarchy.Evaluate();
+    EXPECT_TRUE(hierarchy.GetParent(leaf_a) == root);
+    EXPECT_TRUE(hierarchy.GetParent(leaf_b) == root);
+    ExpectMatrixNear(hierarchy.GetWorldMatrix(leaf_a), XMLoadFloat4x4(&leaf_a_world), 1e-5f);
+    ExpectMatrixNear(hierarchy.GetWorldMatrix(leaf_b), XMLoadFloat4x4(&leaf_b_world), 1e-5f);
+
+    // The leaves still follow the root
+    hierarchy.SetWorldTranslation(root, XMFLOAT3(11.0f, 0.0f, 0.0f));
+    hierarchy.Evaluate();
+    EXPECT_EQ(hierarchy.GetEvaluatedCount(), 3);
+    ExpectFloat3Near(
+        hierarchy.GetWorldTRS(leaf_a).translation,
+        XMFLOAT3(leaf_a_world._41 + 10.0f, leaf_a_world._42, leaf_a_world._43), 1e-5f);
+}
+
+TEST(TransformHierarchy, DirtyPropagationBenchmark)
+{
+    const size_t transform_count = 10000;
+    const size_t tree_size = 100;
+    const size_t changed_count = transform_count / 100; // 1% per frame
+    const int frame_count = 200;
+    using Clock = std::chrono::high_resolution_clock;
+
+    transform_evaluator::TransformHierarchy hierarchy;
+    std::mt19937 random(42);
+
+    // Trees of random shape, each node below a random earlier node of the same tree
+    std::vector<transform_evaluator::TransformHandle> handles;
+    std::vector<transform_evaluator::TransformHandle> roots;
+    XMFLOAT4 rotation;
+    XMStoreFloat4(&rotation, XMQuaternionRotationRollPitchYaw(0.01f, 0.02f, 0.03f));
+    for (size_t i = 0; i < transform_count; ++i)
+    {
+        handles.push_back(hierarchy.Add(
+            MakeTRS(XMFLOAT3(1.0f, 0.5f, 0.25f), rotation, XMFLOAT3(1.0f, 1.0f, 1.0f))));
+
+        size_t tree_index = i % tree_size;
+        if (tree_index == 0)
+            roots.push_back(handles.back());
+        else
+            hierarchy.SetParent(handles.back(), handles[i - tree_index + random() % tree_index]);
+    }
+    hierarchy.Evaluate();
+
+    // Pick the changed transforms up front
+    std::vector<size_t> changed_indices(changed_count * frame_count);
+    for (size_t& index : changed_indices)
+        index = random() % transform_count;
+
+    // Re-evaluate everything every frame
+    Clock::time_point start = Clock::now();
+    size_t full_evaluated_count = 0;
+    for (int frame = 0; frame < frame_count; ++frame)
+    {
+        for (size_t i = 0; i < changed_count; ++i)
+        {
+            transform_evaluator::TransformHandle& handle = handles[changed_indices[frame * changed_count + i]];
+            hierarchy.SetLocalTRS(handle, hierarchy.GetLocalTRS(handle));
+        }
+        for (transform_evaluator::TransformHandle& root : roots)
+            hierarchy.SetLocalTRS(root, hierarchy.GetLocalTRS(root));
+
+        hierarchy.Evaluate();
+        full_evaluated_count += hierarchy.GetEvaluatedCount();
+    }
+    double full_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Only re-evaluate the changed subtrees
+    start = Clock::now();
+    size_t dirty_evaluated_count = 0;
+    for (int frame = 0; frame < frame_count; ++frame)
+    {
+        for (size_t i = 0; i < changed_count; ++i)
+        {
+            transform_evaluator::TransformHandle& handle = handles[changed_indices[frame * changed_count + i]];
+            hierarchy.SetLocalTRS(handle, hierarchy.GetLocalTRS(handle));
+        }
+
+        hierarchy.Evaluate();
+        dirty_evaluated_count += hierarchy.GetEvaluatedCount();
+    }
+    double dirty_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    EXPECT_EQ(full_evaluated_count, transform_count * frame_count);
+    EXPECT_LT(dirty_evaluated_count, full_evaluated_count);
+
+    std::cout << transform_count << " transforms, " << changed_count << " changed per frame, "
+        << frame_count << " frames\n";
+    std::cout << "  full evaluation  : " << full_ms / frame_count << " ms/frame, "
+        << full_evaluated_count / frame_count << " evaluated/frame\n";
+    std::cout << "  dirty evaluation : " << dirty_ms / frame_count << " ms/frame, "
+        << dirty_evaluated_count / frame_count << " evaluated/frame\n";
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include "mono_physics/include/dll_config.h"
+
+#include "mono_physics/include/shape.h"
+
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace mono_physics
+{
+    // The instruction set used by BoxPairBatch::Intersect
+    // It is the widest one the build enables, AVX with /arch:AVX, SSE on any x64 build
+    enum class BoxPairBatchInstructionSet
+    {
+        Scalar, // One pair at a time
+        SSE, // Four pairs at a time
+        AVX, // Eight pairs at a time
+    };
+
+    MONO_PHYSICS_API BoxPairBatchInstructionSet GetBoxPairBatchInstructionSet();
+
+    // The transformed boxes of the pairs stored as SoA, so the overlap test runs several pairs at a time
+    // The boxes are transformed as IsBoxIntersectBox does, and the results are the same as it returns
+    class MONO_PHYSICS_API BoxPairBatch
+    {
+    private:
+        std::vector<float> minAX_, minAY_, minAZ_;
+        std::vector<float> maxAX_, maxAY_, maxAZ_;
+        std::vector<float> minBX_, minBY_, minBZ_;
+        std::vector<float> maxBX_, maxBY_, maxBZ_;
+
+        // Test the pairs in the range one at a time, with the same comparisons as IsBoxIntersectBox
+        size_t IntersectScalarRange(size_t begin, size_t end, std::vector<uint8_t> &outIntersects) const;
+
+    public:
+        BoxPairBatch() = default;
+        ~BoxPairBatch() = default;
+
+        // Remove the pairs, keeping the capacity for the next frame
+        void Clear();
+        void Reserve(size_t count);
+
+        void Add(
+            const ShapeBox &boxA, const DirectX::XMMATRIX &boxATransform,
+            const ShapeBox &boxB, const DirectX::XMMATRIX &boxBTransform);
+
+        // Add a pair whose boxes are already transformed
+        void AddTransformed(
+            const DirectX::XMFLOAT3 &minA, const DirectX::XMFLOAT3 &maxA,
+            const DirectX::XMFLOAT3 &minB, const DirectX::XMFLOAT3 &maxB);
+
+        size_t GetCount() const { return minAX_.size(); }
+
+        // Test all pairs, outIntersects[i] is 1 if the boxes of the i-th pair intersect
+        // Returns the number of the intersecting pairs
+        size_t Intersect(std::vector<uint8_t> &outIntersects) const;
+
+        // The scalar version of Intersect, used as the reference in tests
+        size_t IntersectScalar(std::vector<uint8_t> &outIntersects) const;
+    };
+
+} // namespace mono_physics
\ No newline at end of file
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "mono_physics/include/dll_config.h"
+#include "riaecs/riaecs.h"
+
+#include <DirectXMath.h>
+#include <vector>
+
+namespace mono_physics
+{
+    // A pair of entities whose AABBs might overlap
+    // entityA is always less than entityB
+    struct BroadphasePair
+    {
+        riaecs::Entity entityA;
+        riaecs::Entity entityB;
+
+        bool operator==(const BroadphasePair &other) const
+        {
+            return entityA == other.entityA && entityB == other.entityB;
+        }
+
+        bool operator!=(const BroadphasePair &other) const
+        {
+            return !(*this == other);
+        }
+
+        bool operator<(const BroadphasePair &other) const
+        {
+            if (entityA != other.entityA) return entityA < other.entityA;
+            return entityB < other.entityB;
+        }
+    };
+
+    class Broadphase
+    {
+    public:
+        Broadphase() = default;
+        virtual ~Broadphase() = default;
+
+        // Begin registering the bodies of this frame
+        virtual void BeginUpdate() = 0;
+
+        // Register a body or move it to the new world AABB
+        virtual void UpdateBody(
+            const riaecs::Entity &entity, const DirectX::XMFLOAT3 &min, const DirectX::XMFLOAT3 &max) = 0;
+
+        // End registering, bodies which were not updated since BeginUpdate are removed
+        // The pairs are computed here
+        virtual void EndUpdate() = 0;
+
+        // Get the pairs computed by the last EndUpdate, sorted and without duplicates
+        virtual const std::vector<BroadphasePair> &GetPairs() const = 0;
+    };
+
+} // namespace mono_physics
\ No newline at end of file
@@ -0,0 +1,43 @@
+﻿#pragma once
+#include "mono_physics/include/dll_config.h"
+#include "mono_physics/include/broadphase.h"
+#include "mono_physics/include/grid.h"
+
+#include <vector>
+
+namespace mono_physics
+{
+    // Broadphase using SpatialGrid, which is rebuilt every frame
+    // The pairs are the bodies in the neighbor cells, so they include bodies whose AABBs don't overlap
+    class MONO_PHYSICS_API BroadphaseGrid : public Broadphase
+    {
+    private:
+        struct Body
+        {
+            riaecs::Entity entity;
+            ShapeBox aabb;
+        };
+
+        SpatialGrid spatialGrid_;
+        std::vector<Body> bodies_;
+        std::vector<BroadphasePair> pairs_;
+
+    public:
+        BroadphaseGrid(float gridSize);
+        ~BroadphaseGrid() override = default;
+
+        BroadphaseGrid(const BroadphaseGrid&) = delete;
+        BroadphaseGrid& operator=(const BroadphaseGrid&) = delete;
+
+        /***************************************************************************************************************
+         * Broadphase Implementation
+        /**************************************************************************************************************/
+
+        void BeginUpdate() override;
+        void UpdateBody(
+            const riaecs::Entity &entity, const DirectX::XMFLOAT3 &min, const DirectX::XMFLOAT3 &max) override;
+        void EndUpdate() override;
+        const std::vector<BroadphasePair> &GetPairs() const override { return pairs_; }
+    };
+
+} // namespace mono_physics
\ No newline at end of file
@@ -0,0 +1,73 @@
+﻿#pragma once
+#include "mono_physics/include/dll_config.h"
+#include "mono_physics/include/broadphase.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mono_physics
+{
+    // Persistent sweep and prune along the x axis
+    // The bodies stay sorted across frames, so each frame only fixes the order of the moved bodies
+    // and the buffers are reused, it allocates nothing while the body count and the pair count don't grow
+    // The pairs are exactly the bodies whose AABBs overlap, the same test as IsBoxIntersectBox
+    class MONO_PHYSICS_API BroadphaseSweepAndPrune : public Broadphase
+    {
+    private:
+        struct Proxy
+        {
+            riaecs::Entity entity;
+            DirectX::XMFLOAT3 min = { 0.0f, 0.0f, 0.0f };
+            DirectX::XMFLOAT3 max = { 0.0f, 0.0f, 0.0f };
+            bool isUsed = false;
+            bool isUpdated = false;
+        };
+
+        // The AABB of a proxy copied into the sorted array, so the sweep reads memory in order
+        struct SweepEntry
+        {
+            float minX, maxX;
+            float minY, maxY;
+            float minZ, maxZ;
+            uint32_t proxyIndex;
+        };
+
+        std::vector<Proxy> proxies_;
+        std::vector<uint32_t> freeProxyIndices_;
+        std::unordered_map<riaecs::Entity, uint32_t> proxyIndices_;
+
+        // Sorted by minX
+        std::vector<SweepEntry> sweepEntries_;
+
+        std::vector<BroadphasePair> pairs_;
+
+        // Sort the sweep entries by minX
+        // Insertion sort is used as they are almost sorted, it falls back to std::sort if too many moved
+        void SortSweepEntries();
+
+    public:
+        BroadphaseSweepAndPrune() = default;
+        ~BroadphaseSweepAndPrune() override = default;
+
+        BroadphaseSweepAndPrune(const BroadphaseSweepAndPrune&) = delete;
+        BroadphaseSweepAndPrune& operator=(const BroadphaseSweepAndPrune&) = delete;
+
+        /***************************************************************************************************************
+         * Broadphase Implementation
+        /**************************************************************************************************************/
+
+        void BeginUpdate() override;
+        void UpdateBody(
+            const riaecs::Entity &entity, const DirectX::XMFLOAT3 &min, const DirectX::XMFLOAT3 &max) override;
+        void EndUpdate() override;
+        const std::vector<BroadphasePair> &GetPairs() const override { return pairs_; }
+
+        /***************************************************************************************************************
+         * BroadphaseSweepAndPrune Implementation
+        /**************************************************************************************************************/
+
+        size_t GetBodyCount() const { return proxyIndices_.size(); }
+    };
+
+} // namespace mono_physics
\ No newline at end of file
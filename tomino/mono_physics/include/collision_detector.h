@@ -1,8 +1,10 @@
 ﻿#pragma once
 
+#include <cstdint>
 #include <utility>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "mono_transform/mono_transform.h"
 
@@ -58,6 +60,18 @@ namespace std
 
 namespace mono_physics
 {
+    // A pair passed to a collision detector with its components
+    struct CollisionDetectorPair
+    {
+        riaecs::Entity entityA;
+        Collider *colliderA = nullptr;
+        mono_transform::ComponentTransform *transformA = nullptr;
+
+        riaecs::Entity entityB;
+        Collider *colliderB = nullptr;
+        mono_transform::ComponentTransform *transformB = nullptr;
+    };
+
     class CollisionDetector
     {
     public:
@@ -69,6 +83,22 @@ namespace mono_physics
         virtual bool DetectCollisions(
             const riaecs::Entity& entityA, Collider& colliderA, mono_transform::ComponentTransform& transformA,
             const riaecs::Entity& entityB, Collider& colliderB, mono_transform::ComponentTransform& transformB) = 0;
+
+        // Detect collisions of the pairs whose colliders are the types this detector is registered for
+        // outIsColliding[i] is what DetectCollisions returns for pairs[i], and the collision results are set in the pair order
+        // Override it to test several pairs at a time
+        virtual void DetectCollisionsBatch(
+            const std::vector<CollisionDetectorPair> &pairs, std::vector<uint8_t> &outIsColliding)
+        {
+            outIsColliding.resize(pairs.size());
+            for (size_t i = 0; i < pairs.size(); ++i)
+            {
+                const CollisionDetectorPair &pair = pairs[i];
+                outIsColliding[i] = DetectCollisions(
+                    pair.entityA, *pair.colliderA, *pair.transformA,
+                    pair.entityB, *pair.colliderB, *pair.transformB) ? 1 : 0;
+            }
+        }
     };
     
     class MONO_PHYSICS_API CollisionDetectorRegistry
@@ -2,11 +2,25 @@
 
 #include "mono_physics/include/dll_config.h"
 #include "mono_physics/include/collision_detector.h"
+#include "mono_physics/include/box_pair_batch.h"
 
 namespace mono_physics
 {
     class MONO_PHYSICS_API DetectorBoxVsBox : public CollisionDetector
     {
+    private:
+        // Reused by DetectCollisionsBatch every frame
+        BoxPairBatch batch_;
+        std::vector<uint8_t> intersects_;
+
+        // Set the collision results of the intersecting boxes
+        // Returns false if neither of them is moving, which is not a collision
+        bool SetCollisionResults(
+            const riaecs::Entity& entityA, Collider& colliderA, mono_transform::ComponentTransform& transformA,
+            const DirectX::XMMATRIX& worldMatrixA,
+            const riaecs::Entity& entityB, Collider& colliderB, mono_transform::ComponentTransform& transformB,
+            const DirectX::XMMATRIX& worldMatrixB);
+
     public:
         DetectorBoxVsBox() = default;
         ~DetectorBoxVsBox() override = default;
@@ -14,6 +28,10 @@ namespace mono_physics
         bool DetectCollisions(
             const riaecs::Entity& entityA, Collider& colliderA, mono_transform::ComponentTransform& transformA,
             const riaecs::Entity& entityB, Collider& colliderB, mono_transform::ComponentTransform& transformB) override;
+
+        // Test the boxes with BoxPairBatch, four or eight pairs at a time
+        void DetectCollisionsBatch(
+            const std::vector<CollisionDetectorPair> &pairs, std::vector<uint8_t> &outIsColliding) override;
     };
     
 } // namespace mono_physics
\ No newline at end of file
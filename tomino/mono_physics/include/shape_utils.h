@@ -18,6 +18,11 @@ namespace mono_physics
     MONO_PHYSICS_API ShapeBox CreateBoxFromVector(
         const DirectX::XMFLOAT3 &vec, const DirectX::XMFLOAT3 &origin = {0.0f, 0.0f, 0.0f});
 
+    // Transform the min and max points of the box, same as IsBoxIntersectBox does
+    MONO_PHYSICS_API void GetTransformedBoxMinMax(
+        const ShapeBox &box, const DirectX::XMMATRIX &transform, 
+        DirectX::XMFLOAT3 &outMin, DirectX::XMFLOAT3 &outMax);
+
     /*******************************************************************************************************************
      * Box x Box Utility
     /******************************************************************************************************************/
@@ -3,7 +3,7 @@
 #include "riaecs/riaecs.h"
 
 #include "mono_delta_time/mono_delta_time.h"
-#include "mono_physics/include/grid.h"
+#include "mono_physics/include/broadphase.h"
 #include "mono_physics/include/collision_detector.h"
 #include "mono_physics/include/collision_resolver.h"
 
@@ -15,13 +15,26 @@ namespace mono_physics
         // Delta time provider
         mono_delta_time::DeltaTimeProvider deltaTimeProvider_ = mono_delta_time::DeltaTimeProvider();
 
-        // Spatial grid for broadphase collision detection
-        const float girdCellSize_ = 10.0f; // Size of each grid cell
-        SpatialGrid spatialGrid_;
+        // Broadphase collision detection, kept across frames
+        std::unique_ptr<Broadphase> broadphase_;
+
+        // Pairs passed to the narrowphase, reused every frame
+        std::vector<BroadphasePair> potentialCollisionPairs_;
 
         // Registry of collision detectors
         CollisionDetectorRegistry collisionDetectorRegistry_ = CollisionDetectorRegistry();
 
+        // Narrowphase pairs bucketed by their collider types, in the order the types first appear
+        // Each detector tests the pairs of its bucket in one batch
+        struct NarrowphaseBucket
+        {
+            ColliderPair colliderPair;
+            CollisionDetector *detector = nullptr;
+            std::vector<CollisionDetectorPair> pairs;
+        };
+        std::vector<NarrowphaseBucket> narrowphaseBuckets_;
+        std::vector<uint8_t> isColliding_;
+
         // Registry of collision resolvers
         CollisionResolverRegistry CollisionResolverRegistry_ = CollisionResolverRegistry();
 
@@ -0,0 +1,148 @@
+﻿#include "mono_physics/src/pch.h"
+#include "mono_physics/include/box_pair_batch.h"
+
+#include "mono_physics/include/shape_utils.h"
+
+using namespace DirectX;
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define MONO_PHYSICS_BOX_PAIR_BATCH_AVX
+    #define MONO_PHYSICS_BOX_PAIR_BATCH_SSE
+#elif defined(_M_X64) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define MONO_PHYSICS_BOX_PAIR_BATCH_SSE
+#endif
+
+MONO_PHYSICS_API mono_physics::BoxPairBatchInstructionSet mono_physics::GetBoxPairBatchInstructionSet()
+{
+#if defined(MONO_PHYSICS_BOX_PAIR_BATCH_AVX)
+    return BoxPairBatchInstructionSet::AVX;
+#elif defined(MONO_PHYSICS_BOX_PAIR_BATCH_SSE)
+    return BoxPairBatchInstructionSet::SSE;
+#else
+    return BoxPairBatchInstructionSet::Scalar;
+#endif
+}
+
+void mono_physics::BoxPairBatch::Clear()
+{
+    for (std::vector<float> *values : { 
+        &minAX_, &minAY_, &minAZ_, &maxAX_, &maxAY_, &maxAZ_, 
+        &minBX_, &minBY_, &minBZ_, &maxBX_, &maxBY_, &maxBZ_ })
+    {
+        values->clear();
+    }
+}
+
+void mono_physics::BoxPairBatch::Reserve(size_t count)
+{
+    for (std::vector<float> *values : { 
+        &minAX_, &minAY_, &minAZ_, &maxAX_, &maxAY_, &maxAZ_, 
+        &minBX_, &minBY_, &minBZ_, &maxBX_, &maxBY_, &maxBZ_ })
+    {
+        values->reserve(count);
+    }
+}
+
+void mono_physics::BoxPairBatch::Add(
+    const ShapeBox &boxA, const XMMATRIX &boxATransform,
+    const ShapeBox &boxB, const XMMATRIX &boxBTransform)
+{
+    XMFLOAT3 minA, maxA, minB, maxB;
+    GetTransformedBoxMinMax(boxA, boxATransform, minA, maxA);
+    GetTransformedBoxMinMax(boxB, boxBTransform, minB, maxB);
+    AddTransformed(minA, maxA, minB, maxB);
+}
+
+void mono_physics::BoxPairBatch::AddTransformed(
+    const XMFLOAT3 &minA, const XMFLOAT3 &maxA, const XMFLOAT3 &minB, const XMFLOAT3 &maxB)
+{
+    minAX_.push_back(minA.x); minAY_.push_back(minA.y); minAZ_.push_back(minA.z);
+    maxAX_.push_back(maxA.x); maxAY_.push_back(maxA.y); maxAZ_.push_back(maxA.z);
+    minBX_.push_back(minB.x); minBY_.push_back(minB.y); minBZ_.push_back(minB.z);
+    maxBX_.push_back(maxB.x); maxBY_.push_back(maxB.y); maxBZ_.push_back(maxB.z);
+}
+
+size_t mono_physics::BoxPairBatch::Intersect(std::vector<uint8_t> &outIntersects) const
+{
+    const size_t count = GetCount();
+    outIntersects.resize(count);
+
+    size_t intersectCount = 0;
+    size_t i = 0;
+
+#if defined(MONO_PHYSICS_BOX_PAIR_BATCH_AVX)
+    for (; i + 8 <= count; i += 8)
+    {
+        // Ordered comparisons, false for NaN as the scalar comparisons are
+        __m256 overlapX = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&minAX_[i]), _mm256_loadu_ps(&maxBX_[i]), _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&maxAX_[i]), _mm256_loadu_ps(&minBX_[i]), _CMP_GE_OQ));
+        __m256 overlapY = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&minAY_[i]), _mm256_loadu_ps(&maxBY_[i]), _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&maxAY_[i]), _mm256_loadu_ps(&minBY_[i]), _CMP_GE_OQ));
+        __m256 overlapZ = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&minAZ_[i]), _mm256_loadu_ps(&maxBZ_[i]), _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&maxAZ_[i]), _mm256_loadu_ps(&minBZ_[i]), _CMP_GE_OQ));
+
+        int mask = _mm256_movemask_ps(_mm256_and_ps(overlapX, _mm256_and_ps(overlapY, overlapZ)));
+        for (size_t lane = 0; lane < 8; ++lane)
+        {
+            uint8_t isIntersecting = static_cast<uint8_t>((mask >> lane) & 1);
+            outIntersects[i + lane] = isIntersecting;
+            intersectCount += isIntersecting;
+        }
+    }
+#endif
+
+#if defined(MONO_PHYSICS_BOX_PAIR_BATCH_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 overlapX = _mm_and_ps(
+            _mm_cmple_ps(_mm_loadu_ps(&minAX_[i]), _mm_loadu_ps(&maxBX_[i])),
+            _mm_cmpge_ps(_mm_loadu_ps(&maxAX_[i]), _mm_loadu_ps(&minBX_[i])));
+        __m128 overlapY = _mm_and_ps(
+            _mm_cmple_ps(_mm_loadu_ps(&minAY_[i]), _mm_loadu_ps(&maxBY_[i])),
+            _mm_cmpge_ps(_mm_loadu_ps(&maxAY_[i]), _mm_loadu_ps(&minBY_[i])));
+        __m128 overlapZ = _mm_and_ps(
+            _mm_cmple_ps(_mm_loadu_ps(&minAZ_[i]), _mm_loadu_ps(&maxBZ_[i])),
+            _mm_cmpge_ps(_mm_loadu_ps(&maxAZ_[i]), _mm_loadu_ps(&minBZ_[i])));
+
+        int mask = _mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            uint8_t isIntersecting = static_cast<uint8_t>((mask >> lane) & 1);
+            outIntersects[i + lane] = isIntersecting;
+            intersectCount += isIntersecting;
+        }
+    }
+#endif
+
+    // The remaining pairs, and all of them without SIMD
+    intersectCount += IntersectScalarRange(i, count, outIntersects);
+    return intersectCount;
+}
+
+size_t mono_physics::BoxPairBatch::IntersectScalar(std::vector<uint8_t> &outIntersects) const
+{
+    outIntersects.resize(GetCount());
+    return IntersectScalarRange(0, GetCount(), outIntersects);
+}
+
+size_t mono_physics::BoxPairBatch::IntersectScalarRange(
+    size_t begin, size_t end, std::vector<uint8_t> &outIntersects) const
+{
+    size_t intersectCount = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        bool overlapX = (minAX_[i] <= maxBX_[i]) && (maxAX_[i] >= minBX_[i]);
+        bool overlapY = (minAY_[i] <= maxBY_[i]) && (maxAY_[i] >= minBY_[i]);
+        bool overlapZ = (minAZ_[i] <= maxBZ_[i]) && (maxAZ_[i] >= minBZ_[i]);
+
+        outIntersects[i] = (overlapX && overlapY && overlapZ) ? 1 : 0;
+        intersectCount += outIntersects[i];
+    }
+
+    return intersectCount;
+}
\ No newline at end of file
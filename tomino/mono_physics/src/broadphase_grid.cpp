@@ -0,0 +1,49 @@
+﻿#include "mono_physics/src/pch.h"
+#include "mono_physics/include/broadphase_grid.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+mono_physics::BroadphaseGrid::BroadphaseGrid(float gridSize) :
+    spatialGrid_(gridSize)
+{
+}
+
+void mono_physics::BroadphaseGrid::BeginUpdate()
+{
+    bodies_.clear();
+}
+
+void mono_physics::BroadphaseGrid::UpdateBody(
+    const riaecs::Entity &entity, const XMFLOAT3 &min, const XMFLOAT3 &max)
+{
+    Body body;
+    body.entity = entity;
+    body.aabb.SetMin(min);
+    body.aabb.SetMax(max);
+    bodies_.push_back(body);
+}
+
+void mono_physics::BroadphaseGrid::EndUpdate()
+{
+    // Register all bodies to the grid
+    spatialGrid_.Clear();
+    for (const Body &body : bodies_)
+        spatialGrid_.RegisterAABB(body.entity, body.aabb, XMMatrixIdentity());
+
+    // Query the bodies in the neighbor cells
+    pairs_.clear();
+    for (const Body &body : bodies_)
+    {
+        std::vector<riaecs::Entity> nearby = spatialGrid_.QueryNearby(body.entity, body.aabb, XMMatrixIdentity());
+        for (const riaecs::Entity &other : nearby)
+        {
+            if (body.entity < other)
+                pairs_.push_back({ body.entity, other });
+        }
+    }
+
+    std::sort(pairs_.begin(), pairs_.end());
+    pairs_.erase(std::unique(pairs_.begin(), pairs_.end()), pairs_.end());
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+﻿#include "mono_physics/src/pch.h"
+#include "mono_physics/include/broadphase_sweep_and_prune.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+void mono_physics::BroadphaseSweepAndPrune::SortSweepEntries()
+{
+    // Number of shifts allowed before giving up the insertion sort
+    const size_t maxShiftCount = sweepEntries_.size() * 8;
+    size_t shiftCount = 0;
+
+    for (size_t i = 1; i < sweepEntries_.size(); ++i)
+    {
+        SweepEntry entry = sweepEntries_[i];
+        size_t j = i;
+        while (j > 0 && sweepEntries_[j - 1].minX > entry.minX)
+        {
+            sweepEntries_[j] = sweepEntries_[j - 1];
+            --j;
+
+            if (++shiftCount > maxShiftCount)
+            {
+                // Too many bodies moved, sort the rest from scratch
+                sweepEntries_[j] = entry;
+                std::sort(
+                    sweepEntries_.begin(), sweepEntries_.end(),
+                    [](const SweepEntry &a, const SweepEntry &b) { return a.minX < b.minX; });
+                return;
+            }
+        }
+        sweepEntries_[j] = entry;
+    }
+}
+
+void mono_physics::BroadphaseSweepAndPrune::BeginUpdate()
+{
+    for (Proxy &proxy : proxies_)
+        proxy.isUpdated = false;
+}
+
+void mono_physics::BroadphaseSweepAndPrune::UpdateBody(
+    const riaecs::Entity &entity, const XMFLOAT3 &min, const XMFLOAT3 &max)
+{
+    auto it = proxyIndices_.find(entity);
+    uint32_t proxyIndex = 0;
+    if (it != proxyIndices_.end())
+    {
+        proxyIndex = it->second;
+    }
+    else
+    {
+        // Create a new proxy, reusing a free one if possible
+        if (!freeProxyIndices_.empty())
+        {
+            proxyIndex = freeProxyIndices_.back();
+            freeProxyIndices_.pop_back();
+        }
+        else
+        {
+            proxyIndex = static_cast<uint32_t>(proxies_.size());
+            proxies_.emplace_back();
+        }
+
+        proxies_[proxyIndex].entity = entity;
+        proxies_[proxyIndex].isUsed = true;
+        proxyIndices_[entity] = proxyIndex;
+
+        // Added to the end, SortSweepEntries moves it to its place
+        SweepEntry entry = {};
+        entry.proxyIndex = proxyIndex;
+        sweepEntries_.push_back(entry);
+    }
+
+    Proxy &proxy = proxies_[proxyIndex];
+    proxy.min = min;
+    proxy.max = max;
+    proxy.isUpdated = true;
+}
+
+void mono_physics::BroadphaseSweepAndPrune::EndUpdate()
+{
+    // Remove the bodies which were not updated
+    bool isRemoved = false;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(proxies_.size()); ++i)
+    {
+        Proxy &proxy = proxies_[i];
+        if (!proxy.isUsed || proxy.isUpdated)
+            continue;
+
+        proxyIndices_.erase(proxy.entity);
+        proxy.isUsed = false;
+        freeProxyIndices_.push_back(i);
+        isRemoved = true;
+    }
+
+    if (isRemoved)
+    {
+        sweepEntries_.erase(
+            std::remove_if(
+                sweepEntries_.begin(), sweepEntries_.end(),
+                [this](const SweepEntry &entry) { return !proxies_[entry.proxyIndex].isUsed; }),
+            sweepEntries_.end());
+    }
+
+    // Copy the new AABBs into the sweep entries
+    for (SweepEntry &entry : sweepEntries_)
+    {
+        const Proxy &proxy = proxies_[entry.proxyIndex];
+        entry.minX = proxy.min.x;
+        entry.maxX = proxy.max.x;
+        entry.minY = proxy.min.y;
+        entry.maxY = proxy.max.y;
+        entry.minZ = proxy.min.z;
+        entry.maxZ = proxy.max.z;
+    }
+
+    SortSweepEntries();
+
+    // Sweep along the x axis
+    // Each pair is found once, from the entry which comes first
+    pairs_.clear();
+    for (size_t i = 0; i < sweepEntries_.size(); ++i)
+    {
+        const SweepEntry &a = sweepEntries_[i];
+        for (size_t j = i + 1; j < sweepEntries_.size(); ++j)
+        {
+            const SweepEntry &b = sweepEntries_[j];
+            if (b.minX > a.maxX)
+                break; // No more entries overlap on the x axis
+
+            // Combined without short circuit, as most entries fail on an unpredictable axis
+            bool isOverlapped =
+                (a.minX <= b.maxX) &
+                (a.minY <= b.maxY) & (a.maxY >= b.minY) &
+                (a.minZ <= b.maxZ) & (a.maxZ >= b.minZ);
+            if (!isOverlapped)
+                continue;
+
+            const riaecs::Entity &entityA = proxies_[a.proxyIndex].entity;
+            const riaecs::Entity &entityB = proxies_[b.proxyIndex].entity;
+            if (entityA < entityB)
+                pairs_.push_back({ entityA, entityB });
+            else
+                pairs_.push_back({ entityB, entityA });
+        }
+    }
+
+    std::sort(pairs_.begin(), pairs_.end());
+}
\ No newline at end of file
@@ -17,82 +17,129 @@ bool mono_physics::DetectorBoxVsBox::DetectCollisions(
     const ShapeBox &boxA = static_cast<const ShapeBox&>(colliderA.GetShape());
     const ShapeBox &boxB = static_cast<const ShapeBox&>(colliderB.GetShape());
 
+    XMMATRIX worldMatrixA = transformA.GetWorldMatrixNoRot();
+    XMMATRIX worldMatrixB = transformB.GetWorldMatrixNoRot();
+
     // Check for intersection
-    if (IsBoxIntersectBox(boxA, transformA.GetWorldMatrixNoRot(), boxB, transformB.GetWorldMatrixNoRot()))
+    if (!IsBoxIntersectBox(boxA, worldMatrixA, boxB, worldMatrixB))
+        return false; // No collision
+
+    return SetCollisionResults(
+        entityA, colliderA, transformA, worldMatrixA, 
+        entityB, colliderB, transformB, worldMatrixB);
+}
+
+void mono_physics::DetectorBoxVsBox::DetectCollisionsBatch(
+    const std::vector<CollisionDetectorPair> &pairs, std::vector<uint8_t> &outIsColliding)
+{
+    // Gather the transformed boxes as SoA
+    batch_.Clear();
+    batch_.Reserve(pairs.size());
+    for (const CollisionDetectorPair &pair : pairs)
     {
-        // Get velocities
-        XMFLOAT3 velocityA = XMFLOAT3(
-            transformA.GetPos().x - transformA.GetLastPos().x,
-            transformA.GetPos().y - transformA.GetLastPos().y,
-            transformA.GetPos().z - transformA.GetLastPos().z);
-        XMVECTOR velocityAVec = XMLoadFloat3(&velocityA);
-        
-        XMFLOAT3 velocityB = XMFLOAT3(
-            transformB.GetPos().x - transformB.GetLastPos().x,
-            transformB.GetPos().y - transformB.GetLastPos().y,
-            transformB.GetPos().z - transformB.GetLastPos().z);
-        XMVECTOR velocityBVec = XMLoadFloat3(&velocityB);
-
-        // Get runner velocity
-        bool isARunner = !XMVector3Equal(velocityAVec, XMVectorZero());
-        bool isBRunner = !XMVector3Equal(velocityBVec, XMVectorZero());
-
-        // If both are not moving, no collision
-        if (!isARunner && !isBRunner)
-            return false;
-
-        if (isARunner)
-        {
-            // Get collision normal
-            XMFLOAT3 collisionNormal = GetCollisionNormalFromCollidedBoxes(
-                boxA, transformA.GetWorldMatrixNoRot(),
-                boxB, transformB.GetWorldMatrixNoRot(), velocityA);
-
-            // Set collision result for A
-            CollisionResult& resultA = colliderA.GetCollisionResult();
-            mono_physics::BoxCollisionResult& boxResultA = static_cast<mono_physics::BoxCollisionResult&>(resultA);
-            boxResultA.SetCollided(true);
-            boxResultA.AddCollidedEntity(entityB);
-            boxResultA.AddCollisionNormal(collisionNormal);
-
-            // Inverse normal for B
-            XMFLOAT3 inverseNormal = XMFLOAT3(-collisionNormal.x, -collisionNormal.y, -collisionNormal.z);
-
-            // Set collision result for B
-            CollisionResult& resultB = colliderB.GetCollisionResult();
-            mono_physics::BoxCollisionResult& boxResultB = static_cast<mono_physics::BoxCollisionResult&>(resultB);
-            boxResultB.SetCollided(true);
-            boxResultB.AddCollidedEntity(entityA);
-            boxResultB.AddCollisionNormal(inverseNormal);
-        }
-        else if (isBRunner)
+        batch_.Add(
+            static_cast<const ShapeBox&>(pair.colliderA->GetShape()), pair.transformA->GetWorldMatrixNoRot(),
+            static_cast<const ShapeBox&>(pair.colliderB->GetShape()), pair.transformB->GetWorldMatrixNoRot());
+    }
+
+    // Check for intersection several pairs at a time
+    batch_.Intersect(intersects_);
+
+    // Set the results of the intersecting pairs in the pair order, as DetectCollisions does one by one
+    outIsColliding.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        if (!intersects_[i])
         {
-            // Get collision normal
-            XMFLOAT3 collisionNormal = GetCollisionNormalFromCollidedBoxes(
-                boxB, transformB.GetWorldMatrixNoRot(),
-                boxA, transformA.GetWorldMatrixNoRot(), velocityB);
-
-            // Set collision result for B
-            CollisionResult& resultB = colliderB.GetCollisionResult();
-            mono_physics::BoxCollisionResult& boxResultB = static_cast<mono_physics::BoxCollisionResult&>(resultB);
-            boxResultB.SetCollided(true);
-            boxResultB.AddCollidedEntity(entityA);
-            boxResultB.AddCollisionNormal(collisionNormal);
-
-            // Inverse normal for A
-            XMFLOAT3 inverseNormal = XMFLOAT3(-collisionNormal.x, -collisionNormal.y, -collisionNormal.z);
-
-            // Set collision result for A
-            CollisionResult& resultA = colliderA.GetCollisionResult();
-            mono_physics::BoxCollisionResult& boxResultA = static_cast<mono_physics::BoxCollisionResult&>(resultA);
-            boxResultA.SetCollided(true);
-            boxResultA.AddCollidedEntity(entityB);
-            boxResultA.AddCollisionNormal(inverseNormal);
+            outIsColliding[i] = 0; // No collision
+            continue;
         }
+
+        const CollisionDetectorPair &pair = pairs[i];
+        outIsColliding[i] = SetCollisionResults(
+            pair.entityA, *pair.colliderA, *pair.transformA, pair.transformA->GetWorldMatrixNoRot(),
+            pair.entityB, *pair.colliderB, *pair.transformB, pair.transformB->GetWorldMatrixNoRot()) ? 1 : 0;
     }
-    else
+}
+
+bool mono_physics::DetectorBoxVsBox::SetCollisionResults(
+    const riaecs::Entity& entityA, Collider& colliderA, mono_transform::ComponentTransform& transformA,
+    const XMMATRIX& worldMatrixA,
+    const riaecs::Entity& entityB, Collider& colliderB, mono_transform::ComponentTransform& transformB,
+    const XMMATRIX& worldMatrixB)
+{
+    // Cast to box shapes
+    const ShapeBox &boxA = static_cast<const ShapeBox&>(colliderA.GetShape());
+    const ShapeBox &boxB = static_cast<const ShapeBox&>(colliderB.GetShape());
+
+    // Get velocities
+    XMFLOAT3 velocityA = XMFLOAT3(
+        transformA.GetPos().x - transformA.GetLastPos().x,
+        transformA.GetPos().y - transformA.GetLastPos().y,
+        transformA.GetPos().z - transformA.GetLastPos().z);
+    XMVECTOR velocityAVec = XMLoadFloat3(&velocityA);
+    
+    XMFLOAT3 velocityB = XMFLOAT3(
+        transformB.GetPos().x - transformB.GetLastPos().x,
+        transformB.GetPos().y - transformB.GetLastPos().y,
+        transformB.GetPos().z - transformB.GetLastPos().z);
+    XMVECTOR velocityBVec = XMLoadFloat3(&velocityB);
+
+    // Get runner velocity
+    bool isARunner = !XMVector3Equal(velocityAVec, XMVectorZero());
+    bool isBRunner = !XMVector3Equal(velocityBVec, XMVectorZero());
+
+    // If both are not moving, no collision
+    if (!isARunner && !isBRunner)
+        return false;
+
+    if (isARunner)
     {
-        return false; // No collision
+        // Get collision normal
+        XMFLOAT3 collisionNormal = GetCollisionNormalFromCollidedBoxes(
+            boxA, worldMatrixA,
+            boxB, worldMatrixB, velocityA);
+
+        // Set collision result for A
+        CollisionResult& resultA = colliderA.GetCollisionResult();
+        mono_physics::BoxCollisionResult& boxResultA = static_cast<mono_physics::BoxCollisionResult&>(resultA);
+        boxResultA.SetCollided(true);
+        boxResultA.AddCollidedEntity(entityB);
+        boxResultA.AddCollisionNormal(collisionNormal);
+
+        // Inverse normal for B
+        XMFLOAT3 inverseNormal = XMFLOAT3(-collisionNormal.x, -collisionNormal.y, -collisionNormal.z);
+
+        // Set collision result for B
+        CollisionResult& resultB = colliderB.GetCollisionResult();
+        mono_physics::BoxCollisionResult& boxResultB = static_cast<mono_physics::BoxCollisionResult&>(resultB);
+        boxResultB.SetCollided(true);
+        boxResultB.AddCollidedEntity(entityA);
+        boxResultB.AddCollisionNormal(inverseNormal);
+    }
+    else if (isBRunner)
+    {
+        // Get collision normal
+        XMFLOAT3 collisionNormal = GetCollisionNormalFromCollidedBoxes(
+            boxB, worldMatrixB,
+            boxA, worldMatrixA, velocityB);
+
+        // Set collision result for B
+        CollisionResult& resultB = colliderB.GetCollisionResult();
+        mono_physics::BoxCollisionResult& boxResultB = static_cast<mono_physics::BoxCollisionResult&>(resultB);
+        boxResultB.SetCollided(true);
+        boxResultB.AddCollidedEntity(entityA);
+        boxResultB.AddCollisionNormal(collisionNormal);
+
+        // Inverse normal for A
+        XMFLOAT3 inverseNormal = XMFLOAT3(-collisionNormal.x, -collisionNormal.y, -collisionNormal.z);
+
+        // Set collision result for A
+        CollisionResult& resultA = colliderA.GetCollisionResult();
+        mono_physics::BoxCollisionResult& boxResultA = static_cast<mono_physics::BoxCollisionResult&>(resultA);
+        boxResultA.SetCollided(true);
+        boxResultA.AddCollidedEntity(entityB);
+        boxResultA.AddCollisionNormal(inverseNormal);
     }
 
     return true;
@@ -15,19 +15,24 @@ MONO_PHYSICS_API mono_physics::ShapeBox mono_physics::CreateBoxFromVector(
     return mono_physics::ShapeBox();
 }
 
+MONO_PHYSICS_API void mono_physics::GetTransformedBoxMinMax(
+    const ShapeBox &box, const XMMATRIX &transform, XMFLOAT3 &outMin, XMFLOAT3 &outMax)
+{
+    XMStoreFloat3(&outMin, XMVector3Transform(XMLoadFloat3(&box.GetMin()), transform));
+    XMStoreFloat3(&outMax, XMVector3Transform(XMLoadFloat3(&box.GetMax()), transform));
+}
+
 MONO_PHYSICS_API bool mono_physics::IsBoxIntersectBox(
     const ShapeBox &box1, const XMMATRIX &box1Transform,
     const ShapeBox &box2, const XMMATRIX &box2Transform)
 {
-    // Get transformed min and max points of box1
+    // Get transformed min and max points of box1, the same way as BoxPairBatch does
     XMFLOAT3 box1MinTransformed, box1MaxTransformed;
-    XMStoreFloat3(&box1MinTransformed, XMVector3Transform(XMLoadFloat3(&box1.GetMin()), box1Transform));
-    XMStoreFloat3(&box1MaxTransformed, XMVector3Transform(XMLoadFloat3(&box1.GetMax()), box1Transform));
+    GetTransformedBoxMinMax(box1, box1Transform, box1MinTransformed, box1MaxTransformed);
 
     // Get transformed min and max points of box2
     XMFLOAT3 box2MinTransformed, box2MaxTransformed;
-    XMStoreFloat3(&box2MinTransformed, XMVector3Transform(XMLoadFloat3(&box2.GetMin()), box2Transform));
-    XMStoreFloat3(&box2MaxTransformed, XMVector3Transform(XMLoadFloat3(&box2.GetMax()), box2Transform));
+    GetTransformedBoxMinMax(box2, box2Transform, box2MinTransformed, box2MaxTransformed);
 
     // Check for overlap on all axes
     bool overlapX = (box1MinTransformed.x <= box2MaxTransformed.x) && (box1MaxTransformed.x >= box2MinTransformed.x);
@@ -12,66 +12,15 @@ using namespace DirectX;
 #include "mono_physics/include/component_rigid_body.h"
 #include "mono_physics/include/component_box_collider.h"
 
+#include "mono_physics/include/shape_utils.h"
+#include "mono_physics/include/broadphase_sweep_and_prune.h"
 #include "mono_physics/include/detector_box_vs_box.h"
 #include "mono_physics/include/resolver_box.h"
 
-namespace system_physics
-{
-
-class EntityPair
-{
-public:
-    EntityPair(const riaecs::Entity &entityA, const riaecs::Entity &entityB)
-        : entityA_(entityA), entityB_(entityB) {}
-
-    const riaecs::Entity &GetEntityA() const { return entityA_; }
-    const riaecs::Entity &GetEntityB() const { return entityB_; }
-
-    bool operator==(const EntityPair &other) const
-    {
-        auto a1 = entityA_.GetIndex();
-        auto b1 = entityB_.GetIndex();
-        auto a2 = other.entityA_.GetIndex();
-        auto b2 = other.entityB_.GetIndex();
-
-        return (a1 == a2 && b1 == b2) || (a1 == b2 && b1 == a2);
-    }
-
-private:
-    riaecs::Entity entityA_;
-    riaecs::Entity entityB_;
-};
-
-} // namespace system_physics
-
-namespace std
-{
-    template <>
-    struct hash<system_physics::EntityPair>
-    {
-        std::size_t operator()(const system_physics::EntityPair &pair) const noexcept
-        {
-            auto makeKey = [](const riaecs::Entity& e) {
-                size_t i = e.GetIndex();
-                size_t g = e.GetGeneration();
-                std::size_t h1 = std::hash<size_t>()(i);
-                std::size_t h2 = std::hash<size_t>()(g);
-                return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
-            };
-
-            auto keyA = makeKey(pair.GetEntityA());
-            auto keyB = makeKey(pair.GetEntityB());
-            if (keyA > keyB) std::swap(keyA, keyB);
-
-            std::size_t h1 = keyA;
-            std::size_t h2 = keyB;
-            return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
-        }
-    };
-}
+#include <algorithm>
 
 mono_physics::SystemPhysics::SystemPhysics() :
-    spatialGrid_(girdCellSize_)
+    broadphase_(std::make_unique<mono_physics::BroadphaseSweepAndPrune>())
 {
     // Register collision detectors  
 
@@ -104,10 +53,10 @@ bool mono_physics::SystemPhysics::Update
     deltaTimeProvider_.UpdateTime();
     float deltaTime = deltaTimeProvider_.GetDeltaTime();
 
-    // Clear spatial grid
-    spatialGrid_.Clear();
+    // Begin updating broadphase
+    broadphase_->BeginUpdate();
 
-    // Register all colliders to spatial grid
+    // Register all colliders to broadphase
     // And also store velocity in rigid body, clear previous collision results
     for (const riaecs::Entity &entity : ecsWorld.View(mono_physics::ComponentRigidBodyID())())
     {
@@ -141,8 +90,11 @@ bool mono_physics::SystemPhysics::Update
         // Get bounding box
         const mono_physics::ShapeBox &boundingBox = collider->GetBoundingBox();
 
-        // Register to spatial grid
-        spatialGrid_.RegisterAABB(entity, boundingBox, transform->GetWorldMatrixNoRot());
+        // Register to broadphase
+        XMFLOAT3 boundingBoxMin, boundingBoxMax;
+        mono_physics::GetTransformedBoxMinMax(
+            boundingBox, transform->GetWorldMatrixNoRot(), boundingBoxMin, boundingBoxMax);
+        broadphase_->UpdateBody(entity, boundingBoxMin, boundingBoxMax);
 
         // Store velocity in rigid body for later use
         XMFLOAT3 velocity = XMFLOAT3(
@@ -155,84 +107,65 @@ bool mono_physics::SystemPhysics::Update
         collider->GetCollisionResult().Clear();
     }
 
-    // Query potential collisions
-    std::unordered_set<system_physics::EntityPair> potentialCollisionPairs;
-    for (const riaecs::Entity &entity : ecsWorld.View(mono_physics::ComponentRigidBodyID())())
-    {
-        // Get the identity component
-        mono_identity::ComponentIdentity *identity
-        = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-            ecsWorld, entity, mono_identity::ComponentIdentityID(), "ComponentIdentity", RIAECS_LOG_LOC);
-            
-        if (!identity->IsActiveSelf()) // Skip if not active
-            continue;
-
-        mono_physics::ComponentRigidBody *rigidBody
-        = riaecs::GetComponentWithCheck<mono_physics::ComponentRigidBody>(
-            ecsWorld, entity, mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
-
-        // Check if the entity has a collider attached
-        size_t colliderComponentID = 0;
-        bool hasCollider = rigidBody->GetAttachedColliderComponentID(colliderComponentID);
-        assert(hasCollider); // Rigid body must have a collider attached
-
-        // If it has a collider, get the collider component
-        mono_physics::Collider *collider 
-            = riaecs::GetComponentWithCheck<mono_physics::Collider>(
-                ecsWorld, entity, colliderComponentID, "Collider", RIAECS_LOG_LOC);
+    // End updating broadphase, the bodies which were not registered are removed
+    broadphase_->EndUpdate();
 
-        // Get the transform component
-        mono_transform::ComponentTransform *transform
-        = riaecs::GetComponentWithCheck<mono_transform::ComponentTransform>(
-            ecsWorld, entity, mono_transform::ComponentTransformID(), "ComponentTransform", RIAECS_LOG_LOC);
-
-        // Get bounding box
-        const mono_physics::ShapeBox &boundingBox = collider->GetBoundingBox();
-
-        // Query potential collisions
-        std::vector<riaecs::Entity> potentialCollisions 
-            = spatialGrid_.QueryNearby(entity, boundingBox, transform->GetWorldMatrixNoRot());
-
-        // Get collidable component IDs
-        const std::vector<size_t> &collidableComponentIDs = collider->GetCollidableComponentIDs();
+    // Filter potential collisions by collidable component IDs
+    potentialCollisionPairs_.clear();
+    for (const mono_physics::BroadphasePair &broadphasePair : broadphase_->GetPairs())
+    {
+        assert(broadphasePair.entityA != broadphasePair.entityB); // Should not be the same entity
 
-        for (const riaecs::Entity &other : potentialCollisions)
+        // Check both directions, the entity whose collidable component IDs match comes first
+        const riaecs::Entity *entities[2] = { &broadphasePair.entityA, &broadphasePair.entityB };
+        for (int i = 0; i < 2; ++i)
         {
-            assert(other != entity); // Should not be the same entity
+            const riaecs::Entity &entity = *entities[i];
+            const riaecs::Entity &other = *entities[1 - i];
 
-            // Check if the other entity has a collider attached
-            mono_physics::ComponentRigidBody *otherRigidBody
+            mono_physics::ComponentRigidBody *rigidBody
             = riaecs::GetComponentWithCheck<mono_physics::ComponentRigidBody>(
-                ecsWorld, other, mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
+                ecsWorld, entity, mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
 
-            size_t otherColliderComponentID = 0;
-            bool otherHasCollider = otherRigidBody->GetAttachedColliderComponentID(otherColliderComponentID);
-            assert(otherHasCollider); // Other rigid body must have a collider attached
+            // Check if the entity has a collider attached
+            size_t colliderComponentID = 0;
+            bool hasCollider = rigidBody->GetAttachedColliderComponentID(colliderComponentID);
+            assert(hasCollider); // Rigid body must have a collider attached
+
+            // If it has a collider, get the collider component
+            mono_physics::Collider *collider 
+                = riaecs::GetComponentWithCheck<mono_physics::Collider>(
+                    ecsWorld, entity, colliderComponentID, "Collider", RIAECS_LOG_LOC);
 
             // Check if the other entity has any of the collidable component IDs
-            for (size_t id : collidableComponentIDs)
+            bool isCollidable = false;
+            for (size_t id : collider->GetCollidableComponentIDs())
             {
                 if (ecsWorld.HasComponent(other, id))
                 {
-                    // Create entity pair
-                    system_physics::EntityPair pair(entity, other);
-
-                    // Add to potential collision pairs
-                    potentialCollisionPairs.insert(pair);
-
+                    isCollidable = true;
                     break; // No need to check further
                 }
             }
+
+            if (isCollidable)
+            {
+                // Add to potential collision pairs
+                potentialCollisionPairs_.push_back({ entity, other });
+                break; // Added once per pair
+            }
         }
     }
 
-    // Narrowphase collision detection
-    std::unordered_set<riaecs::Entity> collidedEntities;
-    for (const system_physics::EntityPair& pair : potentialCollisionPairs)
+    // Bucket the potential collision pairs by their collider types
+    for (NarrowphaseBucket &bucket : narrowphaseBuckets_)
+        bucket.pairs.clear();
+
+    for (const mono_physics::BroadphasePair& pair : potentialCollisionPairs_)
     {
         mono_physics::ComponentRigidBody *rigidBody
         = riaecs::GetComponentWithCheck<mono_physics::ComponentRigidBody>(
-            ecsWorld, pair.GetEntityA(), mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityA, mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
 
         // Get the collider component
         size_t colliderComponentID = 0;
@@ -241,7 +174,7 @@ bool mono_physics::SystemPhysics::Update
 
         mono_physics::ComponentRigidBody *otherRigidBody
         = riaecs::GetComponentWithCheck<mono_physics::ComponentRigidBody>(
-            ecsWorld, pair.GetEntityB(), mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityB, mono_physics::ComponentRigidBodyID(), "ComponentRigidBody", RIAECS_LOG_LOC);
 
         // Get the other collider component
         size_t otherColliderComponentID = 0;
@@ -250,55 +183,50 @@ bool mono_physics::SystemPhysics::Update
 
         // Get the collider components
         mono_physics::Collider *colliderA = riaecs::GetComponentWithCheck<mono_physics::Collider>(
-            ecsWorld, pair.GetEntityA(), colliderComponentID, "Collider", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityA, colliderComponentID, "Collider", RIAECS_LOG_LOC);
         mono_physics::Collider *colliderB = riaecs::GetComponentWithCheck<mono_physics::Collider>(
-            ecsWorld, pair.GetEntityB(), otherColliderComponentID, "Collider", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityB, otherColliderComponentID, "Collider", RIAECS_LOG_LOC);
 
         // Get the transform components
         mono_transform::ComponentTransform *transformA
         = riaecs::GetComponentWithCheck<mono_transform::ComponentTransform>(
-            ecsWorld, pair.GetEntityA(), mono_transform::ComponentTransformID(), "ComponentTransform", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityA, mono_transform::ComponentTransformID(), "ComponentTransform", RIAECS_LOG_LOC);
         mono_transform::ComponentTransform *transformB
         = riaecs::GetComponentWithCheck<mono_transform::ComponentTransform>(
-            ecsWorld, pair.GetEntityB(), mono_transform::ComponentTransformID(), "ComponentTransform", RIAECS_LOG_LOC);
+            ecsWorld, pair.entityB, mono_transform::ComponentTransformID(), "ComponentTransform", RIAECS_LOG_LOC);
 
-        // Create collider pair
+        // Find the bucket of the collider pair, there are only a few collider types
         mono_physics::ColliderPair colliderPair(colliderComponentID, otherColliderComponentID);
+        auto bucket = std::find_if(narrowphaseBuckets_.begin(), narrowphaseBuckets_.end(),
+            [&colliderPair](const NarrowphaseBucket &bucket) { return bucket.colliderPair == colliderPair; });
 
-        // Get the collision detector
-        mono_physics::CollisionDetector& detector = collisionDetectorRegistry_.Get(colliderPair);
-
-        bool playerDetected = false;
-
-        // Get identity component
-        mono_identity::ComponentIdentity *identityA
-        = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-            ecsWorld, pair.GetEntityA(), mono_identity::ComponentIdentityID(), "ComponentIdentity", RIAECS_LOG_LOC);
-
-        if (identityA->GetName() == "Player")
-            playerDetected = true;
-
-        mono_identity::ComponentIdentity *identityB
-        = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-            ecsWorld, pair.GetEntityB(), mono_identity::ComponentIdentityID(), "ComponentIdentity", RIAECS_LOG_LOC);
+        if (bucket == narrowphaseBuckets_.end())
+        {
+            // Get the collision detector
+            narrowphaseBuckets_.push_back({ colliderPair, &collisionDetectorRegistry_.Get(colliderPair) });
+            bucket = narrowphaseBuckets_.end() - 1;
+        }
 
-        if (identityB->GetName() == "Player")
-            playerDetected = true;
+        bucket->pairs.push_back({ pair.entityA, colliderA, transformA, pair.entityB, colliderB, transformB });
+    }
 
-        // Detect collision
-        bool isColliding = detector.DetectCollisions(
-            pair.GetEntityA(), *colliderA, *transformA,
-            pair.GetEntityB(), *colliderB, *transformB);
+    // Narrowphase collision detection, a batch per collider pair type
+    std::unordered_set<riaecs::Entity> collidedEntities;
+    for (NarrowphaseBucket &bucket : narrowphaseBuckets_)
+    {
+        if (bucket.pairs.empty())
+            continue;
 
-        if (isColliding && playerDetected)
-        {
-            int a = 0;
-        }
+        // Detect collisions
+        bucket.detector->DetectCollisionsBatch(bucket.pairs, isColliding_);
 
-        if (isColliding) // If colliding, add to the collided entities
+        for (size_t i = 0; i < bucket.pairs.size(); ++i)
         {
-            collidedEntities.insert(pair.GetEntityA());
-            collidedEntities.insert(pair.GetEntityB());
+            if (isColliding_[i]) // If colliding, add to the collided entities
+            {
+                collidedEntities.insert(bucket.pairs[i].entityA);
+                collidedEntities.insert(bucket.pairs[i].entityB);
+            }
         }
     }
 
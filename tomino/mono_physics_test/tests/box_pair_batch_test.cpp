@@ -0,0 +1,195 @@
+﻿#include "mono_physics_test/pch.h"
+
+#include "mono_physics/include/box_pair_batch.h"
+#include "mono_physics/include/shape_utils.h"
+#pragma comment(lib, "mono_physics.lib")
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace box_pair_batch_test
+{
+    struct TestBox
+    {
+        mono_physics::ShapeBox box;
+        XMMATRIX transform;
+    };
+
+    // Create boxes placed on a coarse lattice, so many pairs touch exactly on a face
+    std::vector<TestBox> CreateBoxes(size_t count, std::mt19937 &random)
+    {
+        std::uniform_int_distribution<int> latticeDist(-4, 4);
+        std::uniform_int_distribution<int> sizeDist(1, 3);
+        std::uniform_real_distribution<float> scaleDist(0.5f, 2.0f);
+        std::uniform_int_distribution<int> uniformScaleDist(0, 1);
+
+        std::vector<TestBox> boxes(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMFLOAT3 min = XMFLOAT3(
+                static_cast<float>(latticeDist(random)), 
+                static_cast<float>(latticeDist(random)), 
+                static_cast<float>(latticeDist(random)));
+            boxes[i].box.SetMin(min);
+            boxes[i].box.SetMax(XMFLOAT3(
+                min.x + static_cast<float>(sizeDist(random)),
+                min.y + static_cast<float>(sizeDist(random)),
+                min.z + static_cast<float>(sizeDist(random))));
+
+            // The world matrix without rotation, as the physics system passes
+            float scale = uniformScaleDist(random) ? 1.0f : scaleDist(random);
+            boxes[i].transform = 
+                XMMatrixScaling(scale, scale, scale) *
+                XMMatrixTranslation(
+                    static_cast<float>(latticeDist(random)), 
+                    static_cast<float>(latticeDist(random)), 
+                    static_cast<float>(latticeDist(random)));
+        }
+        return boxes;
+    }
+
+    void AddPairs(
+        mono_physics::BoxPairBatch &batch, const std::vector<TestBox> &boxesA, const std::vector<TestBox> &boxesB)
+    {
+        batch.Clear();
+        for (size_t i = 0; i < boxesA.size(); ++i)
+            batch.Add(boxesA[i].box, boxesA[i].transform, boxesB[i].box, boxesB[i].transform);
+    }
+
+} // namespace box_pair_batch_test
+
+TEST(BoxPairBatch, SameAsIsBoxIntersectBox)
+{
+    std::cout << "Instruction set: ";
+    switch (mono_physics::GetBoxPairBatchInstructionSet())
+    {
+    case mono_physics::BoxPairBatchInstructionSet::Scalar: std::cout << "Scalar" << std::endl; break;
+    case mono_physics::BoxPairBatchInstructionSet::SSE: std::cout << "SSE" << std::endl; break;
+    case mono_physics::BoxPairBatchInstructionSet::AVX: std::cout << "AVX" << std::endl; break;
+    }
+
+    std::mt19937 random(5);
+    mono_physics::BoxPairBatch batch;
+    std::vector<uint8_t> intersects;
+    std::vector<uint8_t> scalarIntersects;
+
+    // Counts around the lane widths, so full blocks and every tail length are covered
+    std::vector<size_t> counts;
+    for (size_t count = 0; count <= 37; ++count)
+        counts.push_back(count);
+    counts.push_back(10000);
+
+    for (size_t count : counts)
+    {
+        std::vector<box_pair_batch_test::TestBox> boxesA = box_pair_batch_test::CreateBoxes(count, random);
+        std::vector<box_pair_batch_test::TestBox> boxesB = box_pair_batch_test::CreateBoxes(count, random);
+        box_pair_batch_test::AddPairs(batch, boxesA, boxesB);
+        ASSERT_EQ(batch.GetCount(), count);
+
+        size_t intersectCount = batch.Intersect(intersects);
+        ASSERT_EQ(intersects.size(), count);
+
+        size_t expectedCount = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool expected = mono_physics::IsBoxIntersectBox(
+                boxesA[i].box, boxesA[i].transform, boxesB[i].box, boxesB[i].transform);
+            EXPECT_EQ(intersects[i] != 0, expected) << "count " << count << ", pair " << i;
+            expectedCount += expected ? 1 : 0;
+        }
+        EXPECT_EQ(intersectCount, expectedCount) << "count " << count;
+
+        EXPECT_EQ(batch.IntersectScalar(scalarIntersects), intersectCount) << "count " << count;
+        EXPECT_EQ(scalarIntersects, intersects) << "count " << count;
+    }
+}
+
+TEST(BoxPairBatch, Touching)
+{
+    // Boxes sharing a face, an edge or a corner intersect, as IsBoxIntersectBox treats them
+    mono_physics::ShapeBox box;
+    box.SetMin(XMFLOAT3(0.0f, 0.0f, 0.0f));
+    box.SetMax(XMFLOAT3(1.0f, 1.0f, 1.0f));
+
+    std::vector<XMFLOAT3> offsets = {
+        XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 0.0f), 
+        XMFLOAT3(-1.0f, -1.0f, -1.0f), XMFLOAT3(1.001f, 0.0f, 0.0f), XMFLOAT3(0.5f, 0.5f, 0.5f), 
+        XMFLOAT3(0.0f, 0.0f, -1.001f), XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(2.0f, 2.0f, 2.0f) };
+
+    mono_physics::BoxPairBatch batch;
+    for (const XMFLOAT3 &offset : offsets)
+        batch.Add(box, XMMatrixIdentity(), box, XMMatrixTranslation(offset.x, offset.y, offset.z));
+
+    std::vector<uint8_t> intersects;
+    EXPECT_EQ(batch.Intersect(intersects), 6);
+
+    std::vector<uint8_t> expected = { 1, 1, 1, 1, 0, 1, 0, 1, 0 };
+    EXPECT_EQ(intersects, expected);
+
+    // Clearing keeps nothing from the previous pairs
+    batch.Clear();
+    EXPECT_EQ(batch.GetCount(), 0);
+    EXPECT_EQ(batch.Intersect(intersects), 0);
+    EXPECT_TRUE(intersects.empty());
+}
+
+TEST(BoxPairBatch, Benchmark)
+{
+    constexpr size_t PAIR_COUNT = 100000;
+    constexpr size_t REPEAT = 20;
+
+    std::mt19937 random(9);
+    std::vector<box_pair_batch_test::TestBox> boxesA = box_pair_batch_test::CreateBoxes(PAIR_COUNT, random);
+    std::vector<box_pair_batch_test::TestBox> boxesB = box_pair_batch_test::CreateBoxes(PAIR_COUNT, random);
+
+    mono_physics::BoxPairBatch batch;
+    batch.Reserve(PAIR_COUNT);
+    std::vector<uint8_t> intersects;
+
+    // One pair at a time, as DetectorBoxVsBox::DetectCollisions does
+    size_t scalarCount = 0;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (size_t i = 0; i < PAIR_COUNT; ++i)
+        {
+            if (mono_physics::IsBoxIntersectBox(boxesA[i].box, boxesA[i].transform, boxesB[i].box, boxesB[i].transform))
+                ++scalarCount;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double scalarNs = std::chrono::duration<double, std::nano>(end - begin).count() / (REPEAT * PAIR_COUNT);
+
+    // Gathering the transformed boxes and testing them in a batch, as DetectCollisionsBatch does
+    size_t batchCount = 0;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        box_pair_batch_test::AddPairs(batch, boxesA, boxesB);
+        batchCount += batch.Intersect(intersects);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double batchNs = std::chrono::duration<double, std::nano>(end - begin).count() / (REPEAT * PAIR_COUNT);
+
+    // The overlap test alone, scalar and SIMD
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+        batch.IntersectScalar(intersects);
+    end = std::chrono::high_resolution_clock::now();
+    double overlapScalarNs = std::chrono::duration<double, std::nano>(end - begin).count() / (REPEAT * PAIR_COUNT);
+
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+        batch.Intersect(intersects);
+    end = std::chrono::high_resolution_clock::now();
+    double overlapSimdNs = std::chrono::duration<double, std::nano>(end - begin).count() / (REPEAT * PAIR_COUNT);
+
+    EXPECT_EQ(scalarCount, batchCount);
+    std::cout << "Pairs: " << PAIR_COUNT << ", intersecting: " << scalarCount / REPEAT << std::endl;
+    std::cout << "Per pair, IsBoxIntersectBox: " << scalarNs << " ns, batch with gather: " << batchNs << " ns" << std::endl;
+    std::cout << "Per pair, overlap test scalar: " << overlapScalarNs << " ns, SIMD: " << overlapSimdNs << " ns" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,272 @@
+﻿#include "mono_physics_test/pch.h"
+
+#include "mono_physics/include/broadphase_grid.h"
+#include "mono_physics/include/broadphase_sweep_and_prune.h"
+#include "mono_physics/include/shape_utils.h"
+#pragma comment(lib, "mono_physics.lib")
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace DirectX;
+
+namespace broadphase_test
+{
+    struct TestBody
+    {
+        riaecs::Entity entity;
+        XMFLOAT3 min;
+        XMFLOAT3 max;
+        bool isActive = true;
+    };
+
+    // Create bodies of random sizes, some of them are larger than a grid cell
+    std::vector<TestBody> CreateBodies(size_t count, float range, std::mt19937 &random)
+    {
+        std::uniform_real_distribution<float> posDist(-range, range);
+        std::uniform_real_distribution<float> sizeDist(0.1f, 4.0f);
+        std::uniform_real_distribution<float> largeSizeDist(4.0f, 25.0f);
+        std::uniform_int_distribution<int> largeDist(0, 19);
+
+        std::vector<TestBody> bodies(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float size = (largeDist(random) == 0) ? largeSizeDist(random) : sizeDist(random);
+            bodies[i].entity = riaecs::Entity(i, 0);
+            bodies[i].min = XMFLOAT3(posDist(random), posDist(random), posDist(random));
+            bodies[i].max = XMFLOAT3(bodies[i].min.x + size, bodies[i].min.y + size, bodies[i].min.z + size);
+        }
+        return bodies;
+    }
+
+    // Move a body by the offset
+    void MoveBody(TestBody &body, const XMFLOAT3 &offset)
+    {
+        body.min = XMFLOAT3(body.min.x + offset.x, body.min.y + offset.y, body.min.z + offset.z);
+        body.max = XMFLOAT3(body.max.x + offset.x, body.max.y + offset.y, body.max.z + offset.z);
+    }
+
+    // Update the broadphase with the active bodies
+    void UpdateBroadphase(mono_physics::Broadphase &broadphase, const std::vector<TestBody> &bodies)
+    {
+        broadphase.BeginUpdate();
+        for (const TestBody &body : bodies)
+        {
+            if (body.isActive)
+                broadphase.UpdateBody(body.entity, body.min, body.max);
+        }
+        broadphase.EndUpdate();
+    }
+
+    // Check the AABB overlap with IsBoxIntersectBox, which the narrowphase uses
+    bool IsOverlapped(const TestBody &bodyA, const TestBody &bodyB)
+    {
+        mono_physics::ShapeBox boxA;
+        boxA.SetMin(bodyA.min);
+        boxA.SetMax(bodyA.max);
+
+        mono_physics::ShapeBox boxB;
+        boxB.SetMin(bodyB.min);
+        boxB.SetMax(bodyB.max);
+
+        return mono_physics::IsBoxIntersectBox(boxA, XMMatrixIdentity(), boxB, XMMatrixIdentity());
+    }
+
+    // Keep only the grid pairs whose AABBs overlap
+    std::vector<mono_physics::BroadphasePair> FilterOverlappedPairs(
+        const std::vector<mono_physics::BroadphasePair> &pairs, const std::vector<TestBody> &bodies)
+    {
+        std::vector<mono_physics::BroadphasePair> overlappedPairs;
+        for (const mono_physics::BroadphasePair &pair : pairs)
+        {
+            if (IsOverlapped(bodies[pair.entityA.GetIndex()], bodies[pair.entityB.GetIndex()]))
+                overlappedPairs.push_back(pair);
+        }
+        return overlappedPairs;
+    }
+
+} // namespace broadphase_test
+
+TEST(Broadphase, SweepAndPruneMatchesGrid)
+{
+    std::mt19937 random(1234);
+    std::vector<broadphase_test::TestBody> bodies = broadphase_test::CreateBodies(1000, 60.0f, random);
+
+    mono_physics::BroadphaseGrid grid(10.0f);
+    mono_physics::BroadphaseSweepAndPrune sweepAndPrune;
+
+    std::uniform_real_distribution<float> moveDist(-1.5f, 1.5f);
+    std::uniform_int_distribution<int> activeDist(0, 9);
+
+    size_t totalPairCount = 0;
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        // Move bodies, and activate or deactivate some of them
+        for (broadphase_test::TestBody &body : bodies)
+        {
+            broadphase_test::MoveBody(body, XMFLOAT3(moveDist(random), moveDist(random), moveDist(random)));
+            if (frame != 0 && activeDist(random) == 0)
+                body.isActive = !body.isActive;
+        }
+
+        broadphase_test::UpdateBroadphase(grid, bodies);
+        broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+
+        const std::vector<mono_physics::BroadphasePair> &gridPairs = grid.GetPairs();
+        const std::vector<mono_physics::BroadphasePair> &sweepAndPrunePairs = sweepAndPrune.GetPairs();
+
+        // Pairs must be sorted and unique
+        EXPECT_TRUE(std::is_sorted(sweepAndPrunePairs.begin(), sweepAndPrunePairs.end()));
+        EXPECT_EQ(
+            std::adjacent_find(sweepAndPrunePairs.begin(), sweepAndPrunePairs.end()), sweepAndPrunePairs.end());
+
+        // Every pair from sweep and prune must be found by the grid
+        EXPECT_TRUE(std::includes(
+            gridPairs.begin(), gridPairs.end(), sweepAndPrunePairs.begin(), sweepAndPrunePairs.end()));
+
+        // The grid pairs whose AABBs overlap must be the same as sweep and prune
+        ASSERT_EQ(broadphase_test::FilterOverlappedPairs(gridPairs, bodies), sweepAndPrunePairs)
+            << "Frame: " << frame;
+
+        // Inactive bodies must not appear
+        for (const mono_physics::BroadphasePair &pair : sweepAndPrunePairs)
+        {
+            EXPECT_LT(pair.entityA, pair.entityB);
+            EXPECT_TRUE(bodies[pair.entityA.GetIndex()].isActive);
+            EXPECT_TRUE(bodies[pair.entityB.GetIndex()].isActive);
+        }
+
+        totalPairCount += sweepAndPrunePairs.size();
+    }
+
+    EXPECT_GT(totalPairCount, 0);
+}
+
+TEST(Broadphase, SweepAndPruneTouching)
+{
+    mono_physics::BroadphaseSweepAndPrune sweepAndPrune;
+
+    std::vector<broadphase_test::TestBody> bodies(4);
+    for (size_t i = 0; i < bodies.size(); ++i)
+        bodies[i].entity = riaecs::Entity(i, 0);
+
+    // Touching on the x axis face
+    bodies[0].min = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    bodies[0].max = XMFLOAT3(1.0f, 1.0f, 1.0f);
+    bodies[1].min = XMFLOAT3(1.0f, 0.0f, 0.0f);
+    bodies[1].max = XMFLOAT3(2.0f, 1.0f, 1.0f);
+
+    // Overlapping on the x axis only
+    bodies[2].min = XMFLOAT3(0.5f, 5.0f, 0.0f);
+    bodies[2].max = XMFLOAT3(1.5f, 6.0f, 1.0f);
+
+    // Same min x as body 0, overlapping it on all axes
+    bodies[3].min = XMFLOAT3(0.0f, 0.5f, 0.5f);
+    bodies[3].max = XMFLOAT3(0.2f, 0.7f, 0.7f);
+
+    broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+
+    std::vector<mono_physics::BroadphasePair> expected =
+    {
+        { bodies[0].entity, bodies[1].entity },
+        { bodies[0].entity, bodies[3].entity },
+    };
+    EXPECT_EQ(sweepAndPrune.GetPairs(), expected);
+
+    for (const mono_physics::BroadphasePair &pair : sweepAndPrune.GetPairs())
+        EXPECT_TRUE(broadphase_test::IsOverlapped(bodies[pair.entityA.GetIndex()], bodies[pair.entityB.GetIndex()]));
+
+    // Removing body 0 removes its pairs
+    bodies[0].isActive = false;
+    broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+    EXPECT_TRUE(sweepAndPrune.GetPairs().empty());
+    EXPECT_EQ(sweepAndPrune.GetBodyCount(), 3);
+
+    // Adding it back with a new generation is a new body
+    bodies[0].isActive = true;
+    bodies[0].entity = riaecs::Entity(0, 1);
+    broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+    EXPECT_EQ(sweepAndPrune.GetPairs().size(), 2);
+    EXPECT_EQ(sweepAndPrune.GetBodyCount(), 4);
+}
+
+TEST(Broadphase, SweepAndPruneReusesBuffers)
+{
+    std::mt19937 random(5678);
+    std::vector<broadphase_test::TestBody> bodies = broadphase_test::CreateBodies(500, 30.0f, random);
+
+    mono_physics::BroadphaseSweepAndPrune sweepAndPrune;
+    broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+    ASSERT_FALSE(sweepAndPrune.GetPairs().empty());
+
+    // Same bodies at the same place keep the pair buffer
+    const mono_physics::BroadphasePair *pairData = sweepAndPrune.GetPairs().data();
+    size_t pairCount = sweepAndPrune.GetPairs().size();
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        broadphase_test::UpdateBroadphase(sweepAndPrune, bodies);
+        EXPECT_EQ(sweepAndPrune.GetPairs().data(), pairData);
+        EXPECT_EQ(sweepAndPrune.GetPairs().size(), pairCount);
+    }
+}
+
+TEST(Broadphase, Benchmark)
+{
+    for (size_t bodyCount : { 1000, 10000 })
+    {
+        // Keep the density of the bodies the same
+        float range = 60.0f * std::cbrt(static_cast<float>(bodyCount) / 1000.0f);
+
+        std::mt19937 random(static_cast<unsigned int>(bodyCount));
+        std::vector<broadphase_test::TestBody> bodies = broadphase_test::CreateBodies(bodyCount, range, random);
+
+        // Velocities of the bodies, a quarter of them are static
+        std::uniform_real_distribution<float> velocityDist(-0.2f, 0.2f);
+        std::vector<XMFLOAT3> velocities(bodyCount, XMFLOAT3(0.0f, 0.0f, 0.0f));
+        for (size_t i = 0; i < bodyCount; ++i)
+        {
+            if (i % 4 != 0)
+                velocities[i] = XMFLOAT3(velocityDist(random), velocityDist(random), velocityDist(random));
+        }
+
+        // Measure the average time of a frame
+        const int frameCount = 60;
+        auto measure = [&](mono_physics::Broadphase &broadphase, size_t &pairCount)
+        {
+            std::vector<broadphase_test::TestBody> frameBodies = bodies;
+            broadphase_test::UpdateBroadphase(broadphase, frameBodies); // Warm up
+
+            std::chrono::nanoseconds total(0);
+            for (int frame = 0; frame < frameCount; ++frame)
+            {
+                for (size_t i = 0; i < bodyCount; ++i)
+                    broadphase_test::MoveBody(frameBodies[i], velocities[i]);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                broadphase_test::UpdateBroadphase(broadphase, frameBodies);
+                auto end = std::chrono::high_resolution_clock::now();
+                total += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+            }
+
+            pairCount = broadphase.GetPairs().size();
+            return std::chrono::duration<double, std::milli>(total).count() / frameCount;
+        };
+
+        size_t gridPairCount = 0;
+        mono_physics::BroadphaseGrid grid(10.0f);
+        double gridMs = measure(grid, gridPairCount);
+
+        size_t sweepAndPrunePairCount = 0;
+        mono_physics::BroadphaseSweepAndPrune sweepAndPrune;
+        double sweepAndPruneMs = measure(sweepAndPrune, sweepAndPrunePairCount);
+
+        EXPECT_LE(sweepAndPrunePairCount, gridPairCount);
+
+        std::cout << "Bodies: " << bodyCount
+            << ", grid: " << gridMs << " ms (" << gridPairCount << " pairs)"
+            << ", sweep and prune: " << sweepAndPruneMs << " ms (" << sweepAndPrunePairCount << " pairs)"
+            << std::endl;
+    }
+}
\ No newline at end of file
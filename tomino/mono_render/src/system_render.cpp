@@ -530,6 +530,43 @@ void DrawScene(RenderContext& draw_context)
         command_set_handle, window_render_bind_component->GetSwapChainHandle(), std::move(ui_draw_func));
 }
 
+// Report the entities which have the component but lack the components it requires
+// The query of the component with the required components matched matched_count entities
+void CheckRequiredComponents(
+    riaecs::IECSWorld& ecsWorld, size_t component_id, size_t matched_count,
+    std::string_view component_name, std::string_view required_component_names)
+{
+    const size_t entity_count = ecsWorld.View(component_id)().size();
+    if (matched_count == entity_count)
+        return; // Every entity has the required components
+
+    riaecs::NotifyError({
+        std::to_string(entity_count - matched_count) + " entities with " + std::string(component_name) 
+            + " component do not have " + std::string(required_component_names) + " component.",
+        "This error occurs when an Entity does not have a component that it must have."
+    }, RIAECS_LOG_LOC);
+}
+
+// Store the active light entities with the light component under their scene entity
+template <typename LIGHT_COMPONENT>
+void GatherLights(
+    riaecs::IECSWorld& ecsWorld, size_t component_id, std::string_view component_name,
+    std::unordered_map<riaecs::Entity, std::vector<std::pair<size_t, riaecs::Entity>>>& scene_to_lights_map)
+{
+    riaecs::Query<LIGHT_COMPONENT, mono_identity::ComponentIdentity, mono_scene::ComponentSceneTag> light_query(
+        ecsWorld, { component_id, mono_identity::ComponentIdentityID(), mono_scene::ComponentSceneTagID() });
+    CheckRequiredComponents(ecsWorld, component_id, light_query.GetCount(), component_name, "Identity and SceneTag");
+
+    for (auto [entity, light_component, identity_component, scene_tag_component] : light_query)
+    {
+        if (identity_component->IsActiveSelf() == false)
+            continue; // Skip inactive lights
+
+        // Store light entity under its scene entity
+        scene_to_lights_map[scene_tag_component->GetSceneEntity()].emplace_back(component_id, entity);
+    }
+}
+
 } // namespace mono_render
 
 mono_render::SystemRender::SystemRender()
@@ -573,42 +610,30 @@ bool mono_render::SystemRender::Update(
 
     // Iterate through all entities with WindowComponent
     std::unordered_map<riaecs::Entity, riaecs::Entity> window_to_scene_map;
-    for (const riaecs::Entity& entity : ecsWorld.View(mono_d3d12::ComponentWindowD3D12ID())())
+    riaecs::Query<mono_d3d12::ComponentWindowD3D12, mono_identity::ComponentIdentity> window_query(
+        ecsWorld, { mono_d3d12::ComponentWindowD3D12ID(), mono_identity::ComponentIdentityID() });
+    CheckRequiredComponents(
+        ecsWorld, mono_d3d12::ComponentWindowD3D12ID(), window_query.GetCount(), "WindowD3D12", "Identity");
+    for (auto [entity, window_component, identity_component] : window_query)
     {
-        // Get ComponentIdentity
-        mono_identity::ComponentIdentity* identity_component
-            = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-                ecsWorld, entity, mono_identity::ComponentIdentityID(), "Identity", RIAECS_LOG_LOC);
-
         if (identity_component->IsActiveSelf() == false)
             continue; // Skip inactive windows
 
-        // Get WindowComponent
-        mono_d3d12::ComponentWindowD3D12* window_component
-            = riaecs::GetComponentWithCheck<mono_d3d12::ComponentWindowD3D12>(
-                ecsWorld, entity, mono_d3d12::ComponentWindowD3D12ID(), "WindowD3D12", RIAECS_LOG_LOC);
-
         // Store mapping from window entity to scene entity
         window_to_scene_map[entity] = window_component->GetSceneEntity();
     }
 
     // Iterate through all entities with CameraComponent
     std::unordered_map<riaecs::Entity, riaecs::Entity> scene_to_camera_map;
-    for (const riaecs::Entity& entity : ecsWorld.View(mono_render::ComponentCameraID())())
+    riaecs::Query<mono_render::ComponentCamera, mono_identity::ComponentIdentity, mono_scene::ComponentSceneTag> camera_query(
+        ecsWorld, { mono_render::ComponentCameraID(), mono_identity::ComponentIdentityID(), mono_scene::ComponentSceneTagID() });
+    CheckRequiredComponents(
+        ecsWorld, mono_render::ComponentCameraID(), camera_query.GetCount(), "Camera", "Identity and SceneTag");
+    for (auto [entity, camera_component, identity_component, scene_tag_component] : camera_query)
     {
-        // Get ComponentIdentity
-        mono_identity::ComponentIdentity* identity_component
-            = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-                ecsWorld, entity, mono_identity::ComponentIdentityID(), "Identity", RIAECS_LOG_LOC);
-
         if (identity_component->IsActiveSelf() == false)
             continue; // Skip inactive cameras
 
-        // Get ComponentSceneTag
-        mono_scene::ComponentSceneTag* scene_tag_component
-            = riaecs::GetComponentWithCheck<mono_scene::ComponentSceneTag>(
-                ecsWorld, entity, mono_scene::ComponentSceneTagID(), "SceneTag", RIAECS_LOG_LOC);
-
         // If scene has a main camera already, log warning and skip
         if (scene_to_camera_map.find(scene_tag_component->GetSceneEntity()) != scene_to_camera_map.end())
         {
@@ -623,72 +648,39 @@ bool mono_render::SystemRender::Update(
 
     // Iterate through all entities with ComponentMeshRenderer
     std::unordered_map<riaecs::Entity, std::vector<riaecs::Entity>> scene_to_mesh_renderers_map;
-    for (const riaecs::Entity& entity : ecsWorld.View(mono_render::ComponentMeshRendererID())())
+    riaecs::Query<mono_render::ComponentMeshRenderer, mono_identity::ComponentIdentity, mono_scene::ComponentSceneTag> mesh_renderer_query(
+        ecsWorld, { mono_render::ComponentMeshRendererID(), mono_identity::ComponentIdentityID(), mono_scene::ComponentSceneTagID() });
+    CheckRequiredComponents(
+        ecsWorld, mono_render::ComponentMeshRendererID(), mesh_renderer_query.GetCount(), "MeshRenderer", "Identity and SceneTag");
+    for (auto [entity, mesh_renderer_component, identity_component, scene_tag_component] : mesh_renderer_query)
     {
-        // Get ComponentIdentity
-        mono_identity::ComponentIdentity* identity_component
-            = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-                ecsWorld, entity, mono_identity::ComponentIdentityID(), "Identity", RIAECS_LOG_LOC);
-
         if (identity_component->IsActiveSelf() == false)
             continue; // Skip inactive mesh renderers
 
-        // Get ComponentSceneTag
-        mono_scene::ComponentSceneTag* scene_tag_component
-            = riaecs::GetComponentWithCheck<mono_scene::ComponentSceneTag>(
-                ecsWorld, entity, mono_scene::ComponentSceneTagID(), "SceneTag", RIAECS_LOG_LOC);
-
         // Store mesh renderer entity under its scene entity
         scene_to_mesh_renderers_map[scene_tag_component->GetSceneEntity()].push_back(entity);
     }
 
-    // Prepare all light component ids
-    std::vector<size_t> light_component_ids;
-    light_component_ids.push_back(mono_render::DirectionalLightComponentID());
-    light_component_ids.push_back(mono_render::PointLightComponentID());
-    light_component_ids.push_back(mono_render::AmbientLightComponentID());
-
-    // Iterate through all entities with LightComponent
+    // Iterate through all entities with each LightComponent
     std::unordered_map<riaecs::Entity, std::vector<std::pair<size_t, riaecs::Entity>>> scene_to_lights_map;
-    for (size_t component_id : light_component_ids)
-    {
-        for (const riaecs::Entity& entity : ecsWorld.View(component_id)())
-        {
-            // Get ComponentIdentity
-            mono_identity::ComponentIdentity* identity_component
-                = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-                    ecsWorld, entity, mono_identity::ComponentIdentityID(), "Identity", RIAECS_LOG_LOC);
-
-            if (identity_component->IsActiveSelf() == false)
-                continue; // Skip inactive lights
-
-            // Get ComponentSceneTag
-            mono_scene::ComponentSceneTag* scene_tag_component
-                = riaecs::GetComponentWithCheck<mono_scene::ComponentSceneTag>(
-                    ecsWorld, entity, mono_scene::ComponentSceneTagID(), "SceneTag", RIAECS_LOG_LOC);
-
-            // Store light entity under its scene entity
-            scene_to_lights_map[scene_tag_component->GetSceneEntity()].emplace_back(component_id, entity);
-        }
-    }
+    GatherLights<mono_render::DirectionalLightComponent>(
+        ecsWorld, mono_render::DirectionalLightComponentID(), "DirectionalLight", scene_to_lights_map);
+    GatherLights<mono_render::PointLightComponent>(
+        ecsWorld, mono_render::PointLightComponentID(), "PointLight", scene_to_lights_map);
+    GatherLights<mono_render::AmbientLightComponent>(
+        ecsWorld, mono_render::AmbientLightComponentID(), "AmbientLight", scene_to_lights_map);
 
     // Iterate through all entities with UIComponent
     std::unordered_map<riaecs::Entity, std::vector<std::pair<size_t, riaecs::Entity>>> scene_to_ui_map;
-    for (const riaecs::Entity& entity : ecsWorld.View(mono_render::UIComponentID())())
+    riaecs::Query<mono_render::UIComponent, mono_identity::ComponentIdentity, mono_scene::ComponentSceneTag> ui_query(
+        ecsWorld, { mono_render::UIComponentID(), mono_identity::ComponentIdentityID(), mono_scene::ComponentSceneTagID() });
+    CheckRequiredComponents(
+        ecsWorld, mono_render::UIComponentID(), ui_query.GetCount(), "UI", "Identity and SceneTag");
+    for (auto [entity, ui_component, identity_component, scene_tag_component] : ui_query)
     {
-        // Get ComponentIdentity
-        mono_identity::ComponentIdentity* identity_component
-            = riaecs::GetComponentWithCheck<mono_identity::ComponentIdentity>(
-                ecsWorld, entity, mono_identity::ComponentIdentityID(), "Identity", RIAECS_LOG_LOC);
-
         if (identity_component->IsActiveSelf() == false)
             continue; // Skip inactive UI components
 
-        // Get ComponentSceneTag
-        mono_scene::ComponentSceneTag* scene_tag_component
-            = riaecs::GetComponentWithCheck<mono_scene::ComponentSceneTag>(
-                ecsWorld, entity, mono_scene::ComponentSceneTagID(), "SceneTag", RIAECS_LOG_LOC);
-
         // Store UI entity under its scene entity
         scene_to_ui_map[scene_tag_component->GetSceneEntity()].emplace_back(mono_render::UIComponentID(), entity);
     }
@@ -20,6 +20,8 @@ namespace mono_transform
             riaecs::ISystemLoopCommandQueue &systemLoopCmdQueue
         ) override;
 
+        bool DeclareAccess(riaecs::SystemAccess &access) const override;
+
     private:
         // 何回にかに1回、全てのLastTransformを現在のTransformで更新する
         // その回数を指定する
@@ -68,4 +68,12 @@ bool mono_transform::SystemTransform::Update
     return true; // Continue running
 }
 
+bool mono_transform::SystemTransform::DeclareAccess(riaecs::SystemAccess &access) const
+{
+    // Only updates the transforms, the identity is read to report an uninitialized transform
+    access.readComponentIDs = { mono_identity::ComponentIdentityID() };
+    access.writeComponentIDs = { mono_transform::ComponentTransformID() };
+    return true;
+}
+
 MONO_TRANSFORM_API riaecs::SystemFactoryRegistrar<mono_transform::SystemTransform> mono_transform::SystemTransformID;
\ No newline at end of file
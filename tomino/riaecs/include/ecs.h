@@ -3,10 +3,13 @@
 
 #include "riaecs/include/interfaces/ecs.h"
 #include "riaecs/include/interfaces/factory.h"
-#include "riaecs/include/types/stl_less.h"
 
 #include "riaecs/include/registry.h"
+#include "riaecs/include/entity_command_buffer.h"
+#include "riaecs/include/sparse_set.h"
+#include "riaecs/include/worker_pool.h"
 
+#include <limits>
 #include <map>
 #include <shared_mutex>
 #include <queue>
@@ -28,9 +31,9 @@ namespace riaecs
         mutable bool isReady_ = false;
 
         std::vector<bool> entityExistFlags_;
+        std::vector<bool> entityStagingFlags_;
         std::vector<Entity> entities_;
         std::vector<Entity> freeEntities_;
-        std::set<Entity> emptyEntities_;
 
         static size_t nextRegisterIndex_;
         std::map<size_t, Entity> registeredEntities_;
@@ -38,11 +41,43 @@ namespace riaecs
         std::vector<std::unique_ptr<IPool>> componentPools_;
         std::vector<std::unique_ptr<IAllocator>> componentAllocators_;
 
-        std::map<Entity, std::set<size_t>> entityToComponents_;
-        std::map<size_t, std::set<Entity>> componentToEntities_;
-        std::map<std::pair<Entity, size_t>, std::byte*, PairLess> entityComponentToData_;
+        // Sparse set per component ID
+        std::vector<ComponentSparseSet> componentSets_;
 
-        std::vector<Entity> stagingEntities_;
+        // The structural changes shared by the locking methods and ExecuteEntityCommands
+        // The caller holds the unique lock
+        Entity CreateEntityLocked();
+        void DestroyEntityLocked(const Entity &entity);
+        std::byte* AddComponentLocked(const Entity &entity, size_t componentID);
+        void RemoveComponentLocked(const Entity &entity, size_t componentID);
+
+        // Check the commands against the world before any of them is executed, so a bad one changes nothing
+        void ValidateEntityCommandsLocked(const EntityCommandBuffer &commandBuffer);
+
+        static constexpr size_t NO_COMPONENT_STATE = (std::numeric_limits<size_t>::max)();
+
+        // The state of an entity after the commands validated so far
+        struct EntityCommandState
+        {
+            bool isCreated = false;
+            bool isDestroyed = false;
+            size_t componentStateHead = NO_COMPONENT_STATE;
+        };
+
+        // Whether the entity has the component after the commands validated so far, linked per entity
+        struct ComponentCommandState
+        {
+            size_t componentID;
+            bool hasComponent;
+            size_t next;
+        };
+
+        // Kept between the validations to reuse the memory
+        // The states of the existing entities are indexed by the entity index and reset after each validation
+        std::vector<EntityCommandState> deferredCommandStates_;
+        std::vector<EntityCommandState> existingCommandStates_;
+        std::vector<size_t> touchedEntityIndices_;
+        std::vector<ComponentCommandState> componentCommandStates_;
 
     public:
         ECSWorld(IComponentFactoryRegistry &componentFactoryRegistry, IComponentMaxCountRegistry &componentMaxCountRegistry);
@@ -73,6 +108,10 @@ namespace riaecs
         StagingEntityArea CreateStagingArea() override;
         Entity CreateEntity(StagingEntityArea &stagingArea) override;
         void CommitEntities(StagingEntityArea &stagingArea) override;
+        void ExecuteEntityCommands
+        (
+            const EntityCommandBuffer &commandBuffer, std::vector<Entity> &createdEntities
+        ) override;
 
         void RegisterEntity(size_t index, const Entity &entity) override;
         Entity GetRegisteredEntity(size_t index) const override;
@@ -82,7 +121,12 @@ namespace riaecs
         bool HasComponent(const Entity &entity, size_t componentID) const override;
         std::byte* GetComponent(const Entity &entity, size_t componentID) override;
 
-        ROObject<std::set<Entity>> View(size_t componentID) const override;
+        ROObject<Span<Entity>> View(size_t componentID) const override;
+        void CollectComponents
+        (
+            const size_t *componentIDs, size_t componentCount, 
+            std::vector<Entity> &entities, std::vector<std::byte*> &components
+        ) const override;
     };
 
     template <typename T>
@@ -149,6 +193,9 @@ namespace riaecs
         std::map<size_t, std::unique_ptr<ISystem>> systemMap_;
         std::vector<size_t> order_;
 
+        // The systems in the order, rebuilt by GetAll
+        std::vector<ISystem*> orderedSystems_;
+
     public:
         SystemList() = default;
         virtual ~SystemList() override;
@@ -171,6 +218,7 @@ namespace riaecs
 
         RWObject<ISystem> Get(size_t index) override;
         size_t GetCount() const override;
+        RWObject<std::vector<ISystem*>> GetAll() override;
     };
 
     class RIAECS_API DefaultSystemListFactory : public ISystemListFactory
@@ -234,10 +282,32 @@ namespace riaecs
         std::unique_ptr<ISystemList> systemList_;
         std::unique_ptr<ISystemLoopCommandQueue> commandQueue_;
 
+        // Created on the first frame having a system which declares its access
+        size_t workerCount_ = GetDefaultWorkerCount();
+        std::unique_ptr<WorkerPool> workerPool_;
+
+        // The commands of the systems updated concurrently, passed to commandQueue_ in the system order
+        std::vector<std::unique_ptr<ISystemLoopCommandQueue>> systemCommandQueues_;
+
+        static size_t GetDefaultWorkerCount();
+
+        // Returns false if any system returns false
+        bool UpdateSystems(IECSWorld &ecsWorld, IAssetContainer &assetCont);
+        bool UpdateSystemsConcurrently
+        (
+            IECSWorld &ecsWorld, IAssetContainer &assetCont, 
+            const std::vector<ISystem*> &systems, const std::vector<SystemAccess> &accesses, 
+            const std::vector<bool> &isDeclared
+        );
+
     public:
         SystemLoop() = default;
         virtual ~SystemLoop() override;
 
+        // Set the number of the worker threads before the first frame
+        // If zero, all systems are updated in order on the thread calling Run
+        void SetWorkerCount(size_t workerCount);
+
         /***************************************************************************************************************
          * ISystemLoop Implementation
         /**************************************************************************************************************/
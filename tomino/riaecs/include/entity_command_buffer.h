@@ -0,0 +1,152 @@
+﻿#pragma once
+
+#include "riaecs/include/interfaces/ecs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace riaecs
+{
+    enum class EntityCommandType : uint8_t
+    {
+        CreateEntity,
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent,
+    };
+
+    // Initialize the component data right after the component is constructed in the playback
+    // It runs under the unique lock of the world, so it must not call the world, which would deadlock
+    using ComponentInitializer = std::function<void(std::byte*)>;
+
+    // Records entity creation, destruction and component changes without touching the world,
+    // then plays them back in the recorded order under one lock of the world
+    // Recording is not synchronized, so each thread or system records into its own buffer
+    // A system enqueues EntityCommandPlayback to play its buffer back at the sync point of the system loop
+    class EntityCommandBuffer
+    {
+    public:
+        // The generation of the entities returned by CreateEntity until the buffer is played back
+        static constexpr size_t DEFERRED_GENERATION = (std::numeric_limits<size_t>::max)();
+        static constexpr size_t NO_INITIALIZER = (std::numeric_limits<size_t>::max)();
+
+        struct Command
+        {
+            EntityCommandType type;
+            Entity entity;
+            size_t componentID = 0;
+            size_t initializerIndex = NO_INITIALIZER;
+        };
+
+    private:
+        std::vector<Command> commands_;
+        std::vector<ComponentInitializer> initializers_;
+        size_t deferredEntityCount_ = 0;
+
+        // The entities created by the last playback, in the order of the deferred entities
+        std::vector<Entity> createdEntities_;
+
+    public:
+        EntityCommandBuffer() = default;
+        ~EntityCommandBuffer() = default;
+
+        static bool IsDeferred(const Entity &entity)
+        {
+            return entity.IsValid() && entity.GetGeneration() == DEFERRED_GENERATION;
+        }
+
+        // Returns a deferred entity, which can be used in the commands of this buffer until it is played back
+        Entity CreateEntity()
+        {
+            Entity entity(deferredEntityCount_++, DEFERRED_GENERATION);
+            commands_.push_back({ EntityCommandType::CreateEntity, entity });
+            return entity;
+        }
+
+        // An entity already destroyed when played back is skipped
+        void DestroyEntity(const Entity &entity)
+        {
+            commands_.push_back({ EntityCommandType::DestroyEntity, entity });
+        }
+
+        void AddComponent(const Entity &entity, size_t componentID)
+        {
+            commands_.push_back({ EntityCommandType::AddComponent, entity, componentID });
+        }
+
+        void AddComponent(const Entity &entity, size_t componentID, ComponentInitializer initializer)
+        {
+            commands_.push_back({ EntityCommandType::AddComponent, entity, componentID, initializers_.size() });
+            initializers_.emplace_back(std::move(initializer));
+        }
+
+        void RemoveComponent(const Entity &entity, size_t componentID)
+        {
+            commands_.push_back({ EntityCommandType::RemoveComponent, entity, componentID });
+        }
+
+        const std::vector<Command> &GetCommands() const { return commands_; }
+        const ComponentInitializer &GetInitializer(size_t index) const { return initializers_[index]; }
+        size_t GetDeferredEntityCount() const { return deferredEntityCount_; }
+        bool IsEmpty() const { return commands_.empty(); }
+
+        // Execute the commands and clear them, keeping the capacity for the next frame
+        void Playback(IECSWorld &ecsWorld)
+        {
+            ecsWorld.ExecuteEntityCommands(*this, createdEntities_);
+            Clear();
+        }
+
+        // Get the entity created for the deferred entity by the last playback
+        // Destroyed in the same buffer, it no longer exists in the world
+        Entity Resolve(const Entity &entity) const
+        {
+            if (!IsDeferred(entity))
+                return entity;
+
+            if (entity.GetIndex() >= createdEntities_.size())
+                NotifyError({"Deferred entity is not played back yet"}, RIAECS_LOG_LOC);
+
+            return createdEntities_[entity.GetIndex()];
+        }
+
+        const std::vector<Entity> &GetCreatedEntities() const { return createdEntities_; }
+
+        // Discard the recorded commands
+        void Clear()
+        {
+            commands_.clear();
+            initializers_.clear();
+            deferredEntityCount_ = 0;
+        }
+    };
+
+    // The system loop command playing back the buffer between the frames
+    // The system keeps the buffer to record the next frame and resolve the created entities
+    class EntityCommandPlayback : public ISystemLoopCommand
+    {
+    private:
+        std::shared_ptr<EntityCommandBuffer> commandBuffer_;
+
+    public:
+        EntityCommandPlayback(std::shared_ptr<EntityCommandBuffer> commandBuffer) : 
+            commandBuffer_(std::move(commandBuffer))
+        {
+        }
+
+        void Execute(ISystemList &systemList, IECSWorld &ecsWorld, IAssetContainer &assetCont) const override
+        {
+            commandBuffer_->Playback(ecsWorld);
+        }
+
+        std::unique_ptr<ISystemLoopCommand> Clone() const override
+        {
+            return std::make_unique<EntityCommandPlayback>(commandBuffer_);
+        }
+    };
+
+} // namespace riaecs
\ No newline at end of file
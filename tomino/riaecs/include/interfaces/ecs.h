@@ -26,6 +26,8 @@ namespace riaecs
     using IAllocatorFactory = IFactory<std::unique_ptr<IAllocator>, IPool&, size_t>;
 
     using StagingEntityArea = std::vector<Entity>;
+    class EntityCommandBuffer;
+
     class IECSWorld
     {
     public:
@@ -48,6 +50,14 @@ namespace riaecs
         virtual Entity CreateEntity(StagingEntityArea &stagingArea) = 0;
         virtual void CommitEntities(StagingEntityArea &stagingArea) = 0;
 
+        // Execute the recorded commands in order under one lock, use EntityCommandBuffer::Playback instead
+        // All commands are checked first, so an invalid one raises an error without changing the world
+        // The created entities are stored in the order of the deferred entities of the buffer
+        virtual void ExecuteEntityCommands
+        (
+            const EntityCommandBuffer &commandBuffer, std::vector<Entity> &createdEntities
+        ) = 0;
+
         virtual void RegisterEntity(size_t index, const Entity &entity) = 0;
         virtual Entity GetRegisteredEntity(size_t index) const = 0;
 
@@ -56,7 +66,18 @@ namespace riaecs
         virtual bool HasComponent(const Entity &entity, size_t componentID) const = 0;
         virtual std::byte* GetComponent(const Entity &entity, size_t componentID) = 0;
 
-        virtual ROObject<std::set<Entity>> View(size_t componentID) const = 0;
+        // The entities which have the component, contiguous and in no particular order
+        // The span is valid until the component is removed from an entity, iterate a copy to remove it in the loop
+        virtual ROObject<Span<Entity>> View(size_t componentID) const = 0;
+
+        // Collect the entities which have all the components and their component data in one locked pass
+        // The component set with the fewest entities drives the iteration
+        // The data of the i-th entity is stored from components[i * componentCount] in the order of componentIDs
+        virtual void CollectComponents
+        (
+            const size_t *componentIDs, size_t componentCount, 
+            std::vector<Entity> &entities, std::vector<std::byte*> &components
+        ) const = 0;
     };
 
     template <typename T>
@@ -102,6 +123,23 @@ namespace riaecs
 
     class ISystemLoopCommandQueue;
 
+    // The components a system reads and writes in its update
+    // Systems whose accesses do not conflict can be updated concurrently by the system loop
+    struct SystemAccess
+    {
+        std::vector<size_t> readComponentIDs;
+        std::vector<size_t> writeComponentIDs;
+
+        // Set if the system creates or destroys entities, or adds or removes components
+        // Such a system is updated alone, as the structural changes are visible to every system
+        bool hasStructuralChange = false;
+
+        // Set if the system may return false to stop the loop
+        // Then the systems after this one are not started until it returns,
+        // so none of them is updated in the frame it stops the loop
+        bool mayStopLoop = false;
+    };
+
     class ISystem
     {
     public:
@@ -114,6 +152,16 @@ namespace riaecs
             IECSWorld &ecsWorld, IAssetContainer &assetCont, 
             ISystemLoopCommandQueue &systemLoopCmdQueue
         ) = 0;
+
+        // Declare the access to run the system on a worker thread alongside non-conflicting systems
+        // The system must not touch any other state shared with the systems it may run with
+        // Returns false if not declared, then the system runs alone on the system loop thread
+        // If the system returns false from Update without setting mayStopLoop,
+        // the systems after it may still be updated in that frame
+        virtual bool DeclareAccess(SystemAccess &access) const
+        {
+            return false;
+        }
     };
     using ISystemFactory = IFactory<std::unique_ptr<ISystem>>;
     using ISystemFactoryRegistry = IRegistry<ISystemFactory>;
@@ -134,6 +182,9 @@ namespace riaecs
 
         virtual RWObject<ISystem> Get(size_t index) = 0;
         virtual size_t GetCount() const = 0;
+
+        // Get all systems in the order, the list stays locked until the returned object is destroyed
+        virtual RWObject<std::vector<ISystem*>> GetAll() = 0;
     };
     using ISystemListFactory = IFactory<std::unique_ptr<ISystemList>>;
 
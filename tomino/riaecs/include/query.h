@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include "riaecs/include/interfaces/ecs.h"
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace riaecs
+{
+    // Typed iteration over the entities which have all the components
+    // The entities and their component pointers are collected in one locked pass when the query is constructed,
+    // driven by the component with the fewest entities, so no lookup or lock is needed while iterating
+    // The result is a snapshot, destroy the entities after iterating as the pointers of destroyed ones dangle
+    //
+    // for (auto [entity, transform, rigidBody] : riaecs::Query<ComponentTransform, ComponentRigidBody>(
+    //     ecsWorld, { ComponentTransformID(), ComponentRigidBodyID() }))
+    template <typename... COMPONENTS>
+    class Query
+    {
+    private:
+        static constexpr size_t COMPONENT_COUNT = sizeof...(COMPONENTS);
+        static_assert(COMPONENT_COUNT != 0, "Query needs at least one component");
+
+        std::vector<Entity> entities_;
+        std::vector<std::byte*> components_;
+
+        template <size_t... INDICES>
+        std::tuple<Entity, COMPONENTS*...> GetTuple(size_t index, std::index_sequence<INDICES...>) const
+        {
+            const std::byte *const *row = components_.data() + index * COMPONENT_COUNT;
+            return std::tuple<Entity, COMPONENTS*...>(
+                entities_[index], reinterpret_cast<COMPONENTS*>(const_cast<std::byte*>(row[INDICES]))...);
+        }
+
+    public:
+        class Iterator
+        {
+        private:
+            const Query *query_ = nullptr;
+            size_t index_ = 0;
+
+        public:
+            Iterator(const Query *query, size_t index) : query_(query), index_(index) {}
+
+            std::tuple<Entity, COMPONENTS*...> operator*() const { return query_->Get(index_); }
+
+            Iterator &operator++()
+            {
+                ++index_;
+                return *this;
+            }
+
+            bool operator==(const Iterator &other) const { return index_ == other.index_; }
+            bool operator!=(const Iterator &other) const { return index_ != other.index_; }
+        };
+
+        // The component IDs are in the same order as the component types
+        Query(IECSWorld &ecsWorld, const std::array<size_t, COMPONENT_COUNT> &componentIDs)
+        {
+            ecsWorld.CollectComponents(componentIDs.data(), COMPONENT_COUNT, entities_, components_);
+        }
+
+        ~Query() = default;
+
+        size_t GetCount() const { return entities_.size(); }
+        bool IsEmpty() const { return entities_.empty(); }
+
+        std::tuple<Entity, COMPONENTS*...> Get(size_t index) const
+        {
+            return GetTuple(index, std::index_sequence_for<COMPONENTS...>());
+        }
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, entities_.size()); }
+    };
+
+} // namespace riaecs
\ No newline at end of file
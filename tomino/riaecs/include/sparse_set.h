@@ -0,0 +1,166 @@
+﻿#pragma once
+
+#include "riaecs/include/types/id.h"
+#include "riaecs/include/types/span.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace riaecs
+{
+    // Storage of the entities which have a component and their component data
+    // The sparse array is indexed by Entity::GetIndex() and holds the position in the dense arrays,
+    // so lookups are O(1) and the entities can be iterated contiguously
+    // Entities in the staging area are kept apart until they are committed, so they do not appear in the dense entities
+    class ComponentSparseSet
+    {
+    private:
+        static constexpr size_t NPOS = (std::numeric_limits<size_t>::max)();
+
+        struct Slot
+        {
+            size_t position = NPOS;
+            bool isStaging = false;
+        };
+        std::vector<Slot> sparse_;
+
+        std::vector<ID> denseEntities_;
+        std::vector<std::byte*> denseData_;
+
+        std::vector<ID> stagingEntities_;
+        std::vector<std::byte*> stagingData_;
+
+        // Remove the element at the position by moving the last one into it
+        static void SwapRemove
+        (
+            std::vector<Slot> &sparse, std::vector<ID> &entities, std::vector<std::byte*> &data, size_t position
+        ){
+            if (position != entities.size() - 1)
+            {
+                entities[position] = entities.back();
+                data[position] = data.back();
+                sparse[entities[position].GetIndex()].position = position;
+            }
+
+            entities.pop_back();
+            data.pop_back();
+        }
+
+        const Slot *FindSlot(const ID &entity) const
+        {
+            if (entity.GetIndex() >= sparse_.size())
+                return nullptr;
+
+            const Slot &slot = sparse_[entity.GetIndex()];
+            if (slot.position == NPOS)
+                return nullptr;
+
+            // The generation must match, an entity reusing the index does not have the component
+            const std::vector<ID> &entities = slot.isStaging ? stagingEntities_ : denseEntities_;
+            if (entities[slot.position] != entity)
+                return nullptr;
+
+            return &slot;
+        }
+
+    public:
+        ComponentSparseSet() = default;
+        ~ComponentSparseSet() = default;
+
+        // Reserve the dense arrays for the maximum count of the component
+        // As the component pool never holds more, the dense entities are never reallocated
+        // and spans returned by GetEntities stay valid while components are added
+        void Reserve(size_t count)
+        {
+            denseEntities_.reserve(count);
+            denseData_.reserve(count);
+        }
+
+        void Add(const ID &entity, std::byte *data, bool isStaging)
+        {
+            if (entity.GetIndex() >= sparse_.size())
+                sparse_.resize(entity.GetIndex() + 1);
+
+            Slot &slot = sparse_[entity.GetIndex()];
+            slot.isStaging = isStaging;
+            if (isStaging)
+            {
+                slot.position = stagingEntities_.size();
+                stagingEntities_.push_back(entity);
+                stagingData_.push_back(data);
+            }
+            else
+            {
+                slot.position = denseEntities_.size();
+                denseEntities_.push_back(entity);
+                denseData_.push_back(data);
+            }
+        }
+
+        // Returns the data of the removed component, or nullptr if the entity does not have it
+        std::byte *Remove(const ID &entity)
+        {
+            const Slot *found = FindSlot(entity);
+            if (found == nullptr)
+                return nullptr;
+
+            Slot &slot = sparse_[entity.GetIndex()];
+            std::byte *data = nullptr;
+            if (slot.isStaging)
+            {
+                data = stagingData_[slot.position];
+                SwapRemove(sparse_, stagingEntities_, stagingData_, slot.position);
+            }
+            else
+            {
+                data = denseData_[slot.position];
+                SwapRemove(sparse_, denseEntities_, denseData_, slot.position);
+            }
+
+            slot = Slot();
+            return data;
+        }
+
+        // Move the component of the staging entity to the dense arrays
+        void Commit(const ID &entity)
+        {
+            const Slot *found = FindSlot(entity);
+            if (found == nullptr || !found->isStaging)
+                return;
+
+            std::byte *data = Remove(entity);
+            Add(entity, data, false);
+        }
+
+        bool Contains(const ID &entity) const
+        {
+            return FindSlot(entity) != nullptr;
+        }
+
+        std::byte *Find(const ID &entity) const
+        {
+            const Slot *slot = FindSlot(entity);
+            if (slot == nullptr)
+                return nullptr;
+
+            return slot->isStaging ? stagingData_[slot->position] : denseData_[slot->position];
+        }
+
+        // The committed entities which have the component, in no particular order
+        Span<ID> GetEntities() const
+        {
+            return Span<ID>(denseEntities_.data(), denseEntities_.size());
+        }
+
+        void Clear()
+        {
+            sparse_.clear();
+            denseEntities_.clear();
+            denseData_.clear();
+            stagingEntities_.clear();
+            stagingData_.clear();
+        }
+    };
+
+} // namespace riaecs
\ No newline at end of file
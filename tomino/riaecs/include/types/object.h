@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include "riaecs/include/types/span.h"
+
 #include <shared_mutex>
 #include <vector>
 
@@ -79,6 +81,44 @@ namespace riaecs
         }
     };
 
+    template <typename T>
+    class ROObject<Span<T>>
+    {
+    private:
+        std::shared_lock<std::shared_mutex> mainLock_;
+        std::vector<std::unique_lock<std::shared_mutex>> subUniqueLocks_;
+        std::vector<std::shared_lock<std::shared_mutex>> subSharedLocks_;
+
+        Span<T> span_;
+
+    public:
+        ROObject(std::shared_lock<std::shared_mutex> mainLock, Span<T> span) : 
+            mainLock_(std::move(mainLock)), span_(span) 
+        {
+        }
+
+        // The span is returned by value, so it stays valid after this object is destroyed
+        Span<T> operator()() 
+        {
+            return span_;
+        }
+
+        std::shared_lock<std::shared_mutex> TakeLock() 
+        {
+            return std::move(mainLock_);
+        }
+
+        void AddSubLock(std::unique_lock<std::shared_mutex> subLock) 
+        {
+            subUniqueLocks_.emplace_back(std::move(subLock));
+        }
+
+        void AddSubLock(std::shared_lock<std::shared_mutex> subLock) 
+        {
+            subSharedLocks_.emplace_back(std::move(subLock));
+        }
+    };
+
     template <typename T>
     class RWObject
     {
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <cstddef>
+
+namespace riaecs
+{
+    // Read-only view of contiguous elements, like std::span which is not available in C++17
+    template <typename T>
+    class Span
+    {
+    private:
+        const T *data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        Span() = default;
+        Span(const T *data, size_t size) : data_(data), size_(size) {}
+        ~Span() = default;
+
+        const T *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+
+        const T &operator[](size_t index) const { return data_[index]; }
+    };
+
+} // namespace riaecs
\ No newline at end of file
@@ -0,0 +1,38 @@
+﻿#pragma once
+#include "riaecs/include/dll_config.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace riaecs
+{
+    // Persistent threads executing submitted tasks in submission order
+    class RIAECS_API WorkerPool
+    {
+    private:
+        std::vector<std::thread> threads_;
+        std::queue<std::function<void()>> tasks_;
+
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool isStopping_ = false;
+
+        void WorkerMain();
+
+    public:
+        WorkerPool(size_t threadCount);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // The task must not throw, catch and pass the exception to the waiting thread instead
+        void Submit(std::function<void()> task);
+        size_t GetThreadCount() const;
+    };
+
+} // namespace riaecs
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include "riaecs/include/types/id.h"
 #include "riaecs/include/types/object.h"
+#include "riaecs/include/types/span.h"
 #include "riaecs/include/types/stl_hash.h"
 #include "riaecs/include/types/stl_euqal.h"
 
@@ -29,8 +30,12 @@
 #include "riaecs/include/asset.h"
 #include "riaecs/include/container.h"
 #include "riaecs/include/ecs.h"
+#include "riaecs/include/entity_command_buffer.h"
 #include "riaecs/include/file.h"
 #include "riaecs/include/global_registry.h"
 #include "riaecs/include/log.h"
+#include "riaecs/include/query.h"
 #include "riaecs/include/registry.h"
-#include "riaecs/include/utilities.h"
\ No newline at end of file
+#include "riaecs/include/sparse_set.h"
+#include "riaecs/include/utilities.h"
+#include "riaecs/include/worker_pool.h"
\ No newline at end of file
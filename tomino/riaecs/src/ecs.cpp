@@ -4,6 +4,9 @@
 #include "riaecs/include/utilities.h"
 #include "riaecs/include/global_registry.h"
 
+#include <algorithm>
+#include <exception>
+
 size_t riaecs::ECSWorld::nextRegisterIndex_ = 0;
 
 riaecs::ECSWorld::ECSWorld(IComponentFactoryRegistry &componentFactoryRegistry, IComponentMaxCountRegistry &componentMaxCountRegistry)
@@ -73,6 +76,7 @@ void riaecs::ECSWorld::CreateWorld()
     size_t componentCount = componentFactoryRegistry_.GetCount();
     componentPools_.resize(componentCount);
     componentAllocators_.resize(componentCount);
+    componentSets_.resize(componentCount);
 
     for (size_t i = 0; i < componentCount; ++i)
     {
@@ -82,6 +86,7 @@ void riaecs::ECSWorld::CreateWorld()
         size_t blockSize = std::max(factory().GetProductSize(), riaecs::MAX_FREE_BLOCK_SIZE);
         componentPools_[i] = poolFactory_->Create(blockSize * maxCount());
         componentAllocators_[i] = allocatorFactory_->Create(*componentPools_[i], blockSize);
+        componentSets_[i].Reserve(maxCount());
     }
 }
 
@@ -95,9 +100,7 @@ void riaecs::ECSWorld::DestroyWorld()
     std::unique_lock<std::shared_mutex> lock(mutex_);
 
     // Clear all component data
-    entityComponentToData_.clear();
-    entityToComponents_.clear();
-    componentToEntities_.clear();
+    componentSets_.clear();
 
     // Destroy pools and allocators
     for (size_t i = 0; i < componentPools_.size(); ++i)
@@ -110,6 +113,7 @@ void riaecs::ECSWorld::DestroyWorld()
 
     // Reset entity management
     entityExistFlags_.clear();
+    entityStagingFlags_.clear();
     freeEntities_.clear();
 
     // Reset ready state
@@ -123,12 +127,18 @@ riaecs::Entity riaecs::ECSWorld::CreateEntity()
     if (!isReady_)
         riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
 
+    return CreateEntityLocked();
+}
+
+riaecs::Entity riaecs::ECSWorld::CreateEntityLocked()
+{
     if (!freeEntities_.empty())
     {
         Entity entity = freeEntities_.back();
         freeEntities_.pop_back();
 
         entityExistFlags_[entity.GetIndex()] = true;
+        entityStagingFlags_[entity.GetIndex()] = false;
         entities_[entity.GetIndex()] = Entity(entity.GetIndex(), entity.GetGeneration() + 1);
 
         return entities_[entity.GetIndex()];
@@ -137,6 +147,7 @@ riaecs::Entity riaecs::ECSWorld::CreateEntity()
     {
         size_t index = entityExistFlags_.size();
         entityExistFlags_.push_back(true);
+        entityStagingFlags_.push_back(false);
         entities_.push_back(Entity(index, riaecs::ID_DEFAULT_GENERATION));
 
         return entities_.back();
@@ -150,6 +161,11 @@ void riaecs::ECSWorld::DestroyEntity(const Entity &entity)
     if (!isReady_)
         riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
 
+    DestroyEntityLocked(entity);
+}
+
+void riaecs::ECSWorld::DestroyEntityLocked(const Entity &entity)
+{
     if (entity.GetIndex() >= entityExistFlags_.size())
         riaecs::NotifyError({"Entity index out of range"}, RIAECS_LOG_LOC);
 
@@ -160,26 +176,18 @@ void riaecs::ECSWorld::DestroyEntity(const Entity &entity)
         return; // Already destroyed this entity
     
     // Remove all components associated with the entity
-    auto it = entityToComponents_.find(entity);
-    if (it != entityToComponents_.end())
+    for (size_t componentID = 0; componentID < componentSets_.size(); ++componentID)
     {
-        for (size_t componentID : it->second)
-        {
-            // Remove the component from the entity
-            componentToEntities_[componentID].erase(entity);
-
-            // Get the component factory for the component ID
-            riaecs::ROObject<riaecs::IComponentFactory> factory = componentFactoryRegistry_.Get(componentID);
+        std::byte *componentData = componentSets_[componentID].Remove(entity);
+        if (componentData == nullptr)
+            continue; // The entity does not have this component
 
-            // Free the component data which was allocated for this entity
-            std::byte *componentData = entityComponentToData_[{entity, componentID}];
-            factory().Destroy(componentData);
-            componentAllocators_[componentID]->Free(componentData, *componentPools_[componentID]);
-            entityComponentToData_.erase({entity, componentID});
-        }
+        // Get the component factory for the component ID
+        riaecs::ROObject<riaecs::IComponentFactory> factory = componentFactoryRegistry_.Get(componentID);
 
-        // Remove the entity from the entityToComponents map
-        entityToComponents_.erase(it);
+        // Free the component data which was allocated for this entity
+        factory().Destroy(componentData);
+        componentAllocators_[componentID]->Free(componentData, *componentPools_[componentID]);
     }
 
     // Store the entity in freeEntities for reuse
@@ -187,6 +195,7 @@ void riaecs::ECSWorld::DestroyEntity(const Entity &entity)
 
     // Update the entityExistFlags to mark it as not existing
     entityExistFlags_[entity.GetIndex()] = false;
+    entityStagingFlags_[entity.GetIndex()] = false;
 }
 
 bool riaecs::ECSWorld::CheckEntityExist(const Entity &entity) const
@@ -231,9 +240,9 @@ riaecs::Entity riaecs::ECSWorld::CreateEntity(StagingEntityArea &stagingArea)
     // {
         size_t index = entityExistFlags_.size();
         entityExistFlags_.push_back(true);
+        entityStagingFlags_.push_back(true);
         entities_.push_back(Entity(index, riaecs::ID_DEFAULT_GENERATION));
 
-        stagingEntities_.push_back(entities_.back());
         stagingArea.emplace_back(entities_.back());
 
         return entities_.back();
@@ -249,19 +258,203 @@ void riaecs::ECSWorld::CommitEntities(StagingEntityArea &stagingArea)
 
     for (const riaecs::Entity &entity : stagingArea)
     {
-        for (size_t componentID : entityToComponents_[entity])
-            componentToEntities_[componentID].insert(entity);
+        if (entity.GetIndex() >= entityExistFlags_.size())
+            riaecs::NotifyError({"Entity index out of range"}, RIAECS_LOG_LOC);
 
-        auto it = std::find(stagingEntities_.begin(), stagingEntities_.end(), entity);
-        if (it == stagingEntities_.end())
+        if (!entityExistFlags_[entity.GetIndex()] || entities_[entity.GetIndex()] != entity)
+            continue; // Destroyed before being committed, it has no components
+
+        if (!entityStagingFlags_[entity.GetIndex()])
             riaecs::NotifyError({"Entity is not a staging entity"}, RIAECS_LOG_LOC);
 
-        stagingEntities_.erase(it);
+        // Make the components visible to View
+        for (riaecs::ComponentSparseSet &componentSet : componentSets_)
+            componentSet.Commit(entity);
+
+        entityStagingFlags_[entity.GetIndex()] = false;
     }
 
     stagingArea.clear();
 }
 
+void riaecs::ECSWorld::ExecuteEntityCommands
+(
+    const EntityCommandBuffer &commandBuffer, std::vector<Entity> &createdEntities
+){
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    if (!isReady_)
+        riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
+
+    ValidateEntityCommandsLocked(commandBuffer);
+
+    createdEntities.assign(commandBuffer.GetDeferredEntityCount(), Entity());
+
+    for (const EntityCommandBuffer::Command &command : commandBuffer.GetCommands())
+    {
+        if (command.type == EntityCommandType::CreateEntity)
+        {
+            createdEntities[command.entity.GetIndex()] = CreateEntityLocked();
+            continue;
+        }
+
+        // Replace the deferred entity with the created one
+        Entity entity = command.entity;
+        if (EntityCommandBuffer::IsDeferred(entity))
+        {
+            if (entity.GetIndex() >= createdEntities.size() || !createdEntities[entity.GetIndex()].IsValid())
+                riaecs::NotifyError({"Deferred entity is used before it is created"}, RIAECS_LOG_LOC);
+
+            entity = createdEntities[entity.GetIndex()];
+        }
+
+        // The entity may have been destroyed after the command was recorded
+        bool isAlive = 
+            entity.GetIndex() < entityExistFlags_.size() && 
+            entityExistFlags_[entity.GetIndex()] && entities_[entity.GetIndex()] == entity;
+        if (!isAlive)
+            continue;
+
+        switch (command.type)
+        {
+        case EntityCommandType::DestroyEntity:
+            DestroyEntityLocked(entity);
+            break;
+
+        case EntityCommandType::AddComponent:
+        {
+            std::byte *componentData = AddComponentLocked(entity, command.componentID);
+            if (command.initializerIndex != EntityCommandBuffer::NO_INITIALIZER)
+                commandBuffer.GetInitializer(command.initializerIndex)(componentData);
+            break;
+        }
+
+        case EntityCommandType::RemoveComponent:
+            RemoveComponentLocked(entity, command.componentID);
+            break;
+
+        default:
+            riaecs::NotifyError({"Invalid entity command type"}, RIAECS_LOG_LOC);
+        }
+    }
+}
+
+void riaecs::ECSWorld::ValidateEntityCommandsLocked(const EntityCommandBuffer &commandBuffer)
+{
+    const EntityCommandState initialState = {};
+    deferredCommandStates_.assign(commandBuffer.GetDeferredEntityCount(), initialState);
+    if (existingCommandStates_.size() < entities_.size())
+        existingCommandStates_.resize(entities_.size(), initialState);
+    componentCommandStates_.clear();
+
+    // Reset the states of the existing entities even if a command is invalid
+    struct StateReset
+    {
+        std::vector<EntityCommandState> &states;
+        std::vector<size_t> &touchedIndices;
+        const EntityCommandState &initialState;
+
+        ~StateReset()
+        {
+            for (size_t index : touchedIndices)
+                states[index] = initialState;
+            touchedIndices.clear();
+        }
+    } stateReset = { existingCommandStates_, touchedEntityIndices_, initialState };
+
+    for (const EntityCommandBuffer::Command &command : commandBuffer.GetCommands())
+    {
+        if (command.type == EntityCommandType::CreateEntity)
+        {
+            deferredCommandStates_[command.entity.GetIndex()].isCreated = true;
+            continue;
+        }
+
+        // Skipped in the same way as the execution
+        bool isDeferred = EntityCommandBuffer::IsDeferred(command.entity);
+        EntityCommandState *state = nullptr;
+        if (isDeferred)
+        {
+            if (command.entity.GetIndex() >= deferredCommandStates_.size() || !deferredCommandStates_[command.entity.GetIndex()].isCreated)
+                riaecs::NotifyError({"Deferred entity is used before it is created"}, RIAECS_LOG_LOC);
+
+            state = &deferredCommandStates_[command.entity.GetIndex()];
+        }
+        else
+        {
+            bool isAlive = 
+                command.entity.GetIndex() < entityExistFlags_.size() && 
+                entityExistFlags_[command.entity.GetIndex()] && entities_[command.entity.GetIndex()] == command.entity;
+            if (!isAlive)
+                continue;
+
+            state = &existingCommandStates_[command.entity.GetIndex()];
+            if (!state->isCreated)
+            {
+                // Marks the state as touched, an existing entity is not created by the buffer otherwise
+                state->isCreated = true;
+                touchedEntityIndices_.push_back(command.entity.GetIndex());
+            }
+        }
+
+        if (state->isDestroyed)
+            continue;
+
+        if (command.type == EntityCommandType::DestroyEntity)
+        {
+            state->isDestroyed = true;
+            continue;
+        }
+
+        if (command.type != EntityCommandType::AddComponent && command.type != EntityCommandType::RemoveComponent)
+            riaecs::NotifyError({"Invalid entity command type"}, RIAECS_LOG_LOC);
+
+        if (command.componentID >= componentPools_.size())
+            riaecs::NotifyError({"Component ID out of range: " + std::to_string(command.componentID)}, RIAECS_LOG_LOC);
+
+        // Find the component changed by the earlier commands
+        size_t componentStateIndex = state->componentStateHead;
+        while (componentStateIndex != NO_COMPONENT_STATE && componentCommandStates_[componentStateIndex].componentID != command.componentID)
+            componentStateIndex = componentCommandStates_[componentStateIndex].next;
+
+        if (componentStateIndex == NO_COMPONENT_STATE)
+        {
+            bool hasComponent = !isDeferred && componentSets_[command.componentID].Contains(command.entity);
+            componentCommandStates_.push_back({ command.componentID, hasComponent, state->componentStateHead });
+            componentStateIndex = componentCommandStates_.size() - 1;
+            state->componentStateHead = componentStateIndex;
+        }
+
+        ComponentCommandState &componentState = componentCommandStates_[componentStateIndex];
+        if (command.type == EntityCommandType::AddComponent)
+        {
+            if (componentPools_[command.componentID] == nullptr || componentAllocators_[command.componentID] == nullptr)
+                riaecs::NotifyError({"Component pool or allocator not initialized for component ID"}, RIAECS_LOG_LOC);
+
+            if (componentState.hasComponent)
+            {
+                riaecs::NotifyError
+                (
+                    {
+                        "Entity already has this component",
+                        "Entity index: " + std::to_string(command.entity.GetIndex()),
+                        "Component ID: " + std::to_string(command.componentID)
+                    }, RIAECS_LOG_LOC
+                );
+            }
+
+            componentState.hasComponent = true;
+        }
+        else
+        {
+            if (!isDeferred && entityStagingFlags_[command.entity.GetIndex()])
+                riaecs::NotifyError({"Cannot remove component from a staging entity"}, RIAECS_LOG_LOC);
+
+            componentState.hasComponent = false;
+        }
+    }
+}
+
 size_t riaecs::ECSWorld::CreateRegisterIndex()
 {
     return nextRegisterIndex_++;
@@ -301,6 +494,11 @@ void riaecs::ECSWorld::AddComponent(const Entity &entity, size_t componentID)
     if (!isReady_)
         riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
 
+    AddComponentLocked(entity, componentID);
+}
+
+std::byte* riaecs::ECSWorld::AddComponentLocked(const Entity &entity, size_t componentID)
+{
     if (entity.GetIndex() >= entityExistFlags_.size())
         riaecs::NotifyError({"Entity index out of range"}, RIAECS_LOG_LOC);
 
@@ -316,7 +514,7 @@ void riaecs::ECSWorld::AddComponent(const Entity &entity, size_t componentID)
     if (componentPools_[componentID] == nullptr || componentAllocators_[componentID] == nullptr)
         riaecs::NotifyError({"Component pool or allocator not initialized for component ID"}, RIAECS_LOG_LOC);
 
-    if (entityToComponents_[entity].find(componentID) != entityToComponents_[entity].end())
+    if (componentSets_[componentID].Contains(entity))
         riaecs::NotifyError({"Entity already has this component"}, RIAECS_LOG_LOC);
 
     // Get the component factory for the component ID
@@ -332,13 +530,9 @@ void riaecs::ECSWorld::AddComponent(const Entity &entity, size_t componentID)
     // Initialize the component using the factory
     componentPtr = factory().Create(componentPtr);
 
-    // Store to the maps
-    entityToComponents_[entity].insert(componentID);
-    entityComponentToData_[{entity, componentID}] = componentPtr;
-
-    // If the entity is not a staging entity, add it to the componentToEntities_ map immediately
-    if (stagingEntities_.end() == std::find(stagingEntities_.begin(), stagingEntities_.end(), entity))
-        componentToEntities_[componentID].insert(entity);
+    // Store to the sparse set, a staging entity is not visible to View until it is committed
+    componentSets_[componentID].Add(entity, componentPtr, entityStagingFlags_[entity.GetIndex()]);
+    return componentPtr;
 }
 
 void riaecs::ECSWorld::RemoveComponent(const Entity &entity, size_t componentID)
@@ -348,6 +542,11 @@ void riaecs::ECSWorld::RemoveComponent(const Entity &entity, size_t componentID)
     if (!isReady_)
         riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
 
+    RemoveComponentLocked(entity, componentID);
+}
+
+void riaecs::ECSWorld::RemoveComponentLocked(const Entity &entity, size_t componentID)
+{
     if (entity.GetIndex() >= entityExistFlags_.size())
         riaecs::NotifyError({"Entity index out of range"}, RIAECS_LOG_LOC);
 
@@ -360,25 +559,19 @@ void riaecs::ECSWorld::RemoveComponent(const Entity &entity, size_t componentID)
     if (componentID >= componentPools_.size())
         riaecs::NotifyError({"Component ID out of range"}, RIAECS_LOG_LOC);
 
-    if (stagingEntities_.end() != std::find(stagingEntities_.begin(), stagingEntities_.end(), entity))
+    if (entityStagingFlags_[entity.GetIndex()])
         riaecs::NotifyError({"Cannot remove component from a staging entity"}, RIAECS_LOG_LOC);
 
-    // Check if the entity has the component
-    auto it = entityToComponents_.find(entity);
-    if (it != entityToComponents_.end() && it->second.find(componentID) != it->second.end())
+    // Remove the component from the entity if it has the component
+    std::byte *componentData = componentSets_[componentID].Remove(entity);
+    if (componentData != nullptr)
     {
-        // Remove the component from the entity
-        it->second.erase(componentID);
-        componentToEntities_[componentID].erase(entity);
-
         // Get the component factory for the component ID
         riaecs::ROObject<riaecs::IComponentFactory> factory = componentFactoryRegistry_.Get(componentID);
 
         // Free the component data which was allocated for this entity
-        std::byte *componentData = entityComponentToData_[{entity, componentID}];
         factory().Destroy(componentData);
         componentAllocators_[componentID]->Free(componentData, *componentPools_[componentID]);
-        entityComponentToData_.erase({entity, componentID});
     }
 }
 
@@ -401,8 +594,7 @@ bool riaecs::ECSWorld::HasComponent(const Entity &entity, size_t componentID) co
     if (componentID >= componentPools_.size())
         riaecs::NotifyError({"Component ID out of range"}, RIAECS_LOG_LOC);
 
-    auto it = entityToComponents_.find(entity);
-    return it != entityToComponents_.end() && it->second.find(componentID) != it->second.end();
+    return componentSets_[componentID].Contains(entity);
 }
 
 std::byte* riaecs::ECSWorld::GetComponent(const Entity &entity, size_t componentID)
@@ -424,14 +616,10 @@ std::byte* riaecs::ECSWorld::GetComponent(const Entity &entity, size_t component
     if (componentID >= componentPools_.size())
         riaecs::NotifyError({"Component ID out of range"}, RIAECS_LOG_LOC);
 
-    auto it = entityComponentToData_.find({entity, componentID});
-    if (it != entityComponentToData_.end())
-        return it->second;
-    
-    return nullptr;
+    return componentSets_[componentID].Find(entity);
 }
 
-riaecs::ROObject<std::set<riaecs::Entity>> riaecs::ECSWorld::View(size_t componentID) const
+riaecs::ROObject<riaecs::Span<riaecs::Entity>> riaecs::ECSWorld::View(size_t componentID) const
 {
     std::shared_lock<std::shared_mutex> lock(mutex_);
 
@@ -441,11 +629,63 @@ riaecs::ROObject<std::set<riaecs::Entity>> riaecs::ECSWorld::View(size_t compone
     if (componentID >= componentPools_.size())
         riaecs::NotifyError({"Component ID out of range"}, RIAECS_LOG_LOC);
 
-    auto it = componentToEntities_.find(componentID);
-    if (it != componentToEntities_.end())
-        return riaecs::ROObject<std::set<riaecs::Entity>>(std::move(lock), it->second);
+    return riaecs::ROObject<riaecs::Span<riaecs::Entity>>(std::move(lock), componentSets_[componentID].GetEntities());
+}
+
+void riaecs::ECSWorld::CollectComponents
+(
+    const size_t *componentIDs, size_t componentCount, 
+    std::vector<Entity> &entities, std::vector<std::byte*> &components
+) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    if (!isReady_)
+        riaecs::NotifyError({"ECSWorld is not ready"}, RIAECS_LOG_LOC);
 
-    return riaecs::ROObject<std::set<riaecs::Entity>>(std::move(lock), emptyEntities_);
+    entities.clear();
+    components.clear();
+
+    if (componentCount == 0)
+        return;
+
+    // Find the component set with the fewest entities
+    size_t drivingIndex = 0;
+    for (size_t i = 0; i < componentCount; ++i)
+    {
+        if (componentIDs[i] >= componentSets_.size())
+            riaecs::NotifyError({"Component ID out of range"}, RIAECS_LOG_LOC);
+
+        if (componentSets_[componentIDs[i]].GetEntities().size() 
+            < componentSets_[componentIDs[drivingIndex]].GetEntities().size())
+            drivingIndex = i;
+    }
+
+    riaecs::Span<riaecs::Entity> drivingEntities = componentSets_[componentIDs[drivingIndex]].GetEntities();
+    entities.reserve(drivingEntities.size());
+    components.reserve(drivingEntities.size() * componentCount);
+
+    for (const riaecs::Entity &entity : drivingEntities)
+    {
+        // Look up the other components of the entity, and drop it if one is missing
+        size_t rowBegin = components.size();
+        bool hasAll = true;
+        for (size_t i = 0; i < componentCount; ++i)
+        {
+            std::byte *componentData = componentSets_[componentIDs[i]].Find(entity);
+            if (componentData == nullptr)
+            {
+                hasAll = false;
+                break;
+            }
+
+            components.push_back(componentData);
+        }
+
+        if (hasAll)
+            entities.push_back(entity);
+        else
+            components.resize(rowBegin);
+    }
 }
 
 riaecs::SystemList::~SystemList()
@@ -541,6 +781,22 @@ size_t riaecs::SystemList::GetCount() const
     return order_.size();
 }
 
+riaecs::RWObject<std::vector<riaecs::ISystem*>> riaecs::SystemList::GetAll()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    orderedSystems_.clear();
+    for (size_t systemID : order_)
+    {
+        if (systemMap_.find(systemID) == systemMap_.end())
+            riaecs::NotifyError({"System with ID " + std::to_string(systemID) + " does not exist"}, RIAECS_LOG_LOC);
+
+        orderedSystems_.push_back(systemMap_[systemID].get());
+    }
+
+    return riaecs::RWObject<std::vector<ISystem*>>(std::move(lock), orderedSystems_);
+}
+
 std::unique_ptr<riaecs::ISystemList> riaecs::DefaultSystemListFactory::Create() const
 {
     return std::make_unique<riaecs::SystemList>();
@@ -680,16 +936,219 @@ void riaecs::SystemLoop::Run(IECSWorld &ecsWorld, IAssetContainer &assetCont)
             break; // Exit the loop if no systems are available
 
         // Update systems
-        bool continueLoop = true;
-        for (size_t i = 0; i < systemList_->GetCount(); ++i)
+        if (!UpdateSystems(ecsWorld, assetCont))
+            break; // Stop the system loop if any system returns false
+    }
+}
+
+void riaecs::SystemLoop::SetWorkerCount(size_t workerCount)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    workerCount_ = workerCount;
+    workerPool_.reset();
+}
+
+size_t riaecs::SystemLoop::GetDefaultWorkerCount()
+{
+    // Leave a hardware thread to the thread calling Run
+    size_t hardwareThreadCount = std::thread::hardware_concurrency();
+    return (hardwareThreadCount > 2) ? hardwareThreadCount - 1 : 1;
+}
+
+namespace
+{
+    bool HasCommonID(const std::vector<size_t> &a, const std::vector<size_t> &b)
+    {
+        for (size_t id : a)
         {
-            riaecs::RWObject<ISystem> system = systemList_->Get(i);
-            continueLoop = system().Update(ecsWorld, assetCont, *commandQueue_);
-            if (!continueLoop)
-                break; // Stop the system update if any system returns false
+            if (std::find(b.begin(), b.end(), id) != b.end())
+                return true;
         }
+        return false;
+    }
+
+    bool IsConflicting(const riaecs::SystemAccess &a, const riaecs::SystemAccess &b)
+    {
+        return 
+            a.hasStructuralChange || b.hasStructuralChange ||
+            HasCommonID(a.writeComponentIDs, b.writeComponentIDs) ||
+            HasCommonID(a.writeComponentIDs, b.readComponentIDs) ||
+            HasCommonID(a.readComponentIDs, b.writeComponentIDs);
+    }
+
+} // namespace
+
+bool riaecs::SystemLoop::UpdateSystems(IECSWorld &ecsWorld, IAssetContainer &assetCont)
+{
+    // The system list stays locked until all systems are updated
+    riaecs::RWObject<std::vector<ISystem*>> lockedSystems = systemList_->GetAll();
+    const std::vector<ISystem*> &systems = lockedSystems();
+    const size_t systemCount = systems.size();
+
+    std::vector<SystemAccess> accesses(systemCount);
+    std::vector<bool> isDeclared(systemCount);
+    bool hasDeclared = false;
+    for (size_t i = 0; i < systemCount; ++i)
+    {
+        isDeclared[i] = systems[i]->DeclareAccess(accesses[i]);
+        hasDeclared = hasDeclared || isDeclared[i];
+    }
+
+    if (!hasDeclared || workerCount_ == 0)
+    {
+        for (ISystem *system : systems)
+        {
+            if (!system->Update(ecsWorld, assetCont, *commandQueue_))
+                return false; // Stop the system update if any system returns false
+        }
+        return true;
+    }
+
+    if (!workerPool_)
+        workerPool_ = std::make_unique<WorkerPool>(workerCount_);
+
+    while (systemCommandQueues_.size() < systemCount)
+    {
+        systemCommandQueues_.emplace_back(loopCommandQueueFactory_->Create());
+        if (!systemCommandQueues_.back())
+            riaecs::NotifyError({"Failed to create System Loop Command Queue"}, RIAECS_LOG_LOC);
+    }
+
+    bool continueLoop = UpdateSystemsConcurrently(ecsWorld, assetCont, systems, accesses, isDeclared);
+
+    // Enqueue the commands as if the systems were updated in order
+    for (size_t i = 0; i < systemCount; ++i)
+    {
+        while (!systemCommandQueues_[i]->IsEmpty())
+            commandQueue_->Enqueue(systemCommandQueues_[i]->Dequeue());
+    }
+
+    return continueLoop;
+}
+
+bool riaecs::SystemLoop::UpdateSystemsConcurrently
+(
+    IECSWorld &ecsWorld, IAssetContainer &assetCont, 
+    const std::vector<ISystem*> &systems, const std::vector<SystemAccess> &accesses, 
+    const std::vector<bool> &isDeclared
+){
+    const size_t systemCount = systems.size();
+
+    // A system waits for the earlier systems conflicting with it
+    // The systems not declaring their access and the ones which may stop the loop wait for or block all others
+    // The systems making structural changes conflict with all others
+    std::vector<std::vector<size_t>> dependents(systemCount);
+    std::vector<size_t> waitCounts(systemCount, 0);
+    for (size_t later = 0; later < systemCount; ++later)
+    {
+        for (size_t earlier = 0; earlier < later; ++earlier)
+        {
+            bool mustWait = 
+                !isDeclared[earlier] || !isDeclared[later] || accesses[earlier].mayStopLoop ||
+                IsConflicting(accesses[earlier], accesses[later]);
+
+            if (mustWait)
+            {
+                dependents[earlier].push_back(later);
+                ++waitCounts[later];
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<size_t> readyIndices;
+    size_t runningCount = 0;
+    bool isStopping = false;
+    std::exception_ptr exception;
+
+    for (size_t i = 0; i < systemCount; ++i)
+    {
+        if (waitCounts[i] == 0)
+            readyIndices.push_back(i);
+    }
+
+    // Must be called with the mutex locked
+    auto finish = [&](size_t index, bool continueLoop, std::exception_ptr updateException)
+    {
+        --runningCount;
+
+        if (updateException && !exception)
+            exception = updateException;
 
         if (!continueLoop)
-            break; // Stop the system loop if any system returns false
+            isStopping = true; // Do not start the remaining systems
+
+        for (size_t dependent : dependents[index])
+        {
+            if (--waitCounts[dependent] == 0)
+                readyIndices.push_back(dependent);
+        }
+    };
+
+    auto update = [&](size_t index, bool &continueLoop, std::exception_ptr &updateException)
+    {
+        try
+        {
+            continueLoop = systems[index]->Update(ecsWorld, assetCont, *systemCommandQueues_[index]);
+        }
+        catch (...)
+        {
+            continueLoop = false;
+            updateException = std::current_exception();
+        }
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        if (!isStopping && !readyIndices.empty())
+        {
+            std::vector<size_t> startIndices;
+            startIndices.swap(readyIndices);
+
+            for (size_t index : startIndices)
+            {
+                ++runningCount;
+
+                if (isDeclared[index])
+                {
+                    workerPool_->Submit([&, index]()
+                    {
+                        bool continueLoop = true;
+                        std::exception_ptr updateException;
+                        update(index, continueLoop, updateException);
+
+                        // Notify with the mutex locked, as the locals are destroyed once the loop thread sees it
+                        std::unique_lock<std::mutex> workerLock(mutex);
+                        finish(index, continueLoop, updateException);
+                        finished.notify_one();
+                    });
+                }
+                else
+                {
+                    // Nothing else is running, and the system may depend on the thread, as a window does
+                    lock.unlock();
+
+                    bool continueLoop = true;
+                    std::exception_ptr updateException;
+                    update(index, continueLoop, updateException);
+
+                    lock.lock();
+                    finish(index, continueLoop, updateException);
+                }
+            }
+            continue;
+        }
+
+        if (runningCount == 0)
+            break; // All systems are updated, or the loop is stopping and the running systems are finished
+
+        finished.wait(lock);
     }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    return !isStopping;
 }
\ No newline at end of file
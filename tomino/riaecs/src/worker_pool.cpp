@@ -0,0 +1,56 @@
+﻿#include "riaecs/src/pch.h"
+#include "riaecs/include/worker_pool.h"
+
+riaecs::WorkerPool::WorkerPool(size_t threadCount)
+{
+    threads_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        threads_.emplace_back(&WorkerPool::WorkerMain, this);
+}
+
+riaecs::WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        isStopping_ = true;
+    }
+    condition_.notify_all();
+
+    // The queued tasks are executed before the threads exit
+    for (std::thread &thread : threads_)
+        thread.join();
+}
+
+void riaecs::WorkerPool::WorkerMain()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return isStopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty())
+                return; // Stopping and no task left
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        task();
+    }
+}
+
+void riaecs::WorkerPool::Submit(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+size_t riaecs::WorkerPool::GetThreadCount() const
+{
+    return threads_.size();
+}
\ No newline at end of file
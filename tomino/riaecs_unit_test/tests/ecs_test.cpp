@@ -7,6 +7,14 @@
 #include "mem_alloc_fixed_block/mem_alloc_fixed_block.h"
 #pragma comment(lib, "mem_alloc_fixed_block.lib")
 
+#include "riaecs/include/types/stl_less.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+
 namespace
 {
     constexpr int INITIAL_A_VALUE = 7;
@@ -239,5 +247,313 @@ TEST(ECS, World)
     systemLoop->Initialize();
     systemLoop->Run(*ecsWorld, *assetContainer);
 
+    ecsWorld->DestroyWorld();
+}
+
+namespace
+{
+    constexpr size_t SPARSE_SET_TEST_MAX_COUNT = 1000;
+    constexpr size_t SPARSE_SET_BENCHMARK_ENTITY_COUNT = 100000;
+
+    class SparseSetAComponent
+    {
+    public:
+        size_t value = 0;
+    };
+    riaecs::ComponentRegistrar<SparseSetAComponent, SPARSE_SET_TEST_MAX_COUNT> SparseSetAComponentID;
+
+    class SparseSetBComponent
+    {
+    public:
+        size_t value = 0;
+    };
+    riaecs::ComponentRegistrar<SparseSetBComponent, SPARSE_SET_TEST_MAX_COUNT> SparseSetBComponentID;
+
+    class SparseSetBenchmarkComponent
+    {
+    public:
+        float value = 1.0f;
+    };
+    riaecs::ComponentRegistrar<SparseSetBenchmarkComponent, SPARSE_SET_BENCHMARK_ENTITY_COUNT> SparseSetBenchmarkComponentID;
+
+    std::unique_ptr<riaecs::IECSWorld> CreateTestWorld()
+    {
+        std::unique_ptr<riaecs::IECSWorld> ecsWorld = std::make_unique<riaecs::ECSWorld>(*riaecs::gComponentFactoryRegistry, *riaecs::gComponentMaxCountRegistry);
+        ecsWorld->SetPoolFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockPoolFactory>());
+        ecsWorld->SetAllocatorFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockAllocatorFactory>());
+        EXPECT_TRUE(ecsWorld->IsReady());
+        ecsWorld->CreateWorld();
+        return ecsWorld;
+    }
+
+    std::set<riaecs::Entity> ViewToSet(riaecs::IECSWorld &ecsWorld, size_t componentID)
+    {
+        std::set<riaecs::Entity> entities;
+        for (const riaecs::Entity &entity : ecsWorld.View(componentID)())
+            EXPECT_TRUE(entities.insert(entity).second); // Each entity appears once
+
+        return entities;
+    }
+
+    // The bookkeeping ECSWorld had before the sparse sets, used as the reference
+    struct MapBookkeeping
+    {
+        std::map<riaecs::Entity, std::set<size_t>> entityToComponents;
+        std::map<size_t, std::set<riaecs::Entity>> componentToEntities;
+        std::map<std::pair<riaecs::Entity, size_t>, size_t, riaecs::PairLess> entityComponentToValue;
+    };
+
+} // namespace
+
+TEST(ECS, SparseSetEquivalence)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateTestWorld();
+    const size_t componentIDs[] = { SparseSetAComponentID(), SparseSetBComponentID() };
+
+    MapBookkeeping reference;
+    std::vector<riaecs::Entity> aliveEntities;
+    std::set<riaecs::Entity> stagingEntities;
+    riaecs::StagingEntityArea stagingArea = ecsWorld->CreateStagingArea();
+
+    std::mt19937 random(7);
+    size_t nextValue = 1;
+
+    auto setValue = [&](const riaecs::Entity &entity, size_t componentID, size_t value)
+    {
+        if (componentID == SparseSetAComponentID())
+            riaecs::GetComponent<SparseSetAComponent>(*ecsWorld, entity, componentID)->value = value;
+        else
+            riaecs::GetComponent<SparseSetBComponent>(*ecsWorld, entity, componentID)->value = value;
+    };
+
+    auto getValue = [&](const riaecs::Entity &entity, size_t componentID) -> size_t
+    {
+        if (componentID == SparseSetAComponentID())
+            return riaecs::GetComponent<SparseSetAComponent>(*ecsWorld, entity, componentID)->value;
+        else
+            return riaecs::GetComponent<SparseSetBComponent>(*ecsWorld, entity, componentID)->value;
+    };
+
+    auto checkSame = [&]()
+    {
+        for (const riaecs::Entity &entity : aliveEntities)
+        {
+            EXPECT_TRUE(ecsWorld->CheckEntityExist(entity));
+            for (size_t componentID : componentIDs)
+            {
+                bool has = reference.entityToComponents[entity].count(componentID) != 0;
+                EXPECT_EQ(ecsWorld->HasComponent(entity, componentID), has);
+                EXPECT_EQ(ecsWorld->GetComponent(entity, componentID) != nullptr, has);
+                if (has)
+                {
+                    EXPECT_EQ(getValue(entity, componentID), (reference.entityComponentToValue[{entity, componentID}]));
+                }
+            }
+        }
+
+        // Staging entities are not in the views until they are committed
+        for (size_t componentID : componentIDs)
+            EXPECT_EQ(ViewToSet(*ecsWorld, componentID), reference.componentToEntities[componentID]);
+    };
+
+    constexpr size_t STEP_COUNT = 20000;
+    constexpr size_t MAX_ALIVE_COUNT = 400;
+    for (size_t step = 0; step < STEP_COUNT; ++step)
+    {
+        uint32_t operation = random() % 100;
+        if (aliveEntities.empty() || (operation < 20 && aliveEntities.size() < MAX_ALIVE_COUNT))
+        {
+            // Create an entity, some of them in the staging area
+            bool isStaging = random() % 4 == 0;
+            riaecs::Entity entity = isStaging ? ecsWorld->CreateEntity(stagingArea) : ecsWorld->CreateEntity();
+            aliveEntities.push_back(entity);
+            reference.entityToComponents[entity];
+            if (isStaging)
+                stagingEntities.insert(entity);
+            continue;
+        }
+
+        riaecs::Entity entity = aliveEntities[random() % aliveEntities.size()];
+        size_t componentID = componentIDs[random() % 2];
+        bool isStaging = stagingEntities.count(entity) != 0;
+        bool has = reference.entityToComponents[entity].count(componentID) != 0;
+
+        if (operation < 30)
+        {
+            // Destroy the entity, its index is reused with the next generation
+            ecsWorld->DestroyEntity(entity);
+            EXPECT_FALSE(ecsWorld->CheckEntityExist(entity));
+
+            for (size_t id : reference.entityToComponents[entity])
+            {
+                reference.componentToEntities[id].erase(entity);
+                reference.entityComponentToValue.erase({entity, id});
+            }
+            reference.entityToComponents.erase(entity);
+            stagingEntities.erase(entity);
+            aliveEntities.erase(std::find(aliveEntities.begin(), aliveEntities.end(), entity));
+        }
+        else if (operation < 70 && !has)
+        {
+            ecsWorld->AddComponent(entity, componentID);
+            setValue(entity, componentID, nextValue);
+
+            reference.entityToComponents[entity].insert(componentID);
+            reference.entityComponentToValue[{entity, componentID}] = nextValue++;
+            if (!isStaging)
+                reference.componentToEntities[componentID].insert(entity);
+        }
+        else if (operation < 90 && has && !isStaging)
+        {
+            ecsWorld->RemoveComponent(entity, componentID);
+
+            reference.entityToComponents[entity].erase(componentID);
+            reference.entityComponentToValue.erase({entity, componentID});
+            reference.componentToEntities[componentID].erase(entity);
+        }
+        else if (operation >= 95)
+        {
+            // Commit the staging entities, including the destroyed ones
+            ecsWorld->CommitEntities(stagingArea);
+            EXPECT_TRUE(stagingArea.empty());
+
+            for (const riaecs::Entity &stagingEntity : stagingEntities)
+            {
+                for (size_t id : reference.entityToComponents[stagingEntity])
+                    reference.componentToEntities[id].insert(stagingEntity);
+            }
+            stagingEntities.clear();
+        }
+
+        if (step % 100 == 0)
+            checkSame();
+    }
+    checkSame();
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(ECS, ViewSpan)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateTestWorld();
+
+    // An empty view
+    EXPECT_TRUE(ecsWorld->View(SparseSetAComponentID())().empty());
+
+    std::vector<riaecs::Entity> entities;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        entities.push_back(ecsWorld->CreateEntity());
+        ecsWorld->AddComponent(entities.back(), SparseSetAComponentID());
+    }
+
+    // The entities are contiguous
+    riaecs::Span<riaecs::Entity> span = ecsWorld->View(SparseSetAComponentID())();
+    EXPECT_EQ(span.size(), entities.size());
+    EXPECT_EQ(span.end() - span.begin(), static_cast<std::ptrdiff_t>(entities.size()));
+    for (size_t i = 0; i < span.size(); ++i)
+        EXPECT_EQ(span[i], entities[i]);
+
+    // Adding the component while iterating does not invalidate the span
+    for (const riaecs::Entity &entity : ecsWorld->View(SparseSetAComponentID())())
+    {
+        riaecs::Entity added = ecsWorld->CreateEntity();
+        ecsWorld->AddComponent(added, SparseSetAComponentID());
+        EXPECT_TRUE(ecsWorld->HasComponent(entity, SparseSetAComponentID()));
+    }
+    EXPECT_EQ(ecsWorld->View(SparseSetAComponentID())().size(), entities.size() * 2);
+    EXPECT_EQ(ecsWorld->View(SparseSetAComponentID())().data(), span.data());
+
+    // An entity reusing the index does not have the components of the destroyed one
+    ecsWorld->DestroyEntity(entities[3]);
+    riaecs::Entity reused = ecsWorld->CreateEntity();
+    EXPECT_EQ(reused.GetIndex(), entities[3].GetIndex());
+    EXPECT_FALSE(ecsWorld->HasComponent(reused, SparseSetAComponentID()));
+    EXPECT_EQ(ecsWorld->GetComponent(reused, SparseSetAComponentID()), nullptr);
+    EXPECT_EQ(ecsWorld->View(SparseSetAComponentID())().size(), entities.size() * 2 - 1);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(ECS, SparseSetBenchmark)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateTestWorld();
+    const size_t componentID = SparseSetBenchmarkComponentID();
+
+    // Every other entity has the component
+    std::vector<riaecs::Entity> entities;
+    MapBookkeeping reference;
+    std::map<std::pair<riaecs::Entity, size_t>, std::byte*, riaecs::PairLess> entityComponentToData;
+    for (size_t i = 0; i < SPARSE_SET_BENCHMARK_ENTITY_COUNT * 2; ++i)
+    {
+        riaecs::Entity entity = ecsWorld->CreateEntity();
+        entities.push_back(entity);
+        if (i % 2 != 0)
+            continue;
+
+        ecsWorld->AddComponent(entity, componentID);
+        reference.entityToComponents[entity].insert(componentID);
+        reference.componentToEntities[componentID].insert(entity);
+        entityComponentToData[{entity, componentID}] = ecsWorld->GetComponent(entity, componentID);
+    }
+
+    constexpr size_t REPEAT = 10;
+
+    // Iterate the view and get each component
+    float viewSum = 0.0f;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : ecsWorld->View(componentID)())
+            viewSum += riaecs::GetComponent<SparseSetBenchmarkComponent>(*ecsWorld, entity, componentID)->value;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double viewMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    // The same with the maps
+    float mapSum = 0.0f;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : reference.componentToEntities[componentID])
+            mapSum += reinterpret_cast<SparseSetBenchmarkComponent*>(entityComponentToData[{entity, componentID}])->value;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double mapViewMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    EXPECT_EQ(viewSum, mapSum);
+
+    // Check every entity for the component
+    size_t hasCount = 0;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : entities)
+            hasCount += ecsWorld->HasComponent(entity, componentID) ? 1 : 0;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double hasMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    size_t mapHasCount = 0;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : entities)
+        {
+            auto it = reference.entityToComponents.find(entity);
+            mapHasCount += (it != reference.entityToComponents.end() && it->second.count(componentID) != 0) ? 1 : 0;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double mapHasMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    EXPECT_EQ(hasCount, SPARSE_SET_BENCHMARK_ENTITY_COUNT * REPEAT);
+    EXPECT_EQ(hasCount, mapHasCount);
+
+    std::cout << "Entities with the component: " << SPARSE_SET_BENCHMARK_ENTITY_COUNT
+        << " of " << entities.size() << std::endl;
+    std::cout << "View and GetComponent, sparse set: " << viewMs << " ms, maps: " << mapViewMs << " ms" << std::endl;
+    std::cout << "HasComponent, sparse set: " << hasMs << " ms, maps: " << mapHasMs << " ms" << std::endl;
+
     ecsWorld->DestroyWorld();
 }
\ No newline at end of file
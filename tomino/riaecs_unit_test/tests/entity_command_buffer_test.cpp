@@ -0,0 +1,416 @@
+﻿#include "riaecs_unit_test/pch.h"
+
+#include "riaecs/include/entity_command_buffer.h"
+#include "riaecs/include/ecs.h"
+#include "riaecs/include/global_registry.h"
+#pragma comment(lib, "riaecs.lib")
+
+#include "mem_alloc_fixed_block/mem_alloc_fixed_block.h"
+#pragma comment(lib, "mem_alloc_fixed_block.lib")
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    constexpr size_t COMMAND_BUFFER_TEST_MAX_COUNT = 20000;
+
+    size_t gCommandBufferTestAliveCount = 0;
+
+    class CommandBufferPositionComponent
+    {
+    public:
+        float x = 0.0f;
+        float y = 0.0f;
+
+        CommandBufferPositionComponent() { ++gCommandBufferTestAliveCount; }
+        ~CommandBufferPositionComponent() { --gCommandBufferTestAliveCount; }
+    };
+    riaecs::ComponentRegistrar<CommandBufferPositionComponent, COMMAND_BUFFER_TEST_MAX_COUNT> CommandBufferPositionComponentID;
+
+    class CommandBufferLifeComponent
+    {
+    public:
+        int frameCount = 1;
+    };
+    riaecs::ComponentRegistrar<CommandBufferLifeComponent, COMMAND_BUFFER_TEST_MAX_COUNT> CommandBufferLifeComponentID;
+
+    std::unique_ptr<riaecs::IECSWorld> CreateCommandBufferTestWorld()
+    {
+        std::unique_ptr<riaecs::IECSWorld> ecsWorld = std::make_unique<riaecs::ECSWorld>(*riaecs::gComponentFactoryRegistry, *riaecs::gComponentMaxCountRegistry);
+        ecsWorld->SetPoolFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockPoolFactory>());
+        ecsWorld->SetAllocatorFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockAllocatorFactory>());
+        EXPECT_TRUE(ecsWorld->IsReady());
+        ecsWorld->CreateWorld();
+        return ecsWorld;
+    }
+
+    void SetPosition(std::byte *data, float x, float y)
+    {
+        CommandBufferPositionComponent *position = reinterpret_cast<CommandBufferPositionComponent*>(data);
+        position->x = x;
+        position->y = y;
+    }
+
+    constexpr size_t COMMAND_BUFFER_TEST_FRAME_COUNT = 3;
+
+    // The number of entities with the position seen by the spawning system in each frame
+    std::vector<size_t> gCommandBufferTestViewCounts;
+
+    // Spawns an entity per frame through its buffer, running on a worker as it makes no structural change itself
+    class CommandBufferSpawnSystem : public riaecs::ISystem
+    {
+    private:
+        std::shared_ptr<riaecs::EntityCommandBuffer> commandBuffer_ = std::make_shared<riaecs::EntityCommandBuffer>();
+
+    public:
+        bool Update
+        (
+            riaecs::IECSWorld &ecsWorld, riaecs::IAssetContainer &assetCont, 
+            riaecs::ISystemLoopCommandQueue &systemLoopCmdQueue
+        ) override
+        {
+            gCommandBufferTestViewCounts.push_back(ecsWorld.View(CommandBufferPositionComponentID())().size());
+
+            riaecs::Entity entity = commandBuffer_->CreateEntity();
+            commandBuffer_->AddComponent(entity, CommandBufferPositionComponentID());
+            systemLoopCmdQueue.Enqueue(std::make_unique<riaecs::EntityCommandPlayback>(commandBuffer_));
+
+            return gCommandBufferTestViewCounts.size() < COMMAND_BUFFER_TEST_FRAME_COUNT;
+        }
+
+        bool DeclareAccess(riaecs::SystemAccess &access) const override
+        {
+            access.readComponentIDs = { CommandBufferPositionComponentID() };
+            access.mayStopLoop = true;
+            return true;
+        }
+    };
+    riaecs::SystemFactoryRegistrar<CommandBufferSpawnSystem> CommandBufferSpawnSystemID;
+
+    class CommandBufferSystemListFactory : public riaecs::ISystemListFactory
+    {
+    public:
+        std::unique_ptr<riaecs::ISystemList> Create() const override
+        {
+            std::unique_ptr<riaecs::ISystemList> systemList = std::make_unique<riaecs::SystemList>();
+            systemList->CreateSystem(CommandBufferSpawnSystemID());
+            systemList->SetOrder({ CommandBufferSpawnSystemID() });
+            return systemList;
+        }
+
+        void Destroy(std::unique_ptr<riaecs::ISystemList> product) const override
+        {
+            product.reset();
+        }
+
+        size_t GetProductSize() const override
+        {
+            return sizeof(riaecs::SystemList);
+        }
+    };
+
+} // namespace
+
+TEST(EntityCommandBuffer, Ordering)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+    riaecs::Entity existing = ecsWorld->CreateEntity();
+    ecsWorld->AddComponent(existing, CommandBufferLifeComponentID());
+
+    riaecs::EntityCommandBuffer commandBuffer;
+
+    // Nothing changes until the buffer is played back
+    riaecs::Entity deferred = commandBuffer.CreateEntity();
+    EXPECT_TRUE(riaecs::EntityCommandBuffer::IsDeferred(deferred));
+    commandBuffer.AddComponent(deferred, CommandBufferPositionComponentID(), [](std::byte *data) { SetPosition(data, 1.0f, 2.0f); });
+    commandBuffer.AddComponent(deferred, CommandBufferLifeComponentID());
+
+    // Removed then added again, the component exists with the initial value
+    commandBuffer.RemoveComponent(existing, CommandBufferLifeComponentID());
+    commandBuffer.AddComponent(existing, CommandBufferLifeComponentID());
+
+    // Added then removed, the component does not exist
+    commandBuffer.AddComponent(existing, CommandBufferPositionComponentID());
+    commandBuffer.RemoveComponent(existing, CommandBufferPositionComponentID());
+
+    riaecs::GetComponent<CommandBufferLifeComponent>(*ecsWorld, existing, CommandBufferLifeComponentID())->frameCount = 5;
+    EXPECT_EQ(ecsWorld->View(CommandBufferPositionComponentID())().size(), 0);
+    EXPECT_EQ(commandBuffer.GetCommands().size(), 7);
+
+    commandBuffer.Playback(*ecsWorld);
+    EXPECT_TRUE(commandBuffer.IsEmpty());
+
+    riaecs::Entity created = commandBuffer.Resolve(deferred);
+    EXPECT_FALSE(riaecs::EntityCommandBuffer::IsDeferred(created));
+    EXPECT_TRUE(ecsWorld->CheckEntityExist(created));
+    EXPECT_EQ(commandBuffer.GetCreatedEntities().size(), 1);
+    EXPECT_EQ(commandBuffer.Resolve(existing), existing);
+
+    CommandBufferPositionComponent *position 
+        = riaecs::GetComponent<CommandBufferPositionComponent>(*ecsWorld, created, CommandBufferPositionComponentID());
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->x, 1.0f);
+    EXPECT_EQ(position->y, 2.0f);
+    EXPECT_TRUE(ecsWorld->HasComponent(created, CommandBufferLifeComponentID()));
+
+    // The created entity is visible at once, not left in a staging area
+    riaecs::Span<riaecs::Entity> view = ecsWorld->View(CommandBufferPositionComponentID())();
+    ASSERT_EQ(view.size(), 1);
+    EXPECT_EQ(view[0], created);
+
+    EXPECT_EQ(riaecs::GetComponent<CommandBufferLifeComponent>(*ecsWorld, existing, CommandBufferLifeComponentID())->frameCount, 1);
+    EXPECT_FALSE(ecsWorld->HasComponent(existing, CommandBufferPositionComponentID()));
+
+    // Buffers played back one after another apply in that order
+    riaecs::EntityCommandBuffer first;
+    riaecs::EntityCommandBuffer second;
+    first.RemoveComponent(created, CommandBufferLifeComponentID());
+    second.AddComponent(created, CommandBufferLifeComponentID());
+    first.Playback(*ecsWorld);
+    second.Playback(*ecsWorld);
+    EXPECT_TRUE(ecsWorld->HasComponent(created, CommandBufferLifeComponentID()));
+
+    // A deferred entity from another buffer is an error
+    riaecs::EntityCommandBuffer invalid;
+    invalid.AddComponent(deferred, CommandBufferLifeComponentID());
+    EXPECT_THROW(invalid.Playback(*ecsWorld), std::runtime_error);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(EntityCommandBuffer, DestroyAfterCreate)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+    size_t aliveCount = gCommandBufferTestAliveCount;
+
+    riaecs::EntityCommandBuffer commandBuffer;
+    riaecs::Entity destroyed = commandBuffer.CreateEntity();
+    commandBuffer.AddComponent(destroyed, CommandBufferPositionComponentID());
+    commandBuffer.DestroyEntity(destroyed);
+
+    // Commands after the destruction are skipped
+    commandBuffer.AddComponent(destroyed, CommandBufferLifeComponentID());
+    commandBuffer.DestroyEntity(destroyed);
+
+    // The freed index is reused by the next entity in the same buffer
+    riaecs::Entity reused = commandBuffer.CreateEntity();
+    commandBuffer.AddComponent(reused, CommandBufferPositionComponentID());
+
+    commandBuffer.Playback(*ecsWorld);
+
+    riaecs::Entity destroyedEntity = commandBuffer.Resolve(destroyed);
+    riaecs::Entity reusedEntity = commandBuffer.Resolve(reused);
+    EXPECT_FALSE(ecsWorld->CheckEntityExist(destroyedEntity));
+    EXPECT_TRUE(ecsWorld->CheckEntityExist(reusedEntity));
+    EXPECT_EQ(reusedEntity.GetIndex(), destroyedEntity.GetIndex());
+    EXPECT_EQ(reusedEntity.GetGeneration(), destroyedEntity.GetGeneration() + 1);
+
+    // The component of the destroyed entity is destructed
+    EXPECT_EQ(gCommandBufferTestAliveCount, aliveCount + 1);
+    EXPECT_EQ(ecsWorld->View(CommandBufferPositionComponentID())().size(), 1);
+    EXPECT_EQ(ecsWorld->View(CommandBufferLifeComponentID())().size(), 0);
+
+    // An entity destroyed after being recorded is skipped, as the recording thread could not know
+    riaecs::EntityCommandBuffer stale;
+    stale.AddComponent(reusedEntity, CommandBufferLifeComponentID());
+    stale.DestroyEntity(reusedEntity);
+    ecsWorld->DestroyEntity(reusedEntity);
+    EXPECT_NO_THROW(stale.Playback(*ecsWorld));
+    EXPECT_EQ(gCommandBufferTestAliveCount, aliveCount);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(EntityCommandBuffer, Threads)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+
+    // Each thread records into its own buffer without locking the world
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t ENTITY_COUNT_PER_THREAD = 1000;
+    std::vector<riaecs::EntityCommandBuffer> commandBuffers(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; ++t)
+    {
+        threads.emplace_back([&commandBuffers, t]()
+        {
+            for (size_t i = 0; i < ENTITY_COUNT_PER_THREAD; ++i)
+            {
+                riaecs::Entity entity = commandBuffers[t].CreateEntity();
+                commandBuffers[t].AddComponent(entity, CommandBufferPositionComponentID(), [t, i](std::byte *data)
+                {
+                    SetPosition(data, static_cast<float>(t), static_cast<float>(i));
+                });
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // Played back at the sync point in a fixed order
+    for (riaecs::EntityCommandBuffer &commandBuffer : commandBuffers)
+        commandBuffer.Playback(*ecsWorld);
+
+    EXPECT_EQ(ecsWorld->View(CommandBufferPositionComponentID())().size(), THREAD_COUNT * ENTITY_COUNT_PER_THREAD);
+    for (size_t t = 0; t < THREAD_COUNT; ++t)
+    {
+        const std::vector<riaecs::Entity> &createdEntities = commandBuffers[t].GetCreatedEntities();
+        ASSERT_EQ(createdEntities.size(), ENTITY_COUNT_PER_THREAD);
+        for (size_t i = 0; i < ENTITY_COUNT_PER_THREAD; ++i)
+        {
+            CommandBufferPositionComponent *position = riaecs::GetComponent<CommandBufferPositionComponent>(
+                *ecsWorld, createdEntities[i], CommandBufferPositionComponentID());
+            EXPECT_EQ(position->x, static_cast<float>(t));
+            EXPECT_EQ(position->y, static_cast<float>(i));
+        }
+    }
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(EntityCommandBuffer, InvalidCommand)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+    riaecs::Entity existing = ecsWorld->CreateEntity();
+    ecsWorld->AddComponent(existing, CommandBufferLifeComponentID());
+    size_t aliveCount = gCommandBufferTestAliveCount;
+
+    // The valid commands before the invalid one are not executed either
+    riaecs::EntityCommandBuffer commandBuffer;
+    riaecs::Entity deferred = commandBuffer.CreateEntity();
+    commandBuffer.AddComponent(deferred, CommandBufferPositionComponentID());
+    commandBuffer.AddComponent(existing, CommandBufferPositionComponentID());
+    commandBuffer.AddComponent(existing, CommandBufferLifeComponentID());
+    EXPECT_THROW(commandBuffer.Playback(*ecsWorld), std::runtime_error);
+
+    EXPECT_EQ(gCommandBufferTestAliveCount, aliveCount);
+    EXPECT_EQ(ecsWorld->View(CommandBufferPositionComponentID())().size(), 0);
+    EXPECT_FALSE(ecsWorld->CheckEntityExist(riaecs::Entity(existing.GetIndex() + 1, riaecs::ID_DEFAULT_GENERATION)));
+
+    // Added twice in the same buffer
+    riaecs::EntityCommandBuffer twice;
+    riaecs::Entity twiceDeferred = twice.CreateEntity();
+    twice.AddComponent(twiceDeferred, CommandBufferPositionComponentID());
+    twice.AddComponent(twiceDeferred, CommandBufferPositionComponentID());
+    EXPECT_THROW(twice.Playback(*ecsWorld), std::runtime_error);
+    EXPECT_EQ(gCommandBufferTestAliveCount, aliveCount);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(EntityCommandBuffer, SystemLoopPlayback)
+{
+    gCommandBufferTestViewCounts.clear();
+
+    std::unique_ptr<riaecs::IAssetContainer> assetContainer = std::make_unique<riaecs::AssetContainer>();
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+
+    std::unique_ptr<riaecs::SystemLoop> systemLoop = std::make_unique<riaecs::SystemLoop>();
+    systemLoop->SetSystemListFactory(std::make_unique<CommandBufferSystemListFactory>());
+    systemLoop->SetSystemLoopCommandQueueFactory(std::make_unique<riaecs::DefaultSystemLoopCommandQueueFactory>());
+    systemLoop->SetWorkerCount(2);
+    EXPECT_TRUE(systemLoop->IsReady());
+    systemLoop->Initialize();
+
+    systemLoop->Run(*ecsWorld, *assetContainer);
+
+    // The entity recorded in a frame exists from the next frame
+    std::vector<size_t> expected = { 0, 1, 2 };
+    EXPECT_EQ(gCommandBufferTestViewCounts, expected);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(EntityCommandBuffer, Benchmark)
+{
+    // Spawn 10k entities per frame and destroy the ones spawned in the previous frame, as bullets do
+    constexpr size_t SPAWN_COUNT = 10000;
+    constexpr size_t FRAME_COUNT = 30;
+    constexpr size_t THREAD_COUNT = 4;
+
+    auto benchmark = [&](const char *name, auto frame)
+    {
+        std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateCommandBufferTestWorld();
+        std::vector<riaecs::Entity> previous;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (size_t f = 0; f < FRAME_COUNT; ++f)
+            frame(*ecsWorld, previous);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        EXPECT_EQ(ecsWorld->View(CommandBufferPositionComponentID())().size(), SPAWN_COUNT);
+        std::cout << name << ": " 
+            << std::chrono::duration<double, std::milli>(end - begin).count() / FRAME_COUNT << " ms per frame" << std::endl;
+
+        ecsWorld->DestroyWorld();
+    };
+
+    // Each thread spawns and destroys its share, the previous entities are split the same way
+    auto spawnImmediate = [&](riaecs::IECSWorld &ecsWorld, const riaecs::Entity *toDestroy, size_t destroyCount, riaecs::Entity *spawned)
+    {
+        for (size_t i = 0; i < destroyCount; ++i)
+            ecsWorld.DestroyEntity(toDestroy[i]);
+
+        for (size_t i = 0; i < SPAWN_COUNT / THREAD_COUNT; ++i)
+        {
+            riaecs::Entity entity = ecsWorld.CreateEntity();
+            ecsWorld.AddComponent(entity, CommandBufferPositionComponentID());
+            SetPosition(ecsWorld.GetComponent(entity, CommandBufferPositionComponentID()), 1.0f, 2.0f);
+            ecsWorld.AddComponent(entity, CommandBufferLifeComponentID());
+            spawned[i] = entity;
+        }
+    };
+
+    auto spawnDeferred = [&](riaecs::EntityCommandBuffer &commandBuffer, const riaecs::Entity *toDestroy, size_t destroyCount)
+    {
+        for (size_t i = 0; i < destroyCount; ++i)
+            commandBuffer.DestroyEntity(toDestroy[i]);
+
+        for (size_t i = 0; i < SPAWN_COUNT / THREAD_COUNT; ++i)
+        {
+            riaecs::Entity entity = commandBuffer.CreateEntity();
+            commandBuffer.AddComponent(entity, CommandBufferPositionComponentID(), [](std::byte *data) { SetPosition(data, 1.0f, 2.0f); });
+            commandBuffer.AddComponent(entity, CommandBufferLifeComponentID());
+        }
+    };
+
+    auto runThreads = [&](auto work)
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; ++t)
+            threads.emplace_back(work, t);
+        for (std::thread &thread : threads)
+            thread.join();
+    };
+
+    benchmark("Immediate, 4 threads", [&](riaecs::IECSWorld &ecsWorld, std::vector<riaecs::Entity> &previous)
+    {
+        std::vector<riaecs::Entity> spawned(SPAWN_COUNT);
+        size_t share = previous.size() / THREAD_COUNT;
+        runThreads([&](size_t t)
+        {
+            spawnImmediate(
+                ecsWorld, previous.data() + t * share, share, spawned.data() + t * (SPAWN_COUNT / THREAD_COUNT));
+        });
+        previous = std::move(spawned);
+    });
+
+    std::vector<riaecs::EntityCommandBuffer> commandBuffers(THREAD_COUNT);
+    benchmark("Command buffers, 4 threads", [&](riaecs::IECSWorld &ecsWorld, std::vector<riaecs::Entity> &previous)
+    {
+        size_t share = previous.size() / THREAD_COUNT;
+        runThreads([&](size_t t)
+        {
+            spawnDeferred(commandBuffers[t], previous.data() + t * share, share);
+        });
+
+        // The sync point
+        previous.clear();
+        for (riaecs::EntityCommandBuffer &commandBuffer : commandBuffers)
+        {
+            commandBuffer.Playback(ecsWorld);
+            previous.insert(previous.end(), commandBuffer.GetCreatedEntities().begin(), commandBuffer.GetCreatedEntities().end());
+        }
+    });
+}
\ No newline at end of file
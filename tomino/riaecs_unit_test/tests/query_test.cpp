@@ -0,0 +1,287 @@
+﻿#include "riaecs_unit_test/pch.h"
+
+#include "riaecs/include/query.h"
+#include "riaecs/include/ecs.h"
+#include "riaecs/include/global_registry.h"
+#pragma comment(lib, "riaecs.lib")
+
+#include "mem_alloc_fixed_block/mem_alloc_fixed_block.h"
+#pragma comment(lib, "mem_alloc_fixed_block.lib")
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace
+{
+    constexpr size_t QUERY_TEST_MAX_COUNT = 100000;
+
+    class QueryAComponent
+    {
+    public:
+        size_t value = 0;
+    };
+    riaecs::ComponentRegistrar<QueryAComponent, QUERY_TEST_MAX_COUNT> QueryAComponentID;
+
+    class QueryBComponent
+    {
+    public:
+        float value = 1.0f;
+    };
+    riaecs::ComponentRegistrar<QueryBComponent, QUERY_TEST_MAX_COUNT> QueryBComponentID;
+
+    class QueryCComponent
+    {
+    public:
+        float value = 2.0f;
+    };
+    riaecs::ComponentRegistrar<QueryCComponent, QUERY_TEST_MAX_COUNT> QueryCComponentID;
+
+    std::unique_ptr<riaecs::IECSWorld> CreateQueryTestWorld()
+    {
+        std::unique_ptr<riaecs::IECSWorld> ecsWorld = std::make_unique<riaecs::ECSWorld>(*riaecs::gComponentFactoryRegistry, *riaecs::gComponentMaxCountRegistry);
+        ecsWorld->SetPoolFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockPoolFactory>());
+        ecsWorld->SetAllocatorFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockAllocatorFactory>());
+        EXPECT_TRUE(ecsWorld->IsReady());
+        ecsWorld->CreateWorld();
+        return ecsWorld;
+    }
+
+    // Check the query against HasComponent and GetComponent of every alive entity
+    // Staging entities have their components but are not queried until they are committed
+    void ExpectSameAsLookup
+    (
+        riaecs::IECSWorld &ecsWorld, const std::vector<riaecs::Entity> &aliveEntities, 
+        const riaecs::StagingEntityArea &stagingArea
+    ){
+        std::set<riaecs::Entity> queried;
+        for (auto [entity, a, b] : riaecs::Query<QueryAComponent, QueryBComponent>(
+            ecsWorld, { QueryAComponentID(), QueryBComponentID() }))
+        {
+            EXPECT_TRUE(queried.insert(entity).second); // Each entity appears once
+            EXPECT_TRUE(ecsWorld.CheckEntityExist(entity));
+            EXPECT_EQ(a, riaecs::GetComponent<QueryAComponent>(ecsWorld, entity, QueryAComponentID()));
+            EXPECT_EQ(b, riaecs::GetComponent<QueryBComponent>(ecsWorld, entity, QueryBComponentID()));
+            EXPECT_EQ(a->value, entity.GetIndex() * 10 + entity.GetGeneration());
+        }
+
+        std::set<riaecs::Entity> expected;
+        for (const riaecs::Entity &entity : aliveEntities)
+        {
+            if (std::find(stagingArea.begin(), stagingArea.end(), entity) != stagingArea.end())
+                continue;
+
+            if (ecsWorld.HasComponent(entity, QueryAComponentID()) && ecsWorld.HasComponent(entity, QueryBComponentID()))
+                expected.insert(entity);
+        }
+
+        EXPECT_EQ(queried, expected);
+    }
+
+} // namespace
+
+TEST(Query, Match)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateQueryTestWorld();
+
+    // Entities with every combination of the components
+    std::vector<riaecs::Entity> entities;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        riaecs::Entity entity = ecsWorld->CreateEntity();
+        entities.push_back(entity);
+
+        if (i % 2 == 0)
+        {
+            ecsWorld->AddComponent(entity, QueryAComponentID());
+            riaecs::GetComponent<QueryAComponent>(*ecsWorld, entity, QueryAComponentID())->value 
+                = entity.GetIndex() * 10 + entity.GetGeneration();
+        }
+        if (i % 3 == 0)
+            ecsWorld->AddComponent(entity, QueryBComponentID());
+        if (i % 5 == 0)
+            ecsWorld->AddComponent(entity, QueryCComponentID());
+    }
+
+    ExpectSameAsLookup(*ecsWorld, entities, ecsWorld->CreateStagingArea());
+
+    // The component pointers are in the order of the types
+    size_t count = 0;
+    for (auto [entity, c, a, b] : riaecs::Query<QueryCComponent, QueryAComponent, QueryBComponent>(
+        *ecsWorld, { QueryCComponentID(), QueryAComponentID(), QueryBComponentID() }))
+    {
+        EXPECT_EQ(entity.GetIndex() % 30, 0);
+        EXPECT_EQ(c->value, 2.0f);
+        EXPECT_EQ(b->value, 1.0f);
+        EXPECT_EQ(a->value, entity.GetIndex() * 10 + entity.GetGeneration());
+        ++count;
+    }
+    EXPECT_EQ(count, 3); // 0, 30, 60
+
+    // The component with the fewest entities drives the iteration, so the order follows its view
+    riaecs::Query<QueryAComponent, QueryCComponent> query(*ecsWorld, { QueryAComponentID(), QueryCComponentID() });
+    std::vector<riaecs::Entity> expected;
+    for (const riaecs::Entity &entity : ecsWorld->View(QueryCComponentID())())
+    {
+        if (ecsWorld->HasComponent(entity, QueryAComponentID()))
+            expected.push_back(entity);
+    }
+    ASSERT_EQ(query.GetCount(), expected.size());
+    for (size_t i = 0; i < query.GetCount(); ++i)
+        EXPECT_EQ(std::get<0>(query.Get(i)), expected[i]);
+
+    // A single component query is the same as the view
+    riaecs::Query<QueryBComponent> single(*ecsWorld, { QueryBComponentID() });
+    riaecs::Span<riaecs::Entity> view = ecsWorld->View(QueryBComponentID())();
+    ASSERT_EQ(single.GetCount(), view.size());
+    for (size_t i = 0; i < view.size(); ++i)
+        EXPECT_EQ(std::get<0>(single.Get(i)), view[i]);
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(Query, CreateAndDestroy)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateQueryTestWorld();
+
+    std::vector<riaecs::Entity> aliveEntities;
+    riaecs::StagingEntityArea stagingArea = ecsWorld->CreateStagingArea();
+    std::mt19937 random(11);
+
+    for (size_t round = 0; round < 50; ++round)
+    {
+        // Create entities, some of them in the staging area
+        for (size_t i = 0; i < 40; ++i)
+        {
+            bool isStaging = random() % 5 == 0;
+            riaecs::Entity entity = isStaging ? ecsWorld->CreateEntity(stagingArea) : ecsWorld->CreateEntity();
+            aliveEntities.push_back(entity);
+
+            if (random() % 3 != 0)
+            {
+                ecsWorld->AddComponent(entity, QueryAComponentID());
+                riaecs::GetComponent<QueryAComponent>(*ecsWorld, entity, QueryAComponentID())->value 
+                    = entity.GetIndex() * 10 + entity.GetGeneration();
+            }
+            if (random() % 2 != 0)
+                ecsWorld->AddComponent(entity, QueryBComponentID());
+        }
+
+        // Staging entities are not queried until they are committed
+        for (auto [entity, a, b] : riaecs::Query<QueryAComponent, QueryBComponent>(
+            *ecsWorld, { QueryAComponentID(), QueryBComponentID() }))
+        {
+            EXPECT_EQ(std::find(stagingArea.begin(), stagingArea.end(), entity), stagingArea.end());
+        }
+
+        if (round % 3 == 0)
+            ecsWorld->CommitEntities(stagingArea);
+
+        // Destroy the queried entities after iterating, the indices are reused by the next round
+        std::vector<riaecs::Entity> toDestroy;
+        for (auto [entity, a, b] : riaecs::Query<QueryAComponent, QueryBComponent>(
+            *ecsWorld, { QueryAComponentID(), QueryBComponentID() }))
+        {
+            if (random() % 4 == 0)
+                toDestroy.push_back(entity);
+        }
+
+        for (const riaecs::Entity &entity : toDestroy)
+        {
+            ecsWorld->DestroyEntity(entity);
+            aliveEntities.erase(std::find(aliveEntities.begin(), aliveEntities.end(), entity));
+        }
+
+        ExpectSameAsLookup(*ecsWorld, aliveEntities, stagingArea);
+    }
+
+    ecsWorld->DestroyWorld();
+}
+
+TEST(Query, Benchmark)
+{
+    std::unique_ptr<riaecs::IECSWorld> ecsWorld = CreateQueryTestWorld();
+
+    // Every entity has A and B, one in ten also has C
+    constexpr size_t ENTITY_COUNT = 100000;
+    for (size_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        riaecs::Entity entity = ecsWorld->CreateEntity();
+        ecsWorld->AddComponent(entity, QueryAComponentID());
+        ecsWorld->AddComponent(entity, QueryBComponentID());
+        if (i % 10 == 0)
+            ecsWorld->AddComponent(entity, QueryCComponentID());
+    }
+
+    constexpr size_t REPEAT = 10;
+
+    // View over A, then GetComponent for the others as the systems do
+    float viewSum = 0.0f;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : ecsWorld->View(QueryAComponentID())())
+        {
+            QueryBComponent *b = riaecs::GetComponent<QueryBComponent>(*ecsWorld, entity, QueryBComponentID());
+            QueryCComponent *c = riaecs::GetComponent<QueryCComponent>(*ecsWorld, entity, QueryCComponentID());
+            if (b != nullptr && c != nullptr)
+                viewSum += b->value + c->value;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double viewMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    // The same with a query, which is driven by C
+    float querySum = 0.0f;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (auto [entity, a, b, c] : riaecs::Query<QueryAComponent, QueryBComponent, QueryCComponent>(
+            *ecsWorld, { QueryAComponentID(), QueryBComponentID(), QueryCComponentID() }))
+        {
+            querySum += b->value + c->value;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double queryMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    EXPECT_EQ(viewSum, querySum);
+
+    // Every entity matches
+    float viewAllSum = 0.0f;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (const riaecs::Entity &entity : ecsWorld->View(QueryAComponentID())())
+        {
+            QueryAComponent *a = riaecs::GetComponent<QueryAComponent>(*ecsWorld, entity, QueryAComponentID());
+            QueryBComponent *b = riaecs::GetComponent<QueryBComponent>(*ecsWorld, entity, QueryBComponentID());
+            viewAllSum += static_cast<float>(a->value) + b->value;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double viewAllMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    float queryAllSum = 0.0f;
+    begin = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < REPEAT; ++r)
+    {
+        for (auto [entity, a, b] : riaecs::Query<QueryAComponent, QueryBComponent>(
+            *ecsWorld, { QueryAComponentID(), QueryBComponentID() }))
+        {
+            queryAllSum += static_cast<float>(a->value) + b->value;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double queryAllMs = std::chrono::duration<double, std::milli>(end - begin).count() / REPEAT;
+
+    EXPECT_EQ(viewAllSum, queryAllSum);
+
+    std::cout << "Entities: " << ENTITY_COUNT << std::endl;
+    std::cout << "A, B and C (one in ten), View+GetComponent: " << viewMs << " ms, Query: " << queryMs << " ms" << std::endl;
+    std::cout << "A and B (all), View+GetComponent: " << viewAllMs << " ms, Query: " << queryAllMs << " ms" << std::endl;
+
+    ecsWorld->DestroyWorld();
+}
\ No newline at end of file
@@ -0,0 +1,354 @@
+﻿#include "riaecs_unit_test/pch.h"
+
+#include "riaecs/include/ecs.h"
+#include "riaecs/include/global_registry.h"
+#pragma comment(lib, "riaecs.lib")
+
+#include "mem_alloc_fixed_block/mem_alloc_fixed_block.h"
+#pragma comment(lib, "mem_alloc_fixed_block.lib")
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    constexpr size_t LOOP_TEST_SLOT_COUNT = 5;
+    constexpr size_t LOOP_TEST_NO_STOP = SIZE_MAX;
+
+    // The longest time the meeting systems wait for each other
+    constexpr std::chrono::milliseconds LOOP_TEST_MEET_TIMEOUT = std::chrono::milliseconds(2000);
+
+    // How a test system behaves and what it recorded in its last update
+    struct LoopTestSlot
+    {
+        bool isDeclared = false;
+        riaecs::SystemAccess access;
+        std::chrono::milliseconds workTime = std::chrono::milliseconds(0);
+        size_t stopFrameCount = LOOP_TEST_NO_STOP; // Returns false in this frame
+        size_t meetCount = 0; // Waits for this number of systems to be updating at once
+        bool isThrowing = false;
+
+        std::atomic<size_t> updateCount = 0;
+        size_t beginTick = 0;
+        size_t endTick = 0;
+        std::thread::id threadID;
+        bool hasMet = false;
+    };
+    LoopTestSlot gLoopTestSlots[LOOP_TEST_SLOT_COUNT];
+
+    std::atomic<size_t> gLoopTestTick = 0;
+    std::atomic<size_t> gLoopTestMeetingCount = 0;
+
+    std::mutex gLoopTestCommandLogMutex;
+    std::vector<size_t> gLoopTestCommandLog;
+
+    std::vector<size_t> gLoopTestOrder;
+
+    void ResetLoopTest()
+    {
+        for (LoopTestSlot &slot : gLoopTestSlots)
+        {
+            slot.isDeclared = false;
+            slot.access = riaecs::SystemAccess();
+            slot.workTime = std::chrono::milliseconds(0);
+            slot.stopFrameCount = LOOP_TEST_NO_STOP;
+            slot.meetCount = 0;
+            slot.isThrowing = false;
+
+            slot.updateCount = 0;
+            slot.beginTick = 0;
+            slot.endTick = 0;
+            slot.threadID = std::thread::id();
+            slot.hasMet = false;
+        }
+
+        gLoopTestTick = 0;
+        gLoopTestMeetingCount = 0;
+        gLoopTestCommandLog.clear();
+        gLoopTestOrder.clear();
+    }
+
+    void DeclareLoopTestSlot
+    (
+        size_t slotIndex, std::vector<size_t> readIDs, std::vector<size_t> writeIDs, bool mayStopLoop
+    ){
+        LoopTestSlot &slot = gLoopTestSlots[slotIndex];
+        slot.isDeclared = true;
+        slot.access.readComponentIDs = std::move(readIDs);
+        slot.access.writeComponentIDs = std::move(writeIDs);
+        slot.access.mayStopLoop = mayStopLoop;
+    }
+
+    class LoopTestCommand : public riaecs::ISystemLoopCommand
+    {
+    private:
+        size_t slotIndex_;
+
+    public:
+        LoopTestCommand(size_t slotIndex) : slotIndex_(slotIndex) {}
+
+        void Execute(riaecs::ISystemList &systemList, riaecs::IECSWorld &ecsWorld, riaecs::IAssetContainer &assetCont) const override
+        {
+            std::unique_lock<std::mutex> lock(gLoopTestCommandLogMutex);
+            gLoopTestCommandLog.push_back(slotIndex_);
+        }
+
+        std::unique_ptr<riaecs::ISystemLoopCommand> Clone() const override
+        {
+            return std::make_unique<LoopTestCommand>(slotIndex_);
+        }
+    };
+
+    template <size_t SLOT_INDEX>
+    class LoopTestSystem : public riaecs::ISystem
+    {
+    public:
+        bool Update
+        (
+            riaecs::IECSWorld &ecsWorld, riaecs::IAssetContainer &assetCont, 
+            riaecs::ISystemLoopCommandQueue &systemLoopCmdQueue
+        ) override
+        {
+            LoopTestSlot &slot = gLoopTestSlots[SLOT_INDEX];
+            slot.beginTick = gLoopTestTick++;
+            slot.threadID = std::this_thread::get_id();
+            size_t frame = slot.updateCount++;
+
+            if (slot.meetCount != 0)
+            {
+                ++gLoopTestMeetingCount;
+
+                auto begin = std::chrono::steady_clock::now();
+                while (gLoopTestMeetingCount.load() < slot.meetCount)
+                {
+                    if (std::chrono::steady_clock::now() - begin > LOOP_TEST_MEET_TIMEOUT)
+                        break;
+                    std::this_thread::yield();
+                }
+                slot.hasMet = gLoopTestMeetingCount.load() >= slot.meetCount;
+            }
+
+            std::this_thread::sleep_for(slot.workTime);
+            systemLoopCmdQueue.Enqueue(std::make_unique<LoopTestCommand>(SLOT_INDEX));
+
+            slot.endTick = gLoopTestTick++;
+
+            if (slot.isThrowing)
+                throw std::runtime_error("LoopTestSystem failed");
+
+            return frame + 1 < slot.stopFrameCount;
+        }
+
+        bool DeclareAccess(riaecs::SystemAccess &access) const override
+        {
+            const LoopTestSlot &slot = gLoopTestSlots[SLOT_INDEX];
+            if (!slot.isDeclared)
+                return false;
+
+            access = slot.access;
+            return true;
+        }
+    };
+    riaecs::SystemFactoryRegistrar<LoopTestSystem<0>> LoopTestSystem0ID;
+    riaecs::SystemFactoryRegistrar<LoopTestSystem<1>> LoopTestSystem1ID;
+    riaecs::SystemFactoryRegistrar<LoopTestSystem<2>> LoopTestSystem2ID;
+    riaecs::SystemFactoryRegistrar<LoopTestSystem<3>> LoopTestSystem3ID;
+    riaecs::SystemFactoryRegistrar<LoopTestSystem<4>> LoopTestSystem4ID;
+
+    size_t GetLoopTestSystemID(size_t slotIndex)
+    {
+        switch (slotIndex)
+        {
+        case 0: return LoopTestSystem0ID();
+        case 1: return LoopTestSystem1ID();
+        case 2: return LoopTestSystem2ID();
+        case 3: return LoopTestSystem3ID();
+        case 4: return LoopTestSystem4ID();
+        default: throw std::out_of_range("Invalid loop test slot");
+        }
+    }
+
+    class LoopTestSystemListFactory : public riaecs::ISystemListFactory
+    {
+    public:
+        std::unique_ptr<riaecs::ISystemList> Create() const override
+        {
+            std::unique_ptr<riaecs::ISystemList> systemList = std::make_unique<riaecs::SystemList>();
+
+            for (size_t systemID : gLoopTestOrder)
+                systemList->CreateSystem(systemID);
+            systemList->SetOrder(gLoopTestOrder);
+
+            return systemList;
+        }
+
+        void Destroy(std::unique_ptr<riaecs::ISystemList> product) const override
+        {
+            product.reset();
+        }
+
+        size_t GetProductSize() const override
+        {
+            return sizeof(riaecs::SystemList);
+        }
+    };
+
+    // Run the loop of the slots in the order until a system stops it
+    void RunLoopTest(size_t workerCount, size_t slotCount)
+    {
+        gLoopTestOrder.clear();
+        for (size_t i = 0; i < slotCount; ++i)
+            gLoopTestOrder.push_back(GetLoopTestSystemID(i));
+
+        std::unique_ptr<riaecs::IAssetContainer> assetContainer = std::make_unique<riaecs::AssetContainer>();
+
+        std::unique_ptr<riaecs::IECSWorld> ecsWorld = std::make_unique<riaecs::ECSWorld>(*riaecs::gComponentFactoryRegistry, *riaecs::gComponentMaxCountRegistry);
+        ecsWorld->SetPoolFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockPoolFactory>());
+        ecsWorld->SetAllocatorFactory(std::make_unique<mem_alloc_fixed_block::FixedBlockAllocatorFactory>());
+        ecsWorld->CreateWorld();
+
+        std::unique_ptr<riaecs::SystemLoop> systemLoop = std::make_unique<riaecs::SystemLoop>();
+        systemLoop->SetSystemListFactory(std::make_unique<LoopTestSystemListFactory>());
+        systemLoop->SetSystemLoopCommandQueueFactory(std::make_unique<riaecs::DefaultSystemLoopCommandQueueFactory>());
+        systemLoop->SetWorkerCount(workerCount);
+        EXPECT_TRUE(systemLoop->IsReady());
+        systemLoop->Initialize();
+
+        systemLoop->Run(*ecsWorld, *assetContainer);
+
+        ecsWorld->DestroyWorld();
+    }
+
+} // namespace
+
+TEST(SystemLoop, ConcurrentDisjoint)
+{
+    ResetLoopTest();
+
+    // Three systems writing different components meet while updating
+    for (size_t i = 0; i < 3; ++i)
+    {
+        DeclareLoopTestSlot(i, {}, { 100 + i }, false);
+        gLoopTestSlots[i].meetCount = 3;
+    }
+
+    // Reads what the first one writes, so it waits for it
+    DeclareLoopTestSlot(3, { 100 }, {}, true);
+    gLoopTestSlots[3].stopFrameCount = 1;
+
+    RunLoopTest(3, 4);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(gLoopTestSlots[i].hasMet);
+        EXPECT_EQ(gLoopTestSlots[i].updateCount.load(), 1);
+    }
+    EXPECT_NE(gLoopTestSlots[0].threadID, gLoopTestSlots[1].threadID);
+    EXPECT_GT(gLoopTestSlots[3].beginTick, gLoopTestSlots[0].endTick);
+}
+
+TEST(SystemLoop, ConflictOrder)
+{
+    ResetLoopTest();
+
+    // Write, read and write the same component, the first one being the slowest
+    DeclareLoopTestSlot(0, {}, { 100 }, false);
+    gLoopTestSlots[0].workTime = std::chrono::milliseconds(20);
+    DeclareLoopTestSlot(1, { 100 }, {}, false);
+    gLoopTestSlots[1].workTime = std::chrono::milliseconds(10);
+    DeclareLoopTestSlot(2, {}, { 100 }, false);
+
+    // Unrelated to the others
+    DeclareLoopTestSlot(3, { 200 }, { 201 }, false);
+
+    // Not declared, so it runs alone on the thread calling Run
+    gLoopTestSlots[4].stopFrameCount = 3;
+
+    RunLoopTest(4, 5);
+
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT_EQ(gLoopTestSlots[i].updateCount.load(), 3);
+
+    EXPECT_GT(gLoopTestSlots[1].beginTick, gLoopTestSlots[0].endTick);
+    EXPECT_GT(gLoopTestSlots[2].beginTick, gLoopTestSlots[1].endTick);
+
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_GT(gLoopTestSlots[4].beginTick, gLoopTestSlots[i].endTick);
+    EXPECT_EQ(gLoopTestSlots[4].threadID, std::this_thread::get_id());
+}
+
+TEST(SystemLoop, StructuralChange)
+{
+    ResetLoopTest();
+
+    // Disjoint accesses, but the middle one makes structural changes, so nothing runs with it
+    DeclareLoopTestSlot(0, {}, { 100 }, false);
+    gLoopTestSlots[0].workTime = std::chrono::milliseconds(10);
+    DeclareLoopTestSlot(1, {}, { 101 }, false);
+    gLoopTestSlots[1].access.hasStructuralChange = true;
+    gLoopTestSlots[1].workTime = std::chrono::milliseconds(10);
+    DeclareLoopTestSlot(2, {}, { 102 }, true);
+    gLoopTestSlots[2].stopFrameCount = 1;
+
+    RunLoopTest(3, 3);
+
+    EXPECT_GT(gLoopTestSlots[1].beginTick, gLoopTestSlots[0].endTick);
+    EXPECT_GT(gLoopTestSlots[2].beginTick, gLoopTestSlots[1].endTick);
+}
+
+TEST(SystemLoop, EarlyExit)
+{
+    for (size_t workerCount : { size_t(0), size_t(4) })
+    {
+        ResetLoopTest();
+
+        // May stop the loop, so the later ones are not updated in the frame it does
+        DeclareLoopTestSlot(0, {}, { 100 }, true);
+        gLoopTestSlots[0].stopFrameCount = 2;
+        DeclareLoopTestSlot(1, {}, { 101 }, false);
+        DeclareLoopTestSlot(2, {}, { 102 }, false);
+
+        RunLoopTest(workerCount, 3);
+
+        EXPECT_EQ(gLoopTestSlots[0].updateCount.load(), 2) << "workers " << workerCount;
+        EXPECT_EQ(gLoopTestSlots[1].updateCount.load(), 1) << "workers " << workerCount;
+        EXPECT_EQ(gLoopTestSlots[2].updateCount.load(), 1) << "workers " << workerCount;
+    }
+}
+
+TEST(SystemLoop, CommandOrder)
+{
+    for (size_t workerCount : { size_t(0), size_t(4) })
+    {
+        ResetLoopTest();
+
+        // The later systems finish earlier
+        for (size_t i = 0; i < 4; ++i)
+        {
+            DeclareLoopTestSlot(i, {}, { 100 + i }, false);
+            gLoopTestSlots[i].workTime = std::chrono::milliseconds(30 - i * 10);
+        }
+        gLoopTestSlots[4].stopFrameCount = 2;
+
+        RunLoopTest(workerCount, 5);
+
+        // The commands of the first frame are executed before the second one, in the system order
+        // The ones of the last frame are not executed, as the loop has stopped
+        std::vector<size_t> expected = { 0, 1, 2, 3, 4 };
+        EXPECT_EQ(gLoopTestCommandLog, expected) << "workers " << workerCount;
+    }
+}
+
+TEST(SystemLoop, Exception)
+{
+    ResetLoopTest();
+
+    DeclareLoopTestSlot(0, {}, { 100 }, false);
+    gLoopTestSlots[0].isThrowing = true;
+    DeclareLoopTestSlot(1, {}, { 101 }, false);
+
+    // The exception on the worker thread is thrown from Run after the running systems finish
+    EXPECT_THROW(RunLoopTest(2, 2), std::runtime_error);
+    EXPECT_EQ(gLoopTestSlots[0].updateCount.load(), 1);
+}
\ No newline at end of file